@@ -248,6 +248,23 @@
 #define  CP_STATISTIC               0
 #endif
 
+/*-------------------------------------------------------------------*/
+/*!
+** \def  CP_TRM_PRIORITY
+** \ingroup CP_CONF
+**
+** This symbol defines the number of entries of the priority ordered
+** transmit queue which the driver assigns to a transmit FIFO. Pending
+** messages are transmitted in order of their CAN identifier priority,
+** messages with the same identifier keep the order of submission.
+** The queueing delay can be read via CpCoreFifoDelay().
+** - 0 = messages are transmitted in order of submission
+** - n = priority ordered transmit queue with n entries per buffer
+*/
+#ifndef  CP_TRM_PRIORITY
+#define  CP_TRM_PRIORITY            0
+#endif
+
 
 //-----------------------------------------------------------------------------
 /*!
@@ -1187,6 +1204,93 @@ typedef struct CpStatistic_s
 } CpStatistic_ts;
 
 
+/*----------------------------------------------------------------------------*/
+/*!
+** \struct  CpHandlerTime_s   canpie.h
+** \brief   Runtime of a callback handler
+**
+** The runtime is measured in nanoseconds, the average runtime is
+** uqTimeSum / ulCallCount.
+*/
+typedef struct CpHandlerTime_s
+{
+
+   /*!   Number of handler calls
+   */
+   uint32_t     ulCallCount;
+
+   /*!   Minimum runtime
+   */
+   uint32_t     ulTimeMin;
+
+   /*!   Maximum runtime
+   */
+   uint32_t     ulTimeMax;
+
+   /*!   Sum of all runtimes
+   */
+   uint64_t     uqTimeSum;
+
+} CpHandlerTime_ts;
+
+
+/*----------------------------------------------------------------------------*/
+/*!
+** \struct  CpStatisticExt_s   canpie.h
+** \brief   Extended CAN statistic structure
+**
+** The extended statistic is read by CpCoreStatisticExt(), all values
+** are cleared by CpCoreDriverInit().
+*/
+typedef struct CpStatisticExt_s
+{
+
+   /*!   Total number of received data & remote frames
+   */
+   uint64_t     uqRcvMsgCount;
+
+   /*!   Total number of transmitted data & remote frames
+   */
+   uint64_t     uqTrmMsgCount;
+
+   /*!   Total number of error frames
+   */
+   uint64_t     uqErrMsgCount;
+
+   /*!   Total number of received data bytes
+   */
+   uint64_t     uqRcvByteCount;
+
+   /*!   Total number of transmitted data bytes
+   */
+   uint64_t     uqTrmByteCount;
+
+   /*!   Number of messages per buffer which have been dropped because
+   **    the receive FIFO or the transmit queue of the driver was full or
+   **    the message could not be transmitted
+   */
+   uint32_t     aulFifoOverrun[CP_BUFFER_MAX];
+
+   /*!   Maximum number of pending messages per buffer, for a receive
+   **    FIFO or a transmit queue of the driver
+   */
+   uint32_t     aulFifoHighWater[CP_BUFFER_MAX];
+
+   /*!   Runtime of the receive handler
+   */
+   CpHandlerTime_ts  tsRcvHandler;
+
+   /*!   Runtime of the transmit handler
+   */
+   CpHandlerTime_ts  tsTrmHandler;
+
+   /*!   Runtime of the FIFO handler
+   */
+   CpHandlerTime_ts  tsFifoHandler;
+
+} CpStatisticExt_ts;
+
+
 
 
 /*----------------------------------------------------------------------------*/
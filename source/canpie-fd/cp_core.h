@@ -96,6 +96,7 @@
 \*----------------------------------------------------------------------------*/
 
 #include "cp_fifo.h"
+#include "cp_prio.h"
 
 //-------------------------------------------------------------------//
 // take precautions if compiled with C++ compiler                    //
@@ -131,6 +132,8 @@ extern "C" {                                                         //
 #define  CpCoreCanMode(CH, A)                   CpCoreCanMode(A)
 #define  CpCoreCanState(CH, A)                  CpCoreCanState(A)
 #define  CpCoreFifoConfig(CH, A, B)             CpCoreFifoConfig(A, B)
+#define  CpCoreFifoDelay(CH, A, B)              CpCoreFifoDelay(A, B)
+#define  CpCoreFifoEvent(CH, A, B, C, D, E)     CpCoreFifoEvent(A, B, C, D, E)
 #define  CpCoreFifoRead(CH, A, B, C)            CpCoreFifoRead(A, B, C)
 #define  CpCoreFifoRelease(CH, A)               CpCoreFifoRelease(A)
 #define  CpCoreFifoWrite(CH, A, B, C)           CpCoreFifoWrite(A, B, C)
@@ -139,6 +142,7 @@ extern "C" {                                                         //
 #define  CpCoreIntFunctions(CH, A, B, C)        CpCoreIntFunctions(A, B, C)
 
 #define  CpCoreStatistic(CH, A)                 CpCoreStatistic(A)
+#define  CpCoreStatisticExt(CH, A)              CpCoreStatisticExt(A)
 
 #endif
 
@@ -146,6 +150,7 @@ extern "C" {                                                         //
 typedef uint8_t (* CpRcvHandler_Fn)(CpCanMsg_ts *ptsMsgV, uint8_t ubBufferV);
 typedef uint8_t (* CpTrmHandler_Fn)(CpCanMsg_ts *ptsMsgV, uint8_t ubBufferV);
 typedef uint8_t (* CpErrHandler_Fn)(CpState_ts   *ptsErrV);
+typedef uint8_t (* CpFifoHandler_Fn)(uint8_t ubBufferV, uint32_t ulMsgCntV);
 
 
 
@@ -505,7 +510,64 @@ CpStatus_tv CpCoreDriverRelease(CpPort_ts *ptsPortV);
 CpStatus_tv CpCoreFifoConfig(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
                              CpFifo_ts *ptsFifoV);
 
-void        CpCoreFifoEvent(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV);
+
+/*!
+** \brief      Get queueing delay of a transmit FIFO
+** \param[in]  ptsPortV       Pointer to CAN port structure
+** \param[in]  ubBufferIdxV   Buffer number
+** \param[out] ptsDelayV      Pointer to array of #CP_PRIO_CLASS_MAX
+**                            CpPrioDelay_ts elements
+**
+** \return  Error code is defined by the #CpErr_e enumeration. If no error
+**          occurred, the function will return the value \c #eCP_ERR_NONE.
+**
+** If the driver is compiled with #CP_TRM_PRIORITY > 0, messages written
+** by CpCoreFifoWrite() are transmitted in order of their CAN identifier
+** priority. This function copies the queueing delay of the transmit FIFO
+** defined by \c ubBufferIdxV for every priority class to \c ptsDelayV.
+** The unit of the delay is a tick of the driver. If the driver does not
+** support a priority ordered transmit queue, the function returns
+** #eCP_ERR_NOT_SUPPORTED.
+*/
+CpStatus_tv CpCoreFifoDelay(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
+                            CpPrioDelay_ts *ptsDelayV);
+
+
+/*!
+** \brief      Install notification for a receive FIFO
+** \param[in]  ptsPortV         Pointer to CAN port structure
+** \param[in]  ubBufferIdxV     Buffer number
+** \param[in]  pfnFifoHandlerV  Pointer to callback function, NULL disables
+**                              the notification
+** \param[in]  ulHighMarkV      Number of pending messages which triggers
+**                              the notification
+** \param[in]  ulLowMarkV       Number of pending messages for re-arming
+** \param[in]  ulTimeoutV       Maximum latency in milliseconds, 0 disables
+**                              the timeout
+**
+** \return  Error code is defined by the #CpErr_e enumeration. If no error
+**          occurred, the function will return the value \c #eCP_ERR_NONE.
+**
+** This function installs a callback function for a receive FIFO defined by
+** the parameter \c ubBufferIdxV. The FIFO has to be configured by
+** CpCoreFifoConfig() in advance. Instead of one callback per message the
+** driver calls \c pfnFifoHandlerV once per batch, with the buffer number
+** and the number of pending messages as parameters. The callback is called
+** when
+** <ul>
+** <li>\c ulHighMarkV messages are pending in the FIFO, or
+** <li>a message has been pending for \c ulTimeoutV milliseconds.
+** </ul>
+** After a callback the application reads the FIFO by CpCoreFifoRead().
+** The next callback is armed when the number of pending messages has
+** dropped to \c ulLowMarkV. The value of \c ulHighMarkV must be within
+** the range 1 .. FIFO size and greater than \c ulLowMarkV, otherwise the
+** function returns #eCP_ERR_FIFO_PARAM.
+*/
+CpStatus_tv CpCoreFifoEvent(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
+                            /*@null@*/ CpFifoHandler_Fn pfnFifoHandlerV,
+                            uint32_t ulHighMarkV, uint32_t ulLowMarkV,
+                            uint32_t ulTimeoutV);
 
 /*!
 ** \brief         Read a CAN message from FIFO
@@ -641,6 +703,26 @@ CpStatus_tv CpCoreIntFunctions(CpPort_ts *ptsPortV,
 CpStatus_tv CpCoreStatistic(CpPort_ts *ptsPortV, CpStatistic_ts *ptsStatsV);
 
 
+/*!
+** \brief      Read extended CAN controller statistics
+** \param[in]  ptsPortV       Pointer to CAN port structure
+** \param[in]  ptsStatsV      Pointer to extended statistic data structure
+**
+** \return  Error code is defined by the #CpErr_e enumeration. If no error
+**          occurred, the function will return the value \c #eCP_ERR_NONE.
+**
+** This function copies the extended CAN statistic information to the
+** structure pointed by \c ptsStatsV. Besides 64-bit message and byte
+** counters the structure holds the number of dropped messages and the
+** maximum fill level of every FIFO, as well as the runtime of the
+** callback handlers. If the driver does not support statistic
+** information (#CP_STATISTIC is 0) the function returns
+** #eCP_ERR_NOT_SUPPORTED.
+*/
+CpStatus_tv CpCoreStatisticExt(CpPort_ts *ptsPortV,
+                               CpStatisticExt_ts *ptsStatsV);
+
+
 //-------------------------------------------------------------------//
 #ifdef __cplusplus                                                   //
 }                                                                    //
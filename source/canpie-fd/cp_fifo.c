@@ -50,6 +50,56 @@
 \*----------------------------------------------------------------------------*/
 #if   CP_FIFO_MACRO == 0
 
+//----------------------------------------------------------------------------//
+// CpFifoAddIn()                                                              //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CPP_INLINE void CpFifoAddIn(CpFifo_ts *ptsFifoV, uint32_t ulCountV)
+{
+   if (ulCountV > 0)
+   {
+      ptsFifoV->ulIndexIn += ulCountV;
+      if ((ptsFifoV->ulIndexIn) >= (ptsFifoV->ulIndexMax))
+      {
+         ptsFifoV->ulIndexIn -= ptsFifoV->ulIndexMax;
+      }
+      if (ptsFifoV->ulIndexIn == ptsFifoV->ulIndexOut)
+      {
+         // set state to full
+         ptsFifoV->ulState = 0x02;
+      }
+
+      // clear empty state
+      ptsFifoV->ulState &= ~0x01;
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// CpFifoAddOut()                                                             //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CPP_INLINE void CpFifoAddOut(CpFifo_ts *ptsFifoV, uint32_t ulCountV)
+{
+   if (ulCountV > 0)
+   {
+      ptsFifoV->ulIndexOut += ulCountV;
+      if ((ptsFifoV->ulIndexOut) >= (ptsFifoV->ulIndexMax))
+      {
+         ptsFifoV->ulIndexOut -= ptsFifoV->ulIndexMax;
+      }
+
+      if (ptsFifoV->ulIndexIn == ptsFifoV->ulIndexOut)
+      {
+         // set empty state
+         ptsFifoV->ulState = 0x01;
+      }
+      // clear full state
+      ptsFifoV->ulState &= ~0x02;
+   }
+}
+
+
 //----------------------------------------------------------------------------//
 // CpFifoDataInPtr()                                                          //
 //                                                                            //
@@ -67,6 +117,34 @@ CPP_INLINE CpCanMsg_ts *CpFifoDataInPtr(CpFifo_ts *ptsFifoV)
 }
 
 
+//----------------------------------------------------------------------------//
+// CpFifoDataInSpan()                                                         //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CPP_INLINE uint32_t CpFifoDataInSpan(CpFifo_ts *ptsFifoV)
+{
+   uint32_t ulSpanT = 0;
+
+   if (ptsFifoV->ulState != 0x0002)
+   {
+      //--------------------------------------------------------
+      // free entries end either at the end of the array or at
+      // the first pending entry
+      //
+      if (ptsFifoV->ulIndexIn >= ptsFifoV->ulIndexOut)
+      {
+         ulSpanT = ptsFifoV->ulIndexMax - ptsFifoV->ulIndexIn;
+      }
+      else
+      {
+         ulSpanT = ptsFifoV->ulIndexOut - ptsFifoV->ulIndexIn;
+      }
+   }
+
+   return (ulSpanT);
+}
+
+
 //----------------------------------------------------------------------------//
 // CpFifoDataOutPtr()                                                         //
 //                                                                            //
@@ -84,6 +162,34 @@ CPP_INLINE CpCanMsg_ts *CpFifoDataOutPtr(CpFifo_ts *ptsFifoV)
 }
 
 
+//----------------------------------------------------------------------------//
+// CpFifoDataOutSpan()                                                        //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CPP_INLINE uint32_t CpFifoDataOutSpan(CpFifo_ts *ptsFifoV)
+{
+   uint32_t ulSpanT = 0;
+
+   if (ptsFifoV->ulState != 0x0001)
+   {
+      //--------------------------------------------------------
+      // pending entries end either at the end of the array or
+      // at the first free entry
+      //
+      if (ptsFifoV->ulIndexIn > ptsFifoV->ulIndexOut)
+      {
+         ulSpanT = ptsFifoV->ulIndexIn - ptsFifoV->ulIndexOut;
+      }
+      else
+      {
+         ulSpanT = ptsFifoV->ulIndexMax - ptsFifoV->ulIndexOut;
+      }
+   }
+
+   return (ulSpanT);
+}
+
+
 //----------------------------------------------------------------------------//
 // CpFifoIncIn()                                                              //
 //                                                                            //
@@ -180,3 +286,145 @@ CPP_INLINE bool_t CpFifoIsFull(CpFifo_ts *ptsFifoV)
 }
 
 #endif   // CP_FIFO_MACRO == 0
+
+
+/*----------------------------------------------------------------------------*\
+** Notification functions, not available as macro                             **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//----------------------------------------------------------------------------//
+// CpFifoEventIn()                                                            //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool_t CpFifoEventIn(CpFifoEvent_ts *ptsEventV, CpFifo_ts *ptsFifoV,
+                     uint32_t ulTickV)
+{
+   bool_t   btNotifyT = false;
+   uint32_t ulPendingT;
+
+   if ((ptsEventV->ulState & CP_FIFO_EVENT_ARMED) != 0)
+   {
+      ulPendingT = CpFifoPending(ptsFifoV);
+      if (ulPendingT >= ptsEventV->ulHighMark)
+      {
+         //--------------------------------------------------------
+         // high watermark reached, the notification is armed
+         // again by CpFifoEventOut()
+         //
+         ptsEventV->ulState = 0;
+         btNotifyT = true;
+      }
+      else if ((ptsEventV->ulTimeout > 0) && (ulPendingT > 0) &&
+               ((ptsEventV->ulState & CP_FIFO_EVENT_TIMER) == 0))
+      {
+         ptsEventV->ulTickStart = ulTickV;
+         ptsEventV->ulState    |= CP_FIFO_EVENT_TIMER;
+      }
+   }
+
+   return (btNotifyT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpFifoEventInit()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void CpFifoEventInit(CpFifoEvent_ts *ptsEventV, uint32_t ulHighMarkV,
+                     uint32_t ulLowMarkV, uint32_t ulTimeoutV)
+{
+   ptsEventV->ulHighMark  = ulHighMarkV;
+   ptsEventV->ulLowMark   = ulLowMarkV;
+   ptsEventV->ulTimeout   = ulTimeoutV;
+   ptsEventV->ulTickStart = 0;
+   ptsEventV->ulState     = CP_FIFO_EVENT_ARMED;
+}
+
+
+//----------------------------------------------------------------------------//
+// CpFifoEventOut()                                                           //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void CpFifoEventOut(CpFifoEvent_ts *ptsEventV, CpFifo_ts *ptsFifoV,
+                    uint32_t ulTickV)
+{
+   uint32_t ulPendingT;
+
+   ulPendingT = CpFifoPending(ptsFifoV);
+
+   if ((ptsEventV->ulState & CP_FIFO_EVENT_ARMED) == 0)
+   {
+      //--------------------------------------------------------
+      // re-arm below the low watermark, remaining entries
+      // are covered by a new timeout
+      //
+      if (ulPendingT <= ptsEventV->ulLowMark)
+      {
+         ptsEventV->ulState = CP_FIFO_EVENT_ARMED;
+         if ((ptsEventV->ulTimeout > 0) && (ulPendingT > 0))
+         {
+            ptsEventV->ulTickStart = ulTickV;
+            ptsEventV->ulState    |= CP_FIFO_EVENT_TIMER;
+         }
+      }
+   }
+   else if (ulPendingT == 0)
+   {
+      ptsEventV->ulState = CP_FIFO_EVENT_ARMED;
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// CpFifoEventTimer()                                                         //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool_t CpFifoEventTimer(CpFifoEvent_ts *ptsEventV, CpFifo_ts *ptsFifoV,
+                        uint32_t ulTickV)
+{
+   bool_t   btNotifyT = false;
+
+   if (ptsEventV->ulState == (CP_FIFO_EVENT_ARMED | CP_FIFO_EVENT_TIMER))
+   {
+      if ((ulTickV - ptsEventV->ulTickStart) >= ptsEventV->ulTimeout)
+      {
+         if (CpFifoPending(ptsFifoV) > 0)
+         {
+            ptsEventV->ulState = 0;
+            btNotifyT = true;
+         }
+         else
+         {
+            ptsEventV->ulState = CP_FIFO_EVENT_ARMED;
+         }
+      }
+   }
+
+   return (btNotifyT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpFifoPending()                                                            //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint32_t CpFifoPending(CpFifo_ts *ptsFifoV)
+{
+   uint32_t ulPendingT;
+
+   if (CpFifoIsFull(ptsFifoV))
+   {
+      ulPendingT = ptsFifoV->ulIndexMax;
+   }
+   else if (ptsFifoV->ulIndexIn >= ptsFifoV->ulIndexOut)
+   {
+      ulPendingT = ptsFifoV->ulIndexIn - ptsFifoV->ulIndexOut;
+   }
+   else
+   {
+      ulPendingT = ptsFifoV->ulIndexMax - ptsFifoV->ulIndexOut + ptsFifoV->ulIndexIn;
+   }
+
+   return (ulPendingT);
+}
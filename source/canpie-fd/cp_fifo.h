@@ -73,6 +73,12 @@ extern "C" {                                                         //
 #define CP_FIFO_MACRO   0
 #endif
 
+//-------------------------------------------------------------------
+// state bits of CpFifoEvent_ts::ulState
+//
+#define  CP_FIFO_EVENT_ARMED     ((uint32_t) 0x01)
+#define  CP_FIFO_EVENT_TIMER     ((uint32_t) 0x02)
+
 
 /*----------------------------------------------------------------------------*\
 ** Structures                                                                 **
@@ -116,11 +122,80 @@ struct CpFifo_s
 */
 typedef struct CpFifo_s CpFifo_ts;
 
+
+/*----------------------------------------------------------------------------*/
+/*!
+** \struct  CpFifoEvent_s
+** \brief   Notification state of a CAN message FIFO
+**
+** This structure is initialised by CpFifoEventInit(). It is used by a
+** driver to notify the application once per batch of messages instead
+** of once per message.
+*/
+struct CpFifoEvent_s
+{
+   /*! Number of pending entries which triggers a notification
+   */
+   uint32_t  ulHighMark;
+
+   /*! After a notification the next one is armed when the number of
+    *  pending entries has dropped to this value
+   */
+   uint32_t  ulLowMark;
+
+   /*! Maximum time in ticks between the first pending entry and the
+    *  notification, 0 disables the timeout
+   */
+   uint32_t  ulTimeout;
+
+   /*! Tick value of the first entry which has not been notified
+   */
+   uint32_t  ulTickStart;
+
+   /*! Notification state
+    *  #CP_FIFO_EVENT_ARMED: notification is armed
+    *  #CP_FIFO_EVENT_TIMER: timeout is running
+    */
+   uint32_t  ulState;
+};
+/*!
+** \typedef    CpFifoEvent_ts
+*/
+typedef struct CpFifoEvent_s CpFifoEvent_ts;
+
 /*----------------------------------------------------------------------------*\
 ** Function prototypes                                                        **
 **                                                                            **
 \*----------------------------------------------------------------------------*/
 
+/*!
+** \brief   Add number of entries to data in pointer
+** \param   ptsFifoV - Pointer to CAN message FIFO
+** \param   ulCountV - Number of entries written to the FIFO
+**
+** This function increments the CpFifo_ts::ulIndexIn element of the
+** CAN message FIFO by \a ulCountV entries. It is used to commit a
+** block of messages which has been copied to the location returned by
+** CpFifoDataInPtr(). The value of \a ulCountV must not exceed the
+** value returned by CpFifoDataInSpan().
+*/
+void CpFifoAddIn(CpFifo_ts *ptsFifoV, uint32_t ulCountV);
+
+
+/*!
+** \brief   Add number of entries to data out pointer
+** \param   ptsFifoV - Pointer to CAN message FIFO
+** \param   ulCountV - Number of entries read from the FIFO
+**
+** This function increments the CpFifo_ts::ulIndexOut element of the
+** CAN message FIFO by \a ulCountV entries. It is used to release a
+** block of messages which has been copied from the location returned by
+** CpFifoDataOutPtr(). The value of \a ulCountV must not exceed the
+** value returned by CpFifoDataOutSpan().
+*/
+void CpFifoAddOut(CpFifo_ts *ptsFifoV, uint32_t ulCountV);
+
+
 /*!
 ** \brief   Get next free entry from FIFO
 ** \param   ptsFifoV - Pointer to CAN message FIFO
@@ -152,6 +227,43 @@ typedef struct CpFifo_s CpFifo_ts;
 CpCanMsg_ts *CpFifoDataInPtr(CpFifo_ts *ptsFifoV);
 
 
+/*!
+** \brief   Get number of contiguous free entries
+** \param   ptsFifoV - Pointer to CAN message FIFO
+** \return  Number of free entries
+**
+** This function returns the number of free entries which can be written
+** as one block, starting at the location returned by CpFifoDataInPtr().
+** Because of the ring layout a FIFO may hold up to two of these blocks,
+** hence a bulk write requires at most two calls to memcpy():
+**
+** \code
+**
+** static CpFifo_ts  tsCanFifoS;
+** CpCanMsg_ts *     ptsCanNewMsgT;
+** uint32_t          ulMsgCntT;
+** uint32_t          ulSpanT;
+**
+**
+**
+** while (ulMsgCntT > 0)
+** {
+**    ulSpanT = CpFifoDataInSpan(&tsCanFifoS);
+**    if (ulSpanT == 0) break;
+**    if (ulSpanT > ulMsgCntT) ulSpanT = ulMsgCntT;
+**
+**    memcpy(CpFifoDataInPtr(&tsCanFifoS), ptsCanNewMsgT,
+**           ulSpanT * sizeof(CpCanMsg_ts));
+**
+**    CpFifoAddIn(&tsCanFifoS, ulSpanT);
+**    ptsCanNewMsgT += ulSpanT;
+**    ulMsgCntT     -= ulSpanT;
+** }
+** \endcode
+*/
+uint32_t CpFifoDataInSpan(CpFifo_ts *ptsFifoV);
+
+
 /*!
 ** \brief   Get first element of FIFO
 ** \param   ptsFifoV - Pointer to CAN message FIFO
@@ -183,6 +295,82 @@ CpCanMsg_ts *CpFifoDataInPtr(CpFifo_ts *ptsFifoV);
 CpCanMsg_ts *CpFifoDataOutPtr(CpFifo_ts *ptsFifoV);
 
 
+/*!
+** \brief   Get number of contiguous pending entries
+** \param   ptsFifoV - Pointer to CAN message FIFO
+** \return  Number of pending entries
+**
+** This function returns the number of pending entries which can be read
+** as one block, starting at the location returned by CpFifoDataOutPtr().
+** After copying the block the entries are released by calling
+** CpFifoAddOut(). Because of the ring layout all pending entries are
+** read with at most two calls.
+*/
+uint32_t CpFifoDataOutSpan(CpFifo_ts *ptsFifoV);
+
+
+/*!
+** \brief   Update notification state after writing to the FIFO
+** \param   ptsEventV - Pointer to notification state
+** \param   ptsFifoV - Pointer to CAN message FIFO
+** \param   ulTickV - Present tick value
+** \return  true if the application has to be notified
+**
+** This function is called by the driver after one or more entries have
+** been written to the FIFO. It returns \a true when the number of pending
+** entries has reached the high watermark. Otherwise the timeout is started
+** for the first entry. After a notification the function returns \a false
+** until the notification is armed again by CpFifoEventOut().
+*/
+bool_t CpFifoEventIn(CpFifoEvent_ts *ptsEventV, CpFifo_ts *ptsFifoV,
+                     uint32_t ulTickV);
+
+
+/*!
+** \brief   Initialise notification state
+** \param   ptsEventV - Pointer to notification state
+** \param   ulHighMarkV - Number of pending entries for notification
+** \param   ulLowMarkV - Number of pending entries for re-arming
+** \param   ulTimeoutV - Maximum latency in ticks, 0 for no timeout
+**
+** The value of \a ulHighMarkV must be greater than 0 and greater than
+** \a ulLowMarkV. The notification is armed after initialisation.
+*/
+void CpFifoEventInit(CpFifoEvent_ts *ptsEventV, uint32_t ulHighMarkV,
+                     uint32_t ulLowMarkV, uint32_t ulTimeoutV);
+
+
+/*!
+** \brief   Update notification state after reading from the FIFO
+** \param   ptsEventV - Pointer to notification state
+** \param   ptsFifoV - Pointer to CAN message FIFO
+** \param   ulTickV - Present tick value
+**
+** This function is called by the driver after entries have been read
+** from the FIFO. When the number of pending entries has dropped to the
+** low watermark the notification is armed again. If entries are still
+** pending the timeout starts at \a ulTickV.
+*/
+void CpFifoEventOut(CpFifoEvent_ts *ptsEventV, CpFifo_ts *ptsFifoV,
+                    uint32_t ulTickV);
+
+
+/*!
+** \brief   Check timeout of notification
+** \param   ptsEventV - Pointer to notification state
+** \param   ptsFifoV - Pointer to CAN message FIFO
+** \param   ulTickV - Present tick value
+** \return  true if the application has to be notified
+**
+** This function is called periodically by the driver. It returns \a true
+** when entries are pending below the high watermark and the first of them
+** has waited for CpFifoEvent_ts::ulTimeout ticks. The tick counter may
+** wrap around.
+*/
+bool_t CpFifoEventTimer(CpFifoEvent_ts *ptsEventV, CpFifo_ts *ptsFifoV,
+                        uint32_t ulTickV);
+
+
 /*!
 ** \brief   Increment data in pointer
 ** \param   ptsFifoV - Pointer to CAN message FIFO
@@ -242,6 +430,17 @@ bool_t CpFifoIsEmpty(CpFifo_ts *ptsFifoV);
 
 
 
+/*!
+** \brief   Get number of pending entries
+** \param   ptsFifoV - Pointer to CAN message FIFO
+** \return  Number of pending entries
+**
+** The function returns the number of entries which can be read from the
+** FIFO.
+*/
+uint32_t CpFifoPending(CpFifo_ts *ptsFifoV);
+
+
 /*!
 ** \brief   Test for FIFO full
 ** \param   ptsFifoV - Pointer to CAN message FIFO
@@ -266,6 +465,18 @@ bool_t CpFifoIsFull(CpFifo_ts *ptsFifoV);
 #define  CpFifoDataOutPtr(FIFO_PTR) \
       (((FIFO_PTR)->ptsCanMsg) + ((FIFO_PTR)->ulIndexOut))
 
+#define  CpFifoDataInSpan(FIFO_PTR)                                  \
+            (((FIFO_PTR)->ulState == 0x0002) ? 0 :                   \
+             (((FIFO_PTR)->ulIndexIn >= (FIFO_PTR)->ulIndexOut) ?    \
+              ((FIFO_PTR)->ulIndexMax - (FIFO_PTR)->ulIndexIn) :     \
+              ((FIFO_PTR)->ulIndexOut - (FIFO_PTR)->ulIndexIn)))
+
+#define  CpFifoDataOutSpan(FIFO_PTR)                                 \
+            (((FIFO_PTR)->ulState == 0x0001) ? 0 :                   \
+             (((FIFO_PTR)->ulIndexIn > (FIFO_PTR)->ulIndexOut) ?     \
+              ((FIFO_PTR)->ulIndexIn - (FIFO_PTR)->ulIndexOut) :     \
+              ((FIFO_PTR)->ulIndexMax - (FIFO_PTR)->ulIndexOut)))
+
 
 #define  CpFifoIsEmpty(FIFO_PTR)                                     \
             (((FIFO_PTR)->ulState == 0x0001) ? 1 : 0)
@@ -301,6 +512,40 @@ bool_t CpFifoIsFull(CpFifo_ts *ptsFifoV);
             (FIFO_PTR)->ulState &= ~0x02;                            \
          } while (0)
 
+#define  CpFifoAddIn(FIFO_PTR, COUNT)                                \
+         do {                                                        \
+            if ((COUNT) > 0)                                         \
+            {                                                        \
+               (FIFO_PTR)->ulIndexIn += (COUNT);                     \
+               if ((FIFO_PTR)->ulIndexIn >= (FIFO_PTR)->ulIndexMax)  \
+               {                                                     \
+                  (FIFO_PTR)->ulIndexIn -= (FIFO_PTR)->ulIndexMax;   \
+               }                                                     \
+               if ((FIFO_PTR)->ulIndexIn == (FIFO_PTR)->ulIndexOut)  \
+               {                                                     \
+                  (FIFO_PTR)->ulState = 0x02;                        \
+               }                                                     \
+               (FIFO_PTR)->ulState &= ~0x01;                         \
+            }                                                        \
+         } while (0)
+
+#define  CpFifoAddOut(FIFO_PTR, COUNT)                               \
+         do {                                                        \
+            if ((COUNT) > 0)                                         \
+            {                                                        \
+               (FIFO_PTR)->ulIndexOut += (COUNT);                    \
+               if ((FIFO_PTR)->ulIndexOut >= (FIFO_PTR)->ulIndexMax) \
+               {                                                     \
+                  (FIFO_PTR)->ulIndexOut -= (FIFO_PTR)->ulIndexMax;  \
+               }                                                     \
+               if ((FIFO_PTR)->ulIndexIn == (FIFO_PTR)->ulIndexOut)  \
+               {                                                     \
+                  (FIFO_PTR)->ulState = 0x01;                        \
+               }                                                     \
+               (FIFO_PTR)->ulState &= ~0x02;                         \
+            }                                                        \
+         } while (0)
+
 #define  CpFifoInit(FIFO_PTR, MSG_PTR, SIZE)                         \
          do {                                                        \
             (FIFO_PTR)->ulIndexIn  = 0;                              \
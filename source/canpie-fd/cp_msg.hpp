@@ -0,0 +1,372 @@
+//============================================================================//
+// File:          cp_msg.hpp                                                  //
+// Description:   CANpie message access for C++                               //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+#ifndef  CP_MSG_HPP_
+#define  CP_MSG_HPP_
+
+
+
+//-----------------------------------------------------------------------------
+/*!
+** \file    cp_msg.hpp
+** \brief   %CANpie message access for C++
+**
+** The class CpMsg provides inline access functions for the CAN message
+** structure CpCanMsg_ts. Unlike the macros enabled by #CP_CAN_MSG_MACRO
+** the functions are type-safe, unlike the functions of cp_msg.c they
+** are expanded in place and compile down to single loads and masks.
+** The functions work directly on a CpCanMsg_ts structure, so they can
+** be mixed with the C API in any order.
+**
+** The frame format is selected at compile time: CpMsg is an alias for
+** CpMsgAccess<#CP_CAN_FD>. The specialisation CpMsgAccess<0> handles
+** Classical CAN frames only, all FD related tests are constant
+** \c false. It may also be used in a CAN FD build for code paths that
+** only see Classical CAN frames.
+** <p>
+** \b Example
+** \code
+** CpCanMsg_ts   tsCanMsgT;
+** CpMsg::init(tsCanMsgT, CP_MSG_FORMAT_CBFF);
+** CpMsg::setIdentifier(tsCanMsgT, 100);
+** CpMsg::setDlc(tsCanMsgT, 2);
+**
+** if (CpMsg::isExtended(tsCanMsgT) == false)
+** {
+**    // ...
+** }
+** \endcode
+*/
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#include "cp_msg.h"
+
+
+/*----------------------------------------------------------------------------*\
+** Class definitions                                                          **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+
+//-----------------------------------------------------------------------------
+/*!
+** \class   CpMsgAccessBase
+** \brief   Access functions independent of the CAN FD support
+**
+*/
+class CpMsgAccessBase
+{
+public:
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \return  Data Length Code (DLC) of CAN message
+   ** \see     CpMsgGetDlc()
+   */
+   static constexpr uint8_t  dlc(const CpCanMsg_ts & tsCanMsgR)
+   {
+      return (tsCanMsgR.ubMsgDLC);
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \return  Identifier value, masked according to the frame format
+   ** \see     CpMsgGetIdentifier()
+   */
+   static constexpr uint32_t identifier(const CpCanMsg_ts & tsCanMsgR)
+   {
+      return (tsCanMsgR.ulIdentifier & (((tsCanMsgR.ubMsgCtrl & CP_MSG_CTRL_EXT_BIT) != 0) ?
+                                        CP_MASK_EXT_FRAME : CP_MASK_STD_FRAME));
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \return  \c true for Extended CAN frame
+   ** \see     CpMsgIsExtended()
+   */
+   static constexpr bool     isExtended(const CpCanMsg_ts & tsCanMsgR)
+   {
+      return ((tsCanMsgR.ubMsgCtrl & CP_MSG_CTRL_EXT_BIT) != 0);
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \return  \c true for data overrun
+   ** \see     CpMsgIsOverrun()
+   */
+   static constexpr bool     isOverrun(const CpCanMsg_ts & tsCanMsgR)
+   {
+      return ((tsCanMsgR.ubMsgCtrl & CP_MSG_CTRL_OVR_BIT) != 0);
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \return  \c true for Remote frame
+   ** \see     CpMsgIsRemote()
+   */
+   static constexpr bool     isRemote(const CpCanMsg_ts & tsCanMsgR)
+   {
+      return ((tsCanMsgR.ubMsgCtrl & CP_MSG_CTRL_RTR_BIT) != 0);
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \param   ubFormatV   Frame format
+   ** \see     CpMsgInit()
+   */
+   static inline void        init(CpCanMsg_ts & tsCanMsgR, uint8_t ubFormatV)
+   {
+      tsCanMsgR.ulIdentifier = 0UL;
+      tsCanMsgR.ubMsgDLC     = (uint8_t) 0;
+      tsCanMsgR.ubMsgCtrl    = ubFormatV & CP_MASK_MSG_FORMAT;
+   }
+
+   /*!
+   ** \param   tsCanMsgR      Reference to a CpCanMsg_ts message
+   ** \param   ulIdentifierV  Identifier value
+   ** \see     CpMsgSetIdentifier()
+   */
+   static inline void        setIdentifier(CpCanMsg_ts & tsCanMsgR, uint32_t ulIdentifierV)
+   {
+      tsCanMsgR.ulIdentifier = ulIdentifierV & (isExtended(tsCanMsgR) ?
+                                                CP_MASK_EXT_FRAME : CP_MASK_STD_FRAME);
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \param   tsOtherR    Reference to a CpCanMsg_ts message
+   ** \return  \c true if both messages have the same frame format (CAN 2.0A / 2.0B)
+   */
+   static constexpr bool     isSameFormat(const CpCanMsg_ts & tsCanMsgR, const CpCanMsg_ts & tsOtherR)
+   {
+      return (((tsCanMsgR.ubMsgCtrl ^ tsOtherR.ubMsgCtrl) & CP_MSG_CTRL_EXT_BIT) == 0);
+   }
+};
+
+
+//-----------------------------------------------------------------------------
+/*!
+** \class   CpMsgAccess
+** \brief   Access functions for Classical CAN (\c 0) or CAN FD (\c 1)
+**
+*/
+template <int slCanFdV> class CpMsgAccess;
+
+
+//-----------------------------------------------------------------------------
+/*!
+** \brief   Access functions for Classical CAN frames
+**
+*/
+template <> class CpMsgAccess<0> : public CpMsgAccessBase
+{
+public:
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \param   ubPosV      Zero based index of byte position, 0 .. 7
+   ** \return  Value of data at position ubPosV
+   ** \see     CpMsgGetData()
+   */
+   static constexpr uint8_t  data(const CpCanMsg_ts & tsCanMsgR, uint8_t ubPosV)
+   {
+      return ((ubPosV < 8) ? tsCanMsgR.tuMsgData.aubByte[ubPosV] : (uint8_t) 0);
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \return  Number of data bytes, 0 .. 8
+   */
+   static constexpr uint8_t  dataSize(const CpCanMsg_ts & tsCanMsgR)
+   {
+      return ((tsCanMsgR.ubMsgDLC < 8) ? tsCanMsgR.ubMsgDLC : (uint8_t) 8);
+   }
+
+   /*!
+   ** \return  always \c false for Classical CAN frames
+   */
+   static constexpr bool     isBitrateSwitchSet(const CpCanMsg_ts &)
+   {
+      return (false);
+   }
+
+   /*!
+   ** \return  always \c false for Classical CAN frames
+   */
+   static constexpr bool     isFdFrame(const CpCanMsg_ts &)
+   {
+      return (false);
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \param   ubPosV      Zero based index of byte position, 0 .. 7
+   ** \param   ubValueV    Data value
+   ** \see     CpMsgSetData()
+   */
+   static inline void        setData(CpCanMsg_ts & tsCanMsgR, uint8_t ubPosV, uint8_t ubValueV)
+   {
+      if (ubPosV < 8)
+      {
+         tsCanMsgR.tuMsgData.aubByte[ubPosV] = ubValueV;
+      }
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \param   ubDlcV      Data Length Code, 0 .. 8
+   ** \see     CpMsgSetDlc()
+   */
+   static inline void        setDlc(CpCanMsg_ts & tsCanMsgR, uint8_t ubDlcV)
+   {
+      if (ubDlcV < 9)
+      {
+         tsCanMsgR.ubMsgDLC = ubDlcV;
+      }
+   }
+};
+
+
+#if CP_CAN_FD > 0
+//-----------------------------------------------------------------------------
+/*!
+** \brief   Access functions for Classical CAN and CAN FD frames
+**
+*/
+template <> class CpMsgAccess<1> : public CpMsgAccessBase
+{
+public:
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \param   ubPosV      Zero based index of byte position, 0 .. 7 or 0 .. 63
+   ** \return  Value of data at position ubPosV
+   ** \see     CpMsgGetData()
+   */
+   static constexpr uint8_t  data(const CpCanMsg_ts & tsCanMsgR, uint8_t ubPosV)
+   {
+      return ((ubPosV < (isFdFrame(tsCanMsgR) ? 64 : 8)) ?
+              tsCanMsgR.tuMsgData.aubByte[ubPosV] : (uint8_t) 0);
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \return  Number of data bytes, 0 .. 64
+   */
+   static constexpr uint8_t  dataSize(const CpCanMsg_ts & tsCanMsgR)
+   {
+      return (isFdFrame(tsCanMsgR) ? dlcToSize(tsCanMsgR.ubMsgDLC & 0x0F) :
+              ((tsCanMsgR.ubMsgDLC < 8) ? tsCanMsgR.ubMsgDLC : (uint8_t) 8));
+   }
+
+   /*!
+   ** \param   ubDlcV      Data Length Code, 0 .. 15
+   ** \return  Number of data bytes of a CAN FD frame
+   */
+   static constexpr uint8_t  dlcToSize(uint8_t ubDlcV)
+   {
+      return ((ubDlcV <= 8) ? ubDlcV :
+              (ubDlcV <= 12) ? (uint8_t) (8 + ((ubDlcV - 8) * 4)) : (uint8_t) ((ubDlcV - 11) * 16));
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \return  \c true if bit-rate switch is set
+   ** \see     CpMsgIsBitrateSwitchSet()
+   */
+   static constexpr bool     isBitrateSwitchSet(const CpCanMsg_ts & tsCanMsgR)
+   {
+      return ((tsCanMsgR.ubMsgCtrl & (CP_MSG_CTRL_FDF_BIT | CP_MSG_CTRL_BRS_BIT)) ==
+              (CP_MSG_CTRL_FDF_BIT | CP_MSG_CTRL_BRS_BIT));
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \return  \c true for CAN FD frame
+   ** \see     CpMsgIsFdFrame()
+   */
+   static constexpr bool     isFdFrame(const CpCanMsg_ts & tsCanMsgR)
+   {
+      return ((tsCanMsgR.ubMsgCtrl & CP_MSG_CTRL_FDF_BIT) != 0);
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \param   ubPosV      Zero based index of byte position, 0 .. 7 or 0 .. 63
+   ** \param   ubValueV    Data value
+   ** \see     CpMsgSetData()
+   */
+   static inline void        setData(CpCanMsg_ts & tsCanMsgR, uint8_t ubPosV, uint8_t ubValueV)
+   {
+      if (ubPosV < (isFdFrame(tsCanMsgR) ? 64 : 8))
+      {
+         tsCanMsgR.tuMsgData.aubByte[ubPosV] = ubValueV;
+      }
+   }
+
+   /*!
+   ** \param   tsCanMsgR   Reference to a CpCanMsg_ts message
+   ** \param   ubDlcV      Data Length Code, 0 .. 8 or 0 .. 15
+   ** \see     CpMsgSetDlc()
+   */
+   static inline void        setDlc(CpCanMsg_ts & tsCanMsgR, uint8_t ubDlcV)
+   {
+      if (ubDlcV < (isFdFrame(tsCanMsgR) ? 16 : 9))
+      {
+         tsCanMsgR.ubMsgDLC = ubDlcV;
+      }
+   }
+};
+
+static_assert(CP_DATA_SIZE == 64, "CpMsgAccess<1> requires a CAN FD message structure");
+#endif
+
+
+//-----------------------------------------------------------------------------
+/*!
+** \typedef CpMsg
+** \brief   Access functions for the frame formats of the platform
+**
+*/
+typedef CpMsgAccess<CP_CAN_FD> CpMsg;
+
+
+#endif   /* CP_MSG_HPP_ */
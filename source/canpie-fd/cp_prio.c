@@ -0,0 +1,330 @@
+//============================================================================//
+// File:          cp_prio.c                                                   //
+// Description:   CANpie priority ordered transmit queue                      //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#include "cp_prio.h"
+#include "cp_msg.h"
+
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// bit positions of the arbitration key
+//
+#define  CP_PRIO_KEY_BASE_POS    21
+#define  CP_PRIO_KEY_SRR_BIT     ((uint32_t) 0x00100000)
+#define  CP_PRIO_KEY_IDE_BIT     ((uint32_t) 0x00080000)
+#define  CP_PRIO_KEY_EXT_POS     1
+
+
+/*----------------------------------------------------------------------------*\
+** Function implementation                                                    **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//----------------------------------------------------------------------------//
+// CpPrioIsBefore()                                                           //
+// test if entry A has to be transmitted before entry B                       //
+//----------------------------------------------------------------------------//
+static bool_t CpPrioIsBefore(const CpPrioEntry_ts *ptsEntryAV,
+                             const CpPrioEntry_ts *ptsEntryBV)
+{
+   bool_t btResultT = false;
+
+   if (ptsEntryAV->ulKey < ptsEntryBV->ulKey)
+   {
+      btResultT = true;
+   }
+   else if (ptsEntryAV->ulKey == ptsEntryBV->ulKey)
+   {
+      //--------------------------------------------------------
+      // the sequence number may wrap around
+      //
+      if ((int32_t) (ptsEntryAV->ulSequence - ptsEntryBV->ulSequence) < 0)
+      {
+         btResultT = true;
+      }
+   }
+
+   return (btResultT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpPrioClass()                                                              //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint8_t CpPrioClass(uint32_t ulKeyV)
+{
+   return ((uint8_t) (((ulKeyV >> CP_PRIO_KEY_BASE_POS) * CP_PRIO_CLASS_MAX)
+                      >> 11));
+}
+
+
+//----------------------------------------------------------------------------//
+// CpPrioHead()                                                               //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool_t CpPrioHead(CpPrio_ts *ptsPrioV, uint32_t *pulKeyV)
+{
+   bool_t btResultT = false;
+
+   if (ptsPrioV->ulCount > 0)
+   {
+      *pulKeyV  = ptsPrioV->ptsEntry[0].ulKey;
+      btResultT = true;
+   }
+
+   return (btResultT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpPrioInit()                                                               //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void CpPrioInit(CpPrio_ts *ptsPrioV, CpPrioEntry_ts *ptsEntryV,
+                uint32_t ulSizeV)
+{
+   uint8_t  ubClassT;
+
+   ptsPrioV->ulCount    = 0;
+   ptsPrioV->ulIndexMax = ulSizeV;
+   ptsPrioV->ulSequence = 0;
+   ptsPrioV->ptsEntry   = ptsEntryV;
+
+   for (ubClassT = 0; ubClassT < CP_PRIO_CLASS_MAX; ubClassT++)
+   {
+      ptsPrioV->atsDelay[ubClassT].ulMsgCount = 0;
+      ptsPrioV->atsDelay[ubClassT].ulDelaySum = 0;
+      ptsPrioV->atsDelay[ubClassT].ulDelayMax = 0;
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// CpPrioIsEmpty()                                                            //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool_t CpPrioIsEmpty(CpPrio_ts *ptsPrioV)
+{
+   return (ptsPrioV->ulCount == 0);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpPrioIsFull()                                                             //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool_t CpPrioIsFull(CpPrio_ts *ptsPrioV)
+{
+   return (ptsPrioV->ulCount >= ptsPrioV->ulIndexMax);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpPrioKey()                                                                //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint32_t CpPrioKey(const CpCanMsg_ts *ptsCanMsgV)
+{
+   uint32_t ulIdentifierT;
+   uint32_t ulKeyT;
+
+   ulIdentifierT = CpMsgGetIdentifier(ptsCanMsgV);
+
+   if (CpMsgIsExtended(ptsCanMsgV))
+   {
+      //--------------------------------------------------------
+      // base identifier, SRR and IDE are recessive, followed
+      // by identifier extension and RTR
+      //
+      ulKeyT  = ((ulIdentifierT >> 18) & CP_MASK_STD_FRAME) <<
+                CP_PRIO_KEY_BASE_POS;
+      ulKeyT |= CP_PRIO_KEY_SRR_BIT | CP_PRIO_KEY_IDE_BIT;
+      ulKeyT |= (ulIdentifierT & (uint32_t) 0x0003FFFF) << CP_PRIO_KEY_EXT_POS;
+      if (CpMsgIsRemote(ptsCanMsgV))
+      {
+         ulKeyT |= (uint32_t) 0x00000001;
+      }
+   }
+   else
+   {
+      //--------------------------------------------------------
+      // base identifier followed by RTR, IDE is dominant
+      //
+      ulKeyT = (ulIdentifierT & CP_MASK_STD_FRAME) << CP_PRIO_KEY_BASE_POS;
+      if (CpMsgIsRemote(ptsCanMsgV))
+      {
+         ulKeyT |= CP_PRIO_KEY_SRR_BIT;
+      }
+   }
+
+   return (ulKeyT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpPrioPending()                                                            //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint32_t CpPrioPending(CpPrio_ts *ptsPrioV)
+{
+   return (ptsPrioV->ulCount);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpPrioPop()                                                                //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool_t CpPrioPop(CpPrio_ts *ptsPrioV, CpCanMsg_ts *ptsCanMsgV,
+                 uint32_t ulTickV)
+{
+   CpPrioEntry_ts * ptsEntryT;
+   CpPrioDelay_ts * ptsDelayT;
+   uint32_t         ulDelayT;
+   uint32_t         ulHoleT;
+   uint32_t         ulChildT;
+
+   if (ptsPrioV->ulCount == 0)
+   {
+      return (false);
+   }
+
+   ptsEntryT   = ptsPrioV->ptsEntry;
+   *ptsCanMsgV = ptsEntryT[0].tsCanMsg;
+
+   //----------------------------------------------------------------
+   // update queueing delay of the priority class
+   //
+   ulDelayT  = ulTickV - ptsEntryT[0].ulTick;
+   ptsDelayT = &(ptsPrioV->atsDelay[CpPrioClass(ptsEntryT[0].ulKey)]);
+   ptsDelayT->ulMsgCount++;
+   ptsDelayT->ulDelaySum += ulDelayT;
+   if (ulDelayT > ptsDelayT->ulDelayMax)
+   {
+      ptsDelayT->ulDelayMax = ulDelayT;
+   }
+
+   //----------------------------------------------------------------
+   // move the last entry down from the top of the heap
+   //
+   ptsPrioV->ulCount--;
+   ulHoleT = 0;
+   while (1)
+   {
+      ulChildT = (2 * ulHoleT) + 1;
+      if (ulChildT >= ptsPrioV->ulCount)
+      {
+         break;
+      }
+      if (((ulChildT + 1) < ptsPrioV->ulCount) &&
+          CpPrioIsBefore(&ptsEntryT[ulChildT + 1], &ptsEntryT[ulChildT]))
+      {
+         ulChildT++;
+      }
+      if (!CpPrioIsBefore(&ptsEntryT[ulChildT],
+                          &ptsEntryT[ptsPrioV->ulCount]))
+      {
+         break;
+      }
+      ptsEntryT[ulHoleT] = ptsEntryT[ulChildT];
+      ulHoleT = ulChildT;
+   }
+
+   if (ulHoleT != ptsPrioV->ulCount)
+   {
+      ptsEntryT[ulHoleT] = ptsEntryT[ptsPrioV->ulCount];
+   }
+
+   return (true);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpPrioPush()                                                               //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool_t CpPrioPush(CpPrio_ts *ptsPrioV, const CpCanMsg_ts *ptsCanMsgV,
+                  uint32_t ulTickV)
+{
+   CpPrioEntry_ts * ptsEntryT;
+   CpPrioEntry_ts   tsNewT;
+   uint32_t         ulHoleT;
+   uint32_t         ulParentT;
+
+   if (ptsPrioV->ulCount >= ptsPrioV->ulIndexMax)
+   {
+      return (false);
+   }
+
+   tsNewT.ulKey      = CpPrioKey(ptsCanMsgV);
+   tsNewT.ulSequence = ptsPrioV->ulSequence++;
+   tsNewT.ulTick     = ulTickV;
+
+   //----------------------------------------------------------------
+   // move the new entry up from the bottom of the heap, the CAN
+   // message is copied only once
+   //
+   ptsEntryT = ptsPrioV->ptsEntry;
+   ulHoleT   = ptsPrioV->ulCount;
+   while (ulHoleT > 0)
+   {
+      ulParentT = (ulHoleT - 1) / 2;
+      if (!CpPrioIsBefore(&tsNewT, &ptsEntryT[ulParentT]))
+      {
+         break;
+      }
+      ptsEntryT[ulHoleT] = ptsEntryT[ulParentT];
+      ulHoleT = ulParentT;
+   }
+
+   ptsEntryT[ulHoleT].ulKey      = tsNewT.ulKey;
+   ptsEntryT[ulHoleT].ulSequence = tsNewT.ulSequence;
+   ptsEntryT[ulHoleT].ulTick     = tsNewT.ulTick;
+   ptsEntryT[ulHoleT].tsCanMsg   = *ptsCanMsgV;
+   ptsPrioV->ulCount++;
+
+   return (true);
+}
@@ -0,0 +1,296 @@
+//============================================================================//
+// File:          cp_prio.h                                                   //
+// Description:   CANpie priority ordered transmit queue                      //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+
+#ifndef  CP_PRIO_H_
+#define  CP_PRIO_H_
+
+//-----------------------------------------------------------------------------
+/*!
+** \file    cp_prio.h
+** \brief   CANpie priority ordered transmit queue
+**
+** A driver which transmits messages of a FIFO in order of submission
+** causes priority inversion: a message with a high priority waits
+** behind all messages which have been submitted before. On the CAN bus
+** the message with the high priority would win the arbitration.
+** The transmit queue defined in this file returns pending messages
+** ordered by the arbitration field, messages with the same identifier
+** keep the order of submission. The queueing delay is recorded for
+** #CP_PRIO_CLASS_MAX priority classes.
+*/
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#include "canpie.h"
+
+//-------------------------------------------------------------------//
+// take precautions if compiled with C++ compiler                    //
+#ifdef __cplusplus                                                   //
+extern "C" {                                                         //
+#endif                                                               //
+//-------------------------------------------------------------------//
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+/*!
+** \def  CP_PRIO_CLASS_MAX
+**
+** Number of priority classes for the queueing delay. The range of the
+** 11 most significant identifier bits is split into classes of equal
+** size, class 0 has the highest priority.
+*/
+#ifndef  CP_PRIO_CLASS_MAX
+#define  CP_PRIO_CLASS_MAX       4
+#endif
+
+
+/*----------------------------------------------------------------------------*\
+** Structures                                                                 **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*!
+** \struct  CpPrioDelay_s
+** \brief   Queueing delay of a priority class
+**
+** The delay is measured in ticks of the driver between CpPrioPush()
+** and CpPrioPop().
+*/
+struct CpPrioDelay_s
+{
+   /*! Number of messages taken from the queue
+   */
+   uint32_t  ulMsgCount;
+
+   /*! Sum of all delays, the value wraps around
+   */
+   uint32_t  ulDelaySum;
+
+   /*! Maximum delay
+   */
+   uint32_t  ulDelayMax;
+};
+/*!
+** \typedef    CpPrioDelay_ts
+*/
+typedef struct CpPrioDelay_s CpPrioDelay_ts;
+
+
+/*----------------------------------------------------------------------------*/
+/*!
+** \struct  CpPrioEntry_s
+** \brief   Entry of a priority ordered transmit queue
+*/
+struct CpPrioEntry_s
+{
+   /*! Arbitration key calculated by CpPrioKey()
+   */
+   uint32_t     ulKey;
+
+   /*! Sequence number, keeps the order of submission for equal keys
+   */
+   uint32_t     ulSequence;
+
+   /*! Tick value of CpPrioPush()
+   */
+   uint32_t     ulTick;
+
+   /*! CAN message
+   */
+   CpCanMsg_ts  tsCanMsg;
+};
+/*!
+** \typedef    CpPrioEntry_ts
+*/
+typedef struct CpPrioEntry_s CpPrioEntry_ts;
+
+
+/*----------------------------------------------------------------------------*/
+/*!
+** \struct  CpPrio_s
+** \brief   Administration variables of a priority ordered transmit queue
+**
+** This structure is initialised by CpPrioInit(). The entries are kept
+** as binary heap, the entry with the highest priority is the first
+** element of the array.
+*/
+struct CpPrio_s
+{
+   /*! Number of pending entries
+   */
+   uint32_t  ulCount;
+
+   /*! Maximum number of entries
+   */
+   uint32_t  ulIndexMax;
+
+   /*! Sequence number of the next entry
+   */
+   uint32_t  ulSequence;
+
+   /*! Pointer to array of entries
+   */
+   CpPrioEntry_ts *ptsEntry;
+
+   /*! Queueing delay for every priority class
+   */
+   CpPrioDelay_ts  atsDelay[CP_PRIO_CLASS_MAX];
+};
+/*!
+** \typedef    CpPrio_ts
+*/
+typedef struct CpPrio_s CpPrio_ts;
+
+
+/*----------------------------------------------------------------------------*\
+** Function prototypes                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+/*!
+** \brief   Get priority class of an arbitration key
+** \param   ulKeyV - Arbitration key
+** \return  Priority class, 0 is the highest priority
+*/
+uint8_t CpPrioClass(uint32_t ulKeyV);
+
+
+/*!
+** \brief   Get arbitration key of the first entry
+** \param   ptsPrioV - Pointer to transmit queue
+** \param   pulKeyV - Pointer to arbitration key
+** \return  true if the queue is not empty
+**
+** A driver with several transmit queues uses this function to select
+** the queue which holds the message with the highest priority.
+*/
+bool_t CpPrioHead(CpPrio_ts *ptsPrioV, uint32_t *pulKeyV);
+
+
+/*!
+** \brief   Initialise transmit queue
+** \param   ptsPrioV - Pointer to transmit queue
+** \param   ptsEntryV - Pointer to array of entries
+** \param   ulSizeV - Number of entries of the array
+**
+** This function initialises a transmit queue and clears the queueing
+** delay of all priority classes.
+*/
+void CpPrioInit(CpPrio_ts *ptsPrioV, CpPrioEntry_ts *ptsEntryV,
+                uint32_t ulSizeV);
+
+
+/*!
+** \brief   Test for empty queue
+** \param   ptsPrioV - Pointer to transmit queue
+** \return  true if the queue is empty
+*/
+bool_t CpPrioIsEmpty(CpPrio_ts *ptsPrioV);
+
+
+/*!
+** \brief   Test for full queue
+** \param   ptsPrioV - Pointer to transmit queue
+** \return  true if the queue is full
+*/
+bool_t CpPrioIsFull(CpPrio_ts *ptsPrioV);
+
+
+/*!
+** \brief   Calculate arbitration key of a CAN message
+** \param   ptsCanMsgV - Pointer to CAN message
+** \return  Arbitration key
+**
+** The key is built from the arbitration field in order of transmission
+** on the bus: base identifier, RTR / SRR bit, IDE bit, identifier
+** extension and RTR bit of extended frames. A lower key value denotes
+** a higher priority, so a base frame wins against an extended frame
+** with the same base identifier and a data frame wins against a remote
+** frame.
+*/
+uint32_t CpPrioKey(const CpCanMsg_ts *ptsCanMsgV);
+
+
+/*!
+** \brief   Get number of pending entries
+** \param   ptsPrioV - Pointer to transmit queue
+** \return  Number of pending entries
+*/
+uint32_t CpPrioPending(CpPrio_ts *ptsPrioV);
+
+
+/*!
+** \brief   Take message with the highest priority from the queue
+** \param   ptsPrioV - Pointer to transmit queue
+** \param   ptsCanMsgV - Pointer to CAN message
+** \param   ulTickV - Present tick value
+** \return  true if a message has been copied to \a ptsCanMsgV
+**
+** The queueing delay of the message is added to its priority class.
+** The tick counter may wrap around.
+*/
+bool_t CpPrioPop(CpPrio_ts *ptsPrioV, CpCanMsg_ts *ptsCanMsgV,
+                 uint32_t ulTickV);
+
+
+/*!
+** \brief   Add message to the queue
+** \param   ptsPrioV - Pointer to transmit queue
+** \param   ptsCanMsgV - Pointer to CAN message
+** \param   ulTickV - Present tick value
+** \return  false if the queue is full
+*/
+bool_t CpPrioPush(CpPrio_ts *ptsPrioV, const CpCanMsg_ts *ptsCanMsgV,
+                  uint32_t ulTickV);
+
+
+//-------------------------------------------------------------------//
+#ifdef __cplusplus                                                   //
+}                                                                    //
+#endif                                                               //
+// end of C++ compiler wrapper                                       //
+//-------------------------------------------------------------------//
+
+
+#endif   // CP_PRIO_H_
@@ -81,6 +81,10 @@
 
 #define  CP_STATISTIC               1
 
+#ifndef  CP_TRM_PRIORITY
+#define  CP_TRM_PRIORITY            0
+#endif
+
 
 
 /*----------------------------------------------------------------------------*\
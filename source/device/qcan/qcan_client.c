@@ -0,0 +1,818 @@
+//============================================================================//
+// File:          qcan_client.c                                               //
+// Description:   Qt-free client for the QCan server protocol                 //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// the socket API is not part of C99
+//
+#ifndef  _POSIX_C_SOURCE
+#define  _POSIX_C_SOURCE   200809L
+#endif
+
+#include "qcan_client.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// position of fields inside a record
+//
+#define  RECORD_POS_ID           0
+#define  RECORD_POS_DLC          4
+#define  RECORD_POS_CTRL         5
+#define  RECORD_POS_DATA         6
+#define  RECORD_POS_TIME_SEC     70
+#define  RECORD_POS_TIME_NSEC    74
+#define  RECORD_POS_USER         78
+#define  RECORD_POS_MARKER       82
+#define  RECORD_POS_UNUSED       86
+#define  RECORD_POS_TYPE         87
+#define  RECORD_POS_CHECKSUM     94
+
+#define  RECORD_DATA_SIZE        64
+
+//-------------------------------------------------------------------
+// size of the receive and transmit buffer
+//
+#define  CLIENT_BUFFER_SIZE      (QCAN_CLIENT_FRAME_MAX * QCAN_CLIENT_RECORD_SIZE)
+
+//-------------------------------------------------------------------
+// a broken connection must not raise SIGPIPE
+//
+#ifdef   MSG_NOSIGNAL
+#define  CLIENT_SEND_FLAGS       MSG_NOSIGNAL
+#else
+#define  CLIENT_SEND_FLAGS       0
+#endif
+
+
+/*----------------------------------------------------------------------------*\
+** Variables of module                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// CRC-16 ISO 3309 (polynomial 0x1021, reflected), one entry per byte
+//
+static CPP_CONST uint16_t auwChecksumTableS[256] = {
+   0x0000, 0x1189, 0x2312, 0x329B, 0x4624, 0x57AD, 0x6536, 0x74BF,
+   0x8C48, 0x9DC1, 0xAF5A, 0xBED3, 0xCA6C, 0xDBE5, 0xE97E, 0xF8F7,
+   0x1081, 0x0108, 0x3393, 0x221A, 0x56A5, 0x472C, 0x75B7, 0x643E,
+   0x9CC9, 0x8D40, 0xBFDB, 0xAE52, 0xDAED, 0xCB64, 0xF9FF, 0xE876,
+   0x2102, 0x308B, 0x0210, 0x1399, 0x6726, 0x76AF, 0x4434, 0x55BD,
+   0xAD4A, 0xBCC3, 0x8E58, 0x9FD1, 0xEB6E, 0xFAE7, 0xC87C, 0xD9F5,
+   0x3183, 0x200A, 0x1291, 0x0318, 0x77A7, 0x662E, 0x54B5, 0x453C,
+   0xBDCB, 0xAC42, 0x9ED9, 0x8F50, 0xFBEF, 0xEA66, 0xD8FD, 0xC974,
+   0x4204, 0x538D, 0x6116, 0x709F, 0x0420, 0x15A9, 0x2732, 0x36BB,
+   0xCE4C, 0xDFC5, 0xED5E, 0xFCD7, 0x8868, 0x99E1, 0xAB7A, 0xBAF3,
+   0x5285, 0x430C, 0x7197, 0x601E, 0x14A1, 0x0528, 0x37B3, 0x263A,
+   0xDECD, 0xCF44, 0xFDDF, 0xEC56, 0x98E9, 0x8960, 0xBBFB, 0xAA72,
+   0x6306, 0x728F, 0x4014, 0x519D, 0x2522, 0x34AB, 0x0630, 0x17B9,
+   0xEF4E, 0xFEC7, 0xCC5C, 0xDDD5, 0xA96A, 0xB8E3, 0x8A78, 0x9BF1,
+   0x7387, 0x620E, 0x5095, 0x411C, 0x35A3, 0x242A, 0x16B1, 0x0738,
+   0xFFCF, 0xEE46, 0xDCDD, 0xCD54, 0xB9EB, 0xA862, 0x9AF9, 0x8B70,
+   0x8408, 0x9581, 0xA71A, 0xB693, 0xC22C, 0xD3A5, 0xE13E, 0xF0B7,
+   0x0840, 0x19C9, 0x2B52, 0x3ADB, 0x4E64, 0x5FED, 0x6D76, 0x7CFF,
+   0x9489, 0x8500, 0xB79B, 0xA612, 0xD2AD, 0xC324, 0xF1BF, 0xE036,
+   0x18C1, 0x0948, 0x3BD3, 0x2A5A, 0x5EE5, 0x4F6C, 0x7DF7, 0x6C7E,
+   0xA50A, 0xB483, 0x8618, 0x9791, 0xE32E, 0xF2A7, 0xC03C, 0xD1B5,
+   0x2942, 0x38CB, 0x0A50, 0x1BD9, 0x6F66, 0x7EEF, 0x4C74, 0x5DFD,
+   0xB58B, 0xA402, 0x9699, 0x8710, 0xF3AF, 0xE226, 0xD0BD, 0xC134,
+   0x39C3, 0x284A, 0x1AD1, 0x0B58, 0x7FE7, 0x6E6E, 0x5CF5, 0x4D7C,
+   0xC60C, 0xD785, 0xE51E, 0xF497, 0x8028, 0x91A1, 0xA33A, 0xB2B3,
+   0x4A44, 0x5BCD, 0x6956, 0x78DF, 0x0C60, 0x1DE9, 0x2F72, 0x3EFB,
+   0xD68D, 0xC704, 0xF59F, 0xE416, 0x90A9, 0x8120, 0xB3BB, 0xA232,
+   0x5AC5, 0x4B4C, 0x79D7, 0x685E, 0x1CE1, 0x0D68, 0x3FF3, 0x2E7A,
+   0xE70E, 0xF687, 0xC41C, 0xD595, 0xA12A, 0xB0A3, 0x8238, 0x93B1,
+   0x6B46, 0x7ACF, 0x4854, 0x59DD, 0x2D62, 0x3CEB, 0x0E70, 0x1FF9,
+   0xF78F, 0xE606, 0xD49D, 0xC514, 0xB1AB, 0xA022, 0x92B9, 0x8330,
+   0x7BC7, 0x6A4E, 0x58D5, 0x495C, 0x3DE3, 0x2C6A, 0x1EF1, 0x0F78
+};
+
+
+/*----------------------------------------------------------------------------*\
+** Function implementation                                                    **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//----------------------------------------------------------------------------//
+// ClientConnectLocal()                                                       //
+// connect to local server of a network                                       //
+//----------------------------------------------------------------------------//
+static int ClientConnectLocal(uint8_t ubChannelV)
+{
+   struct sockaddr_un   tsAddrT;
+   CPP_CONST char *     pszDirT;
+   size_t               ulDirLenT;
+   int                  slSocketT;
+   int                  slSizeT;
+
+   //----------------------------------------------------------------
+   // QLocalServer places the socket inside QDir::tempPath(), which
+   // is defined by TMPDIR without a trailing separator
+   //
+   pszDirT = getenv("TMPDIR");
+   if ((pszDirT == (CPP_CONST char *) 0L) || (pszDirT[0] == '\0'))
+   {
+      pszDirT = "/tmp";
+   }
+   ulDirLenT = strlen(pszDirT);
+   while ((ulDirLenT > 1) && (pszDirT[ulDirLenT - 1] == '/'))
+   {
+      ulDirLenT--;
+   }
+
+   memset(&tsAddrT, 0, sizeof(tsAddrT));
+   tsAddrT.sun_family = AF_UNIX;
+   slSizeT = snprintf(tsAddrT.sun_path, sizeof(tsAddrT.sun_path),
+                      "%.*s/%s%d", (int) ulDirLenT, pszDirT,
+                      QCAN_CLIENT_SERVER_NAME, (int) ubChannelV);
+   if ((slSizeT < 0) || ((size_t) slSizeT >= sizeof(tsAddrT.sun_path)))
+   {
+      return (-1);
+   }
+
+   slSocketT = socket(AF_UNIX, SOCK_STREAM, 0);
+   if (slSocketT < 0)
+   {
+      return (-1);
+   }
+
+   if (connect(slSocketT, (struct sockaddr *) &tsAddrT, sizeof(tsAddrT)) < 0)
+   {
+      close(slSocketT);
+      return (-1);
+   }
+
+   return (slSocketT);
+}
+
+
+//----------------------------------------------------------------------------//
+// ClientConnectTcp()                                                         //
+// connect to TCP server of a network                                         //
+//----------------------------------------------------------------------------//
+static int ClientConnectTcp(CPP_CONST char *pszHostV, uint16_t uwPortV)
+{
+   struct addrinfo      tsHintsT;
+   struct addrinfo *    ptsAddrListT;
+   struct addrinfo *    ptsAddrT;
+   char                 aszPortT[8];
+   int                  slSocketT = -1;
+   int                  slFlagT   = 1;
+
+   memset(&tsHintsT, 0, sizeof(tsHintsT));
+   tsHintsT.ai_family   = AF_UNSPEC;
+   tsHintsT.ai_socktype = SOCK_STREAM;
+   snprintf(aszPortT, sizeof(aszPortT), "%u", (unsigned int) uwPortV);
+
+   if (getaddrinfo(pszHostV, aszPortT, &tsHintsT, &ptsAddrListT) != 0)
+   {
+      return (-1);
+   }
+
+   //----------------------------------------------------------------
+   // try all addresses of the host until a connection is made
+   //
+   for (ptsAddrT = ptsAddrListT; ptsAddrT != 0L; ptsAddrT = ptsAddrT->ai_next)
+   {
+      slSocketT = socket(ptsAddrT->ai_family, ptsAddrT->ai_socktype,
+                         ptsAddrT->ai_protocol);
+      if (slSocketT < 0)
+      {
+         continue;
+      }
+
+      if (connect(slSocketT, ptsAddrT->ai_addr, ptsAddrT->ai_addrlen) == 0)
+      {
+         break;
+      }
+
+      close(slSocketT);
+      slSocketT = -1;
+   }
+   freeaddrinfo(ptsAddrListT);
+
+   //----------------------------------------------------------------
+   // the records are collected by the client, so the Nagle
+   // algorithm only adds latency
+   //
+   if (slSocketT >= 0)
+   {
+      setsockopt(slSocketT, IPPROTO_TCP, TCP_NODELAY,
+                 &slFlagT, sizeof(slFlagT));
+   }
+
+   return (slSocketT);
+}
+
+
+//----------------------------------------------------------------------------//
+// ClientTick()                                                               //
+// monotonic time in milli-seconds                                            //
+//----------------------------------------------------------------------------//
+static uint32_t ClientTick(void)
+{
+   struct timespec tsTimeT;
+
+   clock_gettime(CLOCK_MONOTONIC, &tsTimeT);
+   return ((uint32_t) (tsTimeT.tv_sec * 1000) +
+           (uint32_t) (tsTimeT.tv_nsec / 1000000));
+}
+
+
+//----------------------------------------------------------------------------//
+// GetLong()                                                                  //
+// read 32 bit value, MSB first                                               //
+//----------------------------------------------------------------------------//
+static uint32_t GetLong(CPP_CONST uint8_t *pubSrcV)
+{
+   return (((uint32_t) pubSrcV[0] << 24) | ((uint32_t) pubSrcV[1] << 16) |
+           ((uint32_t) pubSrcV[2] <<  8) | ((uint32_t) pubSrcV[3]));
+}
+
+
+//----------------------------------------------------------------------------//
+// PutLong()                                                                  //
+// write 32 bit value, MSB first                                              //
+//----------------------------------------------------------------------------//
+static void PutLong(uint8_t *pubDestV, uint32_t ulValueV)
+{
+   pubDestV[0] = (uint8_t) (ulValueV >> 24);
+   pubDestV[1] = (uint8_t) (ulValueV >> 16);
+   pubDestV[2] = (uint8_t) (ulValueV >>  8);
+   pubDestV[3] = (uint8_t) (ulValueV);
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientChecksum()                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint16_t QCanClientChecksum(CPP_CONST uint8_t *pubDataV, uint32_t ulSizeV)
+{
+   uint16_t uwCrcT = 0xFFFF;
+
+   while (ulSizeV > 0)
+   {
+      uwCrcT = (uint16_t) ((uwCrcT >> 8) ^
+                           auwChecksumTableS[(uwCrcT ^ *pubDataV) & 0xFF]);
+      pubDataV++;
+      ulSizeV--;
+   }
+
+   return ((uint16_t) ~uwCrcT);
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientConnect()                                                        //
+//                                                                            //
+//----------------------------------------------------------------------------//
+int32_t QCanClientConnect(QCanClient_ts *ptsClientV, uint8_t ubChannelV,
+                          CPP_CONST char *pszHostV, uint16_t uwPortV)
+{
+   int   slSocketT;
+   int   slFlagsT;
+
+   QCanClientDisconnect(ptsClientV);
+
+   if (ubChannelV == 0)
+   {
+      return (-1);
+   }
+
+   //----------------------------------------------------------------
+   // like QCanSocket each network has its own local server
+   // and TCP port
+   //
+   if (pszHostV == (CPP_CONST char *) 0L)
+   {
+      slSocketT = ClientConnectLocal(ubChannelV);
+   }
+   else
+   {
+      if (uwPortV == 0)
+      {
+         uwPortV = QCAN_CLIENT_TCP_PORT;
+      }
+      slSocketT = ClientConnectTcp(pszHostV,
+                                   (uint16_t) (uwPortV + ubChannelV - 1));
+   }
+
+   if (slSocketT < 0)
+   {
+      return (-1);
+   }
+
+   //----------------------------------------------------------------
+   // all transfers are non-blocking
+   //
+   slFlagsT = fcntl(slSocketT, F_GETFL, 0);
+   if ((slFlagsT < 0) || (fcntl(slSocketT, F_SETFL, slFlagsT | O_NONBLOCK) < 0))
+   {
+      close(slSocketT);
+      return (-1);
+   }
+
+   #ifdef SO_NOSIGPIPE
+   slFlagsT = 1;
+   setsockopt(slSocketT, SOL_SOCKET, SO_NOSIGPIPE, &slFlagsT, sizeof(slFlagsT));
+   #endif
+
+   ptsClientV->slSocket  = (int32_t) slSocketT;
+   ptsClientV->ubChannel = ubChannelV;
+
+   return (0);
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientDisconnect()                                                     //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void QCanClientDisconnect(QCanClient_ts *ptsClientV)
+{
+   if (ptsClientV->slSocket >= 0)
+   {
+      close((int) ptsClientV->slSocket);
+   }
+
+   ptsClientV->slSocket   = -1;
+   ptsClientV->ulRcvCount = 0;
+   ptsClientV->ulRcvIndex = 0;
+   ptsClientV->ulTrmCount = 0;
+   ptsClientV->ulTrmIndex = 0;
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientFlush()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+int32_t QCanClientFlush(QCanClient_ts *ptsClientV)
+{
+   ssize_t  slSizeT;
+
+   if (ptsClientV->slSocket < 0)
+   {
+      return (-1);
+   }
+
+   while (ptsClientV->ulTrmIndex < ptsClientV->ulTrmCount)
+   {
+      slSizeT = send((int) ptsClientV->slSocket,
+                     &(ptsClientV->aubTrmBuffer[ptsClientV->ulTrmIndex]),
+                     ptsClientV->ulTrmCount - ptsClientV->ulTrmIndex,
+                     CLIENT_SEND_FLAGS);
+      if (slSizeT > 0)
+      {
+         ptsClientV->ulTrmIndex += (uint32_t) slSizeT;
+      }
+      else if ((slSizeT < 0) && (errno == EINTR))
+      {
+         continue;
+      }
+      else if ((slSizeT < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+      {
+         break;
+      }
+      else
+      {
+         QCanClientDisconnect(ptsClientV);
+         return (-1);
+      }
+   }
+
+   if (ptsClientV->ulTrmIndex == ptsClientV->ulTrmCount)
+   {
+      ptsClientV->ulTrmCount = 0;
+      ptsClientV->ulTrmIndex = 0;
+   }
+
+   return ((int32_t) (ptsClientV->ulTrmCount - ptsClientV->ulTrmIndex));
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientInit()                                                           //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void QCanClientInit(QCanClient_ts *ptsClientV)
+{
+   ptsClientV->slSocket     = -1;
+   ptsClientV->ubChannel    = 0;
+   ptsClientV->ulErrorCount = 0;
+   QCanClientDisconnect(ptsClientV);
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientIsErrorFrame()                                                   //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool_t QCanClientIsErrorFrame(CPP_CONST CpCanMsg_ts *ptsCanMsgV)
+{
+   return ((ptsCanMsgV->ulIdentifier & QCAN_CLIENT_TYPE_ERROR) > 0);
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientRecordDecode()                                                   //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool_t QCanClientRecordDecode(CPP_CONST uint8_t *pubRecordV,
+                              CpCanMsg_ts *ptsCanMsgV)
+{
+   uint16_t uwChecksumT;
+
+   //----------------------------------------------------------------
+   // the checksum covers byte 0 .. 93
+   //
+   uwChecksumT = (uint16_t) ((pubRecordV[RECORD_POS_CHECKSUM] << 8) |
+                             pubRecordV[RECORD_POS_CHECKSUM + 1]);
+   if (uwChecksumT != QCanClientChecksum(pubRecordV, RECORD_POS_CHECKSUM))
+   {
+      return (false);
+   }
+
+   ptsCanMsgV->ulIdentifier = GetLong(&pubRecordV[RECORD_POS_ID]);
+   ptsCanMsgV->ubMsgDLC     = pubRecordV[RECORD_POS_DLC];
+   ptsCanMsgV->ubMsgCtrl    = pubRecordV[RECORD_POS_CTRL];
+   #if CP_CAN_FD == 0
+   memcpy(&(ptsCanMsgV->tuMsgData.aubByte[0]),
+          &pubRecordV[RECORD_POS_DATA], CP_DATA_SIZE);
+   #else
+   memcpy(&(ptsCanMsgV->tuMsgData.aubByte[0]),
+          &pubRecordV[RECORD_POS_DATA], RECORD_DATA_SIZE);
+   #endif
+
+   #if CP_CAN_MSG_TIME == 1
+   ptsCanMsgV->tsMsgTime.ulSec1970 = GetLong(&pubRecordV[RECORD_POS_TIME_SEC]);
+   ptsCanMsgV->tsMsgTime.ulNanoSec = GetLong(&pubRecordV[RECORD_POS_TIME_NSEC]);
+   #endif
+
+   #if CP_CAN_MSG_USER == 1
+   ptsCanMsgV->ulMsgUser   = GetLong(&pubRecordV[RECORD_POS_USER]);
+   #endif
+
+   #if CP_CAN_MSG_MARKER == 1
+   ptsCanMsgV->ulMsgMarker = GetLong(&pubRecordV[RECORD_POS_MARKER]);
+   #endif
+
+   return (true);
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientRecordEncode()                                                   //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void QCanClientRecordEncode(CPP_CONST CpCanMsg_ts *ptsCanMsgV,
+                            uint8_t *pubRecordV)
+{
+   uint16_t uwChecksumT;
+
+   PutLong(&pubRecordV[RECORD_POS_ID], ptsCanMsgV->ulIdentifier);
+   pubRecordV[RECORD_POS_DLC]  = ptsCanMsgV->ubMsgDLC;
+   pubRecordV[RECORD_POS_CTRL] = ptsCanMsgV->ubMsgCtrl;
+   #if CP_CAN_FD == 0
+   memcpy(&pubRecordV[RECORD_POS_DATA],
+          &(ptsCanMsgV->tuMsgData.aubByte[0]), CP_DATA_SIZE);
+   memset(&pubRecordV[RECORD_POS_DATA + CP_DATA_SIZE], 0x00,
+          RECORD_DATA_SIZE - CP_DATA_SIZE);
+   #else
+   memcpy(&pubRecordV[RECORD_POS_DATA],
+          &(ptsCanMsgV->tuMsgData.aubByte[0]), RECORD_DATA_SIZE);
+   #endif
+
+   #if CP_CAN_MSG_TIME == 1
+   PutLong(&pubRecordV[RECORD_POS_TIME_SEC],  ptsCanMsgV->tsMsgTime.ulSec1970);
+   PutLong(&pubRecordV[RECORD_POS_TIME_NSEC], ptsCanMsgV->tsMsgTime.ulNanoSec);
+   #else
+   memset(&pubRecordV[RECORD_POS_TIME_SEC], 0x00, 8);
+   #endif
+
+   #if CP_CAN_MSG_USER == 1
+   PutLong(&pubRecordV[RECORD_POS_USER], ptsCanMsgV->ulMsgUser);
+   #else
+   memset(&pubRecordV[RECORD_POS_USER], 0x00, 4);
+   #endif
+
+   #if CP_CAN_MSG_MARKER == 1
+   PutLong(&pubRecordV[RECORD_POS_MARKER], ptsCanMsgV->ulMsgMarker);
+   #else
+   memset(&pubRecordV[RECORD_POS_MARKER], 0x00, 4);
+   #endif
+
+   //----------------------------------------------------------------
+   // byte 86 .. 93 are not used, the checksum covers byte 0 .. 93
+   //
+   memset(&pubRecordV[RECORD_POS_UNUSED], 0x00,
+          RECORD_POS_CHECKSUM - RECORD_POS_UNUSED);
+   uwChecksumT = QCanClientChecksum(pubRecordV, RECORD_POS_CHECKSUM);
+   pubRecordV[RECORD_POS_CHECKSUM]     = (uint8_t) (uwChecksumT >> 8);
+   pubRecordV[RECORD_POS_CHECKSUM + 1] = (uint8_t) (uwChecksumT);
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientRead()                                                           //
+//                                                                            //
+//----------------------------------------------------------------------------//
+int32_t QCanClientRead(QCanClient_ts *ptsClientV, CpCanMsg_ts *ptsCanMsgV,
+                       uint32_t ulMsgMaxV)
+{
+   CPP_CONST uint8_t *  pubRecordT;
+   ssize_t              slSizeT;
+   uint32_t             ulMsgCntT = 0;
+   uint32_t             ulRestT;
+   bool_t               btReceivedT = false;
+
+   if (ptsClientV->slSocket < 0)
+   {
+      return (-1);
+   }
+
+   while (ulMsgCntT < ulMsgMaxV)
+   {
+      //--------------------------------------------------------
+      // decode the complete records of the receive buffer
+      //
+      if ((ptsClientV->ulRcvCount - ptsClientV->ulRcvIndex) >=
+          QCAN_CLIENT_RECORD_SIZE)
+      {
+         pubRecordT = &(ptsClientV->aubRcvBuffer[ptsClientV->ulRcvIndex]);
+         ptsClientV->ulRcvIndex += QCAN_CLIENT_RECORD_SIZE;
+
+         if (pubRecordT[RECORD_POS_TYPE] != 0)
+         {
+            continue;
+         }
+
+         if (QCanClientRecordDecode(pubRecordT, ptsCanMsgV) == false)
+         {
+            ptsClientV->ulErrorCount++;
+            continue;
+         }
+
+         ptsCanMsgV++;
+         ulMsgCntT++;
+         continue;
+      }
+
+      //--------------------------------------------------------
+      // the socket is read once per call, so a busy network
+      // can not hold the caller inside this function
+      //
+      if (btReceivedT == true)
+      {
+         break;
+      }
+      btReceivedT = true;
+
+      //--------------------------------------------------------
+      // move an incomplete record to the start of the buffer
+      //
+      ulRestT = ptsClientV->ulRcvCount - ptsClientV->ulRcvIndex;
+      if ((ulRestT > 0) && (ptsClientV->ulRcvIndex > 0))
+      {
+         memmove(&(ptsClientV->aubRcvBuffer[0]),
+                 &(ptsClientV->aubRcvBuffer[ptsClientV->ulRcvIndex]),
+                 ulRestT);
+      }
+      ptsClientV->ulRcvCount = ulRestT;
+      ptsClientV->ulRcvIndex = 0;
+
+      do
+      {
+         slSizeT = recv((int) ptsClientV->slSocket,
+                        &(ptsClientV->aubRcvBuffer[ulRestT]),
+                        CLIENT_BUFFER_SIZE - ulRestT, 0);
+      } while ((slSizeT < 0) && (errno == EINTR));
+
+      if (slSizeT > 0)
+      {
+         ptsClientV->ulRcvCount += (uint32_t) slSizeT;
+      }
+      else if ((slSizeT < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+      {
+         break;
+      }
+      else
+      {
+         //------------------------------------------------
+         // connection closed by the server, messages which
+         // have already been decoded are returned first
+         //
+         QCanClientDisconnect(ptsClientV);
+         if (ulMsgCntT == 0)
+         {
+            return (-1);
+         }
+         break;
+      }
+   }
+
+   return ((int32_t) ulMsgCntT);
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientWait()                                                           //
+//                                                                            //
+//----------------------------------------------------------------------------//
+int32_t QCanClientWait(QCanClient_ts *ptsClientV, int32_t slTimeoutV)
+{
+   struct pollfd  tsPollT;
+   uint32_t       ulStartT;
+   uint32_t       ulElapsedT;
+   int            slWaitT;
+   int            slResultT;
+
+   if (ptsClientV->slSocket < 0)
+   {
+      return (-1);
+   }
+
+   //----------------------------------------------------------------
+   // records which have been received by the last call of
+   // QCanClientRead() are available without waiting
+   //
+   if ((ptsClientV->ulRcvCount - ptsClientV->ulRcvIndex) >=
+       QCAN_CLIENT_RECORD_SIZE)
+   {
+      return (1);
+   }
+
+   ulStartT = ClientTick();
+   while (1)
+   {
+      slWaitT = (int) slTimeoutV;
+      if (slTimeoutV > 0)
+      {
+         ulElapsedT = ClientTick() - ulStartT;
+         if (ulElapsedT >= (uint32_t) slTimeoutV)
+         {
+            slWaitT = 0;
+         }
+         else
+         {
+            slWaitT = (int) ((uint32_t) slTimeoutV - ulElapsedT);
+         }
+      }
+
+      tsPollT.fd      = (int) ptsClientV->slSocket;
+      tsPollT.events  = POLLIN;
+      tsPollT.revents = 0;
+      if (ptsClientV->ulTrmIndex < ptsClientV->ulTrmCount)
+      {
+         tsPollT.events |= POLLOUT;
+      }
+
+      slResultT = poll(&tsPollT, 1, slWaitT);
+      if (slResultT < 0)
+      {
+         if (errno == EINTR)
+         {
+            continue;
+         }
+         return (-1);
+      }
+
+      if (slResultT == 0)
+      {
+         return (0);
+      }
+
+      if ((tsPollT.revents & POLLOUT) != 0)
+      {
+         if (QCanClientFlush(ptsClientV) < 0)
+         {
+            return (-1);
+         }
+      }
+
+      //--------------------------------------------------------
+      // a closed connection is reported by the next call of
+      // QCanClientRead()
+      //
+      if ((tsPollT.revents & (POLLIN | POLLHUP | POLLERR)) != 0)
+      {
+         return (1);
+      }
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// QCanClientWrite()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+int32_t QCanClientWrite(QCanClient_ts *ptsClientV,
+                        CPP_CONST CpCanMsg_ts *ptsCanMsgV,
+                        uint32_t ulMsgCntV)
+{
+   uint32_t ulMsgCntT = 0;
+   uint32_t ulRestT;
+
+   //----------------------------------------------------------------
+   // send the rest of the last call first, so the order of the
+   // records is kept
+   //
+   if (QCanClientFlush(ptsClientV) < 0)
+   {
+      return (-1);
+   }
+
+   ulRestT = ptsClientV->ulTrmCount - ptsClientV->ulTrmIndex;
+   if ((ulRestT > 0) && (ptsClientV->ulTrmIndex > 0))
+   {
+      memmove(&(ptsClientV->aubTrmBuffer[0]),
+              &(ptsClientV->aubTrmBuffer[ptsClientV->ulTrmIndex]),
+              ulRestT);
+      ptsClientV->ulTrmCount = ulRestT;
+      ptsClientV->ulTrmIndex = 0;
+   }
+
+   //----------------------------------------------------------------
+   // encode as many messages as the transmit buffer can hold and
+   // send them with one system call
+   //
+   while ((ulMsgCntT < ulMsgCntV) &&
+          ((CLIENT_BUFFER_SIZE - ptsClientV->ulTrmCount) >=
+           QCAN_CLIENT_RECORD_SIZE))
+   {
+      QCanClientRecordEncode(ptsCanMsgV,
+                             &(ptsClientV->aubTrmBuffer[ptsClientV->ulTrmCount]));
+      ptsClientV->ulTrmCount += QCAN_CLIENT_RECORD_SIZE;
+      ptsCanMsgV++;
+      ulMsgCntT++;
+   }
+
+   if (ulMsgCntT > 0)
+   {
+      if (QCanClientFlush(ptsClientV) < 0)
+      {
+         return (-1);
+      }
+   }
+
+   return ((int32_t) ulMsgCntT);
+}
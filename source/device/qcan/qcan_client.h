@@ -0,0 +1,345 @@
+//============================================================================//
+// File:          qcan_client.h                                               //
+// Description:   Qt-free client for the QCan server protocol                 //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+#ifndef  QCAN_CLIENT_H_
+#define  QCAN_CLIENT_H_
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+#include "canpie.h"
+
+
+//-----------------------------------------------------------------------------
+/*!
+** \file    qcan_client.h
+** \brief   Qt-free client for the QCan server protocol
+**
+** The client connects to a network of a running QCanServer in the same way
+** as QCanSocket, but only needs the C library of a POSIX system. A network
+** is reached either via the local server \c CANpieServerChannel<n> (Unix
+** domain socket inside the temporary directory) or via TCP on port
+** #QCAN_CLIENT_TCP_PORT + n - 1.
+**
+** Every CAN frame is transferred as record of #QCAN_CLIENT_RECORD_SIZE
+** bytes, which has the layout of QCanFrame::toByteArray():
+**
+** | Offset | Size | Content                                        |
+** |--------|------|------------------------------------------------|
+** | 0      | 4    | Identifier, frame type in bit 29 .. 31 (MSB first) |
+** | 4      | 1    | Data length code                               |
+** | 5      | 1    | Message control field                          |
+** | 6      | 64   | Data                                           |
+** | 70     | 8    | Time-stamp, seconds and nano-seconds (MSB first) |
+** | 78     | 4    | User field (MSB first)                         |
+** | 82     | 4    | Marker field (MSB first)                       |
+** | 86     | 8    | Not used, a value other than 0 at offset 87 denotes a control record |
+** | 94     | 2    | Checksum of byte 0 .. 93 (MSB first)           |
+**
+** The bits of the message control field match the CANpie definitions
+** (see #CP_MSG_CTRL_EXT_BIT etc.), so a record is converted directly from
+** and to a CpCanMsg_ts structure. The identifier of a CpCanMsg_ts read
+** by QCanClientRead() keeps the frame type bits, error frames are tested
+** with QCanClientIsErrorFrame().
+**
+** The socket is non-blocking: QCanClientRead() and QCanClientWrite()
+** transfer as many records as possible with one system call and return
+** immediately. QCanClientWait() blocks until records are available.
+** A client must only be used by one thread at a time.
+*/
+
+
+//-------------------------------------------------------------------//
+// take precautions if compiled with C++ compiler                    //
+#ifdef __cplusplus                                                   //
+extern "C" {                                                         //
+#endif                                                               //
+//-------------------------------------------------------------------//
+
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+/*!
+** \def  QCAN_CLIENT_RECORD_SIZE
+** Size of a CAN frame record in bytes, equal to QCAN_FRAME_ARRAY_SIZE
+*/
+#define  QCAN_CLIENT_RECORD_SIZE    ((uint32_t) 96)
+
+/*!
+** \def  QCAN_CLIENT_FRAME_MAX
+** Number of records the receive and the transmit buffer of a client can
+** hold, this is also the maximum number of frames transferred by one
+** system call
+*/
+#ifndef  QCAN_CLIENT_FRAME_MAX
+#define  QCAN_CLIENT_FRAME_MAX      ((uint32_t) 64)
+#endif
+
+/*!
+** \def  QCAN_CLIENT_TCP_PORT
+** TCP port of the first network, equal to QCAN_TCP_DEFAULT_PORT
+*/
+#define  QCAN_CLIENT_TCP_PORT       ((uint16_t) 55660)
+
+/*!
+** \def  QCAN_CLIENT_SERVER_NAME
+** Name of the local server of a network, the number of the network is
+** appended
+*/
+#define  QCAN_CLIENT_SERVER_NAME    "CANpieServerChannel"
+
+/*!
+** \def  QCAN_CLIENT_TYPE_ERROR
+** Identifier bit of an error frame, the data bytes 0 .. 3 hold the CAN
+** state, the error type, the receive and the transmit error counter
+*/
+#define  QCAN_CLIENT_TYPE_ERROR     ((uint32_t) 0x20000000)
+
+/*!
+** \def  QCAN_CLIENT_TYPE_MASK
+** Identifier bits of the frame type, a data frame has no bit set
+*/
+#define  QCAN_CLIENT_TYPE_MASK      ((uint32_t) 0xE0000000)
+
+
+/*----------------------------------------------------------------------------*\
+** Structures                                                                 **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*!
+** \struct  QCanClient_s
+** \brief   Connection of a client to a QCan network
+**
+** This structure is initialised by QCanClientInit().
+*/
+typedef struct QCanClient_s
+{
+   /*! File descriptor of the socket, -1 if not connected
+   */
+   int32_t  slSocket;
+
+   /*! Number of the network, first network is eCP_CHANNEL_1
+   */
+   uint8_t  ubChannel;
+
+   /*! Received bytes, may end with an incomplete record
+   */
+   uint8_t  aubRcvBuffer[QCAN_CLIENT_FRAME_MAX * QCAN_CLIENT_RECORD_SIZE];
+
+   /*! Number of bytes stored in aubRcvBuffer
+   */
+   uint32_t ulRcvCount;
+
+   /*! Position of the next record inside aubRcvBuffer
+   */
+   uint32_t ulRcvIndex;
+
+   /*! Records which have not been sent completely
+   */
+   uint8_t  aubTrmBuffer[QCAN_CLIENT_FRAME_MAX * QCAN_CLIENT_RECORD_SIZE];
+
+   /*! Number of bytes stored in aubTrmBuffer
+   */
+   uint32_t ulTrmCount;
+
+   /*! Number of bytes of aubTrmBuffer which have already been sent
+   */
+   uint32_t ulTrmIndex;
+
+   /*! Number of records discarded because of a checksum error
+   */
+   uint32_t ulErrorCount;
+
+} QCanClient_ts;
+
+
+/*----------------------------------------------------------------------------*\
+** Function prototypes                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+/*!
+** \brief   Calculate checksum of a record
+** \param   pubDataV    - Pointer to data
+** \param   ulSizeV     - Number of bytes
+** \return  Checksum value
+**
+** The checksum is the CRC-16 defined by ISO 3309, which is the default of
+** qChecksum().
+*/
+uint16_t QCanClientChecksum(CPP_CONST uint8_t *pubDataV, uint32_t ulSizeV);
+
+
+/*!
+** \brief   Connect client to a network
+** \param   ptsClientV  - Pointer to client
+** \param   ubChannelV  - Number of the network, first network is
+**                        eCP_CHANNEL_1
+** \param   pszHostV    - Host name or address of the server, the
+**                        local server is used for a value of 0
+** \param   uwPortV     - TCP port of the first network, the default
+**                        #QCAN_CLIENT_TCP_PORT is used for a value of 0
+** \return  0 on success, -1 on failure
+**
+** An existing connection is closed first. The connection to the local
+** server uses the directory defined by the environment variable
+** \c TMPDIR (default \c /tmp), like QDir::tempPath().
+*/
+int32_t  QCanClientConnect(QCanClient_ts *ptsClientV, uint8_t ubChannelV,
+                           CPP_CONST char *pszHostV, uint16_t uwPortV);
+
+
+/*!
+** \brief   Close connection
+** \param   ptsClientV  - Pointer to client
+**
+** Records which have not been sent yet are discarded.
+*/
+void     QCanClientDisconnect(QCanClient_ts *ptsClientV);
+
+
+/*!
+** \brief   Send pending records
+** \param   ptsClientV  - Pointer to client
+** \return  Number of bytes still pending, -1 if the connection failed
+*/
+int32_t  QCanClientFlush(QCanClient_ts *ptsClientV);
+
+
+/*!
+** \brief   Initialise client
+** \param   ptsClientV  - Pointer to client
+**
+** The function must be called once before any other function.
+*/
+void     QCanClientInit(QCanClient_ts *ptsClientV);
+
+
+/*!
+** \brief   Test for error frame
+** \param   ptsCanMsgV  - Pointer to CAN message read by QCanClientRead()
+** \return  true if the message is an error frame
+*/
+bool_t   QCanClientIsErrorFrame(CPP_CONST CpCanMsg_ts *ptsCanMsgV);
+
+
+/*!
+** \brief   Convert record to CAN message
+** \param   pubRecordV  - Pointer to #QCAN_CLIENT_RECORD_SIZE bytes
+** \param   ptsCanMsgV  - Pointer to CAN message
+** \return  false if the checksum is not valid
+*/
+bool_t   QCanClientRecordDecode(CPP_CONST uint8_t *pubRecordV,
+                                CpCanMsg_ts *ptsCanMsgV);
+
+
+/*!
+** \brief   Convert CAN message to record
+** \param   ptsCanMsgV  - Pointer to CAN message
+** \param   pubRecordV  - Pointer to #QCAN_CLIENT_RECORD_SIZE bytes
+**
+** The identifier is stored unchanged, so the frame type bits have to be
+** cleared for a data frame.
+*/
+void     QCanClientRecordEncode(CPP_CONST CpCanMsg_ts *ptsCanMsgV,
+                                uint8_t *pubRecordV);
+
+
+/*!
+** \brief   Read CAN frames
+** \param   ptsClientV  - Pointer to client
+** \param   ptsCanMsgV  - Pointer to array of CAN messages
+** \param   ulMsgMaxV   - Size of the CAN message array
+** \return  Number of CAN messages stored in \a ptsCanMsgV, -1 if the
+**          connection is closed
+**
+** The function does not block. It reads all bytes available on the socket
+** up to the size of the receive buffer with a single system call and
+** decodes the complete records. Control records and records with a
+** checksum error are discarded.
+*/
+int32_t  QCanClientRead(QCanClient_ts *ptsClientV, CpCanMsg_ts *ptsCanMsgV,
+                        uint32_t ulMsgMaxV);
+
+
+/*!
+** \brief   Wait for CAN frames
+** \param   ptsClientV  - Pointer to client
+** \param   slTimeoutV  - Maximum time to wait in milli-seconds, -1 waits
+**                        infinitely
+** \return  1 if CAN frames are available, 0 on timeout, -1 if the
+**          connection is closed
+**
+** Pending records are sent while waiting.
+*/
+int32_t  QCanClientWait(QCanClient_ts *ptsClientV, int32_t slTimeoutV);
+
+
+/*!
+** \brief   Write CAN frames
+** \param   ptsClientV  - Pointer to client
+** \param   ptsCanMsgV  - Pointer to array of CAN messages
+** \param   ulMsgCntV   - Number of CAN messages
+** \return  Number of CAN messages accepted, -1 if the connection is
+**          closed
+**
+** The function does not block. The messages are encoded into the
+** transmit buffer as far as it has space and the buffer is sent with a
+** single system call. A message which has been accepted is sent
+** completely, remaining bytes are sent by the next call of
+** QCanClientWrite(), QCanClientFlush() or QCanClientWait().
+*/
+int32_t  QCanClientWrite(QCanClient_ts *ptsClientV,
+                         CPP_CONST CpCanMsg_ts *ptsCanMsgV,
+                         uint32_t ulMsgCntV);
+
+
+//-------------------------------------------------------------------//
+#ifdef __cplusplus                                                   //
+}                                                                    //
+#endif                                                               //
+// end of C++ compiler wrapper                                       //
+//-------------------------------------------------------------------//
+
+
+#endif   // QCAN_CLIENT_H_
@@ -0,0 +1,1614 @@
+//============================================================================//
+// File:          qcan_client_canpie_fd.c                                     //
+// Description:   CANpie FD driver for the Qt-free QCan client                //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// clock_gettime() is not part of C99
+//
+#ifndef  _POSIX_C_SOURCE
+#define  _POSIX_C_SOURCE   200809L
+#endif
+
+#include "qcan_client_canpie_fd.h"
+#include "cp_msg.h"
+
+#include <string.h>
+#include <time.h>
+
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#define  CP_USER_FLAG_RCV        ((uint32_t)(0x00000001))
+#define  CP_USER_FLAG_TRM        ((uint32_t)(0x00000002))
+
+//-------------------------------------------------------------------
+// maximum length of the host name set by CpSocketSetHostAddress()
+//
+#define  HOST_NAME_MAX_LEN       256
+
+enum DrvInfo_e {
+   eDRV_INFO_OFF = 0,
+   eDRV_INFO_INIT
+};
+
+
+/*----------------------------------------------------------------------------*\
+** Structures                                                                 **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// state of one CAN channel, the message buffers are simulated
+//
+typedef struct CpChannel_s
+{
+   QCanClient_ts     tsClient;
+   uint8_t           ubClientInit;
+   uint8_t           ubProcess;
+   uint8_t           ubCanMode;
+   char              aszHost[HOST_NAME_MAX_LEN];
+   uint16_t          uwPort;
+
+   CpCanMsg_ts       atsCanMsg[CP_BUFFER_MAX];
+   uint32_t          aulAccMask[CP_BUFFER_MAX];
+   CpFifo_ts *       aptsFifo[CP_BUFFER_MAX];
+   CpFifoEvent_ts    atsFifoEvent[CP_BUFFER_MAX];
+   CpFifoHandler_Fn  apfnFifoHandler[CP_BUFFER_MAX];
+   #if CP_TRM_PRIORITY > 0
+   CpPrio_ts         atsTrmPrio[CP_BUFFER_MAX];
+   CpPrioEntry_ts    atsTrmPrioEntry[CP_BUFFER_MAX][CP_TRM_PRIORITY];
+   #endif
+
+   CpRcvHandler_Fn   pfnRcvHandler;
+   CpTrmHandler_Fn   pfnTrmHandler;
+   CpErrHandler_Fn   pfnErrHandler;
+
+   CpState_ts        tsCanState;
+   CpStatistic_ts    tsStatistic;
+   CpStatisticExt_ts tsStatisticExt;
+
+   //-----------------------------------------------------------
+   // block of messages passed between socket and buffers
+   //
+   CpCanMsg_ts       atsMsgBlock[QCAN_CLIENT_FRAME_MAX];
+   #if CP_TRM_PRIORITY > 0
+   uint8_t           aubMsgBuffer[QCAN_CLIENT_FRAME_MAX];
+   #endif
+} CpChannel_ts;
+
+
+/*----------------------------------------------------------------------------*\
+** Variables of module                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+static CpChannel_ts  atsChannelS[CP_CHANNEL_MAX];
+
+
+/*----------------------------------------------------------------------------*\
+** Function implementation                                                    **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+
+//----------------------------------------------------------------------------//
+// CheckParam()                                                               //
+// check valid port, buffer number and driver state                           //
+//----------------------------------------------------------------------------//
+static CpStatus_tv CheckParam(CPP_CONST CpPort_ts * ptsPortV,
+                              CPP_CONST uint8_t ubBufferIdxV,
+                              CPP_CONST uint8_t ubReqStateV )
+{
+   CpStatus_tv tvStatusT = eCP_ERR_CHANNEL;
+
+   //----------------------------------------------------------------
+   // test CAN port
+   //
+   if (ptsPortV != (CpPort_ts *) 0L)
+   {
+      if ((ptsPortV->ubPhyIf > eCP_CHANNEL_NONE) &&
+          (ptsPortV->ubPhyIf <= CP_CHANNEL_MAX))
+      {
+         tvStatusT = eCP_ERR_INIT_MISSING;
+
+         //------------------------------------------------
+         // check for initialisation
+         //
+         if (ptsPortV->ubDrvInfo >= ubReqStateV)
+         {
+            tvStatusT = eCP_ERR_BUFFER;
+
+            //----------------------------------------
+            // check for valid buffer number
+            //
+            if (ubBufferIdxV < CP_BUFFER_MAX)
+            {
+               tvStatusT = eCP_ERR_NONE;
+            }
+         }
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvDataSize()                                                              //
+// number of data bytes of a CAN message                                      //
+//----------------------------------------------------------------------------//
+static uint8_t DrvDataSize(CPP_CONST CpCanMsg_ts * ptsCanMsgV)
+{
+   static CPP_CONST uint8_t aubSizeS[16] = { 0,  1,  2,  3,  4,  5,  6,  7,
+                                             8, 12, 16, 20, 24, 32, 48, 64 };
+
+   if ((ptsCanMsgV->ubMsgCtrl & CP_MSG_CTRL_FDF_BIT) > 0)
+   {
+      return (aubSizeS[ptsCanMsgV->ubMsgDLC & 0x0F]);
+   }
+
+   return ((ptsCanMsgV->ubMsgDLC < 8) ? ptsCanMsgV->ubMsgDLC : (uint8_t) 8);
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvTick()                                                                  //
+// monotonic time in micro-seconds                                            //
+//----------------------------------------------------------------------------//
+static uint64_t DrvTick(void)
+{
+   struct timespec tsTimeT;
+
+   clock_gettime(CLOCK_MONOTONIC, &tsTimeT);
+   return (((uint64_t) tsTimeT.tv_sec * 1000000) +
+           ((uint64_t) tsTimeT.tv_nsec / 1000));
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvHandlerTime()                                                           //
+// update runtime of a callback handler                                       //
+//----------------------------------------------------------------------------//
+static void DrvHandlerTime(CpHandlerTime_ts * ptsTimeV, uint64_t uqStartV)
+{
+   uint32_t ulTimeT;
+
+   ulTimeT = (uint32_t) ((DrvTick() - uqStartV) * 1000);
+   ptsTimeV->ulCallCount++;
+   ptsTimeV->uqTimeSum += ulTimeT;
+   if (ulTimeT < ptsTimeV->ulTimeMin)
+   {
+      ptsTimeV->ulTimeMin = ulTimeT;
+   }
+   if (ulTimeT > ptsTimeV->ulTimeMax)
+   {
+      ptsTimeV->ulTimeMax = ulTimeT;
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvFifoNotify()                                                            //
+// call FIFO handler                                                          //
+//----------------------------------------------------------------------------//
+static void DrvFifoNotify(CpChannel_ts * ptsChannelV, uint8_t ubBufferIdxV)
+{
+   uint64_t uqStartT;
+
+   uqStartT = DrvTick();
+   (* ptsChannelV->apfnFifoHandler[ubBufferIdxV])(ubBufferIdxV,
+                            CpFifoPending(ptsChannelV->aptsFifo[ubBufferIdxV]));
+   DrvHandlerTime(&(ptsChannelV->tsStatisticExt.tsFifoHandler), uqStartT);
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvFifoWait()                                                              //
+// time in milli-seconds until the next FIFO notification timeout             //
+//----------------------------------------------------------------------------//
+static int32_t DrvFifoWait(CpChannel_ts * ptsChannelV, int32_t slTimeoutV)
+{
+   CpFifoEvent_ts *  ptsEventT;
+   uint32_t          ulTickT;
+   uint32_t          ulWaitT;
+   uint8_t           ubBufferIdxT;
+
+   ulTickT = (uint32_t) (DrvTick() / 1000);
+   for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
+   {
+      ptsEventT = &(ptsChannelV->atsFifoEvent[ubBufferIdxT]);
+      if ((ptsChannelV->apfnFifoHandler[ubBufferIdxT] != CPP_NULL) &&
+          (ptsEventT->ulState == (CP_FIFO_EVENT_ARMED | CP_FIFO_EVENT_TIMER)))
+      {
+         ulWaitT = ulTickT - ptsEventT->ulTickStart;
+         if (ulWaitT < ptsEventT->ulTimeout)
+         {
+            ulWaitT = ptsEventT->ulTimeout - ulWaitT;
+         }
+         else
+         {
+            ulWaitT = 0;
+         }
+
+         if ((slTimeoutV < 0) || (ulWaitT < (uint32_t) slTimeoutV))
+         {
+            slTimeoutV = (int32_t) ulWaitT;
+         }
+      }
+   }
+
+   return (slTimeoutV);
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvReceiveError()                                                          //
+// handle error frame                                                         //
+//----------------------------------------------------------------------------//
+static void DrvReceiveError(CpChannel_ts * ptsChannelV,
+                            CpCanMsg_ts * ptsCanMsgV)
+{
+   //----------------------------------------------------------------
+   // the CAN state values of QCan and CANpie are equal, byte 0 .. 3
+   // hold the state, error type and the error counters
+   //
+   ptsChannelV->tsCanState.ubCanErrState  = ptsCanMsgV->tuMsgData.aubByte[0];
+   ptsChannelV->tsCanState.ubCanErrType   = ptsCanMsgV->tuMsgData.aubByte[1];
+   ptsChannelV->tsCanState.ubCanRcvErrCnt = ptsCanMsgV->tuMsgData.aubByte[2];
+   ptsChannelV->tsCanState.ubCanTrmErrCnt = ptsCanMsgV->tuMsgData.aubByte[3];
+
+   ptsChannelV->tsStatistic.ulErrMsgCount++;
+   ptsChannelV->tsStatisticExt.uqErrMsgCount++;
+
+   if (ptsChannelV->pfnErrHandler != CPP_NULL)
+   {
+      (* ptsChannelV->pfnErrHandler)(&(ptsChannelV->tsCanState));
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvReceiveMsg()                                                            //
+// pass received CAN message to all matching message buffers                  //
+//----------------------------------------------------------------------------//
+static void DrvReceiveMsg(CpChannel_ts * ptsChannelV,
+                          CpCanMsg_ts * ptsCanMsgV)
+{
+   CpCanMsg_ts *  ptsCanBufT;
+   CpFifo_ts *    ptsFifoT;
+   uint32_t       ulAccMaskT;
+   uint32_t       ulPendingT;
+   uint64_t       uqStartT;
+   uint8_t        ubBufferIdxT;
+
+   ptsChannelV->tsStatisticExt.uqRcvMsgCount++;
+   ptsChannelV->tsStatisticExt.uqRcvByteCount += DrvDataSize(ptsCanMsgV);
+
+   //----------------------------------------------------------------
+   // the user field of a message buffer holds the direction, so
+   // it is not taken from the received message
+   //
+   for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
+   {
+      ptsCanBufT = &(ptsChannelV->atsCanMsg[ubBufferIdxT]);
+      ulAccMaskT = ptsChannelV->aulAccMask[ubBufferIdxT];
+
+      if ((ptsCanBufT->ulMsgUser & CP_USER_FLAG_RCV) == 0)
+      {
+         continue;
+      }
+
+      if (((ptsCanBufT->ubMsgCtrl ^ ptsCanMsgV->ubMsgCtrl) &
+           CP_MSG_CTRL_EXT_BIT) != 0)
+      {
+         continue;
+      }
+
+      if ((ptsCanBufT->ulIdentifier & ulAccMaskT) !=
+          (ptsCanMsgV->ulIdentifier & ulAccMaskT))
+      {
+         continue;
+      }
+
+      ptsCanBufT->ulIdentifier = ptsCanMsgV->ulIdentifier;
+      ptsCanBufT->ubMsgDLC     = ptsCanMsgV->ubMsgDLC;
+      memcpy(&(ptsCanBufT->tuMsgData.aubByte[0]),
+             &(ptsCanMsgV->tuMsgData.aubByte[0]), CP_DATA_SIZE);
+
+      ptsFifoT = ptsChannelV->aptsFifo[ubBufferIdxT];
+      if (ptsFifoT == (CpFifo_ts *) 0L)
+      {
+         //------------------------------------------------
+         // no FIFO available
+         //
+         if (ptsChannelV->pfnRcvHandler != CPP_NULL)
+         {
+            uqStartT = DrvTick();
+            (* ptsChannelV->pfnRcvHandler)(ptsCanBufT, ubBufferIdxT);
+            DrvHandlerTime(&(ptsChannelV->tsStatisticExt.tsRcvHandler),
+                           uqStartT);
+         }
+      }
+      else
+      {
+         //------------------------------------------------
+         // copy to the receive FIFO and notify once per
+         // batch
+         //
+         if (CpFifoIsFull(ptsFifoT) == false)
+         {
+            memcpy(CpFifoDataInPtr(ptsFifoT), ptsCanMsgV, sizeof(CpCanMsg_ts));
+            CpFifoIncIn(ptsFifoT);
+
+            ulPendingT = CpFifoPending(ptsFifoT);
+            if (ulPendingT >
+                ptsChannelV->tsStatisticExt.aulFifoHighWater[ubBufferIdxT])
+            {
+               ptsChannelV->tsStatisticExt.aulFifoHighWater[ubBufferIdxT] =
+                                                                  ulPendingT;
+            }
+         }
+         else
+         {
+            ptsChannelV->tsStatisticExt.aulFifoOverrun[ubBufferIdxT]++;
+         }
+
+         if (ptsChannelV->apfnFifoHandler[ubBufferIdxT] != CPP_NULL)
+         {
+            if (CpFifoEventIn(&(ptsChannelV->atsFifoEvent[ubBufferIdxT]),
+                              ptsFifoT, (uint32_t) (DrvTick() / 1000)))
+            {
+               DrvFifoNotify(ptsChannelV, ubBufferIdxT);
+            }
+         }
+      }
+
+      ptsChannelV->tsStatistic.ulRcvMsgCount++;
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvReceive()                                                               //
+// read all CAN frames which are available on the socket                      //
+//----------------------------------------------------------------------------//
+static CpStatus_tv DrvReceive(CpChannel_ts * ptsChannelV)
+{
+   int32_t  slMsgCntT;
+   int32_t  slMsgIdxT;
+
+   do
+   {
+      slMsgCntT = QCanClientRead(&(ptsChannelV->tsClient),
+                                 &(ptsChannelV->atsMsgBlock[0]),
+                                 QCAN_CLIENT_FRAME_MAX);
+      if (slMsgCntT < 0)
+      {
+         return (eCP_ERR_INIT_FAIL);
+      }
+
+      for (slMsgIdxT = 0; slMsgIdxT < slMsgCntT; slMsgIdxT++)
+      {
+         if (QCanClientIsErrorFrame(&(ptsChannelV->atsMsgBlock[slMsgIdxT])))
+         {
+            DrvReceiveError(ptsChannelV, &(ptsChannelV->atsMsgBlock[slMsgIdxT]));
+         }
+         else if ((ptsChannelV->atsMsgBlock[slMsgIdxT].ulIdentifier &
+                   QCAN_CLIENT_TYPE_MASK) == 0)
+         {
+            DrvReceiveMsg(ptsChannelV, &(ptsChannelV->atsMsgBlock[slMsgIdxT]));
+         }
+      }
+   } while (slMsgCntT == (int32_t) QCAN_CLIENT_FRAME_MAX);
+
+   return (eCP_ERR_NONE);
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvWrite()                                                                 //
+// write CAN messages of one buffer to the socket                             //
+//----------------------------------------------------------------------------//
+static uint32_t DrvWrite(CpChannel_ts * ptsChannelV, CpCanMsg_ts * ptsCanMsgV,
+                         uint32_t ulMsgCntV, CPP_CONST uint8_t * pubBufferIdxV)
+{
+   int32_t  slMsgCntT;
+   int32_t  slMsgIdxT;
+   uint64_t uqStartT;
+
+   slMsgCntT = QCanClientWrite(&(ptsChannelV->tsClient), ptsCanMsgV,
+                               ulMsgCntV);
+   if (slMsgCntT <= 0)
+   {
+      return (0);
+   }
+
+   for (slMsgIdxT = 0; slMsgIdxT < slMsgCntT; slMsgIdxT++)
+   {
+      ptsChannelV->tsStatistic.ulTrmMsgCount++;
+      ptsChannelV->tsStatisticExt.uqTrmMsgCount++;
+      ptsChannelV->tsStatisticExt.uqTrmByteCount += DrvDataSize(ptsCanMsgV);
+
+      if (ptsChannelV->pfnTrmHandler != CPP_NULL)
+      {
+         uqStartT = DrvTick();
+         (* ptsChannelV->pfnTrmHandler)(ptsCanMsgV, *pubBufferIdxV);
+         DrvHandlerTime(&(ptsChannelV->tsStatisticExt.tsTrmHandler), uqStartT);
+      }
+
+      ptsCanMsgV++;
+      #if CP_TRM_PRIORITY > 0
+      pubBufferIdxV++;
+      #endif
+   }
+
+   return ((uint32_t) slMsgCntT);
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvTransmit()                                                              //
+// write pending messages of the transmit FIFOs to the socket                 //
+//----------------------------------------------------------------------------//
+static void DrvTransmit(CpChannel_ts * ptsChannelV)
+{
+   #if CP_TRM_PRIORITY > 0
+   uint32_t    ulKeyT;
+   uint32_t    ulSelectKeyT = 0;
+   uint32_t    ulMsgCntT;
+   uint32_t    ulMsgMaxT;
+   uint32_t    ulTickT;
+   uint8_t     ubSelectT;
+   #else
+   CpFifo_ts * ptsFifoT;
+   uint32_t    ulSpanT;
+   #endif
+   uint8_t     ubBufferIdxT;
+
+   #if CP_TRM_PRIORITY > 0
+   //----------------------------------------------------------------
+   // take as many messages as the transmit buffer of the client
+   // can accept in order of priority, so no message is dropped
+   //
+   ulMsgMaxT = ((sizeof(ptsChannelV->tsClient.aubTrmBuffer) -
+                 (ptsChannelV->tsClient.ulTrmCount -
+                  ptsChannelV->tsClient.ulTrmIndex)) / QCAN_CLIENT_RECORD_SIZE);
+   ulTickT   = (uint32_t) DrvTick();
+   ulMsgCntT = 0;
+   while (ulMsgCntT < ulMsgMaxT)
+   {
+      ubSelectT = CP_BUFFER_MAX;
+      for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
+      {
+         if (CpPrioHead(&(ptsChannelV->atsTrmPrio[ubBufferIdxT]), &ulKeyT))
+         {
+            if ((ubSelectT == CP_BUFFER_MAX) || (ulKeyT < ulSelectKeyT))
+            {
+               ubSelectT    = ubBufferIdxT;
+               ulSelectKeyT = ulKeyT;
+            }
+         }
+      }
+
+      if (ubSelectT == CP_BUFFER_MAX)
+      {
+         break;
+      }
+
+      CpPrioPop(&(ptsChannelV->atsTrmPrio[ubSelectT]),
+                &(ptsChannelV->atsMsgBlock[ulMsgCntT]), ulTickT);
+      ptsChannelV->aubMsgBuffer[ulMsgCntT] = ubSelectT;
+      ulMsgCntT++;
+   }
+
+   if (ulMsgCntT > 0)
+   {
+      DrvWrite(ptsChannelV, &(ptsChannelV->atsMsgBlock[0]), ulMsgCntT,
+               &(ptsChannelV->aubMsgBuffer[0]));
+   }
+   (void) ubBufferIdxT;
+
+   #else
+   //----------------------------------------------------------------
+   // write the FIFOs block-wise, the ring layout requires at most
+   // two blocks per FIFO, stop when the socket does not accept
+   // further messages
+   //
+   for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
+   {
+      ptsFifoT = ptsChannelV->aptsFifo[ubBufferIdxT];
+      if ((ptsFifoT == (CpFifo_ts *) 0L) ||
+          ((ptsChannelV->atsCanMsg[ubBufferIdxT].ulMsgUser &
+            CP_USER_FLAG_RCV) != 0))
+      {
+         continue;
+      }
+
+      while ((ulSpanT = CpFifoDataOutSpan(ptsFifoT)) > 0)
+      {
+         if (ulSpanT > QCAN_CLIENT_FRAME_MAX)
+         {
+            ulSpanT = QCAN_CLIENT_FRAME_MAX;
+         }
+
+         ulSpanT = DrvWrite(ptsChannelV, CpFifoDataOutPtr(ptsFifoT), ulSpanT,
+                            &ubBufferIdxT);
+         if (ulSpanT == 0)
+         {
+            return;
+         }
+         CpFifoAddOut(ptsFifoT, ulSpanT);
+      }
+   }
+   #endif
+}
+
+
+//----------------------------------------------------------------------------//
+// DrvProcess()                                                               //
+// receive, transmit and FIFO notification timeout                            //
+//----------------------------------------------------------------------------//
+static CpStatus_tv DrvProcess(CpChannel_ts * ptsChannelV)
+{
+   CpStatus_tv tvStatusT;
+   uint32_t    ulTickT;
+   uint8_t     ubBufferIdxT;
+
+   //----------------------------------------------------------------
+   // a callback handler may call a core function which processes
+   // the socket again
+   //
+   if (ptsChannelV->ubProcess != 0)
+   {
+      return (eCP_ERR_NONE);
+   }
+   ptsChannelV->ubProcess = 1;
+
+   tvStatusT = DrvReceive(ptsChannelV);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      DrvTransmit(ptsChannelV);
+      if (QCanClientFlush(&(ptsChannelV->tsClient)) < 0)
+      {
+         tvStatusT = eCP_ERR_INIT_FAIL;
+      }
+   }
+
+   ulTickT = (uint32_t) (DrvTick() / 1000);
+   for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
+   {
+      if (ptsChannelV->apfnFifoHandler[ubBufferIdxT] != CPP_NULL)
+      {
+         if (CpFifoEventTimer(&(ptsChannelV->atsFifoEvent[ubBufferIdxT]),
+                              ptsChannelV->aptsFifo[ubBufferIdxT], ulTickT))
+         {
+            DrvFifoNotify(ptsChannelV, ubBufferIdxT);
+         }
+      }
+   }
+
+   ptsChannelV->ubProcess = 0;
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreBitrate()                                                            //
+// Setup bit-rate of CAN controller                                           //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreBitrate( CpPort_ts * ptsPortV, int32_t slNomBitRateV,
+                           int32_t slDatBitRateV)
+{
+   CpStatus_tv tvStatusT;
+
+   //----------------------------------------------------------------
+   // the bit-rate is defined by the server
+   //
+   tvStatusT = CheckParam(ptsPortV, 0, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      if ((slDatBitRateV != eCP_BITRATE_NONE) &&
+          (slNomBitRateV > slDatBitRateV) )
+      {
+         tvStatusT = eCP_ERR_BITRATE;
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreBufferConfig()                                                       //
+// Configure CAN message buffer                                               //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreBufferConfig( CpPort_ts * ptsPortV,
+                                uint8_t   ubBufferIdxV,
+                                uint32_t  ulIdentifierV,
+                                uint32_t  ulAcceptMaskV,
+                                uint8_t   ubFormatV,
+                                uint8_t   ubDirectionV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+
+      //--------------------------------------------------------
+      // test message format and mask identifier
+      //
+      switch(ubFormatV & CP_MASK_MSG_FORMAT)
+      {
+         case CP_MSG_FORMAT_CEFF:
+         case CP_MSG_FORMAT_FEFF:
+            ulIdentifierV = ulIdentifierV & CP_MASK_EXT_FRAME;
+            ulAcceptMaskV = ulAcceptMaskV & CP_MASK_EXT_FRAME;
+            break;
+
+         default:
+            ulIdentifierV = ulIdentifierV & CP_MASK_STD_FRAME;
+            ulAcceptMaskV = ulAcceptMaskV & CP_MASK_STD_FRAME;
+            break;
+      }
+
+      //--------------------------------------------------------
+      // copy to simulated CAN buffer and mark Tx/Rx message
+      //
+      ptsChannelT->atsCanMsg[ubBufferIdxV].ulIdentifier = ulIdentifierV;
+      ptsChannelT->atsCanMsg[ubBufferIdxV].ubMsgCtrl    = ubFormatV;
+      if (ubDirectionV == eCP_BUFFER_DIR_TRM)
+      {
+         ptsChannelT->atsCanMsg[ubBufferIdxV].ulMsgUser = CP_USER_FLAG_TRM;
+      }
+      else
+      {
+         ptsChannelT->atsCanMsg[ubBufferIdxV].ulMsgUser = CP_USER_FLAG_RCV;
+      }
+      ptsChannelT->aulAccMask[ubBufferIdxV] = ulAcceptMaskV;
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreBufferGetData()                                                      //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreBufferGetData( CpPort_ts * ptsPortV,
+                                 uint8_t   ubBufferIdxV,
+                                 uint8_t * pubDestDataV,
+                                 uint8_t   ubStartPosV,
+                                 uint8_t   ubSizeV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+
+      //--------------------------------------------------------
+      // test start position and size
+      //
+      if ( (ubStartPosV + ubSizeV) > CP_DATA_SIZE )
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else
+      {
+         memcpy(pubDestDataV,
+                &(ptsChannelT->atsCanMsg[ubBufferIdxV].tuMsgData.aubByte[ubStartPosV]),
+                ubSizeV);
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreBufferGetDlc()                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreBufferGetDlc(  CpPort_ts * ptsPortV,
+                                 uint8_t ubBufferIdxV, uint8_t * pubDlcV)
+{
+   CpStatus_tv    tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      *pubDlcV = atsChannelS[ptsPortV->ubPhyIf - 1].atsCanMsg[ubBufferIdxV].ubMsgDLC;
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreBufferRelease()                                                      //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreBufferRelease( CpPort_ts * ptsPortV,
+                                 uint8_t ubBufferIdxV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+
+      //--------------------------------------------------------
+      // clear simulated CAN buffer
+      //
+      memset(&(ptsChannelT->atsCanMsg[ubBufferIdxV]), 0, sizeof(CpCanMsg_ts));
+      ptsChannelT->aulAccMask[ubBufferIdxV] = 0;
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreBufferSend()                                                         //
+// send message out of the CAN controller                                     //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreBufferSend(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+   CpCanMsg_ts    tsCanMsgT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+
+      //--------------------------------------------------------
+      // the user field of the buffer holds the direction flags,
+      // they are not sent
+      //
+      tsCanMsgT = ptsChannelT->atsCanMsg[ubBufferIdxV];
+      tsCanMsgT.ulMsgUser = 0;
+      if (DrvWrite(ptsChannelT, &tsCanMsgT, 1, &ubBufferIdxV) == 0)
+      {
+         tvStatusT = eCP_ERR_TRM_FULL;
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreBufferSetData()                                                      //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreBufferSetData( CpPort_ts * ptsPortV,
+                                 uint8_t ubBufferIdxV,  uint8_t * pubSrcDataV,
+                                 uint8_t   ubStartPosV, uint8_t   ubSizeV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+
+      //--------------------------------------------------------
+      // test start position and size
+      //
+      if ( (ubStartPosV + ubSizeV) > CP_DATA_SIZE )
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else
+      {
+         memcpy(&(ptsChannelT->atsCanMsg[ubBufferIdxV].tuMsgData.aubByte[ubStartPosV]),
+                pubSrcDataV, ubSizeV);
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreBufferSetDlc()                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreBufferSetDlc(  CpPort_ts * ptsPortV,
+                                 uint8_t ubBufferIdxV, uint8_t ubDlcV)
+{
+   CpStatus_tv    tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      atsChannelS[ptsPortV->ubPhyIf - 1].atsCanMsg[ubBufferIdxV].ubMsgDLC = ubDlcV;
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreCanMode()                                                            //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreCanMode(CpPort_ts * ptsPortV, uint8_t ubModeV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   tvStatusT = CheckParam(ptsPortV, 0, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+
+      //--------------------------------------------------------
+      // the mode of the CAN interface is defined by the server,
+      // the mode is only stored
+      //
+      switch(ubModeV)
+      {
+         case eCP_MODE_START:
+            ptsChannelT->tsCanState.ubCanErrState = eCP_STATE_BUS_ACTIVE;
+            ptsChannelT->ubCanMode = ubModeV;
+            break;
+
+         case eCP_MODE_STOP:
+         case eCP_MODE_LISTEN_ONLY:
+            ptsChannelT->ubCanMode = ubModeV;
+            break;
+
+         default:
+            tvStatusT = eCP_ERR_NOT_SUPPORTED;
+            break;
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreCanState()                                                           //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreCanState(CpPort_ts * ptsPortV, CpState_ts * ptsStateV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   tvStatusT = CheckParam(ptsPortV, 0, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      if (ptsStateV == (CpState_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else
+      {
+         ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+         *ptsStateV  = ptsChannelT->tsCanState;
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreDriverInit()                                                         //
+// init CAN controller                                                        //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreDriverInit(uint8_t ubPhyIfV, CpPort_ts * ptsPortV,
+                             uint8_t CPP_PARM_UNUSED(ubConfigV))
+{
+   CpChannel_ts *       ptsChannelT;
+   CPP_CONST char *     pszHostT = (CPP_CONST char *) 0L;
+
+   //----------------------------------------------------------------
+   // test parameter
+   //
+   if ((ubPhyIfV > CP_CHANNEL_MAX) || (ubPhyIfV == eCP_CHANNEL_NONE))
+   {
+      return (eCP_ERR_CHANNEL);
+   }
+
+   if (ptsPortV == (CpPort_ts *) 0L)
+   {
+      return (eCP_ERR_PARAM);
+   }
+
+   ptsChannelT = &(atsChannelS[ubPhyIfV - 1]);
+   if (ptsChannelT->ubClientInit == 0)
+   {
+      QCanClientInit(&(ptsChannelT->tsClient));
+      ptsChannelT->ubClientInit = 1;
+   }
+
+   //----------------------------------------------------------------
+   // no FIFOs attached to message buffers, clear CAN state and
+   // statistic
+   //
+   memset(&(ptsChannelT->atsCanMsg[0]), 0, sizeof(ptsChannelT->atsCanMsg));
+   memset(&(ptsChannelT->aulAccMask[0]), 0, sizeof(ptsChannelT->aulAccMask));
+   memset(&(ptsChannelT->aptsFifo[0]), 0, sizeof(ptsChannelT->aptsFifo));
+   memset(&(ptsChannelT->apfnFifoHandler[0]), 0,
+          sizeof(ptsChannelT->apfnFifoHandler));
+   ptsChannelT->pfnRcvHandler = CPP_NULL;
+   ptsChannelT->pfnTrmHandler = CPP_NULL;
+   ptsChannelT->pfnErrHandler = CPP_NULL;
+   ptsChannelT->ubProcess     = 0;
+   ptsChannelT->ubCanMode     = eCP_MODE_STOP;
+
+   memset(&(ptsChannelT->tsCanState), 0, sizeof(CpState_ts));
+   ptsChannelT->tsCanState.ubCanErrState = eCP_STATE_INIT;
+   ptsChannelT->tsCanState.ubCanErrType  = eCP_ERR_TYPE_NONE;
+
+   memset(&(ptsChannelT->tsStatistic), 0, sizeof(CpStatistic_ts));
+   memset(&(ptsChannelT->tsStatisticExt), 0, sizeof(CpStatisticExt_ts));
+   ptsChannelT->tsStatisticExt.tsRcvHandler.ulTimeMin  = 0xFFFFFFFF;
+   ptsChannelT->tsStatisticExt.tsTrmHandler.ulTimeMin  = 0xFFFFFFFF;
+   ptsChannelT->tsStatisticExt.tsFifoHandler.ulTimeMin = 0xFFFFFFFF;
+
+   //----------------------------------------------------------------
+   // connect to the network with the same number
+   //
+   if (ptsChannelT->aszHost[0] != '\0')
+   {
+      pszHostT = &(ptsChannelT->aszHost[0]);
+   }
+   if (QCanClientConnect(&(ptsChannelT->tsClient), ubPhyIfV, pszHostT,
+                         ptsChannelT->uwPort) < 0)
+   {
+      return (eCP_ERR_INIT_FAIL);
+   }
+
+   ptsPortV->ubPhyIf   = ubPhyIfV;
+   ptsPortV->ubDrvInfo = eDRV_INFO_INIT;
+
+   return (eCP_ERR_NONE);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreDriverRelease()                                                      //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreDriverRelease(CpPort_ts * ptsPortV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   tvStatusT = CpCoreCanMode(ptsPortV, eCP_MODE_STOP);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+
+      //--------------------------------------------------------
+      // messages which have been accepted are sent before the
+      // connection is closed, as far as the socket allows
+      //
+      QCanClientFlush(&(ptsChannelT->tsClient));
+      QCanClientDisconnect(&(ptsChannelT->tsClient));
+      ptsPortV->ubDrvInfo = eDRV_INFO_OFF;
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoConfig()                                                         //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoConfig(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+                             CpFifo_ts * ptsFifoV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      if (ptsFifoV == (CpFifo_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+      else
+      {
+         ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+         ptsChannelT->aptsFifo[ubBufferIdxV]        = ptsFifoV;
+         ptsChannelT->apfnFifoHandler[ubBufferIdxV] = CPP_NULL;
+         #if CP_TRM_PRIORITY > 0
+         CpPrioInit(&(ptsChannelT->atsTrmPrio[ubBufferIdxV]),
+                    &(ptsChannelT->atsTrmPrioEntry[ubBufferIdxV][0]),
+                    CP_TRM_PRIORITY);
+         #endif
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoDelay()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoDelay(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+                            CpPrioDelay_ts * ptsDelayV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+
+      if (ptsDelayV == (CpPrioDelay_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else if (ptsChannelT->aptsFifo[ubBufferIdxV] == (CpFifo_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+      else
+      {
+         #if CP_TRM_PRIORITY > 0
+         memcpy(ptsDelayV, &(ptsChannelT->atsTrmPrio[ubBufferIdxV].atsDelay[0]),
+                sizeof(ptsChannelT->atsTrmPrio[ubBufferIdxV].atsDelay));
+         #else
+         tvStatusT = eCP_ERR_NOT_SUPPORTED;
+         #endif
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoEvent()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoEvent(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+                            CpFifoHandler_Fn pfnFifoHandlerV,
+                            uint32_t ulHighMarkV, uint32_t ulLowMarkV,
+                            uint32_t ulTimeoutV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpFifo_ts *    ptsFifoT;
+   CpStatus_tv    tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+      ptsFifoT    = ptsChannelT->aptsFifo[ubBufferIdxV];
+
+      if (ptsFifoT == (CpFifo_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+      else if (pfnFifoHandlerV == CPP_NULL)
+      {
+         ptsChannelT->apfnFifoHandler[ubBufferIdxV] = CPP_NULL;
+      }
+      else if ((ulHighMarkV == 0) || (ulHighMarkV <= ulLowMarkV) ||
+               (ulHighMarkV > ptsFifoT->ulIndexMax))
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+      else
+      {
+         CpFifoEventInit(&(ptsChannelT->atsFifoEvent[ubBufferIdxV]),
+                         ulHighMarkV, ulLowMarkV, ulTimeoutV);
+         ptsChannelT->apfnFifoHandler[ubBufferIdxV] = pfnFifoHandlerV;
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoRead()                                                           //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoRead(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+                           CpCanMsg_ts * ptsCanMsgV,
+                           uint32_t * pulMsgCntV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpFifo_ts *    ptsFifoT;
+   CpStatus_tv    tvStatusT;
+   uint32_t       ulMsgCntT;
+   uint32_t       ulSpanT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+      ptsFifoT    = ptsChannelT->aptsFifo[ubBufferIdxV];
+
+      if (ptsFifoT == (CpFifo_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+      else if ((pulMsgCntV == (uint32_t *) 0L) ||
+               (ptsCanMsgV == (CpCanMsg_ts *) 0L))
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else
+      {
+         //------------------------------------------------
+         // take the frames which are available on the
+         // socket without waiting
+         //
+         DrvProcess(ptsChannelT);
+
+         //------------------------------------------------
+         // copy pending messages block-wise, the ring
+         // layout requires at most two blocks
+         //
+         ulMsgCntT = 0;
+         while (ulMsgCntT < *pulMsgCntV)
+         {
+            ulSpanT = CpFifoDataOutSpan(ptsFifoT);
+            if (ulSpanT == 0)
+            {
+               break;
+            }
+            if (ulSpanT > (*pulMsgCntV - ulMsgCntT))
+            {
+               ulSpanT = *pulMsgCntV - ulMsgCntT;
+            }
+
+            memcpy(ptsCanMsgV, CpFifoDataOutPtr(ptsFifoT),
+                   ulSpanT * sizeof(CpCanMsg_ts));
+            CpFifoAddOut(ptsFifoT, ulSpanT);
+
+            ptsCanMsgV += ulSpanT;
+            ulMsgCntT  += ulSpanT;
+         }
+         *pulMsgCntV = ulMsgCntT;
+
+         //------------------------------------------------
+         // re-arm the notification
+         //
+         if (ptsChannelT->apfnFifoHandler[ubBufferIdxV] != CPP_NULL)
+         {
+            CpFifoEventOut(&(ptsChannelT->atsFifoEvent[ubBufferIdxV]),
+                           ptsFifoT, (uint32_t) (DrvTick() / 1000));
+         }
+
+         if (ulMsgCntT == 0)
+         {
+            tvStatusT = eCP_ERR_FIFO_EMPTY;
+         }
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoRelease()                                                        //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoRelease(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+      ptsChannelT->aptsFifo[ubBufferIdxV]        = (CpFifo_ts *) 0L;
+      ptsChannelT->apfnFifoHandler[ubBufferIdxV] = CPP_NULL;
+      #if CP_TRM_PRIORITY > 0
+      CpPrioInit(&(ptsChannelT->atsTrmPrio[ubBufferIdxV]),
+                 &(ptsChannelT->atsTrmPrioEntry[ubBufferIdxV][0]),
+                 CP_TRM_PRIORITY);
+      #endif
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoWrite()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoWrite(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+                            CpCanMsg_ts * ptsCanMsgV,
+                            uint32_t * pulMsgCntV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpFifo_ts *    ptsFifoT;
+   CpStatus_tv    tvStatusT;
+   uint32_t       ulMsgCntT;
+   uint32_t       ulPendingT;
+   #if CP_TRM_PRIORITY == 0
+   uint32_t       ulSpanT;
+   #endif
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+      ptsFifoT    = ptsChannelT->aptsFifo[ubBufferIdxV];
+
+      if ((ptsFifoT == (CpFifo_ts *) 0L) ||
+          ((ptsChannelT->atsCanMsg[ubBufferIdxV].ulMsgUser &
+            CP_USER_FLAG_RCV) != 0))
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+      else if ((pulMsgCntV == (uint32_t *) 0L) ||
+               (ptsCanMsgV == (CpCanMsg_ts *) 0L))
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else
+      {
+         ulMsgCntT = 0;
+
+         #if CP_TRM_PRIORITY > 0
+         //------------------------------------------------
+         // sort messages into the priority ordered
+         // transmit queue
+         //
+         while (ulMsgCntT < *pulMsgCntV)
+         {
+            if (CpPrioPush(&(ptsChannelT->atsTrmPrio[ubBufferIdxV]),
+                           ptsCanMsgV, (uint32_t) DrvTick()) == false)
+            {
+               break;
+            }
+            ptsCanMsgV++;
+            ulMsgCntT++;
+         }
+         ulPendingT = CpPrioPending(&(ptsChannelT->atsTrmPrio[ubBufferIdxV]));
+
+         #else
+         //------------------------------------------------
+         // copy messages block-wise into the transmit FIFO,
+         // the ring layout requires at most two blocks
+         //
+         while (ulMsgCntT < *pulMsgCntV)
+         {
+            ulSpanT = CpFifoDataInSpan(ptsFifoT);
+            if (ulSpanT == 0)
+            {
+               break;
+            }
+            if (ulSpanT > (*pulMsgCntV - ulMsgCntT))
+            {
+               ulSpanT = *pulMsgCntV - ulMsgCntT;
+            }
+
+            memcpy(CpFifoDataInPtr(ptsFifoT), ptsCanMsgV,
+                   ulSpanT * sizeof(CpCanMsg_ts));
+            CpFifoAddIn(ptsFifoT, ulSpanT);
+
+            ptsCanMsgV += ulSpanT;
+            ulMsgCntT  += ulSpanT;
+         }
+         ulPendingT = CpFifoPending(ptsFifoT);
+         #endif
+
+         if (ulMsgCntT < *pulMsgCntV)
+         {
+            tvStatusT = eCP_ERR_FIFO_FULL;
+         }
+         *pulMsgCntV = ulMsgCntT;
+
+         if (ulPendingT > ptsChannelT->tsStatisticExt.aulFifoHighWater[ubBufferIdxV])
+         {
+            ptsChannelT->tsStatisticExt.aulFifoHighWater[ubBufferIdxV] = ulPendingT;
+         }
+
+         //------------------------------------------------
+         // start transmission, messages which are not
+         // accepted by the socket are sent by the next
+         // call of CpSocketPoll()
+         //
+         DrvProcess(ptsChannelT);
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreHDI()                                                                //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreHDI(CpPort_ts * ptsPortV, CpHdi_ts * ptsHdiV)
+{
+   CpStatus_tv tvStatusT;
+
+   tvStatusT = CheckParam(ptsPortV, 0, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      if (ptsHdiV == (CpHdi_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else
+      {
+         memset(ptsHdiV, 0, sizeof(CpHdi_ts));
+         ptsHdiV->ubVersionMajor   = CP_VERSION_MAJOR;
+         ptsHdiV->ubVersionMinor   = CP_VERSION_MINOR;
+         ptsHdiV->ubBufferMax      = CP_BUFFER_MAX;
+         ptsHdiV->slNomBitRate     = eCP_BITRATE_NONE;
+         ptsHdiV->slDatBitRate     = eCP_BITRATE_NONE;
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreIntFunctions()                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreIntFunctions(CpPort_ts * ptsPortV,
+                               CpRcvHandler_Fn pfnRcvHandlerV,
+                               CpTrmHandler_Fn pfnTrmHandlerV,
+                               CpErrHandler_Fn pfnErrHandlerV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   tvStatusT = CheckParam(ptsPortV, 0, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+
+      //--------------------------------------------------------
+      // store the new callbacks
+      //
+      ptsChannelT->pfnRcvHandler = pfnRcvHandlerV;
+      ptsChannelT->pfnTrmHandler = pfnTrmHandlerV;
+      ptsChannelT->pfnErrHandler = pfnErrHandlerV;
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreStatistic()                                                          //
+// return statistical information                                             //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreStatistic(CpPort_ts * ptsPortV, CpStatistic_ts * ptsStatsV)
+{
+   CpStatus_tv tvStatusT;
+
+   tvStatusT = CheckParam(ptsPortV, 0, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      if (ptsStatsV == (CpStatistic_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else
+      {
+         *ptsStatsV = atsChannelS[ptsPortV->ubPhyIf - 1].tsStatistic;
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreStatisticExt()                                                       //
+// return extended statistical information                                    //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreStatisticExt(CpPort_ts * ptsPortV,
+                               CpStatisticExt_ts * ptsStatsV)
+{
+   CpStatus_tv tvStatusT;
+
+   tvStatusT = CheckParam(ptsPortV, 0, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      if (ptsStatsV == (CpStatisticExt_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else
+      {
+         *ptsStatsV = atsChannelS[ptsPortV->ubPhyIf - 1].tsStatisticExt;
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpSocketDescriptor()                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+int32_t CpSocketDescriptor(CpPort_ts * ptsPortV)
+{
+   if (CheckParam(ptsPortV, 0, eDRV_INFO_INIT) != eCP_ERR_NONE)
+   {
+      return (-1);
+   }
+
+   return (atsChannelS[ptsPortV->ubPhyIf - 1].tsClient.slSocket);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpSocketPoll()                                                             //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpSocketPoll(CpPort_ts * ptsPortV, int32_t slTimeoutV)
+{
+   CpChannel_ts * ptsChannelT;
+   CpStatus_tv    tvStatusT;
+
+   tvStatusT = CheckParam(ptsPortV, 0, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsChannelT = &(atsChannelS[ptsPortV->ubPhyIf - 1]);
+
+      //--------------------------------------------------------
+      // do not wait longer than the next FIFO notification
+      //
+      slTimeoutV = DrvFifoWait(ptsChannelT, slTimeoutV);
+      if (QCanClientWait(&(ptsChannelT->tsClient), slTimeoutV) < 0)
+      {
+         tvStatusT = eCP_ERR_INIT_FAIL;
+      }
+      else
+      {
+         tvStatusT = DrvProcess(ptsChannelT);
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpSocketSetHostAddress()                                                   //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpSocketSetHostAddress(uint8_t ubPhyIfV, CPP_CONST char * pszHostV,
+                                   uint16_t uwPortV)
+{
+   CpChannel_ts * ptsChannelT;
+
+   //----------------------------------------------------------------
+   // test parameter
+   //
+   if ((ubPhyIfV > CP_CHANNEL_MAX) || (ubPhyIfV == eCP_CHANNEL_NONE))
+   {
+      return (eCP_ERR_CHANNEL);
+   }
+
+   ptsChannelT = &(atsChannelS[ubPhyIfV - 1]);
+   if (pszHostV == (CPP_CONST char *) 0L)
+   {
+      ptsChannelT->aszHost[0] = '\0';
+   }
+   else
+   {
+      if (strlen(pszHostV) >= HOST_NAME_MAX_LEN)
+      {
+         return (eCP_ERR_PARAM);
+      }
+      strcpy(&(ptsChannelT->aszHost[0]), pszHostV);
+   }
+   ptsChannelT->uwPort = uwPortV;
+
+   return (eCP_ERR_NONE);
+}
@@ -0,0 +1,133 @@
+//============================================================================//
+// File:          qcan_client_canpie_fd.h                                     //
+// Description:   CANpie FD driver for the Qt-free QCan client                //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+#ifndef  QCAN_CLIENT_CANPIE_FD_H_
+#define  QCAN_CLIENT_CANPIE_FD_H_
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+#include "cp_core.h"
+#include "qcan_client.h"
+
+
+//-----------------------------------------------------------------------------
+/*!
+** \file    qcan_client_canpie_fd.h
+** \brief   CANpie FD driver for the Qt-free QCan client
+**
+** The driver implements the %CANpie FD core functions on top of the
+** QCanClient functions, so an application using the C API of %CANpie FD
+** connects to a QCanServer without linking Qt. Each CAN channel
+** (eCP_CHANNEL_1 .. #CP_CHANNEL_MAX) is connected to the network with the
+** same number by CpCoreDriverInit().
+**
+** There is no thread inside the driver. Received frames are processed,
+** callback handlers are called and pending transmit FIFOs are written by
+** CpSocketPoll(), which takes the place of the CAN interrupt of an
+** embedded target. CpCoreFifoRead() and CpCoreFifoWrite() process the
+** socket as well, so an application which only uses FIFOs does not need
+** to call CpSocketPoll(). All functions of one CAN channel must be called
+** by the same thread.
+*/
+
+
+//-------------------------------------------------------------------//
+// take precautions if compiled with C++ compiler                    //
+#ifdef __cplusplus                                                   //
+extern "C" {                                                         //
+#endif                                                               //
+//-------------------------------------------------------------------//
+
+
+/*----------------------------------------------------------------------------*\
+** Function prototypes                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+/*!
+** \brief   Get file descriptor of a CAN channel
+** \param   ptsPortV    - Pointer to CAN port
+** \return  File descriptor of the socket, -1 if not connected
+**
+** The file descriptor can be added to the event loop of the application,
+** CpSocketPoll() is called with a timeout of 0 when it is readable.
+*/
+int32_t     CpSocketDescriptor(CpPort_ts *ptsPortV);
+
+
+/*!
+** \brief   Process CAN channel
+** \param   ptsPortV    - Pointer to CAN port
+** \param   slTimeoutV  - Maximum time to wait for CAN frames in
+**                        milli-seconds, -1 waits infinitely
+** \return  Error code taken from the CpErr enumeration, #eCP_ERR_INIT_FAIL
+**          if the connection to the server is lost
+**
+** The function waits until CAN frames are received, the timeout of a FIFO
+** notification (see CpCoreFifoEvent()) has elapsed or \a slTimeoutV has
+** elapsed. Afterwards the received frames are passed to the message
+** buffers and the callback handlers are called.
+*/
+CpStatus_tv CpSocketPoll(CpPort_ts *ptsPortV, int32_t slTimeoutV);
+
+
+/*!
+** \brief   Set server address of a CAN channel
+** \param   ubPhyIfV    - CAN channel, first channel is eCP_CHANNEL_1
+** \param   pszHostV    - Host name or address of the server, the local
+**                        server is used for a value of 0
+** \param   uwPortV     - TCP port of the first network, the default
+**                        #QCAN_CLIENT_TCP_PORT is used for a value of 0
+** \return  Error code taken from the CpErr enumeration
+**
+** The address is used by the next call of CpCoreDriverInit().
+*/
+CpStatus_tv CpSocketSetHostAddress(uint8_t ubPhyIfV, CPP_CONST char *pszHostV,
+                                   uint16_t uwPortV);
+
+
+//-------------------------------------------------------------------//
+#ifdef __cplusplus                                                   //
+}                                                                    //
+#endif                                                               //
+// end of C++ compiler wrapper                                       //
+//-------------------------------------------------------------------//
+
+
+#endif   // QCAN_CLIENT_CANPIE_FD_H_
@@ -62,6 +62,14 @@ enum DrvInfo_e {
    eDRV_INFO_INIT
 };
 
+//-------------------------------------------------------------------
+// transmit commands for the I/O thread
+//
+enum IoCmd_e {
+   eIO_CMD_BUFFER_SEND = 0,
+   eIO_CMD_FIFO_WRITE
+};
+
 /*----------------------------------------------------------------------------*\
 ** Internal function                                                          **
 **                                                                            **
@@ -82,6 +90,14 @@ enum DrvInfo_e {
 
 static QCanSocketCpFD  aclCanSockListS[CP_CHANNEL_MAX];
 
+//-------------------------------------------------------------------
+// the I/O thread owns all initialised sockets, it is stopped when
+// the last socket is released
+//
+static QThread *       pclIoThreadS = Q_NULLPTR;
+static uint8_t         ubIoSocketCntS = 0;
+static QMutex          clIoMutexS;
+
 
 /*----------------------------------------------------------------------------*\
 ** Function implementation                                                    **
@@ -193,6 +209,7 @@ CpStatus_tv CpCoreBufferConfig( CpPort_ts * ptsPortV,
    if (tvStatusT == eCP_ERR_NONE)
    {
       pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
+      QMutexLocker clLockT(&(pclSockT->clConfigMutexP));
       
       //--------------------------------------------------------
       // test message format and mask identifier
@@ -253,6 +270,7 @@ CpStatus_tv CpCoreBufferGetData( CpPort_ts * ptsPortV,
 {
    QCanSocketCpFD *  pclSockT;
    CpStatus_tv       tvStatusT;
+   CpCanMsg_ts       tsCanMsgT;
    uint8_t           ubCntT;
 
    //----------------------------------------------------------------
@@ -273,12 +291,13 @@ CpStatus_tv CpCoreBufferGetData( CpPort_ts * ptsPortV,
       else
       {
          //---------------------------------------------------
-         // copy data from simulated CAN buffer
+         // copy data from simulated CAN buffer, the message
+         // may be updated by the I/O thread
          //
+         pclSockT->bufferRead(ubBufferIdxV, tsCanMsgT);
          for(ubCntT = ubStartPosV; ubCntT < ubSizeV; ubCntT++)
          {
-            *pubDestDataV = CpMsgGetData(&(pclSockT->atsCanMsgP[ubBufferIdxV]), 
-                                          ubCntT);
+            *pubDestDataV = CpMsgGetData(&tsCanMsgT, ubCntT);
             pubDestDataV++;
          }
       }
@@ -297,6 +316,7 @@ CpStatus_tv CpCoreBufferGetDlc(  CpPort_ts * ptsPortV,
 {
    QCanSocketCpFD *  pclSockT;
    CpStatus_tv       tvStatusT;
+   CpCanMsg_ts       tsCanMsgT;
 
    //----------------------------------------------------------------
    // test parameter ptsPortV and ubBufferIdxV
@@ -309,7 +329,8 @@ CpStatus_tv CpCoreBufferGetDlc(  CpPort_ts * ptsPortV,
       //----------------------------------------------------------------
       // read DLC from simulated CAN buffer
       //
-      *pubDlcV = pclSockT->atsCanMsgP[ubBufferIdxV].ubMsgDLC;   
+      pclSockT->bufferRead(ubBufferIdxV, tsCanMsgT);
+      *pubDlcV = tsCanMsgT.ubMsgDLC;   
    }
 
    return (tvStatusT);
@@ -333,6 +354,7 @@ CpStatus_tv CpCoreBufferRelease( CpPort_ts * ptsPortV,
    if (tvStatusT == eCP_ERR_NONE)
    {
       pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
+      QMutexLocker clLockT(&(pclSockT->clConfigMutexP));
 
       //--------------------------------------------------------
       // clear simulated CAN buffer
@@ -352,10 +374,9 @@ CpStatus_tv CpCoreBufferRelease( CpPort_ts * ptsPortV,
 //----------------------------------------------------------------------------//
 CpStatus_tv CpCoreBufferSend(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV)
 {
-   QCanFrame        clFrameT;
+   QCanCpCmd_ts     tsCmdT;
    QCanSocketCpFD * pclSockT;
    CpStatus_tv      tvStatusT;
-   CpTrmHandler_Fn  pfnTrmHandlerT;
    
    //----------------------------------------------------------------
    // test parameter ptsPortV and ubBufferIdxV
@@ -366,24 +387,20 @@ CpStatus_tv CpCoreBufferSend(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV)
       pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
       
       //----------------------------------------------------------------
-      // write CAN frame
+      // pass a copy of the message buffer to the I/O thread, the
+      // transmit handler is called after the frame has been written
       //
-      clFrameT = pclSockT->fromCpMsg(ubBufferIdxV);
-      if(pclSockT->write(clFrameT) == false)
+      tsCmdT.ubCommand   = eIO_CMD_BUFFER_SEND;
+      tsCmdT.ubBufferIdx = ubBufferIdxV;
+      tsCmdT.ulTick      = (uint32_t) (pclSockT->clFifoClockP.nsecsElapsed() / 1000);
+      tsCmdT.tsCanMsg    = pclSockT->atsCanMsgP[ubBufferIdxV];
+      if (pclSockT->clCmdQueueP.enqueue(tsCmdT) == false)
       {
          tvStatusT = eCP_ERR_TRM_FULL;
-         qDebug() << "Failed to write message";
       }
       else
       {
-         pclSockT->tsStatisticP.ulTrmMsgCount++;
-
-         if (pclSockT->pfnTrmIntHandlerP != 0)
-         {
-            pfnTrmHandlerT = pclSockT->pfnTrmIntHandlerP;
-            tvStatusT = (* pfnTrmHandlerT)(&(pclSockT->atsCanMsgP[ubBufferIdxV]),
-                                           ubBufferIdxV);
-         }
+         pclSockT->ioWake();
       }
    }
 
@@ -487,6 +504,7 @@ CpStatus_tv CpCoreCanMode(CpPort_ts * ptsPortV, uint8_t ubModeV)
       if (ptsPortV->ubPhyIf < QCAN_NETWORK_MAX)
       {
          pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
+         QMutexLocker clLockT(&(pclSockT->clConfigMutexP));
 
          //-----------------------------------------------------
          // switch CAN controller into mode "ubModeV"
@@ -603,14 +621,41 @@ CpStatus_tv CpCoreDriverInit(uint8_t ubPhyIfV, CpPort_ts * ptsPortV,
    // get access to socket
    //
    pclSockT = &(aclCanSockListS[ubPhyIfV - 1]);
-   pclSockT->connectNetwork((CAN_Channel_e) ubPhyIfV, 1000);
+
+   //----------------------------------------------------------------
+   // start the I/O thread and move the socket to it, this must be
+   // done by the thread which owns the socket
+   //
+   clIoMutexS.lock();
+   if (pclIoThreadS == Q_NULLPTR)
+   {
+      pclIoThreadS = new QThread();
+      pclIoThreadS->setObjectName("CANpie I/O");
+      pclIoThreadS->start(QThread::TimeCriticalPriority);
+   }
+
+   if (pclSockT->thread() != pclIoThreadS)
+   {
+      if (pclSockT->thread() != QThread::currentThread())
+      {
+         clIoMutexS.unlock();
+         qWarning() << "CpCoreDriverInit() .......... : wrong thread";
+         return(eCP_ERR_INIT_FAIL);
+      }
+      pclSockT->pclOwnerThreadP = QThread::currentThread();
+      pclSockT->moveToThread(pclIoThreadS);
+      ubIoSocketCntS++;
+   }
+   clIoMutexS.unlock();
 
    //----------------------------------------------------------------
    // no FIFOs attached to message buffers
    //
+   pclSockT->clConfigMutexP.lock();
    for (uint8_t ubBufferCntT = 0; ubBufferCntT < CP_BUFFER_MAX; ubBufferCntT++)
    {
-      pclSockT->aptsCanFifoP[ubBufferCntT] = Q_NULLPTR;
+      pclSockT->aptsCanFifoP[ubBufferCntT]     = Q_NULLPTR;
+      pclSockT->apfnFifoHandlerP[ubBufferCntT] = Q_NULLPTR;
    }
    
    //----------------------------------------------------------------
@@ -633,7 +678,18 @@ CpStatus_tv CpCoreDriverInit(uint8_t ubPhyIfV, CpPort_ts * ptsPortV,
    pclSockT->tsStatisticP.ulErrMsgCount = 0;
    pclSockT->tsStatisticP.ulRcvMsgCount = 0;
    pclSockT->tsStatisticP.ulTrmMsgCount = 0;
+
+   memset(&(pclSockT->tsStatisticExtP), 0, sizeof(CpStatisticExt_ts));
+   pclSockT->tsStatisticExtP.tsRcvHandler.ulTimeMin  = 0xFFFFFFFF;
+   pclSockT->tsStatisticExtP.tsTrmHandler.ulTimeMin  = 0xFFFFFFFF;
+   pclSockT->tsStatisticExtP.tsFifoHandler.ulTimeMin = 0xFFFFFFFF;
+   pclSockT->clConfigMutexP.unlock();
    
+   //----------------------------------------------------------------
+   // connect the socket inside the I/O thread
+   //
+   pclSockT->teIoChannelP = (CAN_Channel_e) ubPhyIfV;
+   QMetaObject::invokeMethod(pclSockT, "onIoConnect", Qt::BlockingQueuedConnection);
 
    qDebug() << "CpCoreDriverInit() .......... : connected";
    return (eCP_ERR_NONE);
@@ -646,10 +702,31 @@ CpStatus_tv CpCoreDriverInit(uint8_t ubPhyIfV, CpPort_ts * ptsPortV,
 //----------------------------------------------------------------------------//
 CpStatus_tv CpCoreDriverRelease(CpPort_ts * ptsPortV)
 {
-   CpStatus_tv tvStatusT;
+   QCanSocketCpFD *  pclSockT;
+   CpStatus_tv       tvStatusT;
 
    tvStatusT = CpCoreCanMode(ptsPortV, eCP_MODE_STOP);
-   aclCanSockListS[(ptsPortV->ubPhyIf) - 1].disconnectNetwork();
+   pclSockT  = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
+
+   //----------------------------------------------------------------
+   // the I/O thread disconnects the socket and passes it back to
+   // the thread which has called CpCoreDriverInit()
+   //
+   clIoMutexS.lock();
+   if ((pclIoThreadS != Q_NULLPTR) && (pclSockT->thread() == pclIoThreadS))
+   {
+      QMetaObject::invokeMethod(pclSockT, "onIoDisconnect", Qt::BlockingQueuedConnection);
+
+      ubIoSocketCntS--;
+      if (ubIoSocketCntS == 0)
+      {
+         pclIoThreadS->quit();
+         pclIoThreadS->wait();
+         delete pclIoThreadS;
+         pclIoThreadS = Q_NULLPTR;
+      }
+   }
+   clIoMutexS.unlock();
 
    return (tvStatusT);
 }
@@ -675,8 +752,111 @@ CpStatus_tv CpCoreFifoConfig(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
    if (tvStatusT == eCP_ERR_NONE)
    {
       pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
+      QMutexLocker clLockT(&(pclSockT->clConfigMutexP));
       
-      pclSockT->aptsCanFifoP[ubBufferIdxV] = ptsFifoV;
+      pclSockT->aptsCanFifoP[ubBufferIdxV]     = ptsFifoV;
+      pclSockT->apfnFifoHandlerP[ubBufferIdxV] = Q_NULLPTR;
+      pclSockT->aulRcvIndexInP[ubBufferIdxV].storeRelease(0);
+      pclSockT->aulRcvIndexOutP[ubBufferIdxV].storeRelease(0);
+      pclSockT->aulRcvIndexOutLastP[ubBufferIdxV] = 0;
+      #if CP_TRM_PRIORITY > 0
+      CpPrioInit(&(pclSockT->atsTrmPrioP[ubBufferIdxV]),
+                 &(pclSockT->atsTrmPrioEntryP[ubBufferIdxV][0]), CP_TRM_PRIORITY);
+      #endif
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoDelay()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoDelay(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+                            CpPrioDelay_ts * ptsDelayV)
+{
+   CpStatus_tv       tvStatusT;
+   QCanSocketCpFD *  pclSockT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
+      QMutexLocker clLockT(&(pclSockT->clConfigMutexP));
+
+      if (ptsDelayV == Q_NULLPTR)
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else if (pclSockT->aptsCanFifoP[ubBufferIdxV] == Q_NULLPTR)
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+      else
+      {
+         #if CP_TRM_PRIORITY > 0
+         memcpy(ptsDelayV, &(pclSockT->atsTrmPrioP[ubBufferIdxV].atsDelay[0]),
+                sizeof(pclSockT->atsTrmPrioP[ubBufferIdxV].atsDelay));
+         #else
+         tvStatusT = eCP_ERR_NOT_SUPPORTED;
+         #endif
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoEvent()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoEvent(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+                            CpFifoHandler_Fn pfnFifoHandlerV,
+                            uint32_t ulHighMarkV, uint32_t ulLowMarkV,
+                            uint32_t ulTimeoutV)
+{
+   CpStatus_tv       tvStatusT;
+   QCanSocketCpFD *  pclSockT;
+   CpFifo_ts *       ptsFifoT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
+      QMutexLocker clLockT(&(pclSockT->clConfigMutexP));
+      ptsFifoT = pclSockT->aptsCanFifoP[ubBufferIdxV];
+
+      if (ptsFifoT == Q_NULLPTR)
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+      else if (pfnFifoHandlerV == Q_NULLPTR)
+      {
+         pclSockT->apfnFifoHandlerP[ubBufferIdxV] = Q_NULLPTR;
+      }
+      else if ((ulHighMarkV == 0) || (ulHighMarkV <= ulLowMarkV) ||
+               (ulHighMarkV > ptsFifoT->ulIndexMax))
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+      else
+      {
+         //--------------------------------------------------------
+         // messages which are already pending are notified by
+         // the next run of the I/O thread
+         //
+         CpFifoEventInit(&(pclSockT->atsFifoEventP[ubBufferIdxV]), ulHighMarkV,
+                         ulLowMarkV, ulTimeoutV);
+         pclSockT->apfnFifoHandlerP[ubBufferIdxV] = pfnFifoHandlerV;
+      }
    }
 
    return (tvStatusT);
@@ -694,7 +874,12 @@ CpStatus_tv CpCoreFifoRead(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
    CpStatus_tv       tvStatusT;
    QCanSocketCpFD *  pclSockT;
    CpFifo_ts *       ptsFifoT;
-   CpCanMsg_ts *     ptsFifoMsgT;
+   uint32_t          ulIndexInT;
+   uint32_t          ulIndexOutT;
+   uint32_t          ulIndexMaxT;
+   uint32_t          ulMsgCntT;
+   uint32_t          ulMsgMaxT;
+   uint32_t          ulSpanT;
    
    //----------------------------------------------------------------
    // test parameter ptsPortV and ubBufferIdxV
@@ -709,23 +894,68 @@ CpStatus_tv CpCoreFifoRead(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
       {
          tvStatusT = eCP_ERR_FIFO_PARAM;
       }
+      else if ((pulMsgCntV == Q_NULLPTR) || (ptsCanMsgV == Q_NULLPTR))
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
       else
       {
-         if(CpFifoIsEmpty(ptsFifoT) == 1)
+         //--------------------------------------------------------
+         // copy pending messages block-wise, the ring layout
+         // requires at most two blocks
+         //
+         ulIndexMaxT = ptsFifoT->ulIndexMax;
+         ulIndexInT  = pclSockT->aulRcvIndexInP[ubBufferIdxV].loadAcquire();
+         ulIndexOutT = pclSockT->aulRcvIndexOutP[ubBufferIdxV].loadAcquire();
+         ulMsgMaxT   = *pulMsgCntV;
+         ulMsgCntT   = 0;
+         while ((ulMsgCntT < ulMsgMaxT) && (ulIndexOutT != ulIndexInT))
+         {
+            //------------------------------------------------
+            // number of pending messages, limited by the end
+            // of the FIFO memory
+            //
+            ulSpanT = (ulIndexInT + (2 * ulIndexMaxT) - ulIndexOutT) % (2 * ulIndexMaxT);
+            if (ulSpanT > (ulIndexMaxT - (ulIndexOutT % ulIndexMaxT)))
+            {
+               ulSpanT = ulIndexMaxT - (ulIndexOutT % ulIndexMaxT);
+            }
+
+            if (ulSpanT > (ulMsgMaxT - ulMsgCntT))
+            {
+               ulSpanT = ulMsgMaxT - ulMsgCntT;
+            }
+
+            memcpy(ptsCanMsgV, &(ptsFifoT->ptsCanMsg[ulIndexOutT % ulIndexMaxT]),
+                   ulSpanT * sizeof(CpCanMsg_ts));
+
+            ulIndexOutT += ulSpanT;
+            if (ulIndexOutT == (2 * ulIndexMaxT))
+            {
+               ulIndexOutT = 0;
+            }
+
+            ptsCanMsgV += ulSpanT;
+            ulMsgCntT  += ulSpanT;
+         }
+         *pulMsgCntV = ulMsgCntT;   // store number of messages read
+
+         //--------------------------------------------------------
+         // release the entries, the I/O thread re-arms the
+         // notification
+         //
+         pclSockT->aulRcvIndexOutP[ubBufferIdxV].storeRelease(ulIndexOutT);
+
+         if (ulMsgCntT == 0)
          {
-            //--------------------------------------------------------
+            //------------------------------------------------
             // FIFO is empty, no data has been copied
             //
-            *pulMsgCntV = 0;
             tvStatusT = eCP_ERR_FIFO_EMPTY;
          }
          else
          {
-            ptsFifoMsgT = CpFifoDataOutPtr(ptsFifoT);
-            memcpy(ptsCanMsgV, ptsFifoMsgT, sizeof(CpCanMsg_ts));
-            CpFifoIncOut(ptsFifoT);
-            *pulMsgCntV = 1;
-            tvStatusT = eCP_ERR_NONE;
+            pclSockT->ioWake();
          }
       }
    }
@@ -749,7 +979,13 @@ CpStatus_tv CpCoreFifoRelease(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV)
    if (tvStatusT == eCP_ERR_NONE)
    {
       pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
-      pclSockT->aptsCanFifoP[ubBufferIdxV] = Q_NULLPTR;
+      QMutexLocker clLockT(&(pclSockT->clConfigMutexP));
+      pclSockT->aptsCanFifoP[ubBufferIdxV]     = Q_NULLPTR;
+      pclSockT->apfnFifoHandlerP[ubBufferIdxV] = Q_NULLPTR;
+      #if CP_TRM_PRIORITY > 0
+      CpPrioInit(&(pclSockT->atsTrmPrioP[ubBufferIdxV]),
+                 &(pclSockT->atsTrmPrioEntryP[ubBufferIdxV][0]), CP_TRM_PRIORITY);
+      #endif
    }
 
    return (tvStatusT);
@@ -764,49 +1000,42 @@ CpStatus_tv CpCoreFifoWrite(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
                             CpCanMsg_ts * ptsCanMsgV,
                             uint32_t * pulMsgCntV)
 {
-   QCanFrame         clFrameT;
+   QCanCpCmd_ts      tsCmdT;
    QCanSocketCpFD *  pclSockT;
    CpStatus_tv       tvStatusT;
    uint32_t          ulMsgCntT;
-   CpTrmHandler_Fn   pfnTrmHandlerT;
-   
    
-   qDebug() << "CpCoreFifoWrite() ........... :" << ubBufferIdxV;
-
    //----------------------------------------------------------------
    // test parameter ptsPortV and ubBufferIdxV
    //
    tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
    if (tvStatusT == eCP_ERR_NONE)
    {
-      qDebug() << "CpCoreFifoWrite() ........... :" << ubBufferIdxV;
-
       pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
       
       //----------------------------------------------------------------
-      // write CAN frame
+      // pass the CAN frames to the I/O thread, the tick value is the
+      // start of the queueing delay of the transmit queue
       //
+      tsCmdT.ubCommand   = eIO_CMD_FIFO_WRITE;
+      tsCmdT.ubBufferIdx = ubBufferIdxV;
+      tsCmdT.ulTick      = (uint32_t) (pclSockT->clFifoClockP.nsecsElapsed() / 1000);
       for (ulMsgCntT = 0; ulMsgCntT < *pulMsgCntV; ulMsgCntT++)
       {
-         clFrameT = pclSockT->fromCpMsg(ptsCanMsgV);
-         if(pclSockT->write(clFrameT) == false)
+         tsCmdT.tsCanMsg = *ptsCanMsgV;
+         if (pclSockT->clCmdQueueP.enqueue(tsCmdT) == false)
          {
-            tvStatusT = eCP_ERR_TRM_FULL;
-            qDebug() << "CpCoreFifoWrite() ........... : failed";
+            tvStatusT = eCP_ERR_FIFO_FULL;
             break;
          }
-
-         if (pclSockT->pfnTrmIntHandlerP != 0)
-         {
-            pfnTrmHandlerT = pclSockT->pfnTrmIntHandlerP;
-            tvStatusT = (* pfnTrmHandlerT)(ptsCanMsgV, ubBufferIdxV);
-         }
-
          ptsCanMsgV++;
       }
-      *pulMsgCntV = ulMsgCntT;   // store number of messages written
+      *pulMsgCntV = ulMsgCntT;   // store number of messages queued
 
-      pclSockT->tsStatisticP.ulTrmMsgCount += ulMsgCntT;
+      if (ulMsgCntT > 0)
+      {
+         pclSockT->ioWake();
+      }
    }
    
    return (tvStatusT);
@@ -868,6 +1097,7 @@ CpStatus_tv CpCoreIntFunctions( CpPort_ts * ptsPortV,
       if (ptsPortV->ubPhyIf < QCAN_NETWORK_MAX)
       {
          pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
+         QMutexLocker clLockT(&(pclSockT->clConfigMutexP));
 
          //------------------------------------------------
          // store the new callbacks
@@ -890,21 +1120,61 @@ CpStatus_tv CpCoreIntFunctions( CpPort_ts * ptsPortV,
 //----------------------------------------------------------------------------//
 CpStatus_tv CpCoreStatistic(CpPort_ts * ptsPortV, CpStatistic_ts * ptsStatsV)
 {
+   QCanSocketCpFD *  pclSockT;
+   CpStatus_tv       tvStatusT;
+
    //----------------------------------------------------------------
-   // avoid compiler warning
+   // test parameter ptsPortV
    //
-   #if CP_SMALL_CODE == 0
-   if(ptsPortV == 0L)
+   tvStatusT = CheckParam(ptsPortV, 0, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
    {
-      return(eCP_ERR_PARAM);
+      pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
+      QMutexLocker clLockT(&(pclSockT->clConfigMutexP));
+
+      if (ptsStatsV == Q_NULLPTR)
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else
+      {
+         *ptsStatsV = pclSockT->tsStatisticP;
+      }
    }
-   #endif
 
-   ptsStatsV->ulErrMsgCount = 0;
-   ptsStatsV->ulRcvMsgCount = 0;
-   ptsStatsV->ulTrmMsgCount = 0;
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreStatisticExt()                                                       //
+// return extended statistical information                                    //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreStatisticExt(CpPort_ts * ptsPortV, CpStatisticExt_ts * ptsStatsV)
+{
+   QCanSocketCpFD *  pclSockT;
+   CpStatus_tv       tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV
+   //
+   tvStatusT = CheckParam(ptsPortV, 0, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      pclSockT = &(aclCanSockListS[(ptsPortV->ubPhyIf) - 1]);
+      QMutexLocker clLockT(&(pclSockT->clConfigMutexP));
+
+      if (ptsStatsV == Q_NULLPTR)
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else
+      {
+         *ptsStatsV = pclSockT->tsStatisticExtP;
+      }
+   }
 
-   return(eCP_ERR_NONE);
+   return (tvStatusT);
 }
 
 
@@ -982,15 +1252,134 @@ CpStatus_tv CpSocketSetHostAddress(uint8_t ubPhyIfV,
 //                                                                            //
 //----------------------------------------------------------------------------//
 QCanSocketCpFD::QCanSocketCpFD()
+   : clConfigMutexP(QMutex::Recursive)
 {
 
    pfnRcvIntHandlerP = 0;
    pfnTrmIntHandlerP = 0;
 
+   for (uint8_t ubBufferCntT = 0; ubBufferCntT < CP_BUFFER_MAX; ubBufferCntT++)
+   {
+      aptsCanFifoP[ubBufferCntT]        = Q_NULLPTR;
+      apfnFifoHandlerP[ubBufferCntT]    = Q_NULLPTR;
+      aulRcvIndexOutLastP[ubBufferCntT] = 0;
+   }
+
+   //----------------------------------------------------------------
+   // the timers are children of the socket, so they are moved to
+   // the I/O thread together with the socket
+   //
+   clFifoTimerP.setParent(this);
+
+   //----------------------------------------------------------------
+   // the FIFO timer runs only while a timeout is pending
+   //
+   clFifoClockP.start();
+   clFifoTimerP.setSingleShot(true);
+   connect(&clFifoTimerP, SIGNAL(timeout()), this, SLOT(onFifoTimeout()));
+
+   //----------------------------------------------------------------
+   // the transmit queues are written by the I/O thread, so messages
+   // queued before the I/O thread runs are sorted
+   //
+   #if CP_TRM_PRIORITY > 0
+   for (uint8_t ubBufferCntT = 0; ubBufferCntT < CP_BUFFER_MAX; ubBufferCntT++)
+   {
+      CpPrioInit(&(atsTrmPrioP[ubBufferCntT]), &(atsTrmPrioEntryP[ubBufferCntT][0]),
+                 CP_TRM_PRIORITY);
+   }
+   #endif
+
+   slIoWakeP.storeRelease(0);
+   pclOwnerThreadP = Q_NULLPTR;
+   teIoChannelP    = eCAN_CHANNEL_NONE;
+
    ubStatusP = 0;
 }
 
 
+//----------------------------------------------------------------------------//
+// bufferRead()                                                               //
+// copy message buffer which may be updated by the I/O thread                 //
+//----------------------------------------------------------------------------//
+void QCanSocketCpFD::bufferRead(uint8_t ubBufferIdxV, CpCanMsg_ts & tsCanMsgR)
+{
+   quint32  ulSequenceT;
+
+   //----------------------------------------------------------------
+   // repeat the copy if the I/O thread has changed the message
+   // buffer in the meantime
+   //
+   do
+   {
+      ulSequenceT = aulBufferSeqP[ubBufferIdxV].loadAcquire();
+      tsCanMsgR   = atsCanMsgP[ubBufferIdxV];
+   } while (((ulSequenceT & 1) != 0) ||
+            (aulBufferSeqP[ubBufferIdxV].fetchAndAddOrdered(0) != ulSequenceT));
+}
+
+
+//----------------------------------------------------------------------------//
+// fifoNotify()                                                               //
+// call FIFO handler                                                          //
+//----------------------------------------------------------------------------//
+void QCanSocketCpFD::fifoNotify(uint8_t ubBufferIdxV)
+{
+   qint64   sqStartT;
+
+   sqStartT = clFifoClockP.nsecsElapsed();
+   (* apfnFifoHandlerP[ubBufferIdxV])(ubBufferIdxV, rcvFifoPending(ubBufferIdxV));
+   handlerTime(tsStatisticExtP.tsFifoHandler, sqStartT);
+}
+
+
+//----------------------------------------------------------------------------//
+// fifoEventSchedule()                                                        //
+// start FIFO timer for the next timeout                                      //
+//----------------------------------------------------------------------------//
+void QCanSocketCpFD::fifoEventSchedule(void)
+{
+   CpFifoEvent_ts *  ptsEventT;
+   uint32_t          ulTickT;
+   uint32_t          ulWaitT;
+   uint32_t          ulWaitMinT = 0xFFFFFFFF;
+
+   ulTickT = (uint32_t) clFifoClockP.elapsed();
+
+   for (uint8_t ubBufferCntT = 0; ubBufferCntT < CP_BUFFER_MAX; ubBufferCntT++)
+   {
+      ptsEventT = &(atsFifoEventP[ubBufferCntT]);
+      if ((apfnFifoHandlerP[ubBufferCntT] != Q_NULLPTR) &&
+          (ptsEventT->ulState == (CP_FIFO_EVENT_ARMED | CP_FIFO_EVENT_TIMER)))
+      {
+         ulWaitT = ulTickT - ptsEventT->ulTickStart;
+         if (ulWaitT < ptsEventT->ulTimeout)
+         {
+            ulWaitT = ptsEventT->ulTimeout - ulWaitT;
+         }
+         else
+         {
+            ulWaitT = 0;
+         }
+
+         if (ulWaitT < ulWaitMinT)
+         {
+            ulWaitMinT = ulWaitT;
+         }
+      }
+   }
+
+   if (ulWaitMinT == 0xFFFFFFFF)
+   {
+      clFifoTimerP.stop();
+   }
+   else
+   {
+      clFifoTimerP.start((int) ulWaitMinT);
+   }
+}
+
+
 //----------------------------------------------------------------------------//
 // fromCanFrame()                                                             //
 // message conversion                                                         //
@@ -1005,28 +1394,28 @@ CpCanMsg_ts QCanSocketCpFD::fromCanFrame(QCanFrame & clCanFrameR)
    switch(clCanFrameR.frameFormat())
    {
       case QCanFrame::eFORMAT_CAN_STD:
-         CpMsgInit(&tsCanMsgT, CP_MSG_FORMAT_CBFF);
+         CpMsg::init(tsCanMsgT, CP_MSG_FORMAT_CBFF);
          break;
 
       case QCanFrame::eFORMAT_CAN_EXT:
-         CpMsgInit(&tsCanMsgT, CP_MSG_FORMAT_CEFF);
+         CpMsg::init(tsCanMsgT, CP_MSG_FORMAT_CEFF);
          break;
          
       case QCanFrame::eFORMAT_FD_STD:
-         CpMsgInit(&tsCanMsgT, CP_MSG_FORMAT_FBFF);
+         CpMsg::init(tsCanMsgT, CP_MSG_FORMAT_FBFF);
          break;
          
       case QCanFrame::eFORMAT_FD_EXT:
-         CpMsgInit(&tsCanMsgT, CP_MSG_FORMAT_FEFF);
+         CpMsg::init(tsCanMsgT, CP_MSG_FORMAT_FEFF);
          break;
    }
    
-   CpMsgSetIdentifier(&tsCanMsgT, clCanFrameR.identifier());
-   CpMsgSetDlc(&tsCanMsgT, clCanFrameR.dlc());
+   CpMsg::setIdentifier(tsCanMsgT, clCanFrameR.identifier());
+   CpMsg::setDlc(tsCanMsgT, clCanFrameR.dlc());
 
    for(ubDataCntT = 0; ubDataCntT < CP_DATA_SIZE; ubDataCntT++)
    {
-      CpMsgSetData(&tsCanMsgT, ubDataCntT, clCanFrameR.data(ubDataCntT));
+      CpMsg::setData(tsCanMsgT, ubDataCntT, clCanFrameR.data(ubDataCntT));
    }
    return(tsCanMsgT);
 }
@@ -1041,9 +1430,9 @@ QCanFrame QCanSocketCpFD::fromCpMsg(CpCanMsg_ts * ptsCanMsgV)
    QCanFrame      clCanFrameT;
    uint8_t        ubDataCntT;
 
-   if(CpMsgIsFdFrame(ptsCanMsgV))
+   if(CpMsg::isFdFrame(*ptsCanMsgV))
    {
-      if(CpMsgIsExtended(ptsCanMsgV))
+      if(CpMsg::isExtended(*ptsCanMsgV))
       {
          clCanFrameT.setFrameFormat(QCanFrame::eFORMAT_FD_EXT);
       }
@@ -1054,7 +1443,7 @@ QCanFrame QCanSocketCpFD::fromCpMsg(CpCanMsg_ts * ptsCanMsgV)
    }
    else
    {
-      if(CpMsgIsExtended(ptsCanMsgV))
+      if(CpMsg::isExtended(*ptsCanMsgV))
       {
          clCanFrameT.setFrameFormat(QCanFrame::eFORMAT_CAN_EXT);
       }
@@ -1063,12 +1452,12 @@ QCanFrame QCanSocketCpFD::fromCpMsg(CpCanMsg_ts * ptsCanMsgV)
          clCanFrameT.setFrameFormat(QCanFrame::eFORMAT_CAN_STD);
       }
    }
-   clCanFrameT.setIdentifier(CpMsgGetIdentifier(ptsCanMsgV));
-   clCanFrameT.setDlc(CpMsgGetDlc(ptsCanMsgV));
+   clCanFrameT.setIdentifier(CpMsg::identifier(*ptsCanMsgV));
+   clCanFrameT.setDlc(CpMsg::dlc(*ptsCanMsgV));
 
    for(ubDataCntT = 0; ubDataCntT < clCanFrameT.dataSize(); ubDataCntT++)
    {
-      clCanFrameT.setData(ubDataCntT, CpMsgGetData(ptsCanMsgV, ubDataCntT));
+      clCanFrameT.setData(ubDataCntT, CpMsg::data(*ptsCanMsgV, ubDataCntT));
    }
 
    return(clCanFrameT);
@@ -1087,9 +1476,9 @@ QCanFrame QCanSocketCpFD::fromCpMsg(uint8_t ubMsgBufferV)
 
    ptsCanMsgT = &(atsCanMsgP[ubMsgBufferV]);
 
-   if(CpMsgIsFdFrame(ptsCanMsgT))
+   if(CpMsg::isFdFrame(*ptsCanMsgT))
    {
-      if(CpMsgIsExtended(ptsCanMsgT))
+      if(CpMsg::isExtended(*ptsCanMsgT))
       {
          clCanFrameT.setFrameFormat(QCanFrame::eFORMAT_FD_EXT);
       }
@@ -1100,7 +1489,7 @@ QCanFrame QCanSocketCpFD::fromCpMsg(uint8_t ubMsgBufferV)
    }
    else
    {
-      if(CpMsgIsExtended(ptsCanMsgT))
+      if(CpMsg::isExtended(*ptsCanMsgT))
       {
          clCanFrameT.setFrameFormat(QCanFrame::eFORMAT_CAN_EXT);
       }
@@ -1109,12 +1498,12 @@ QCanFrame QCanSocketCpFD::fromCpMsg(uint8_t ubMsgBufferV)
          clCanFrameT.setFrameFormat(QCanFrame::eFORMAT_CAN_STD);
       }
    }
-   clCanFrameT.setIdentifier(CpMsgGetIdentifier(ptsCanMsgT));
-   clCanFrameT.setDlc(CpMsgGetDlc(ptsCanMsgT));
+   clCanFrameT.setIdentifier(CpMsg::identifier(*ptsCanMsgT));
+   clCanFrameT.setDlc(CpMsg::dlc(*ptsCanMsgT));
 
    for(ubDataCntT = 0; ubDataCntT < clCanFrameT.dataSize(); ubDataCntT++)
    {
-      clCanFrameT.setData(ubDataCntT, CpMsgGetData(ptsCanMsgT, ubDataCntT));
+      clCanFrameT.setData(ubDataCntT, CpMsg::data(*ptsCanMsgT, ubDataCntT));
    }
 
    return(clCanFrameT);
@@ -1122,6 +1511,28 @@ QCanFrame QCanSocketCpFD::fromCpMsg(uint8_t ubMsgBufferV)
 
 
 
+//----------------------------------------------------------------------------//
+// handlerTime()                                                              //
+// update runtime of a callback handler                                       //
+//----------------------------------------------------------------------------//
+void QCanSocketCpFD::handlerTime(CpHandlerTime_ts & tsTimeR, qint64 sqStartV)
+{
+   uint32_t ulTimeT;
+
+   ulTimeT = (uint32_t) (clFifoClockP.nsecsElapsed() - sqStartV);
+   tsTimeR.ulCallCount++;
+   tsTimeR.uqTimeSum += ulTimeT;
+   if (ulTimeT < tsTimeR.ulTimeMin)
+   {
+      tsTimeR.ulTimeMin = ulTimeT;
+   }
+   if (ulTimeT > tsTimeR.ulTimeMax)
+   {
+      tsTimeR.ulTimeMax = ulTimeT;
+   }
+}
+
+
 //----------------------------------------------------------------------------//
 // handleCanFrame()                                                           //
 //                                                                            //
@@ -1132,9 +1543,42 @@ void QCanSocketCpFD::handleCanFrame(QCanFrame & clCanFrameR)
    CpCanMsg_ts *  ptsCanBufT;
    CpFifo_ts *    ptsFifoT;
    uint32_t       ulAccMaskT;
+   uint32_t       ulIdentifierT;
+   uint32_t       ulIndexInT;
+   uint32_t       ulPendingT;
+   qint64         sqStartT;
    uint8_t        ubBufferIdxT;
 
+   //----------------------------------------------------------------
+   // error frames update the CAN state, they are not passed to the
+   // message buffers and are not counted as received messages
+   //
+   if (clCanFrameR.frameType() == QCanFrame::eFRAME_TYPE_ERROR)
+   {
+      //--------------------------------------------------------
+      // the CAN state values and error types of QCan and CANpie
+      // are equal
+      //
+      tsCanStateP.ubCanErrState  = (uint8_t) clCanFrameR.errorState();
+      tsCanStateP.ubCanErrType   = (uint8_t) clCanFrameR.errorType();
+      tsCanStateP.ubCanRcvErrCnt = clCanFrameR.errorCounterReceive();
+      tsCanStateP.ubCanTrmErrCnt = clCanFrameR.errorCounterTransmit();
+
+      tsStatisticP.ulErrMsgCount++;
+      tsStatisticExtP.uqErrMsgCount++;
+
+      if (this->pfnErrIntHandlerP != 0)
+      {
+         (* this->pfnErrIntHandlerP)(&tsCanStateP);
+      }
+      return;
+   }
+
    tsCanMsgT = fromCanFrame(clCanFrameR);
+   ulIdentifierT = CpMsg::identifier(tsCanMsgT);
+
+   tsStatisticExtP.uqRcvMsgCount++;
+   tsStatisticExtP.uqRcvByteCount += CpMsg::dataSize(tsCanMsgT);
 
    //----------------------------------------------------------------
    // run through all possible message buffer
@@ -1159,22 +1603,24 @@ void QCanSocketCpFD::handleCanFrame(QCanFrame & clCanFrameR)
       //--------------------------------------------------------
       // distinguish frame types
       //
-      if (CpMsgIsExtended(ptsCanBufT) == CpMsgIsExtended(&tsCanMsgT))
+      if (CpMsg::isSameFormat(*ptsCanBufT, tsCanMsgT))
       {
          //------------------------------------------------
          // check for identifier
          //
-         if( (CpMsgGetIdentifier(ptsCanBufT) & ulAccMaskT) ==
-             (CpMsgGetIdentifier(&tsCanMsgT) & ulAccMaskT)    )
+         if( (CpMsg::identifier(*ptsCanBufT) & ulAccMaskT) ==
+             (ulIdentifierT & ulAccMaskT)    )
          {
             //----------------------------------------
             // copy to buffer
             //
+            aulBufferSeqP[ubBufferIdxT].fetchAndAddOrdered(1);
             ptsCanBufT->ulIdentifier   = tsCanMsgT.ulIdentifier;
             ptsCanBufT->ubMsgDLC       = tsCanMsgT.ubMsgDLC;
             memcpy(&(ptsCanBufT->tuMsgData.aubByte[0]),
                    &(tsCanMsgT.tuMsgData.aubByte[0]),
                    CP_DATA_SIZE );
+            aulBufferSeqP[ubBufferIdxT].fetchAndAddRelease(1);
             
             //----------------------------------------
             // test for receive callback handler
@@ -1186,17 +1632,52 @@ void QCanSocketCpFD::handleCanFrame(QCanFrame & clCanFrameR)
                //
                if (this->pfnRcvIntHandlerP != 0)
                {
+                  sqStartT = clFifoClockP.nsecsElapsed();
                   (* this->pfnRcvIntHandlerP)(ptsCanBufT, ubBufferIdxT);
+                  handlerTime(tsStatisticExtP.tsRcvHandler, sqStartT);
                }
             }
             else
             {
-               ptsFifoT = this->aptsCanFifoP[ubBufferIdxT];
-               if (CpFifoIsFull(ptsFifoT) == 0)
+               //--------------------------------
+               // copy to the receive ring, the
+               // message is visible to the reader
+               // after the input index is stored
+               //
+               ptsFifoT    = this->aptsCanFifoP[ubBufferIdxT];
+               ulIndexInT  = aulRcvIndexInP[ubBufferIdxT].loadAcquire();
+               if (rcvFifoPending(ubBufferIdxT) < ptsFifoT->ulIndexMax)
+               {
+                  ptsFifoT->ptsCanMsg[ulIndexInT % ptsFifoT->ulIndexMax] = tsCanMsgT;
+                  ulIndexInT++;
+                  if (ulIndexInT == (2 * ptsFifoT->ulIndexMax))
+                  {
+                     ulIndexInT = 0;
+                  }
+                  aulRcvIndexInP[ubBufferIdxT].storeRelease(ulIndexInT);
+
+                  ulPendingT = rcvFifoPending(ubBufferIdxT);
+                  if (ulPendingT > tsStatisticExtP.aulFifoHighWater[ubBufferIdxT])
+                  {
+                     tsStatisticExtP.aulFifoHighWater[ubBufferIdxT] = ulPendingT;
+                  }
+               }
+               else
+               {
+                  tsStatisticExtP.aulFifoOverrun[ubBufferIdxT]++;
+               }
+
+               //--------------------------------
+               // notify once per batch
+               //
+               if (this->apfnFifoHandlerP[ubBufferIdxT] != Q_NULLPTR)
                {
-                  ptsCanBufT = CpFifoDataInPtr(ptsFifoT);
-                  memcpy(ptsCanBufT, &tsCanMsgT, sizeof(CpCanMsg_ts));
-                  CpFifoIncIn(ptsFifoT);
+                  if (CpFifoEventIn(&(this->atsFifoEventP[ubBufferIdxT]),
+                                    rcvFifoState(ubBufferIdxT),
+                                    (uint32_t) clFifoClockP.elapsed()))
+                  {
+                     fifoNotify(ubBufferIdxT);
+                  }
                }
             }
 
@@ -1210,12 +1691,177 @@ void QCanSocketCpFD::handleCanFrame(QCanFrame & clCanFrameR)
 }
 
 
+//----------------------------------------------------------------------------//
+// ioWake()                                                                   //
+// wake up the I/O thread, may be called by any thread                        //
+//----------------------------------------------------------------------------//
+void QCanSocketCpFD::ioWake(void)
+{
+   //----------------------------------------------------------------
+   // only the first command of a burst posts an event to the
+   // I/O thread, following commands are read with it
+   //
+   if (slIoWakeP.testAndSetOrdered(0, 1))
+   {
+      QMetaObject::invokeMethod(this, "onIoQueue", Qt::QueuedConnection);
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// onFifoTimeout()                                                            //
+// notify FIFOs with messages pending longer than the timeout                 //
+//----------------------------------------------------------------------------//
+void QCanSocketCpFD::onFifoTimeout()
+{
+   QMutexLocker   clLockT(&clConfigMutexP);
+   uint32_t       ulTickT;
+
+   ulTickT = (uint32_t) clFifoClockP.elapsed();
+   for (uint8_t ubBufferCntT = 0; ubBufferCntT < CP_BUFFER_MAX; ubBufferCntT++)
+   {
+      if (apfnFifoHandlerP[ubBufferCntT] != Q_NULLPTR)
+      {
+         if (CpFifoEventTimer(&(atsFifoEventP[ubBufferCntT]), rcvFifoState(ubBufferCntT), ulTickT))
+         {
+            fifoNotify(ubBufferCntT);
+         }
+      }
+   }
+
+   fifoEventSchedule();
+}
+
+
+//----------------------------------------------------------------------------//
+// onIoConnect()                                                              //
+// connect the socket, called inside the I/O thread                           //
+//----------------------------------------------------------------------------//
+void QCanSocketCpFD::onIoConnect()
+{
+   connectNetwork(teIoChannelP, 1000);
+
+   //----------------------------------------------------------------
+   // commands which have been queued before the socket was
+   // connected are written now
+   //
+   onIoQueue();
+}
+
+
+//----------------------------------------------------------------------------//
+// onIoDisconnect()                                                           //
+// disconnect the socket, called inside the I/O thread                        //
+//----------------------------------------------------------------------------//
+void QCanSocketCpFD::onIoDisconnect()
+{
+   //----------------------------------------------------------------
+   // write pending commands before the socket is closed
+   //
+   onIoQueue();
+
+   clFifoTimerP.stop();
+   disconnectNetwork();
+
+   //----------------------------------------------------------------
+   // the socket (and its timers) must not stay in the I/O thread,
+   // which is deleted after the last socket has been released
+   //
+   moveToThread(pclOwnerThreadP);
+}
+
+
+//----------------------------------------------------------------------------//
+// onIoQueue()                                                                //
+// write pending commands and re-arm FIFO notifications                       //
+//----------------------------------------------------------------------------//
+void QCanSocketCpFD::onIoQueue()
+{
+   QMutexLocker   clLockT(&clConfigMutexP);
+   QCanCpCmd_ts   tsCmdT;
+   uint32_t       ulIndexOutT;
+   #if CP_TRM_PRIORITY > 0
+   uint32_t       ulPendingT;
+   #endif
+   uint32_t       ulTickT;
+
+   //----------------------------------------------------------------
+   // allow the next wake-up before the queue is read, a command
+   // enqueued from now on invokes this function again
+   //
+   slIoWakeP.storeRelease(0);
+
+   //----------------------------------------------------------------
+   // write all commands of the application threads, FIFO messages
+   // are sorted into the priority ordered transmit queues first
+   //
+   while (clCmdQueueP.dequeue(tsCmdT))
+   {
+      #if CP_TRM_PRIORITY > 0
+      if (tsCmdT.ubCommand == eIO_CMD_FIFO_WRITE)
+      {
+         if (CpPrioPush(&(atsTrmPrioP[tsCmdT.ubBufferIdx]), &(tsCmdT.tsCanMsg),
+                        tsCmdT.ulTick) == false)
+         {
+            //------------------------------------------------
+            // the queue is still full if the socket is blocked,
+            // the message is dropped in that case
+            //
+            trmPrioWrite();
+            if (CpPrioPush(&(atsTrmPrioP[tsCmdT.ubBufferIdx]), &(tsCmdT.tsCanMsg),
+                           tsCmdT.ulTick) == false)
+            {
+               tsStatisticExtP.aulFifoOverrun[tsCmdT.ubBufferIdx]++;
+               continue;
+            }
+         }
+
+         ulPendingT = CpPrioPending(&(atsTrmPrioP[tsCmdT.ubBufferIdx]));
+         if (ulPendingT > tsStatisticExtP.aulFifoHighWater[tsCmdT.ubBufferIdx])
+         {
+            tsStatisticExtP.aulFifoHighWater[tsCmdT.ubBufferIdx] = ulPendingT;
+         }
+         continue;
+      }
+      #endif
+      trmWrite(&(tsCmdT.tsCanMsg), tsCmdT.ubBufferIdx);
+   }
+   trmPrioWrite();
+
+   //----------------------------------------------------------------
+   // re-arm the notification of FIFOs which have been read since
+   // the last run, pending messages start a timeout
+   //
+   ulTickT = (uint32_t) clFifoClockP.elapsed();
+   for (uint8_t ubBufferCntT = 0; ubBufferCntT < CP_BUFFER_MAX; ubBufferCntT++)
+   {
+      if (apfnFifoHandlerP[ubBufferCntT] != Q_NULLPTR)
+      {
+         ulIndexOutT = aulRcvIndexOutP[ubBufferCntT].loadAcquire();
+         if (ulIndexOutT != aulRcvIndexOutLastP[ubBufferCntT])
+         {
+            aulRcvIndexOutLastP[ubBufferCntT] = ulIndexOutT;
+            CpFifoEventOut(&(atsFifoEventP[ubBufferCntT]), rcvFifoState(ubBufferCntT), ulTickT);
+         }
+
+         if (CpFifoEventIn(&(atsFifoEventP[ubBufferCntT]), rcvFifoState(ubBufferCntT), ulTickT))
+         {
+            fifoNotify(ubBufferCntT);
+         }
+      }
+   }
+
+   fifoEventSchedule();
+}
+
+
 //----------------------------------------------------------------------------//
 // onSocketReceive()                                                          //
 // receive CAN message                                                        //
 //----------------------------------------------------------------------------//
 void QCanSocketCpFD::onSocketReceive()
 {
+   QMutexLocker      clLockT(&clConfigMutexP);
    QCanFrame         clCanFrameT;
    uint32_t          ulFrameCntT;
    uint32_t          ulFrameMaxT;
@@ -1229,6 +1875,148 @@ void QCanSocketCpFD::onSocketReceive()
          handleCanFrame(clCanFrameT);
       }
    }
+
+   //----------------------------------------------------------------
+   // new messages below the high watermark start a timeout
+   //
+   fifoEventSchedule();
+}
+
+
+//----------------------------------------------------------------------------//
+// rcvFifoPending()                                                           //
+// number of messages inside the receive ring                                 //
+//----------------------------------------------------------------------------//
+uint32_t QCanSocketCpFD::rcvFifoPending(uint8_t ubBufferIdxV)
+{
+   uint32_t ulIndexMaxT;
+   uint32_t ulIndexInT;
+   uint32_t ulIndexOutT;
+
+   ulIndexMaxT = aptsCanFifoP[ubBufferIdxV]->ulIndexMax;
+   ulIndexInT  = aulRcvIndexInP[ubBufferIdxV].loadAcquire();
+   ulIndexOutT = aulRcvIndexOutP[ubBufferIdxV].loadAcquire();
+
+   return ((ulIndexInT + (2 * ulIndexMaxT) - ulIndexOutT) % (2 * ulIndexMaxT));
+}
+
+
+//----------------------------------------------------------------------------//
+// rcvFifoState()                                                             //
+// FIFO structure with the number of messages inside the receive ring         //
+//----------------------------------------------------------------------------//
+CpFifo_ts * QCanSocketCpFD::rcvFifoState(uint8_t ubBufferIdxV)
+{
+   CpFifo_ts * ptsStateT = &(atsRcvFifoStateP[ubBufferIdxV]);
+   uint32_t    ulPendingT;
+
+   //----------------------------------------------------------------
+   // the FIFO notification functions evaluate the number of pending
+   // messages only, so the state is built from this value
+   //
+   ulPendingT = rcvFifoPending(ubBufferIdxV);
+   ptsStateT->ulIndexMax = aptsCanFifoP[ubBufferIdxV]->ulIndexMax;
+   ptsStateT->ulIndexOut = 0;
+   ptsStateT->ptsCanMsg  = aptsCanFifoP[ubBufferIdxV]->ptsCanMsg;
+   if (ulPendingT == 0)
+   {
+      ptsStateT->ulIndexIn = 0;
+      ptsStateT->ulState   = 0x01;     // FIFO is empty
+   }
+   else if (ulPendingT == ptsStateT->ulIndexMax)
+   {
+      ptsStateT->ulIndexIn = 0;
+      ptsStateT->ulState   = 0x02;     // FIFO is full
+   }
+   else
+   {
+      ptsStateT->ulIndexIn = ulPendingT;
+      ptsStateT->ulState   = 0x00;
+   }
+
+   return (ptsStateT);
+}
+
+
+//----------------------------------------------------------------------------//
+// trmPrioWrite()                                                             //
+// write transmit queues to the socket in order of priority                   //
+//----------------------------------------------------------------------------//
+void QCanSocketCpFD::trmPrioWrite()
+{
+   #if CP_TRM_PRIORITY > 0
+   CpCanMsg_ts       tsCanMsgT;
+   uint32_t          ulKeyT;
+   uint32_t          ulSelectKeyT = 0;
+   uint32_t          ulTickT;
+   uint8_t           ubSelectT;
+
+   ulTickT = (uint32_t) (clFifoClockP.nsecsElapsed() / 1000);
+   while (1)
+   {
+      //--------------------------------------------------------
+      // select the buffer with the highest priority message
+      //
+      ubSelectT = CP_BUFFER_MAX;
+      for (uint8_t ubBufferCntT = 0; ubBufferCntT < CP_BUFFER_MAX; ubBufferCntT++)
+      {
+         if (CpPrioHead(&(atsTrmPrioP[ubBufferCntT]), &ulKeyT))
+         {
+            if ((ubSelectT == CP_BUFFER_MAX) || (ulKeyT < ulSelectKeyT))
+            {
+               ubSelectT    = ubBufferCntT;
+               ulSelectKeyT = ulKeyT;
+            }
+         }
+      }
+
+      if (ubSelectT == CP_BUFFER_MAX)
+      {
+         break;
+      }
+
+      //--------------------------------------------------------
+      // if the socket fails the message is dropped and counted
+      // by trmWrite(), remaining messages are written with the
+      // next run of onIoQueue()
+      //
+      CpPrioPop(&(atsTrmPrioP[ubSelectT]), &tsCanMsgT, ulTickT);
+      if (trmWrite(&tsCanMsgT, ubSelectT) == false)
+      {
+         break;
+      }
+   }
+   #endif
+}
+
+
+//----------------------------------------------------------------------------//
+// trmWrite()                                                                 //
+// write CAN message to the socket                                            //
+//----------------------------------------------------------------------------//
+bool QCanSocketCpFD::trmWrite(CpCanMsg_ts * ptsCanMsgV, uint8_t ubBufferIdxV)
+{
+   QCanFrame   clFrameT;
+   qint64      sqStartT;
+
+   clFrameT = fromCpMsg(ptsCanMsgV);
+   if (write(clFrameT) == false)
+   {
+      tsStatisticExtP.aulFifoOverrun[ubBufferIdxV]++;
+      return (false);
+   }
+   tsStatisticP.ulTrmMsgCount++;
+   tsStatisticExtP.uqTrmMsgCount++;
+   tsStatisticExtP.uqTrmByteCount += CpMsg::dataSize(*ptsCanMsgV);
+
+   if (pfnTrmIntHandlerP != 0)
+   {
+      sqStartT = clFifoClockP.nsecsElapsed();
+      (* pfnTrmIntHandlerP)(ptsCanMsgV, ubBufferIdxV);
+      handlerTime(tsStatisticExtP.tsTrmHandler, sqStartT);
+   }
+
+   return (true);
 }
 
 
@@ -41,12 +41,49 @@
 
 
 
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
 #include "../../canpie-fd/cp_core.h"
 #include "../../canpie-fd/cp_msg.h"
+#include "../../canpie-fd/cp_msg.hpp"
+#include "qcan_bounded_queue.hpp"
 #include "qcan_socket.hpp"
 #include "qcan_server_settings.hpp"
 
 
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// number of entries of the transmit command queue of one CAN
+// channel, the value must be a power of 2
+//
+#ifndef  QCAN_CPFD_CMD_QUEUE_SIZE
+#define  QCAN_CPFD_CMD_QUEUE_SIZE      256
+#endif
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \struct  QCanCpCmd_s
+**
+** Transmit command passed from the application threads to the I/O thread
+*/
+struct QCanCpCmd_s
+{
+   uint8_t        ubCommand;
+   uint8_t        ubBufferIdx;
+   uint32_t       ulTick;
+   CpCanMsg_ts    tsCanMsg;
+};
+
+typedef struct QCanCpCmd_s QCanCpCmd_ts;
 
 
 //----------------------------------------------------------------------------------------------------------------
@@ -55,6 +92,14 @@
 **
 ** The QCanSocketCpFD class provides an interface between the %CANpie FD core functions and the QCanSocket class.
 ** Hence it is possible to write applications using the C API of %CANpie FD.
+**
+** The sockets are owned by an I/O thread which is started by the first call of CpCoreDriverInit(). The functions
+** CpCoreBufferSend(), CpCoreBufferGetData(), CpCoreBufferGetDlc(), CpCoreFifoRead() and CpCoreFifoWrite() never
+** block and may be called from any thread, also from threads which do not run a Qt event loop. Messages for
+** transmission are passed through a lock-free command queue, received messages are passed through a lock-free
+** ring inside the FIFO memory of the application. A FIFO must be read by one thread only. The remaining functions
+** configure the driver, they are serialised with the I/O thread by a mutex. All callback handlers are called by
+** the I/O thread.
 */
 class QCanSocketCpFD : public QCanSocket
 {
@@ -109,6 +154,14 @@ public:
    friend  CpStatus_tv CpCoreFifoConfig(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
          CpFifo_ts * ptsFifoV);
    
+   friend  CpStatus_tv CpCoreFifoDelay(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+         CpPrioDelay_ts * ptsDelayV);
+   
+   friend  CpStatus_tv CpCoreFifoEvent(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+         CpFifoHandler_Fn pfnFifoHandlerV,
+         uint32_t ulHighMarkV, uint32_t ulLowMarkV,
+         uint32_t ulTimeoutV);
+   
    friend  CpStatus_tv CpCoreFifoRead(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
          CpCanMsg_ts * ptsCanMsgV,
          uint32_t * pulMsgCntV);
@@ -128,8 +181,14 @@ public:
    
    friend  CpStatus_tv CpCoreStatistic(CpPort_ts * ptsPortV, CpStatistic_ts * ptsStatsV);
    
+   friend  CpStatus_tv CpCoreStatisticExt(CpPort_ts * ptsPortV, CpStatisticExt_ts * ptsStatsV);
+   
   
 private slots:
+   void  onFifoTimeout(void);
+   void  onIoConnect(void);
+   void  onIoDisconnect(void);
+   void  onIoQueue(void);
    void  onSocketReceive(void);
 
    
@@ -138,13 +197,24 @@ private:
    QCanFrame      fromCpMsg(CpCanMsg_ts * ptsCanMsgV);
    CpCanMsg_ts    fromCanFrame(QCanFrame & clCanFrameR);
    
+   void           bufferRead(uint8_t ubBufferIdxV, CpCanMsg_ts & tsCanMsgR);
+   void           fifoEventSchedule(void);
+   void           fifoNotify(uint8_t ubBufferIdxV);
    void           handleCanFrame(QCanFrame & clCanFrameR);
+   void           handlerTime(CpHandlerTime_ts & tsTimeR, qint64 sqStartV);
+   void           ioWake(void);
+   uint32_t       rcvFifoPending(uint8_t ubBufferIdxV);
+   CpFifo_ts *    rcvFifoState(uint8_t ubBufferIdxV);
+   bool           trmWrite(CpCanMsg_ts * ptsCanMsgV, uint8_t ubBufferIdxV);
+   void           trmPrioWrite(void);
    
    //-------------------------------------------------------------------
-   // simulation of CAN message buffer
+   // simulation of CAN message buffer, received messages are copied
+   // by the I/O thread, the sequence number is odd during the copy
    //
    CpCanMsg_ts    atsCanMsgP[CP_BUFFER_MAX];
    uint32_t       atsAccMaskP[CP_BUFFER_MAX];
+   QAtomicInteger<quint32> aulBufferSeqP[CP_BUFFER_MAX];
 
 
    //-------------------------------------------------------------------
@@ -158,6 +228,47 @@ private:
    // these pointers store the FIFOs
    //
    CpFifo_ts *    aptsCanFifoP[CP_BUFFER_MAX];
+
+   //-------------------------------------------------------------------
+   // receive ring inside the memory of a FIFO: the index values run
+   // from 0 to 2 * ulIndexMax - 1, the input index is written by the
+   // I/O thread, the output index by the thread which reads the FIFO
+   //
+   QAtomicInteger<quint32> aulRcvIndexInP[CP_BUFFER_MAX];
+   QAtomicInteger<quint32> aulRcvIndexOutP[CP_BUFFER_MAX];
+   uint32_t                aulRcvIndexOutLastP[CP_BUFFER_MAX];
+   CpFifo_ts               atsRcvFifoStateP[CP_BUFFER_MAX];
+
+   //-------------------------------------------------------------------
+   // FIFO notification, the tick of the notification state is the
+   // elapsed time in milliseconds
+   //
+   CpFifoEvent_ts    atsFifoEventP[CP_BUFFER_MAX];
+   CpFifoHandler_Fn  apfnFifoHandlerP[CP_BUFFER_MAX];
+   QElapsedTimer     clFifoClockP;
+   QTimer            clFifoTimerP;
+
+   //-------------------------------------------------------------------
+   // priority ordered transmit queues, the queues are written to the
+   // socket by trmPrioWrite(), the tick of the queueing delay is
+   // the elapsed time in microseconds
+   //
+   #if CP_TRM_PRIORITY > 0
+   CpPrio_ts         atsTrmPrioP[CP_BUFFER_MAX];
+   CpPrioEntry_ts    atsTrmPrioEntryP[CP_BUFFER_MAX][CP_TRM_PRIORITY];
+   #endif
+
+   //-------------------------------------------------------------------
+   // I/O thread: the command queue is read by onIoQueue(), which is
+   // invoked once per burst of commands (slIoWakeP is set while the
+   // invocation is pending), the mutex serialises the configuration
+   // functions with the I/O thread
+   //
+   QCanBoundedQueue<QCanCpCmd_ts, QCAN_CPFD_CMD_QUEUE_SIZE> clCmdQueueP;
+   QAtomicInt           slIoWakeP;
+   QMutex               clConfigMutexP;
+   QThread *            pclOwnerThreadP;
+   CAN_Channel_e        teIoChannelP;
    
    //-------------------------------------------------------------------
    // store configured nominal bit-rate and data bit-rate
@@ -169,6 +280,12 @@ private:
    // statistic counter values
    //
    CpStatistic_ts tsStatisticP;
+
+   //-------------------------------------------------------------------
+   // extended statistic, updated by the I/O thread, the runtime of
+   // the handlers is taken from clFifoClockP
+   //
+   CpStatisticExt_ts tsStatisticExtP;
    
    //-------------------------------------------------------------------
    // CAN state value
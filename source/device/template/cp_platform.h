@@ -201,6 +201,18 @@
 */
 #define  CP_STATISTIC               1
 
+/*-------------------------------------------------------------------*/
+/*!
+** \def  CP_TRM_PRIORITY
+** \ingroup CP_CONF
+**
+** This symbol defines the number of entries of the priority ordered
+** transmit queue for each transmit FIFO.
+** - 0 = messages are transmitted in order of submission
+** - n = priority ordered transmit queue with n entries per buffer
+*/
+#define  CP_TRM_PRIORITY            0
+
 
 
 /*----------------------------------------------------------------------------*\
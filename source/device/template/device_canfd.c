@@ -46,6 +46,8 @@
 #include "cp_core.h"
 #include "cp_msg.h"
 
+#include <string.h>
+
 
 /*----------------------------------------------------------------------------*\
 ** Definitions                                                                **
@@ -82,6 +84,25 @@ static uint32_t    aulAccMaskS[CP_BUFFER_MAX];
 
 static uint8_t     ubCanModeS;
 
+//-------------------------------------------------------------------
+// FIFO notification, the receive interrupt calls CpFifoEventIn()
+// after storing a message in a FIFO, the timer interrupt increments
+// ulFifoTickS every millisecond and calls CpFifoEventTimer()
+//
+static CpFifoEvent_ts   atsFifoEventS[CP_BUFFER_MAX];
+static CpFifoHandler_Fn apfnFifoHandlerS[CP_BUFFER_MAX];
+static uint32_t         ulFifoTickS;
+
+#if CP_TRM_PRIORITY > 0
+//-------------------------------------------------------------------
+// priority ordered transmit queues, the transmit interrupt takes
+// the next message by CpPrioPop() from the queue which returns the
+// highest priority by CpPrioHead(), ulFifoTickS is used as tick
+//
+static CpPrio_ts        atsTrmPrioS[CP_BUFFER_MAX];
+static CpPrioEntry_ts   atsTrmPrioEntryS[CP_BUFFER_MAX][CP_TRM_PRIORITY];
+#endif
+
 //-------------------------------------------------------------------
 // these pointers store the callback handlers
 //
@@ -89,6 +110,15 @@ static CpRcvHandler_Fn  /*@null@*/  pfnRcvHandlerS = CPP_NULL;
 static CpTrmHandler_Fn  /*@null@*/  pfnTrmHandlerS = CPP_NULL;
 static CpErrHandler_Fn  /*@null@*/  pfnErrHandlerS = CPP_NULL;
 
+#if CP_STATISTIC > 0
+//-------------------------------------------------------------------
+// extended statistic, the receive interrupt counts messages, bytes
+// and FIFO overruns, the interrupts measure the runtime of the
+// callback handlers with a free running hardware timer
+//
+static CpStatisticExt_ts   tsStatisticExtS;
+#endif
+
 
 /*----------------------------------------------------------------------------*\
 ** Function implementation                                                    **
@@ -540,6 +570,13 @@ CpStatus_tv CpCoreDriverInit( uint8_t ubPhyIfV, CpPort_ts * ptsPortV,
             ptsPortV->ubPhyIf   = eCP_CHANNEL_1;
             ptsPortV->ubDrvInfo = eDRV_INFO_INIT;
             
+            #if CP_STATISTIC > 0
+            memset(&tsStatisticExtS, 0, sizeof(tsStatisticExtS));
+            tsStatisticExtS.tsRcvHandler.ulTimeMin  = 0xFFFFFFFF;
+            tsStatisticExtS.tsTrmHandler.ulTimeMin  = 0xFFFFFFFF;
+            tsStatisticExtS.tsFifoHandler.ulTimeMin = 0xFFFFFFFF;
+            #endif
+
             //----------------------------------------------
             // todo: hardware initialisation
             //
@@ -614,11 +651,96 @@ CpStatus_tv CpCoreFifoConfig(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
       if(ptsFifoV != (CpFifo_ts *) 0)
       {
          aptsFifoS[ubBufferIdxV] = ptsFifoV;
+         apfnFifoHandlerS[ubBufferIdxV] = CPP_NULL;
+         #if CP_TRM_PRIORITY > 0
+         CpPrioInit(&atsTrmPrioS[ubBufferIdxV],
+                    &atsTrmPrioEntryS[ubBufferIdxV][0], CP_TRM_PRIORITY);
+         #endif
+      }
+      else
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+   }
+
+   return(tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoDelay()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoDelay(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+                            CpPrioDelay_ts * ptsDelayV)
+{
+   CpStatus_tv tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      if (ptsDelayV == (CpPrioDelay_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
+      else if (aptsFifoS[ubBufferIdxV] == (CpFifo_ts *) 0)
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
       }
       else
+      {
+         #if CP_TRM_PRIORITY > 0
+         memcpy(ptsDelayV, &(atsTrmPrioS[ubBufferIdxV].atsDelay[0]),
+                sizeof(atsTrmPrioS[ubBufferIdxV].atsDelay));
+         #else
+         tvStatusT = eCP_ERR_NOT_SUPPORTED;
+         #endif
+      }
+   }
+
+   return(tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoEvent()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoEvent(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
+                            CpFifoHandler_Fn pfnFifoHandlerV,
+                            uint32_t ulHighMarkV, uint32_t ulLowMarkV,
+                            uint32_t ulTimeoutV)
+{
+   CpStatus_tv tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      if (aptsFifoS[ubBufferIdxV] == (CpFifo_ts *) 0)
       {
          tvStatusT = eCP_ERR_FIFO_PARAM;
       }
+      else if (pfnFifoHandlerV == CPP_NULL)
+      {
+         apfnFifoHandlerS[ubBufferIdxV] = CPP_NULL;
+      }
+      else if ((ulHighMarkV == 0) || (ulHighMarkV <= ulLowMarkV) ||
+               (ulHighMarkV > aptsFifoS[ubBufferIdxV]->ulIndexMax))
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+      else
+      {
+         CpFifoEventInit(&atsFifoEventS[ubBufferIdxV], ulHighMarkV,
+                         ulLowMarkV, ulTimeoutV);
+         apfnFifoHandlerS[ubBufferIdxV] = pfnFifoHandlerV;
+      }
    }
 
    return(tvStatusT);
@@ -635,6 +757,8 @@ CpStatus_tv CpCoreFifoRead(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
 {
    CpFifo_ts * ptsFifoT;
    CpStatus_tv tvStatusT;
+   uint32_t    ulMsgCntT;
+   uint32_t    ulSpanT;
 
    //----------------------------------------------------------------
    // test parameter ptsPortV and ubBufferIdxV
@@ -646,13 +770,57 @@ CpStatus_tv CpCoreFifoRead(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
       {
          if(ptsCanMsgV != (CpCanMsg_ts *) 0L)
          {
-            ptsFifoT = aptsFifoS[ubBufferIdxV];
-            if (CpFifoIsEmpty(ptsFifoT))
+            ptsFifoT  = aptsFifoS[ubBufferIdxV];
+            ulMsgCntT = 0;
+
+            //------------------------------------------------
+            // copy pending messages block-wise, the ring
+            // layout requires at most two blocks
+            //
+            while (ulMsgCntT < *pulBufferSizeV)
             {
-               
+               ulSpanT = CpFifoDataOutSpan(ptsFifoT);
+               if (ulSpanT == 0)
+               {
+                  break;
+               }
+               if (ulSpanT > (*pulBufferSizeV - ulMsgCntT))
+               {
+                  ulSpanT = *pulBufferSizeV - ulMsgCntT;
+               }
+
+               memcpy(ptsCanMsgV, CpFifoDataOutPtr(ptsFifoT),
+                      ulSpanT * sizeof(CpCanMsg_ts));
+               CpFifoAddOut(ptsFifoT, ulSpanT);
+
+               ptsCanMsgV += ulSpanT;
+               ulMsgCntT  += ulSpanT;
+            }
+            *pulBufferSizeV = ulMsgCntT;
+
+            //------------------------------------------------
+            // re-arm the notification
+            //
+            if (apfnFifoHandlerS[ubBufferIdxV] != CPP_NULL)
+            {
+               CpFifoEventOut(&atsFifoEventS[ubBufferIdxV], ptsFifoT,
+                              ulFifoTickS);
             }
+
+            if (ulMsgCntT == 0)
+            {
+               tvStatusT = eCP_ERR_FIFO_EMPTY;
+            }
+         }
+         else
+         {
+            tvStatusT = eCP_ERR_PARAM;
          }
       }
+      else
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
    }
 
    return(tvStatusT);
@@ -673,7 +841,7 @@ CpStatus_tv CpCoreFifoRelease(CpPort_ts * ptsPortV, uint8_t ubBufferIdxV)
    tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
    if (tvStatusT == eCP_ERR_NONE)
    {
-      
+      apfnFifoHandlerS[ubBufferIdxV] = CPP_NULL;
    }
 
    return(tvStatusT);
@@ -688,8 +856,12 @@ CpStatus_tv CpCoreFifoWrite( CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
                              CpCanMsg_ts * ptsCanMsgV,
                              uint32_t * pulBufferSizeV)
 {
+   #if CP_TRM_PRIORITY == 0
    CpFifo_ts * ptsFifoT;
+   uint32_t    ulSpanT;
+   #endif
    CpStatus_tv tvStatusT;
+   uint32_t    ulMsgCntT;
 
    //----------------------------------------------------------------
    // test parameter ptsPortV and ubBufferIdxV
@@ -698,16 +870,88 @@ CpStatus_tv CpCoreFifoWrite( CpPort_ts * ptsPortV, uint8_t ubBufferIdxV,
    if (tvStatusT == eCP_ERR_NONE)
    {
       if(pulBufferSizeV != (uint32_t *) 0L)
-       {
-          if(ptsCanMsgV != (CpCanMsg_ts *) 0L)
-          {
-             ptsFifoT = aptsFifoS[ubBufferIdxV];
-             if (CpFifoIsFull(ptsFifoT))
-             {
-                
-             }
-          }
-       }      
+      {
+         if(ptsCanMsgV != (CpCanMsg_ts *) 0L)
+         {
+            ulMsgCntT = 0;
+
+            #if CP_TRM_PRIORITY > 0
+            //------------------------------------------------
+            // sort messages into the priority ordered
+            // transmit queue
+            //
+            while (ulMsgCntT < *pulBufferSizeV)
+            {
+               if (CpPrioPush(&atsTrmPrioS[ubBufferIdxV], ptsCanMsgV,
+                              ulFifoTickS) == false)
+               {
+                  break;
+               }
+               ptsCanMsgV++;
+               ulMsgCntT++;
+            }
+            #else
+            ptsFifoT  = aptsFifoS[ubBufferIdxV];
+
+            //------------------------------------------------
+            // copy messages block-wise into the transmit FIFO,
+            // the ring layout requires at most two blocks
+            //
+            while (ulMsgCntT < *pulBufferSizeV)
+            {
+               ulSpanT = CpFifoDataInSpan(ptsFifoT);
+               if (ulSpanT == 0)
+               {
+                  break;
+               }
+               if (ulSpanT > (*pulBufferSizeV - ulMsgCntT))
+               {
+                  ulSpanT = *pulBufferSizeV - ulMsgCntT;
+               }
+
+               memcpy(CpFifoDataInPtr(ptsFifoT), ptsCanMsgV,
+                      ulSpanT * sizeof(CpCanMsg_ts));
+               CpFifoAddIn(ptsFifoT, ulSpanT);
+
+               ptsCanMsgV += ulSpanT;
+               ulMsgCntT  += ulSpanT;
+            }
+            #endif
+
+            if (ulMsgCntT < *pulBufferSizeV)
+            {
+               tvStatusT = eCP_ERR_FIFO_FULL;
+            }
+            *pulBufferSizeV = ulMsgCntT;
+
+            #if CP_STATISTIC > 0
+            //------------------------------------------------
+            // update maximum number of pending messages
+            //
+            #if CP_TRM_PRIORITY > 0
+            ulMsgCntT = CpPrioPending(&atsTrmPrioS[ubBufferIdxV]);
+            #else
+            ulMsgCntT = CpFifoPending(ptsFifoT);
+            #endif
+            if (ulMsgCntT > tsStatisticExtS.aulFifoHighWater[ubBufferIdxV])
+            {
+               tsStatisticExtS.aulFifoHighWater[ubBufferIdxV] = ulMsgCntT;
+            }
+            #endif
+
+            //------------------------------------------------
+            // todo: start transmission of first FIFO entry
+            //
+         }
+         else
+         {
+            tvStatusT = eCP_ERR_PARAM;
+         }
+      }
+      else
+      {
+         tvStatusT = eCP_ERR_PARAM;
+      }
    }
 
    return(tvStatusT);
@@ -810,9 +1054,15 @@ CpStatus_tv CpCoreStatistic(CpPort_ts * ptsPortV,
       {
          tvStatusT = eCP_ERR_NONE;
 
+         #if CP_STATISTIC > 0
+         ptsStatsV->ulErrMsgCount = (uint32_t) tsStatisticExtS.uqErrMsgCount;
+         ptsStatsV->ulRcvMsgCount = (uint32_t) tsStatisticExtS.uqRcvMsgCount;
+         ptsStatsV->ulTrmMsgCount = (uint32_t) tsStatisticExtS.uqTrmMsgCount;
+         #else
          ptsStatsV->ulErrMsgCount = 0;
          ptsStatsV->ulRcvMsgCount = 0;
          ptsStatsV->ulTrmMsgCount = 0;
+         #endif
 
       }
       
@@ -822,3 +1072,46 @@ CpStatus_tv CpCoreStatistic(CpPort_ts * ptsPortV,
    return(tvStatusT);
 }
 
+
+//----------------------------------------------------------------------------//
+// CpCoreStatisticExt()                                                       //
+// return extended statistical information                                    //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreStatisticExt(CpPort_ts * ptsPortV,
+                               CpStatisticExt_ts * ptsStatsV)
+{
+   CpStatus_tv tvStatusT = eCP_ERR_CHANNEL;
+
+   //----------------------------------------------------------------
+   // test CAN port
+   //
+   if (ptsPortV != (CpPort_ts *) 0L)
+   {
+      if (ptsPortV->ubDrvInfo > eDRV_INFO_OFF)
+      {
+         if (ptsStatsV == (CpStatisticExt_ts *) 0L)
+         {
+            tvStatusT = eCP_ERR_PARAM;
+         }
+         else
+         {
+            #if CP_STATISTIC > 0
+            //----------------------------------------------
+            // todo: disable CAN interrupts during the copy
+            //
+            memcpy(ptsStatsV, &tsStatisticExtS, sizeof(CpStatisticExt_ts));
+            tvStatusT = eCP_ERR_NONE;
+            #else
+            tvStatusT = eCP_ERR_NOT_SUPPORTED;
+            #endif
+         }
+      }
+      else
+      {
+         tvStatusT = eCP_ERR_INIT_MISSING;
+      }
+   }
+
+   return(tvStatusT);
+}
+
@@ -114,8 +114,10 @@ HEADERS =   qcan_socket.hpp            \
 SOURCES =   qcan_frame.cpp             \
             qcan_network_settings.cpp  \
             qcan_server_settings.cpp   \
+            qcan_signal_database.cpp   \
             qcan_socket.cpp            \
             qcan_timestamp.cpp         \
+            qcan_trace.cpp             \
             qcan_dump.cpp
                
 #---------------------------------------------------------------
@@ -125,6 +125,9 @@ QCanDump::QCanDump(QObject *parent) :
 // constructor and/or to stop any threads
 void QCanDump::aboutToQuitApp()
 {
+    // complete trace file
+    clTraceWriterP.close();
+
     // stop threads
     // sleep(1);   // wait for threads to stop.
     // delete any objects
@@ -185,6 +188,46 @@ void QCanDump::runCmdParser()
          tr("count"));
    clCmdParserP.addOption(clOptCountT);
    
+   //-----------------------------------------------------------
+   // command line option: -d <file>
+   //
+   QCommandLineOption clOptDatabaseT("d", 
+         tr("Decode signals described in DBC <file>"),
+         tr("file"));
+   clCmdParserP.addOption(clOptDatabaseT);
+
+   //-----------------------------------------------------------
+   // command line option: -i <id>
+   //
+   QCommandLineOption clOptIdentifierT("i", 
+         tr("Show only frames with identifier <id> (hex), a suffix 'x' or values above 7FF select extended frames"),
+         tr("id"));
+   clCmdParserP.addOption(clOptIdentifierT);
+
+   //-----------------------------------------------------------
+   // command line option: -r <file>
+   //
+   QCommandLineOption clOptReadT("r", 
+         tr("Read frames from trace <file> instead of CAN interface"),
+         tr("file"));
+   clCmdParserP.addOption(clOptReadT);
+
+   //-----------------------------------------------------------
+   // command line option: -s <sec>
+   //
+   QCommandLineOption clOptStartT("s", 
+         tr("Start at time-stamp <sec> of trace file"),
+         tr("sec"));
+   clCmdParserP.addOption(clOptStartT);
+
+   //-----------------------------------------------------------
+   // command line option: -w <file>
+   //
+   QCommandLineOption clOptWriteT("w", 
+         tr("Write received frames to trace <file>"),
+         tr("file"));
+   clCmdParserP.addOption(clOptWriteT);
+
    //-----------------------------------------------------------
    // command line option: -t 
    //
@@ -206,6 +249,92 @@ void QCanDump::runCmdParser()
    // Process the actual command line arguments given by the user
    //
    clCmdParserP.process(*pclAppP);
+   
+   //----------------------------------------------------------------
+   // check for time-stamp
+   //
+   btTimeStampP = clCmdParserP.isSet(clOptTimeStampT);
+
+   
+   //----------------------------------------------------------------
+   // load signal database
+   //
+   btDecodeSignalsP = clCmdParserP.isSet(clOptDatabaseT);
+   if (btDecodeSignalsP)
+   {
+      if (clSignalDatabaseP.load(clCmdParserP.value(clOptDatabaseT)) == false)
+      {
+         fprintf(stderr, "%s %s: %s\n", 
+                 qPrintable(tr("Error: Failed to load")),
+                 qPrintable(clCmdParserP.value(clOptDatabaseT)),
+                 qPrintable(clSignalDatabaseP.errorString()));
+         emit finished();
+         return;
+      }
+   }
+
+   
+   //----------------------------------------------------------------
+   // check for termination options
+   //
+   btQuitNeverP = true;
+   ulQuitCountP = clCmdParserP.value(clOptCountT).toInt(Q_NULLPTR, 10);    
+   ulQuitTimeP  = clCmdParserP.value(clOptTimeOutT).toInt(Q_NULLPTR, 10);      
+   if ((ulQuitCountP > 0) || (ulQuitTimeP > 0))
+   {
+      btQuitNeverP = false; 
+   }
+   
+   
+   //----------------------------------------------------------------
+   // check for identifier filter
+   //
+   btFilterP = clCmdParserP.isSet(clOptIdentifierT);
+   if (btFilterP)
+   {
+      QString  clFilterT = clCmdParserP.value(clOptIdentifierT);
+      bool     btValidT;
+
+      btFilterExtP = clFilterT.endsWith('x', Qt::CaseInsensitive);
+      if (btFilterExtP)
+      {
+         clFilterT.chop(1);
+      }
+      ulFilterIdP  = clFilterT.toUInt(&btValidT, 16);
+      btFilterExtP = btFilterExtP || (ulFilterIdP > 0x7FF);
+
+      if ((btValidT == false) || (ulFilterIdP > 0x1FFFFFFF))
+      {
+         fprintf(stderr, "%s %s\n",
+                 qPrintable(tr("Error: Invalid identifier")),
+                 qPrintable(clCmdParserP.value(clOptIdentifierT)));
+         emit finished();
+         return;
+      }
+   }
+
+
+   //----------------------------------------------------------------
+   // offline mode: show frames of trace file
+   //
+   if (clCmdParserP.isSet(clOptReadT))
+   {
+      QCanTimeStamp clStartT;
+      if (clCmdParserP.isSet(clOptStartT))
+      {
+         double dStartT = clCmdParserP.value(clOptStartT).toDouble();
+         clStartT.setSeconds((uint32_t) dStartT);
+         clStartT.setNanoSeconds((uint32_t) ((dStartT - (uint32_t) dStartT) * 1000000000.0));
+      }
+      readTrace(clCmdParserP.value(clOptReadT), clStartT);
+      emit finished();
+      return;
+   }
+
+
+   //----------------------------------------------------------------
+   // argument <interface> is required for reception
+   //
    const QStringList clArgsT = clCmdParserP.positionalArguments();
    if (clArgsT.size() != 1) 
    {
@@ -248,32 +377,31 @@ void QCanDump::runCmdParser()
 
    
    //----------------------------------------------------------------
-   // check for time-stamp
-   //
-   btTimeStampP = clCmdParserP.isSet(clOptTimeStampT);
-
-   
-   //----------------------------------------------------------------
-   // check for termination options
+   // set host address for socket
    //
-   btQuitNeverP = true;
-   ulQuitCountP = clCmdParserP.value(clOptCountT).toInt(Q_NULLPTR, 10);    
-   ulQuitTimeP  = clCmdParserP.value(clOptTimeOutT).toInt(Q_NULLPTR, 10);      
-   if ((ulQuitCountP > 0) || (ulQuitTimeP > 0))
+   if(clCmdParserP.isSet(clOptHostT))
    {
-      btQuitNeverP = false; 
+      QHostAddress clAddressT = QHostAddress(clCmdParserP.value(clOptHostT));
+      clCanSocketP.setHostAddress(clAddressT);
    }
    
-   
    //----------------------------------------------------------------
-   // set host address for socket
+   // write frames to trace file
    //
-   if(clCmdParserP.isSet(clOptHostT))
+   if (clCmdParserP.isSet(clOptWriteT))
    {
-      QHostAddress clAddressT = QHostAddress(clCmdParserP.value(clOptHostT));
-      clCanSocketP.setHostAddress(clAddressT);
+      if (clTraceWriterP.open(clCmdParserP.value(clOptWriteT)) == false)
+      {
+         fprintf(stderr, "%s %s: %s\n", 
+                 qPrintable(tr("Error: Failed to create")),
+                 qPrintable(clCmdParserP.value(clOptWriteT)),
+                 qPrintable(clTraceWriterP.errorString()));
+         emit finished();
+         return;
+      }
    }
    
+
    //----------------------------------------------------------------
    // connect to CAN interface
    //
@@ -341,22 +469,37 @@ void QCanDump::socketError(QAbstractSocket::SocketError teSocketErrorV)
 //----------------------------------------------------------------------------//
 void QCanDump::socketReceive(uint32_t ulFrameCntV)
 {
-   QCanFrame      clCanFrameT;
-   QString        clCanStringT;
-   
+   Q_UNUSED(ulFrameCntV);
+
+   int32_t        slFrameIdxT;
+
    if ((btQuitNeverP == false) && (ulQuitTimeP > 0))
    {
       clActivityTimerP.start(ulQuitTimeP);
    }
-   
-   while(ulFrameCntV)
+
+   //----------------------------------------------------------------
+   // all available frames are read with a single call, the list
+   // keeps its capacity for the next call
+   //
+   clFrameListP.clear();
+   clCanSocketP.readFrames(clFrameListP);
+
+   for (slFrameIdxT = 0; slFrameIdxT < clFrameListP.size(); slFrameIdxT++)
    {
-      if (clCanSocketP.read(clCanFrameT) == true)
+      QCanFrame & clCanFrameT = clFrameListP[slFrameIdxT];
+
+      if (clTraceWriterP.isOpen())
       {
-         clCanStringT = clCanFrameT.toString(btTimeStampP);
-         fprintf(stderr, "%s\n", qPrintable(clCanStringT));
+         clTraceWriterP.write(clCanFrameT);
       }
-      ulFrameCntV--;
+
+      if ((btFilterP == false) ||
+          ((clCanFrameT.identifier() == ulFilterIdP) && (clCanFrameT.isExtended() == btFilterExtP)))
+      {
+         showFrame(clCanFrameT);
+      }
+
       ulQuitCountP--;
       if(ulQuitCountP == 0)
       {
@@ -366,10 +509,78 @@ void QCanDump::socketReceive(uint32_t ulFrameCntV)
 }
 
 
+//----------------------------------------------------------------------------//
+// readTrace()                                                                //
+// show messages of trace file                                                //
+//----------------------------------------------------------------------------//
+void QCanDump::readTrace(const QString & clFileNameR, const QCanTimeStamp & clStartR)
+{
+   QCanTraceReader   clTraceT;
+   QCanFrame         clCanFrameT;
+   uint64_t          uqIndexT;
+
+   if (clTraceT.open(clFileNameR) == false)
+   {
+      fprintf(stderr, "%s %s: %s\n", 
+              qPrintable(tr("Error: Failed to open")),
+              qPrintable(clFileNameR),
+              qPrintable(clTraceT.errorString()));
+      return;
+   }
+
+   //----------------------------------------------------------------
+   // the index of the trace file is used to find the first frame
+   // and the frames of the identifier filter
+   //
+   uqIndexT = clTraceT.seekTime(clStartR);
+   if (btFilterP)
+   {
+      uqIndexT = clTraceT.findIdentifier(uqIndexT, ulFilterIdP, btFilterExtP);
+   }
+
+   while (clTraceT.frame(uqIndexT, clCanFrameT) == true)
+   {
+      showFrame(clCanFrameT);
 
+      if (ulQuitCountP > 0)
+      {
+         ulQuitCountP--;
+         if (ulQuitCountP == 0)
+         {
+            break;
+         }
+      }
 
+      uqIndexT++;
+      if (btFilterP)
+      {
+         uqIndexT = clTraceT.findIdentifier(uqIndexT, ulFilterIdP, btFilterExtP);
+      }
+   }
+}
 
 
+//----------------------------------------------------------------------------//
+// showFrame()                                                                //
+// show message and its decoded signals                                       //
+//----------------------------------------------------------------------------//
+void QCanDump::showFrame(QCanFrame & clCanFrameR)
+{
+   QString  clCanStringT;
 
+   clCanStringT = clCanFrameR.toString(btTimeStampP);
+   fprintf(stderr, "%s\n", qPrintable(clCanStringT));
 
+   //----------------------------------------------------------------
+   // show decoded signals below the frame
+   //
+   if (btDecodeSignalsP)
+   {
+      clCanStringT = clSignalDatabaseP.toString(clCanFrameR);
+      if (clCanStringT.isEmpty() == false)
+      {
+         fprintf(stderr, "   %s\n", qPrintable(clCanStringT));
+      }
+   }
+}
 
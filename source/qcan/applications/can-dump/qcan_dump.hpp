@@ -30,7 +30,10 @@
 #include <QtCore/QCommandlineParser>
 #include <QtCore/QTimer>
 
+#include <QCanSignalDatabase>
 #include <QCanSocket>
+#include <QCanTraceReader>
+#include <QCanTraceWriter>
 
 //-----------------------------------------------------------------------------
 /*!
@@ -69,11 +72,23 @@ public slots:
    
 private:
 
+   void  readTrace(const QString & clFileNameR, const QCanTimeStamp & clStartR);
+   void  showFrame(QCanFrame & clCanFrameR);
+
    QCoreApplication *   pclAppP;
 
    QCommandLineParser   clCmdParserP;
    QCanSocket           clCanSocketP;
    uint8_t              ubChannelP;
+   QVector<QCanFrame>   clFrameListP;
+
+   QCanSignalDatabase   clSignalDatabaseP;
+   bool                 btDecodeSignalsP;
+
+   QCanTraceWriter      clTraceWriterP;
+   bool                 btFilterP;
+   bool                 btFilterExtP;
+   uint32_t             ulFilterIdP;
    
    QTimer               clActivityTimerP;
    bool                 btTimeStampP;
@@ -33,6 +33,12 @@
 #include <QtCore/QTimer>
 
 
+//----------------------------------------------------------------------------//
+// number of frames which are written with a single call                      //
+//----------------------------------------------------------------------------//
+#define  QCAN_SEND_BLOCK_SIZE    64
+
+
 //----------------------------------------------------------------------------//
 // main()                                                                     //
 //                                                                            //
@@ -91,6 +97,7 @@ QCanSend::QCanSend(QObject *parent) :
    pclAppP = QCoreApplication::instance();
 
    ubChannelP = eCAN_CHANNEL_NONE;
+   ulCyclePeriodP = 0;
    
    //----------------------------------------------------------------
    // connect signals for socket operations
@@ -148,6 +155,15 @@ void QCanSend::runCmdParser(void)
    clCmdParserP.addPositionalArgument("interface", 
                                       tr("CAN interface, e.g. can1"));
 
+   //-----------------------------------------------------------
+   // command line option: -c <msec>
+   //
+   QCommandLineOption clOptCycleT("c", 
+         tr("Transmit CAN frame by the server with a period of <msec> milli-seconds"),
+         tr("msec"),
+         "0");          // default value
+   clCmdParserP.addOption(clOptCycleT);
+   
    //-----------------------------------------------------------
    // command line option: -D <dlc>
    //
@@ -337,6 +353,11 @@ void QCanSend::runCmdParser(void)
    //
    ulFrameGapP = clCmdParserP.value(clOptGapT).toInt(Q_NULLPTR, 10);
    
+   //----------------------------------------------------------------
+   // get period for cyclic transmission
+   //
+   ulCyclePeriodP = clCmdParserP.value(clOptCycleT).toInt(Q_NULLPTR, 10);
+   
    //----------------------------------------------------------------
    // get increment type
    //
@@ -371,90 +392,120 @@ void QCanSend::sendFrame(void)
    
    clSystemTimeT = QTime::currentTime();
    clCanTimeT.fromMilliSeconds(clSystemTimeT.msec());
-   clCanFrameP.setTimeStamp(clCanTimeT);
-   
-   clCanSocketP.write(clCanFrameP);
-   
-   if (ulFrameCountP > 1)
+
+   //----------------------------------------------------------------
+   // without a time gap the frames are written in blocks of
+   // QCAN_SEND_BLOCK_SIZE frames with a single call
+   //
+   clFrameListP.clear();
+   for (;;)
    {
+      clCanFrameP.setTimeStamp(clCanTimeT);
+      clFrameListP.append(clCanFrameP);
+
+      if (ulFrameCountP <= 1)
+      {
+         ulFrameCountP = 0;
+         break;
+      }
+
       ulFrameCountP--;
-      
-      //--------------------------------------------------------
-      // test if identifier value must be incemented
+      nextFrame();
+
+      if ((ulFrameGapP > 0) || (clFrameListP.size() >= QCAN_SEND_BLOCK_SIZE))
+      {
+         break;
+      }
+   }
+
+   clCanSocketP.writeFrames(clFrameListP);
+
+   if (ulFrameCountP > 0)
+   {
+      QTimer::singleShot(ulFrameGapP, this, SLOT(sendFrame()));
+   }
+   else
+   {
+      QTimer::singleShot(50, this, SLOT(quit()));
+   }
+
+}
+
+
+//----------------------------------------------------------------------------//
+// nextFrame()                                                                //
+// increment identifier, DLC and data of the frame                            //
+//----------------------------------------------------------------------------//
+void QCanSend::nextFrame(void)
+{
+   //--------------------------------------------------------
+   // test if identifier value must be incemented
+   //
+   if (btIncIdP)
+   {
+      ulFrameIdP++;
+
+      //------------------------------------------------
+      // test for wrap-around
       //
-      if (btIncIdP)
+      if (clCanFrameP.isExtended())
       {
-         ulFrameIdP++;
-         
-         //------------------------------------------------
-         // test for wrap-around
-         //
-         if (clCanFrameP.isExtended())
+         if (ulFrameIdP > QCAN_FRAME_ID_MASK_EXT)
          {
-            if (ulFrameIdP > QCAN_FRAME_ID_MASK_EXT)
-            {
-               ulFrameIdP = 0;
-            }
+            ulFrameIdP = 0;
          }
-         else
+      }
+      else
+      {
+         if (ulFrameIdP > QCAN_FRAME_ID_MASK_STD)
          {
-            if (ulFrameIdP > QCAN_FRAME_ID_MASK_STD)
-            {
-               ulFrameIdP = 0;
-            }
+            ulFrameIdP = 0;
          }
-         
-         //------------------------------------------------
-         // set new identifier value
-         //
-         clCanFrameP.setIdentifier(ulFrameIdP);
       }
-      
-      //--------------------------------------------------------
-      // test if DLC value must be incemented
+
+      //------------------------------------------------
+      // set new identifier value
       //
-      if (btIncDlcP)
+      clCanFrameP.setIdentifier(ulFrameIdP);
+   }
+
+   //--------------------------------------------------------
+   // test if DLC value must be incemented
+   //
+   if (btIncDlcP)
+   {
+      ubFrameDlcP++;
+
+      //------------------------------------------------
+      // test for wrap-around
+      //
+      if (clCanFrameP.frameFormat() > QCanFrame::eFORMAT_CAN_EXT)
       {
-         ubFrameDlcP++;
-         
-         //------------------------------------------------
-         // test for wrap-around
-         //
-         if (clCanFrameP.frameFormat() > QCanFrame::eFORMAT_CAN_EXT)
+         if (ubFrameDlcP > 15)
          {
-            if (ubFrameDlcP > 15)
-            {
-               ubFrameDlcP = 0;
-            }
+            ubFrameDlcP = 0;
          }
-         else
+      }
+      else
+      {
+         if (ubFrameDlcP > 8)
          {
-            if (ubFrameDlcP > 8)
-            {
-               ubFrameDlcP = 0;
-            }
+            ubFrameDlcP = 0;
          }
-         //------------------------------------------------
-         // set new DLC value
-         //
-         clCanFrameP.setDlc(ubFrameDlcP);
-      }  
-      
-      //--------------------------------------------------------
-      // test if data value must be incemented
-      //
-      if (btIncDataP)
-      {
-         clCanFrameP.setDataUInt32(0, clCanFrameP.dataUInt32(0) + 1);
       }
-      
-      QTimer::singleShot(ulFrameGapP, this, SLOT(sendFrame()));
+      //------------------------------------------------
+      // set new DLC value
+      //
+      clCanFrameP.setDlc(ubFrameDlcP);
    }
-   else
+
+   //--------------------------------------------------------
+   // test if data value must be incemented
+   //
+   if (btIncDataP)
    {
-      QTimer::singleShot(50, this, SLOT(quit()));
+      clCanFrameP.setDataUInt32(0, clCanFrameP.dataUInt32(0) + 1);
    }
-
 }
 
 
@@ -474,6 +525,30 @@ void QCanSend::socketConnected()
    {
       clCanFrameP.setData(ubCntT, aubFrameDataP[ubCntT]);
    }
+
+   //----------------------------------------------------------------
+   // a cyclic frame is transmitted by the scheduler of the server,
+   // an increment of the payload is done by the payload counter, it
+   // stops when the socket is disconnected
+   //
+   if (ulCyclePeriodP > 0)
+   {
+      uint8_t ubCounterSizeT = 0;
+
+      if (btIncDataP)
+      {
+         ubCounterSizeT = qMin(clCanFrameP.dataSize(), (uint8_t) 4);
+      }
+
+      if (clCanSocketP.setCyclicFrame(1, clCanFrameP, ulCyclePeriodP * 1000, 0, ubCounterSizeT) == false)
+      {
+         fprintf(stderr, "%s \n", qPrintable(tr("Error: Cyclic frame not accepted")));
+         QTimer::singleShot(50, this, SLOT(quit()));
+         return;
+      }
+      QTimer::singleShot(ulFrameCountP * ulCyclePeriodP, this, SLOT(quit()));
+      return;
+   }
     
    QTimer::singleShot(10, this, SLOT(sendFrame()));
 }
@@ -54,6 +54,8 @@ public slots:
    
 private:
 
+   void  nextFrame(void);
+
    QCoreApplication *   pclAppP;
 
    QCommandLineParser   clCmdParserP;
@@ -61,8 +63,10 @@ private:
    uint8_t              ubChannelP;
    
    QCanFrame            clCanFrameP;
+   QVector<QCanFrame>   clFrameListP;
    uint32_t             ulFrameIdP;
    uint32_t             ulFrameGapP;
+   uint32_t             ulCyclePeriodP;
    uint8_t              ubFrameDlcP;
    uint8_t              ubFrameFormatP;
    uint8_t              aubFrameDataP[QCAN_MSG_DATA_MAX];
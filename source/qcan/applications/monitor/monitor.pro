@@ -103,6 +103,7 @@ VPATH += ./../../../canpie-fd
 #
 HEADERS =   qcan_socket.hpp            \
             qcan_socket_dialog.hpp     \
+            monitor_trace_model.hpp    \
             monitor_window.hpp
 
                 
@@ -118,6 +119,7 @@ SOURCES =   qcan_data.cpp              \
             qcan_socket_dialog.cpp     \
             qcan_timestamp.cpp         \
             monitor_main.cpp           \
+            monitor_trace_model.cpp    \
             monitor_window.cpp
 
 #---------------------------------------------------------------
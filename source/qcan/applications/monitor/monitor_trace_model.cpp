@@ -0,0 +1,478 @@
+#include "monitor_trace_model.hpp"
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// MonitorTraceModel()                                                                                                //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+MonitorTraceModel::MonitorTraceModel(QObject * pclParentV, int32_t slCapacityV)
+   : QAbstractTableModel(pclParentV)
+{
+   if (slCapacityV < 1)
+   {
+      slCapacityV = 1;
+   }
+
+   slCapacityP        = slCapacityV;
+   slTraceStartP      = 0;
+   slTraceCountP      = 0;
+   slOverwrittenP     = 0;
+   slFixedDirtyFirstP = -1;
+   slFixedDirtyLastP  = -1;
+   slRowCountP        = 0;
+   btFixedModeP       = false;
+
+   //----------------------------------------------------------------
+   // the ring buffer is allocated once, frames are copied into
+   // existing objects afterwards
+   //
+   aclTraceP.resize(slCapacityP);
+
+   connect(&clUpdateTimerP, SIGNAL(timeout()), this, SLOT(onUpdate()));
+   clUpdateTimerP.start(MONITOR_TRACE_UPDATE_INTERVAL);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// appendFrame()                                                                                                      //
+// store frame, the view is not notified here                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+void MonitorTraceModel::appendFrame(const QCanFrame & clFrameR)
+{
+   int32_t  slRowT;
+   uint32_t ulKeyT;
+
+   //----------------------------------------------------------------
+   // trace: overwrite the oldest frame if the buffer is full
+   //
+   if (slTraceCountP < slCapacityP)
+   {
+      aclTraceP[(slTraceStartP + slTraceCountP) % slCapacityP] = clFrameR;
+      slTraceCountP++;
+   }
+   else
+   {
+      aclTraceP[slTraceStartP] = clFrameR;
+      slTraceStartP = (slTraceStartP + 1) % slCapacityP;
+      slOverwrittenP++;
+   }
+
+   //----------------------------------------------------------------
+   // fixed: update the entry of the identifier, all error frames
+   // share one entry
+   //
+   if (clFrameR.frameType() == QCanFrame::eFRAME_TYPE_ERROR)
+   {
+      ulKeyT = 0xFFFFFFFF;
+   }
+   else
+   {
+      ulKeyT = clFrameR.identifier();
+      if (clFrameR.isExtended())
+      {
+         ulKeyT |= 0x80000000;
+      }
+   }
+
+   slRowT = clFixedRowP.value(ulKeyT, -1);
+   if (slRowT < 0)
+   {
+      FixedEntry_s tsEntryT;
+      tsEntryT.clFrame = clFrameR;
+      tsEntryT.ulCount = 1;
+      clFixedRowP.insert(ulKeyT, atsFixedP.size());
+      atsFixedP.append(tsEntryT);
+   }
+   else
+   {
+      FixedEntry_s & tsEntryR = atsFixedP[slRowT];
+      tsEntryR.clPeriod = clFrameR.timeStamp() - tsEntryR.clFrame.timeStamp();
+      tsEntryR.clFrame  = clFrameR;
+      tsEntryR.ulCount++;
+
+      if ((slFixedDirtyFirstP < 0) || (slRowT < slFixedDirtyFirstP))
+      {
+         slFixedDirtyFirstP = slRowT;
+      }
+      if (slRowT > slFixedDirtyLastP)
+      {
+         slFixedDirtyLastP = slRowT;
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// clear()                                                                                                            //
+// remove all frames                                                                                                  //
+//--------------------------------------------------------------------------------------------------------------------//
+void MonitorTraceModel::clear(void)
+{
+   beginResetModel();
+   slTraceStartP      = 0;
+   slTraceCountP      = 0;
+   slOverwrittenP     = 0;
+   slFixedDirtyFirstP = -1;
+   slFixedDirtyLastP  = -1;
+   slRowCountP        = 0;
+   atsFixedP.clear();
+   clFixedRowP.clear();
+   endResetModel();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// columnCount()                                                                                                      //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+int MonitorTraceModel::columnCount(const QModelIndex & clParentR) const
+{
+   if (clParentR.isValid())
+   {
+      return 0;
+   }
+
+   if (btFixedModeP)
+   {
+      return eCOLUMN_MAX;
+   }
+
+   return (eCOLUMN_DATA + 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// data()                                                                                                             //
+// the text is generated only for the cells requested by the view                                                     //
+//--------------------------------------------------------------------------------------------------------------------//
+QVariant MonitorTraceModel::data(const QModelIndex & clIndexR, int slRoleV) const
+{
+   const QCanFrame *       pclFrameT;
+   const FixedEntry_s *    ptsEntryT = Q_NULLPTR;
+   int32_t                 slRowT    = clIndexR.row();
+
+   if ((slRoleV != Qt::DisplayRole) || (slRowT < 0) || (slRowT >= slRowCountP))
+   {
+      return QVariant();
+   }
+
+   if (btFixedModeP)
+   {
+      ptsEntryT = &atsFixedP.at(slRowT);
+      pclFrameT = &ptsEntryT->clFrame;
+   }
+   else
+   {
+      pclFrameT = &aclTraceP.at((slTraceStartP + slRowT) % slCapacityP);
+   }
+
+   switch (clIndexR.column())
+   {
+      case eCOLUMN_TIME:
+         return timeStamp(pclFrameT->timeStamp());
+
+      case eCOLUMN_IDENTIFIER:
+         if (pclFrameT->frameType() == QCanFrame::eFRAME_TYPE_ERROR)
+         {
+            return QVariant();
+         }
+         if (pclFrameT->isExtended())
+         {
+            return QString("%1").arg(pclFrameT->identifier(), 8, 16, QChar('0')).toUpper();
+         }
+         return QString("%1").arg(pclFrameT->identifier(), 3, 16, QChar('0')).toUpper();
+
+      case eCOLUMN_FORMAT:
+         return frameFormat(*pclFrameT);
+
+      case eCOLUMN_DLC:
+         if (pclFrameT->frameType() == QCanFrame::eFRAME_TYPE_ERROR)
+         {
+            return QVariant();
+         }
+         return pclFrameT->dlc();
+
+      case eCOLUMN_DATA:
+         return frameData(*pclFrameT);
+
+      case eCOLUMN_COUNT:
+         if (ptsEntryT != Q_NULLPTR)
+         {
+            return ptsEntryT->ulCount;
+         }
+         break;
+
+      case eCOLUMN_PERIOD:
+         if ((ptsEntryT != Q_NULLPTR) && (ptsEntryT->ulCount > 1))
+         {
+            return QString("%1 ms").arg(((double) ptsEntryT->clPeriod.seconds() * 1000.0) +
+                                        ((double) ptsEntryT->clPeriod.nanoSeconds() / 1000000.0),
+                                        0, 'f', 3);
+         }
+         break;
+
+      default:
+         break;
+   }
+
+   return QVariant();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// frameData()                                                                                                        //
+// data bytes in hex format                                                                                           //
+//--------------------------------------------------------------------------------------------------------------------//
+QString MonitorTraceModel::frameData(const QCanFrame & clFrameR) const
+{
+   static const char aszHexT[] = "0123456789ABCDEF";
+   QString           clDataT;
+   uint8_t           ubDataSizeT;
+   uint8_t           ubValueT;
+
+   if (clFrameR.frameType() == QCanFrame::eFRAME_TYPE_ERROR)
+   {
+      QCanFrame clFrameT(clFrameR);
+      return clFrameT.toString();
+   }
+
+   ubDataSizeT = clFrameR.dataSize();
+   if (clFrameR.isRemote())
+   {
+      ubDataSizeT = 0;
+   }
+
+   clDataT.reserve(ubDataSizeT * 3);
+   for (uint8_t ubCntT = 0; ubCntT < ubDataSizeT; ubCntT++)
+   {
+      ubValueT = clFrameR.data(ubCntT);
+      clDataT += QLatin1Char(aszHexT[ubValueT >> 4]);
+      clDataT += QLatin1Char(aszHexT[ubValueT & 0x0F]);
+      clDataT += QLatin1Char(' ');
+   }
+
+   return clDataT;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// frameFormat()                                                                                                      //
+// frame format and flags                                                                                             //
+//--------------------------------------------------------------------------------------------------------------------//
+QString MonitorTraceModel::frameFormat(const QCanFrame & clFrameR) const
+{
+   QString clFormatT;
+
+   if (clFrameR.frameType() == QCanFrame::eFRAME_TYPE_ERROR)
+   {
+      return QString("Error");
+   }
+
+   switch (clFrameR.frameFormat())
+   {
+      case QCanFrame::eFORMAT_CAN_STD:
+         clFormatT = "CBFF";
+         break;
+
+      case QCanFrame::eFORMAT_CAN_EXT:
+         clFormatT = "CEFF";
+         break;
+
+      case QCanFrame::eFORMAT_FD_STD:
+         clFormatT = "FBFF";
+         break;
+
+      case QCanFrame::eFORMAT_FD_EXT:
+         clFormatT = "FEFF";
+         break;
+
+      default:
+         break;
+   }
+
+   if (clFrameR.bitrateSwitch())
+   {
+      clFormatT += " BRS";
+   }
+
+   if (clFrameR.errorStateIndicator())
+   {
+      clFormatT += " ESI";
+   }
+
+   if (clFrameR.isRemote())
+   {
+      clFormatT += " RTR";
+   }
+
+   return clFormatT;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// headerData()                                                                                                       //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+QVariant MonitorTraceModel::headerData(int slSectionV, Qt::Orientation teOrientationV, int slRoleV) const
+{
+   if ((slRoleV != Qt::DisplayRole) || (teOrientationV != Qt::Horizontal))
+   {
+      return QVariant();
+   }
+
+   switch (slSectionV)
+   {
+      case eCOLUMN_TIME:
+         return tr("Time");
+
+      case eCOLUMN_IDENTIFIER:
+         return tr("Identifier");
+
+      case eCOLUMN_FORMAT:
+         return tr("Format");
+
+      case eCOLUMN_DLC:
+         return tr("DLC");
+
+      case eCOLUMN_DATA:
+         return tr("Data");
+
+      case eCOLUMN_COUNT:
+         return tr("Count");
+
+      case eCOLUMN_PERIOD:
+         return tr("Period");
+
+      default:
+         break;
+   }
+
+   return QVariant();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// onUpdate()                                                                                                         //
+// pass all changes since the last update to the view                                                                 //
+//--------------------------------------------------------------------------------------------------------------------//
+void MonitorTraceModel::onUpdate(void)
+{
+   int32_t  slRowsT;
+   bool     btAppendedT = false;
+
+   if (btFixedModeP)
+   {
+      //--------------------------------------------------------
+      // rows of known identifiers only change their contents,
+      // rows appended since the last update are not known to the
+      // view yet and are passed by the insertion below
+      //
+      if (slFixedDirtyLastP >= slRowCountP)
+      {
+         slFixedDirtyLastP = slRowCountP - 1;
+      }
+      if ((slFixedDirtyFirstP >= 0) && (slFixedDirtyFirstP <= slFixedDirtyLastP))
+      {
+         emit dataChanged(index(slFixedDirtyFirstP, 0),
+                          index(slFixedDirtyLastP, eCOLUMN_MAX - 1));
+      }
+
+      slRowsT = atsFixedP.size();
+      if (slRowsT > slRowCountP)
+      {
+         beginInsertRows(QModelIndex(), slRowCountP, slRowsT - 1);
+         slRowCountP = slRowsT;
+         endInsertRows();
+         btAppendedT = true;
+      }
+   }
+   else
+   {
+      //--------------------------------------------------------
+      // overwritten frames disappear at the top of the view
+      //
+      if (slOverwrittenP > 0)
+      {
+         if (slOverwrittenP >= slRowCountP)
+         {
+            beginResetModel();
+            slRowCountP = slTraceCountP;
+            endResetModel();
+            btAppendedT = true;
+         }
+         else
+         {
+            beginRemoveRows(QModelIndex(), 0, slOverwrittenP - 1);
+            slRowCountP -= slOverwrittenP;
+            endRemoveRows();
+         }
+      }
+
+      if (slTraceCountP > slRowCountP)
+      {
+         beginInsertRows(QModelIndex(), slRowCountP, slTraceCountP - 1);
+         slRowCountP = slTraceCountP;
+         endInsertRows();
+         btAppendedT = true;
+      }
+   }
+
+   slOverwrittenP     = 0;
+   slFixedDirtyFirstP = -1;
+   slFixedDirtyLastP  = -1;
+
+   if (btAppendedT)
+   {
+      emit rowsAppended();
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// rowCount()                                                                                                         //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+int MonitorTraceModel::rowCount(const QModelIndex & clParentR) const
+{
+   if (clParentR.isValid())
+   {
+      return 0;
+   }
+
+   return slRowCountP;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// setFixedMode()                                                                                                     //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void MonitorTraceModel::setFixedMode(bool btFixedV)
+{
+   if (btFixedV != btFixedModeP)
+   {
+      beginResetModel();
+      btFixedModeP   = btFixedV;
+      slOverwrittenP = 0;
+      if (btFixedModeP)
+      {
+         slRowCountP = atsFixedP.size();
+      }
+      else
+      {
+         slRowCountP = slTraceCountP;
+      }
+      endResetModel();
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// timeStamp()                                                                                                        //
+// time stamp with a resolution of 10 microseconds                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+QString MonitorTraceModel::timeStamp(const QCanTimeStamp & clTimeR) const
+{
+   return QString("%1.%2").arg(clTimeR.seconds(), 5, 10)
+                          .arg(clTimeR.nanoSeconds() / 10000, 5, 10, QChar('0'));
+}
@@ -0,0 +1,130 @@
+#ifndef MONITOR_TRACE_MODEL_HPP_
+#define MONITOR_TRACE_MODEL_HPP_
+
+
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QHash>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include "qcan_frame.hpp"
+
+
+//-------------------------------------------------------------------
+// default number of CAN frames kept by the trace
+//
+#define  MONITOR_TRACE_CAPACITY        100000
+
+//-------------------------------------------------------------------
+// interval for model updates in milliseconds, the view is not
+// refreshed faster than the display anyway
+//
+#define  MONITOR_TRACE_UPDATE_INTERVAL 40
+
+
+//-----------------------------------------------------------------------------------------------------------
+/*!
+** \class   MonitorTraceModel
+**
+** The model holds the received CAN frames in a ring buffer of fixed capacity. When the buffer is full,
+** the oldest frame is overwritten. New frames are announced to the view in batches, text is only
+** generated for the rows the view requests.
+**
+** In fixed mode the model shows one row per identifier with the number of received frames, the
+** period between the last two frames and the last data.
+*/
+class MonitorTraceModel : public QAbstractTableModel
+{
+   Q_OBJECT
+
+public:
+
+   enum Column_e {
+      eCOLUMN_TIME = 0,
+      eCOLUMN_IDENTIFIER,
+      eCOLUMN_FORMAT,
+      eCOLUMN_DLC,
+      eCOLUMN_DATA,
+      eCOLUMN_COUNT,
+      eCOLUMN_PERIOD,
+
+      eCOLUMN_MAX
+   };
+
+   MonitorTraceModel(QObject * pclParentV = Q_NULLPTR,
+                     int32_t slCapacityV = MONITOR_TRACE_CAPACITY);
+
+   /*!
+   ** Add CAN frame to the trace, the view is updated with the next batch.
+   */
+   void     appendFrame(const QCanFrame & clFrameR);
+
+   /*!
+   ** Remove all CAN frames.
+   */
+   void     clear(void);
+
+   /*!
+   ** \return  \c true if the model shows one row per identifier
+   */
+   inline bool isFixedMode(void) const { return btFixedModeP; };
+
+   /*!
+   ** Select fixed mode (one row per identifier) or trace mode.
+   */
+   void     setFixedMode(bool btFixedV);
+
+   int      columnCount(const QModelIndex & clParentR = QModelIndex()) const Q_DECL_OVERRIDE;
+   QVariant data(const QModelIndex & clIndexR, int slRoleV = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+   QVariant headerData(int slSectionV, Qt::Orientation teOrientationV,
+                       int slRoleV = Qt::DisplayRole) const Q_DECL_OVERRIDE;
+   int      rowCount(const QModelIndex & clParentR = QModelIndex()) const Q_DECL_OVERRIDE;
+
+signals:
+   /*!
+   ** Emitted after a batch of new rows has been passed to the view.
+   */
+   void     rowsAppended(void);
+
+private slots:
+   void     onUpdate(void);
+
+private:
+
+   struct FixedEntry_s {
+      QCanFrame      clFrame;
+      QCanTimeStamp  clPeriod;
+      uint32_t       ulCount;
+   };
+
+   QString  frameData(const QCanFrame & clFrameR) const;
+   QString  frameFormat(const QCanFrame & clFrameR) const;
+   QString  timeStamp(const QCanTimeStamp & clTimeR) const;
+
+   //----------------------------------------------------------------
+   // trace mode: ring buffer, row 0 is the oldest frame
+   //
+   QVector<QCanFrame>      aclTraceP;
+   int32_t                 slCapacityP;
+   int32_t                 slTraceStartP;
+   int32_t                 slTraceCountP;
+   int32_t                 slOverwrittenP;
+
+   //----------------------------------------------------------------
+   // fixed mode: one entry per identifier, the key contains the
+   // identifier and the frame format
+   //
+   QVector<FixedEntry_s>   atsFixedP;
+   QHash<uint32_t, int32_t> clFixedRowP;
+   int32_t                 slFixedDirtyFirstP;
+   int32_t                 slFixedDirtyLastP;
+
+   //----------------------------------------------------------------
+   // number of rows known by the view
+   //
+   int32_t                 slRowCountP;
+   bool                    btFixedModeP;
+   QTimer                  clUpdateTimerP;
+};
+
+#endif // MONITOR_TRACE_MODEL_HPP_
@@ -1,6 +1,8 @@
 #include "monitor_window.hpp"
 #include "qcan_socket_dialog.hpp"
 
+#include <QHeaderView>
+
 MonitorWindow::MonitorWindow(QWidget *parent)
     : QMainWindow(parent)
 {
@@ -27,6 +29,23 @@ MonitorWindow::MonitorWindow(QWidget *parent)
 
    connect( ui.actionConnect, SIGNAL(triggered(bool)),
             this, SLOT(onSocketConnect(bool)));
+
+   //----------------------------------------------------------------
+   // the trace view only requests the visible rows from the model,
+   // a fixed row height avoids measuring each row
+   //
+   pclTraceModelP = new MonitorTraceModel(this);
+   ui.pclCanTraceP->setModel(pclTraceModelP);
+   ui.pclCanTraceP->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+   ui.pclCanTraceP->verticalHeader()->setDefaultSectionSize(ui.pclCanTraceP->fontMetrics().height() + 4);
+   ui.pclCanTraceP->verticalHeader()->hide();
+   ui.pclCanTraceP->horizontalHeader()->setStretchLastSection(true);
+
+   connect( pclTraceModelP, SIGNAL(rowsAppended()),
+            this, SLOT(onTraceAppended()));
+
+   connect( ui.actionFixed, SIGNAL(toggled(bool)),
+            this, SLOT(onTraceFixed(bool)));
    /*
    connect( pclCanSocketP, SIGNAL(framesReceived(uint32_t)),
             this, SLOT(onClientReceive(uint32_t)));
@@ -60,15 +79,18 @@ void  MonitorWindow::onClientDisconnect(void)
 
 void  MonitorWindow::onClientReceive(uint32_t ulFramesReceivedV)
 {
-   QCanFrame   clFrameT;
-   QString     clMsgStringT;
-   uint32_t    ulFrameCntT;
+   Q_UNUSED(ulFramesReceivedV);
+
+   QVector<QCanFrame>   clFrameListT;
+   int32_t              slFrameIdxT;
 
-   for(ulFrameCntT = 0; ulFrameCntT < ulFramesReceivedV; ulFrameCntT++)
+   //----------------------------------------------------------------
+   // the model collects the frames, the view is updated periodically
+   //
+   pclCanSocketP->readFrames(clFrameListT);
+   for (slFrameIdxT = 0; slFrameIdxT < clFrameListT.size(); slFrameIdxT++)
    {
-      pclCanSocketP->readFrame(clFrameT);
-      clMsgStringT = clFrameT.toString();
-      ui.pclCanTraceP->append(clMsgStringT);
+      pclTraceModelP->appendFrame(clFrameListT.at(slFrameIdxT));
    }
 
 }
@@ -106,3 +128,26 @@ void MonitorWindow::onSocketSelect(QCanSocket * pclCanSocketV)
    connect( pclCanSocketP, SIGNAL(framesReceived(uint32_t)),
             this, SLOT(onClientReceive(uint32_t)));
 }
+
+//--------------------------------------------------------------------------------------------------------------------//
+// onTraceAppended()                                                                                                  //
+// keep the last frame visible in trace mode                                                                          //
+//--------------------------------------------------------------------------------------------------------------------//
+void MonitorWindow::onTraceAppended(void)
+{
+   if (!pclTraceModelP->isFixedMode())
+   {
+      ui.pclCanTraceP->scrollToBottom();
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// onTraceFixed()                                                                                                     //
+// switch between trace and fixed mode                                                                                //
+//--------------------------------------------------------------------------------------------------------------------//
+void MonitorWindow::onTraceFixed(bool btCheckedV)
+{
+   pclTraceModelP->setFixedMode(btCheckedV);
+   ui.pclCanTraceP->scrollToBottom();
+}
@@ -9,6 +9,8 @@
 
 #include "ui_MonitorWindow.h"
 
+#include "monitor_trace_model.hpp"
+
 class MonitorWindow : public QMainWindow
 {
     Q_OBJECT
@@ -29,10 +31,13 @@ public slots:
    
 private slots:
    void  onSocketSelect(QCanSocket * pclCanSocketV);
+   void  onTraceAppended(void);
+   void  onTraceFixed(bool btCheckedV);
    
 private:
    Ui::MonitorWindow    ui;
    QPointer<QCanSocket> pclCanSocketP;
+   MonitorTraceModel *  pclTraceModelP;
     
 };
 
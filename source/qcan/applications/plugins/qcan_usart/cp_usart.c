@@ -35,6 +35,7 @@
 \*----------------------------------------------------------------------------*/
 #include "cp_core.h"
 #include "cp_msg.h"
+#include "cp_usart_frame.h"
 #include "mc_usart.h"
 
 #include "string.h"
@@ -69,6 +70,21 @@
 */
 #define CP_USART_STATE_BUSY  0x01
 
+/*!
+** \def   CP_USART_STATE_VERSION
+** Flag for aubUsartStateS variable.
+** A version frame is pending, it is sent after the transmission of the
+** current frame has been completed.
+*/
+#define CP_USART_STATE_VERSION   0x02
+
+/*!
+** \def   CP_USART_STATE_REQUEST
+** Flag for aubUsartStateS variable.
+** The pending version frame requests a version frame as reply.
+*/
+#define CP_USART_STATE_REQUEST   0x04
+
 /*!
 ** \def  CP_BUFFER_VAL
 ** Flag for ulMsgUser variable within CANpie Message, that is used
@@ -93,60 +109,18 @@ enum DrvInfo_e
    eDRV_INFO_ACTIVE  //!< eDRV_INFO_ACTIVE
 };
 
-/*----------------------------------------------------------------------------*/
 /*!
-** \struct  CpUsartFrame_s
-** \brief   USART frame for streaming
-**
+** \def   CP_USART_RCV_BATCH
+** Maximum number of CAN messages which are decoded in one step by the
+** receive handler before they are passed to the message buffers
 */
-typedef struct CpUsartFrame_s
-{
+#define CP_USART_RCV_BATCH    16
 
-   /*!
-   ** The identifier field may have 11 bits for standard frames
-   ** (CAN specification 2.0A) or 29 bits for extended frames
-   ** (CAN specification 2.0B). The three most significant bits
-   ** are reserved (always read 0).
-   ** \see CP_MASK
-   */
-   uint32_t  ulIdentifier;
-
-   /*!
-   ** The data field has up to 8 bytes (for classic CAN) or
-   ** 64 bytes (for ISO CAN FD) of message data.
-   ** The number of used bytes is described via the structure
-   ** member \c ubMsgDLC.
-   */
-   uint8_t   aubData[CP_DATA_SIZE];
-
-   /*!
-   ** The data length code denotes the number of data bytes
-   ** which are transmitted by a message.
-   ** The possible value range for the data length code is
-   ** from 0 to 8 for classic CAN and 0 to 15 for ISO CAN FD.
-   */
-   uint8_t  ubMsgDLC;
-
-
-   /*!
-   ** The structure member \c ubMsgCtrl defines the
-   ** different data frames (2.0A / 2.0B) and the RTR frames.
-   ** <ul>
-   ** <li>Bit 0: Std. / Ext. Frame
-   ** <li>Bit 1: ISO CAN FD: value of FDF bit
-   ** <li>Bit 2: Remote Frame
-   ** <li>Bit 3: Overload Frame
-   ** <li>Bit 4: reserved, always 0
-   ** <li>Bit 5: reserved, always 0
-   ** <li>Bit 6: ISO CAN FD: value of BRS bit
-   ** <li>Bit 7: ISO CAN FD: value of ESI bit
-   ** </ul>
-   ** \see CP_MSG_CTRL
-   */
-   uint8_t  ubMsgCtrl;
-
-
-} CPP_PACK CpUsartFrame_ts;
+/*!
+** \def   CP_USART_BUFFER_NONE
+** Marks a received CAN message which does not match any message buffer
+*/
+#define CP_USART_BUFFER_NONE  ((uint8_t) 0xFF)
 
 
 /*----------------------------------------------------------------------------*\
@@ -156,16 +130,40 @@ typedef struct CpUsartFrame_s
 
 
 /*!
-** \var  atsUsartRcvFrameS
-** Reception buffer for USAT frame
+** \var  atsUsartDecoderS
+** Frame decoder for the received byte stream of an USART interface
+*/
+static CpUsartDecoder_ts atsUsartDecoderS[MC_USART_PORT_MAX];
+
+/*!
+** \var  atsUsartTrmMsgS
+** CAN message which is currently transmitted via an USART interface
 */
-CpUsartFrame_ts atsUsartRcvFrameS[MC_USART_PORT_MAX];
+static CpCanMsg_ts     atsUsartTrmMsgS[MC_USART_PORT_MAX];
 
 /*!
-** \var  atsUsartTrmFrameS
-** Transmission buffer for USAT frame
+** \var  aaubUsartTrmFrameS
+** Transmission buffer for USART frame
 */
-CpUsartFrame_ts atsUsartTrmFrameS[MC_USART_PORT_MAX];
+static uint8_t         aaubUsartTrmFrameS[MC_USART_PORT_MAX][CP_USART_FRAME_SIZE];
+
+/*!
+** \var  aaubUsartVersionFrameS
+** Transmission buffer for version frame
+*/
+static uint8_t         aaubUsartVersionFrameS[MC_USART_PORT_MAX][CP_USART_FRAME_SIZE];
+
+/*!
+** \var  atsUsartRcvMsgS
+** CAN messages decoded by the receive handler
+*/
+static CpCanMsg_ts     atsUsartRcvMsgS[CP_CHANNEL_MAX][CP_USART_RCV_BATCH];
+
+/*!
+** \var  aubUsartRcvBufferS
+** Message buffer index for each decoded CAN message
+*/
+static uint8_t         aubUsartRcvBufferS[CP_CHANNEL_MAX][CP_USART_RCV_BATCH];
 
 /*!
 ** \var  aubUsartStateS
@@ -189,6 +187,17 @@ static CpState_ts  atsCpStateS[CP_CHANNEL_MAX];
 static CpStatistic_ts atsCpStatisticS[CP_CHANNEL_MAX];
 #endif
 
+#if CP_TRM_PRIORITY > 0
+//-------------------------------------------------------------------
+// priority ordered transmit queues, the tick counts the frames
+// transmitted by an USART interface, so the queueing delay is
+// measured in frame slots
+//
+static CpPrio_ts       atsTrmPrioS[CP_CHANNEL_MAX][CP_BUFFER_MAX];
+static CpPrioEntry_ts  atsTrmPrioEntryS[CP_CHANNEL_MAX][CP_BUFFER_MAX][CP_TRM_PRIORITY];
+static uint32_t        aulTrmTickS[CP_CHANNEL_MAX];
+#endif
+
 //-------------------------------------------------------------------
 // these pointers store the callback handlers
 //
@@ -196,6 +205,13 @@ static CpRcvHandler_Fn  apfnRcvHandlerS[CP_CHANNEL_MAX];
 static CpTrmHandler_Fn  apfnTrmHandlerS[CP_CHANNEL_MAX];
 static CpErrHandler_Fn  apfnErrHandlerS[CP_CHANNEL_MAX];
 
+//-------------------------------------------------------------------
+// batch notification of receive FIFOs, the driver has no time base:
+// the end of a received USART block is used as timeout instead
+//
+static CpFifoHandler_Fn apfnFifoHandlerS[CP_CHANNEL_MAX][CP_BUFFER_MAX];
+static CpFifoEvent_ts   atsFifoEventS[CP_CHANNEL_MAX][CP_BUFFER_MAX];
+
 /*----------------------------------------------------------------------------*\
 ** Internal function declaration                                              **
 **                                                                            **
@@ -299,55 +315,26 @@ static uint8_t CpPortToUsart(CPP_CONST CpPort_ts *ptsPortV)
 
 
 //----------------------------------------------------------------------------//
-// CpCanMsgFromUsart()                                                        //
-// Copy data from CAN message into USART frame                                //
+// CopyCanMsgToBuffer()                                                       //
+// Copy identifier, control field, DLC and data into CAN message buffer       //
 //----------------------------------------------------------------------------//
-static void CopyCanMsgToUsartFrame(CPP_CONST CpCanMsg_ts *ptsCanMsgV,
-                                   CpUsartFrame_ts *ptsUsartFrameV)
+static void CopyCanMsgToBuffer(CpCanMsg_ts *ptsBufferMsgV,
+                               CPP_CONST CpCanMsg_ts *ptsCanMsgV)
 {
-   uint8_t ubCntrT;
-
-   if ((ptsCanMsgV != CPP_NULL) && (ptsUsartFrameV != CPP_NULL))
-   {
-      ptsUsartFrameV->ubMsgDLC = ptsCanMsgV->ubMsgDLC;
-      ptsUsartFrameV->ulIdentifier = ptsCanMsgV->ulIdentifier;
-      ptsUsartFrameV->ubMsgCtrl = ptsCanMsgV->ubMsgCtrl;
-      for (ubCntrT = 0; ubCntrT < CP_DATA_SIZE; ubCntrT++)
-      {
-         ptsUsartFrameV->aubData[ubCntrT] = ptsCanMsgV->tuMsgData.aubByte[ubCntrT];
-      }
-   }
+   ptsBufferMsgV->ubMsgDLC     = ptsCanMsgV->ubMsgDLC;
+   ptsBufferMsgV->ulIdentifier = ptsCanMsgV->ulIdentifier;
+   ptsBufferMsgV->ubMsgCtrl    = ptsCanMsgV->ubMsgCtrl;
+   memcpy(&(ptsBufferMsgV->tuMsgData.aubByte[0]),
+          &(ptsCanMsgV->tuMsgData.aubByte[0]), CP_DATA_SIZE);
 }
 
-//----------------------------------------------------------------------------//
-// CpCanMsgFromUsart()                                                        //
-// Copy data from USART frame into CAN message                                //
-//----------------------------------------------------------------------------//
-static void CopyUsartFrameToCanMsg(CpCanMsg_ts *ptsCanMsgV,
-                                   CPP_CONST CpUsartFrame_ts *ptsUsartFrameV)
-{
-   uint8_t ubCntrT;
-
-   if ((ptsCanMsgV != CPP_NULL) && (ptsUsartFrameV != CPP_NULL))
-   {
-      ptsCanMsgV->ubMsgDLC = ptsUsartFrameV->ubMsgDLC;
-      ptsCanMsgV->ulIdentifier = ptsUsartFrameV->ulIdentifier;
-      ptsCanMsgV->ubMsgCtrl = ptsUsartFrameV->ubMsgCtrl;
-      for (ubCntrT = 0; ubCntrT < CP_DATA_SIZE; ubCntrT++)
-      {
-         ptsCanMsgV->tuMsgData.aubByte[ubCntrT] = ptsUsartFrameV->aubData[ubCntrT];
-      }
-   }
-}
-
-
 
 //----------------------------------------------------------------------------//
-// CpCanMsgFromUsart()                                                        //
-// Copy data from USART frame into CAN message                                //
+// CpCanMsgFromBuffer()                                                       //
+// Search the message buffer which matches a CAN message                      //
 //----------------------------------------------------------------------------//
-static CpCanMsg_ts *CpCanMsgFromBuffer(CPP_CONST CpUsartFrame_ts
-                                       *ptsUsartFrameV,
+static CpCanMsg_ts *CpCanMsgFromBuffer(uint8_t ubChannelV,
+                                       CPP_CONST CpCanMsg_ts *ptsCanMsgV,
                                        uint8_t ubDirectionV,
                                        uint8_t *pubBufferIdxV)
 {
@@ -355,24 +342,24 @@ static CpCanMsg_ts *CpCanMsgFromBuffer(CPP_CONST CpUsartFrame_ts
    uint8_t      ubBufferIdxT;
 
    //----------------------------------------------------------------
-   // go through all valid transmit buffers and check for identifier hit
+   // go through all valid buffers and check for identifier hit
    //
    for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
    {
-      if ((atsCanMsgS[eCP_CHANNEL_1-1][ubBufferIdxT].ulMsgUser &
+      if ((atsCanMsgS[ubChannelV][ubBufferIdxT].ulMsgUser &
             (CP_BUFFER_VAL | eCP_BUFFER_DIR_TRM)) == (CP_BUFFER_VAL | ubDirectionV))
       {
          // consider mask at comparison of identifier
-         if ( ((atsCanMsgS[eCP_CHANNEL_1-1][ubBufferIdxT].ulIdentifier &
-               aulAccMaskS[eCP_CHANNEL_1-1][ubBufferIdxT]) ==
-               (ptsUsartFrameV->ulIdentifier &
-                aulAccMaskS[eCP_CHANNEL_1-1][ubBufferIdxT])) &&
+         if ( ((atsCanMsgS[ubChannelV][ubBufferIdxT].ulIdentifier &
+               aulAccMaskS[ubChannelV][ubBufferIdxT]) ==
+               (ptsCanMsgV->ulIdentifier &
+                aulAccMaskS[ubChannelV][ubBufferIdxT])) &&
             // consider identifier type (standard or extended)
-            ((atsCanMsgS[eCP_CHANNEL_1-1][ubBufferIdxT].ubMsgCtrl & CP_MSG_FORMAT_CEFF) ==
-             (ptsUsartFrameV->ubMsgCtrl & CP_MSG_FORMAT_CEFF)))
+            ((atsCanMsgS[ubChannelV][ubBufferIdxT].ubMsgCtrl & CP_MSG_FORMAT_CEFF) ==
+             (ptsCanMsgV->ubMsgCtrl & CP_MSG_FORMAT_CEFF)))
          {
             // we have a hit, get pointer to the corresponding buffer
-            ptsBufferMsgT = &(atsCanMsgS[eCP_CHANNEL_1-1][ubBufferIdxT]);
+            ptsBufferMsgT = &(atsCanMsgS[ubChannelV][ubBufferIdxT]);
 
             if (pubBufferIdxV != CPP_NULL)
             {
@@ -389,6 +376,317 @@ static CpCanMsg_ts *CpCanMsgFromBuffer(CPP_CONST CpUsartFrame_ts
 }
 
 
+//----------------------------------------------------------------------------//
+// CpUsartSendVersion()                                                       //
+// announce the supported protocol version to the peer                        //
+//----------------------------------------------------------------------------//
+static void CpUsartSendVersion(uint8_t ubPortV, uint8_t ubRequestV)
+{
+   //----------------------------------------------------------------
+   // a frame is still transmitted: the version frame is sent by the
+   // transmit handler when the USART is idle again
+   //
+   if ((aubUsartStateS[ubPortV] & CP_USART_STATE_BUSY) > 0)
+   {
+      aubUsartStateS[ubPortV] |= CP_USART_STATE_VERSION;
+      if (ubRequestV > 0)
+      {
+         aubUsartStateS[ubPortV] |= CP_USART_STATE_REQUEST;
+      }
+      return;
+   }
+
+   if ((aubUsartStateS[ubPortV] & CP_USART_STATE_REQUEST) > 0)
+   {
+      ubRequestV = 1;
+   }
+   aubUsartStateS[ubPortV] &= ~(CP_USART_STATE_VERSION | CP_USART_STATE_REQUEST);
+   aubUsartStateS[ubPortV] |= CP_USART_STATE_BUSY;
+
+   McUsartWrite(ubPortV, &(aaubUsartVersionFrameS[ubPortV][0]),
+                CpUsartVersionEncode(ubRequestV,
+                                     &(aaubUsartVersionFrameS[ubPortV][0])));
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartRcvDispatch()                                                       //
+// Pass decoded CAN messages to message buffers and FIFOs                     //
+//----------------------------------------------------------------------------//
+static void CpUsartRcvDispatch(uint8_t ubChannelV, uint32_t ulMsgCntV)
+{
+   CpCanMsg_ts *ptsBufferMsgT;
+   CpCanMsg_ts *ptsCanMsgT;
+   CpFifo_ts   *ptsFifoT;
+   uint8_t     *pubBufferIdxT;
+   uint32_t     ulMsgIdxT;
+   uint32_t     ulRunT;
+   uint32_t     ulCopyT;
+   uint32_t     ulSpanT;
+
+   ptsCanMsgT    = &(atsUsartRcvMsgS[ubChannelV][0]);
+   pubBufferIdxT = &(aubUsartRcvBufferS[ubChannelV][0]);
+
+   //----------------------------------------------------------------
+   // look up the message buffer of each message first, so that
+   // consecutive messages of one FIFO can be copied as a block
+   //
+   for (ulMsgIdxT = 0; ulMsgIdxT < ulMsgCntV; ulMsgIdxT++)
+   {
+      if (CpCanMsgFromBuffer(ubChannelV, &ptsCanMsgT[ulMsgIdxT],
+                             eCP_BUFFER_DIR_RCV,
+                             &pubBufferIdxT[ulMsgIdxT]) == CPP_NULL)
+      {
+         pubBufferIdxT[ulMsgIdxT] = CP_USART_BUFFER_NONE;
+      }
+   }
+
+   ulMsgIdxT = 0;
+   while (ulMsgIdxT < ulMsgCntV)
+   {
+      if (pubBufferIdxT[ulMsgIdxT] == CP_USART_BUFFER_NONE)
+      {
+         ulMsgIdxT++;
+         continue;
+      }
+
+      ptsBufferMsgT = &(atsCanMsgS[ubChannelV][pubBufferIdxT[ulMsgIdxT]]);
+      ptsFifoT      = aptsFifoS[ubChannelV][pubBufferIdxT[ulMsgIdxT]];
+
+      //--------------------------------------------------------
+      // test for FIFO
+      //
+      if (ptsFifoT == CPP_NULL)
+      {
+         CopyCanMsgToBuffer(ptsBufferMsgT, &ptsCanMsgT[ulMsgIdxT]);
+
+         //------------------------------------------------
+         // test for receive callback handler and pass data to it
+         //
+         if (apfnRcvHandlerS[ubChannelV] != CPP_NULL)
+         {
+            (* apfnRcvHandlerS[ubChannelV])(ptsBufferMsgT,
+                                            pubBufferIdxT[ulMsgIdxT]);
+         }
+         ulRunT = 1;
+      }
+      else
+      {
+         //------------------------------------------------
+         // put all consecutive messages of this buffer into
+         // the receive FIFO, messages which do not fit are
+         // discarded
+         //
+         ulRunT = 1;
+         while (((ulMsgIdxT + ulRunT) < ulMsgCntV) &&
+                (pubBufferIdxT[ulMsgIdxT + ulRunT] == pubBufferIdxT[ulMsgIdxT]))
+         {
+            ulRunT++;
+         }
+         CopyCanMsgToBuffer(ptsBufferMsgT, &ptsCanMsgT[ulMsgIdxT + ulRunT - 1]);
+
+         ulCopyT = 0;
+         while (ulCopyT < ulRunT)
+         {
+            ulSpanT = CpFifoDataInSpan(ptsFifoT);
+            if (ulSpanT == 0)
+            {
+               break;
+            }
+            if (ulSpanT > (ulRunT - ulCopyT))
+            {
+               ulSpanT = ulRunT - ulCopyT;
+            }
+            memcpy(CpFifoDataInPtr(ptsFifoT), &ptsCanMsgT[ulMsgIdxT + ulCopyT],
+                   ulSpanT * sizeof(CpCanMsg_ts));
+            CpFifoAddIn(ptsFifoT, ulSpanT);
+            ulCopyT += ulSpanT;
+         }
+
+         //------------------------------------------------
+         // notify the application once per batch
+         //
+         if (apfnFifoHandlerS[ubChannelV][pubBufferIdxT[ulMsgIdxT]] != CPP_NULL)
+         {
+            if (CpFifoEventIn(&atsFifoEventS[ubChannelV][pubBufferIdxT[ulMsgIdxT]],
+                              ptsFifoT, 0))
+            {
+               (* apfnFifoHandlerS[ubChannelV][pubBufferIdxT[ulMsgIdxT]])(
+                                          pubBufferIdxT[ulMsgIdxT],
+                                          CpFifoPending(ptsFifoT));
+            }
+         }
+      }
+
+      #if CP_STATISTIC > 0
+      atsCpStatisticS[ubChannelV].ulRcvMsgCount += ulRunT;
+      #endif
+
+      ulMsgIdxT += ulRunT;
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartRcvProcess()                                                        //
+// Decode received bytes of an USART interface                                //
+//----------------------------------------------------------------------------//
+static void CpUsartRcvProcess(uint8_t ubChannelV,
+                              CPP_CONST uint8_t *pubDataV, uint32_t ulSizeV)
+{
+   CpFifoEvent_ts *ptsEventT;
+   uint32_t        ulMsgCntT;
+   uint32_t        ulUsedT;
+   uint8_t         ubBufferIdxT;
+
+   //----------------------------------------------------------------
+   // the data may contain any number of frames, including partial
+   // frames at the start and at the end
+   //
+   while (ulSizeV > 0)
+   {
+      ulMsgCntT = CpUsartFrameDecode(&atsUsartDecoderS[ubChannelV],
+                                     pubDataV, ulSizeV, &ulUsedT,
+                                     &(atsUsartRcvMsgS[ubChannelV][0]),
+                                     CP_USART_RCV_BATCH);
+      pubDataV += ulUsedT;
+      ulSizeV  -= ulUsedT;
+
+      CpUsartRcvDispatch(ubChannelV, ulMsgCntT);
+
+      //--------------------------------------------------------
+      // answer a version request of the peer
+      //
+      if (atsUsartDecoderS[ubChannelV].ubReplyPending > 0)
+      {
+         atsUsartDecoderS[ubChannelV].ubReplyPending = 0;
+         if (ubCanModeS == eCP_MODE_START)
+         {
+            CpUsartSendVersion(ubChannelV, 0);
+         }
+      }
+   }
+
+   //----------------------------------------------------------------
+   // the block ends with the receive timeout of the USART, messages
+   // below the high watermark are notified now if a timeout is set
+   //
+   for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
+   {
+      if (apfnFifoHandlerS[ubChannelV][ubBufferIdxT] != CPP_NULL)
+      {
+         ptsEventT = &atsFifoEventS[ubChannelV][ubBufferIdxT];
+         if (CpFifoEventTimer(ptsEventT, aptsFifoS[ubChannelV][ubBufferIdxT],
+                              ptsEventT->ulTickStart + ptsEventT->ulTimeout))
+         {
+            (* apfnFifoHandlerS[ubChannelV][ubBufferIdxT])(ubBufferIdxT,
+                           CpFifoPending(aptsFifoS[ubChannelV][ubBufferIdxT]));
+         }
+      }
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartTrmPending()                                                        //
+// start transmission of a pending message buffer                             //
+//----------------------------------------------------------------------------//
+static void CpUsartTrmPending(uint8_t ubChannelV)
+{
+   CpCanMsg_ts *ptsBufferMsgT;
+   uint8_t      ubBufferIdxT;
+   #if CP_TRM_PRIORITY > 0
+   uint8_t      ubSelectT = CP_BUFFER_MAX;
+   uint32_t     ulKeyT;
+   uint32_t     ulSelectKeyT = 0;
+   #endif
+
+   #if CP_TRM_PRIORITY > 0
+   //----------------------------------------------------------------
+   // select the pending buffer with the highest priority, the
+   // other buffers stay pending
+   //
+   for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
+   {
+      ptsBufferMsgT = &(atsCanMsgS[ubChannelV][ubBufferIdxT]);
+      if (((ptsBufferMsgT->ulMsgUser) & CP_BUFFER_PND))
+      {
+         ulKeyT = CpPrioKey(ptsBufferMsgT);
+         if ((ubSelectT == CP_BUFFER_MAX) || (ulKeyT < ulSelectKeyT))
+         {
+            ubSelectT    = ubBufferIdxT;
+            ulSelectKeyT = ulKeyT;
+         }
+      }
+   }
+
+   if (ubSelectT < CP_BUFFER_MAX)
+   {
+      atsCanMsgS[ubChannelV][ubSelectT].ulMsgUser &= ~CP_BUFFER_PND;
+      CpCoreBufferSend(aptsPortS[ubChannelV], ubSelectT);
+   }
+   #else
+   //----------------------------------------------------------------
+   // run through buffer list and test for open Tx requests
+   //
+   for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
+   {
+      ptsBufferMsgT = &(atsCanMsgS[ubChannelV][ubBufferIdxT]);
+      if (((ptsBufferMsgT->ulMsgUser) & CP_BUFFER_PND))
+      {
+         ptsBufferMsgT->ulMsgUser &= ~CP_BUFFER_PND;
+         CpCoreBufferSend(aptsPortS[ubChannelV], ubBufferIdxT);
+      }
+   }
+   #endif
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartTrmRefill()                                                         //
+// copy next message of a transmit FIFO to its message buffer                 //
+//----------------------------------------------------------------------------//
+static void CpUsartTrmRefill(uint8_t ubChannelV, uint8_t ubBufferIdxV,
+                             CpCanMsg_ts *ptsBufferMsgV)
+{
+   #if CP_TRM_PRIORITY > 0
+   if (CpPrioPop(&atsTrmPrioS[ubChannelV][ubBufferIdxV], ptsBufferMsgV,
+                 aulTrmTickS[ubChannelV]))
+   {
+      ptsBufferMsgV->ulMsgUser |= CP_BUFFER_PND;
+   }
+   #else
+   CpFifo_ts   *ptsFifoT;
+   CpCanMsg_ts *ptsFifoMsgT;
+
+   ptsFifoT = aptsFifoS[ubChannelV][ubBufferIdxV];
+   if (CpFifoIsEmpty(ptsFifoT) == 0)
+   {
+      ptsFifoMsgT = CpFifoDataOutPtr(ptsFifoT);
+      memcpy(ptsBufferMsgV, ptsFifoMsgT, sizeof(CpCanMsg_ts));
+      CpFifoIncOut(ptsFifoT);
+      ptsFifoMsgT->ulMsgUser |= CP_BUFFER_PND;
+   }
+   #endif
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartTrmSize()                                                           //
+// return expected size of a transmitted frame                                //
+//----------------------------------------------------------------------------//
+static uint32_t CpUsartTrmSize(uint8_t ubChannelV,
+                               CPP_CONST uint8_t *pubDataV, uint32_t ulSizeV)
+{
+   if (atsUsartDecoderS[ubChannelV].ubLegacy > 0)
+   {
+      return (CP_USART_LEGACY_SIZE);
+   }
+
+   return (CpUsartFrameSize(pubDataV, ulSizeV));
+}
+
+
 //----------------------------------------------------------------------------//
 // CpCoreBitrate()                                                            //
 //                                                                            //
@@ -608,17 +906,28 @@ CpStatus_tv CpCoreBufferSend(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV)
       //--------------------------------------------------------
       // if USART interface is available, transmit frame
       //
-      if ((aubUsartStateS[CpPortToUsart(ptsPortV)] & CP_USART_STATE_IDLE) ==
-            CP_USART_STATE_IDLE)
+      if ((aubUsartStateS[CpPortToUsart(ptsPortV)] & CP_USART_STATE_BUSY) == 0)
       {
          aubUsartStateS[CpPortToUsart(ptsPortV)] |= CP_USART_STATE_BUSY;
 
-         CopyCanMsgToUsartFrame(&(atsCanMsgS[ptsPortV->ubPhyIf-1][ubBufferIdxV]),
-                                &(atsUsartTrmFrameS[CpPortToUsart(ptsPortV)]));
+         CopyCanMsgToBuffer(&(atsUsartTrmMsgS[CpPortToUsart(ptsPortV)]),
+                            &(atsCanMsgS[ptsPortV->ubPhyIf-1][ubBufferIdxV]));
 
-         McUsartWrite((ptsPortV->ubPhyIf-1),
-                      (uint8_t *)&(atsUsartTrmFrameS[CpPortToUsart(ptsPortV)]),
-                      sizeof(CpUsartFrame_ts));
+         if (atsUsartDecoderS[CpPortToUsart(ptsPortV)].ubLegacy > 0)
+         {
+            McUsartWrite((ptsPortV->ubPhyIf-1),
+                         &(aaubUsartTrmFrameS[CpPortToUsart(ptsPortV)][0]),
+                         CpUsartLegacyEncode(&(atsUsartTrmMsgS[CpPortToUsart(ptsPortV)]),
+                                 &(aaubUsartTrmFrameS[CpPortToUsart(ptsPortV)][0])));
+         }
+         else
+         {
+            McUsartWrite((ptsPortV->ubPhyIf-1),
+                         &(aaubUsartTrmFrameS[CpPortToUsart(ptsPortV)][0]),
+                         CpUsartFrameEncode(&(atsUsartTrmMsgS[CpPortToUsart(ptsPortV)]),
+                                 CpUsartVersionSelect(&atsUsartDecoderS[CpPortToUsart(ptsPortV)]),
+                                 &(aaubUsartTrmFrameS[CpPortToUsart(ptsPortV)][0])));
+         }
       }
       else
       {
@@ -735,16 +1044,26 @@ CpStatus_tv CpCoreCanMode(CpPort_ts *ptsPortV, uint8_t ubModeV)
             // Start the CAN controller (active on the bus)
             //
             case eCP_MODE_START:
-               McUsartSetRcvBufferSize(CpPortToUsart(ptsPortV), sizeof(CpUsartFrame_ts));
+               McUsartSetRcvBufferSize(CpPortToUsart(ptsPortV), 1);
                McUsartSetDir(CpPortToUsart(ptsPortV), eUSART_DIR_RXTX);
                ubCanModeS = ubModeV;
+
+               //---------------------------------------------
+               // ask the peer for its protocol version, frames
+               // stay fixed until the peer answers, a legacy
+               // peer does not know version frames
+               //
+               if (atsUsartDecoderS[CpPortToUsart(ptsPortV)].ubLegacy == 0)
+               {
+                  CpUsartSendVersion(CpPortToUsart(ptsPortV), 1);
+               }
                break;
 
             //--------------------------------------------------------
             // Start the CAN controller (Listen-Only)
             //
             case eCP_MODE_LISTEN_ONLY:
-               McUsartSetRcvBufferSize(CpPortToUsart(ptsPortV), sizeof(CpUsartFrame_ts));
+               McUsartSetRcvBufferSize(CpPortToUsart(ptsPortV), 1);
                McUsartSetDir(CpPortToUsart(ptsPortV), eUSART_DIR_RX);
                ubCanModeS = ubModeV;
                break;
@@ -806,7 +1125,7 @@ CpStatus_tv CpCoreCanState(CpPort_ts *ptsPortV, CpState_ts *ptsStateV)
 // init CAN controller                                                        //
 //----------------------------------------------------------------------------//
 CpStatus_tv CpCoreDriverInit(uint8_t ubPhyIfV, CpPort_ts *ptsPortV,
-                             uint8_t CPP_PARM_UNUSED(ubConfigV))
+                             uint8_t ubConfigV)
 {
    CpStatus_tv tvStatusT = eCP_ERR_CHANNEL;
    uint8_t ubBufferIdxT;
@@ -841,16 +1160,35 @@ CpStatus_tv CpCoreDriverInit(uint8_t ubPhyIfV, CpPort_ts *ptsPortV,
                memset(&atsCanMsgS[ptsPortV->ubPhyIf-1][ubBufferIdxT], 0x00,
                       sizeof(CpCanMsg_ts));
                aptsFifoS[ptsPortV->ubPhyIf-1][ubBufferIdxT] = CPP_NULL;
+               apfnFifoHandlerS[ptsPortV->ubPhyIf-1][ubBufferIdxT] = CPP_NULL;
             }
 
-            // reset receive and transmit buffers for USART frames
-            memset(&atsUsartRcvFrameS[CpPortToUsart(ptsPortV)], 0x00,
-                   sizeof(CpUsartFrame_ts));
-            memset(&atsUsartTrmFrameS[CpPortToUsart(ptsPortV)], 0x00,
-                   sizeof(CpUsartFrame_ts));
+            // reset receive decoder and transmit buffer for USART frames
+            CpUsartDecoderInit(&atsUsartDecoderS[CpPortToUsart(ptsPortV)]);
+            if ((ubConfigV & CP_USART_CONFIG_LEGACY) > 0)
+            {
+               atsUsartDecoderS[CpPortToUsart(ptsPortV)].ubLegacy = 1;
+            }
+            memset(&atsUsartTrmMsgS[CpPortToUsart(ptsPortV)], 0x00,
+                   sizeof(CpCanMsg_ts));
 
             aubUsartStateS[CpPortToUsart(ptsPortV)] = CP_USART_STATE_IDLE;
 
+            //---------------------------------------------
+            // the transmit handler clears the busy state of
+            // the USART
+            //
+            if (CpPortToUsart(ptsPortV) == eUSART_PORT_1)
+            {
+               McUsartSetTrmHandler(CpPortToUsart(ptsPortV), CpUsart1TrmHandler);
+            }
+            #if MC_USART_PORT_MAX > 1
+            if (CpPortToUsart(ptsPortV) == eUSART_PORT_2)
+            {
+               McUsartSetTrmHandler(CpPortToUsart(ptsPortV), CpUsart2TrmHandler);
+            }
+            #endif
+
             tvStatusT = eCP_ERR_NONE;
          }
          else
@@ -920,11 +1258,110 @@ CpStatus_tv CpCoreFifoConfig(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
       if (ptsFifoV != (CpFifo_ts *) 0)
       {
          aptsFifoS[ptsPortV->ubPhyIf-1][ubBufferIdxV] = ptsFifoV;
+         apfnFifoHandlerS[ptsPortV->ubPhyIf-1][ubBufferIdxV] = CPP_NULL;
+         #if CP_TRM_PRIORITY > 0
+         CpPrioInit(&atsTrmPrioS[ptsPortV->ubPhyIf-1][ubBufferIdxV],
+                    &atsTrmPrioEntryS[ptsPortV->ubPhyIf-1][ubBufferIdxV][0],
+                    CP_TRM_PRIORITY);
+         #endif
+      }
+      else
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoDelay()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoDelay(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
+                            CpPrioDelay_ts *ptsDelayV)
+{
+   CpStatus_tv tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      if (aptsFifoS[ptsPortV->ubPhyIf-1][ubBufferIdxV] == CPP_NULL)
+      {
+         tvStatusT = eCP_ERR_INIT_MISSING;
+      }
+
+      else if (ptsDelayV == (CpPrioDelay_ts *) 0L)
+      {
+         tvStatusT = eCP_ERR_PARAM;
       }
+
       else
+      {
+         #if CP_TRM_PRIORITY > 0
+         memcpy(ptsDelayV,
+                &(atsTrmPrioS[ptsPortV->ubPhyIf-1][ubBufferIdxV].atsDelay[0]),
+                CP_PRIO_CLASS_MAX * sizeof(CpPrioDelay_ts));
+         #else
+         tvStatusT = eCP_ERR_NOT_SUPPORTED;
+         #endif
+      }
+   }
+
+   return (tvStatusT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpCoreFifoEvent()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+CpStatus_tv CpCoreFifoEvent(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
+                            CpFifoHandler_Fn pfnFifoHandlerV,
+                            uint32_t ulHighMarkV, uint32_t ulLowMarkV,
+                            uint32_t ulTimeoutV)
+{
+   CpFifo_ts   *ptsFifoT;
+   CpStatus_tv  tvStatusT;
+
+   //----------------------------------------------------------------
+   // test parameter ptsPortV and ubBufferIdxV
+   //
+   tvStatusT = CheckParam(ptsPortV, ubBufferIdxV, eDRV_INFO_INIT);
+   if (tvStatusT == eCP_ERR_NONE)
+   {
+      ptsFifoT = aptsFifoS[ptsPortV->ubPhyIf-1][ubBufferIdxV];
+
+      if (ptsFifoT == CPP_NULL)
       {
          tvStatusT = eCP_ERR_FIFO_PARAM;
       }
+
+      else if (pfnFifoHandlerV == CPP_NULL)
+      {
+         apfnFifoHandlerS[ptsPortV->ubPhyIf-1][ubBufferIdxV] = CPP_NULL;
+      }
+
+      else if ((ulHighMarkV == 0) || (ulHighMarkV <= ulLowMarkV) ||
+               (ulHighMarkV > ptsFifoT->ulIndexMax))
+      {
+         tvStatusT = eCP_ERR_FIFO_PARAM;
+      }
+
+      else
+      {
+         //--------------------------------------------------------
+         // a timeout value > 0 notifies pending messages at the end
+         // of a received USART block, the tick is not used
+         //
+         CpFifoEventInit(&atsFifoEventS[ptsPortV->ubPhyIf-1][ubBufferIdxV],
+                         ulHighMarkV, ulLowMarkV, ulTimeoutV);
+         apfnFifoHandlerS[ptsPortV->ubPhyIf-1][ubBufferIdxV] = pfnFifoHandlerV;
+      }
    }
 
    return (tvStatusT);
@@ -940,8 +1377,9 @@ CpStatus_tv CpCoreFifoRead(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
                            uint32_t *pulBufferSizeV)
 {
    CpFifo_ts   *ptsFifoT;
-   CpCanMsg_ts *ptsFifoMsgT;
    CpStatus_tv  tvStatusT;
+   uint32_t     ulMsgCntT;
+   uint32_t     ulSpanT;
 
    //----------------------------------------------------------------
    // test parameter ptsPortV and ubBufferIdxV
@@ -962,21 +1400,47 @@ CpStatus_tv CpCoreFifoRead(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
 
       else
       {
-         ptsFifoT = aptsFifoS[ptsPortV->ubPhyIf-1][ubBufferIdxV];
+         ptsFifoT  = aptsFifoS[ptsPortV->ubPhyIf-1][ubBufferIdxV];
+         ulMsgCntT = 0;
 
-         if (CpFifoIsEmpty(ptsFifoT) == 1)
+         //--------------------------------------------------------
+         // copy pending messages block-wise, the ring layout
+         // requires at most two blocks
+         //
+         while (ulMsgCntT < *pulBufferSizeV)
          {
-            // FIFO is empty, no data has been copied
-            *pulBufferSizeV = 0;
-            tvStatusT = eCP_ERR_FIFO_EMPTY;
+            ulSpanT = CpFifoDataOutSpan(ptsFifoT);
+            if (ulSpanT == 0)
+            {
+               break;
+            }
+            if (ulSpanT > (*pulBufferSizeV - ulMsgCntT))
+            {
+               ulSpanT = *pulBufferSizeV - ulMsgCntT;
+            }
+
+            memcpy(ptsCanMsgV, CpFifoDataOutPtr(ptsFifoT),
+                   ulSpanT * sizeof(CpCanMsg_ts));
+            CpFifoAddOut(ptsFifoT, ulSpanT);
+
+            ptsCanMsgV += ulSpanT;
+            ulMsgCntT  += ulSpanT;
          }
-         else
+         *pulBufferSizeV = ulMsgCntT;
+
+         //--------------------------------------------------------
+         // re-arm the notification
+         //
+         if (apfnFifoHandlerS[ptsPortV->ubPhyIf-1][ubBufferIdxV] != CPP_NULL)
          {
-            ptsFifoMsgT = CpFifoDataOutPtr(ptsFifoT);
-            memcpy(ptsCanMsgV, ptsFifoMsgT, sizeof(CpCanMsg_ts));
-            CpFifoIncOut(ptsFifoT);
-            *pulBufferSizeV = 1;
-            tvStatusT = eCP_ERR_NONE;
+            CpFifoEventOut(&atsFifoEventS[ptsPortV->ubPhyIf-1][ubBufferIdxV],
+                           ptsFifoT, 0);
+         }
+
+         if (ulMsgCntT == 0)
+         {
+            // FIFO is empty, no data has been copied
+            tvStatusT = eCP_ERR_FIFO_EMPTY;
          }
       }
    }
@@ -1000,6 +1464,7 @@ CpStatus_tv CpCoreFifoRelease(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV)
    if (tvStatusT == eCP_ERR_NONE)
    {
       aptsFifoS[ptsPortV->ubPhyIf-1][ubBufferIdxV] = CPP_NULL;
+      apfnFifoHandlerS[ptsPortV->ubPhyIf-1][ubBufferIdxV] = CPP_NULL;
    }
 
    return (tvStatusT);
@@ -1014,9 +1479,14 @@ CpStatus_tv CpCoreFifoWrite(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
                             CpCanMsg_ts *ptsCanMsgV,
                             uint32_t *pulBufferSizeV)
 {
+   #if CP_TRM_PRIORITY > 0
+   CpPrio_ts   *ptsPrioT;
+   #else
    CpFifo_ts   *ptsFifoT;
-   CpCanMsg_ts *ptsFifoMsgT;
+   uint32_t     ulSpanT;
+   #endif
    CpStatus_tv  tvStatusT;
+   uint32_t     ulMsgCntT;
 
 
    //----------------------------------------------------------------
@@ -1038,35 +1508,84 @@ CpStatus_tv CpCoreFifoWrite(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
 
       else
       {
-         ptsFifoT = aptsFifoS[ptsPortV->ubPhyIf-1][ubBufferIdxV];
+         ulMsgCntT = 0;
+
+         #if CP_TRM_PRIORITY > 0
+         ptsPrioT = &atsTrmPrioS[ptsPortV->ubPhyIf-1][ubBufferIdxV];
 
          //------------------------------------------------
-         // check if buffer is busy
+         // sort messages into the priority ordered
+         // transmit queue
          //
-         if ((atsCanMsgS[ptsPortV->ubPhyIf-1][ubBufferIdxV].ulMsgUser & CP_BUFFER_PND) !=
-               0)
+         while (ulMsgCntT < *pulBufferSizeV)
          {
-            if (CpFifoIsFull(ptsFifoT) == 1)
+            if (CpPrioPush(ptsPrioT, ptsCanMsgV,
+                           aulTrmTickS[ptsPortV->ubPhyIf-1]) == false)
             {
-               // FIFO is empty, no data has been copied
-               *pulBufferSizeV = 0;
                tvStatusT = eCP_ERR_FIFO_FULL;
+               break;
             }
-            else
-            {
-               ptsFifoMsgT = CpFifoDataInPtr(ptsFifoT);
-               memcpy(ptsFifoMsgT, ptsCanMsgV, sizeof(CpCanMsg_ts));
-               CpFifoIncIn(ptsFifoT);
-               *pulBufferSizeV = 1;
-               tvStatusT = eCP_ERR_NONE;
-            }
+            ptsCanMsgV++;
+            ulMsgCntT++;
          }
-         else
+
+         //------------------------------------------------
+         // if the buffer is not busy the message with the
+         // highest priority is transmitted immediately
+         //
+         if ((ulMsgCntT > 0) &&
+             ((atsCanMsgS[ptsPortV->ubPhyIf-1][ubBufferIdxV].ulMsgUser &
+               CP_BUFFER_PND) == 0))
+         {
+            CpPrioPop(ptsPrioT, &atsCanMsgS[ptsPortV->ubPhyIf-1][ubBufferIdxV],
+                      aulTrmTickS[ptsPortV->ubPhyIf-1]);
+            (void) CpCoreBufferSend(ptsPortV, ubBufferIdxV);
+         }
+         #else
+         ptsFifoT  = aptsFifoS[ptsPortV->ubPhyIf-1][ubBufferIdxV];
+
+         //------------------------------------------------
+         // if the buffer is not busy the first message is
+         // transmitted immediately
+         //
+         if ((*pulBufferSizeV > 0) &&
+             ((atsCanMsgS[ptsPortV->ubPhyIf-1][ubBufferIdxV].ulMsgUser &
+               CP_BUFFER_PND) == 0))
          {
             memcpy(&atsCanMsgS[ptsPortV->ubPhyIf-1][ubBufferIdxV], ptsCanMsgV,
                    sizeof(CpCanMsg_ts));
             tvStatusT = CpCoreBufferSend(ptsPortV, ubBufferIdxV);
+            ptsCanMsgV++;
+            ulMsgCntT++;
+         }
+
+         //------------------------------------------------
+         // copy remaining messages block-wise into the
+         // transmit FIFO, the ring layout requires at most
+         // two blocks
+         //
+         while ((tvStatusT == eCP_ERR_NONE) && (ulMsgCntT < *pulBufferSizeV))
+         {
+            ulSpanT = CpFifoDataInSpan(ptsFifoT);
+            if (ulSpanT == 0)
+            {
+               tvStatusT = eCP_ERR_FIFO_FULL;
+               break;
+            }
+            if (ulSpanT > (*pulBufferSizeV - ulMsgCntT))
+            {
+               ulSpanT = *pulBufferSizeV - ulMsgCntT;
+            }
+
+            memcpy(CpFifoDataInPtr(ptsFifoT), ptsCanMsgV,
+                   ulSpanT * sizeof(CpCanMsg_ts));
+            CpFifoAddIn(ptsFifoT, ulSpanT);
+
+            ptsCanMsgV += ulSpanT;
+            ulMsgCntT  += ulSpanT;
          }
+         #endif
+         *pulBufferSizeV = ulMsgCntT;
       }
    }
 
@@ -1151,10 +1670,12 @@ CpStatus_tv CpCoreIntFunctions(CpPort_ts *ptsPortV,
                McUsartSetRcvHandler(CpPortToUsart(ptsPortV), CpUsart1RcvHandler);
             }
 
-            if (pfnTrmHandlerV != CPP_NULL)
-            {
-               McUsartSetTrmHandler(CpPortToUsart(ptsPortV), CpUsart1TrmHandler);
-            }
+            //---------------------------------------------
+            // the transmit handler clears the busy state
+            // of the USART, it is required without a
+            // callback too
+            //
+            McUsartSetTrmHandler(CpPortToUsart(ptsPortV), CpUsart1TrmHandler);
          }
 
          #if MC_USART_PORT_MAX > 1
@@ -1165,10 +1686,12 @@ CpStatus_tv CpCoreIntFunctions(CpPort_ts *ptsPortV,
                McUsartSetRcvHandler(CpPortToUsart(ptsPortV), CpUsart2RcvHandler);
             }
 
-            if (pfnTrmHandlerV != CPP_NULL)
-            {
-               McUsartSetTrmHandler(CpPortToUsart(ptsPortV), CpUsart2TrmHandler);
-            }
+            //---------------------------------------------
+            // the transmit handler clears the busy state
+            // of the USART, it is required without a
+            // callback too
+            //
+            McUsartSetTrmHandler(CpPortToUsart(ptsPortV), CpUsart2TrmHandler);
          }
          #endif
 
@@ -1213,90 +1736,27 @@ CpStatus_tv CpCoreStatistic(CpPort_ts *ptsPortV,
 
 //----------------------------------------------------------------------------//
 // CpUsart1RcvHandler()                                                       //
-// is called when new have been fully received into atsUsartRcvFrameS         //
+// is called with any number of bytes received from the USART interface       //
 //----------------------------------------------------------------------------//
 void CpUsart1RcvHandler(uint8_t *pubDataV, uint32_t ulSizeV)
 {
-   static uint8_t    ubBufferIdxT = 0;
-   CpCanMsg_ts      *ptsBufferMsgT;
-   CpFifo_ts        *ptsFifoT;
-   CpCanMsg_ts      *ptsFifoMsgT;
-
-   //----------------------------------------------------------------
-   // we should never run in here!
-   //
-   if (ulSizeV != sizeof(CpUsartFrame_ts))
-   {
-      if (apfnErrHandlerS[eCP_CHANNEL_1-1] != CPP_NULL)
-      {
-         atsCpStateS[eCP_CHANNEL_1-1].ubCanErrType = 0xFF;
-         (* apfnErrHandlerS[eCP_CHANNEL_1-1])(&atsCpStateS[eCP_CHANNEL_1-1]);
-      }
-   }
-
-   //----------------------------------------------------------------
-   // get corresponding buffer
-   //
-   ptsBufferMsgT = CpCanMsgFromBuffer((CpUsartFrame_ts *) pubDataV,
-                                      eCP_BUFFER_DIR_RCV,
-                                      &ubBufferIdxT);
-
-   //----------------------------------------------------------------
-   // process buffer at a hit
-   //
-   if (ptsBufferMsgT != CPP_NULL)
-   {
-      CopyUsartFrameToCanMsg(ptsBufferMsgT, (CpUsartFrame_ts *) pubDataV);
-
-      #if CP_STATISTIC > 0
-      atsCpStatisticS[eCP_CHANNEL_1-1].ulRcvMsgCount++;
-      #endif
-
-      //----------------------------------------------------------------
-      // test for FIFO
-      //
-      if (aptsFifoS[eCP_CHANNEL_1-1][ubBufferIdxT] == CPP_NULL)
-      {
-         //--------------------------------------------------------
-         // test for receive callback handler and pass data to it
-         //
-         if (apfnRcvHandlerS[eCP_CHANNEL_1-1] != CPP_NULL)
-         {
-            (* apfnRcvHandlerS[eCP_CHANNEL_1-1])(ptsBufferMsgT, ubBufferIdxT);
-         }
-      }
-      else
-      {
-         //--------------------------------------------------------
-         // put new message into receive FIFO
-         //
-         ptsFifoT = aptsFifoS[eCP_CHANNEL_1-1][ubBufferIdxT];
-         if (CpFifoIsEmpty(ptsFifoT) == 0)
-         {
-            ptsFifoMsgT = CpFifoDataInPtr(ptsFifoT);
-            memcpy(ptsFifoMsgT, ptsBufferMsgT, sizeof(CpCanMsg_ts));
-            CpFifoIncIn(ptsFifoT);
-         }
-      }
-
-   }
+   CpUsartRcvProcess(eCP_CHANNEL_1-1, pubDataV, ulSizeV);
 }
 
 //----------------------------------------------------------------------------//
 // CpUsart1TrmHandler()                                                       //
-// is called when all data from atsUsartTrmFrameS have been send              //
+// is called when all data from aaubUsartTrmFrameS have been send             //
 //----------------------------------------------------------------------------//
 void CpUsart1TrmHandler(uint8_t *pubDataV, uint32_t ulSizeV)
 {
    uint8_t          ubBufferIdxT  = 0;
    CpCanMsg_ts     *ptsBufferMsgT;
-   CpFifo_ts       *ptsFifoT;
-   CpCanMsg_ts     *ptsFifoMsgT;
 
    //----------------------------------------------------------------
    // we should never run in here!
    //
-   if (ulSizeV != sizeof(CpUsartFrame_ts))
+   if ((pubDataV == CPP_NULL) ||
+       (ulSizeV != CpUsartTrmSize(eCP_CHANNEL_1-1, pubDataV, ulSizeV)))
    {
       if (apfnErrHandlerS[eCP_CHANNEL_1-1] != CPP_NULL)
       {
@@ -1306,12 +1766,32 @@ void CpUsart1TrmHandler(uint8_t *pubDataV, uint32_t ulSizeV)
    }
 
    // clear BUSY flag, so next transmission can be done
-   aubUsartStateS[eCP_CHANNEL_1-1] &= ~CP_USART_STATE_IDLE;
+   aubUsartStateS[eCP_CHANNEL_1-1] &= ~CP_USART_STATE_BUSY;
+
+   //----------------------------------------------------------------
+   // a pending version frame is sent before the next CAN message
+   //
+   if ((aubUsartStateS[eCP_CHANNEL_1-1] & CP_USART_STATE_VERSION) > 0)
+   {
+      CpUsartSendVersion(eCP_CHANNEL_1-1, 0);
+   }
+
+   //----------------------------------------------------------------
+   // a version frame does not belong to a message buffer, a legacy
+   // frame may look like one
+   //
+   if ((atsUsartDecoderS[eCP_CHANNEL_1-1].ubLegacy == 0) &&
+       CpUsartFrameIsVersion(pubDataV, ulSizeV))
+   {
+      CpUsartTrmPending(eCP_CHANNEL_1-1);
+      return;
+   }
 
    //----------------------------------------------------------------
    // get corresponding buffer
    //
-   ptsBufferMsgT = CpCanMsgFromBuffer((CpUsartFrame_ts *) pubDataV,
+   ptsBufferMsgT = CpCanMsgFromBuffer(eCP_CHANNEL_1-1,
+                                      &(atsUsartTrmMsgS[eCP_CHANNEL_1-1]),
                                       eCP_BUFFER_DIR_TRM,
                                       &ubBufferIdxT);
 
@@ -1324,6 +1804,10 @@ void CpUsart1TrmHandler(uint8_t *pubDataV, uint32_t ulSizeV)
       atsCpStatisticS[eCP_CHANNEL_1-1].ulTrmMsgCount++;
       #endif
 
+      #if CP_TRM_PRIORITY > 0
+      aulTrmTickS[eCP_CHANNEL_1-1]++;
+      #endif
+
       //--------------------------------------------------------
       // test for transmit callback handler
       //
@@ -1336,119 +1820,42 @@ void CpUsart1TrmHandler(uint8_t *pubDataV, uint32_t ulSizeV)
       }
       else
       {
-         ptsFifoT = aptsFifoS[eCP_CHANNEL_1-1][ubBufferIdxT];
-         if (CpFifoIsEmpty(ptsFifoT) == 0)
-         {
-            ptsFifoMsgT = CpFifoDataOutPtr(ptsFifoT);
-            memcpy(ptsBufferMsgT, ptsFifoMsgT, sizeof(CpCanMsg_ts));
-            CpFifoIncOut(ptsFifoT);
-            ptsFifoMsgT->ulMsgUser |= CP_BUFFER_PND;
-         }
+         CpUsartTrmRefill(eCP_CHANNEL_1-1, ubBufferIdxT, ptsBufferMsgT);
       }
    }
 
    //----------------------------------------------------------------
-   // run through buffer list and test for open Tx requests
+   // test for open Tx requests
    //
-   for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
-   {
-      ptsBufferMsgT = &(atsCanMsgS[eCP_CHANNEL_1-1][ubBufferIdxT]);
-      if (((ptsBufferMsgT->ulMsgUser) & CP_BUFFER_PND))
-      {
-         ptsBufferMsgT->ulMsgUser &= ~CP_BUFFER_PND;
-         CpCoreBufferSend(aptsPortS[0], ubBufferIdxT);
-      }
-   }
+   CpUsartTrmPending(eCP_CHANNEL_1-1);
 }
 
 //----------------------------------------------------------------------------//
 // CpUsart2RcvHandler()                                                       //
-// is called when new have been fully received into atsUsartRcvFrameS         //
+// is called with any number of bytes received from the USART interface       //
 //----------------------------------------------------------------------------//
 #if MC_USART_PORT_MAX > 1
 void CpUsart2RcvHandler(uint8_t *pubDataV, uint32_t ulSizeV)
 {
-   uint8_t           ubBufferIdxT  = 0;
-   CpCanMsg_ts      *ptsBufferMsgT;
-   CpFifo_ts        *ptsFifoT;
-   CpCanMsg_ts      *ptsFifoMsgT;
-
-   //----------------------------------------------------------------
-   // we should never run in here!
-   //
-   if (ulSizeV != sizeof(CpUsartFrame_ts))
-   {
-      if (apfnErrHandlerS[eCP_CHANNEL_2-1] != CPP_NULL)
-      {
-         atsCpStateS[eCP_CHANNEL_2-1].ubCanErrType = 0xFF;
-         (* apfnErrHandlerS[eCP_CHANNEL_2-1])(&atsCpStateS[eCP_CHANNEL_2-1]);
-      }
-   }
-
-   //----------------------------------------------------------------
-   // get corresponding buffer
-   //
-   ptsBufferMsgT = CpCanMsgFromBuffer((CpUsartFrame_ts *) pubDataV,
-                                      eCP_BUFFER_DIR_RCV,
-                                      &ubBufferIdxT);
-
-   //----------------------------------------------------------------
-   // process buffer at a hit
-   //
-   if (ptsBufferMsgT != CPP_NULL)
-   {
-      CopyUsartFrameToCanMsg(ptsBufferMsgT, (CpUsartFrame_ts *) pubDataV);
-
-      #if CP_STATISTIC > 0
-      atsCpStatisticS[eCP_CHANNEL_2-1].ulRcvMsgCount++;
-      #endif
-
-      //----------------------------------------------------------------
-      // test for FIFO
-      //
-      if (aptsFifoS[eCP_CHANNEL_2-1][ubBufferIdxT] == CPP_NULL)
-      {
-         //--------------------------------------------------------
-         // test for receive callback handler and pass data to it
-         //
-         if (apfnRcvHandlerS[eCP_CHANNEL_2-1] != CPP_NULL)
-         {
-            (* apfnRcvHandlerS[eCP_CHANNEL_2-1])(ptsBufferMsgT, ubBufferIdxT);
-         }
-      }
-      else
-      {
-         //--------------------------------------------------------
-         // put new message into receive FIFO
-         //
-         ptsFifoT = aptsFifoS[eCP_CHANNEL_2-1][ubBufferIdxT];
-         if (CpFifoIsEmpty(ptsFifoT) == 0)
-         {
-            ptsFifoMsgT = CpFifoDataInPtr(ptsFifoT);
-            memcpy(ptsFifoMsgT, ptsBufferMsgT, sizeof(CpCanMsg_ts));
-            CpFifoIncIn(ptsFifoT);
-         }
-      }
-   }
+   CpUsartRcvProcess(eCP_CHANNEL_2-1, pubDataV, ulSizeV);
 }
 #endif
 
 //----------------------------------------------------------------------------//
 // CpUsart2TrmHandler()                                                       //
-// is called when all data from atsUsartTrmFrameS have been send              //
+// is called when all data from aaubUsartTrmFrameS have been send             //
 //----------------------------------------------------------------------------//
 #if MC_USART_PORT_MAX > 1
 void CpUsart2TrmHandler(uint8_t *pubDataV, uint32_t ulSizeV)
 {
    uint8_t          ubBufferIdxT  = 0;
    CpCanMsg_ts     *ptsBufferMsgT;
-   CpFifo_ts       *ptsFifoT;
-   CpCanMsg_ts     *ptsFifoMsgT;
 
    //----------------------------------------------------------------
    // we should never run in here!
    //
-   if (ulSizeV != sizeof(CpUsartFrame_ts))
+   if ((pubDataV == CPP_NULL) ||
+       (ulSizeV != CpUsartTrmSize(eCP_CHANNEL_2-1, pubDataV, ulSizeV)))
    {
       if (apfnErrHandlerS[eCP_CHANNEL_2-1] != CPP_NULL)
       {
@@ -1458,12 +1865,32 @@ void CpUsart2TrmHandler(uint8_t *pubDataV, uint32_t ulSizeV)
    }
 
    // clear BUSY flag, so next transmission can be done
-   aubUsartStateS[eCP_CHANNEL_2-1] &= ~CP_USART_STATE_IDLE;
+   aubUsartStateS[eCP_CHANNEL_2-1] &= ~CP_USART_STATE_BUSY;
+
+   //----------------------------------------------------------------
+   // a pending version frame is sent before the next CAN message
+   //
+   if ((aubUsartStateS[eCP_CHANNEL_2-1] & CP_USART_STATE_VERSION) > 0)
+   {
+      CpUsartSendVersion(eCP_CHANNEL_2-1, 0);
+   }
+
+   //----------------------------------------------------------------
+   // a version frame does not belong to a message buffer, a legacy
+   // frame may look like one
+   //
+   if ((atsUsartDecoderS[eCP_CHANNEL_2-1].ubLegacy == 0) &&
+       CpUsartFrameIsVersion(pubDataV, ulSizeV))
+   {
+      CpUsartTrmPending(eCP_CHANNEL_2-1);
+      return;
+   }
 
    //----------------------------------------------------------------
    // get corresponding buffer
    //
-   ptsBufferMsgT = CpCanMsgFromBuffer((CpUsartFrame_ts *) pubDataV,
+   ptsBufferMsgT = CpCanMsgFromBuffer(eCP_CHANNEL_2-1,
+                                      &(atsUsartTrmMsgS[eCP_CHANNEL_2-1]),
                                       eCP_BUFFER_DIR_TRM,
                                       &ubBufferIdxT);
 
@@ -1476,6 +1903,10 @@ void CpUsart2TrmHandler(uint8_t *pubDataV, uint32_t ulSizeV)
       atsCpStatisticS[eCP_CHANNEL_2-1].ulTrmMsgCount++;
       #endif
 
+      #if CP_TRM_PRIORITY > 0
+      aulTrmTickS[eCP_CHANNEL_2-1]++;
+      #endif
+
       //--------------------------------------------------------
       // test for transmit callback handler
       //
@@ -1488,34 +1919,15 @@ void CpUsart2TrmHandler(uint8_t *pubDataV, uint32_t ulSizeV)
       }
       else
       {
-         ptsFifoT = aptsFifoS[eCP_CHANNEL_2-1][ubBufferIdxT];
-         if (CpFifoIsEmpty(ptsFifoT) == 0)
-         {
-            ptsFifoMsgT = CpFifoDataOutPtr(ptsFifoT);
-            memcpy(ptsBufferMsgT, ptsFifoMsgT, sizeof(CpCanMsg_ts));
-            CpFifoIncOut(ptsFifoT);
-            ptsFifoMsgT->ulMsgUser |= CP_BUFFER_PND;
-         }
+         CpUsartTrmRefill(eCP_CHANNEL_2-1, ubBufferIdxT, ptsBufferMsgT);
       }
    }
 
    //----------------------------------------------------------------
-   // run through buffer list and test for open Tx requests
+   // test for open Tx requests
    //
-   for (ubBufferIdxT = 0; ubBufferIdxT < CP_BUFFER_MAX; ubBufferIdxT++)
-   {
-      ptsBufferMsgT = &(atsCanMsgS[eCP_CHANNEL_2-1][ubBufferIdxT]);
-      if (((ptsBufferMsgT->ulMsgUser) & CP_BUFFER_PND))
-      {
-         ptsBufferMsgT->ulMsgUser &= ~CP_BUFFER_PND;
-         CpCoreBufferSend(aptsPortS[0], ubBufferIdxT);
-      }
-   }
+   CpUsartTrmPending(eCP_CHANNEL_2-1);
 }
 #endif
 
-//uint32_t CpUsartFrameSize()
-//{
-//   return (uint32_t)sizeof(CpUsartFrame_ts);
-//}
 #endif // MC_USART_PORT_MAX > 0
@@ -0,0 +1,825 @@
+//============================================================================//
+// File:          cp_usart_frame.c                                            //
+// Description:   Frame encoder and decoder for CANpie USART bridge           //
+//                                                                            //
+// Copyright (C) MicroControl GmbH & Co. KG                                   //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Provided that this notice is retained in full, this software may be        //
+// distributed under the terms of the GNU Lesser General Public License       //
+// ("LGPL") version 3 as distributed in the 'LICENSE' file.                   //
+//                                                                            //
+//============================================================================//
+
+
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+#include "cp_usart_frame.h"
+
+#include "string.h"
+
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// position of fields inside a fixed USART frame
+//
+#define  FRAME_POS_TYPE          2
+#define  FRAME_POS_ID            3
+#define  FRAME_POS_CTRL          7
+#define  FRAME_POS_DLC           8
+#define  FRAME_POS_DATA          9
+#define  FRAME_POS_CRC           (FRAME_POS_DATA + CP_DATA_SIZE)
+
+//-------------------------------------------------------------------
+// position of fields inside a version frame, which uses the layout
+// of a fixed USART frame
+//
+#define  FRAME_POS_VERSION       (FRAME_POS_DATA)
+#define  FRAME_POS_REQUEST       (FRAME_POS_DATA + 1)
+
+//-------------------------------------------------------------------
+// position of fields inside a compact USART frame
+//
+#define  COMPACT_POS_DLC         3
+#define  COMPACT_POS_ID          4
+
+//-------------------------------------------------------------------
+// position of fields inside a legacy USART frame
+//
+#define  LEGACY_POS_ID           0
+#define  LEGACY_POS_DATA         4
+#define  LEGACY_POS_DLC          (LEGACY_POS_DATA + CP_DATA_SIZE)
+#define  LEGACY_POS_CTRL         (LEGACY_POS_DLC + 1)
+
+//-------------------------------------------------------------------
+// number of bytes required to calculate the size of a frame
+//
+#define  FRAME_HEADER_SIZE       4
+
+//-------------------------------------------------------------------
+// size of sync pattern and CRC, added to the size of the payload
+//
+#define  FRAME_SYNC_SIZE         2
+#define  FRAME_CRC_SIZE          2
+
+//-------------------------------------------------------------------
+// initial value of CRC-16/CCITT
+//
+#define  FRAME_CRC_INIT          ((uint16_t) 0xFFFF)
+
+
+/*----------------------------------------------------------------------------*\
+** Variables of module                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// lookup table for CRC-16/CCITT, polynomial 0x1021
+//
+static CPP_CONST uint16_t auwCrcTableS[256] =
+{
+   0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+   0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+   0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+   0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+   0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+   0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+   0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+   0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+   0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+   0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+   0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+   0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+   0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+   0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+   0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+   0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+   0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+   0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+   0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+   0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+   0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+   0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+   0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+   0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+   0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+   0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+   0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+   0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+   0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+   0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+   0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+   0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+
+//-------------------------------------------------------------------
+// number of data bytes for a given DLC value of a CAN FD frame
+//
+static CPP_CONST uint8_t aubDlcToSizeS[16] =
+{
+   0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64
+};
+
+
+/*----------------------------------------------------------------------------*\
+** Function implementation                                                    **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//----------------------------------------------------------------------------//
+// FrameCrc()                                                                 //
+// calculate CRC-16/CCITT                                                     //
+//----------------------------------------------------------------------------//
+static uint16_t FrameCrc(CPP_CONST uint8_t *pubDataV, uint32_t ulSizeV)
+{
+   uint16_t uwCrcT = FRAME_CRC_INIT;
+
+   while (ulSizeV > 0)
+   {
+      uwCrcT = (uint16_t) ((uwCrcT << 8) ^
+                           auwCrcTableS[((uwCrcT >> 8) ^ *pubDataV) & 0xFF]);
+      pubDataV++;
+      ulSizeV--;
+   }
+
+   return (uwCrcT);
+}
+
+
+//----------------------------------------------------------------------------//
+// FrameCrcSet()                                                              //
+// append CRC to a frame of ulSizeV bytes (including the CRC)                 //
+//----------------------------------------------------------------------------//
+static void FrameCrcSet(uint8_t *pubFrameV, uint32_t ulSizeV)
+{
+   uint16_t uwCrcT;
+
+   uwCrcT = FrameCrc(&pubFrameV[FRAME_POS_TYPE],
+                     ulSizeV - FRAME_POS_TYPE - FRAME_CRC_SIZE);
+   pubFrameV[ulSizeV - 2] = (uint8_t) (uwCrcT);
+   pubFrameV[ulSizeV - 1] = (uint8_t) (uwCrcT >> 8);
+}
+
+
+//----------------------------------------------------------------------------//
+// FrameDataSize()                                                            //
+// number of data bytes transferred by a compact frame                        //
+//----------------------------------------------------------------------------//
+static uint32_t FrameDataSize(uint8_t ubMsgCtrlV, uint8_t ubMsgDlcV)
+{
+   uint32_t ulSizeT;
+
+   if ((ubMsgCtrlV & CP_MSG_CTRL_RTR_BIT) > 0)
+   {
+      ulSizeT = 0;
+   }
+   else if ((ubMsgCtrlV & CP_MSG_CTRL_FDF_BIT) > 0)
+   {
+      ulSizeT = aubDlcToSizeS[ubMsgDlcV & 0x0F];
+   }
+   else
+   {
+      ulSizeT = (ubMsgDlcV > 8) ? 8 : ubMsgDlcV;
+   }
+
+   return (ulSizeT);
+}
+
+
+//----------------------------------------------------------------------------//
+// FrameTypeToCtrl()                                                          //
+// message control field from the type byte of a compact frame                //
+//----------------------------------------------------------------------------//
+static uint8_t FrameTypeToCtrl(uint8_t ubTypeV)
+{
+   return ((uint8_t) ((ubTypeV & 0x0F) | ((ubTypeV & 0x30) << 2)));
+}
+
+
+//----------------------------------------------------------------------------//
+// FrameSize()                                                                //
+// size of a frame, calculated from the first FRAME_HEADER_SIZE bytes         //
+//----------------------------------------------------------------------------//
+static uint32_t FrameSize(CPP_CONST uint8_t *pubFrameV)
+{
+   uint32_t ulSizeT = 0;
+   uint32_t ulDataSizeT;
+   uint8_t  ubMsgCtrlT;
+
+   if ((pubFrameV[0] == CP_USART_SYNC_0) && (pubFrameV[1] == CP_USART_SYNC_1))
+   {
+      if ((pubFrameV[FRAME_POS_TYPE] == CP_USART_TYPE_CAN) ||
+          (pubFrameV[FRAME_POS_TYPE] == CP_USART_TYPE_VERSION))
+      {
+         ulSizeT = CP_USART_FRAME_SIZE;
+      }
+      else if ((pubFrameV[FRAME_POS_TYPE] & 0xC0) == CP_USART_TYPE_COMPACT)
+      {
+         //--------------------------------------------------------
+         // a compact frame is only valid if the data fits into
+         // the CAN message structure
+         //
+         ubMsgCtrlT  = FrameTypeToCtrl(pubFrameV[FRAME_POS_TYPE]);
+         ulDataSizeT = FrameDataSize(ubMsgCtrlT, pubFrameV[COMPACT_POS_DLC]);
+         if ((pubFrameV[COMPACT_POS_DLC] <= 15) && (ulDataSizeT <= CP_DATA_SIZE))
+         {
+            ulSizeT = COMPACT_POS_ID + ulDataSizeT + FRAME_CRC_SIZE;
+            ulSizeT += ((ubMsgCtrlT & CP_MSG_CTRL_EXT_BIT) > 0) ? 4 : 2;
+         }
+      }
+   }
+
+   return (ulSizeT);
+}
+
+
+//----------------------------------------------------------------------------//
+// FrameIsValid()                                                             //
+// test CRC and DLC of a complete frame                                       //
+//----------------------------------------------------------------------------//
+static bool_t FrameIsValid(CPP_CONST uint8_t *pubFrameV, uint32_t ulSizeV)
+{
+   bool_t   btResultT = false;
+   uint16_t uwCrcT;
+
+   if ((pubFrameV[FRAME_POS_TYPE] & CP_USART_TYPE_COMPACT) ||
+       (pubFrameV[FRAME_POS_DLC] <= 15))
+   {
+      uwCrcT = (uint16_t) (pubFrameV[ulSizeV - 2]) |
+               (uint16_t) (pubFrameV[ulSizeV - 1] << 8);
+
+      if (FrameCrc(&pubFrameV[FRAME_POS_TYPE],
+                   ulSizeV - FRAME_POS_TYPE - FRAME_CRC_SIZE) == uwCrcT)
+      {
+         btResultT = true;
+      }
+   }
+
+   return (btResultT);
+}
+
+
+//----------------------------------------------------------------------------//
+// FrameToCanMsg()                                                            //
+// copy fields of a valid fixed frame into CAN message                        //
+//----------------------------------------------------------------------------//
+static void FrameToCanMsg(CPP_CONST uint8_t *pubFrameV, CpCanMsg_ts *ptsCanMsgV)
+{
+   memset(ptsCanMsgV, 0x00, sizeof(CpCanMsg_ts));
+
+   ptsCanMsgV->ulIdentifier = ((uint32_t) pubFrameV[FRAME_POS_ID])           |
+                              ((uint32_t) pubFrameV[FRAME_POS_ID + 1] <<  8) |
+                              ((uint32_t) pubFrameV[FRAME_POS_ID + 2] << 16) |
+                              ((uint32_t) pubFrameV[FRAME_POS_ID + 3] << 24);
+   ptsCanMsgV->ubMsgCtrl    = pubFrameV[FRAME_POS_CTRL];
+   ptsCanMsgV->ubMsgDLC     = pubFrameV[FRAME_POS_DLC];
+   memcpy(&(ptsCanMsgV->tuMsgData.aubByte[0]), &pubFrameV[FRAME_POS_DATA],
+          CP_DATA_SIZE);
+}
+
+
+//----------------------------------------------------------------------------//
+// CompactToCanMsg()                                                          //
+// copy fields of a valid compact frame into CAN message                      //
+//----------------------------------------------------------------------------//
+static void CompactToCanMsg(CPP_CONST uint8_t *pubFrameV, CpCanMsg_ts *ptsCanMsgV)
+{
+   uint32_t ulPosT = COMPACT_POS_ID + 2;
+
+   memset(ptsCanMsgV, 0x00, sizeof(CpCanMsg_ts));
+
+   ptsCanMsgV->ubMsgCtrl    = FrameTypeToCtrl(pubFrameV[FRAME_POS_TYPE]);
+   ptsCanMsgV->ubMsgDLC     = pubFrameV[COMPACT_POS_DLC];
+   ptsCanMsgV->ulIdentifier = ((uint32_t) pubFrameV[COMPACT_POS_ID])     |
+                              ((uint32_t) pubFrameV[COMPACT_POS_ID + 1] << 8);
+   if ((ptsCanMsgV->ubMsgCtrl & CP_MSG_CTRL_EXT_BIT) > 0)
+   {
+      ptsCanMsgV->ulIdentifier |= ((uint32_t) pubFrameV[ulPosT]     << 16) |
+                                  ((uint32_t) pubFrameV[ulPosT + 1] << 24);
+      ulPosT += 2;
+   }
+   memcpy(&(ptsCanMsgV->tuMsgData.aubByte[0]), &pubFrameV[ulPosT],
+          FrameDataSize(ptsCanMsgV->ubMsgCtrl, ptsCanMsgV->ubMsgDLC));
+}
+
+
+//----------------------------------------------------------------------------//
+// FrameAccept()                                                              //
+// evaluate a valid frame, return the number of CAN messages                  //
+//----------------------------------------------------------------------------//
+static uint32_t FrameAccept(CpUsartDecoder_ts *ptsDecoderV,
+                            CPP_CONST uint8_t *pubFrameV,
+                            CpCanMsg_ts *ptsCanMsgV)
+{
+   uint32_t ulMsgCntT = 1;
+
+   if (pubFrameV[FRAME_POS_TYPE] == CP_USART_TYPE_VERSION)
+   {
+      //--------------------------------------------------------
+      // the peer announces the highest protocol version it
+      // is able to decode
+      //
+      ptsDecoderV->ubPeerVersion = pubFrameV[FRAME_POS_VERSION];
+      if (pubFrameV[FRAME_POS_REQUEST] > 0)
+      {
+         ptsDecoderV->ubReplyPending = 1;
+      }
+      ulMsgCntT = 0;
+   }
+   else if (pubFrameV[FRAME_POS_TYPE] == CP_USART_TYPE_CAN)
+   {
+      FrameToCanMsg(pubFrameV, ptsCanMsgV);
+   }
+   else
+   {
+      CompactToCanMsg(pubFrameV, ptsCanMsgV);
+   }
+
+   ptsDecoderV->ulFrameCount++;
+
+   return (ulMsgCntT);
+}
+
+
+//----------------------------------------------------------------------------//
+// FindSync()                                                                 //
+// return offset of first possible sync byte, ulSizeV if there is none        //
+//----------------------------------------------------------------------------//
+static uint32_t FindSync(CPP_CONST uint8_t *pubDataV, uint32_t ulSizeV)
+{
+   CPP_CONST uint8_t *pubSyncT;
+
+   pubSyncT = (CPP_CONST uint8_t *) memchr(pubDataV, CP_USART_SYNC_0, ulSizeV);
+   if (pubSyncT == CPP_NULL)
+   {
+      return (ulSizeV);
+   }
+
+   return ((uint32_t) (pubSyncT - pubDataV));
+}
+
+
+//----------------------------------------------------------------------------//
+// DecoderResync()                                                            //
+// keep the buffered bytes starting at the next sync byte                     //
+//----------------------------------------------------------------------------//
+static void DecoderResync(CpUsartDecoder_ts *ptsDecoderV)
+{
+   uint32_t ulSkipT;
+
+   ulSkipT = 1 + FindSync(&(ptsDecoderV->aubBuffer[1]), ptsDecoderV->ulCount - 1);
+   ptsDecoderV->ulDropCount += ulSkipT;
+   ptsDecoderV->ulCount     -= ulSkipT;
+   memmove(&(ptsDecoderV->aubBuffer[0]), &(ptsDecoderV->aubBuffer[ulSkipT]),
+           ptsDecoderV->ulCount);
+}
+
+
+//----------------------------------------------------------------------------//
+// DecoderPending()                                                           //
+// test if the decoder buffer holds a complete frame or an invalid header     //
+//----------------------------------------------------------------------------//
+static bool_t DecoderPending(CpUsartDecoder_ts *ptsDecoderV)
+{
+   uint32_t ulFrameSizeT;
+
+   if (ptsDecoderV->ulCount < FRAME_HEADER_SIZE)
+   {
+      return (false);
+   }
+
+   ulFrameSizeT = FrameSize(&(ptsDecoderV->aubBuffer[0]));
+
+   return ((ulFrameSizeT == 0) || (ptsDecoderV->ulCount >= ulFrameSizeT));
+}
+
+
+//----------------------------------------------------------------------------//
+// LegacyDecode()                                                             //
+// decode legacy frames, which are cut from the byte stream by size only      //
+//----------------------------------------------------------------------------//
+static uint32_t LegacyDecode(CpUsartDecoder_ts *ptsDecoderV,
+                             CPP_CONST uint8_t *pubDataV, uint32_t ulSizeV,
+                             uint32_t *pulUsedV,
+                             CpCanMsg_ts *ptsCanMsgV, uint32_t ulMsgMaxV)
+{
+   CPP_CONST uint8_t *pubFrameT;
+   uint32_t ulPosT    = 0;
+   uint32_t ulMsgCntT = 0;
+   uint32_t ulCopyT;
+
+   while ((ulPosT < ulSizeV) && (ulMsgCntT < ulMsgMaxV))
+   {
+      //--------------------------------------------------------
+      // a complete frame is decoded in place, otherwise it is
+      // collected inside the decoder buffer
+      //
+      if ((ptsDecoderV->ulCount == 0) &&
+          ((ulSizeV - ulPosT) >= CP_USART_LEGACY_SIZE))
+      {
+         pubFrameT = &pubDataV[ulPosT];
+         ulPosT   += CP_USART_LEGACY_SIZE;
+      }
+      else
+      {
+         ulCopyT = CP_USART_LEGACY_SIZE - ptsDecoderV->ulCount;
+         if (ulCopyT > (ulSizeV - ulPosT))
+         {
+            ulCopyT = ulSizeV - ulPosT;
+         }
+         memcpy(&(ptsDecoderV->aubBuffer[ptsDecoderV->ulCount]),
+                &pubDataV[ulPosT], ulCopyT);
+         ptsDecoderV->ulCount += ulCopyT;
+         ulPosT += ulCopyT;
+
+         if (ptsDecoderV->ulCount < CP_USART_LEGACY_SIZE)
+         {
+            break;
+         }
+         ptsDecoderV->ulCount = 0;
+         pubFrameT = &(ptsDecoderV->aubBuffer[0]);
+      }
+
+      memset(ptsCanMsgV, 0x00, sizeof(CpCanMsg_ts));
+      ptsCanMsgV->ulIdentifier = ((uint32_t) pubFrameT[LEGACY_POS_ID])           |
+                                 ((uint32_t) pubFrameT[LEGACY_POS_ID + 1] <<  8) |
+                                 ((uint32_t) pubFrameT[LEGACY_POS_ID + 2] << 16) |
+                                 ((uint32_t) pubFrameT[LEGACY_POS_ID + 3] << 24);
+      ptsCanMsgV->ubMsgDLC     = pubFrameT[LEGACY_POS_DLC];
+      ptsCanMsgV->ubMsgCtrl    = pubFrameT[LEGACY_POS_CTRL];
+      memcpy(&(ptsCanMsgV->tuMsgData.aubByte[0]), &pubFrameT[LEGACY_POS_DATA],
+             CP_DATA_SIZE);
+
+      ptsDecoderV->ulFrameCount++;
+      ptsCanMsgV++;
+      ulMsgCntT++;
+   }
+
+   if (pulUsedV != CPP_NULL)
+   {
+      *pulUsedV = ulPosT;
+   }
+
+   return (ulMsgCntT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartDecoderInit()                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void CpUsartDecoderInit(CpUsartDecoder_ts *ptsDecoderV)
+{
+   ptsDecoderV->ulCount        = 0;
+   ptsDecoderV->ulFrameCount   = 0;
+   ptsDecoderV->ulErrorCount   = 0;
+   ptsDecoderV->ulDropCount    = 0;
+   ptsDecoderV->ubPeerVersion  = 0;
+   ptsDecoderV->ubReplyPending = 0;
+   ptsDecoderV->ubLegacy       = 0;
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartFrameDecode()                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint32_t CpUsartFrameDecode(CpUsartDecoder_ts *ptsDecoderV,
+                            CPP_CONST uint8_t *pubDataV, uint32_t ulSizeV,
+                            uint32_t *pulUsedV,
+                            CpCanMsg_ts *ptsCanMsgV, uint32_t ulMsgMaxV)
+{
+   uint32_t ulPosT    = 0;
+   uint32_t ulMsgCntT = 0;
+   uint32_t ulFrameSizeT;
+   uint32_t ulCopyT;
+   uint32_t ulSkipT;
+
+   if (ptsDecoderV->ubLegacy > 0)
+   {
+      return (LegacyDecode(ptsDecoderV, pubDataV, ulSizeV, pulUsedV,
+                           ptsCanMsgV, ulMsgMaxV));
+   }
+
+   //----------------------------------------------------------------
+   // after a resynchronisation the decoder buffer may already hold
+   // complete frames, they are evaluated without further data
+   //
+   while (((ulPosT < ulSizeV) || DecoderPending(ptsDecoderV)) &&
+          (ulMsgCntT < ulMsgMaxV))
+   {
+      if (ptsDecoderV->ulCount == 0)
+      {
+         //--------------------------------------------------------
+         // hunt for the start of a frame
+         //
+         ulSkipT = FindSync(&pubDataV[ulPosT], ulSizeV - ulPosT);
+         ptsDecoderV->ulDropCount += ulSkipT;
+         ulPosT += ulSkipT;
+         if (ulPosT == ulSizeV)
+         {
+            break;
+         }
+
+         //--------------------------------------------------------
+         // a complete frame is decoded in place, without copying
+         // it to the decoder buffer
+         //
+         if ((ulSizeV - ulPosT) >= FRAME_HEADER_SIZE)
+         {
+            ulFrameSizeT = FrameSize(&pubDataV[ulPosT]);
+            if (ulFrameSizeT == 0)
+            {
+               ptsDecoderV->ulDropCount++;
+               ulPosT++;
+               continue;
+            }
+
+            if ((ulSizeV - ulPosT) >= ulFrameSizeT)
+            {
+               if (FrameIsValid(&pubDataV[ulPosT], ulFrameSizeT))
+               {
+                  ulCopyT = FrameAccept(ptsDecoderV, &pubDataV[ulPosT],
+                                        ptsCanMsgV);
+                  ptsCanMsgV += ulCopyT;
+                  ulMsgCntT  += ulCopyT;
+                  ulPosT     += ulFrameSizeT;
+               }
+               else
+               {
+                  //----------------------------------------
+                  // resynchronise with the next byte
+                  //
+                  ptsDecoderV->ulErrorCount++;
+                  ptsDecoderV->ulDropCount++;
+                  ulPosT++;
+               }
+               continue;
+            }
+         }
+      }
+
+      //----------------------------------------------------------------
+      // complete the header inside the decoder buffer first, it
+      // defines the size of the frame
+      //
+      ulFrameSizeT = FRAME_HEADER_SIZE;
+      if (ptsDecoderV->ulCount >= FRAME_HEADER_SIZE)
+      {
+         ulFrameSizeT = FrameSize(&(ptsDecoderV->aubBuffer[0]));
+         if (ulFrameSizeT == 0)
+         {
+            DecoderResync(ptsDecoderV);
+            continue;
+         }
+      }
+
+      //----------------------------------------------------------------
+      // a resynchronisation onto a shorter frame leaves more bytes
+      // in the buffer than the frame size, the frame is evaluated
+      // without copying further data
+      //
+      if (ptsDecoderV->ulCount < ulFrameSizeT)
+      {
+         ulCopyT = ulFrameSizeT - ptsDecoderV->ulCount;
+         if (ulCopyT > (ulSizeV - ulPosT))
+         {
+            ulCopyT = ulSizeV - ulPosT;
+         }
+         memcpy(&(ptsDecoderV->aubBuffer[ptsDecoderV->ulCount]),
+                &pubDataV[ulPosT], ulCopyT);
+         ptsDecoderV->ulCount += ulCopyT;
+         ulPosT += ulCopyT;
+
+         if ((ptsDecoderV->ulCount < ulFrameSizeT) ||
+             (ptsDecoderV->ulCount == FRAME_HEADER_SIZE))
+         {
+            //------------------------------------------------
+            // wait for more data, or evaluate the header which
+            // has been completed right now
+            //
+            continue;
+         }
+      }
+
+      if (FrameIsValid(&(ptsDecoderV->aubBuffer[0]), ulFrameSizeT))
+      {
+         ulCopyT = FrameAccept(ptsDecoderV, &(ptsDecoderV->aubBuffer[0]),
+                               ptsCanMsgV);
+         ptsCanMsgV += ulCopyT;
+         ulMsgCntT  += ulCopyT;
+
+         //--------------------------------------------------------
+         // carry the remaining bytes over to the next frame
+         //
+         ptsDecoderV->ulCount -= ulFrameSizeT;
+         memmove(&(ptsDecoderV->aubBuffer[0]),
+                 &(ptsDecoderV->aubBuffer[ulFrameSizeT]),
+                 ptsDecoderV->ulCount);
+      }
+      else
+      {
+         ptsDecoderV->ulErrorCount++;
+         DecoderResync(ptsDecoderV);
+      }
+   }
+
+   if (pulUsedV != CPP_NULL)
+   {
+      *pulUsedV = ulPosT;
+   }
+
+   return (ulMsgCntT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartFrameEncode()                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint32_t CpUsartFrameEncode(CPP_CONST CpCanMsg_ts *ptsCanMsgV,
+                            uint8_t ubVersionV, uint8_t *pubBufferV)
+{
+   uint32_t ulSizeT;
+   uint32_t ulDataSizeT;
+   uint8_t  ubMsgCtrlT;
+
+   pubBufferV[0] = CP_USART_SYNC_0;
+   pubBufferV[1] = CP_USART_SYNC_1;
+
+   if (ubVersionV < CP_USART_VERSION_COMPACT)
+   {
+      //--------------------------------------------------------
+      // fixed frame, understood by every peer
+      //
+      pubBufferV[FRAME_POS_TYPE]   = CP_USART_TYPE_CAN;
+      pubBufferV[FRAME_POS_ID]     = (uint8_t) (ptsCanMsgV->ulIdentifier);
+      pubBufferV[FRAME_POS_ID + 1] = (uint8_t) (ptsCanMsgV->ulIdentifier >>  8);
+      pubBufferV[FRAME_POS_ID + 2] = (uint8_t) (ptsCanMsgV->ulIdentifier >> 16);
+      pubBufferV[FRAME_POS_ID + 3] = (uint8_t) (ptsCanMsgV->ulIdentifier >> 24);
+      pubBufferV[FRAME_POS_CTRL]   = ptsCanMsgV->ubMsgCtrl;
+      pubBufferV[FRAME_POS_DLC]    = ptsCanMsgV->ubMsgDLC;
+      memcpy(&pubBufferV[FRAME_POS_DATA], &(ptsCanMsgV->tuMsgData.aubByte[0]),
+             CP_DATA_SIZE);
+      ulSizeT = CP_USART_FRAME_SIZE;
+   }
+   else
+   {
+      //--------------------------------------------------------
+      // compact frame: the upper identifier bytes are only sent
+      // for extended frames and only the used data bytes follow
+      //
+      ubMsgCtrlT  = ptsCanMsgV->ubMsgCtrl & (CP_MSG_CTRL_EXT_BIT |
+                                             CP_MSG_CTRL_FDF_BIT |
+                                             CP_MSG_CTRL_RTR_BIT |
+                                             CP_MSG_CTRL_OVR_BIT |
+                                             CP_MSG_CTRL_BRS_BIT |
+                                             CP_MSG_CTRL_ESI_BIT);
+      ulDataSizeT = FrameDataSize(ubMsgCtrlT, ptsCanMsgV->ubMsgDLC & 0x0F);
+      if (ulDataSizeT > CP_DATA_SIZE)
+      {
+         ulDataSizeT = CP_DATA_SIZE;
+      }
+
+      pubBufferV[FRAME_POS_TYPE]     = (uint8_t) (CP_USART_TYPE_COMPACT |
+                                                  (ubMsgCtrlT & 0x0F) |
+                                                  ((ubMsgCtrlT & 0xC0) >> 2));
+      pubBufferV[COMPACT_POS_DLC]    = ptsCanMsgV->ubMsgDLC & 0x0F;
+      pubBufferV[COMPACT_POS_ID]     = (uint8_t) (ptsCanMsgV->ulIdentifier);
+      pubBufferV[COMPACT_POS_ID + 1] = (uint8_t) (ptsCanMsgV->ulIdentifier >> 8);
+      ulSizeT = COMPACT_POS_ID + 2;
+      if ((ubMsgCtrlT & CP_MSG_CTRL_EXT_BIT) > 0)
+      {
+         pubBufferV[ulSizeT]     = (uint8_t) (ptsCanMsgV->ulIdentifier >> 16);
+         pubBufferV[ulSizeT + 1] = (uint8_t) (ptsCanMsgV->ulIdentifier >> 24);
+         ulSizeT += 2;
+      }
+      memcpy(&pubBufferV[ulSizeT], &(ptsCanMsgV->tuMsgData.aubByte[0]),
+             ulDataSizeT);
+      ulSizeT += ulDataSizeT + FRAME_CRC_SIZE;
+   }
+
+   FrameCrcSet(pubBufferV, ulSizeT);
+
+   return (ulSizeT);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartFrameSize()                                                         //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint32_t CpUsartFrameSize(CPP_CONST uint8_t *pubFrameV, uint32_t ulSizeV)
+{
+   if (ulSizeV < FRAME_HEADER_SIZE)
+   {
+      return (0);
+   }
+
+   return (FrameSize(pubFrameV));
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartFrameIsVersion()                                                    //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool_t CpUsartFrameIsVersion(CPP_CONST uint8_t *pubFrameV, uint32_t ulSizeV)
+{
+   if ((pubFrameV != CPP_NULL) && (ulSizeV == CP_USART_FRAME_SIZE) &&
+       (pubFrameV[FRAME_POS_TYPE] == CP_USART_TYPE_VERSION))
+   {
+      return (true);
+   }
+
+   return (false);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartLegacyEncode()                                                      //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint32_t CpUsartLegacyEncode(CPP_CONST CpCanMsg_ts *ptsCanMsgV,
+                             uint8_t *pubBufferV)
+{
+   pubBufferV[LEGACY_POS_ID]     = (uint8_t) (ptsCanMsgV->ulIdentifier);
+   pubBufferV[LEGACY_POS_ID + 1] = (uint8_t) (ptsCanMsgV->ulIdentifier >>  8);
+   pubBufferV[LEGACY_POS_ID + 2] = (uint8_t) (ptsCanMsgV->ulIdentifier >> 16);
+   pubBufferV[LEGACY_POS_ID + 3] = (uint8_t) (ptsCanMsgV->ulIdentifier >> 24);
+   memcpy(&pubBufferV[LEGACY_POS_DATA], &(ptsCanMsgV->tuMsgData.aubByte[0]),
+          CP_DATA_SIZE);
+   pubBufferV[LEGACY_POS_DLC]    = ptsCanMsgV->ubMsgDLC;
+   pubBufferV[LEGACY_POS_CTRL]   = ptsCanMsgV->ubMsgCtrl;
+
+   return (CP_USART_LEGACY_SIZE);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartVersionEncode()                                                     //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint32_t CpUsartVersionEncode(uint8_t ubRequestV, uint8_t *pubBufferV)
+{
+   memset(pubBufferV, 0x00, CP_USART_FRAME_SIZE);
+
+   pubBufferV[0]                 = CP_USART_SYNC_0;
+   pubBufferV[1]                 = CP_USART_SYNC_1;
+   pubBufferV[FRAME_POS_TYPE]    = CP_USART_TYPE_VERSION;
+   pubBufferV[FRAME_POS_VERSION] = CP_USART_VERSION;
+   pubBufferV[FRAME_POS_REQUEST] = ubRequestV;
+
+   FrameCrcSet(pubBufferV, CP_USART_FRAME_SIZE);
+
+   return (CP_USART_FRAME_SIZE);
+}
+
+
+//----------------------------------------------------------------------------//
+// CpUsartVersionSelect()                                                     //
+//                                                                            //
+//----------------------------------------------------------------------------//
+uint8_t CpUsartVersionSelect(CPP_CONST CpUsartDecoder_ts *ptsDecoderV)
+{
+   //----------------------------------------------------------------
+   // a peer which never announced a version only understands
+   // fixed frames
+   //
+   if (ptsDecoderV->ubPeerVersion < CP_USART_VERSION_FIXED)
+   {
+      return (CP_USART_VERSION_FIXED);
+   }
+
+   if (ptsDecoderV->ubPeerVersion > CP_USART_VERSION)
+   {
+      return (CP_USART_VERSION);
+   }
+
+   return (ptsDecoderV->ubPeerVersion);
+}
+
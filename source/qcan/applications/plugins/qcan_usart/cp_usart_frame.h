@@ -0,0 +1,356 @@
+//============================================================================//
+// File:          cp_usart_frame.h                                            //
+// Description:   Frame encoder and decoder for CANpie USART bridge           //
+//                                                                            //
+// Copyright (C) MicroControl GmbH & Co. KG                                   //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Provided that this notice is retained in full, this software may be        //
+// distributed under the terms of the GNU Lesser General Public License       //
+// ("LGPL") version 3 as distributed in the 'LICENSE' file.                   //
+//                                                                            //
+//============================================================================//
+
+
+
+#ifndef  CP_USART_FRAME_H_
+#define  CP_USART_FRAME_H_
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+#include "canpie.h"
+
+
+//-----------------------------------------------------------------------------
+/*!
+** \file    cp_usart_frame.h
+** \brief   Frame encoder and decoder for CANpie USART bridge
+**
+** A serial link delivers a byte stream in chunks of arbitrary size, so
+** CAN messages are transferred inside frames which can be detected and
+** checked by the receiver:
+**
+** | Offset | Size          | Content                                |
+** |--------|---------------|----------------------------------------|
+** | 0      | 2             | Sync bytes #CP_USART_SYNC_0, #CP_USART_SYNC_1 |
+** | 2      | 1             | Frame type, #CP_USART_TYPE_CAN         |
+** | 3      | 4             | Identifier (little endian)             |
+** | 7      | 1             | Message control field                  |
+** | 8      | 1             | Data length code                       |
+** | 9      | #CP_DATA_SIZE | Data                                   |
+** | 9 + #CP_DATA_SIZE | 2  | CRC-16/CCITT (little endian)           |
+**
+** The CRC covers all bytes starting at the frame type. The decoder
+** CpUsartFrameDecode() accepts partial as well as coalesced frames and
+** resynchronises on the next sync pattern after a CRC error.
+**
+** Since protocol version #CP_USART_VERSION_COMPACT a CAN message can be
+** sent as compact frame, which omits all bytes that are not used:
+**
+** | Offset | Size          | Content                                |
+** |--------|---------------|----------------------------------------|
+** | 0      | 2             | Sync bytes #CP_USART_SYNC_0, #CP_USART_SYNC_1 |
+** | 2      | 1             | #CP_USART_TYPE_COMPACT, control bits   |
+** | 3      | 1             | Data length code                       |
+** | 4      | 2 or 4        | Identifier (little endian), 4 bytes for extended frames |
+** | 6 / 8  | 0 .. 64       | Data bytes defined by the DLC, none for remote frames |
+** | n - 2  | 2             | CRC-16/CCITT (little endian)           |
+**
+** Bits 0 .. 3 of the type byte hold the EXT, FDF, RTR and OVR bits of
+** the message control field, bits 4 and 5 hold the BRS and ESI bits.
+** A classic frame with standard identifier and 8 data bytes takes 16
+** instead of 19 bytes, a CAN FD frame with 8 data bytes takes 16 instead
+** of 75 bytes.
+**
+** A peer is only sent compact frames after it has announced support by a
+** version frame (#CP_USART_TYPE_VERSION), so a peer which decodes fixed
+** frames with sync pattern and CRC only keeps on receiving fixed frames.
+** The decoder always accepts both formats.
+**
+** A peer running a firmware that still exchanges the plain CAN message
+** structure without sync pattern and CRC can not be detected reliably,
+** because such a firmware misinterprets the version request. The legacy
+** format is therefore selected explicitly: the driver is initialised
+** with #CP_USART_CONFIG_LEGACY, which the USART plugin passes when the
+** option "Legacy frames" is checked in its configuration dialog. The
+** decoder and CpUsartLegacyEncode() then use the legacy layout, which
+** has a fixed size of #CP_USART_LEGACY_SIZE bytes:
+**
+** | Offset            | Size          | Content                          |
+** |-------------------|---------------|----------------------------------|
+** | 0                 | 4             | Identifier (little endian)       |
+** | 4                 | #CP_DATA_SIZE | Data                             |
+** | 4 + #CP_DATA_SIZE | 1             | Data length code                 |
+** | 5 + #CP_DATA_SIZE | 1             | Message control field            |
+**
+** Legacy frames can not be resynchronised, both sides have to start with
+** an empty serial line. No version frames are exchanged in this mode.
+*/
+
+
+//-------------------------------------------------------------------//
+// take precautions if compiled with C++ compiler                    //
+#ifdef __cplusplus                                                   //
+extern "C" {                                                         //
+#endif                                                               //
+//-------------------------------------------------------------------//
+
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+/*!
+** \def  CP_USART_SYNC_0
+** First sync byte of a USART frame
+*/
+#define  CP_USART_SYNC_0         ((uint8_t) 0xA5)
+
+/*!
+** \def  CP_USART_SYNC_1
+** Second sync byte of a USART frame
+*/
+#define  CP_USART_SYNC_1         ((uint8_t) 0x5A)
+
+/*!
+** \def  CP_USART_TYPE_CAN
+** Frame type for a CAN message
+*/
+#define  CP_USART_TYPE_CAN       ((uint8_t) 0x01)
+
+/*!
+** \def  CP_USART_TYPE_VERSION
+** Frame type for a protocol version announcement, the frame uses the layout
+** of a fixed frame with the supported version in the first data byte and a
+** reply request flag in the second data byte
+*/
+#define  CP_USART_TYPE_VERSION   ((uint8_t) 0x02)
+
+/*!
+** \def  CP_USART_TYPE_COMPACT
+** Frame type for a CAN message in compact format, the lower 6 bits carry
+** the message control bits
+*/
+#define  CP_USART_TYPE_COMPACT   ((uint8_t) 0x80)
+
+/*!
+** \def  CP_USART_VERSION_FIXED
+** Protocol version with fixed frames only
+*/
+#define  CP_USART_VERSION_FIXED     ((uint8_t) 1)
+
+/*!
+** \def  CP_USART_VERSION_COMPACT
+** Protocol version with support of compact frames
+*/
+#define  CP_USART_VERSION_COMPACT   ((uint8_t) 2)
+
+/*!
+** \def  CP_USART_VERSION
+** Highest protocol version supported by this implementation
+*/
+#define  CP_USART_VERSION           CP_USART_VERSION_COMPACT
+
+/*!
+** \def  CP_USART_FRAME_SIZE
+** Size of a fixed USART frame in bytes, which is also the maximum size
+** of any USART frame
+*/
+#define  CP_USART_FRAME_SIZE     ((uint32_t) (11 + CP_DATA_SIZE))
+
+/*!
+** \def  CP_USART_LEGACY_SIZE
+** Size of a legacy USART frame in bytes, which is the plain CAN message
+** structure exchanged by older firmware
+*/
+#define  CP_USART_LEGACY_SIZE    ((uint32_t) (6 + CP_DATA_SIZE))
+
+/*!
+** \def  CP_USART_CONFIG_LEGACY
+** Configuration flag for CpCoreDriverInit() of the USART driver, which
+** selects the legacy format without sync pattern and CRC
+*/
+#define  CP_USART_CONFIG_LEGACY  ((uint8_t) 0x01)
+
+
+/*----------------------------------------------------------------------------*\
+** Structures                                                                 **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+/*----------------------------------------------------------------------------*/
+/*!
+** \struct  CpUsartDecoder_s
+** \brief   State of USART frame decoder
+**
+** This structure is initialised by CpUsartDecoderInit().
+*/
+typedef struct CpUsartDecoder_s
+{
+   /*! Bytes of an incomplete frame
+   */
+   uint8_t  aubBuffer[CP_USART_FRAME_SIZE];
+
+   /*! Number of bytes stored in aubBuffer
+   */
+   uint32_t ulCount;
+
+   /*! Number of frames decoded successfully
+   */
+   uint32_t ulFrameCount;
+
+   /*! Number of frames discarded because of a CRC or format error
+   */
+   uint32_t ulErrorCount;
+
+   /*! Number of bytes skipped while searching for the sync pattern
+   */
+   uint32_t ulDropCount;
+
+   /*! Protocol version announced by the peer, 0 if unknown
+   */
+   uint8_t  ubPeerVersion;
+
+   /*! The peer requested a version frame as reply
+   */
+   uint8_t  ubReplyPending;
+
+   /*! Frames use the legacy format, see #CP_USART_LEGACY_SIZE
+   */
+   uint8_t  ubLegacy;
+
+} CpUsartDecoder_ts;
+
+
+/*----------------------------------------------------------------------------*\
+** Function prototypes                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+/*!
+** \brief   Initialise USART frame decoder
+** \param   ptsDecoderV - Pointer to decoder
+**
+** The function discards any incomplete frame and clears all counters.
+** The format is set to framing with sync pattern and CRC.
+*/
+void     CpUsartDecoderInit(CpUsartDecoder_ts *ptsDecoderV);
+
+
+/*!
+** \brief   Decode CAN messages from received bytes
+** \param   ptsDecoderV - Pointer to decoder
+** \param   pubDataV    - Pointer to received bytes
+** \param   ulSizeV     - Number of received bytes
+** \param   pulUsedV    - Number of bytes consumed by the decoder
+** \param   ptsCanMsgV  - Pointer to array of CAN messages
+** \param   ulMsgMaxV   - Size of the CAN message array
+** \return  Number of CAN messages stored in \a ptsCanMsgV
+**
+** The function consumes bytes from \a pubDataV until either all bytes
+** are processed or \a ulMsgMaxV CAN messages have been decoded. The number
+** of consumed bytes is returned via \a pulUsedV, so the caller has to
+** repeat the call with the remaining bytes if it is less than \a ulSizeV.
+** An incomplete frame at the end of \a pubDataV is kept inside the decoder
+** and completed by the next call. Version frames are evaluated by the
+** decoder and do not produce a CAN message. If the member ubLegacy of
+** the decoder is set, the bytes are decoded as legacy frames.
+*/
+uint32_t CpUsartFrameDecode(CpUsartDecoder_ts *ptsDecoderV,
+                            CPP_CONST uint8_t *pubDataV, uint32_t ulSizeV,
+                            uint32_t *pulUsedV,
+                            CpCanMsg_ts *ptsCanMsgV, uint32_t ulMsgMaxV);
+
+
+/*!
+** \brief   Encode CAN message into USART frame
+** \param   ptsCanMsgV  - Pointer to CAN message
+** \param   ubVersionV  - Protocol version, see CpUsartVersionSelect()
+** \param   pubBufferV  - Pointer to buffer of at least #CP_USART_FRAME_SIZE
+**                        bytes
+** \return  Number of bytes written to \a pubBufferV
+**
+** A compact frame is generated if \a ubVersionV is
+** #CP_USART_VERSION_COMPACT or higher, otherwise a fixed frame.
+*/
+uint32_t CpUsartFrameEncode(CPP_CONST CpCanMsg_ts *ptsCanMsgV,
+                            uint8_t ubVersionV, uint8_t *pubBufferV);
+
+
+/*!
+** \brief   Get size of an encoded USART frame
+** \param   pubFrameV   - Pointer to start of frame
+** \param   ulSizeV     - Number of valid bytes at \a pubFrameV
+** \return  Size of frame in bytes, 0 if the header is not valid
+*/
+uint32_t CpUsartFrameSize(CPP_CONST uint8_t *pubFrameV, uint32_t ulSizeV);
+
+
+/*!
+** \brief   Test for version frame
+** \param   pubFrameV   - Pointer to start of frame
+** \param   ulSizeV     - Size of frame
+** \return  true if the frame is a version frame
+*/
+bool_t   CpUsartFrameIsVersion(CPP_CONST uint8_t *pubFrameV, uint32_t ulSizeV);
+
+
+/*!
+** \brief   Encode CAN message into legacy USART frame
+** \param   ptsCanMsgV  - Pointer to CAN message
+** \param   pubBufferV  - Pointer to buffer of at least #CP_USART_LEGACY_SIZE
+**                        bytes
+** \return  Number of bytes written to \a pubBufferV
+*/
+uint32_t CpUsartLegacyEncode(CPP_CONST CpCanMsg_ts *ptsCanMsgV,
+                             uint8_t *pubBufferV);
+
+
+/*!
+** \brief   Encode version frame
+** \param   ubRequestV  - Value 1 requests a version frame as reply
+** \param   pubBufferV  - Pointer to buffer of at least #CP_USART_FRAME_SIZE
+**                        bytes
+** \return  Number of bytes written to \a pubBufferV
+**
+** The version frame announces #CP_USART_VERSION to the peer.
+*/
+uint32_t CpUsartVersionEncode(uint8_t ubRequestV, uint8_t *pubBufferV);
+
+
+/*!
+** \brief   Select protocol version for transmission
+** \param   ptsDecoderV - Pointer to decoder of the receive direction
+** \return  Protocol version supported by both sides
+*/
+uint8_t  CpUsartVersionSelect(CPP_CONST CpUsartDecoder_ts *ptsDecoderV);
+
+
+//-------------------------------------------------------------------//
+#ifdef __cplusplus                                                   //
+}                                                                    //
+#endif                                                               //
+// end of C++ compiler wrapper                                       //
+//-------------------------------------------------------------------//
+
+
+#endif   // CP_USART_FRAME_H_
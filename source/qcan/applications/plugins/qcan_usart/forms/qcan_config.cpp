@@ -96,6 +96,11 @@ QCanConfig::QCanConfig(QCanUsart::QCanUsartConfig_ts &tsConfigurationR, QWidget
    clStringListT << "Rx & Tx OFF" << "Only Rx" << "Only Tx" << "Rx & Tx ON" << "RS485";
    clQCanCfgGuiP.clComboBoxCOMDirection->insertItems(0,clStringListT);
    clQCanCfgGuiP.clComboBoxCOMDirection->setCurrentIndex(tsCurrentConfigP.ubDirection);
+
+   //----------------------------------------------------------------
+   // frame format of older firmware
+   //
+   clQCanCfgGuiP.clCheckBoxLegacy->setChecked(tsCurrentConfigP.btLegacy);
 }
 
 //----------------------------------------------------------------------------//
@@ -106,6 +111,7 @@ QCanUsart::QCanUsartConfig_ts & QCanConfig::currentConfig()
 {
    tsCurrentConfigP.ubDirection = clQCanCfgGuiP.clComboBoxCOMDirection->currentIndex();
    tsCurrentConfigP.ubMode = (clQCanCfgGuiP.clComboBoxCOMMode->currentIndex()+4);
+   tsCurrentConfigP.btLegacy = clQCanCfgGuiP.clCheckBoxLegacy->isChecked();
 
    return tsCurrentConfigP;
 }
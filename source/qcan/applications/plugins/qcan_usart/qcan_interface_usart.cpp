@@ -197,7 +197,18 @@ QCanInterface::InterfaceError_e QCanInterfaceUsart::connect(void)
    if (clCpUsartP.isAvailable())
    {
       clCpUsartP.setDeviceName(clDeviceNameP);
-      tvStatusT = clCpUsartP.CpUsartDriverInit(uwDeviceNumberP+1,&tsPortP,0);
+      //----------------------------------------------------------------
+      // older firmware exchanges the plain CAN message structure
+      //
+      if (clCpUsartP.currentConfig().btLegacy)
+      {
+         tvStatusT = clCpUsartP.CpUsartDriverInit(uwDeviceNumberP+1, &tsPortP,
+                                                  CP_USART_CONFIG_LEGACY);
+      }
+      else
+      {
+         tvStatusT = clCpUsartP.CpUsartDriverInit(uwDeviceNumberP+1,&tsPortP,0);
+      }
       if (tvStatusT == eCP_ERR_NONE)
       {
          tvStatusT += clCpUsartP.CpUsartIntFunctions(&tsPortP,
@@ -769,6 +780,7 @@ bool QCanInterfaceUsart::configureDevice(void)
    qDebug() << "value from current connfig, dir: "<<clCpUsartP.currentConfig().ubDirection;
    qDebug() << "value from current connfig, mode: "<<clCpUsartP.currentConfig().ubMode;
    qDebug() << "value from current connfig, bitrate: "<<clCpUsartP.currentConfig().ulBaud;
+   qDebug() << "value from current connfig, legacy: "<<clCpUsartP.currentConfig().btLegacy;
 
    QCanConfig *pclConfigGuiT = new QCanConfig(clCpUsartP.currentConfig());
    pclConfigGuiT->exec();
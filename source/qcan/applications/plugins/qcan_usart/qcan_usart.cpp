@@ -387,14 +387,17 @@ void QCanUsart::onReadyRead()
    if (pclSerialPortP->bytesAvailable() >= ulUsartRcvBufferSizeP)
    {
       //--------------------------------------------------------
-      // pass received USART Data to the CANpie Receive Handler
+      // pass all received USART Data to the CANpie Receive
+      // Handler, the handler takes care of partial and
+      // multiple frames
       //
-      clUartRcvBufG.clear();
-      clUartRcvBufG.resize(ulUsartRcvBufferSizeP);
-
-      pclSerialPortP->read(clUartRcvBufG.data(), ulUsartRcvBufferSizeP);
+      clUartRcvBufG = pclSerialPortP->readAll();
 
-      pfnUsartRcvHandlerP((uint8_t *)clUartRcvBufG.data(),ulUsartRcvBufferSizeP);
+      if ((pfnUsartRcvHandlerP != NULL) && (clUartRcvBufG.size() > 0))
+      {
+         pfnUsartRcvHandlerP((uint8_t *)clUartRcvBufG.data(),
+                             (uint32_t) clUartRcvBufG.size());
+      }
    }
 }
 
@@ -406,6 +409,7 @@ QCanUsart::QCanUsart()
 {
    btLibFuncLoadP = true;
    pclSerialPortP = NULL;
+   tsConfigP.btLegacy = false;
 }
 
 //----------------------------------------------------------------------------//
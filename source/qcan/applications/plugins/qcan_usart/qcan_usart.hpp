@@ -41,6 +41,7 @@
 #include "cp_core.h"
 #include "cp_fifo.h"
 #include "cp_msg.h"
+#include "cp_usart_frame.h"
 #include "mc_usart.h"
 
 
@@ -59,6 +60,7 @@ public:
       quint32 ulBaud;
       quint8  ubDirection;  // USART_DIR_e from mc_usart.h
       quint8  ubMode;       // USART_MODE_e from mc_usart.h
+      bool    btLegacy;     // legacy frames, see CP_USART_CONFIG_LEGACY
    } QCanUsartConfig_ts;
 
 
@@ -228,10 +230,20 @@ public:
       return CpCoreFifoConfig(ptsPortV,ubBufferIdxV,ptsFifoV);
    }
 
+   CpStatus_tv CpUsartFifoDelay(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
+                                CpPrioDelay_ts *ptsDelayV)
+   {
+      return CpCoreFifoDelay(ptsPortV, ubBufferIdxV, ptsDelayV);
+   }
+
 
-   void        CpUsartFifoEvent(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV)
+   CpStatus_tv CpUsartFifoEvent(CpPort_ts *ptsPortV, uint8_t ubBufferIdxV,
+                                CpFifoHandler_Fn pfnFifoHandlerV,
+                                uint32_t ulHighMarkV, uint32_t ulLowMarkV,
+                                uint32_t ulTimeoutV)
    {
-      CpCoreFifoEvent(ptsPortV, ubBufferIdxV);
+      return CpCoreFifoEvent(ptsPortV, ubBufferIdxV, pfnFifoHandlerV,
+                             ulHighMarkV, ulLowMarkV, ulTimeoutV);
    }
 
    CpStatus_tv CpUsartFifoRead(CpPort_ts *ptsPortV,
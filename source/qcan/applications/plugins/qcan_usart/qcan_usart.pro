@@ -146,7 +146,9 @@ SOURCES =   qcan_frame.cpp             \
 
 SOURCES += cp_fifo.c    \
            cp_msg.c     \
-           cp_usart.c
+           cp_prio.c    \
+           cp_usart.c   \
+           cp_usart_frame.c
 
 
 contains(TEMPLATE, app) {
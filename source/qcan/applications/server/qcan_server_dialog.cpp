@@ -161,6 +161,8 @@ QCanServerDialog::QCanServerDialog(QWidget * parent)
    //---------------------------------------------------------------------------------------------------
    // settings for server
    //
+   pclLoggerP->addLoggingSource(pclCanServerP->multiplexer());
+
    pclSettingsP->beginGroup("Server");
    QHostAddress clHostAddrT = QHostAddress(pclSettingsP->value("hostAddress",
                                              "127.0.0.1").toString());
@@ -187,6 +189,9 @@ QCanServerDialog::QCanServerDialog(QWidget * parent)
       pclNetworkT->setErrorFrameEnabled(pclSettingsP->value("errorFrame",
                                      0).toBool());
 
+      pclNetworkT->setErrorCoalescingTime(pclSettingsP->value("errorCoalesce",
+                                     0).toUInt());
+
       pclNetworkT->setFlexibleDataEnabled(pclSettingsP->value("canFD",
                                      0).toBool());
 
@@ -328,6 +333,7 @@ QCanServerDialog::~QCanServerDialog()
       pclSettingsP->setValue("bitrateDat", pclNetworkT->dataBitrate());
       pclSettingsP->setValue("enable"    , pclNetworkT->isNetworkEnabled());
       pclSettingsP->setValue("errorFrame", pclNetworkT->isErrorFrameEnabled());
+      pclSettingsP->setValue("errorCoalesce", pclNetworkT->errorCoalescingTime());
       pclSettingsP->setValue("canFD"     , pclNetworkT->isFlexibleDataEnabled());
       pclSettingsP->setValue("listenOnly", pclNetworkT->isListenOnlyEnabled());
       pclSettingsP->setValue("loglevel"  , pclLoggerP->logLevel((CAN_Channel_e)(ubNetworkIdxT+1)));
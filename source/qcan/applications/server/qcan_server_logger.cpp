@@ -46,8 +46,121 @@
 #include <QtWidgets/QMenu>
 
 
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanServerLogWriter()                                                                                              //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanServerLogWriter::QCanServerLogWriter(QCanServerLogger * pclLoggerV)
+{
+   pclLoggerP = pclLoggerV;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanServerLogWriter::processQueue()                                                                                //
+// format all queued records, write them to the log files and pass them to the log window                            //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanServerLogWriter::processQueue(void)
+{
+   QCanLogRecord_ts  tsRecordT;
+   QByteArray        aclFileDataT[QCAN_NETWORK_MAX];
+   QStringList       aclLinesT[QCAN_NETWORK_MAX];
+   QString           clLineT;
+   quint32           ulDropCountT;
+   uint8_t           ubLogNumT;
+
+   //----------------------------------------------------------------
+   // report dropped records first, to all channels
+   //
+   ulDropCountT = pclLoggerP->ulDropCountP.fetchAndStoreOrdered(0);
+   if (ulDropCountT > 0)
+   {
+      pclLoggerP->ulDropTotalP.fetchAndAddOrdered(ulDropCountT);
+      clLineT = QDateTime::currentDateTime().toString("hh:mm:ss.zzz - ");
+      clLineT += QString("%1 log messages dropped").arg(ulDropCountT);
+      for (ubLogNumT = 0; ubLogNumT < QCAN_NETWORK_MAX; ubLogNumT++)
+      {
+         aclLinesT[ubLogNumT].append(clLineT);
+         aclFileDataT[ubLogNumT].append(clLineT.toLatin1());
+         aclFileDataT[ubLogNumT].append('\n');
+      }
+   }
+
+   //----------------------------------------------------------------
+   // format all records, the time stamp is captured when the record
+   // is queued
+   //
+   while (pclLoggerP->clQueueP.dequeue(tsRecordT))
+   {
+      ubLogNumT = (uint8_t) (tsRecordT.teChannel - 1);
+      clLineT   = QDateTime::fromMSecsSinceEpoch(tsRecordT.sqTimeStamp).toString("hh:mm:ss.zzz - ");
+      clLineT  += tsRecordT.clMessage;
+
+      aclLinesT[ubLogNumT].append(clLineT);
+      aclFileDataT[ubLogNumT].append(clLineT.toLatin1());
+      aclFileDataT[ubLogNumT].append('\n');
+   }
+
+   //----------------------------------------------------------------
+   // one write access per log file
+   //
+   pclLoggerP->clFileMutexP.lock();
+   for (ubLogNumT = 0; ubLogNumT < QCAN_NETWORK_MAX; ubLogNumT++)
+   {
+      if ((aclFileDataT[ubLogNumT].isEmpty() == false) &&
+          (pclLoggerP->apclLogFileP[ubLogNumT] != Q_NULLPTR))
+      {
+         pclLoggerP->apclLogFileP[ubLogNumT]->write(aclFileDataT[ubLogNumT]);
+         pclLoggerP->apclLogFileP[ubLogNumT]->flush();
+      }
+   }
+   pclLoggerP->clFileMutexP.unlock();
+
+   //----------------------------------------------------------------
+   // hand the lines over to the log window, only the latest lines
+   // are kept if the window is not updated fast enough
+   //
+   pclLoggerP->clUiMutexP.lock();
+   for (ubLogNumT = 0; ubLogNumT < QCAN_NETWORK_MAX; ubLogNumT++)
+   {
+      if (aclLinesT[ubLogNumT].isEmpty() == false)
+      {
+         pclLoggerP->aclUiLinesP[ubLogNumT].append(aclLinesT[ubLogNumT]);
+         while (pclLoggerP->aclUiLinesP[ubLogNumT].size() > QCAN_LOG_UI_LINES_MAX)
+         {
+            pclLoggerP->aclUiLinesP[ubLogNumT].removeFirst();
+            pclLoggerP->aulUiSkipP[ubLogNumT]++;
+         }
+      }
+   }
+   pclLoggerP->clUiMutexP.unlock();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanServerLogWriter::run()                                                                                         //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanServerLogWriter::run(void)
+{
+   while (isInterruptionRequested() == false)
+   {
+      processQueue();
+      msleep(QCAN_LOG_WRITE_INTERVAL);
+   }
+
+   //----------------------------------------------------------------
+   // write remaining records before the thread quits
+   //
+   processQueue();
+}
+
+
 QCanServerLogger::QCanServerLogger()
 {
+   ulDropCountP.storeRelease(0);
+   ulDropTotalP.storeRelease(0);
+
    teCanChannelP = eCAN_CHANNEL_1;
    pclLogWindowP = new QMainWindow();
    pclLogTabP    = new QTabWidget();
@@ -65,6 +178,7 @@ QCanServerLogger::QCanServerLogger()
    {
       ateLogLevelP[ubLogNumT] = eLOG_LEVEL_INFO;
       apclLogFileP[ubLogNumT] = Q_NULLPTR;
+      aulUiSkipP[ubLogNumT]   = 0;
 
       apclLogTextP[ubLogNumT] = new QTextBrowser();
       apclLogTextP[ubLogNumT]->setFont(clFontT);
@@ -86,10 +200,28 @@ QCanServerLogger::QCanServerLogger()
    pclLogWindowP->setCentralWidget(pclLogTabP);
    pclLogWindowP->setWindowTitle("CANpie Server - Logging Window");
    pclLogWindowP->resize(800, 480);
+
+   //----------------------------------------------------------------
+   // the log window is updated at a fixed rate, independent of
+   // the number of log messages
+   //
+   pclUiTimerP = new QTimer(this);
+   connect(pclUiTimerP, SIGNAL(timeout()), this, SLOT(onUpdateLog()));
+   pclUiTimerP->start(QCAN_LOG_UI_INTERVAL);
+
+   pclWriterP = new QCanServerLogWriter(this);
+   pclWriterP->start(QThread::LowPriority);
 }
 
 QCanServerLogger::~QCanServerLogger()
 {
+   //----------------------------------------------------------------
+   // stop the writer thread, it writes all pending records
+   //
+   pclWriterP->requestInterruption();
+   pclWriterP->wait();
+   delete pclWriterP;
+
    for (uint8_t ubLogNumT = 0; ubLogNumT < QCAN_NETWORK_MAX; ubLogNumT++)
    {
       if (apclLogFileP[ubLogNumT] != Q_NULLPTR)
@@ -97,6 +229,7 @@ QCanServerLogger::~QCanServerLogger()
          qDebug() << "close log file " << ubLogNumT;
          apclLogFileP[ubLogNumT]->flush();
          apclLogFileP[ubLogNumT]->close();
+         delete apclLogFileP[ubLogNumT];
       }
    }
    delete pclLogTabP;
@@ -123,35 +256,42 @@ void QCanServerLogger::addLoggingSource(QObject *sender)
 
 //----------------------------------------------------------------------------//
 // appendMessage()                                                            //
-// append log message to log window for channel 'ubChannelV'                  //
+// queue log message for channel 'ubChannelV', the function may be called    //
+// from any thread and does not block                                         //
 //----------------------------------------------------------------------------//
 void QCanServerLogger::appendMessage(const CAN_Channel_e ubChannelV,
                                      const QString & clLogMessageV,
                                      LogLevel_e teLogLevelV)
 {
+   QCanLogRecord_ts  tsRecordT;
+
    if ((ubChannelV >= eCAN_CHANNEL_1) && (ubChannelV <= QCAN_NETWORK_MAX))
    {
-      clLogMessageP.clear();
-
       if (teLogLevelV <= ateLogLevelP[ubChannelV - 1])
       {
-         clTimeP = QDateTime::currentDateTime();
-         clLogMessageP  = clTimeP.toString("hh:mm:ss.zzz - ");
-         clLogMessageP += clLogMessageV;
-
-         apclLogTextP[ubChannelV - 1]->append(clLogMessageP);
+         tsRecordT.sqTimeStamp = QDateTime::currentMSecsSinceEpoch();
+         tsRecordT.teChannel   = ubChannelV;
+         tsRecordT.clMessage   = clLogMessageV;
 
-         if ((apclLogFileP[ubChannelV - 1]) != Q_NULLPTR)
+         if (clQueueP.enqueue(tsRecordT) == false)
          {
-            apclLogFileP[ubChannelV - 1]->write(clLogMessageP.toLatin1());
-            qDebug() << "write data to file";
-
+            ulDropCountP.fetchAndAddRelaxed(1);
          }
       }
    }
 }
 
 
+//--------------------------------------------------------------------------------------------------------------------//
+// droppedMessages()                                                                                                  //
+// number of log records dropped because the queue was full                                                          //
+//--------------------------------------------------------------------------------------------------------------------//
+quint32 QCanServerLogger::droppedMessages(void)
+{
+   return (ulDropTotalP.loadAcquire() + ulDropCountP.loadAcquire());
+}
+
+
 //--------------------------------------------------------------------------------------------------------------------//
 // hide()                                                                                                             //
 // hide the log window                                                                                                //
@@ -209,6 +349,43 @@ void QCanServerLogger::onClearLog(void)
 }
 
 
+//--------------------------------------------------------------------------------------------------------------------//
+// onUpdateLog()                                                                                                      //
+// add the lines collected by the writer thread to the log window                                                     //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanServerLogger::onUpdateLog(void)
+{
+   QStringList aclLinesT[QCAN_NETWORK_MAX];
+   quint32     aulSkipT[QCAN_NETWORK_MAX];
+   uint8_t     ubLogNumT;
+
+   clUiMutexP.lock();
+   for (ubLogNumT = 0; ubLogNumT < QCAN_NETWORK_MAX; ubLogNumT++)
+   {
+      aclLinesT[ubLogNumT].swap(aclUiLinesP[ubLogNumT]);
+      aulSkipT[ubLogNumT]   = aulUiSkipP[ubLogNumT];
+      aulUiSkipP[ubLogNumT] = 0;
+   }
+   clUiMutexP.unlock();
+
+   //----------------------------------------------------------------
+   // one append() per window, this keeps the layout effort low
+   //
+   for (ubLogNumT = 0; ubLogNumT < QCAN_NETWORK_MAX; ubLogNumT++)
+   {
+      if (aulSkipT[ubLogNumT] > 0)
+      {
+         aclLinesT[ubLogNumT].prepend(tr("... %1 lines not displayed, see log file").arg(aulSkipT[ubLogNumT]));
+      }
+
+      if (aclLinesT[ubLogNumT].isEmpty() == false)
+      {
+         apclLogTextP[ubLogNumT]->append(aclLinesT[ubLogNumT].join('\n'));
+      }
+   }
+}
+
+
 //--------------------------------------------------------------------------------------------------------------------//
 // onSetLogFile()                                                                                                     //
 // set log file                                                                                                       //
@@ -356,6 +533,11 @@ bool QCanServerLogger::setFileName(const CAN_Channel_e ubChannelV,
 
    if ((ubChannelV >= eCAN_CHANNEL_1) && (ubChannelV <= QCAN_NETWORK_MAX))
    {
+      //--------------------------------------------------------
+      // the writer thread must not access the file meanwhile
+      //
+      QMutexLocker clLockT(&clFileMutexP);
+
       if ((apclLogFileP[teCanChannelP - 1]) == Q_NULLPTR)
       {
          apclLogFileP[teCanChannelP - 1] = new QFile();
@@ -384,7 +566,7 @@ bool QCanServerLogger::setFileName(const CAN_Channel_e ubChannelV,
       // write existing log data to the file
       //
       pclLogFileT->write(apclLogTextP[teCanChannelP - 1]->toPlainText().toLatin1());
-      qDebug() << "write data to file";
+      pclLogFileT->write("\n");
       return true;
    }
 
@@ -37,19 +37,96 @@
 **                                                                                                                    **
 \*--------------------------------------------------------------------------------------------------------------------*/
 
+#include <QtCore/QAtomicInteger>
 #include <QtCore/QDateTime>
 #include <QtCore/QFile>
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
 
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QTextBrowser>
 
+#include "qcan_bounded_queue.hpp"
 #include "qcan_defs.hpp"
 #include "qcan_namespace.hpp"
 
 
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// Number of log records which can be queued, must be a power of 2
+//
+#define  QCAN_LOG_QUEUE_SIZE        ((quint32) 4096)
+
+//-------------------------------------------------------------------
+// Interval of the writer thread in milliseconds, all records
+// queued within this time are written to the log file in one step
+//
+#define  QCAN_LOG_WRITE_INTERVAL    50
+
+//-------------------------------------------------------------------
+// Update interval of the log window in milliseconds
+//
+#define  QCAN_LOG_UI_INTERVAL       100
+
+//-------------------------------------------------------------------
+// Maximum number of lines added to the log window per update and
+// CAN channel, the log file always receives all records
+//
+#define  QCAN_LOG_UI_LINES_MAX      500
+
+
 using namespace QCan;
 
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \struct  QCanLogRecord_s
+**
+** A log record as it is passed from the logging source to the writer thread.
+*/
+struct QCanLogRecord_s
+{
+   qint64         sqTimeStamp;
+   CAN_Channel_e  teChannel;
+   QString        clMessage;
+};
+
+typedef struct QCanLogRecord_s QCanLogRecord_ts;
+
+
+class QCanServerLogger;
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class   QCanServerLogWriter
+**
+** The writer thread formats queued log records, writes them to the log files in batches and collects the
+** lines for the log window.
+*/
+class QCanServerLogWriter : public QThread
+{
+   Q_OBJECT
+
+public:
+   QCanServerLogWriter(QCanServerLogger * pclLoggerV);
+
+protected:
+   void run(void) Q_DECL_OVERRIDE;
+
+private:
+   void processQueue(void);
+
+   QCanServerLogger *   pclLoggerP;
+};
+
+
 class QCanServerLogger : public QObject
 {
     Q_OBJECT
@@ -62,6 +139,9 @@ public:
     ** allow to send log messages */
    void addLoggingSource(QObject *sender);
 
+   /** number of log records dropped because the queue was full */
+   quint32 droppedMessages(void);
+
    bool isHidden(void);
 
    /** set the name of the log file */
@@ -85,11 +165,35 @@ private slots:
    void onClearLog(void);
    void onSetLogFile(void);
    void onShowLogMenu(const QPoint &pos);
+   void onUpdateLog(void);
 
 private:
-   QDateTime      clTimeP;
-   QString        clLogMessageP;
+   friend class QCanServerLogWriter;
+
+   //----------------------------------------------------------------
+   // record queue, filled by appendMessage() and emptied by
+   // the writer thread
+   //
+   QCanBoundedQueue<QCanLogRecord_ts, QCAN_LOG_QUEUE_SIZE> clQueueP;
+   QAtomicInteger<quint32>    ulDropCountP;
+   QAtomicInteger<quint32>    ulDropTotalP;
+   QCanServerLogWriter *      pclWriterP;
+
+   //----------------------------------------------------------------
+   // log files, accessed by the writer thread and setFileName()
+   //
+   QMutex         clFileMutexP;
    QFile *        apclLogFileP[QCAN_NETWORK_MAX];
+
+   //----------------------------------------------------------------
+   // lines for the log window, filled by the writer thread and
+   // emptied by onUpdateLog()
+   //
+   QMutex         clUiMutexP;
+   QStringList    aclUiLinesP[QCAN_NETWORK_MAX];
+   quint32        aulUiSkipP[QCAN_NETWORK_MAX];
+   QTimer *       pclUiTimerP;
+
    LogLevel_e     ateLogLevelP[QCAN_NETWORK_MAX];
    CAN_Channel_e  teCanChannelP;
    QMainWindow  * pclLogWindowP;
@@ -116,11 +116,16 @@ VPATH += ./../../../canpie-fd
 # header files of project 
 #
 HEADERS =   qcan_interface_widget.hpp  \
+            qcan_gateway.hpp           \
             qcan_interface.hpp         \
+            qcan_multiplexer.hpp       \
             qcan_network.hpp           \
+            qcan_recorder.hpp          \
+            qcan_scheduler.hpp         \
             qcan_server.hpp            \
             qcan_server_dialog.hpp     \
-            qcan_server_logger.hpp
+            qcan_server_logger.hpp     \
+            qcan_value_table.hpp
                 
             
 #---------------------------------------------------------------
@@ -129,11 +134,17 @@ HEADERS =   qcan_interface_widget.hpp  \
 SOURCES =   qcan_interface_widget.cpp  \
             qcan_frame.cpp             \
             qcan_timestamp.cpp         \
+            qcan_gateway.cpp           \
+            qcan_multiplexer.cpp       \
             qcan_network.cpp           \
+            qcan_recorder.cpp          \
+            qcan_scheduler.cpp         \
             qcan_server.cpp            \
             qcan_server_dialog.cpp     \
             qcan_server_logger.cpp     \
             qcan_server_settings.cpp   \
+            qcan_trace.cpp             \
+            qcan_value_table.cpp       \
             server_main.cpp
 
 
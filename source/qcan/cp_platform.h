@@ -85,6 +85,8 @@
 
 #define  CP_STATISTIC               1
 
+#define  CP_TRM_PRIORITY            0
+
 
 
 /*----------------------------------------------------------------------------*\
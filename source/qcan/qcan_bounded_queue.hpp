@@ -0,0 +1,167 @@
+//====================================================================================================================//
+// File:          qcan_bounded_queue.hpp                                                                              //
+// Description:   QCAN classes - Bounded lock-free queue                                                              //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+#ifndef QCAN_BOUNDED_QUEUE_HPP_
+#define QCAN_BOUNDED_QUEUE_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QtGlobal>
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanBoundedQueue
+** \brief Bounded lock-free queue
+**
+** A QCanBoundedQueue passes items of type \a T from any number of producer threads to one consumer thread.
+** The producers enqueue items without taking a lock, a full queue rejects the item. Only the consumer thread
+** may dequeue items. The number of entries \a N must be a power of 2.
+** <p>
+** Each slot carries a sequence number which tells if the slot is free for the producer (equal to the write
+** index) or filled for the consumer (equal to the write index + 1).
+*/
+template <typename T, quint32 N> class QCanBoundedQueue
+{
+   Q_STATIC_ASSERT_X((N > 0) && ((N & (N - 1)) == 0), "QCanBoundedQueue: size must be a power of 2");
+
+public:
+
+   QCanBoundedQueue()
+   {
+      for (quint32 ulSlotT = 0; ulSlotT < N; ulSlotT++)
+      {
+         atsSlotP[ulSlotT].ulSequence.storeRelease(ulSlotT);
+      }
+      ulIndexInP.storeRelease(0);
+      ulIndexOutP = 0;
+   };
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[out] tItemR         Item
+   ** \return     \c false if the queue is empty
+   **
+   ** The function removes the oldest item from the queue. It must only be called by the consumer thread.
+   ** The slot is reset to a default constructed item, so the queue does not keep resources of items which
+   ** have already been read.
+   */
+   bool  dequeue(T & tItemR)
+   {
+      Slot_s * ptsSlotT = &atsSlotP[ulIndexOutP & (N - 1)];
+
+      if (ptsSlotT->ulSequence.loadAcquire() != (ulIndexOutP + 1))
+      {
+         return false;
+      }
+
+      tItemR          = ptsSlotT->tItem;
+      ptsSlotT->tItem = T();
+
+      //----------------------------------------------------------------
+      // release the slot for the next round of the producers
+      //
+      ptsSlotT->ulSequence.storeRelease(ulIndexOutP + N);
+      ulIndexOutP++;
+
+      return true;
+   };
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  tItemR         Item
+   ** \return     \c false if the queue is full
+   **
+   ** The function appends the item \a tItemR to the queue, it may be called by any thread.
+   */
+   bool  enqueue(const T & tItemR)
+   {
+      Slot_s * ptsSlotT;
+      quint32  ulIndexT = ulIndexInP.loadAcquire();
+      qint32   slDiffT;
+
+      for (;;)
+      {
+         ptsSlotT = &atsSlotP[ulIndexT & (N - 1)];
+         slDiffT  = (qint32) (ptsSlotT->ulSequence.loadAcquire() - ulIndexT);
+
+         if (slDiffT == 0)
+         {
+            //--------------------------------------------------------
+            // slot is free, try to claim it
+            //
+            if (ulIndexInP.testAndSetOrdered(ulIndexT, ulIndexT + 1))
+            {
+               break;
+            }
+            ulIndexT = ulIndexInP.loadAcquire();
+         }
+         else if (slDiffT < 0)
+         {
+            //--------------------------------------------------------
+            // the consumer did not release this slot yet: queue full
+            //
+            return false;
+         }
+         else
+         {
+            ulIndexT = ulIndexInP.loadAcquire();
+         }
+      }
+
+      ptsSlotT->tItem = tItemR;
+      ptsSlotT->ulSequence.storeRelease(ulIndexT + 1);
+
+      return true;
+   };
+
+private:
+
+   Q_DISABLE_COPY(QCanBoundedQueue)
+
+   struct Slot_s
+   {
+      QAtomicInteger<quint32> ulSequence;
+      T                       tItem;
+   };
+
+   Slot_s                     atsSlotP[N];
+   QAtomicInteger<quint32>    ulIndexInP;
+   quint32                    ulIndexOutP;
+};
+
+#endif   // QCAN_BOUNDED_QUEUE_HPP_
@@ -47,6 +47,13 @@
 **
 */
 
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+#include <stdint.h>
+
+
 /*----------------------------------------------------------------------------*\
 ** Definitions                                                                **
 **                                                                            **
@@ -76,8 +83,9 @@
 ** \ingroup QCAN_NW
 ** \brief   Maximum number of TCP sockets
 **
-** This symbol defines the maximum number of sockets connected to
-** the TCP server.
+** This symbol defines the default value for the maximum number of
+** sockets connected to the TCP server. The value can be changed
+** during run-time by QCanNetwork::setSocketMax().
 */
 #define  QCAN_TCP_SOCKET_MAX        64
 
@@ -87,11 +95,181 @@
 ** \ingroup QCAN_NW
 ** \brief   Maximum number of local sockets
 **
-** This symbol defines the maximum number of local sockets connected to
-** the server.
+** This symbol defines the default value for the maximum number of
+** local sockets connected to the server. The value can be changed
+** during run-time by QCanNetwork::setSocketMax().
 */
 #define  QCAN_LOCAL_SOCKET_MAX      64
 
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_MUX_CHANNEL_POS
+** \ingroup QCAN_NW
+** \brief   Position of CAN channel in multiplexed frames
+**
+** This symbol defines the byte position of the CAN channel inside
+** a frame on a multiplexed connection (see QCanMultiplexer). The
+** byte is not used by QCanFrame::toByteArray().
+*/
+#define  QCAN_MUX_CHANNEL_POS       86
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_MUX_SERVER_NAME
+** \ingroup QCAN_NW
+** \brief   Name of local server for multiplexed connections
+**
+** This symbol defines the name of the local server which accepts
+** multiplexed connections (see QCanMultiplexer).
+*/
+#define  QCAN_MUX_SERVER_NAME       "CANpieServerMux"
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_RECORD_TYPE_POS
+** \ingroup QCAN_NW
+** \brief   Position of record type
+**
+** This symbol defines the byte position of the record type inside
+** the data sent by a socket. A value of 0 denotes a CAN frame,
+** other values denote a control record for the network. The byte
+** is not used by QCanFrame::toByteArray().
+*/
+#define  QCAN_RECORD_TYPE_POS       87
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_RECORD_SUBSCRIPTION
+** \ingroup QCAN_NW
+** \brief   Record type of a subscription
+**
+** A subscription record defines which frames are sent to a socket
+** (see QCanSocket::setSubscription()): bit 0 of byte 0 selects
+** changed frames only, byte 4 .. 7 hold the maximum rate per
+** identifier in Hz and byte 8 .. 11 the keep-alive time in
+** milliseconds (MSB first).
+*/
+#define  QCAN_RECORD_SUBSCRIPTION   0x01
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_RECORD_SNAPSHOT
+** \ingroup QCAN_NW
+** \brief   Record type of a snapshot request
+**
+** On reception of a snapshot request the network sends the last
+** frame of each identifier to the socket (see
+** QCanSocket::requestSnapshot()).
+*/
+#define  QCAN_RECORD_SNAPSHOT       0x02
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_SUBSCRIBE_CHANGE
+** \ingroup QCAN_NW
+** \brief   Subscribe to changed frames only
+**
+** Flag in byte 0 of a subscription record.
+*/
+#define  QCAN_SUBSCRIBE_CHANGE      0x01
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_RECORD_CYCLIC
+** \ingroup QCAN_NW
+** \brief   Record type of a cyclic frame
+**
+** A cyclic frame record controls the transmit scheduler of the
+** network (see QCanSocket::setCyclicFrame()). Byte 0 .. 69 hold the
+** frame like QCanFrame::toByteArray(), byte 70 the command (e.g.
+** #QCAN_CYCLIC_SET), byte 72 .. 73 the handle, byte 74 .. 77 the
+** period in micro-seconds, byte 78 the position and byte 79 the
+** size of the payload counter (all values MSB first).
+** <p>
+** The answer of the network to #QCAN_CYCLIC_STATUS uses the same
+** record type: byte 0 .. 15 hold the values of CyclicStatus_ts
+** (MSB first), byte 70 .. 73 are defined as above.
+*/
+#define  QCAN_RECORD_CYCLIC         0x03
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_CYCLIC_SET
+** \ingroup QCAN_NW
+** \brief   Add or update cyclic frame
+*/
+#define  QCAN_CYCLIC_SET            0x01
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_CYCLIC_PATTERN
+** \ingroup QCAN_NW
+** \brief   Append payload pattern to cyclic frame
+*/
+#define  QCAN_CYCLIC_PATTERN        0x02
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_CYCLIC_CANCEL
+** \ingroup QCAN_NW
+** \brief   Cancel cyclic frame
+*/
+#define  QCAN_CYCLIC_CANCEL         0x03
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_CYCLIC_STATUS
+** \ingroup QCAN_NW
+** \brief   Request status of all cyclic frames of a socket
+*/
+#define  QCAN_CYCLIC_STATUS         0x04
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_MCAST_ADDRESS
+** \ingroup QCAN_NW
+** \brief   Default UDP multicast group
+**
+** This symbol defines the default multicast group address for the
+** UDP publisher of a QCanNetwork.
+*/
+#define  QCAN_MCAST_ADDRESS         "239.255.67.1"
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_MCAST_PORT
+** \ingroup QCAN_NW
+** \brief   Default UDP multicast port
+**
+** This symbol defines the UDP port of the first network, the
+** following networks use the following ports.
+*/
+#define  QCAN_MCAST_PORT            55680
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_MCAST_HEADER_SIZE
+** \ingroup QCAN_NW
+** \brief   Header size of UDP multicast datagram
+**
+** A multicast datagram starts with a header: byte 0 .. 3 hold the
+** sequence number (MSB first), byte 4 the CAN channel and byte 5
+** the number of frames. The frames follow the header with a size
+** of #QCAN_FRAME_ARRAY_SIZE each.
+*/
+#define  QCAN_MCAST_HEADER_SIZE     8
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_MCAST_FRAME_MAX
+** \ingroup QCAN_NW
+** \brief   Maximum number of frames in a UDP multicast datagram
+**
+** The value is selected so that a datagram fits into an Ethernet
+** frame.
+*/
+#define  QCAN_MCAST_FRAME_MAX       14
+
 //-------------------------------------------------------------------
 /*!
 ** \def     QCAN_NETWORK_MAX
@@ -158,4 +336,28 @@
 #define  QCAN_IF_SUPPORT_SPECIFIC_CONFIG  ((uint32_t) (0x00000008))
 
 #define  QCAN_IF_SUPPORT_MASK             ((uint32_t) (0x0000000F))
+
+
+/*----------------------------------------------------------------------------*\
+** Structures                                                                 **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+/*!
+** \brief   Status of a cyclic frame
+** \ingroup QCAN_NW
+**
+** The structure holds the status of a cyclic frame of the transmit
+** scheduler (see QCanScheduler::status() and
+** QCanSocket::cyclicStatus()). The jitter is the deviation between
+** the scheduled and the actual transmission time in micro-seconds.
+*/
+typedef struct CyclicStatus_s {
+   uint32_t ulCount;          //!< number of transmissions
+   int32_t  slJitterLast;     //!< jitter of the last transmission
+   uint32_t ulJitterMax;      //!< maximum absolute jitter
+   uint32_t ulJitterMean;     //!< mean absolute jitter
+} CyclicStatus_ts;
+
 #endif // QCAN_DEFS_HPP_
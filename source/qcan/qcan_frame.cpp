@@ -33,6 +33,10 @@
 **                                                                                                                    **
 \*--------------------------------------------------------------------------------------------------------------------*/
 
+#include <string.h>
+
+#include <QtCore/QtEndian>
+
 #include <QCanFrame>
 
 
@@ -155,6 +159,16 @@ bool QCanFrame::bitrateSwitch(void) const
 }
 
 
+//----------------------------------------------------------------------------//
+// constData()                                                                //
+// get pointer to payload                                                     //
+//----------------------------------------------------------------------------//
+const uint8_t * QCanFrame::constData(void) const
+{
+   return(&aubByteP[0]);
+}
+
+
 //----------------------------------------------------------------------------//
 // data()                                                                     //
 // get data                                                                   //
@@ -433,32 +447,25 @@ QCanFrame::FrameType_e  QCanFrame::frameType(void) const
 
 
 //--------------------------------------------------------------------------------------------------------------------//
-// QCanFrame::fromByteArray()                                                                                         //
-// Convert byte array to a QCanFrame object                                                                           //
+// QCanFrame::fromBuffer()                                                                                            //
+// Convert QCAN_FRAME_ARRAY_SIZE bytes to a QCanFrame object                                                          //
 //--------------------------------------------------------------------------------------------------------------------//
-bool QCanFrame::fromByteArray(const QByteArray & clByteArrayR)
+bool QCanFrame::fromBuffer(const uint8_t * pubBufferV)
 {
-   //---------------------------------------------------------------------------------------------------
-   // test size of byte array
-   //
-   if (clByteArrayR.size() < QCAN_FRAME_ARRAY_SIZE)
-   {
-      return(false);
-   }
+   uint32_t  ulValueT;
 
-   
    //---------------------------------------------------------------------------------------------------
    // build checksum from byte 0 .. 93, and compare with checksum value at the end of the byte stream
    //
-   uint16_t uwChecksumT = clByteArrayR[94];
+   uint16_t uwChecksumT = pubBufferV[94];
    uwChecksumT = uwChecksumT << 8;
-   uwChecksumT = uwChecksumT + (uint8_t) clByteArrayR[95];
+   uwChecksumT = uwChecksumT + pubBufferV[95];
 
-   if (uwChecksumT != qChecksum(clByteArrayR.constData(), QCAN_FRAME_ARRAY_SIZE - 2))
+   if (uwChecksumT != qChecksum((const char *) pubBufferV, QCAN_FRAME_ARRAY_SIZE - 2))
    {
       return(false);
    }
-   
+
    //---------------------------------------------------------------------------------------------------
    // structure seems to be valid, now start copying the contents,
    // start with the identifier value
@@ -468,81 +475,56 @@ bool QCanFrame::fromByteArray(const QByteArray & clByteArrayR)
    //---------------------------------------------------------------------------------------------------
    // set identifier field from byte 0 .. 3, MSB first
    //
-   ulIdentifierP = clByteArrayR[0];
-   ulIdentifierP = ulIdentifierP << 8;
-   ulIdentifierP = ulIdentifierP + (uint8_t) clByteArrayR[1];
-   ulIdentifierP = ulIdentifierP << 8;
-   ulIdentifierP = ulIdentifierP + (uint8_t) clByteArrayR[2];
-   ulIdentifierP = ulIdentifierP << 8;
-   ulIdentifierP = ulIdentifierP + (uint8_t) clByteArrayR[3];
-
+   ulIdentifierP = qFromBigEndian<quint32>(pubBufferV + 0);
 
    //---------------------------------------------------------------------------------------------------
    // set DLC field from byte 4
    //
-   ubMsgDlcP = clByteArrayR[4];
+   ubMsgDlcP = pubBufferV[4];
 
    //---------------------------------------------------------------------------------------------------
    // set message control field from byte 5
    //
-   ubMsgCtrlP = clByteArrayR[5];
+   ubMsgCtrlP = pubBufferV[5];
 
    //---------------------------------------------------------------------------------------------------
    // set message data field from byte 6 .. 69
    //
-   for (uint8_t ubPosT = 0; ubPosT < QCAN_MSG_DATA_MAX; ubPosT++)
-   {
-      aubByteP[ubPosT] = clByteArrayR[6 + ubPosT];
-   }
+   memcpy(&aubByteP[0], pubBufferV + 6, QCAN_MSG_DATA_MAX);
 
    //---------------------------------------------------------------------------------------------------
    // set message time-stamp field from byte 70 .. 77, MSB first
    //
-   uint32_t  ulTimeValT = 0;
-
-   ulTimeValT  = clByteArrayR[70];
-   ulTimeValT  = ulTimeValT << 8;
-   ulTimeValT += (uint8_t) clByteArrayR[71];
-   ulTimeValT  = ulTimeValT << 8;
-   ulTimeValT += (uint8_t) clByteArrayR[72];
-   ulTimeValT  = ulTimeValT << 8;
-   ulTimeValT += (uint8_t) clByteArrayR[73];
-   clMsgTimeP.setSeconds(ulTimeValT);
-
-   ulTimeValT  = 0;
-   ulTimeValT  = clByteArrayR[74];
-   ulTimeValT  = ulTimeValT << 8;
-   ulTimeValT += (uint8_t) clByteArrayR[75];
-   ulTimeValT  = ulTimeValT << 8;
-   ulTimeValT += (uint8_t) clByteArrayR[76];
-   ulTimeValT  = ulTimeValT << 8;
-   ulTimeValT += (uint8_t) clByteArrayR[77];
-   clMsgTimeP.setNanoSeconds(ulTimeValT);
+   ulValueT = qFromBigEndian<quint32>(pubBufferV + 70);
+   clMsgTimeP.setSeconds(ulValueT);
+   ulValueT = qFromBigEndian<quint32>(pubBufferV + 74);
+   clMsgTimeP.setNanoSeconds(ulValueT);
 
    //---------------------------------------------------------------------------------------------------
-   // set message user field from byte 78 .. 81, MSB first
+   // set message user field from byte 78 .. 81 and message marker field from byte 82 .. 85, MSB first
    //
-   ulMsgUserP  = clByteArrayR[78];
-   ulMsgUserP  = ulMsgUserP << 8;
-   ulMsgUserP += (uint8_t) clByteArrayR[79];
-   ulMsgUserP  = ulMsgUserP << 8;
-   ulMsgUserP += (uint8_t) clByteArrayR[80];
-   ulMsgUserP  = ulMsgUserP << 8;
-   ulMsgUserP += (uint8_t) clByteArrayR[81];
+   ulMsgUserP   = qFromBigEndian<quint32>(pubBufferV + 78);
+   ulMsgMarkerP = qFromBigEndian<quint32>(pubBufferV + 82);
 
+   return(true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanFrame::fromByteArray()                                                                                         //
+// Convert byte array to a QCanFrame object                                                                           //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanFrame::fromByteArray(const QByteArray & clByteArrayR)
+{
    //---------------------------------------------------------------------------------------------------
-   // set message marker field from byte 82 .. 85, MSB first
+   // test size of byte array
    //
-   ulMsgMarkerP  = clByteArrayR[82];
-   ulMsgMarkerP  = ulMsgMarkerP << 8;
-   ulMsgMarkerP += (uint8_t) clByteArrayR[83];
-   ulMsgMarkerP  = ulMsgMarkerP << 8;
-   ulMsgMarkerP += (uint8_t) clByteArrayR[84];
-   ulMsgMarkerP  = ulMsgMarkerP << 8;
-   ulMsgMarkerP += (uint8_t) clByteArrayR[85];
-
+   if (clByteArrayR.size() < QCAN_FRAME_ARRAY_SIZE)
+   {
+      return(false);
+   }
 
-   return(true);
+   return (fromBuffer((const uint8_t *) clByteArrayR.constData()));
 }
 
 
@@ -1046,91 +1028,70 @@ void QCanFrame::setUser(const uint32_t & ulUserValueR)
 
 
 //--------------------------------------------------------------------------------------------------------------------//
-// QCanFrame::toByteArray()                                                                                           //
-//                                                                                                                    //
+// QCanFrame::toBuffer()                                                                                              //
+// Convert a QCanFrame object to QCAN_FRAME_ARRAY_SIZE bytes                                                          //
 //--------------------------------------------------------------------------------------------------------------------//
-QByteArray QCanFrame::toByteArray() const
+void QCanFrame::toBuffer(uint8_t * pubBufferV) const
 {
-   //----------------------------------------------------------------
-   // setup a defined length and clear contents
-   //
-   QByteArray clByteArrayT(QCAN_FRAME_ARRAY_SIZE, 0x00);
-
-
    //----------------------------------------------------------------
    // place identifier field in byte 0 .. 3, MSB first
    //
-   clByteArrayT[0] = (uint8_t) (ulIdentifierP >> 24);
-   clByteArrayT[1] = (uint8_t) (ulIdentifierP >> 16);
-   clByteArrayT[2] = (uint8_t) (ulIdentifierP >>  8);
-   clByteArrayT[3] = (uint8_t) (ulIdentifierP >>  0);
+   qToBigEndian<quint32>(ulIdentifierP, pubBufferV + 0);
 
    //----------------------------------------------------------------
    // place message DLC field in byte 4
    //
-   clByteArrayT[4] = ubMsgDlcP;
+   pubBufferV[4] = ubMsgDlcP;
 
    //----------------------------------------------------------------
    // place message control field in byte 5
    //
-   clByteArrayT[5] = ubMsgCtrlP;
+   pubBufferV[5] = ubMsgCtrlP;
 
    //----------------------------------------------------------------
    // place message data field in byte 6 .. 69
    //
-   for(uint8_t ubPosT = 0; ubPosT < QCAN_MSG_DATA_MAX; ubPosT++)
-   {
-      clByteArrayT[6 + ubPosT] = aubByteP[ubPosT];
-   }
+   memcpy(pubBufferV + 6, &aubByteP[0], QCAN_MSG_DATA_MAX);
 
    //----------------------------------------------------------------
    // place message timestamp field in byte 70 .. 77, MSB first
    //
-   uint32_t  ulTimeValT = 0;
-
-   ulTimeValT = clMsgTimeP.seconds();
-   clByteArrayT[70] = (uint8_t) (ulTimeValT >> 24);
-   clByteArrayT[71] = (uint8_t) (ulTimeValT >> 16);
-   clByteArrayT[72] = (uint8_t) (ulTimeValT >>  8);
-   clByteArrayT[73] = (uint8_t) (ulTimeValT >>  0);
-
-   ulTimeValT = clMsgTimeP.nanoSeconds();
-   clByteArrayT[74] = (uint8_t) (ulTimeValT >>  24);
-   clByteArrayT[75] = (uint8_t) (ulTimeValT >>  16);
-   clByteArrayT[76] = (uint8_t) (ulTimeValT >>   8);
-   clByteArrayT[77] = (uint8_t) (ulTimeValT >>   0);
-
-   //----------------------------------------------------------------
-   // place message user field in byte 78 .. 81, MSB first
-   //
-   clByteArrayT[78] = (uint8_t) (ulMsgUserP >>  24);
-   clByteArrayT[79] = (uint8_t) (ulMsgUserP >>  16);
-   clByteArrayT[80] = (uint8_t) (ulMsgUserP >>   8);
-   clByteArrayT[81] = (uint8_t) (ulMsgUserP >>   0);
+   qToBigEndian<quint32>(clMsgTimeP.seconds(),     pubBufferV + 70);
+   qToBigEndian<quint32>(clMsgTimeP.nanoSeconds(), pubBufferV + 74);
 
    //----------------------------------------------------------------
-   // place message marker field in byte 82 .. 85, MSB first
+   // place message user field in byte 78 .. 81 and message marker
+   // field in byte 82 .. 85, MSB first
    //
-   clByteArrayT[82] = (uint8_t) (ulMsgMarkerP >>  24);
-   clByteArrayT[83] = (uint8_t) (ulMsgMarkerP >>  16);
-   clByteArrayT[84] = (uint8_t) (ulMsgMarkerP >>   8);
-   clByteArrayT[85] = (uint8_t) (ulMsgMarkerP >>   0);
+   qToBigEndian<quint32>(ulMsgUserP,   pubBufferV + 78);
+   qToBigEndian<quint32>(ulMsgMarkerP, pubBufferV + 82);
 
    //----------------------------------------------------------------
    // byte 86 .. 93 (i.e. 8 bytes) are not used, set to 0
-   //----------------------------------------------------------------
+   //
+   memset(pubBufferV + 86, 0x00, 8);
 
    //----------------------------------------------------------------
    // build checksum from byte 0 .. 93, add checksum at the end
    //
-   uint16_t uwChecksumT = qChecksum(clByteArrayT.constData(),
-                                    QCAN_FRAME_ARRAY_SIZE - 2);
+   uint16_t uwChecksumT = qChecksum((const char *) pubBufferV, QCAN_FRAME_ARRAY_SIZE - 2);
 
-   clByteArrayT[94] = (uint8_t) (uwChecksumT >> 8);
-   clByteArrayT[95] = (uint8_t) (uwChecksumT >> 0);
+   pubBufferV[94] = (uint8_t) (uwChecksumT >> 8);
+   pubBufferV[95] = (uint8_t) (uwChecksumT >> 0);
+}
 
-   return(clByteArrayT);
 
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanFrame::toByteArray()                                                                                           //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+QByteArray QCanFrame::toByteArray() const
+{
+   QByteArray clByteArrayT(QCAN_FRAME_ARRAY_SIZE, Qt::Uninitialized);
+
+   toBuffer((uint8_t *) clByteArrayT.data());
+
+   return(clByteArrayT);
 }
 
 
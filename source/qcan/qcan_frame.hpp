@@ -273,6 +273,18 @@ public:
    bool        bitrateSwitch(void) const;
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Pointer to payload of CAN frame
+   ** \see        data()
+   **
+   ** The function returns a pointer to the payload buffer of the CAN frame, which has a size of
+   ** #QCAN_MSG_DATA_MAX bytes. Only the first dataSize() bytes are defined by the CAN frame. The
+   ** pointer is valid as long as the CAN frame object exists.
+   */
+   const uint8_t * constData(void) const;
+
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \return     Data at payload position \a ubPosR
@@ -441,6 +453,19 @@ public:
    bool        fromByteArray(const QByteArray & clByteArrayR);
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pubBufferV     Pointer to #QCAN_FRAME_ARRAY_SIZE bytes of CAN frame data
+   ** \return     Conversion result
+   ** \see        toBuffer()
+   **
+   ** The function converts a buffer in the format of toByteArray() to a QCanFrame object. In contrast
+   ** to fromByteArray() no QByteArray is required, which allows to convert a block of frames in a
+   ** loop. On success, the functions returns \c true, otherwise \c false.
+   */
+   bool        fromBuffer(const uint8_t * pubBufferV);
+
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \return  Identifier of CAN frame
@@ -719,6 +744,17 @@ public:
    ** #QCAN_FRAME_ARRAY_SIZE.
    */
    QByteArray  toByteArray() const;
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[out] pubBufferV     Pointer to #QCAN_FRAME_ARRAY_SIZE bytes
+   ** \see        fromBuffer()
+   **
+   ** The function converts a QCanFrame object to the format of toByteArray() and places the result
+   ** in the buffer \a pubBufferV.
+   */
+   void        toBuffer(uint8_t * pubBufferV) const;
    
 
    //---------------------------------------------------------------------------------------------------
@@ -751,6 +787,7 @@ public:
    
    friend QDataStream & operator>> (QDataStream & clStreamR, 
                                     QCanFrame & clCanFrameR);
+
    
 private:
    
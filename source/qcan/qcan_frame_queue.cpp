@@ -0,0 +1,226 @@
+//====================================================================================================================//
+// File:          qcan_frame_queue.cpp                                                                                //
+// Description:   QCAN classes - CAN frame queue                                                                      //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#include "qcan_frame_queue.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class methods                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanFrameQueue()                                                                                                   //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanFrameQueue::QCanFrameQueue(uint32_t ulSizeV)
+{
+   uint32_t ulSizeT = 1;
+
+   //---------------------------------------------------------------------------------------------------
+   // the size is a power of 2, so the free running indices are mapped by a mask
+   //
+   while ((ulSizeT < ulSizeV) && (ulSizeT < 0x80000000))
+   {
+      ulSizeT = ulSizeT << 1;
+   }
+   clBufferP.resize(ulSizeT);
+   ulMaskP = ulSizeT - 1;
+
+   ulHeadP.storeRelease(0);
+   ulTailP.storeRelease(0);
+   ulLostP.storeRelease(0);
+   slWaitingP.storeRelease(0);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// ~QCanFrameQueue()                                                                                                  //
+// destructor                                                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanFrameQueue::~QCanFrameQueue()
+{
+
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanFrameQueue::append()                                                                                           //
+// append frame, called by the producer                                                                               //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanFrameQueue::append(const QCanFrame & clFrameR)
+{
+   uint32_t ulHeadT = ulHeadP.loadAcquire();
+
+   if ((ulHeadT - ulTailP.loadAcquire()) > ulMaskP)
+   {
+      ulLostP.fetchAndAddOrdered(1);
+      return (false);
+   }
+
+   clBufferP[ulHeadT & ulMaskP] = clFrameR;
+
+   //---------------------------------------------------------------------------------------------------
+   // both operations have a full barrier: either the consumer sees the new frame before it sleeps or
+   // the producer sees the waiting consumer
+   //
+   ulHeadP.fetchAndAddOrdered(1);
+   if (slWaitingP.testAndSetOrdered(1, 0))
+   {
+      clWakeUpP.release();
+   }
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanFrameQueue::framesAvailable()                                                                                  //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+int32_t QCanFrameQueue::framesAvailable(void) const
+{
+   return ((int32_t) (ulHeadP.loadAcquire() - ulTailP.loadAcquire()));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanFrameQueue::read()                                                                                             //
+// read frame, called by the consumer                                                                                 //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanFrameQueue::read(QCanFrame & clFrameR)
+{
+   uint32_t ulTailT = ulTailP.loadAcquire();
+
+   if (ulHeadP.loadAcquire() == ulTailT)
+   {
+      return (false);
+   }
+
+   clFrameR = clBufferP.at(ulTailT & ulMaskP);
+   ulTailP.storeRelease(ulTailT + 1);
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanFrameQueue::readBlocking()                                                                                     //
+// wait for a frame and read it                                                                                       //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanFrameQueue::readBlocking(QCanFrame & clFrameR, int32_t slMilliSecsV)
+{
+   if (read(clFrameR) == true)
+   {
+      return (true);
+   }
+
+   if (waitForFrames(slMilliSecsV) == false)
+   {
+      return (false);
+   }
+
+   return (read(clFrameR));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanFrameQueue::readFrames()                                                                                       //
+// read all available frames, called by the consumer                                                                  //
+//--------------------------------------------------------------------------------------------------------------------//
+int32_t QCanFrameQueue::readFrames(QVector<QCanFrame> & clFrameListR, int32_t slFrameMaxV)
+{
+   uint32_t ulTailT = ulTailP.loadAcquire();
+   uint32_t ulCountT;
+   uint32_t ulIdxT;
+
+   ulCountT = ulHeadP.loadAcquire() - ulTailT;
+   if ((slFrameMaxV >= 0) && (ulCountT > (uint32_t) slFrameMaxV))
+   {
+      ulCountT = (uint32_t) slFrameMaxV;
+   }
+
+   clFrameListR.reserve(clFrameListR.size() + (int32_t) ulCountT);
+   for (ulIdxT = 0; ulIdxT < ulCountT; ulIdxT++)
+   {
+      clFrameListR.append(clBufferP.at((ulTailT + ulIdxT) & ulMaskP));
+   }
+   ulTailP.storeRelease(ulTailT + ulCountT);
+
+   return ((int32_t) ulCountT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanFrameQueue::waitForFrames()                                                                                    //
+// wait for frames, called by the consumer                                                                            //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanFrameQueue::waitForFrames(int32_t slMilliSecsV)
+{
+   bool  btWakeUpT = false;
+
+   if (framesAvailable() > 0)
+   {
+      return (true);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // announce the waiting consumer, a frame which has been appended in the meantime is detected by the
+   // second test
+   //
+   slWaitingP.fetchAndStoreOrdered(1);
+   if (ulHeadP.fetchAndAddOrdered(0) == ulTailP.loadAcquire())
+   {
+      btWakeUpT = clWakeUpP.tryAcquire(1, slMilliSecsV);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // if the consumer has not been woken up, the flag is reset: if the producer has already reset it,
+   // the semaphore is released in a moment and must be taken
+   //
+   if (btWakeUpT == false)
+   {
+      if (slWaitingP.testAndSetOrdered(1, 0) == false)
+      {
+         clWakeUpP.acquire();
+      }
+   }
+
+   return (framesAvailable() > 0);
+}
@@ -0,0 +1,199 @@
+//====================================================================================================================//
+// File:          qcan_frame_queue.hpp                                                                                //
+// Description:   QCAN classes - CAN frame queue                                                                      //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+#ifndef QCAN_FRAME_QUEUE_HPP_
+#define QCAN_FRAME_QUEUE_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QSemaphore>
+#include <QtCore/QVector>
+
+#include "qcan_frame.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_FRAME_QUEUE_SIZE
+** \ingroup QCAN_NW
+** \brief   Default size of a frame queue
+**
+** This symbol defines the default number of CAN frames of a
+** QCanFrameQueue. The size is rounded up to a power of 2.
+*/
+#define  QCAN_FRAME_QUEUE_SIZE         4096
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanFrameQueue
+** \brief Lock-free queue of CAN frames
+**
+** A QCanFrameQueue passes CAN frames from one producer thread to one consumer thread without a lock. The
+** producer appends frames by append(), the consumer reads them by read(), readFrames() or readBlocking().
+** If the queue is full, append() drops the frame and increments framesLost().
+** <p>
+** A consumer thread which waits for frames (waitForFrames(), readBlocking()) sleeps on a semaphore. The
+** producer only touches the semaphore if the consumer is waiting, so the effort of append() is a copy of the
+** frame and two atomic operations. The wake-up latency is the one of the operating system for a thread
+** waiting on a semaphore.
+*/
+class QCanFrameQueue
+{
+public:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ulSizeV        Number of CAN frames
+   **
+   ** Create a queue for \a ulSizeV CAN frames, the value is rounded up to a power of 2.
+   */
+   QCanFrameQueue(uint32_t ulSizeV = QCAN_FRAME_QUEUE_SIZE);
+
+   ~QCanFrameQueue();
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameR       Reference to CAN frame
+   ** \return     \c true if the CAN frame has been appended
+   **
+   ** The function appends the CAN frame \a clFrameR to the queue and wakes up a waiting consumer. It
+   ** must only be called by the producer thread. If the queue is full, the function returns \c false.
+   */
+   bool     append(const QCanFrame & clFrameR);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of CAN frames
+   **
+   ** The function returns the number of CAN frames which are available for reading.
+   */
+   int32_t  framesAvailable(void) const;
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of lost CAN frames
+   **
+   ** The function returns the number of CAN frames which have been dropped because the queue was full.
+   */
+   uint32_t framesLost(void) const     { return (ulLostP.loadAcquire()); };
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[out] clFrameR       Reference to CAN frame
+   ** \return     \c true if a CAN frame was read
+   **
+   ** The function reads the next CAN frame of the queue. It must only be called by the consumer
+   ** thread. If no CAN frame is available, the function returns \c false.
+   */
+   bool     read(QCanFrame & clFrameR);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[out] clFrameR       Reference to CAN frame
+   ** \param[in]  slMilliSecsV   Timeout in milli-seconds
+   ** \return     \c true if a CAN frame was read
+   **
+   ** The function waits up to \a slMilliSecsV milli-seconds for a CAN frame and reads it. It must only
+   ** be called by the consumer thread.
+   */
+   bool     readBlocking(QCanFrame & clFrameR, int32_t slMilliSecsV);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[out] clFrameListR   List of CAN frames
+   ** \param[in]  slFrameMaxV    Maximum number of frames, -1 reads all available frames
+   ** \return     Number of CAN frames appended to \a clFrameListR
+   **
+   ** The function appends the available CAN frames to \a clFrameListR. It must only be called by the
+   ** consumer thread.
+   */
+   int32_t  readFrames(QVector<QCanFrame> & clFrameListR, int32_t slFrameMaxV = -1);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of CAN frames
+   **
+   ** The function returns the maximum number of CAN frames of the queue.
+   */
+   uint32_t size(void) const           { return (ulMaskP + 1); };
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slMilliSecsV   Timeout in milli-seconds
+   ** \return     \c true if CAN frames are available
+   **
+   ** The function blocks the consumer thread until CAN frames are available or \a slMilliSecsV
+   ** milli-seconds have passed.
+   */
+   bool     waitForFrames(int32_t slMilliSecsV);
+
+private:
+
+   Q_DISABLE_COPY(QCanFrameQueue)
+
+   QVector<QCanFrame>         clBufferP;
+   uint32_t                   ulMaskP;
+
+   //----------------------------------------------------------------
+   // ulHeadP is only written by the producer, ulTailP only by the
+   // consumer, both are free running
+   //
+   QAtomicInteger<uint32_t>   ulHeadP;
+   QAtomicInteger<uint32_t>   ulTailP;
+   QAtomicInteger<uint32_t>   ulLostP;
+
+   //----------------------------------------------------------------
+   // the consumer sets slWaitingP before it sleeps on the semaphore,
+   // the producer which resets it releases the semaphore
+   //
+   QAtomicInt                 slWaitingP;
+   QSemaphore                 clWakeUpP;
+};
+
+#endif   // QCAN_FRAME_QUEUE_HPP_
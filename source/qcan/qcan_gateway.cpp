@@ -0,0 +1,432 @@
+//====================================================================================================================//
+// File:          qcan_gateway.cpp                                                                                    //
+// Description:   QCAN classes - CAN gateway                                                                          //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#include "qcan_gateway.hpp"
+#include "qcan_network.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#define  GATEWAY_STD_ID_COUNT          ((uint32_t) 2048)
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class methods                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanGateway()                                                                                                      //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanGateway::QCanGateway(QObject * pclParentV)
+{
+   this->setParent(pclParentV);
+
+   clRuleListP.reserve(QCAN_GATEWAY_RULE_MAX);
+   clStatisticListP.reserve(QCAN_GATEWAY_RULE_MAX);
+   clNextTimeListP.reserve(QCAN_GATEWAY_RULE_MAX);
+
+   compileRules();
+
+   clTimeP.start();
+
+   connect(&clRefreshTimerP, SIGNAL(timeout()), this, SLOT(onTimerEvent()));
+   clRefreshTimerP.start(1000);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// ~QCanGateway()                                                                                                     //
+// destructor                                                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanGateway::~QCanGateway()
+{
+   clRefreshTimerP.stop();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanGateway::addNetwork()                                                                                          //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanGateway::addNetwork(QCanNetwork * pclNetworkV)
+{
+   if ((pclNetworkV->id() > 0) && (pclNetworkV->id() <= QCAN_NETWORK_MAX))
+   {
+      if (clNetworkListP.size() < pclNetworkV->id())
+      {
+         clNetworkListP.resize(pclNetworkV->id());
+      }
+      clNetworkListP[pclNetworkV->id() - 1] = pclNetworkV;
+      pclNetworkV->setGateway(this);
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanGateway::addRule()                                                                                             //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+int32_t QCanGateway::addRule(const GatewayRule_ts & tsRuleR)
+{
+   GatewayStatistic_ts  tsStatisticT;
+   int32_t              slRuleIdxT = -1;
+
+   if ( (clRuleListP.size() < QCAN_GATEWAY_RULE_MAX)                                         &&
+        (tsRuleR.teSrcChannel > eCAN_CHANNEL_NONE) && (tsRuleR.teSrcChannel <= QCAN_NETWORK_MAX) &&
+        (tsRuleR.teDstChannel > eCAN_CHANNEL_NONE) && (tsRuleR.teDstChannel <= QCAN_NETWORK_MAX) &&
+        (tsRuleR.teSrcChannel != tsRuleR.teDstChannel)                                          )
+   {
+      tsStatisticT.ulMatchCount   = 0;
+      tsStatisticT.ulForwardCount = 0;
+      tsStatisticT.ulDropCount    = 0;
+      tsStatisticT.ulLatencyMin   = 0xFFFFFFFF;
+      tsStatisticT.ulLatencyMax   = 0;
+      tsStatisticT.uqLatencySum   = 0;
+
+      slRuleIdxT = clRuleListP.size();
+      clRuleListP.append(tsRuleR);
+      clStatisticListP.append(tsStatisticT);
+      clNextTimeListP.append(0);
+
+      compileRules();
+   }
+
+   return (slRuleIdxT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanGateway::clearRules()                                                                                          //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanGateway::clearRules(void)
+{
+   clRuleListP.clear();
+   clStatisticListP.clear();
+   clNextTimeListP.clear();
+
+   compileRules();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanGateway::compileRules()                                                                                        //
+// build the lookup tables of all source networks                                                                     //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanGateway::compileRules(void)
+{
+   GatewayTable_s *  ptsTableT;
+   int32_t           slRuleIdxT;
+   uint32_t          ulIdT;
+   uint32_t          ulMaskT;
+   uint64_t          uqRuleBitT;
+
+   for (ulIdT = 0; ulIdT < QCAN_NETWORK_MAX; ulIdT++)
+   {
+      atsTableP[ulIdT].clStdMask.clear();
+      atsTableP[ulIdT].clExtMask.clear();
+      atsTableP[ulIdT].uqExtMaskedRules = 0;
+   }
+
+   for (slRuleIdxT = 0; slRuleIdxT < clRuleListP.size(); slRuleIdxT++)
+   {
+      const GatewayRule_ts & tsRuleT = clRuleListP.at(slRuleIdxT);
+
+      ptsTableT  = &atsTableP[tsRuleT.teSrcChannel - 1];
+      uqRuleBitT = ((uint64_t) 1) << slRuleIdxT;
+
+      if (tsRuleT.btExtended == false)
+      {
+         //-------------------------------------------------------------------------------------------
+         // standard identifier: all matching identifiers are marked in the table
+         //
+         if (ptsTableT->clStdMask.isEmpty())
+         {
+            ptsTableT->clStdMask.fill(0, GATEWAY_STD_ID_COUNT);
+         }
+
+         ulMaskT = tsRuleT.ulIdMask & QCAN_FRAME_ID_MASK_STD;
+         for (ulIdT = 0; ulIdT < GATEWAY_STD_ID_COUNT; ulIdT++)
+         {
+            if ((ulIdT & ulMaskT) == (tsRuleT.ulIdMatch & ulMaskT))
+            {
+               ptsTableT->clStdMask[ulIdT] |= uqRuleBitT;
+            }
+         }
+      }
+      else
+      {
+         //-------------------------------------------------------------------------------------------
+         // extended identifier: a rule for a single identifier is placed in the hash, all other
+         // rules are tested for each frame
+         //
+         ulMaskT = tsRuleT.ulIdMask & QCAN_FRAME_ID_MASK_EXT;
+         if (ulMaskT == QCAN_FRAME_ID_MASK_EXT)
+         {
+            ulIdT = tsRuleT.ulIdMatch & QCAN_FRAME_ID_MASK_EXT;
+            ptsTableT->clExtMask[ulIdT] |= uqRuleBitT;
+         }
+         else
+         {
+            ptsTableT->uqExtMaskedRules |= uqRuleBitT;
+         }
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanGateway::onTimerEvent()                                                                                        //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanGateway::onTimerEvent(void)
+{
+   int32_t     slRuleIdxT;
+   uint32_t    ulLatencyT;
+
+   for (slRuleIdxT = 0; slRuleIdxT < clStatisticListP.size(); slRuleIdxT++)
+   {
+      const GatewayStatistic_ts & tsStatisticT = clStatisticListP.at(slRuleIdxT);
+
+      ulLatencyT = 0;
+      if (tsStatisticT.ulForwardCount > 0)
+      {
+         ulLatencyT = (uint32_t) (tsStatisticT.uqLatencySum / tsStatisticT.ulForwardCount);
+      }
+
+      emit showStatistic(slRuleIdxT, tsStatisticT.ulForwardCount, tsStatisticT.ulDropCount, ulLatencyT);
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanGateway::route()                                                                                               //
+// forward CAN frame according to the compiled rules                                                                  //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanGateway::route(uint8_t ubChannelV, const QByteArray & clSockDataR)
+{
+   GatewayTable_s *  ptsTableT;
+   QCanNetwork *     pclNetworkT;
+   QCanFrame         clFrameT;
+   QCanFrame         clFrameOutT;
+   int64_t           sqStartT;
+   int64_t           sqTimeT;
+   uint64_t          uqRulesT;
+   uint64_t          uqMaskedT;
+   uint32_t          ulIdT;
+   uint32_t          ulLatencyT;
+   int32_t           slRuleIdxT;
+
+   if ((ubChannelV == 0) || (ubChannelV > QCAN_NETWORK_MAX))
+   {
+      return;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // leave as early as possible if there is no rule for the network
+   //
+   ptsTableT = &atsTableP[ubChannelV - 1];
+   if (ptsTableT->clStdMask.isEmpty() && ptsTableT->clExtMask.isEmpty() && (ptsTableT->uqExtMaskedRules == 0))
+   {
+      return;
+   }
+
+   sqStartT = clTimeP.nsecsElapsed();
+
+   if (clFrameT.fromByteArray(clSockDataR) == false)
+   {
+      return;
+   }
+
+   if (clFrameT.frameType() != QCanFrame::eFRAME_TYPE_DATA)
+   {
+      return;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // look up matching rules
+   //
+   ulIdT = clFrameT.identifier();
+   if (clFrameT.isExtended() == false)
+   {
+      uqRulesT = 0;
+      if (ptsTableT->clStdMask.isEmpty() == false)
+      {
+         uqRulesT = ptsTableT->clStdMask.at(ulIdT & QCAN_FRAME_ID_MASK_STD);
+      }
+   }
+   else
+   {
+      uqRulesT  = ptsTableT->clExtMask.value(ulIdT, 0);
+      uqMaskedT = ptsTableT->uqExtMaskedRules;
+      for (slRuleIdxT = 0; uqMaskedT != 0; slRuleIdxT++, uqMaskedT = uqMaskedT >> 1)
+      {
+         if ((uqMaskedT & 1) > 0)
+         {
+            const GatewayRule_ts & tsRuleT = clRuleListP.at(slRuleIdxT);
+            if ((ulIdT & tsRuleT.ulIdMask) == (tsRuleT.ulIdMatch & tsRuleT.ulIdMask))
+            {
+               uqRulesT |= ((uint64_t) 1) << slRuleIdxT;
+            }
+         }
+      }
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // forward the frame for each matching rule
+   //
+   for (slRuleIdxT = 0; uqRulesT != 0; slRuleIdxT++, uqRulesT = uqRulesT >> 1)
+   {
+      if ((uqRulesT & 1) == 0)
+      {
+         continue;
+      }
+
+      const GatewayRule_ts &  tsRuleT      = clRuleListP.at(slRuleIdxT);
+      GatewayStatistic_ts &   tsStatisticT = clStatisticListP[slRuleIdxT];
+
+      tsStatisticT.ulMatchCount++;
+
+      //-------------------------------------------------------------------------------------------
+      // destination network must be enabled
+      //
+      pclNetworkT = Q_NULLPTR;
+      if (tsRuleT.teDstChannel <= clNetworkListP.size())
+      {
+         pclNetworkT = clNetworkListP.at(tsRuleT.teDstChannel - 1);
+      }
+      if ((pclNetworkT == Q_NULLPTR) || (pclNetworkT->isNetworkEnabled() == false))
+      {
+         tsStatisticT.ulDropCount++;
+         continue;
+      }
+
+      //-------------------------------------------------------------------------------------------
+      // rate limit: minimum time between two frames
+      //
+      if (tsRuleT.ulRateLimit > 0)
+      {
+         sqTimeT = clTimeP.nsecsElapsed();
+         if (sqTimeT < clNextTimeListP.at(slRuleIdxT))
+         {
+            tsStatisticT.ulDropCount++;
+            continue;
+         }
+         clNextTimeListP[slRuleIdxT] = sqTimeT + (((int64_t) 1000000000) / tsRuleT.ulRateLimit);
+      }
+
+      //-------------------------------------------------------------------------------------------
+      // frame format conversion
+      //
+      clFrameOutT = clFrameT;
+      if (tsRuleT.teConvert == eGATEWAY_CONVERT_CLASSIC)
+      {
+         if (clFrameOutT.dlc() > 8)
+         {
+            tsStatisticT.ulDropCount++;
+            continue;
+         }
+         clFrameOutT.setFrameFormat(clFrameOutT.isExtended() ? QCanFrame::eFORMAT_CAN_EXT :
+                                                               QCanFrame::eFORMAT_CAN_STD);
+      }
+      else if (tsRuleT.teConvert == eGATEWAY_CONVERT_FD)
+      {
+         if (clFrameOutT.isRemote() == true)
+         {
+            tsStatisticT.ulDropCount++;
+            continue;
+         }
+         clFrameOutT.setFrameFormat(clFrameOutT.isExtended() ? QCanFrame::eFORMAT_FD_EXT :
+                                                               QCanFrame::eFORMAT_FD_STD);
+      }
+
+      //-------------------------------------------------------------------------------------------
+      // identifier remap
+      //
+      if (tsRuleT.ulIdRemapMask != 0)
+      {
+         clFrameOutT.setIdentifier((ulIdT & (~tsRuleT.ulIdRemapMask)) |
+                                   (tsRuleT.ulIdRemapValue & tsRuleT.ulIdRemapMask));
+      }
+
+      //-------------------------------------------------------------------------------------------
+      // pass frame to the destination network and update the latency
+      //
+      pclNetworkT->handleCanFrame(QCanNetwork::eFRAME_SOURCE_GATEWAY, 0, clFrameOutT.toByteArray());
+
+      ulLatencyT = (uint32_t) (clTimeP.nsecsElapsed() - sqStartT);
+      tsStatisticT.ulForwardCount++;
+      tsStatisticT.uqLatencySum += ulLatencyT;
+      if (ulLatencyT < tsStatisticT.ulLatencyMin)
+      {
+         tsStatisticT.ulLatencyMin = ulLatencyT;
+      }
+      if (ulLatencyT > tsStatisticT.ulLatencyMax)
+      {
+         tsStatisticT.ulLatencyMax = ulLatencyT;
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanGateway::statistic()                                                                                           //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+GatewayStatistic_ts QCanGateway::statistic(int32_t slRuleIdxV)
+{
+   GatewayStatistic_ts  tsStatisticT;
+
+   tsStatisticT.ulMatchCount   = 0;
+   tsStatisticT.ulForwardCount = 0;
+   tsStatisticT.ulDropCount    = 0;
+   tsStatisticT.ulLatencyMin   = 0;
+   tsStatisticT.ulLatencyMax   = 0;
+   tsStatisticT.uqLatencySum   = 0;
+
+   if ((slRuleIdxV >= 0) && (slRuleIdxV < clStatisticListP.size()))
+   {
+      tsStatisticT = clStatisticListP.at(slRuleIdxV);
+   }
+
+   return (tsStatisticT);
+}
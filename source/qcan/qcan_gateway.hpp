@@ -0,0 +1,264 @@
+//====================================================================================================================//
+// File:          qcan_gateway.hpp                                                                                    //
+// Description:   QCAN classes - CAN gateway                                                                          //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+#ifndef QCAN_GATEWAY_HPP_
+#define QCAN_GATEWAY_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include "qcan_defs.hpp"
+#include "qcan_frame.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_GATEWAY_RULE_MAX
+** \ingroup QCAN_NW
+** \brief   Maximum number of gateway rules
+**
+** This symbol defines the maximum number of rules of a QCanGateway.
+*/
+#define  QCAN_GATEWAY_RULE_MAX      64
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Referenced classes                                                                                                 **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+class QCanNetwork;
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Structures                                                                                                         **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------------------------------
+// Conversion of the frame format
+//
+enum GatewayConvert_e {
+   eGATEWAY_CONVERT_NONE = 0,
+   eGATEWAY_CONVERT_CLASSIC,
+   eGATEWAY_CONVERT_FD
+};
+
+
+//-----------------------------------------------------------------------------------------------------
+// Gateway rule
+//
+typedef struct GatewayRule_s {
+
+   //--------------------------------------------------------------------------
+   // CAN channel of the source and destination network
+   //
+   CAN_Channel_e     teSrcChannel;
+   CAN_Channel_e     teDstChannel;
+
+   //--------------------------------------------------------------------------
+   // A frame matches if (identifier & ulIdMask) == (ulIdMatch & ulIdMask),
+   // btExtended selects standard or extended frames
+   //
+   uint32_t          ulIdMatch;
+   uint32_t          ulIdMask;
+   bool              btExtended;
+
+   //--------------------------------------------------------------------------
+   // The bits of ulIdRemapMask are replaced by the bits of ulIdRemapValue,
+   // a value of 0 for ulIdRemapMask keeps the identifier
+   //
+   uint32_t          ulIdRemapValue;
+   uint32_t          ulIdRemapMask;
+
+   //--------------------------------------------------------------------------
+   // Conversion between classic CAN and CAN FD: a CAN FD frame with more
+   // than 8 data bytes and a remote frame are not converted
+   //
+   GatewayConvert_e  teConvert;
+
+   //--------------------------------------------------------------------------
+   // Maximum number of frames per second, a value of 0 disables the limit
+   //
+   uint32_t          ulRateLimit;
+
+} GatewayRule_ts;
+
+
+//-----------------------------------------------------------------------------------------------------
+// Statistic of a gateway rule, the latency is measured in nanoseconds
+// from reception of a frame until it is passed to the destination network
+//
+typedef struct GatewayStatistic_s {
+   uint32_t  ulMatchCount;
+   uint32_t  ulForwardCount;
+   uint32_t  ulDropCount;
+   uint32_t  ulLatencyMin;
+   uint32_t  ulLatencyMax;
+   uint64_t  uqLatencySum;
+} GatewayStatistic_ts;
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanGateway
+** \brief Forwarding of CAN frames between CAN networks
+**
+** The gateway forwards CAN frames between the CAN networks of a QCanServer according to a set of rules (see
+** addRule()). A rule selects frames of a source network by identifier and mask, the frame is passed to the
+** destination network with an optional identifier remap, frame format conversion and rate limit.
+** <p>
+** The gateway is called by QCanNetwork for every frame, the frame is passed to the destination network
+** without a socket connection. The rules of a source network are compiled into a lookup table: a
+** table with one entry per standard identifier and a hash for extended identifiers, so the effort
+** for a frame does not depend on the number of rules. Frames which are forwarded by the gateway are not
+** forwarded again.
+** <p>
+** The statistic of each rule is available by statistic(), the signal showStatistic() is emitted every
+** second.
+*/
+class QCanGateway : public QObject
+{
+   Q_OBJECT
+public:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclParentV     Pointer to QObject parent class
+   **
+   ** Create a new gateway without rules.
+   */
+   QCanGateway(QObject * pclParentV = Q_NULLPTR);
+
+   ~QCanGateway();
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclNetworkV    Pointer to CAN network
+   **
+   ** Add a CAN network to the gateway, the CAN channel is taken from QCanNetwork::id().
+   */
+   void  addNetwork(QCanNetwork * pclNetworkV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  tsRuleR        Gateway rule
+   ** \return     Index of rule or -1 on failure
+   **
+   ** Add a rule to the gateway. The function fails if #QCAN_GATEWAY_RULE_MAX rules are defined or if
+   ** the source and destination channel are not valid.
+   */
+   int32_t  addRule(const GatewayRule_ts & tsRuleR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** Remove all rules of the gateway.
+   */
+   void  clearRules(void);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of rules
+   */
+   int32_t  ruleCount(void)         { return (clRuleListP.size());  };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ubChannelV     CAN channel of the frame
+   ** \param[in]  clSockDataR    CAN frame as byte array
+   **
+   ** This function is called by a QCanNetwork for every frame.
+   */
+   void  route(uint8_t ubChannelV, const QByteArray & clSockDataR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slRuleIdxV     Index of rule
+   ** \return     Statistic of the rule
+   */
+   GatewayStatistic_ts  statistic(int32_t slRuleIdxV);
+
+signals:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slRuleIdxR     Index of rule
+   ** \param[in]  ulForwardCntR  Number of forwarded frames
+   ** \param[in]  ulDropCntR     Number of dropped frames
+   ** \param[in]  ulLatencyR     Average latency in nanoseconds
+   **
+   ** This signal is emitted every second for each rule.
+   */
+   void  showStatistic(const int32_t & slRuleIdxR, const uint32_t & ulForwardCntR,
+                       const uint32_t & ulDropCntR, const uint32_t & ulLatencyR);
+
+private slots:
+
+   void  onTimerEvent(void);
+
+private:
+
+   void  compileRules(void);
+
+   //----------------------------------------------------------------
+   // compiled rules of a source network, bit n of a mask value
+   // selects rule n
+   //
+   struct GatewayTable_s {
+      QVector<uint64_t>          clStdMask;
+      QHash<uint32_t, uint64_t>  clExtMask;
+      uint64_t                   uqExtMaskedRules;
+   };
+
+   QVector<GatewayRule_ts>       clRuleListP;
+   QVector<GatewayStatistic_ts>  clStatisticListP;
+   QVector<int64_t>              clNextTimeListP;
+
+   GatewayTable_s                atsTableP[QCAN_NETWORK_MAX];
+
+   QVector<QCanNetwork *>        clNetworkListP;
+
+   QElapsedTimer                 clTimeP;
+   QTimer                        clRefreshTimerP;
+};
+
+#endif   // QCAN_GATEWAY_HPP_
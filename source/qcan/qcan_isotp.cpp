@@ -0,0 +1,1140 @@
+//====================================================================================================================//
+// File:          qcan_isotp.cpp                                                                                      //
+// Description:   QCAN classes - ISO-TP transport protocol                                                            //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "qcan_isotp.hpp"
+#include "qcan_socket.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// protocol control information (PCI), upper nibble of byte 0
+//
+#define  ISOTP_PCI_SINGLE        0x00
+#define  ISOTP_PCI_FIRST         0x10
+#define  ISOTP_PCI_CONSECUTIVE   0x20
+#define  ISOTP_PCI_FLOW_CONTROL  0x30
+
+//-------------------------------------------------------------------
+// flow status of a flow control frame
+//
+#define  ISOTP_FLOW_CTS          0x00
+#define  ISOTP_FLOW_WAIT         0x01
+#define  ISOTP_FLOW_OVERFLOW     0x02
+
+//-------------------------------------------------------------------
+// state of transmission and reception
+//
+#define  ISOTP_STATE_IDLE        0
+#define  ISOTP_STATE_WAIT_FC     1
+#define  ISOTP_STATE_SENDING     2
+#define  ISOTP_STATE_RECEIVING   3
+
+//-------------------------------------------------------------------
+// the receive identifier of a channel is the key of the channel
+// index, bit 31 marks the extended frame format
+//
+#define  ISOTP_CHANNEL_KEY(ID, EXT)    ((ID) | ((EXT) ? 0x80000000UL : 0))
+
+#define  ISOTP_TIME_NONE         ((int64_t) 0x7FFFFFFFFFFFFFFFLL)
+#define  ISOTP_SPIN_TIME_NS      ((int64_t) QCAN_ISOTP_SPIN_TIME * 1000)
+#define  ISOTP_MS_NS             ((int64_t) 1000000)
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Static functions                                                                                                   **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//--------------------------------------------------------------------------------------------------------------------//
+// isoTpFrameSize()                                                                                                   //
+// smallest CAN FD data size which holds ubSizeV bytes                                                                //
+//--------------------------------------------------------------------------------------------------------------------//
+static uint8_t isoTpFrameSize(uint8_t ubSizeV)
+{
+   static const uint8_t aubSizeS[] = { 8, 12, 16, 20, 24, 32, 48, 64 };
+
+   for (uint8_t ubIdxT = 0; ubIdxT < sizeof(aubSizeS); ubIdxT++)
+   {
+      if (ubSizeV <= aubSizeS[ubIdxT])
+      {
+         return ((ubSizeV <= 8) ? ubSizeV : aubSizeS[ubIdxT]);
+      }
+   }
+
+   return (64);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// isoTpSepTimeDecode()                                                                                               //
+// convert STmin of a flow control frame to nano-seconds                                                              //
+//--------------------------------------------------------------------------------------------------------------------//
+static int64_t isoTpSepTimeDecode(uint8_t ubSepTimeV)
+{
+   if (ubSepTimeV <= 0x7F)
+   {
+      return (((int64_t) ubSepTimeV) * ISOTP_MS_NS);
+   }
+
+   if ((ubSepTimeV >= 0xF1) && (ubSepTimeV <= 0xF9))
+   {
+      return (((int64_t) (ubSepTimeV - 0xF0)) * 100000);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // reserved values are treated like the maximum value (ISO 15765-2)
+   //
+   return (((int64_t) 0x7F) * ISOTP_MS_NS);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// isoTpSepTimeEncode()                                                                                               //
+// convert separation time in micro-seconds to STmin, the value is rounded up                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+static uint8_t isoTpSepTimeEncode(uint32_t ulSepTimeV)
+{
+   if (ulSepTimeV == 0)
+   {
+      return (0x00);
+   }
+
+   if (ulSepTimeV <= 900)
+   {
+      return ((uint8_t) (0xF0 + ((ulSepTimeV + 99) / 100)));
+   }
+
+   if (ulSepTimeV >= 127000)
+   {
+      return (0x7F);
+   }
+
+   return ((uint8_t) ((ulSepTimeV + 999) / 1000));
+}
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class methods                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp()                                                                                                        //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanIsoTp::QCanIsoTp(QCanSocket * pclSocketV, QObject * pclParentV)
+   : QObject(pclParentV)
+{
+   pclSocketP       = pclSocketV;
+   btSocketReadingP = false;
+   btProcessP       = false;
+
+   //---------------------------------------------------------------------------------------------------
+   // the channel list is not re-allocated, so a signal handler may add channels
+   //
+   clChannelListP.reserve(QCAN_ISOTP_CHANNEL_MAX);
+   clChannelIndexP.reserve(QCAN_ISOTP_CHANNEL_MAX);
+   clTrmListP.reserve(QCAN_ISOTP_BATCH_MAX * 2);
+
+   clClockP.start();
+
+   //---------------------------------------------------------------------------------------------------
+   // the timer is only running while a transmission or reception is pending
+   //
+   clTimerP.setTimerType(Qt::PreciseTimer);
+   clTimerP.setSingleShot(true);
+   connect(&clTimerP, SIGNAL(timeout()), this, SLOT(onTimerEvent()));
+
+   setSocketReading(true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// ~QCanIsoTp()                                                                                                       //
+// destructor                                                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanIsoTp::~QCanIsoTp()
+{
+   clTimerP.stop();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::abortReceive()                                                                                          //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::abortReceive(int32_t slChannelV, Error_e teErrorV)
+{
+   clChannelListP[slChannelV].ubRcvState   = ISOTP_STATE_IDLE;
+   clChannelListP[slChannelV].clRcvMessage = QByteArray();
+
+   emit error(slChannelV, teErrorV);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::abortTransmit()                                                                                         //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::abortTransmit(int32_t slChannelV, Error_e teErrorV)
+{
+   clChannelListP[slChannelV].ubTrmState   = ISOTP_STATE_IDLE;
+   clChannelListP[slChannelV].clTrmMessage = QByteArray();
+
+   emit error(slChannelV, teErrorV);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::addChannel()                                                                                            //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+int32_t QCanIsoTp::addChannel(const Config_s & tsConfigR)
+{
+   Channel_s   tsChannelT;
+   uint32_t    ulIdMaxT;
+   uint32_t    ulKeyT;
+   int32_t     slChannelT;
+
+   //---------------------------------------------------------------------------------------------------
+   // check parameters
+   //
+   ulIdMaxT = (tsConfigR.btExtended == true) ? 0x1FFFFFFF : 0x7FF;
+   if ((tsConfigR.ulTrmId > ulIdMaxT) || (tsConfigR.ulRcvId > ulIdMaxT))
+   {
+      return (-1);
+   }
+
+   if ((tsConfigR.ubFrameSize < 8) || (isoTpFrameSize(tsConfigR.ubFrameSize) != tsConfigR.ubFrameSize) ||
+       ((tsConfigR.btCanFd == false) && (tsConfigR.ubFrameSize != 8)))
+   {
+      return (-1);
+   }
+
+   ulKeyT = ISOTP_CHANNEL_KEY(tsConfigR.ulRcvId, tsConfigR.btExtended);
+   if ((clChannelIndexP.contains(ulKeyT)) || (clChannelIndexP.size() >= QCAN_ISOTP_CHANNEL_MAX))
+   {
+      return (-1);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // initialise the channel, a timeout of 0 or a maximum message size of 0 selects the default value
+   //
+   tsChannelT.tsConfig        = tsConfigR;
+   tsChannelT.btUsed          = true;
+   if (tsChannelT.tsConfig.ulTimeout == 0)
+   {
+      tsChannelT.tsConfig.ulTimeout = QCAN_ISOTP_TIMEOUT;
+   }
+   if (tsChannelT.tsConfig.ulMessageMax == 0)
+   {
+      tsChannelT.tsConfig.ulMessageMax = QCAN_ISOTP_MESSAGE_MAX;
+   }
+
+   tsChannelT.slTrmPos        = 0;
+   tsChannelT.ubTrmState      = ISOTP_STATE_IDLE;
+   tsChannelT.ubTrmSeq        = 0;
+   tsChannelT.ubTrmBlockSize  = 0;
+   tsChannelT.uwTrmBlockCnt   = 0;
+   tsChannelT.ubTrmWaitCnt    = 0;
+   tsChannelT.sqTrmSepTime    = 0;
+   tsChannelT.sqTrmDue        = ISOTP_TIME_NONE;
+
+   tsChannelT.slRcvPos        = 0;
+   tsChannelT.ubRcvState      = ISOTP_STATE_IDLE;
+   tsChannelT.ubRcvSeq        = 0;
+   tsChannelT.ubRcvFrameSize  = 0;
+   tsChannelT.uwRcvBlockCnt   = 0;
+   tsChannelT.sqRcvDue        = ISOTP_TIME_NONE;
+
+   if (clFreeListP.isEmpty())
+   {
+      slChannelT = clChannelListP.size();
+      clChannelListP.append(tsChannelT);
+   }
+   else
+   {
+      slChannelT = clFreeListP.takeLast();
+      clChannelListP[slChannelT] = tsChannelT;
+   }
+   clChannelIndexP.insert(ulKeyT, slChannelT);
+
+   return (slChannelT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::appendFrame()                                                                                           //
+// append frame to the transmit list, the payload is assembled in place and copied into the frame                     //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::appendFrame(Channel_s * ptsChannelV, const uint8_t * pubPciV, uint8_t ubPciSizeV,
+                            const uint8_t * pubDataV, uint8_t ubDataSizeV)
+{
+   QCanFrame::FrameFormat_e   teFormatT;
+   uint8_t                    aubDataT[QCAN_MSG_DATA_MAX];
+   uint8_t                    ubPosT;
+   uint8_t                    ubSizeT;
+   uint8_t                    ubFrameSizeT;
+
+   if (ptsChannelV->tsConfig.btCanFd == true)
+   {
+      teFormatT = (ptsChannelV->tsConfig.btExtended == true) ? QCanFrame::eFORMAT_FD_EXT :
+                                                                QCanFrame::eFORMAT_FD_STD;
+   }
+   else
+   {
+      teFormatT = (ptsChannelV->tsConfig.btExtended == true) ? QCanFrame::eFORMAT_CAN_EXT :
+                                                                QCanFrame::eFORMAT_CAN_STD;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // a CAN FD frame of more than 8 bytes is always padded up to the next data size, padding of
+   // shorter frames is optional
+   //
+   ubSizeT      = ubPciSizeV + ubDataSizeV;
+   ubFrameSizeT = isoTpFrameSize(ubSizeT);
+   if ((ptsChannelV->tsConfig.btPadding == true) && (ubFrameSizeT < 8))
+   {
+      ubFrameSizeT = 8;
+   }
+
+   clTrmListP.append(QCanFrame(teFormatT, ptsChannelV->tsConfig.ulTrmId));
+
+   QCanFrame & clFrameT = clTrmListP.last();
+   clFrameT.setDataSize(ubFrameSizeT);
+   if (ptsChannelV->tsConfig.btCanFd == true)
+   {
+      clFrameT.setBitrateSwitch(ptsChannelV->tsConfig.btBitrateSwitch);
+   }
+
+   memcpy(&aubDataT[0], pubPciV, ubPciSizeV);
+   if (ubDataSizeV > 0)
+   {
+      memcpy(&aubDataT[ubPciSizeV], pubDataV, ubDataSizeV);
+   }
+   if (ubFrameSizeT > ubSizeT)
+   {
+      memset(&aubDataT[ubSizeT], ptsChannelV->tsConfig.ubPaddingValue, ubFrameSizeT - ubSizeT);
+   }
+
+   for (ubPosT = 0; ubPosT < ubFrameSizeT; ubPosT++)
+   {
+      clFrameT.setData(ubPosT, aubDataT[ubPosT]);
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::defaultConfig()                                                                                         //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanIsoTp::Config_s QCanIsoTp::defaultConfig(uint32_t ulTrmIdV, uint32_t ulRcvIdV, bool btCanFdV)
+{
+   Config_s tsConfigT;
+
+   tsConfigT.ulTrmId          = ulTrmIdV;
+   tsConfigT.ulRcvId          = ulRcvIdV;
+   tsConfigT.btExtended       = false;
+   tsConfigT.btCanFd          = btCanFdV;
+   tsConfigT.btBitrateSwitch  = btCanFdV;
+   tsConfigT.ubFrameSize      = (btCanFdV == true) ? 64 : 8;
+   tsConfigT.btPadding        = true;
+   tsConfigT.ubPaddingValue   = 0xCC;
+   tsConfigT.ubBlockSize      = 0;
+   tsConfigT.ulSepTime        = 0;
+   tsConfigT.ulTimeout        = QCAN_ISOTP_TIMEOUT;
+   tsConfigT.ulMessageMax     = QCAN_ISOTP_MESSAGE_MAX;
+
+   return (tsConfigT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::flush()                                                                                                 //
+// write all frames of the transmit list with one call                                                                //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::flush(void)
+{
+   Channel_s * ptsChannelT;
+   int32_t     slChannelT;
+   int32_t     slIdxT;
+   int64_t     sqTimeT;
+   bool        btWrittenT;
+
+   //---------------------------------------------------------------------------------------------------
+   // a signal handler may start a new transmission, its frames are written by the next loop
+   //
+   while ((clTrmListP.isEmpty() == false) || (clSentListP.isEmpty() == false))
+   {
+      btWrittenT = true;
+      if (clTrmListP.isEmpty() == false)
+      {
+         btWrittenT = (pclSocketP->writeFrames(clTrmListP) == clTrmListP.size());
+         clTrmListP.resize(0);
+      }
+
+      //-------------------------------------------------------------------------------------------
+      // the separation time starts with the write of the frame
+      //
+      sqTimeT = clClockP.nsecsElapsed();
+      for (slIdxT = 0; slIdxT < clPacedListP.size(); slIdxT++)
+      {
+         ptsChannelT = &clChannelListP[clPacedListP.at(slIdxT)];
+         if ((ptsChannelT->btUsed == true) && (ptsChannelT->ubTrmState == ISOTP_STATE_SENDING))
+         {
+            ptsChannelT->sqTrmDue = sqTimeT + ptsChannelT->sqTrmSepTime;
+         }
+      }
+      clPacedListP.resize(0);
+
+      //-------------------------------------------------------------------------------------------
+      // a failed write aborts all transmissions, the receiving channels detect a timeout
+      //
+      if (btWrittenT == false)
+      {
+         for (slChannelT = 0; slChannelT < clChannelListP.size(); slChannelT++)
+         {
+            if ((clChannelListP.at(slChannelT).btUsed == true) &&
+                (clChannelListP.at(slChannelT).ubTrmState != ISOTP_STATE_IDLE))
+            {
+               abortTransmit(slChannelT, eERROR_SOCKET);
+            }
+         }
+      }
+
+      QVector<int32_t> clSentListT = clSentListP;
+      clSentListP.resize(0);
+      for (slIdxT = 0; slIdxT < clSentListT.size(); slIdxT++)
+      {
+         slChannelT = clSentListT.at(slIdxT);
+         if (clChannelListP.at(slChannelT).btUsed == true)
+         {
+            if (btWrittenT == true)
+            {
+               emit messageSent(slChannelT);
+            }
+            else
+            {
+               emit error(slChannelT, eERROR_SOCKET);
+            }
+         }
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::handleFrame()                                                                                           //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanIsoTp::handleFrame(const QCanFrame & clFrameR)
+{
+   bool  btResultT;
+
+   btResultT = receive(clFrameR);
+   process();
+
+   return (btResultT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::isBusy()                                                                                                //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanIsoTp::isBusy(int32_t slChannelV) const
+{
+   if ((slChannelV < 0) || (slChannelV >= clChannelListP.size()))
+   {
+      return (false);
+   }
+
+   return ((clChannelListP.at(slChannelV).btUsed == true) &&
+           (clChannelListP.at(slChannelV).ubTrmState != ISOTP_STATE_IDLE));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::onSocketReceive()                                                                                       //
+// read all frames of the socket                                                                                      //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::onSocketReceive(void)
+{
+   int32_t  slIdxT;
+
+   clRcvListP.resize(0);
+   if (pclSocketP->readFrames(clRcvListP) == 0)
+   {
+      return;
+   }
+
+   for (slIdxT = 0; slIdxT < clRcvListP.size(); slIdxT++)
+   {
+      if (receive(clRcvListP.at(slIdxT)) == false)
+      {
+         emit frameReceived(clRcvListP.at(slIdxT));
+      }
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // the frames which are due after the flow control frames are written with one call
+   //
+   process();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::onTimerEvent()                                                                                          //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::onTimerEvent(void)
+{
+   process();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::process()                                                                                               //
+// handle timeouts and consecutive frames which are due, start timer for the next event                               //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::process(void)
+{
+   Channel_s * ptsChannelT;
+   int32_t     slChannelT;
+   int64_t     sqTimeT;
+   int64_t     sqNextT;
+
+   //---------------------------------------------------------------------------------------------------
+   // a signal handler may call send() or handleFrame()
+   //
+   if (btProcessP == true)
+   {
+      return;
+   }
+   btProcessP = true;
+
+   sqTimeT = clClockP.nsecsElapsed();
+   for (slChannelT = 0; slChannelT < clChannelListP.size(); slChannelT++)
+   {
+      ptsChannelT = &clChannelListP[slChannelT];
+      if (ptsChannelT->btUsed == false)
+      {
+         continue;
+      }
+
+      if ((ptsChannelT->ubRcvState == ISOTP_STATE_RECEIVING) && (ptsChannelT->sqRcvDue <= sqTimeT))
+      {
+         abortReceive(slChannelT, eERROR_TIMEOUT_CR);
+         ptsChannelT = &clChannelListP[slChannelT];
+      }
+
+      if ((ptsChannelT->ubTrmState == ISOTP_STATE_WAIT_FC) && (ptsChannelT->sqTrmDue <= sqTimeT))
+      {
+         abortTransmit(slChannelT, eERROR_TIMEOUT_BS);
+      }
+      else if ((ptsChannelT->ubTrmState == ISOTP_STATE_SENDING) && (ptsChannelT->sqTrmDue <= sqTimeT))
+      {
+         transmit(slChannelT, sqTimeT);
+      }
+   }
+
+   flush();
+
+   //---------------------------------------------------------------------------------------------------
+   // search the next event
+   //
+   sqNextT = ISOTP_TIME_NONE;
+   for (slChannelT = 0; slChannelT < clChannelListP.size(); slChannelT++)
+   {
+      ptsChannelT = &clChannelListP[slChannelT];
+      if (ptsChannelT->btUsed == false)
+      {
+         continue;
+      }
+
+      if ((ptsChannelT->ubRcvState == ISOTP_STATE_RECEIVING) && (ptsChannelT->sqRcvDue < sqNextT))
+      {
+         sqNextT = ptsChannelT->sqRcvDue;
+      }
+
+      if ((ptsChannelT->ubTrmState != ISOTP_STATE_IDLE) && (ptsChannelT->sqTrmDue < sqNextT))
+      {
+         sqNextT = ptsChannelT->sqTrmDue;
+      }
+   }
+
+   if (sqNextT == ISOTP_TIME_NONE)
+   {
+      clTimerP.stop();
+   }
+   else
+   {
+      //-------------------------------------------------------------------------------------------
+      // a short wait is done by polling the clock, a longer one by the timer; frames which are due
+      // (after the wait or because a batch has been limited) are written by the next call after the
+      // event loop has been serviced, so every call writes at most one paced frame per channel and
+      // frames of other channels are received in between
+      //
+      sqNextT = sqNextT - clClockP.nsecsElapsed();
+      if (sqNextT < ISOTP_SPIN_TIME_NS)
+      {
+         sqNextT += clClockP.nsecsElapsed();
+         while (clClockP.nsecsElapsed() < sqNextT)
+         {
+         }
+         clTimerP.start(0);
+      }
+      else
+      {
+         clTimerP.start((int) (sqNextT / ISOTP_MS_NS));
+      }
+   }
+
+   btProcessP = false;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::receive()                                                                                               //
+// dispatch frame by its receive identifier and PCI                                                                   //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanIsoTp::receive(const QCanFrame & clFrameR)
+{
+   int32_t  slChannelT;
+
+   if (clFrameR.frameType() != QCanFrame::eFRAME_TYPE_DATA)
+   {
+      return (false);
+   }
+
+   slChannelT = clChannelIndexP.value(ISOTP_CHANNEL_KEY(clFrameR.identifier(), clFrameR.isExtended()), -1);
+   if (slChannelT < 0)
+   {
+      return (false);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // frames without PCI or with an unknown PCI are ignored
+   //
+   if ((clFrameR.dataSize() == 0) || (clFrameR.isRemote() == true))
+   {
+      return (true);
+   }
+
+   switch (clFrameR.constData()[0] & 0xF0)
+   {
+      case ISOTP_PCI_SINGLE:
+         receiveSingle(slChannelT, clFrameR);
+         break;
+
+      case ISOTP_PCI_FIRST:
+         receiveFirst(slChannelT, clFrameR);
+         break;
+
+      case ISOTP_PCI_CONSECUTIVE:
+         receiveConsecutive(slChannelT, clFrameR);
+         break;
+
+      case ISOTP_PCI_FLOW_CONTROL:
+         receiveFlowControl(slChannelT, clFrameR);
+         break;
+
+      default:
+         break;
+   }
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::receiveConsecutive()                                                                                    //
+// copy payload directly into the message buffer                                                                      //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::receiveConsecutive(int32_t slChannelV, const QCanFrame & clFrameR)
+{
+   Channel_s * ptsChannelT = &clChannelListP[slChannelV];
+   int32_t     slSizeT;
+   QByteArray  clMessageT;
+
+   if (ptsChannelT->ubRcvState != ISOTP_STATE_RECEIVING)
+   {
+      return;
+   }
+
+   if ((clFrameR.constData()[0] & 0x0F) != ptsChannelT->ubRcvSeq)
+   {
+      abortReceive(slChannelV, eERROR_SEQUENCE);
+      return;
+   }
+
+   slSizeT = qMin(ptsChannelT->clRcvMessage.size() - ptsChannelT->slRcvPos, clFrameR.dataSize() - 1);
+   memcpy(ptsChannelT->clRcvMessage.data() + ptsChannelT->slRcvPos, clFrameR.constData() + 1, slSizeT);
+   ptsChannelT->slRcvPos += slSizeT;
+   ptsChannelT->ubRcvSeq  = (ptsChannelT->ubRcvSeq + 1) & 0x0F;
+
+   //---------------------------------------------------------------------------------------------------
+   // the buffer is passed to the application, the engine releases its reference
+   //
+   if (ptsChannelT->slRcvPos == ptsChannelT->clRcvMessage.size())
+   {
+      clMessageT = ptsChannelT->clRcvMessage;
+      ptsChannelT->clRcvMessage = QByteArray();
+      ptsChannelT->ubRcvState   = ISOTP_STATE_IDLE;
+      emit messageReceived(slChannelV, clMessageT);
+      return;
+   }
+
+   ptsChannelT->sqRcvDue = clClockP.nsecsElapsed() + ((int64_t) ptsChannelT->tsConfig.ulTimeout) * ISOTP_MS_NS;
+   if (ptsChannelT->tsConfig.ubBlockSize > 0)
+   {
+      ptsChannelT->uwRcvBlockCnt++;
+      if (ptsChannelT->uwRcvBlockCnt == ptsChannelT->tsConfig.ubBlockSize)
+      {
+         ptsChannelT->uwRcvBlockCnt = 0;
+         sendFlowControl(ptsChannelT, ISOTP_FLOW_CTS);
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::receiveFirst()                                                                                          //
+// allocate the message buffer with its final size                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::receiveFirst(int32_t slChannelV, const QCanFrame & clFrameR)
+{
+   Channel_s *     ptsChannelT = &clChannelListP[slChannelV];
+   const uint8_t * pubDataT    = clFrameR.constData();
+   uint32_t        ulSizeT;
+   uint8_t         ubPciSizeT;
+   uint8_t         ubFrameSizeT;
+
+   //---------------------------------------------------------------------------------------------------
+   // a first frame has at least 8 bytes, the escape sequence (length 0) is followed by a 32-bit
+   // length
+   //
+   ubFrameSizeT = clFrameR.dataSize();
+   if (ubFrameSizeT < 8)
+   {
+      return;
+   }
+
+   ulSizeT    = (((uint32_t) pubDataT[0] & 0x0F) << 8) | pubDataT[1];
+   ubPciSizeT = 2;
+   if (ulSizeT == 0)
+   {
+      ulSizeT    = ((uint32_t) pubDataT[2] << 24) | ((uint32_t) pubDataT[3] << 16) |
+                   ((uint32_t) pubDataT[4] <<  8) | ((uint32_t) pubDataT[5]);
+      ubPciSizeT = 6;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // a message which fits into a single frame is not valid
+   //
+   if (ulSizeT <= (uint32_t) (ubFrameSizeT - ubPciSizeT))
+   {
+      return;
+   }
+
+   if (ptsChannelT->ubRcvState == ISOTP_STATE_RECEIVING)
+   {
+      abortReceive(slChannelV, eERROR_UNEXPECTED);
+      ptsChannelT = &clChannelListP[slChannelV];
+   }
+
+   if (ulSizeT > ptsChannelT->tsConfig.ulMessageMax)
+   {
+      sendFlowControl(ptsChannelT, ISOTP_FLOW_OVERFLOW);
+      return;
+   }
+
+   ptsChannelT->clRcvMessage   = QByteArray((int) ulSizeT, Qt::Uninitialized);
+   memcpy(ptsChannelT->clRcvMessage.data(), pubDataT + ubPciSizeT, ubFrameSizeT - ubPciSizeT);
+   ptsChannelT->slRcvPos       = ubFrameSizeT - ubPciSizeT;
+   ptsChannelT->ubRcvState     = ISOTP_STATE_RECEIVING;
+   ptsChannelT->ubRcvSeq       = 1;
+   ptsChannelT->ubRcvFrameSize = ubFrameSizeT;
+   ptsChannelT->uwRcvBlockCnt  = 0;
+   ptsChannelT->sqRcvDue       = clClockP.nsecsElapsed() + ((int64_t) ptsChannelT->tsConfig.ulTimeout) * ISOTP_MS_NS;
+
+   sendFlowControl(ptsChannelT, ISOTP_FLOW_CTS);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::receiveFlowControl()                                                                                    //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::receiveFlowControl(int32_t slChannelV, const QCanFrame & clFrameR)
+{
+   Channel_s * ptsChannelT = &clChannelListP[slChannelV];
+
+   if (ptsChannelT->ubTrmState != ISOTP_STATE_WAIT_FC)
+   {
+      return;
+   }
+
+   if (clFrameR.dataSize() < 3)
+   {
+      abortTransmit(slChannelV, eERROR_FLOW_CONTROL);
+      return;
+   }
+
+   switch (clFrameR.constData()[0] & 0x0F)
+   {
+      //-------------------------------------------------------------------------------------------
+      // the first consecutive frame of a message is sent without delay, the following blocks
+      // keep the separation time
+      //
+      case ISOTP_FLOW_CTS:
+         ptsChannelT->ubTrmState     = ISOTP_STATE_SENDING;
+         ptsChannelT->ubTrmBlockSize = clFrameR.constData()[1];
+         ptsChannelT->ubTrmWaitCnt   = 0;
+         ptsChannelT->sqTrmSepTime   = isoTpSepTimeDecode(clFrameR.constData()[2]);
+         ptsChannelT->sqTrmDue       = clClockP.nsecsElapsed();
+         if (ptsChannelT->uwTrmBlockCnt > 0)
+         {
+            ptsChannelT->sqTrmDue += ptsChannelT->sqTrmSepTime;
+         }
+         ptsChannelT->uwTrmBlockCnt  = 0;
+         break;
+
+      case ISOTP_FLOW_WAIT:
+         ptsChannelT->ubTrmWaitCnt++;
+         if (ptsChannelT->ubTrmWaitCnt > QCAN_ISOTP_WAIT_MAX)
+         {
+            abortTransmit(slChannelV, eERROR_WAIT_MAX);
+         }
+         else
+         {
+            ptsChannelT->sqTrmDue = clClockP.nsecsElapsed() +
+                                    ((int64_t) ptsChannelT->tsConfig.ulTimeout) * ISOTP_MS_NS;
+         }
+         break;
+
+      case ISOTP_FLOW_OVERFLOW:
+         abortTransmit(slChannelV, eERROR_OVERFLOW);
+         break;
+
+      default:
+         abortTransmit(slChannelV, eERROR_FLOW_CONTROL);
+         break;
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::receiveSingle()                                                                                         //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::receiveSingle(int32_t slChannelV, const QCanFrame & clFrameR)
+{
+   uint8_t  ubSizeT;
+   uint8_t  ubPciSizeT;
+   uint8_t  ubFrameSizeT;
+
+   //---------------------------------------------------------------------------------------------------
+   // the length is part of byte 0 for frames up to 8 bytes, larger CAN FD frames use the escape
+   // sequence (length 0) followed by the length in byte 1
+   //
+   ubFrameSizeT = clFrameR.dataSize();
+   ubSizeT      = clFrameR.constData()[0] & 0x0F;
+   ubPciSizeT   = 1;
+   if (ubSizeT == 0)
+   {
+      if (ubFrameSizeT <= 8)
+      {
+         return;
+      }
+      ubSizeT    = clFrameR.constData()[1];
+      ubPciSizeT = 2;
+      if (ubSizeT < 8)
+      {
+         return;
+      }
+   }
+   else if (ubFrameSizeT > 8)
+   {
+      return;
+   }
+
+   if ((ubSizeT == 0) || (ubSizeT > (ubFrameSizeT - ubPciSizeT)))
+   {
+      return;
+   }
+
+   if (clChannelListP.at(slChannelV).ubRcvState == ISOTP_STATE_RECEIVING)
+   {
+      abortReceive(slChannelV, eERROR_UNEXPECTED);
+   }
+
+   emit messageReceived(slChannelV, QByteArray((const char *) clFrameR.constData() + ubPciSizeT, ubSizeT));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::removeChannel()                                                                                         //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanIsoTp::removeChannel(int32_t slChannelV)
+{
+   Channel_s * ptsChannelT;
+
+   if ((slChannelV < 0) || (slChannelV >= clChannelListP.size()))
+   {
+      return (false);
+   }
+
+   ptsChannelT = &clChannelListP[slChannelV];
+   if (ptsChannelT->btUsed == false)
+   {
+      return (false);
+   }
+
+   clChannelIndexP.remove(ISOTP_CHANNEL_KEY(ptsChannelT->tsConfig.ulRcvId, ptsChannelT->tsConfig.btExtended));
+   ptsChannelT->btUsed       = false;
+   ptsChannelT->ubTrmState   = ISOTP_STATE_IDLE;
+   ptsChannelT->ubRcvState   = ISOTP_STATE_IDLE;
+   ptsChannelT->clTrmMessage = QByteArray();
+   ptsChannelT->clRcvMessage = QByteArray();
+   clFreeListP.append(slChannelV);
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::send()                                                                                                  //
+// send single frame or first frame                                                                                   //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanIsoTp::send(int32_t slChannelV, const QByteArray & clMessageR)
+{
+   Channel_s * ptsChannelT;
+   uint8_t     aubPciT[6];
+   uint8_t     ubPciSizeT;
+   uint32_t    ulSizeT;
+   uint32_t    ulSingleMaxT;
+
+   if ((slChannelV < 0) || (slChannelV >= clChannelListP.size()) || (clMessageR.isEmpty() == true))
+   {
+      return (false);
+   }
+
+   ptsChannelT = &clChannelListP[slChannelV];
+   if ((ptsChannelT->btUsed == false) || (ptsChannelT->ubTrmState != ISOTP_STATE_IDLE))
+   {
+      return (false);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // single frame: the escape sequence is required for more than 7 bytes
+   //
+   ulSizeT      = (uint32_t) clMessageR.size();
+   ulSingleMaxT = (ptsChannelT->tsConfig.ubFrameSize == 8) ? 7 : ptsChannelT->tsConfig.ubFrameSize - 2;
+   if (ulSizeT <= ulSingleMaxT)
+   {
+      if (ulSizeT <= 7)
+      {
+         aubPciT[0] = ISOTP_PCI_SINGLE | (uint8_t) ulSizeT;
+         ubPciSizeT = 1;
+      }
+      else
+      {
+         aubPciT[0] = ISOTP_PCI_SINGLE;
+         aubPciT[1] = (uint8_t) ulSizeT;
+         ubPciSizeT = 2;
+      }
+
+      appendFrame(ptsChannelT, &aubPciT[0], ubPciSizeT, (const uint8_t *) clMessageR.constData(),
+                  (uint8_t) ulSizeT);
+      clSentListP.append(slChannelV);
+      process();
+      return (true);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // first frame: the escape sequence is required for more than 4095 bytes
+   //
+   if (ulSizeT <= 4095)
+   {
+      aubPciT[0] = ISOTP_PCI_FIRST | (uint8_t) (ulSizeT >> 8);
+      aubPciT[1] = (uint8_t) ulSizeT;
+      ubPciSizeT = 2;
+   }
+   else
+   {
+      aubPciT[0] = ISOTP_PCI_FIRST;
+      aubPciT[1] = 0;
+      aubPciT[2] = (uint8_t) (ulSizeT >> 24);
+      aubPciT[3] = (uint8_t) (ulSizeT >> 16);
+      aubPciT[4] = (uint8_t) (ulSizeT >>  8);
+      aubPciT[5] = (uint8_t) (ulSizeT);
+      ubPciSizeT = 6;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // the message is not copied, the channel keeps a reference to the shared data
+   //
+   ptsChannelT->clTrmMessage  = clMessageR;
+   ptsChannelT->slTrmPos      = ptsChannelT->tsConfig.ubFrameSize - ubPciSizeT;
+   ptsChannelT->ubTrmSeq      = 1;
+   ptsChannelT->uwTrmBlockCnt = 0;
+   ptsChannelT->ubTrmWaitCnt  = 0;
+   ptsChannelT->ubTrmState    = ISOTP_STATE_WAIT_FC;
+   ptsChannelT->sqTrmDue      = clClockP.nsecsElapsed() + ((int64_t) ptsChannelT->tsConfig.ulTimeout) * ISOTP_MS_NS;
+
+   appendFrame(ptsChannelT, &aubPciT[0], ubPciSizeT, (const uint8_t *) ptsChannelT->clTrmMessage.constData(),
+               (uint8_t) ptsChannelT->slTrmPos);
+   process();
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::sendFlowControl()                                                                                       //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::sendFlowControl(Channel_s * ptsChannelV, uint8_t ubStatusV)
+{
+   uint8_t  aubPciT[3];
+
+   aubPciT[0] = ISOTP_PCI_FLOW_CONTROL | ubStatusV;
+   aubPciT[1] = ptsChannelV->tsConfig.ubBlockSize;
+   aubPciT[2] = isoTpSepTimeEncode(ptsChannelV->tsConfig.ulSepTime);
+
+   appendFrame(ptsChannelV, &aubPciT[0], 3, Q_NULLPTR, 0);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::setSocketReading()                                                                                      //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanIsoTp::setSocketReading(bool btEnableV)
+{
+   if (btEnableV == btSocketReadingP)
+   {
+      return;
+   }
+
+   if (btEnableV == true)
+   {
+      connect(pclSocketP, SIGNAL(framesReceived(uint32_t)), this, SLOT(onSocketReceive()));
+   }
+   else
+   {
+      disconnect(pclSocketP, SIGNAL(framesReceived(uint32_t)), this, SLOT(onSocketReceive()));
+   }
+   btSocketReadingP = btEnableV;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanIsoTp::transmit()                                                                                              //
+// append consecutive frames which are due                                                                            //
+//--------------------------------------------------------------------------------------------------------------------//
+int64_t QCanIsoTp::transmit(int32_t slChannelV, int64_t sqTimeV)
+{
+   Channel_s * ptsChannelT = &clChannelListP[slChannelV];
+   uint8_t     aubPciT[1];
+   int32_t     slSizeT;
+   int32_t     slFrameCntT = 0;
+
+   while (true)
+   {
+      slSizeT = qMin(ptsChannelT->clTrmMessage.size() - ptsChannelT->slTrmPos,
+                     ptsChannelT->tsConfig.ubFrameSize - 1);
+
+      aubPciT[0] = ISOTP_PCI_CONSECUTIVE | ptsChannelT->ubTrmSeq;
+      appendFrame(ptsChannelT, &aubPciT[0], 1,
+                  (const uint8_t *) ptsChannelT->clTrmMessage.constData() + ptsChannelT->slTrmPos,
+                  (uint8_t) slSizeT);
+      ptsChannelT->slTrmPos += slSizeT;
+      ptsChannelT->ubTrmSeq  = (ptsChannelT->ubTrmSeq + 1) & 0x0F;
+      slFrameCntT++;
+
+      //-------------------------------------------------------------------------------------------
+      // last frame of the message
+      //
+      if (ptsChannelT->slTrmPos == ptsChannelT->clTrmMessage.size())
+      {
+         ptsChannelT->ubTrmState   = ISOTP_STATE_IDLE;
+         ptsChannelT->clTrmMessage = QByteArray();
+         clSentListP.append(slChannelV);
+         break;
+      }
+
+      //-------------------------------------------------------------------------------------------
+      // last frame of a block
+      //
+      if (ptsChannelT->ubTrmBlockSize > 0)
+      {
+         ptsChannelT->uwTrmBlockCnt++;
+         if (ptsChannelT->uwTrmBlockCnt == ptsChannelT->ubTrmBlockSize)
+         {
+            ptsChannelT->ubTrmState = ISOTP_STATE_WAIT_FC;
+            ptsChannelT->sqTrmDue   = sqTimeV + ((int64_t) ptsChannelT->tsConfig.ulTimeout) * ISOTP_MS_NS;
+            break;
+         }
+      }
+
+      //-------------------------------------------------------------------------------------------
+      // the time of the next frame is set by flush()
+      //
+      if (ptsChannelT->sqTrmSepTime > 0)
+      {
+         clPacedListP.append(slChannelV);
+         break;
+      }
+
+      if (slFrameCntT == QCAN_ISOTP_BATCH_MAX)
+      {
+         break;
+      }
+   }
+
+   return (ptsChannelT->sqTrmDue);
+}
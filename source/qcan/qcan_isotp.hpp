@@ -0,0 +1,454 @@
+//====================================================================================================================//
+// File:          qcan_isotp.hpp                                                                                      //
+// Description:   QCAN classes - ISO-TP transport protocol                                                            //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+#ifndef QCAN_ISOTP_HPP_
+#define QCAN_ISOTP_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include "qcan_frame.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+/*!
+** \defgroup QCAN_ISOTP QCan ISO-TP definitions
+**
+**
+*/
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_ISOTP_CHANNEL_MAX
+** \ingroup QCAN_ISOTP
+** \brief   Maximum number of ISO-TP channels
+**
+** This symbol defines the maximum number of channels of a
+** QCanIsoTp engine.
+*/
+#define  QCAN_ISOTP_CHANNEL_MAX        256
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_ISOTP_MESSAGE_MAX
+** \ingroup QCAN_ISOTP
+** \brief   Default maximum size of a received message
+**
+** This symbol defines the default value for the maximum size of a
+** received message in bytes. A larger message is rejected by a
+** flow control frame with the status overflow.
+*/
+#define  QCAN_ISOTP_MESSAGE_MAX        (16 * 1024 * 1024)
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_ISOTP_TIMEOUT
+** \ingroup QCAN_ISOTP
+** \brief   Default timeout
+**
+** This symbol defines the default timeout in milli-seconds for a
+** flow control frame (N_Bs) and a consecutive frame (N_Cr).
+*/
+#define  QCAN_ISOTP_TIMEOUT            1000
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_ISOTP_WAIT_MAX
+** \ingroup QCAN_ISOTP
+** \brief   Maximum number of flow control wait frames
+**
+** This symbol defines the number of flow control frames with the
+** status wait which are accepted in a row (N_WFTmax).
+*/
+#define  QCAN_ISOTP_WAIT_MAX           16
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_ISOTP_BATCH_MAX
+** \ingroup QCAN_ISOTP
+** \brief   Maximum number of consecutive frames of one batch
+**
+** This symbol defines the maximum number of consecutive frames a
+** channel writes to the socket with one call, if no separation time
+** is requested. The following frames are written after the event
+** loop has been serviced, so concurrent channels are interleaved.
+*/
+#define  QCAN_ISOTP_BATCH_MAX          64
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_ISOTP_SPIN_TIME
+** \ingroup QCAN_ISOTP
+** \brief   Busy waiting time
+**
+** This symbol defines the time in micro-seconds below which the
+** engine waits for the next consecutive frame by polling the clock
+** instead of starting a timer. Timers of the event loop have a
+** resolution of one milli-second, so separation times of 100 us to
+** 900 us can only be met by polling. The frame is written after the
+** event loop has been serviced, so a single wait blocks the event
+** loop for less than this time and received frames of concurrent
+** channels are handled between two consecutive frames.
+*/
+#define  QCAN_ISOTP_SPIN_TIME          1000
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Referenced classes                                                                                                 **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+class QCanSocket;
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanIsoTp
+** \brief ISO-TP transport protocol
+**
+** The QCanIsoTp class implements the transport protocol of ISO 15765-2 on top of a QCanSocket. It transfers
+** messages of up to 4 GByte by segmentation into a first frame and consecutive frames, the receiver
+** controls the transfer by flow control frames with a block size and a minimum separation time (STmin).
+** Classic CAN frames and CAN FD frames with up to 64 bytes are supported, messages of more than 4095 bytes
+** use the escape sequence of the first frame.
+** <p>
+** An engine handles up to #QCAN_ISOTP_CHANNEL_MAX channels at the same time, each defined by a transmit
+** and a receive identifier (see addChannel()). The engine reads all CAN frames of the socket, frames which
+** do not belong to a channel are passed on by the signal frameReceived(). An application which reads the
+** socket by itself passes the frames to handleFrame() instead (see setSocketReading()).
+** \code
+** QCanSocket           clSocketT;
+** QCanIsoTp            clIsoTpT(&clSocketT);
+** QCanIsoTp::Config_s  tsConfigT = QCanIsoTp::defaultConfig(0x7E0, 0x7E8);
+** int32_t              slChannelT;
+**
+** clSocketT.connectNetwork(eCAN_CHANNEL_1);
+** slChannelT = clIsoTpT.addChannel(tsConfigT);
+** clIsoTpT.send(slChannelT, clRequestT);
+** \endcode
+** <p>
+** Messages are not copied by the engine: send() keeps a reference to the implicitly shared QByteArray and
+** copies the segments directly into the CAN frames, a received message is assembled in a buffer of the
+** final size which is passed by messageReceived(). Consecutive frames are scheduled on a monotonic clock
+** with nanosecond resolution, the separation time is measured from the write of the previous frame.
+** Without a separation time the frames of a block are written in batches of #QCAN_ISOTP_BATCH_MAX.
+*/
+class QCanIsoTp : public QObject
+{
+   Q_OBJECT
+
+public:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \brief   Configuration of a channel
+   **
+   ** The structure defines the identifiers, the frame format and the flow control parameters of a
+   ** channel, defaultConfig() returns the default values.
+   */
+   struct Config_s {
+      uint32_t ulTrmId;          //!< identifier of transmitted frames
+      uint32_t ulRcvId;          //!< identifier of received frames
+      bool     btExtended;       //!< extended frame format
+      bool     btCanFd;          //!< CAN FD frame format
+      bool     btBitrateSwitch;  //!< bit-rate switch of CAN FD frames
+      uint8_t  ubFrameSize;      //!< maximum payload of transmitted frames (TX_DL): 8, 12 .. 64
+      bool     btPadding;        //!< pad classic CAN frames to 8 bytes
+      uint8_t  ubPaddingValue;   //!< value of padding bytes
+      uint8_t  ubBlockSize;      //!< block size requested by the receiver, 0 = no limit
+      uint32_t ulSepTime;        //!< separation time requested by the receiver in micro-seconds
+      uint32_t ulTimeout;        //!< timeout N_Bs and N_Cr in milli-seconds
+      uint32_t ulMessageMax;     //!< maximum size of a received message
+   };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \enum    Error_e
+   **
+   ** The enumeration defines the errors signalled by error().
+   */
+   enum Error_e {
+
+      /*! No error                                                  */
+      eERROR_NONE = 0,
+
+      /*! Timeout for a flow control frame (N_Bs)                   */
+      eERROR_TIMEOUT_BS,
+
+      /*! Timeout for a consecutive frame (N_Cr)                    */
+      eERROR_TIMEOUT_CR,
+
+      /*! Wrong sequence number of a consecutive frame              */
+      eERROR_SEQUENCE,
+
+      /*! Receiver reported an overflow by a flow control frame     */
+      eERROR_OVERFLOW,
+
+      /*! Too many flow control frames with the status wait         */
+      eERROR_WAIT_MAX,
+
+      /*! Invalid flow control frame                                */
+      eERROR_FLOW_CONTROL,
+
+      /*! Reception aborted by a new first or single frame          */
+      eERROR_UNEXPECTED,
+
+      /*! Frames could not be written to the socket                 */
+      eERROR_SOCKET
+   };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclSocketV     Pointer to CAN socket
+   ** \param[in]  pclParentV     Pointer to parent
+   **
+   ** Create a new ISO-TP engine, which uses the socket \a pclSocketV.
+   */
+   QCanIsoTp(QCanSocket * pclSocketV, QObject * pclParentV = Q_NULLPTR);
+
+   ~QCanIsoTp();
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  tsConfigR      Configuration of channel
+   ** \return     Channel number or -1
+   ** \see        removeChannel()
+   **
+   ** Add a new channel, the function returns the channel number which is used by send() and the
+   ** signals. It fails if the receive identifier is used by another channel, if the frame size is
+   ** not a valid CAN FD data size or if #QCAN_ISOTP_CHANNEL_MAX channels exist.
+   */
+   int32_t  addChannel(const Config_s & tsConfigR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of channels
+   */
+   int32_t  channelCount(void) const      { return (clChannelIndexP.size()); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ulTrmIdV       Identifier of transmitted frames
+   ** \param[in]  ulRcvIdV       Identifier of received frames
+   ** \param[in]  btCanFdV       CAN FD frame format
+   ** \return     Default configuration
+   **
+   ** The function returns a configuration with standard frames, a frame size of 8 bytes (64 bytes
+   ** for CAN FD), padding with 0xCC, no block size limit, no separation time and a timeout of
+   ** #QCAN_ISOTP_TIMEOUT.
+   */
+   static Config_s defaultConfig(uint32_t ulTrmIdV, uint32_t ulRcvIdV, bool btCanFdV = false);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameR       Reference to CAN frame
+   ** \return     \c true if the frame belongs to a channel
+   **
+   ** The function processes a received CAN frame. It is called by the engine for all frames of the
+   ** socket, unless reading of the socket has been disabled by setSocketReading().
+   */
+   bool  handleFrame(const QCanFrame & clFrameR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slChannelV     Channel number
+   ** \return     \c true if a message is transmitted
+   */
+   bool  isBusy(int32_t slChannelV) const;
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slChannelV     Channel number
+   ** \return     \c true if the channel has been removed
+   **
+   ** Remove a channel, a pending transmission or reception is aborted without a signal.
+   */
+   bool  removeChannel(int32_t slChannelV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slChannelV     Channel number
+   ** \param[in]  clMessageR     Message
+   ** \return     \c true if the transmission has been started
+   ** \see        messageSent()
+   **
+   ** Start the transmission of the message \a clMessageR. Only one message per channel can be
+   ** transmitted at a time, the function fails if the channel is busy or if the message is empty.
+   ** The end of the transmission is signalled by messageSent() or error().
+   */
+   bool  send(int32_t slChannelV, const QByteArray & clMessageR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  btEnableV      Read frames from the socket
+   **
+   ** By default the engine reads all frames from the socket. If the application reads the socket by
+   ** itself, it disables reading and passes the frames to handleFrame().
+   */
+   void  setSocketReading(bool btEnableV);
+
+signals:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slChannelV     Channel number
+   ** \param[in]  teErrorV       Error
+   **
+   ** This signal is emitted when a transmission or reception of channel \a slChannelV is aborted.
+   */
+   void  error(int32_t slChannelV, QCanIsoTp::Error_e teErrorV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameR       Reference to CAN frame
+   **
+   ** This signal is emitted for a CAN frame of the socket which does not belong to a channel.
+   */
+   void  frameReceived(const QCanFrame & clFrameR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slChannelV     Channel number
+   ** \param[in]  clMessageR     Message
+   **
+   ** This signal is emitted when a message has been received by channel \a slChannelV.
+   */
+   void  messageReceived(int32_t slChannelV, const QByteArray & clMessageR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slChannelV     Channel number
+   **
+   ** This signal is emitted when the last frame of a message has been written by channel
+   ** \a slChannelV.
+   */
+   void  messageSent(int32_t slChannelV);
+
+private slots:
+
+   void  onSocketReceive(void);
+
+   void  onTimerEvent(void);
+
+private:
+
+   //----------------------------------------------------------------
+   // state of a channel, all times are taken from clClockP in
+   // nano-seconds, sqTrmDue / sqRcvDue is the time of the next
+   // consecutive frame or the timeout
+   //
+   struct Channel_s {
+      Config_s    tsConfig;
+      bool        btUsed;
+
+      QByteArray  clTrmMessage;
+      int32_t     slTrmPos;
+      uint8_t     ubTrmState;
+      uint8_t     ubTrmSeq;
+      uint8_t     ubTrmBlockSize;
+      uint16_t    uwTrmBlockCnt;
+      uint8_t     ubTrmWaitCnt;
+      int64_t     sqTrmSepTime;
+      int64_t     sqTrmDue;
+
+      QByteArray  clRcvMessage;
+      int32_t     slRcvPos;
+      uint8_t     ubRcvState;
+      uint8_t     ubRcvSeq;
+      uint8_t     ubRcvFrameSize;
+      uint16_t    uwRcvBlockCnt;
+      int64_t     sqRcvDue;
+   };
+
+   void  abortReceive(int32_t slChannelV, Error_e teErrorV);
+
+   void  abortTransmit(int32_t slChannelV, Error_e teErrorV);
+
+   void  appendFrame(Channel_s * ptsChannelV, const uint8_t * pubPciV, uint8_t ubPciSizeV,
+                     const uint8_t * pubDataV, uint8_t ubDataSizeV);
+
+   void  flush(void);
+
+   void  process(void);
+
+   bool  receive(const QCanFrame & clFrameR);
+
+   void  receiveConsecutive(int32_t slChannelV, const QCanFrame & clFrameR);
+
+   void  receiveFirst(int32_t slChannelV, const QCanFrame & clFrameR);
+
+   void  receiveFlowControl(int32_t slChannelV, const QCanFrame & clFrameR);
+
+   void  receiveSingle(int32_t slChannelV, const QCanFrame & clFrameR);
+
+   void  sendFlowControl(Channel_s * ptsChannelV, uint8_t ubStatusV);
+
+   int64_t  transmit(int32_t slChannelV, int64_t sqTimeV);
+
+   QCanSocket *               pclSocketP;
+   bool                       btSocketReadingP;
+
+   QVector<Channel_s>         clChannelListP;
+   QVector<int32_t>           clFreeListP;
+   QHash<uint32_t, int32_t>   clChannelIndexP;
+
+   //----------------------------------------------------------------
+   // frames which are written with the next call of flush(), the
+   // channels in clPacedListP measure the separation time from the
+   // write, the channels in clSentListP have written their last
+   // frame
+   //
+   QVector<QCanFrame>         clRcvListP;
+   QVector<QCanFrame>         clTrmListP;
+   QVector<int32_t>           clPacedListP;
+   QVector<int32_t>           clSentListP;
+   bool                       btProcessP;
+
+   QElapsedTimer              clClockP;
+   QTimer                     clTimerP;
+};
+
+Q_DECLARE_METATYPE(QCanIsoTp::Error_e)
+
+#endif   // QCAN_ISOTP_HPP_
@@ -0,0 +1,383 @@
+//====================================================================================================================//
+// File:          qcan_multiplexer.cpp                                                                                //
+// Description:   QCAN classes - CAN network multiplexer                                                              //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#include <QtNetwork/QLocalSocket>
+#include <QtNetwork/QTcpSocket>
+
+#include "qcan_frame.hpp"
+#include "qcan_multiplexer.hpp"
+#include "qcan_network.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class methods                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer()                                                                                                  //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanMultiplexer::QCanMultiplexer(QObject * pclParentV, uint16_t uwPortV)
+{
+   this->setParent(pclParentV);
+
+   pclLocalSrvP = new QLocalServer(this);
+   pclTcpSrvP   = new QTcpServer(this);
+
+   clTcpHostAddrP = QHostAddress(QHostAddress::LocalHost);
+   uwTcpPortP     = uwPortV;
+
+   pclSourceP       = Q_NULLPTR;
+   ubSourceChannelP = 0;
+   btEnabledP       = false;
+   btWritePendingP  = false;
+
+   connect( pclLocalSrvP, SIGNAL(newConnection()),
+            this, SLOT(onLocalSocketConnect()));
+
+   connect( pclTcpSrvP, SIGNAL(newConnection()),
+            this, SLOT(onTcpSocketConnect()));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// ~QCanMultiplexer()                                                                                                 //
+// destructor                                                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanMultiplexer::~QCanMultiplexer()
+{
+   setEnabled(false);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::addConnection()                                                                                   //
+// add new connection, no channel is subscribed                                                                       //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::addConnection(QIODevice * pclSocketV)
+{
+   MuxConnection_s   tsConnectionT;
+
+   tsConnectionT.ulChannelMask = 0;
+   clConnectionP.insert(pclSocketV, tsConnectionT);
+
+   connect( pclSocketV, SIGNAL(disconnected()),
+            this, SLOT(onSocketDisconnect()));
+
+   connect( pclSocketV, SIGNAL(readyRead()),
+            this, SLOT(onSocketNewData()));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::addNetwork()                                                                                      //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::addNetwork(QCanNetwork * pclNetworkV)
+{
+   if ((pclNetworkV->id() > 0) && (pclNetworkV->id() <= QCAN_NETWORK_MAX))
+   {
+      if (clNetworkListP.size() < pclNetworkV->id())
+      {
+         clNetworkListP.resize(pclNetworkV->id());
+      }
+      clNetworkListP[pclNetworkV->id() - 1] = pclNetworkV;
+      pclNetworkV->setMultiplexer(this);
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::distribute()                                                                                      //
+// add frame to the write buffer of all subscribers                                                                   //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::distribute(uint8_t ubChannelV, const QByteArray & clSockDataR)
+{
+   QHash<QIODevice *, MuxConnection_s>::iterator   clConnectionT;
+   uint32_t                                        ulChannelBitT;
+   int32_t                                         slPosT;
+
+   if ((ubChannelV == 0) || (ubChannelV > QCAN_NETWORK_MAX) || (clSockDataR.size() < QCAN_FRAME_ARRAY_SIZE))
+   {
+      return;
+   }
+
+   ulChannelBitT = ((uint32_t) 1) << (ubChannelV - 1);
+
+   for (clConnectionT = clConnectionP.begin(); clConnectionT != clConnectionP.end(); ++clConnectionT)
+   {
+      //-------------------------------------------------------------------------------------------
+      // a frame is not sent back to its source, a copy which has been forwarded to another CAN
+      // channel by the gateway is sent
+      //
+      if ((clConnectionT.key() == pclSourceP) && (ubChannelV == ubSourceChannelP))
+      {
+         continue;
+      }
+
+      if ((clConnectionT.value().ulChannelMask & ulChannelBitT) > 0)
+      {
+         //-------------------------------------------------------------------------------------------
+         // append the frame and tag it with the CAN channel
+         //
+         slPosT = clConnectionT.value().clWriteBuffer.size();
+         clConnectionT.value().clWriteBuffer.append(clSockDataR.constData(), QCAN_FRAME_ARRAY_SIZE);
+         clConnectionT.value().clWriteBuffer[slPosT + QCAN_MUX_CHANNEL_POS] = (char) ubChannelV;
+
+         //-------------------------------------------------------------------------------------------
+         // the write buffers are written by the event loop
+         //
+         if (btWritePendingP == false)
+         {
+            btWritePendingP = true;
+            QMetaObject::invokeMethod(this, "onSocketWrite", Qt::QueuedConnection);
+         }
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::logMessage()                                                                                      //
+// the multiplexer serves all networks, so the message is passed to the log of every CAN channel                      //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::logMessage(const QString & clMessageR, LogLevel_e teLogLevelV)
+{
+   for (int32_t slChannelT = 0; slChannelT < clNetworkListP.size(); slChannelT++)
+   {
+      if (clNetworkListP.at(slChannelT) != Q_NULLPTR)
+      {
+         emit addLogMessage(CAN_Channel_e (slChannelT + 1), clMessageR, teLogLevelV);
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::onLocalSocketConnect()                                                                            //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::onLocalSocketConnect(void)
+{
+   QLocalSocket * pclSocketT;
+
+   pclSocketT = pclLocalSrvP->nextPendingConnection();
+   while (pclSocketT != Q_NULLPTR)
+   {
+      addConnection(pclSocketT);
+      pclSocketT = pclLocalSrvP->nextPendingConnection();
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::onSocketDisconnect()                                                                              //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::onSocketDisconnect(void)
+{
+   QIODevice * pclSenderT;
+
+   pclSenderT = (QIODevice *) QObject::sender();
+   disconnect(pclSenderT, 0, 0, 0);
+
+   clConnectionP.remove(pclSenderT);
+   pclSenderT->deleteLater();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::onSocketNewData()                                                                                 //
+// handle subscription and frames of a connection                                                                     //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::onSocketNewData(void)
+{
+   QIODevice *    pclSocketT;
+   QCanNetwork *  pclNetworkT;
+   QByteArray     clSockDataT;
+   uint8_t        ubChannelT;
+   uint32_t       ulMaskT;
+
+   pclSocketT = (QIODevice *) QObject::sender();
+   if (clConnectionP.contains(pclSocketT) == false)
+   {
+      return;
+   }
+
+   while (pclSocketT->bytesAvailable() >= QCAN_FRAME_ARRAY_SIZE)
+   {
+      clSockDataT = pclSocketT->read(QCAN_FRAME_ARRAY_SIZE);
+      ubChannelT  = (uint8_t) clSockDataT.at(QCAN_MUX_CHANNEL_POS);
+
+      if (ubChannelT == eCAN_CHANNEL_NONE)
+      {
+         //-------------------------------------------------------------------------------------------
+         // subscription: bit-mask of CAN channels in byte 0 .. 3, MSB first
+         //
+         ulMaskT =            (uint8_t) clSockDataT.at(0);
+         ulMaskT = ulMaskT << 8;
+         ulMaskT = ulMaskT +  (uint8_t) clSockDataT.at(1);
+         ulMaskT = ulMaskT << 8;
+         ulMaskT = ulMaskT +  (uint8_t) clSockDataT.at(2);
+         ulMaskT = ulMaskT << 8;
+         ulMaskT = ulMaskT +  (uint8_t) clSockDataT.at(3);
+         clConnectionP[pclSocketT].ulChannelMask = ulMaskT;
+      }
+      else if (ubChannelT <= clNetworkListP.size())
+      {
+         //-------------------------------------------------------------------------------------------
+         // pass the frame without channel to the network, it is not sent back to this connection
+         //
+         pclNetworkT = clNetworkListP.at(ubChannelT - 1);
+         if ((pclNetworkT != Q_NULLPTR) && (pclNetworkT->isNetworkEnabled() == true))
+         {
+            clSockDataT[QCAN_MUX_CHANNEL_POS] = 0;
+            pclSourceP       = pclSocketT;
+            ubSourceChannelP = ubChannelT;
+            pclNetworkT->handleCanFrame(QCanNetwork::eFRAME_SOURCE_SOCKET_MUX, 0, clSockDataT);
+            pclSourceP       = Q_NULLPTR;
+            ubSourceChannelP = 0;
+         }
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::onSocketWrite()                                                                                   //
+// write buffer of all connections                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::onSocketWrite(void)
+{
+   QHash<QIODevice *, MuxConnection_s>::iterator   clConnectionT;
+
+   btWritePendingP = false;
+
+   for (clConnectionT = clConnectionP.begin(); clConnectionT != clConnectionP.end(); ++clConnectionT)
+   {
+      if (clConnectionT.value().clWriteBuffer.isEmpty() == false)
+      {
+         clConnectionT.key()->write(clConnectionT.value().clWriteBuffer);
+         clConnectionT.value().clWriteBuffer.clear();
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::onTcpSocketConnect()                                                                              //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::onTcpSocketConnect(void)
+{
+   QTcpSocket * pclSocketT;
+
+   pclSocketT = pclTcpSrvP->nextPendingConnection();
+   while (pclSocketT != Q_NULLPTR)
+   {
+      addConnection(pclSocketT);
+      pclSocketT = pclTcpSrvP->nextPendingConnection();
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::setEnabled()                                                                                      //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::setEnabled(bool btEnableV)
+{
+   QIODevice * pclSocketT;
+
+   if ((btEnableV == true) && (btEnabledP == false))
+   {
+      pclLocalSrvP->setSocketOptions(QLocalServer::WorldAccessOption);
+      if (pclLocalSrvP->listen(QString(QCAN_MUX_SERVER_NAME)) == false)
+      {
+         logMessage(tr("Multiplexer: failed to open local server %1 - %2")
+                    .arg(QCAN_MUX_SERVER_NAME).arg(pclLocalSrvP->errorString()), eLOG_LEVEL_ERROR);
+      }
+
+      if (pclTcpSrvP->listen(clTcpHostAddrP, uwTcpPortP) == false)
+      {
+         logMessage(tr("Multiplexer: failed to open TCP server %1:%2 - %3")
+                    .arg(clTcpHostAddrP.toString()).arg(uwTcpPortP).arg(pclTcpSrvP->errorString()),
+                    eLOG_LEVEL_ERROR);
+      }
+
+      btEnabledP = true;
+   }
+
+   if ((btEnableV == false) && (btEnabledP == true))
+   {
+      pclLocalSrvP->close();
+      pclTcpSrvP->close();
+
+      //-------------------------------------------------------------------------------------------
+      // close all connections
+      //
+      foreach (pclSocketT, clConnectionP.keys())
+      {
+         disconnect(pclSocketT, 0, 0, 0);
+         pclSocketT->close();
+         pclSocketT->deleteLater();
+      }
+      clConnectionP.clear();
+
+      btEnabledP = false;
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanMultiplexer::setServerAddress()                                                                                //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanMultiplexer::setServerAddress(QHostAddress clHostAddressV)
+{
+   if (btEnabledP == true)
+   {
+      setEnabled(false);
+      clTcpHostAddrP = clHostAddressV;
+      setEnabled(true);
+   }
+   else
+   {
+      clTcpHostAddrP = clHostAddressV;
+   }
+}
@@ -0,0 +1,202 @@
+//====================================================================================================================//
+// File:          qcan_multiplexer.hpp                                                                                //
+// Description:   QCAN classes - CAN network multiplexer                                                              //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+#ifndef QCAN_MULTIPLEXER_HPP_
+#define QCAN_MULTIPLEXER_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QVector>
+
+#include <QtNetwork/QHostAddress>
+#include <QtNetwork/QLocalServer>
+#include <QtNetwork/QTcpServer>
+
+#include "qcan_defs.hpp"
+#include "qcan_namespace.hpp"
+
+
+using namespace QCan;
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Referenced classes                                                                                                 **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+class QCanNetwork;
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanMultiplexer
+** \brief Multiplexed connection to several CAN networks
+**
+** A QCanSocket which is connected with QCanSocket::connectNetworks() uses one connection for a set of CAN
+** networks. The connection is made to the local server #QCAN_MUX_SERVER_NAME or to the TCP port of the
+** first network plus #QCAN_NETWORK_MAX.
+** <p>
+** Each record on a multiplexed connection has the size #QCAN_FRAME_ARRAY_SIZE. The byte at position
+** #QCAN_MUX_CHANNEL_POS holds the CAN channel of the frame, it is cleared before the frame is passed to the
+** network, so the checksum of the frame remains valid. A record with channel eCAN_CHANNEL_NONE is a
+** subscription: byte 0 .. 3 hold a bit-mask of the CAN channels (bit 0 for eCAN_CHANNEL_1), MSB first.
+** <p>
+** Frames for a connection are collected from all networks and written by the event loop, so a client
+** receives the frames of several networks with a single write operation.
+*/
+class QCanMultiplexer : public QObject
+{
+   Q_OBJECT
+public:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclParentV     Pointer to QObject parent class
+   ** \param[in]  uwPortV        Port number for TCP access
+   **
+   ** Create a new multiplexer, the servers are opened by setEnabled().
+   */
+   QCanMultiplexer(QObject * pclParentV = Q_NULLPTR,
+                   uint16_t  uwPortV = QCAN_TCP_DEFAULT_PORT + QCAN_NETWORK_MAX);
+
+   ~QCanMultiplexer();
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclNetworkV    Pointer to CAN network
+   **
+   ** Add a CAN network to the multiplexer, the CAN channel is taken from QCanNetwork::id().
+   */
+   void  addNetwork(QCanNetwork * pclNetworkV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ubChannelV     CAN channel of the frame
+   ** \param[in]  clSockDataR    CAN frame as byte array
+   **
+   ** This function is called by a QCanNetwork for every frame. The frame is added to the write buffer
+   ** of all connections which have subscribed the CAN channel, except the connection which has
+   ** transmitted the frame to the same CAN channel.
+   */
+   void  distribute(uint8_t ubChannelV, const QByteArray & clSockDataR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true if multiplexer is enabled
+   ** \see        setEnabled()
+   */
+   bool  isEnabled(void)            { return (btEnabledP);  };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clHostAddressV Server address
+   **
+   ** This method sets the address of the TCP server. An enabled multiplexer is restarted.
+   */
+   void  setServerAddress(QHostAddress clHostAddressV);
+
+public slots:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  btEnableV      Enable / disable multiplexer
+   ** \see        isEnabled()
+   **
+   ** This function opens the local and the TCP server if \a btEnableV is \c true, the servers are closed
+   ** on \c false. A server which can not be opened is reported by addLogMessage().
+   */
+   void  setEnabled(bool btEnableV = true);
+
+signals:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ubChannelR  CAN channel
+   ** \param[in]  clMessageR  Logging message
+   ** \param[in]  teLogLevelR Logging level
+   **
+   ** This signal is emitted for every CAN channel of the multiplexer to inform the application about
+   ** error conditions, the signature is the same as QCanNetwork::addLogMessage().
+   */
+   void  addLogMessage(const CAN_Channel_e & ubChannelR,
+                       const QString & clMessageR, const LogLevel_e & teLogLevelR = eLOG_LEVEL_WARN);
+
+private slots:
+
+   void  onLocalSocketConnect(void);
+
+   void  onTcpSocketConnect(void);
+
+   void  onSocketDisconnect(void);
+
+   void  onSocketNewData(void);
+
+   void  onSocketWrite(void);
+
+private:
+
+   void  addConnection(QIODevice * pclSocketV);
+
+   void  logMessage(const QString & clMessageR, LogLevel_e teLogLevelV);
+
+   //----------------------------------------------------------------
+   // a connection holds the subscribed CAN channels and the frames
+   // which have not been written yet
+   //
+   struct MuxConnection_s {
+      uint32_t    ulChannelMask;
+      QByteArray  clWriteBuffer;
+   };
+
+   QHash<QIODevice *, MuxConnection_s> clConnectionP;
+
+   //----------------------------------------------------------------
+   // connection which has transmitted the frame that is passed to a
+   // network
+   //
+   QIODevice *                pclSourceP;
+   uint8_t                    ubSourceChannelP;
+
+   QVector<QCanNetwork *>     clNetworkListP;
+
+   QPointer<QLocalServer>     pclLocalSrvP;
+   QPointer<QTcpServer>       pclTcpSrvP;
+   QHostAddress               clTcpHostAddrP;
+   uint16_t                   uwTcpPortP;
+
+   bool                       btEnabledP;
+   bool                       btWritePendingP;
+};
+
+#endif   // QCAN_MULTIPLEXER_HPP_
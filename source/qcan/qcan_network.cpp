@@ -34,9 +34,12 @@
 \*--------------------------------------------------------------------------------------------------------------------*/
 
 #include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QtEndian>
 
 #include "qcan_defs.hpp"
 #include "qcan_interface.hpp"
+#include "qcan_multiplexer.hpp"
 #include "qcan_network.hpp"
 
 #include "qcan_server_memory.hpp"
@@ -174,6 +177,8 @@ QCanNetwork::QCanNetwork(QObject * pclParentV, uint16_t  uwPortV, QSharedMemory
    //
    pclLocalSockListP = new QVector<QLocalSocket*>;
    pclLocalSockListP->reserve(QCAN_LOCAL_SOCKET_MAX);
+   clLocalSockIndexP.reserve(QCAN_LOCAL_SOCKET_MAX);
+   ulLocalSockMaxP = QCAN_LOCAL_SOCKET_MAX;
 
 
    //---------------------------------------------------------------------------------------------------
@@ -188,7 +193,34 @@ QCanNetwork::QCanNetwork(QObject * pclParentV, uint16_t  uwPortV, QSharedMemory
    //
    pclTcpSockListP = new QVector<QTcpSocket *>;
    pclTcpSockListP->reserve(QCAN_TCP_SOCKET_MAX);
+   clTcpSockIndexP.reserve(QCAN_TCP_SOCKET_MAX);
+   ulTcpSockMaxP = QCAN_TCP_SOCKET_MAX;
 
+   //---------------------------------------------------------------------------------------------------
+   // UDP multicast publisher is disabled by default
+   //
+   ulMcastSequenceP     = 0;
+   ubMcastFrameCntP     = 0;
+   btMcastWritePendingP = false;
+
+   //---------------------------------------------------------------------------------------------------
+   // time base for subscriptions, the last value cache is enabled by default
+   //
+   clSubscriptionTimeP.start();
+   btValueCacheEnabledP = true;
+
+   //---------------------------------------------------------------------------------------------------
+   // the recorder is disabled by default, trace files are written to the temporary directory
+   //
+   pclRecorderP = new QCanRecorder(this);
+   pclRecorderP->setTraceFilePrefix(QDir::tempPath() + QString("/can%1").arg(ubIdP));
+   connect(pclRecorderP, SIGNAL(traceWritten(QString, bool)),
+           this,         SLOT(onRecorderTraceWritten(QString, bool)));
+
+   //---------------------------------------------------------------------------------------------------
+   // scheduler for cyclic frames
+   //
+   pclSchedulerP = new QCanScheduler(this);
 
    //---------------------------------------------------------------------------------------------------
    // clear statistic
@@ -202,6 +234,18 @@ QCanNetwork::QCanNetwork(QObject * pclParentV, uint16_t  uwPortV, QSharedMemory
 
    ubBusLoadP = 0;
 
+   //---------------------------------------------------------------------------------------------------
+   // coalescing of error frames is disabled by default
+   //
+   ulCntFrameErrCoalescedP = 0;
+   ulErrCoalesceTimeP      = 0;
+   teErrFrameSrcP          = eFRAME_SOURCE_CAN_IF;
+   slErrSockSrcP           = 0;
+   ulErrRepeatP            = 0;
+   btErrRepeatWriteP       = false;
+   clErrCoalesceTimerP.setSingleShot(true);
+   connect(&clErrCoalesceTimerP, SIGNAL(timeout()), this, SLOT(onErrorCoalesceTimer()));
+
    //---------------------------------------------------------------------------------------------------
    // setup timing values
    //
@@ -557,6 +601,78 @@ uint32_t QCanNetwork::frameSize(const QByteArray & clSockDataR)
 }
 
 
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::clearValueTable()                                                                                     //
+// remove all entries of the last value table                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::clearValueTable(void)
+{
+   QHash<QObject *, Subscription_s>::iterator   clSubscriptionT;
+
+   //---------------------------------------------------------------------------------------------------
+   // the state of a subscription refers to the entries of the table
+   //
+   for (clSubscriptionT = clSubscriptionP.begin(); clSubscriptionT != clSubscriptionP.end(); ++clSubscriptionT)
+   {
+      clSubscriptionT->clState.clear();
+   }
+   clValueTableP.clear();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::coalesceErrorFrame()                                                                                  //
+// returns true if the error frame is a repetition inside the time window                                             //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanNetwork::coalesceErrorFrame(enum FrameSource_e teFrameSrcV, const int32_t slSockSrcV,
+                                     const QByteArray & clSockDataR)
+{
+   QCanFrame   clFrameT;
+
+   if (clFrameT.fromByteArray(clSockDataR) == false)
+   {
+      return (false);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // a repetition of the last error frame inside the time window is not distributed, it replaces the
+   // stored frame so that the report carries the time-stamp of the last repetition
+   //
+   if (clErrCoalesceTimerP.isActive())
+   {
+      if ((clFrameT.errorType()            == clErrFrameP.errorType())            &&
+          (clFrameT.errorState()           == clErrFrameP.errorState())           &&
+          (clFrameT.errorCounterReceive()  == clErrFrameP.errorCounterReceive())  &&
+          (clFrameT.errorCounterTransmit() == clErrFrameP.errorCounterTransmit())    )
+      {
+         clErrFrameP    = clFrameT;
+         teErrFrameSrcP = teFrameSrcV;
+         slErrSockSrcP  = slSockSrcV;
+         ulErrRepeatP++;
+         ulCntFrameErrCoalescedP++;
+         return (true);
+      }
+
+      //-------------------------------------------------------------------------------------------
+      // a different error frame: report the repetitions of the previous one first
+      //
+      clErrCoalesceTimerP.stop();
+      writeErrorRepeat();
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // the error frame is distributed and starts a new time window
+   //
+   clErrFrameP    = clFrameT;
+   teErrFrameSrcP = teFrameSrcV;
+   slErrSockSrcP  = slSockSrcV;
+   ulErrRepeatP   = 0;
+   clErrCoalesceTimerP.start((int) ulErrCoalesceTimeP);
+
+   return (false);
+}
+
+
 //--------------------------------------------------------------------------------------------------------------------//
 // QCanNetwork::handleCanFrame()                                                                                      //
 //                                                                                                                    //
@@ -564,10 +680,27 @@ uint32_t QCanNetwork::frameSize(const QByteArray & clSockDataR)
 bool  QCanNetwork::handleCanFrame(enum FrameSource_e teFrameSrcV, const int32_t slSockSrcV, const QByteArray clSockDataV)
 {
    int32_t        slSockIdxT;
+   int32_t        slEntryT = -1;
+   int64_t        sqTimeT  = 0;
+   bool           btSubscriptionT = false;
    bool           btResultT = false;
    QLocalSocket * pclLocalSockS;
    QTcpSocket *   pclTcpSockS;
 
+   //---------------------------------------------------------------------------------------------------
+   // if coalescing of error frames is enabled, a repetition of the last error frame is only counted,
+   // the report of the repetitions has been counted already
+   //
+   if ((ulErrCoalesceTimeP > 0) && (btErrRepeatWriteP == false) && ((clSockDataV.at(0) & 0x20) > 0))
+   {
+      if (coalesceErrorFrame(teFrameSrcV, slSockSrcV, clSockDataV))
+      {
+         ulCntFrameErrP++;
+         ulCntBitCurP = ulCntBitCurP + frameSize(clSockDataV);
+         return (false);
+      }
+   }
+
    //---------------------------------------------------------------------------------------------------
    // If a CAN interface is present and the source of this data is not the CAN interface: convert to a
    // QCanFrame and write it to the interface
@@ -578,6 +711,24 @@ bool  QCanNetwork::handleCanFrame(enum FrameSource_e teFrameSrcV, const int32_t
       pclInterfaceP->write(clCanFrameOutP);
    }
 
+   //---------------------------------------------------------------------------------------------------
+   // update the last value table, it is maintained while the last value cache is enabled or a socket
+   // has a subscription
+   //
+   if ((btValueCacheEnabledP == true) || (clSubscriptionP.isEmpty() == false))
+   {
+      slEntryT = clValueTableP.update(clSockDataV);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // subscriptions are evaluated for frames which are stored in the table, all other frames are sent
+   // to all sockets
+   //
+   if ((slEntryT >= 0) && (clSubscriptionP.isEmpty() == false))
+   {
+      btSubscriptionT = true;
+      sqTimeT = clSubscriptionTimeP.nsecsElapsed() / 1000;
+   }
 
    //---------------------------------------------------------------------------------------------------
    // check all open local sockets and write CAN frame
@@ -597,11 +748,14 @@ bool  QCanNetwork::handleCanFrame(enum FrameSource_e teFrameSrcV, const int32_t
       else
       {
          //-----------------------------------------------------------------------------------
-         // copy data to socket
+         // copy data to socket, if it matches the subscription
          //
          pclLocalSockS = pclLocalSockListP->at(slSockIdxT);
-         pclLocalSockS->write(clSockDataV);
-         btResultT = true;
+         if ((btSubscriptionT == false) || isSubscribed(pclLocalSockS, slEntryT, sqTimeT))
+         {
+            pclLocalSockS->write(clSockDataV);
+            btResultT = true;
+         }
       }
    }
 
@@ -623,30 +777,397 @@ bool  QCanNetwork::handleCanFrame(enum FrameSource_e teFrameSrcV, const int32_t
       else
       {
          //-----------------------------------------------------------------------------------
-         // copy data to socket
+         // copy data to socket, the data is transmitted by the event loop: all frames which
+         // are written until then are sent with a single system call
          //
          pclTcpSockS = pclTcpSockListP->at(slSockIdxT);
-         pclTcpSockS->write(clSockDataV);
-         pclTcpSockS->flush();
-         btResultT = true;
+         if ((btSubscriptionT == false) || isSubscribed(pclTcpSockS, slEntryT, sqTimeT))
+         {
+            pclTcpSockS->write(clSockDataV);
+            btResultT = true;
+         }
       }
    }
 
+   //---------------------------------------------------------------------------------------------------
+   // pass CAN frame to multiplexed connections
+   //
+   if (pclMuxP.isNull() == false)
+   {
+      pclMuxP->distribute(ubIdP, clSockDataV);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // add CAN frame to the multicast datagram, a full datagram is sent immediately
+   //
+   if (pclMcastSockP.isNull() == false)
+   {
+      clMcastDataP.append(clSockDataV.constData(), QCAN_FRAME_ARRAY_SIZE);
+      ubMcastFrameCntP++;
+      if (ubMcastFrameCntP >= QCAN_MCAST_FRAME_MAX)
+      {
+         onMulticastWrite();
+      }
+      else if (btMcastWritePendingP == false)
+      {
+         btMcastWritePendingP = true;
+         QMetaObject::invokeMethod(this, "onMulticastWrite", Qt::QueuedConnection);
+      }
+      btResultT = true;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // pass CAN frame to the gateway, a frame which has been forwarded by the gateway is not passed
+   // again
+   //
+   if ((pclGatewayP.isNull() == false) && (teFrameSrcV != eFRAME_SOURCE_GATEWAY))
+   {
+      pclGatewayP->route(ubIdP, clSockDataV);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // pass CAN frame to the recorder, the frame is copied into the ring
+   //
+   if (pclRecorderP->isEnabled())
+   {
+      pclRecorderP->appendFrame(clSockDataV);
+   }
+
 
    //---------------------------------------------------------------------------------------------------
    // count frame
    //
-   if ((clSockDataV.at(0) & 0x20) > 0)
+   if (btErrRepeatWriteP == false)
+   {
+      if ((clSockDataV.at(0) & 0x20) > 0)
+      {
+         ulCntFrameErrP++;
+      }
+      else
+      {
+         ulCntFrameCanP++;
+      }
+      ulCntBitCurP = ulCntBitCurP + frameSize(clSockDataV);
+   }
+
+   return(btResultT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::handleCyclic()                                                                                        //
+// handle cyclic frame record of a socket                                                                             //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::handleCyclic(QIODevice * pclSocketV, const QByteArray & clRecordR)
+{
+   const uint8_t *   pubRecordT;
+   QByteArray        clFrameDataT;
+   QCanFrame         clFrameT;
+   CyclicStatus_ts   tsStatusT;
+   uint16_t          uwHandleT;
+   uint16_t          uwChecksumT;
+   uint32_t          ulPeriodT;
+   bool              btResultT = false;
+
+   if (clRecordR.size() < QCAN_FRAME_ARRAY_SIZE)
    {
-      ulCntFrameErrP++;
+      return;
+   }
+
+   pubRecordT = (const uint8_t *) clRecordR.constData();
+   uwHandleT  = ((uint16_t) pubRecordT[72] << 8) | ((uint16_t) pubRecordT[73]);
+   ulPeriodT  = ((uint32_t) pubRecordT[74] << 24) | ((uint32_t) pubRecordT[75] << 16) |
+                ((uint32_t) pubRecordT[76] <<  8) | ((uint32_t) pubRecordT[77]);
+
+   //---------------------------------------------------------------------------------------------------
+   // byte 0 .. 69 of the record hold the frame, the remaining bytes are cleared and the checksum is
+   // calculated like QCanFrame::toByteArray() does
+   //
+   clFrameDataT = clRecordR.left(QCAN_FRAME_ARRAY_SIZE);
+   clFrameDataT.replace(70, QCAN_FRAME_ARRAY_SIZE - 70, QByteArray(QCAN_FRAME_ARRAY_SIZE - 70, 0x00));
+   uwChecksumT = qChecksum(clFrameDataT.constData(), QCAN_FRAME_ARRAY_SIZE - 2);
+   clFrameDataT[94] = (uint8_t) (uwChecksumT >> 8);
+   clFrameDataT[95] = (uint8_t) (uwChecksumT >> 0);
+
+   switch (pubRecordT[70])
+   {
+      case QCAN_CYCLIC_SET:
+         if (clFrameT.fromByteArray(clFrameDataT))
+         {
+            btResultT = pclSchedulerP->setFrame(pclSocketV, uwHandleT, clFrameT, ulPeriodT,
+                                                pubRecordT[78], pubRecordT[79]);
+         }
+         break;
+
+      case QCAN_CYCLIC_PATTERN:
+         if (clFrameT.fromByteArray(clFrameDataT))
+         {
+            btResultT = pclSchedulerP->appendPattern(pclSocketV, uwHandleT, clFrameT);
+         }
+         break;
+
+      case QCAN_CYCLIC_CANCEL:
+         btResultT = pclSchedulerP->cancel(pclSocketV, uwHandleT);
+         break;
+
+      case QCAN_CYCLIC_STATUS:
+         //-------------------------------------------------------------------------------------------
+         // answer with one record for each cyclic frame of the socket
+         //
+         foreach (uint16_t uwStatusHandleT, pclSchedulerP->handles(pclSocketV))
+         {
+            QByteArray  clStatusT(QCAN_FRAME_ARRAY_SIZE, 0x00);
+
+            pclSchedulerP->status(pclSocketV, uwStatusHandleT, tsStatusT);
+            qToBigEndian<quint32>(tsStatusT.ulCount,      (uchar *) clStatusT.data() + 0);
+            qToBigEndian<qint32>(tsStatusT.slJitterLast,  (uchar *) clStatusT.data() + 4);
+            qToBigEndian<quint32>(tsStatusT.ulJitterMax,  (uchar *) clStatusT.data() + 8);
+            qToBigEndian<quint32>(tsStatusT.ulJitterMean, (uchar *) clStatusT.data() + 12);
+            clStatusT[70] = QCAN_CYCLIC_STATUS;
+            qToBigEndian<quint16>(uwStatusHandleT,        (uchar *) clStatusT.data() + 72);
+            clStatusT[QCAN_RECORD_TYPE_POS] = QCAN_RECORD_CYCLIC;
+            pclSocketV->write(clStatusT);
+         }
+         btResultT = true;
+         break;
+
+      default:
+
+         break;
+   }
+
+   if (btResultT == false)
+   {
+      emit addLogMessage(channel(), QString("Cyclic frame request %1 for handle %2 failed")
+                                    .arg(pubRecordT[70]).arg(uwHandleT), eLOG_LEVEL_WARN);
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::handleRecord()                                                                                        //
+// handle control record of a socket                                                                                  //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::handleRecord(QIODevice * pclSocketV, const QByteArray & clRecordR)
+{
+   switch (clRecordR.at(QCAN_RECORD_TYPE_POS))
+   {
+      case QCAN_RECORD_SUBSCRIPTION:
+         handleSubscription(pclSocketV, clRecordR);
+         break;
+
+      case QCAN_RECORD_SNAPSHOT:
+         handleSnapshot(pclSocketV);
+         break;
+
+      case QCAN_RECORD_CYCLIC:
+         handleCyclic(pclSocketV, clRecordR);
+         break;
+
+      default:
+
+         break;
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::handleSnapshot()                                                                                      //
+// send last frame of each identifier to a socket                                                                     //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::handleSnapshot(QIODevice * pclSocketV)
+{
+   QHash<QObject *, Subscription_s>::iterator   clSubscriptionT;
+   int64_t                                      sqTimeT;
+   int32_t                                      slEntryT;
+
+   if (clValueTableP.entryCount() == 0)
+   {
+      return;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // the frames are stored contiguously, so all frames are written at once
+   //
+   pclSocketV->write(clValueTableP.snapshot());
+
+   //---------------------------------------------------------------------------------------------------
+   // for a socket with subscription the frames of the snapshot count as sent
+   //
+   clSubscriptionT = clSubscriptionP.find(pclSocketV);
+   if (clSubscriptionT != clSubscriptionP.end())
+   {
+      sqTimeT = clSubscriptionTimeP.nsecsElapsed() / 1000;
+      clSubscriptionT->clState.resize(clValueTableP.entryCount());
+      for (slEntryT = 0; slEntryT < clValueTableP.entryCount(); slEntryT++)
+      {
+         clSubscriptionT->clState[slEntryT].sqSendTime    = sqTimeT;
+         clSubscriptionT->clState[slEntryT].ulChangeCount = clValueTableP.changeCount(slEntryT);
+         clSubscriptionT->clState[slEntryT].btValid       = true;
+      }
+   }
+
+   emit addLogMessage(channel(),
+                      QString("Snapshot of %1 frame(s) sent").arg(clValueTableP.entryCount()),
+                      eLOG_LEVEL_DEBUG);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::handleSubscription()                                                                                  //
+// store subscription of a socket                                                                                     //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::handleSubscription(QObject * pclSocketV, const QByteArray & clRecordR)
+{
+   const uint8_t *   pubRecordT;
+   Subscription_s    tsSubscriptionT;
+   uint32_t          ulRateT;
+   uint32_t          ulKeepAliveT;
+
+   if (clRecordR.size() < QCAN_FRAME_ARRAY_SIZE)
+   {
+      return;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // byte 0 holds the flags, byte 4 .. 7 the maximum rate in Hz and byte 8 .. 11 the keep-alive time
+   // in milli-seconds
+   //
+   pubRecordT   = (const uint8_t *) clRecordR.constData();
+   ulRateT      = ((uint32_t) pubRecordT[4] << 24) | ((uint32_t) pubRecordT[5] << 16) |
+                  ((uint32_t) pubRecordT[6] <<  8) | ((uint32_t) pubRecordT[7]);
+   ulKeepAliveT = ((uint32_t) pubRecordT[8] << 24) | ((uint32_t) pubRecordT[9] << 16) |
+                  ((uint32_t) pubRecordT[10] << 8) | ((uint32_t) pubRecordT[11]);
+
+   tsSubscriptionT.btChangeOnly = ((pubRecordT[0] & QCAN_SUBSCRIBE_CHANGE) > 0);
+   tsSubscriptionT.sqInterval   = 0;
+   tsSubscriptionT.sqKeepAlive  = ((int64_t) ulKeepAliveT) * 1000;
+   if (ulRateT > 0)
+   {
+      tsSubscriptionT.sqInterval = ((int64_t) 1000000) / ulRateT;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // a subscription without restriction is removed, the last value table is not required anymore if
+   // there is no subscription left and the last value cache is disabled
+   //
+   if ((tsSubscriptionT.btChangeOnly == false) && (tsSubscriptionT.sqInterval == 0))
+   {
+      clSubscriptionP.remove(pclSocketV);
+      if (clSubscriptionP.isEmpty() && (btValueCacheEnabledP == false))
+      {
+         clearValueTable();
+      }
    }
    else
    {
-      ulCntFrameCanP++;
+      clSubscriptionP.insert(pclSocketV, tsSubscriptionT);
    }
-   ulCntBitCurP = ulCntBitCurP + frameSize(clSockDataV);
 
-   return(btResultT);
+   emit addLogMessage(channel(),
+                      QString("Subscription changed, %1 socket(s) with subscription").arg(clSubscriptionP.size()),
+                      eLOG_LEVEL_DEBUG);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::isSubscribed()                                                                                        //
+// test if frame of a last value table entry is sent to a socket                                                      //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanNetwork::isSubscribed(QObject * pclSocketV, int32_t slEntryV, int64_t sqTimeV)
+{
+   QHash<QObject *, Subscription_s>::iterator   clSubscriptionT;
+   SubscriptionState_s *                        ptsStateT;
+   int64_t                                      sqElapsedT;
+   bool                                         btResultT = false;
+
+   clSubscriptionT = clSubscriptionP.find(pclSocketV);
+   if (clSubscriptionT == clSubscriptionP.end())
+   {
+      return (true);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // the state table of the socket grows with the last value table
+   //
+   if (clSubscriptionT->clState.size() <= slEntryV)
+   {
+      SubscriptionState_s tsStateT;
+      tsStateT.sqSendTime    = 0;
+      tsStateT.ulChangeCount = 0;
+      tsStateT.btValid       = false;
+      clSubscriptionT->clState.resize(clValueTableP.entryCount());
+      for (int32_t slIdxT = slEntryV; slIdxT < clSubscriptionT->clState.size(); slIdxT++)
+      {
+         clSubscriptionT->clState[slIdxT] = tsStateT;
+      }
+   }
+   ptsStateT = &(clSubscriptionT->clState[slEntryV]);
+
+   //---------------------------------------------------------------------------------------------------
+   // the first frame of an identifier is always sent, after that a frame is sent when the minimum
+   // interval has elapsed and - for a change-only subscription - the payload has changed or the
+   // keep-alive time has elapsed
+   //
+   if (ptsStateT->btValid == false)
+   {
+      btResultT = true;
+   }
+   else
+   {
+      sqElapsedT = sqTimeV - ptsStateT->sqSendTime;
+      if (sqElapsedT >= clSubscriptionT->sqInterval)
+      {
+         if (clSubscriptionT->btChangeOnly == false)
+         {
+            btResultT = true;
+         }
+         else if (ptsStateT->ulChangeCount != clValueTableP.changeCount(slEntryV))
+         {
+            btResultT = true;
+         }
+         else if ((clSubscriptionT->sqKeepAlive > 0) && (sqElapsedT >= clSubscriptionT->sqKeepAlive))
+         {
+            btResultT = true;
+         }
+      }
+   }
+
+   if (btResultT == true)
+   {
+      ptsStateT->sqSendTime    = sqTimeV;
+      ptsStateT->ulChangeCount = clValueTableP.changeCount(slEntryV);
+      ptsStateT->btValid       = true;
+   }
+
+   return (btResultT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::moveErrorSource()                                                                                     //
+// a socket has been removed from a socket list, update the index of the error frame source                           //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::moveErrorSource(enum FrameSource_e teFrameSrcV, const int32_t slSockIdxV,
+                                  const int32_t slSockLastV)
+{
+   if (teErrFrameSrcP != teFrameSrcV)
+   {
+      return;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // the last socket of the list has been moved to the position of the removed socket, if the source
+   // socket itself has been removed, the pending report is sent to all sockets
+   //
+   if (slErrSockSrcP == slSockIdxV)
+   {
+      slErrSockSrcP = -1;
+   }
+   else if (slErrSockSrcP == slSockLastV)
+   {
+      slErrSockSrcP = slSockIdxV;
+   }
 }
 
 
@@ -667,6 +1188,13 @@ void QCanNetwork::reset(void)
    ulFramePerSecMaxP = 0;
    ulFrameCntSaveP   = 0;
 
+   //--------------------------------------------------------------------------------------
+   // pending repetitions of an error frame are discarded
+   //
+   clErrCoalesceTimerP.stop();
+   ulCntFrameErrCoalescedP = 0;
+   ulErrRepeatP = 0;
+
 
    //--------------------------------------------------------------------------------------
    // the initial network state depends if it is enabled or not
@@ -737,6 +1265,24 @@ QString QCanNetwork::nominalBitrateString(void)
 }
 
 
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::onErrorCoalesceTimer()                                                                                //
+// time window for coalescing of error frames has expired                                                             //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::onErrorCoalesceTimer(void)
+{
+   //---------------------------------------------------------------------------------------------------
+   // during an error storm the time window is restarted, so the repetitions are reported once per
+   // time window
+   //
+   if (ulErrRepeatP > 0)
+   {
+      writeErrorRepeat();
+      clErrCoalesceTimerP.start((int) ulErrCoalesceTimeP);
+   }
+}
+
+
 //--------------------------------------------------------------------------------------------------------------------//
 // QCanNetwork::onInterfaceConnectionChanged()                                                                        //
 // handle connection states of a physical CAN interface                                                               //
@@ -875,10 +1421,30 @@ void QCanNetwork::onLocalSocketConnect(void)
    QLocalSocket * pclSocketT;
 
    //---------------------------------------------------------------------------------------------------
-   // Get next pending connect and add this socket to the the socket list
+   // Get next pending connect, the socket is closed if the maximum number of local sockets is reached
    //
    pclSocketT =  pclLocalSrvP->nextPendingConnection();
+   if (pclSocketT == Q_NULLPTR)
+   {
+      return;
+   }
+
    clLocalSockMutexP.lock();
+   if ((uint32_t) pclLocalSockListP->size() >= ulLocalSockMaxP)
+   {
+      clLocalSockMutexP.unlock();
+      pclSocketT->abort();
+      pclSocketT->deleteLater();
+      emit addLogMessage(channel(),
+                         QString("Local socket refused, limit of %1 reached").arg(ulLocalSockMaxP),
+                         eLOG_LEVEL_WARN);
+      return;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // add this socket to the socket list and register its position
+   //
+   clLocalSockIndexP.insert(pclSocketT, pclLocalSockListP->size());
    pclLocalSockListP->append(pclSocketT);
    clLocalSockMutexP.unlock();
 
@@ -915,6 +1481,7 @@ void QCanNetwork::onLocalSocketConnect(void)
 void QCanNetwork::onLocalSocketDisconnect(void)
 {
    int32_t        slSockIdxT;
+   int32_t        slSockLastT;
    QLocalSocket * pclSockT;
    QLocalSocket * pclSenderT;
 
@@ -930,20 +1497,43 @@ void QCanNetwork::onLocalSocketDisconnect(void)
    disconnect(pclSenderT, 0, 0, 0);
 
    //---------------------------------------------------------------------------------------------------
-   // remove sender from socket list
+   // remove sender from socket list: the last socket of the list is moved to the position of the
+   // sender, so no other socket has to be moved
    //
    clLocalSockMutexP.lock();
-   for(slSockIdxT = 0; slSockIdxT < pclLocalSockListP->size(); slSockIdxT++)
+   slSockIdxT = clLocalSockIndexP.take(pclSenderT);
+   if (clLocalSockIndexP.size() < pclLocalSockListP->size())
    {
-      pclSockT = pclLocalSockListP->at(slSockIdxT);
-      if (pclSockT == pclSenderT)
+      slSockLastT = pclLocalSockListP->size() - 1;
+      if (slSockIdxT != slSockLastT)
       {
-         pclLocalSockListP->remove(slSockIdxT);
-         break;
+         pclSockT = pclLocalSockListP->at(slSockLastT);
+         (*pclLocalSockListP)[slSockIdxT] = pclSockT;
+         clLocalSockIndexP[pclSockT] = slSockIdxT;
       }
+      pclLocalSockListP->removeLast();
+      moveErrorSource(eFRAME_SOURCE_SOCKET_LOCAL, slSockIdxT, slSockLastT);
    }
    clLocalSockMutexP.unlock();
 
+   //---------------------------------------------------------------------------------------------------
+   // remove subscription of the socket
+   //
+   if (clSubscriptionP.remove(pclSenderT) > 0)
+   {
+      if (clSubscriptionP.isEmpty() && (btValueCacheEnabledP == false))
+      {
+         clearValueTable();
+      }
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // stop cyclic frames of the socket
+   //
+   pclSchedulerP->cancelAll(pclSenderT);
+
+   pclSenderT->deleteLater();
+
    //---------------------------------------------------------------------------------------------------
    // Prepare log message and send it
    //
@@ -965,29 +1555,36 @@ void QCanNetwork::onLocalSocketNewData(void)
 {
    QLocalSocket *    pclLocalSockT;
    int32_t           slSockIdxT;
-   int32_t           slListSizeT;
    uint32_t          ulFrameMaxT;
    static QByteArray clSockDataT;
 
 
    //---------------------------------------------------------------------------------------------------
-   // lock socket list
+   // only the socket which has emitted the signal is read, its position in the socket list is
+   // taken from the registry
    //
-   clLocalSockMutexP.lock();
-
+   pclLocalSockT = (QLocalSocket* ) QObject::sender();
 
    //---------------------------------------------------------------------------------------------------
-   // check all open local sockets and read messages
+   // lock socket list
    //
-   slListSizeT = pclLocalSockListP->size();
-   for(slSockIdxT = 0; slSockIdxT < slListSizeT; slSockIdxT++)
+   clLocalSockMutexP.lock();
+
+   slSockIdxT = clLocalSockIndexP.value(pclLocalSockT, -1);
+   if (slSockIdxT >= 0)
    {
-      pclLocalSockT = pclLocalSockListP->at(slSockIdxT);
       ulFrameMaxT = (pclLocalSockT->bytesAvailable()) / QCAN_FRAME_ARRAY_SIZE;
       while (ulFrameMaxT > 0)
       {
          clSockDataT = pclLocalSockT->read(QCAN_FRAME_ARRAY_SIZE);
-         handleCanFrame(eFRAME_SOURCE_SOCKET_LOCAL, slSockIdxT, clSockDataT);
+         if (clSockDataT.at(QCAN_RECORD_TYPE_POS) != 0)
+         {
+            handleRecord(pclLocalSockT, clSockDataT);
+         }
+         else
+         {
+            handleCanFrame(eFRAME_SOURCE_SOCKET_LOCAL, slSockIdxT, clSockDataT);
+         }
 
          ulFrameMaxT = (pclLocalSockT->bytesAvailable()) / QCAN_FRAME_ARRAY_SIZE;
       }
@@ -1000,6 +1597,55 @@ void QCanNetwork::onLocalSocketNewData(void)
 }
 
 
+//--------------------------------------------------------------------------------------------------------------------//
+// onMulticastWrite()                                                                                                 //
+// send UDP multicast datagram                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::onMulticastWrite(void)
+{
+   btMcastWritePendingP = false;
+
+   if ((pclMcastSockP.isNull() == false) && (ubMcastFrameCntP > 0))
+   {
+      //-------------------------------------------------------------------------------------------
+      // header: sequence number, CAN channel and number of frames
+      //
+      clMcastDataP[0] = (uint8_t) (ulMcastSequenceP >> 24);
+      clMcastDataP[1] = (uint8_t) (ulMcastSequenceP >> 16);
+      clMcastDataP[2] = (uint8_t) (ulMcastSequenceP >>  8);
+      clMcastDataP[3] = (uint8_t) (ulMcastSequenceP >>  0);
+      clMcastDataP[4] = ubIdP;
+      clMcastDataP[5] = ubMcastFrameCntP;
+
+      pclMcastSockP->writeDatagram(clMcastDataP, clMcastGroupP, QCAN_MCAST_PORT + ubIdP - 1);
+      ulMcastSequenceP++;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // start next datagram with an empty header
+   //
+   clMcastDataP.fill(0x00, QCAN_MCAST_HEADER_SIZE);
+   ubMcastFrameCntP = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// onRecorderTraceWritten()                                                                                           //
+// report trace file of recorder                                                                                      //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::onRecorderTraceWritten(const QString & clFileNameR, const bool & btSuccessR)
+{
+   if (btSuccessR)
+   {
+      emit addLogMessage(CAN_Channel_e (id()), "Recorder trace written to " + clFileNameR, eLOG_LEVEL_INFO);
+   }
+   else
+   {
+      emit addLogMessage(CAN_Channel_e (id()), "Failed to write recorder trace " + clFileNameR, eLOG_LEVEL_WARN);
+   }
+}
+
+
 //--------------------------------------------------------------------------------------------------------------------//
 // onTcpSocketConnect()                                                                                               //
 // slot that manages a new TCP server connection                                                                      //
@@ -1009,11 +1655,31 @@ void QCanNetwork::onTcpSocketConnect(void)
    QTcpSocket *   pclSocketT;
    
    //----------------------------------------------------------------
-   // Get next pending connect and add this socket to the
-   // the socket list
+   // Get next pending connect, the socket is closed if the maximum
+   // number of TCP sockets is reached
    //
    pclSocketT =  pclTcpSrvP->nextPendingConnection();
+   if (pclSocketT == Q_NULLPTR)
+   {
+      return;
+   }
+
    clTcpSockMutexP.lock();
+   if ((uint32_t) pclTcpSockListP->size() >= ulTcpSockMaxP)
+   {
+      clTcpSockMutexP.unlock();
+      pclSocketT->abort();
+      pclSocketT->deleteLater();
+      emit addLogMessage(CAN_Channel_e (id()),
+                         QString("Socket refused, limit of %1 reached").arg(ulTcpSockMaxP),
+                         eLOG_LEVEL_WARN);
+      return;
+   }
+
+   //----------------------------------------------------------------
+   // add this socket to the socket list and register its position
+   //
+   clTcpSockIndexP.insert(pclSocketT, pclTcpSockListP->size());
    pclTcpSockListP->append(pclSocketT);
    clTcpSockMutexP.unlock();
 
@@ -1037,7 +1703,12 @@ void QCanNetwork::onTcpSocketConnect(void)
             SLOT(onTcpSocketDisconnect())   );
    
    //----------------------------------------------------------------
-   // Todo: Send information to client:
+   // Add a slot that handles when new data is available
+   //
+   connect( pclSocketT,
+            SIGNAL(readyRead()),
+            this,
+            SLOT(onTcpSocketNewData())   );
 }
 
 
@@ -1048,6 +1719,7 @@ void QCanNetwork::onTcpSocketConnect(void)
 void QCanNetwork::onTcpSocketDisconnect(void)
 {
    int32_t      slSockIdxT;
+   int32_t      slSockLastT;
    QTcpSocket * pclSockT;
    QTcpSocket * pclSenderT;
 
@@ -1057,18 +1729,46 @@ void QCanNetwork::onTcpSocketDisconnect(void)
    //
    pclSenderT = (QTcpSocket* ) QObject::sender();
 
+   disconnect(pclSenderT, 0, 0, 0);
+
+   //----------------------------------------------------------------
+   // remove sender from socket list: the last socket of the list
+   // is moved to the position of the sender
+   //
    clTcpSockMutexP.lock();
-   for(slSockIdxT = 0; slSockIdxT < pclTcpSockListP->size(); slSockIdxT++)
+   slSockIdxT = clTcpSockIndexP.take(pclSenderT);
+   if (clTcpSockIndexP.size() < pclTcpSockListP->size())
    {
-      pclSockT = pclTcpSockListP->at(slSockIdxT);
-      if(pclSockT == pclSenderT)
+      slSockLastT = pclTcpSockListP->size() - 1;
+      if (slSockIdxT != slSockLastT)
       {
-         pclTcpSockListP->remove(slSockIdxT);
-         break;
+         pclSockT = pclTcpSockListP->at(slSockLastT);
+         (*pclTcpSockListP)[slSockIdxT] = pclSockT;
+         clTcpSockIndexP[pclSockT] = slSockIdxT;
       }
+      pclTcpSockListP->removeLast();
+      moveErrorSource(eFRAME_SOURCE_SOCKET_TCP, slSockIdxT, slSockLastT);
    }
    clTcpSockMutexP.unlock();
 
+   //----------------------------------------------------------------
+   // remove subscription of the socket
+   //
+   if (clSubscriptionP.remove(pclSenderT) > 0)
+   {
+      if (clSubscriptionP.isEmpty() && (btValueCacheEnabledP == false))
+      {
+         clearValueTable();
+      }
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // stop cyclic frames of the socket
+   //
+   pclSchedulerP->cancelAll(pclSenderT);
+
+   pclSenderT->deleteLater();
+
    //----------------------------------------------------------------
    // Prepare log message and send it
    //
@@ -1087,31 +1787,37 @@ void QCanNetwork::onTcpSocketNewData()
 {
    QTcpSocket *   pclTcpSockT;
    int32_t        slSockIdxT;
-   int32_t        slListSizeT;
    uint32_t       ulFrameMaxT;
    QByteArray     clSockDataT;
 
 
    //---------------------------------------------------------------------------------------------------
-   // lock socket list
+   // only the socket which has emitted the signal is read, its position in the socket list is
+   // taken from the registry
    //
-   clTcpSockMutexP.lock();
-
+   pclTcpSockT = (QTcpSocket* ) QObject::sender();
 
    //---------------------------------------------------------------------------------------------------
-   // check all open TCP sockets and read messages
+   // lock socket list
    //
-   slListSizeT = pclTcpSockListP->size();
-   for(slSockIdxT = 0; slSockIdxT < slListSizeT; slSockIdxT++)
+   clTcpSockMutexP.lock();
+
+   slSockIdxT = clTcpSockIndexP.value(pclTcpSockT, -1);
+   if (slSockIdxT >= 0)
    {
-      pclTcpSockT = pclTcpSockListP->at(slSockIdxT);
       ulFrameMaxT = (pclTcpSockT->bytesAvailable()) / QCAN_FRAME_ARRAY_SIZE;
       while (ulFrameMaxT > 0)
       {
          clSockDataT = pclTcpSockT->read(QCAN_FRAME_ARRAY_SIZE);
-         handleCanFrame(eFRAME_SOURCE_SOCKET_TCP, slSockIdxT, clSockDataT);
+         if (clSockDataT.at(QCAN_RECORD_TYPE_POS) != 0)
+         {
+            handleRecord(pclTcpSockT, clSockDataT);
+         }
+         else
+         {
+            handleCanFrame(eFRAME_SOURCE_SOCKET_TCP, slSockIdxT, clSockDataT);
+         }
          ulFrameMaxT = (pclTcpSockT->bytesAvailable()) / QCAN_FRAME_ARRAY_SIZE;
-
       }
    }
 
@@ -1174,6 +1880,18 @@ void QCanNetwork::onTimerEvent(void)
       // store actual frame counter value
       //
       ulFrameCntSaveP = ulCntFrameCanP;
+
+      //--------------------------------------------------------------------------------------
+      // report size of the last value cache
+      //
+      if ((pclSettingsP != 0L) && pclSettingsP->isAttached() )
+      {
+         pclSettingsP->lock();
+         ServerSettings_ts * ptsSettingsT = (ServerSettings_ts *) pclSettingsP->data();
+         ptsSettingsT->atsNetwork[ubIdP - 1].slValueCacheCount = clValueTableP.entryCount();
+         ptsSettingsT->atsNetwork[ubIdP - 1].slValueCacheSize  = clValueTableP.memorySize();
+         pclSettingsP->unlock();
+      }
       
 
       //--------------------------------------------------------------------------------------
@@ -1332,6 +2050,30 @@ void QCanNetwork::setCanState(CAN_State_e teStateV)
    // signal the new state to destination
    //
    emit showState(CAN_Channel_e (id()), teCanStateP);
+
+   //---------------------------------------------------------------------------------------------------
+   // a state change may trigger the recorder
+   //
+   pclRecorderP->changeState(teCanStateP);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::setErrorCoalescingTime()                                                                              //
+// set time window for coalescing of error frames                                                                     //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::setErrorCoalescingTime(uint32_t ulTimeV)
+{
+   //---------------------------------------------------------------------------------------------------
+   // pending repetitions are reported before the time window is changed
+   //
+   if (clErrCoalesceTimerP.isActive())
+   {
+      clErrCoalesceTimerP.stop();
+      writeErrorRepeat();
+   }
+
+   ulErrCoalesceTimeP = ulTimeV;
 }
 
 
@@ -1485,7 +2227,7 @@ void QCanNetwork::setNetworkEnabled(bool btEnableV)
       //-------------------------------------------------------------------------------------------
       // limit the number of connections for local server
       //
-      pclLocalSrvP->setMaxPendingConnections(QCAN_TCP_SOCKET_MAX);
+      pclLocalSrvP->setMaxPendingConnections(ulLocalSockMaxP);
       pclLocalSrvP->setSocketOptions(QLocalServer::WorldAccessOption);
       if(!pclLocalSrvP->listen(QString("CANpieServerChannel%1").arg(ubIdP)))
       {
@@ -1508,7 +2250,7 @@ void QCanNetwork::setNetworkEnabled(bool btEnableV)
       //-------------------------------------------------------------------------------------------
       // limit the number of connections for TCP server
       //
-      pclTcpSrvP->setMaxPendingConnections(QCAN_TCP_SOCKET_MAX);
+      pclTcpSrvP->setMaxPendingConnections(ulTcpSockMaxP);
 
       if(!pclTcpSrvP->listen(clTcpHostAddrP, uwTcpPortP))
       {
@@ -1586,6 +2328,53 @@ void QCanNetwork::setNetworkEnabled(bool btEnableV)
 }
 
 
+//--------------------------------------------------------------------------------------------------------------------//
+// setMulticastEnabled()                                                                                              //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanNetwork::setMulticastEnabled(bool btEnableV, QHostAddress clGroupV)
+{
+   bool  btResultT = false;
+
+   if (btEnableV == true)
+   {
+      if ((pclMcastSockP.isNull() == true) && (clGroupV.isMulticast() == true))
+      {
+         //-------------------------------------------------------------------------------------------
+         // the datagrams stay inside the local network and are looped back to the host
+         //
+         pclMcastSockP = new QUdpSocket(this);
+         pclMcastSockP->bind(QHostAddress(QHostAddress::AnyIPv4), 0);
+         pclMcastSockP->setSocketOption(QAbstractSocket::MulticastTtlOption, 1);
+         pclMcastSockP->setSocketOption(QAbstractSocket::MulticastLoopbackOption, 1);
+
+         clMcastGroupP = clGroupV;
+         clMcastDataP.fill(0x00, QCAN_MCAST_HEADER_SIZE);
+         clMcastDataP.reserve(QCAN_MCAST_HEADER_SIZE + (QCAN_MCAST_FRAME_MAX * QCAN_FRAME_ARRAY_SIZE));
+         ubMcastFrameCntP = 0;
+
+         addLogMessage(CAN_Channel_e (id()),
+                       QString("UDP multicast enabled, group ") + clGroupV.toString(), eLOG_LEVEL_INFO);
+      }
+      btResultT = (pclMcastSockP.isNull() == false);
+   }
+   else
+   {
+      if (pclMcastSockP.isNull() == false)
+      {
+         onMulticastWrite();
+         pclMcastSockP->close();
+         delete (pclMcastSockP);
+
+         addLogMessage(CAN_Channel_e (id()), "UDP multicast disabled", eLOG_LEVEL_INFO);
+      }
+      btResultT = true;
+   }
+
+   return(btResultT);
+}
+
+
 //--------------------------------------------------------------------------------------------------------------------//
 // setServerAddress()                                                                                                 //
 //                                                                                                                    //
@@ -1609,6 +2398,69 @@ bool QCanNetwork::setServerAddress(QHostAddress clHostAddressV)
 }
 
 
+//--------------------------------------------------------------------------------------------------------------------//
+// setSocketMax()                                                                                                     //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanNetwork::setSocketMax(uint32_t ulLocalMaxV, uint32_t ulTcpMaxV)
+{
+   bool  btResultT = false;
+
+   if ((ulLocalMaxV > 0) && (ulTcpMaxV > 0))
+   {
+      clLocalSockMutexP.lock();
+      ulLocalSockMaxP = ulLocalMaxV;
+      pclLocalSockListP->reserve(ulLocalSockMaxP);
+      clLocalSockIndexP.reserve(ulLocalSockMaxP);
+      pclLocalSrvP->setMaxPendingConnections(ulLocalSockMaxP);
+      clLocalSockMutexP.unlock();
+
+      clTcpSockMutexP.lock();
+      ulTcpSockMaxP = ulTcpMaxV;
+      pclTcpSockListP->reserve(ulTcpSockMaxP);
+      clTcpSockIndexP.reserve(ulTcpSockMaxP);
+      pclTcpSrvP->setMaxPendingConnections(ulTcpSockMaxP);
+      clTcpSockMutexP.unlock();
+
+      btResultT = true;
+   }
+
+   return(btResultT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// setValueCacheEnabled()                                                                                             //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::setValueCacheEnabled(bool btEnableV)
+{
+   btValueCacheEnabledP = btEnableV;
+
+   //---------------------------------------------------------------------------------------------------
+   // the table is still required by subscriptions
+   //
+   if ((btValueCacheEnabledP == false) && clSubscriptionP.isEmpty())
+   {
+      clearValueTable();
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// setValueCacheMax()                                                                                                 //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::setValueCacheMax(uint32_t ulEntryMaxV)
+{
+   if ((uint32_t) clValueTableP.entryCount() > ulEntryMaxV)
+   {
+      clearValueTable();
+   }
+   clValueTableP.setEntryMax(ulEntryMaxV);
+}
+
+
 //--------------------------------------------------------------------------------------------------------------------//
 // startInterface()                                                                                                   //
 //                                                                                                                    //
@@ -1680,3 +2532,21 @@ bool QCanNetwork::stopInterface(void)
 
    return (btResultT);
 }
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanNetwork::writeErrorRepeat()                                                                                    //
+// distribute the last error frame with the number of repetitions                                                     //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanNetwork::writeErrorRepeat(void)
+{
+   if (ulErrRepeatP > 0)
+   {
+      clErrFrameP.setUser(ulErrRepeatP);
+      ulErrRepeatP = 0;
+
+      btErrRepeatWriteP = true;
+      handleCanFrame(teErrFrameSrcP, slErrSockSrcP, clErrFrameP.toByteArray());
+      btErrRepeatWriteP = false;
+   }
+}
@@ -38,6 +38,8 @@
 \*--------------------------------------------------------------------------------------------------------------------*/
 
 #include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
 #include <QtCore/QMutex>
 #include <QtCore/QPointer>
 #include <QtCore/QSharedMemory>
@@ -48,9 +50,15 @@
 
 #include <QtNetwork/QTcpServer>
 #include <QtNetwork/QTcpSocket>
+#include <QtNetwork/QUdpSocket>
 
 #include "qcan_frame.hpp"
+#include "qcan_gateway.hpp"
 #include "qcan_interface.hpp"
+#include "qcan_multiplexer.hpp"
+#include "qcan_recorder.hpp"
+#include "qcan_scheduler.hpp"
+#include "qcan_value_table.hpp"
 
 
 using namespace QCan;
@@ -74,7 +82,31 @@ using namespace QCan;
 ** <p>
 ** <h2>Sockets</h2>
 ** Clients can connect to a QCanNetwork via the QCanSocket class, either via a local socket or a TCP socket. The
-** maximum number of available sockets is defined by #QCAN_LOCAL_SOCKET_MAX and #QCAN_TCP_SOCKET_MAX.
+** maximum number of available sockets is set by setSocketMax(), the default values are defined by
+** #QCAN_LOCAL_SOCKET_MAX and #QCAN_TCP_SOCKET_MAX. A socket is registered with its position in the socket
+** list, so the effort for reception and disconnection of a socket does not depend on the number of
+** connected sockets.
+** <p>
+** Passive listeners can receive the frames of a network by UDP multicast (see setMulticastEnabled()). Several
+** frames are packed into one datagram, so the effort of the network does not depend on the number of
+** listeners.
+** <p>
+** A socket can restrict the frames it receives by a subscription (see QCanSocket::setSubscription()): only
+** frames with a changed payload and / or a maximum rate per identifier. The subscription is evaluated by the
+** network against a table with the last frame of each identifier (see QCanValueTable).
+** <p>
+** The same table serves as last value cache (see setValueCacheEnabled()): a socket which connects to the
+** network can request the last frame of each identifier with QCanSocket::requestSnapshot(), so it does not
+** have to wait for the next transmission of slow cyclic frames. The number of identifiers in the cache is
+** limited by setValueCacheMax(), the memory footprint is returned by valueCacheSize().
+** <p>
+** The recorder of the network (see recorder()) keeps the latest frames in a ring with a fixed memory budget.
+** When a trigger condition is met, the frames before and after the trigger are written to a trace file
+** without stalling the routing of frames.
+** <p>
+** The scheduler of the network (see scheduler()) transmits cyclic frames, which are registered by the server
+** or by a socket (see QCanSocket::setCyclicFrame()). The cyclic frames of a socket are removed when the
+** socket is disconnected.
 ** It is only possible to connect to a network when it is enabled (see setNetworkEnabled() and isNetworkEnabled()).
 **
 **
@@ -174,6 +206,17 @@ public:
 	QString dataBitrateString(void);
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Time window for coalescing of error frames in milliseconds
+   ** \see        setErrorCoalescingTime()
+   **
+   ** This function returns the time window for coalescing of error frames, a value of 0 denotes
+   ** that coalescing is disabled.
+   */
+   uint32_t errorCoalescingTime(void)   { return (ulErrCoalesceTimeP);      };
+
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \return     Number of CAN frames
@@ -194,6 +237,17 @@ public:
 	uint32_t frameCountError(void)   { return (ulCntFrameErrP);          };
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of coalesced error frames
+   ** \see        setErrorCoalescingTime()
+   **
+   ** This function returns the number of error frames which have not been distributed because they
+   ** were repetitions of the previous error frame. These frames are included in frameCountError().
+   */
+   uint32_t frameCountErrorCoalesced(void)   { return (ulCntFrameErrCoalescedP); };
+
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \return     \c true if error frames are supported
@@ -265,6 +319,22 @@ public:
    bool isListenOnlyEnabled(void)   { return (btListenOnlyEnabledP);    };
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true if UDP multicast publisher is enabled
+   ** \see        setMulticastEnabled()
+   */
+   bool isMulticastEnabled(void)    { return (!pclMcastSockP.isNull()); };
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true if last value cache is enabled
+   ** \see        setValueCacheEnabled()
+   */
+   bool isValueCacheEnabled(void)   { return (btValueCacheEnabledP);    };
+
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \return     \c true if network is enabled
@@ -275,10 +345,55 @@ public:
    bool isNetworkEnabled(void)      { return (btNetworkEnabledP);       };
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Maximum number of local sockets
+   ** \see        setSocketMax()
+   **
+   ** This function returns the maximum number of local sockets which can be connected to the network.
+   */
+   uint32_t localSocketMax(void)    { return (ulLocalSockMaxP);         };
+
+
 	QString  name()                  { return(clNetNameP);               };
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclMuxV        Pointer to multiplexer
+   **
+   ** All frames of the network are passed to the multiplexer \a pclMuxV, which distributes them to
+   ** multiplexed connections. This function is called by QCanMultiplexer::addNetwork().
+   */
+   void setMultiplexer(QCanMultiplexer * pclMuxV)  { pclMuxP = pclMuxV;  };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclGatewayV    Pointer to gateway
+   **
+   ** All frames of the network are passed to the gateway \a pclGatewayV, which forwards them to other
+   ** networks. This function is called by QCanGateway::addNetwork().
+   */
+   void setGateway(QCanGateway * pclGatewayV)      { pclGatewayP = pclGatewayV;  };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Pointer to recorder
+   **
+   ** This function returns the recorder of the network, which is disabled by default (see
+   ** QCanRecorder::setEnabled()).
+   */
+   QCanRecorder * recorder(void)                   { return (pclRecorderP);  };
+
 	void reset(void);
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Pointer to scheduler
+   **
+   ** This function returns the transmit scheduler of the network.
+   */
+   QCanScheduler * scheduler(void)                 { return (pclSchedulerP); };
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \see     addInterface()
@@ -328,6 +443,24 @@ public:
    void setErrorFrameEnabled(bool btEnableV = true);
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ulTimeV        Time window in milliseconds
+   ** \see        errorCoalescingTime()
+   **
+   ** This function sets the time window for coalescing of error frames. An error frame which has
+   ** the same error type, error state and error counters as the previous error frame is not
+   ** distributed if it is received within the time window. When the time window expires, the last
+   ** of these frames is distributed once and QCanFrame::user() holds the number of repetitions. A
+   ** continuous error storm is thereby reported by one frame per time window. A different error
+   ** frame reports pending repetitions immediately and starts a new time window.
+   ** <p>
+   ** All error frames are counted by frameCountError(), the number of coalesced frames is returned
+   ** by frameCountErrorCoalesced(). A value of 0 disables coalescing, which is the default.
+   */
+   void setErrorCoalescingTime(uint32_t ulTimeV);
+
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \param[in]  btEnableV      Enable / disable CAN FD mode
@@ -372,6 +505,67 @@ public:
    */
    bool setServerAddress(QHostAddress clHostAddressV);
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  btEnableV      Enable / disable UDP multicast
+   ** \param[in]  clGroupV       Multicast group address
+   ** \return     \c true if the publisher has been opened
+   ** \see        isMulticastEnabled()
+   **
+   ** This function enables the UDP multicast publisher of the network if \a btEnableV is \c true, it
+   ** is disabled on \c false. All frames of the network are sent to the group \a clGroupV, the UDP
+   ** port is #QCAN_MCAST_PORT plus the network index. A datagram holds up to #QCAN_MCAST_FRAME_MAX
+   ** frames, it is sent when it is full or when the event loop is entered. The header of each datagram
+   ** carries a sequence number, so a listener can detect lost datagrams (refer to
+   ** QCanSocket::connectMulticast()).
+   */
+   bool setMulticastEnabled(bool btEnableV = true,
+                            QHostAddress clGroupV = QHostAddress(QString(QCAN_MCAST_ADDRESS)));
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ulLocalMaxV    Maximum number of local sockets
+   ** \param[in]  ulTcpMaxV      Maximum number of TCP sockets
+   ** \return     \c true if the values are accepted
+   ** \see        localSocketMax(), tcpSocketMax()
+   **
+   ** This method sets the maximum number of sockets which can be connected to the network, a value of
+   ** 0 is not accepted. A socket which connects while the maximum number is reached will be closed
+   ** by the network. Sockets which are already connected are not affected by a lower value.
+   */
+   bool setSocketMax(uint32_t ulLocalMaxV, uint32_t ulTcpMaxV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of sockets with a subscription
+   **
+   ** This function returns the number of connected sockets which have sent a subscription to the
+   ** network.
+   */
+   uint32_t subscriptionCount(void) { return ((uint32_t) clSubscriptionP.size()); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  btEnableV      Enable / disable last value cache
+   ** \see        isValueCacheEnabled()
+   **
+   ** This function enables the last value cache if \a btEnableV is \c true, it is disabled on
+   ** \c false. The cache is enabled by default. A disabled cache is only maintained while a socket
+   ** has a subscription.
+   */
+   void setValueCacheEnabled(bool btEnableV = true);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ulEntryMaxV    Maximum number of identifiers
+   ** \see        valueCacheSize()
+   **
+   ** This function sets the maximum number of identifiers which are stored in the last value cache,
+   ** the default value is defined by #QCAN_VALUE_ENTRY_MAX. Frames of further identifiers are not
+   ** stored. If the cache holds more identifiers than \a ulEntryMaxV, it is cleared.
+   */
+   void setValueCacheMax(uint32_t ulEntryMaxV);
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \return     \c true if CAN interface is started
@@ -404,6 +598,31 @@ public:
    */
    inline CAN_State_e state(void) { return (teCanStateP);   };
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Maximum number of TCP sockets
+   ** \see        setSocketMax()
+   **
+   ** This function returns the maximum number of TCP sockets which can be connected to the network.
+   */
+   uint32_t tcpSocketMax(void)      { return (ulTcpSockMaxP);           };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of identifiers in the last value cache
+   ** \see        setValueCacheEnabled()
+   */
+   uint32_t valueCacheCount(void)   { return ((uint32_t) clValueTableP.entryCount()); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Memory footprint of the last value cache in bytes
+   ** \see        setValueCacheMax()
+   **
+   ** The value is also stored in the shared memory of the server.
+   */
+   uint32_t valueCacheSize(void)    { return (clValueTableP.memorySize()); };
+
 signals:
 
    //---------------------------------------------------------------------------------------------------
@@ -516,12 +735,22 @@ private slots:
 
    void onTimerEvent(void);
 
+   void onMulticastWrite(void);
+
+   void onErrorCoalesceTimer(void);
+
+   void onRecorderTraceWritten(const QString & clFileNameR, const bool & btSuccessR);
+
 
 
 protected:
 
 private:
 
+   friend class QCanGateway;
+   friend class QCanMultiplexer;
+   friend class QCanScheduler;
+
    //----------------------------------------------------------------
    // returns number of bits inside a data frame for static
    // calculations
@@ -534,15 +763,37 @@ private:
    enum FrameSource_e {
       eFRAME_SOURCE_CAN_IF = 1,
       eFRAME_SOURCE_SOCKET_LOCAL,
-      eFRAME_SOURCE_SOCKET_TCP
+      eFRAME_SOURCE_SOCKET_TCP,
+      eFRAME_SOURCE_SOCKET_MUX,
+      eFRAME_SOURCE_GATEWAY,
+      eFRAME_SOURCE_SCHEDULER
    };
 
    inline CAN_Channel_e channel()      { return ((CAN_Channel_e) ubIdP) ;  };
 
+   bool  coalesceErrorFrame(enum FrameSource_e teFrameSrcV, const int32_t slSockSrcV,
+                            const QByteArray & clSockDataR);
+
    bool  handleCanFrame(enum FrameSource_e teFrameSrcV, const int32_t slSockSrcV, const QByteArray clSockDataV);
 
+   void  handleCyclic(QIODevice * pclSocketV, const QByteArray & clRecordR);
+
+   void  handleRecord(QIODevice * pclSocketV, const QByteArray & clRecordR);
+
+   void  handleSnapshot(QIODevice * pclSocketV);
+
+   void  handleSubscription(QObject * pclSocketV, const QByteArray & clRecordR);
+
+   void  clearValueTable(void);
+
+   bool  isSubscribed(QObject * pclSocketV, int32_t slEntryV, int64_t sqTimeV);
+
+   void  moveErrorSource(enum FrameSource_e teFrameSrcV, const int32_t slSockIdxV, const int32_t slSockLastV);
+
    void  setCanState(CAN_State_e teStateV);
 
+   void  writeErrorRepeat(void);
+
    //----------------------------------------------------------------
    // unique network ID, ubNetIdP is used to manage a unique id
    // for all networks, ubIdP holds the id of the current instance
@@ -567,6 +818,13 @@ private:
    QPointer<QLocalServer>  pclLocalSrvP;
    QVector<QLocalSocket*>* pclLocalSockListP;
 
+   //----------------------------------------------------------------
+   // position of a local socket inside pclLocalSockListP, a socket
+   // is removed by moving the last socket to its position
+   //
+   QHash<QObject *, int32_t>  clLocalSockIndexP;
+   uint32_t                ulLocalSockMaxP;
+
    QMutex                  clLocalSockMutexP;
 
    //----------------------------------------------------------------
@@ -578,10 +836,70 @@ private:
    QHostAddress            clTcpHostAddrP;
    uint16_t                uwTcpPortP;
 
+   //----------------------------------------------------------------
+   // position of a TCP socket inside pclTcpSockListP
+   //
+   QHash<QObject *, int32_t>  clTcpSockIndexP;
+   uint32_t                ulTcpSockMaxP;
+
    QMutex                  clTcpSockMutexP;
 
    QTimer                  clRefreshTimerP;
 
+   //----------------------------------------------------------------
+   // multiplexer for connections to several networks
+   //
+   QPointer<QCanMultiplexer> pclMuxP;
+
+   //----------------------------------------------------------------
+   // gateway which forwards frames to other networks
+   //
+   QPointer<QCanGateway>   pclGatewayP;
+
+   //----------------------------------------------------------------
+   // recorder for frames before and after a trigger
+   //
+   QCanRecorder *          pclRecorderP;
+
+   //----------------------------------------------------------------
+   // scheduler for cyclic frames
+   //
+   QCanScheduler *         pclSchedulerP;
+
+   //----------------------------------------------------------------
+   // UDP multicast publisher: frames are collected in the
+   // datagram clMcastDataP
+   //
+   QPointer<QUdpSocket>    pclMcastSockP;
+   QHostAddress            clMcastGroupP;
+   QByteArray              clMcastDataP;
+   uint32_t                ulMcastSequenceP;
+   uint8_t                 ubMcastFrameCntP;
+   bool                    btMcastWritePendingP;
+
+   //----------------------------------------------------------------
+   // subscription of a socket: the state of each entry of the last
+   // value table holds the time (micro-seconds) and change counter
+   // of the last frame which has been sent to the socket
+   //
+   struct SubscriptionState_s {
+      int64_t     sqSendTime;
+      uint32_t    ulChangeCount;
+      bool        btValid;
+   };
+
+   struct Subscription_s {
+      bool        btChangeOnly;
+      int64_t     sqInterval;
+      int64_t     sqKeepAlive;
+      QVector<SubscriptionState_s> clState;
+   };
+
+   QHash<QObject *, Subscription_s>  clSubscriptionP;
+   QCanValueTable          clValueTableP;
+   QElapsedTimer           clSubscriptionTimeP;
+   bool                    btValueCacheEnabledP;
+
    //----------------------------------------------------------------
    // bit-rate settings: the variables hold the bit-rate in
    // bit/s, if no bit-rate is configured the value is
@@ -603,6 +921,22 @@ private:
    //
    uint32_t                ulCntFrameCanP;
    uint32_t                ulCntFrameErrP;
+   uint32_t                ulCntFrameErrCoalescedP;
+
+   //----------------------------------------------------------------
+   // coalescing of error frames: clErrFrameP holds the last error
+   // frame, ulErrRepeatP the number of repetitions which have not
+   // been distributed yet, the time window is running while the
+   // timer is active; slErrSockSrcP is the index of the source socket
+   // and follows the socket lists, see moveErrorSource()
+   //
+   uint32_t                ulErrCoalesceTimeP;
+   QTimer                  clErrCoalesceTimerP;
+   QCanFrame               clErrFrameP;
+   enum FrameSource_e      teErrFrameSrcP;
+   int32_t                 slErrSockSrcP;
+   uint32_t                ulErrRepeatP;
+   bool                    btErrRepeatWriteP;
 
    //----------------------------------------------------------------
    // statistic bit counter
@@ -0,0 +1,539 @@
+//====================================================================================================================//
+// File:          qcan_recorder.cpp                                                                                   //
+// Description:   QCAN classes - pre/post-trigger recorder                                                            //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QRunnable>
+
+#include "qcan_recorder.hpp"
+#include "qcan_trace.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#define  RECORDER_PRE_TIME_DEFAULT     5000
+#define  RECORDER_POST_TIME_DEFAULT    5000
+
+//-------------------------------------------------------------------
+// position of the control field and the data inside a frame (see
+// QCanFrame::toByteArray())
+//
+#define  RECORDER_FRM_CTRL_POS         5
+#define  RECORDER_FRM_DATA_POS         6
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class QCanRecorderJob                                                                                              **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// The job writes the frames of a capture to a trace file, it is
+// executed by the thread pool of the recorder.
+//
+class QCanRecorderJob : public QRunnable
+{
+public:
+   QCanRecorderJob(QCanRecorder * pclRecorderV, const QString & clFileNameR, const QByteArray & clFrameDataR)
+   {
+      pclRecorderP  = pclRecorderV;
+      clFileNameP   = clFileNameR;
+      clFrameDataP  = clFrameDataR;
+   }
+
+   void run(void) Q_DECL_OVERRIDE
+   {
+      QCanTraceWriter   clWriterT;
+      QCanFrame         clFrameT;
+      bool              btSuccessT;
+      int32_t           slPosT;
+
+      btSuccessT = clWriterT.open(clFileNameP);
+      for (slPosT = 0; btSuccessT && (slPosT < clFrameDataP.size()); slPosT += QCAN_FRAME_ARRAY_SIZE)
+      {
+         if (clFrameT.fromByteArray(QByteArray::fromRawData(clFrameDataP.constData() + slPosT,
+                                                            QCAN_FRAME_ARRAY_SIZE)))
+         {
+            btSuccessT = clWriterT.write(clFrameT);
+         }
+      }
+      btSuccessT = clWriterT.close() && btSuccessT;
+
+      QMetaObject::invokeMethod(pclRecorderP, "onTraceWritten", Qt::QueuedConnection,
+                                Q_ARG(QString, clFileNameP), Q_ARG(bool, btSuccessT));
+   }
+
+private:
+   QCanRecorder * pclRecorderP;
+   QString        clFileNameP;
+   QByteArray     clFrameDataP;
+};
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class methods                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder()                                                                                                     //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanRecorder::QCanRecorder(QObject * pclParentV)
+{
+   this->setParent(pclParentV);
+
+   clTriggerListP.reserve(QCAN_RECORDER_TRIGGER_MAX);
+
+   ulMemorySizeP  = QCAN_RECORDER_MEMORY_SIZE;
+   ulRingSizeP    = 0;
+   ulRingHeadP    = 0;
+   ulRingCountP   = 0;
+
+   btEnabledP     = false;
+   btTriggeredP   = false;
+   sqTriggerTimeP = 0;
+   sqPreTimeP     = RECORDER_PRE_TIME_DEFAULT  * 1000;
+   sqPostTimeP    = RECORDER_POST_TIME_DEFAULT * 1000;
+
+   clTracePrefixP = QDir::tempPath() + "/can";
+
+   clTimeP.start();
+   clThreadPoolP.setMaxThreadCount(1);
+
+   clPostTimerP.setSingleShot(true);
+   connect(&clPostTimerP, SIGNAL(timeout()), this, SLOT(onPostTriggerTimeout()));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// ~QCanRecorder()                                                                                                    //
+// destructor                                                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanRecorder::~QCanRecorder()
+{
+   clPostTimerP.stop();
+   clThreadPoolP.waitForDone();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::addTrigger()                                                                                         //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+int32_t QCanRecorder::addTrigger(const RecorderTrigger_ts & tsTriggerR)
+{
+   if (clTriggerListP.size() >= QCAN_RECORDER_TRIGGER_MAX)
+   {
+      return (-1);
+   }
+
+   if (tsTriggerR.teType == eRECORDER_TRIGGER_PAYLOAD)
+   {
+      if ((tsTriggerR.ubPatternSize == 0) || (tsTriggerR.ubPatternSize > 8) ||
+          ((tsTriggerR.ubPatternPos + tsTriggerR.ubPatternSize) > QCAN_MSG_DATA_MAX))
+      {
+         return (-1);
+      }
+   }
+
+   clTriggerListP.append(tsTriggerR);
+
+   return (clTriggerListP.size() - 1);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::appendFrame()                                                                                        //
+// store frame in ring and evaluate triggers                                                                          //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::appendFrame(const QByteArray & clSockDataR)
+{
+   int64_t  sqTimeT;
+   uint32_t ulOldestT;
+   int32_t  slTriggerIdxT;
+
+   if ((btEnabledP == false) || (ulRingSizeP == 0) || (clSockDataR.size() < QCAN_FRAME_ARRAY_SIZE))
+   {
+      return;
+   }
+
+   sqTimeT = clTimeP.nsecsElapsed() / 1000;
+
+   //---------------------------------------------------------------------------------------------------
+   // a capture ends with the post-trigger time or when the ring is full and the next frame would
+   // overwrite a frame of the capture
+   //
+   if (btTriggeredP)
+   {
+      ulOldestT = (ulRingHeadP + ulRingSizeP - ulRingCountP) % ulRingSizeP;
+      if ((sqTimeT > sqTriggerTimeP + sqPostTimeP) ||
+          ((ulRingCountP == ulRingSizeP) && (clRingTimeP.at(ulOldestT) >= sqTriggerTimeP - sqPreTimeP)))
+      {
+         finishCapture();
+      }
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // store frame
+   //
+   memcpy(clRingP.data() + (ulRingHeadP * QCAN_FRAME_ARRAY_SIZE), clSockDataR.constData(),
+          QCAN_FRAME_ARRAY_SIZE);
+   clRingTimeP[ulRingHeadP] = sqTimeT;
+   ulRingHeadP++;
+   if (ulRingHeadP == ulRingSizeP)
+   {
+      ulRingHeadP = 0;
+   }
+   if (ulRingCountP < ulRingSizeP)
+   {
+      ulRingCountP++;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // evaluate triggers
+   //
+   if (btTriggeredP == false)
+   {
+      for (slTriggerIdxT = 0; slTriggerIdxT < clTriggerListP.size(); slTriggerIdxT++)
+      {
+         if (matchTrigger(clTriggerListP.at(slTriggerIdxT), clSockDataR))
+         {
+            startCapture(slTriggerIdxT, sqTimeT);
+            break;
+         }
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::changeState()                                                                                        //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::changeState(CAN_State_e teStateV)
+{
+   int32_t  slTriggerIdxT;
+
+   if ((btEnabledP == false) || btTriggeredP || (teStateV != eCAN_STATE_BUS_OFF))
+   {
+      return;
+   }
+
+   for (slTriggerIdxT = 0; slTriggerIdxT < clTriggerListP.size(); slTriggerIdxT++)
+   {
+      if (clTriggerListP.at(slTriggerIdxT).teType == eRECORDER_TRIGGER_BUS_OFF)
+      {
+         startCapture(slTriggerIdxT, clTimeP.nsecsElapsed() / 1000);
+         break;
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::clearTriggers()                                                                                      //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::clearTriggers(void)
+{
+   clTriggerListP.clear();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::finishCapture()                                                                                      //
+// copy frames of capture and write them to a trace file                                                              //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::finishCapture(void)
+{
+   QByteArray  clFrameDataT;
+   int64_t     sqStartTimeT;
+   uint32_t    ulPosT;
+   uint32_t    ulCountT;
+
+   clPostTimerP.stop();
+   btTriggeredP = false;
+   if (ulRingSizeP == 0)
+   {
+      return;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // copy all frames starting with the pre-trigger time, the frames of the ring are ordered by
+   // time
+   //
+   sqStartTimeT = sqTriggerTimeP - sqPreTimeP;
+   ulPosT       = (ulRingHeadP + ulRingSizeP - ulRingCountP) % ulRingSizeP;
+   ulCountT     = ulRingCountP;
+   while ((ulCountT > 0) && (clRingTimeP.at(ulPosT) < sqStartTimeT))
+   {
+      ulPosT = (ulPosT + 1) % ulRingSizeP;
+      ulCountT--;
+   }
+
+   clFrameDataT.reserve(ulCountT * QCAN_FRAME_ARRAY_SIZE);
+   if (ulPosT + ulCountT > ulRingSizeP)
+   {
+      clFrameDataT.append(clRingP.constData() + (ulPosT * QCAN_FRAME_ARRAY_SIZE),
+                          (ulRingSizeP - ulPosT) * QCAN_FRAME_ARRAY_SIZE);
+      ulCountT = ulCountT - (ulRingSizeP - ulPosT);
+      ulPosT   = 0;
+   }
+   clFrameDataT.append(clRingP.constData() + (ulPosT * QCAN_FRAME_ARRAY_SIZE), ulCountT * QCAN_FRAME_ARRAY_SIZE);
+
+   clThreadPoolP.start(new QCanRecorderJob(this, clTraceFileP, clFrameDataT));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::matchTrigger()                                                                                       //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanRecorder::matchTrigger(const RecorderTrigger_ts & tsTriggerR, const QByteArray & clSockDataR)
+{
+   const uint8_t *   pubDataT = (const uint8_t *) clSockDataR.constData();
+   uint32_t          ulIdT;
+   bool              btExtT;
+   uint8_t           ubPosT;
+
+   //---------------------------------------------------------------------------------------------------
+   // error frame
+   //
+   if ((pubDataT[0] & 0x20) > 0)
+   {
+      if (tsTriggerR.teType != eRECORDER_TRIGGER_ERROR_FRAME)
+      {
+         return (false);
+      }
+
+      if (tsTriggerR.teErrorType == QCanFrame::eERROR_TYPE_NONE)
+      {
+         return (true);
+      }
+
+      return (clFrameP.fromByteArray(clSockDataR) && (clFrameP.errorType() == tsTriggerR.teErrorType));
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // data frame: compare identifier
+   //
+   if ((tsTriggerR.teType != eRECORDER_TRIGGER_IDENTIFIER) && (tsTriggerR.teType != eRECORDER_TRIGGER_PAYLOAD))
+   {
+      return (false);
+   }
+
+   ulIdT  = ((uint32_t) (pubDataT[0] & 0x1F)) << 24;
+   ulIdT |= ((uint32_t) pubDataT[1]) << 16;
+   ulIdT |= ((uint32_t) pubDataT[2]) << 8;
+   ulIdT |= ((uint32_t) pubDataT[3]);
+   btExtT = (pubDataT[RECORDER_FRM_CTRL_POS] & 0x01) > 0;
+
+   if ((btExtT != tsTriggerR.btExtended) ||
+       ((ulIdT & tsTriggerR.ulIdMask) != (tsTriggerR.ulIdMatch & tsTriggerR.ulIdMask)))
+   {
+      return (false);
+   }
+
+   if (tsTriggerR.teType == eRECORDER_TRIGGER_IDENTIFIER)
+   {
+      return (true);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // compare payload
+   //
+   if ((clFrameP.fromByteArray(clSockDataR) == false) || clFrameP.isRemote() ||
+       (clFrameP.dataSize() < tsTriggerR.ubPatternPos + tsTriggerR.ubPatternSize))
+   {
+      return (false);
+   }
+
+   pubDataT = pubDataT + RECORDER_FRM_DATA_POS + tsTriggerR.ubPatternPos;
+   for (ubPosT = 0; ubPosT < tsTriggerR.ubPatternSize; ubPosT++)
+   {
+      if (((pubDataT[ubPosT] ^ tsTriggerR.aubPattern[ubPosT]) & tsTriggerR.aubPatternMask[ubPosT]) != 0)
+      {
+         return (false);
+      }
+   }
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::onPostTriggerTimeout()                                                                               //
+// end of capture without further frames                                                                              //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::onPostTriggerTimeout(void)
+{
+   if (btTriggeredP)
+   {
+      finishCapture();
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::onTraceWritten()                                                                                     //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::onTraceWritten(QString clFileNameV, bool btSuccessV)
+{
+   emit traceWritten(clFileNameV, btSuccessV);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::setEnabled()                                                                                         //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::setEnabled(bool btEnableV)
+{
+   if (btEnableV == btEnabledP)
+   {
+      return;
+   }
+
+   btEnabledP = btEnableV;
+   if (btEnabledP)
+   {
+      setMemorySize(ulMemorySizeP);
+   }
+   else
+   {
+      //-------------------------------------------------------------------------------------------
+      // a running capture is written, the memory of the ring is released
+      //
+      if (btTriggeredP)
+      {
+         finishCapture();
+      }
+      clRingP.clear();
+      clRingTimeP.clear();
+      clRingTimeP.squeeze();
+      ulRingSizeP  = 0;
+      ulRingHeadP  = 0;
+      ulRingCountP = 0;
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::setMemorySize()                                                                                      //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::setMemorySize(uint32_t ulSizeV)
+{
+   ulMemorySizeP = ulSizeV;
+
+   if (btTriggeredP)
+   {
+      clPostTimerP.stop();
+      btTriggeredP = false;
+   }
+
+   ulRingHeadP  = 0;
+   ulRingCountP = 0;
+   if (btEnabledP)
+   {
+      ulRingSizeP = ulMemorySizeP / QCAN_FRAME_ARRAY_SIZE;
+      clRingP.resize(ulRingSizeP * QCAN_FRAME_ARRAY_SIZE);
+      clRingP.squeeze();
+      clRingTimeP.resize(ulRingSizeP);
+      clRingTimeP.squeeze();
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::setTraceFilePrefix()                                                                                 //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::setTraceFilePrefix(const QString & clPrefixR)
+{
+   clTracePrefixP = clPrefixR;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::setTriggerTime()                                                                                     //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::setTriggerTime(uint32_t ulPreTimeV, uint32_t ulPostTimeV)
+{
+   sqPreTimeP  = ((int64_t) ulPreTimeV)  * 1000;
+   sqPostTimeP = ((int64_t) ulPostTimeV) * 1000;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::startCapture()                                                                                       //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::startCapture(int32_t slTriggerIdxV, int64_t sqTimeV)
+{
+   btTriggeredP   = true;
+   sqTriggerTimeP = sqTimeV;
+   clTraceFileP   = clTracePrefixP + QDateTime::currentDateTime().toString("_yyyyMMdd_hhmmss_zzz") + ".qct";
+
+   //---------------------------------------------------------------------------------------------------
+   // the timer ends the capture if no frame is received after the post-trigger time
+   //
+   clPostTimerP.start((int) (sqPostTimeP / 1000) + 1);
+
+   emit triggered(slTriggerIdxV);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanRecorder::trigger()                                                                                            //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanRecorder::trigger(void)
+{
+   if (btEnabledP && (btTriggeredP == false))
+   {
+      startCapture(-1, clTimeP.nsecsElapsed() / 1000);
+   }
+}
+
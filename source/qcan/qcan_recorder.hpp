@@ -0,0 +1,333 @@
+//====================================================================================================================//
+// File:          qcan_recorder.hpp                                                                                   //
+// Description:   QCAN classes - pre/post-trigger recorder                                                            //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+#ifndef QCAN_RECORDER_HPP_
+#define QCAN_RECORDER_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include "qcan_defs.hpp"
+#include "qcan_frame.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_RECORDER_MEMORY_SIZE
+** \ingroup QCAN_NW
+** \brief   Default memory size of recorder
+**
+** This symbol defines the default memory size in bytes of the ring
+** of a QCanRecorder. The value can be changed during run-time by
+** QCanRecorder::setMemorySize().
+*/
+#define  QCAN_RECORDER_MEMORY_SIZE  (4 * 1024 * 1024)
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_RECORDER_TRIGGER_MAX
+** \ingroup QCAN_NW
+** \brief   Maximum number of recorder triggers
+**
+** This symbol defines the maximum number of triggers of a
+** QCanRecorder.
+*/
+#define  QCAN_RECORDER_TRIGGER_MAX  16
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Structures                                                                                                         **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-----------------------------------------------------------------------------------------------------
+// Type of recorder trigger
+//
+enum RecorderTrigger_e {
+   eRECORDER_TRIGGER_IDENTIFIER = 0,
+   eRECORDER_TRIGGER_PAYLOAD,
+   eRECORDER_TRIGGER_ERROR_FRAME,
+   eRECORDER_TRIGGER_BUS_OFF
+};
+
+
+//-----------------------------------------------------------------------------------------------------
+// Recorder trigger
+//
+typedef struct RecorderTrigger_s {
+
+   RecorderTrigger_e       teType;
+
+   //--------------------------------------------------------------------------
+   // Identifier and payload trigger: a frame matches if (identifier & ulIdMask)
+   // == (ulIdMatch & ulIdMask), btExtended selects standard or extended frames
+   //
+   uint32_t                ulIdMatch;
+   uint32_t                ulIdMask;
+   bool                    btExtended;
+
+   //--------------------------------------------------------------------------
+   // Payload trigger: the data bytes starting at ubPatternPos must match
+   // aubPattern for all bits set in aubPatternMask, ubPatternSize defines
+   // the number of bytes (1 .. 8)
+   //
+   uint8_t                 aubPattern[8];
+   uint8_t                 aubPatternMask[8];
+   uint8_t                 ubPatternPos;
+   uint8_t                 ubPatternSize;
+
+   //--------------------------------------------------------------------------
+   // Error frame trigger: error type of the frame, the value
+   // QCanFrame::eERROR_TYPE_NONE matches every error frame
+   //
+   QCanFrame::ErrorType_e  teErrorType;
+
+} RecorderTrigger_ts;
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanRecorder
+** \brief Pre/post-trigger recorder of a CAN network
+**
+** The recorder keeps the last frames of a QCanNetwork in a ring with a fixed memory size (see setMemorySize()).
+** A trigger (see addTrigger()) fires on a frame with a certain identifier or payload, on an error frame or
+** when the network enters the bus-off state. After the post-trigger time the frames from the pre-trigger
+** time until the post-trigger time are written to a trace file (see QCanTraceWriter), the ring keeps on
+** recording. The capture ends early if the ring is full before the post-trigger time has elapsed.
+** <p>
+** The frames are copied from the ring in the thread of the network, the trace file is written by a
+** separate thread, so writing the file does not delay the routing of frames. The signal traceWritten() is
+** emitted when the file has been written.
+*/
+class QCanRecorder : public QObject
+{
+   Q_OBJECT
+public:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclParentV     Pointer to QObject parent class
+   **
+   ** Create a new recorder, the recorder is disabled.
+   */
+   QCanRecorder(QObject * pclParentV = Q_NULLPTR);
+
+   ~QCanRecorder();
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  tsTriggerR     Recorder trigger
+   ** \return     Index of trigger or -1 on failure
+   **
+   ** Add a trigger to the recorder. The function fails if #QCAN_RECORDER_TRIGGER_MAX triggers are
+   ** defined or if the pattern size of a payload trigger is not valid.
+   */
+   int32_t  addTrigger(const RecorderTrigger_ts & tsTriggerR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clSockDataR    CAN frame as byte array
+   **
+   ** This function is called by a QCanNetwork for every frame while the recorder is enabled.
+   */
+   void  appendFrame(const QByteArray & clSockDataR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  teStateV       CAN state
+   **
+   ** This function is called by a QCanNetwork on a change of the CAN state.
+   */
+   void  changeState(CAN_State_e teStateV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** Remove all triggers of the recorder.
+   */
+   void  clearTriggers(void);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of frames in the ring
+   */
+   inline uint32_t frameCount(void) const                { return (ulRingCountP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true if the recorder is enabled
+   */
+   inline bool  isEnabled(void) const                    { return (btEnabledP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true while frames are recorded after a trigger
+   */
+   inline bool  isTriggered(void) const                  { return (btTriggeredP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Memory size of the ring in bytes
+   */
+   inline uint32_t memorySize(void) const                { return (ulMemorySizeP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  btEnableV      Enable recorder
+   **
+   ** The function enables or disables the recorder. The memory of the ring is allocated while the
+   ** recorder is enabled.
+   */
+   void  setEnabled(bool btEnableV = true);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ulSizeV        Memory size in bytes
+   **
+   ** The function sets the memory size of the ring, the ring holds ulSizeV / #QCAN_FRAME_ARRAY_SIZE
+   ** frames. All recorded frames are removed.
+   */
+   void  setMemorySize(uint32_t ulSizeV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clPrefixR      Path and prefix of trace files
+   **
+   ** The name of a trace file is built from the prefix \a clPrefixR and the time of the trigger,
+   ** e.g. "/tmp/can1_20170512_143012_042.qct".
+   */
+   void  setTraceFilePrefix(const QString & clPrefixR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ulPreTimeV     Pre-trigger time in milliseconds
+   ** \param[in]  ulPostTimeV    Post-trigger time in milliseconds
+   **
+   ** The function sets the time before and after a trigger which is written to the trace file.
+   */
+   void  setTriggerTime(uint32_t ulPreTimeV, uint32_t ulPostTimeV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** Trigger the recorder manually.
+   */
+   void  trigger(void);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of triggers
+   */
+   int32_t  triggerCount(void) const                     { return (clTriggerListP.size()); };
+
+signals:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slTriggerIdxR  Index of trigger, -1 for a manual trigger
+   **
+   ** This signal is emitted when a trigger fires.
+   */
+   void  triggered(const int32_t & slTriggerIdxR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFileNameR    Name of trace file
+   ** \param[in]  btSuccessR     \c true if the file has been written
+   **
+   ** This signal is emitted when a trace file has been written.
+   */
+   void  traceWritten(const QString & clFileNameR, const bool & btSuccessR);
+
+private slots:
+
+   void  onPostTriggerTimeout(void);
+
+   void  onTraceWritten(QString clFileNameV, bool btSuccessV);
+
+private:
+
+   void  finishCapture(void);
+
+   bool  matchTrigger(const RecorderTrigger_ts & tsTriggerR, const QByteArray & clSockDataR);
+
+   void  startCapture(int32_t slTriggerIdxV, int64_t sqTimeV);
+
+   QVector<RecorderTrigger_ts>   clTriggerListP;
+
+   //----------------------------------------------------------------
+   // ring of frames and the time (micro-seconds) of their reception,
+   // ulRingHeadP is the position of the next frame
+   //
+   QByteArray                    clRingP;
+   QVector<int64_t>              clRingTimeP;
+   uint32_t                      ulRingSizeP;
+   uint32_t                      ulRingHeadP;
+   uint32_t                      ulRingCountP;
+   uint32_t                      ulMemorySizeP;
+
+   //----------------------------------------------------------------
+   // capture after a trigger, times in micro-seconds
+   //
+   bool                          btEnabledP;
+   bool                          btTriggeredP;
+   int64_t                       sqTriggerTimeP;
+   int64_t                       sqPreTimeP;
+   int64_t                       sqPostTimeP;
+   QString                       clTraceFileP;
+   QString                       clTracePrefixP;
+
+   QCanFrame                     clFrameP;
+   QElapsedTimer                 clTimeP;
+   QTimer                        clPostTimerP;
+
+   //----------------------------------------------------------------
+   // trace files are written by a single thread in order of their
+   // trigger
+   //
+   QThreadPool                   clThreadPoolP;
+};
+
+#endif   // QCAN_RECORDER_HPP_
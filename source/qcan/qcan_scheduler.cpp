@@ -0,0 +1,550 @@
+//====================================================================================================================//
+// File:          qcan_scheduler.cpp                                                                                  //
+// Description:   QCAN classes - Cyclic transmit scheduler                                                            //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#include "qcan_network.hpp"
+#include "qcan_scheduler.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// timer wheel: level 0 has 256 slots of one tick, level 1 and 2
+// have 64 slots of 256 and 16384 ticks
+//
+#define  WHEEL_LEVEL1_OFFSET     256
+#define  WHEEL_LEVEL2_OFFSET     320
+#define  WHEEL_LEVEL0_TICKS      ((int64_t) 256)
+#define  WHEEL_LEVEL1_TICKS      ((int64_t) 16384)
+#define  WHEEL_LEVEL2_TICKS      ((int64_t) 1048576)
+
+#define  SCHEDULER_TICK_NS       ((int64_t) QCAN_SCHEDULER_TICK * 1000)
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class methods                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler()                                                                                                    //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanScheduler::QCanScheduler(QCanNetwork * pclNetworkV)
+{
+   this->setParent(pclNetworkV);
+   pclNetworkP = pclNetworkV;
+
+   clMessageListP.reserve(QCAN_SCHEDULER_MESSAGE_MAX);
+   clMessageIndexP.reserve(QCAN_SCHEDULER_MESSAGE_MAX);
+
+   for (int32_t slSlotT = 0; slSlotT < 384; slSlotT++)
+   {
+      aslSlotP[slSlotT] = -1;
+   }
+
+   clClockP.start();
+   sqTickP = 0;
+
+   //---------------------------------------------------------------------------------------------------
+   // the timer is only running while there are cyclic frames
+   //
+   clTickTimerP.setTimerType(Qt::PreciseTimer);
+   clTickTimerP.setInterval(QCAN_SCHEDULER_TICK / 1000);
+   connect(&clTickTimerP, SIGNAL(timeout()), this, SLOT(onTimerEvent()));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// ~QCanScheduler()                                                                                                   //
+// destructor                                                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanScheduler::~QCanScheduler()
+{
+   clTickTimerP.stop();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::advance()                                                                                           //
+// process all ticks up to sqTickV                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanScheduler::advance(int64_t sqTickV)
+{
+   int32_t  slIdxT;
+   int32_t  slNextT;
+   int64_t  sqTickT;
+
+   while (sqTickP < sqTickV)
+   {
+      sqTickT = sqTickP + 1;
+
+      //-------------------------------------------------------------------------------------------
+      // move the frames of the next level to level 0 when it wraps around, the frames are linked
+      // again relative to the current tick
+      //
+      if ((sqTickT & (WHEEL_LEVEL0_TICKS - 1)) == 0)
+      {
+         for (int32_t slLevelT = 0; slLevelT < 2; slLevelT++)
+         {
+            int32_t slSlotT;
+
+            if (slLevelT == 0)
+            {
+               slSlotT = WHEEL_LEVEL1_OFFSET + ((sqTickT >> 8) & 63);
+            }
+            else
+            {
+               slSlotT = WHEEL_LEVEL2_OFFSET + ((sqTickT >> 14) & 63);
+            }
+
+            slIdxT = aslSlotP[slSlotT];
+            aslSlotP[slSlotT] = -1;
+            while (slIdxT >= 0)
+            {
+               slNextT = clMessageListP.at(slIdxT).slNext;
+               link(slIdxT);
+               slIdxT = slNextT;
+            }
+
+            if (((sqTickT >> 8) & 63) != 0)
+            {
+               break;
+            }
+         }
+      }
+
+      //-------------------------------------------------------------------------------------------
+      // transmit all frames of the slot, they are linked again for their next transmission
+      //
+      sqTickP = sqTickT;
+      slIdxT  = aslSlotP[sqTickT & (WHEEL_LEVEL0_TICKS - 1)];
+      aslSlotP[sqTickT & (WHEEL_LEVEL0_TICKS - 1)] = -1;
+      while (slIdxT >= 0)
+      {
+         slNextT = clMessageListP.at(slIdxT).slNext;
+         transmit(slIdxT, clClockP.nsecsElapsed());
+         link(slIdxT);
+         slIdxT = slNextT;
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::appendPattern()                                                                                     //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanScheduler::appendPattern(QObject * pclOwnerV, uint16_t uwHandleV, const QCanFrame & clFrameR)
+{
+   int32_t     slIdxT;
+   QByteArray  clPayloadT;
+
+   slIdxT = clMessageIndexP.value(MessageKey_t(pclOwnerV, uwHandleV), -1);
+   if ((slIdxT < 0) || (clMessageListP.at(slIdxT).clPattern.size() >= QCAN_SCHEDULER_PATTERN_MAX))
+   {
+      return (false);
+   }
+
+   for (uint8_t ubPosT = 0; ubPosT < clMessageListP.at(slIdxT).clFrame.dataSize(); ubPosT++)
+   {
+      clPayloadT.append((char) clFrameR.data(ubPosT));
+   }
+   clMessageListP[slIdxT].clPattern.append(clPayloadT);
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::cancel()                                                                                            //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanScheduler::cancel(QObject * pclOwnerV, uint16_t uwHandleV)
+{
+   int32_t  slIdxT;
+
+   slIdxT = clMessageIndexP.value(MessageKey_t(pclOwnerV, uwHandleV), -1);
+   if (slIdxT < 0)
+   {
+      return (false);
+   }
+
+   clMessageIndexP.remove(MessageKey_t(pclOwnerV, uwHandleV));
+   unlink(slIdxT);
+   clMessageListP[slIdxT].pclOwner = Q_NULLPTR;
+   clMessageListP[slIdxT].clPattern.clear();
+   clFreeListP.append(slIdxT);
+
+   if (clMessageIndexP.isEmpty())
+   {
+      clTickTimerP.stop();
+   }
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::cancelAll()                                                                                         //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanScheduler::cancelAll(QObject * pclOwnerV)
+{
+   foreach (uint16_t uwHandleT, handles(pclOwnerV))
+   {
+      cancel(pclOwnerV, uwHandleT);
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::handles()                                                                                           //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+QVector<uint16_t> QCanScheduler::handles(QObject * pclOwnerV) const
+{
+   QVector<uint16_t>                               clHandleListT;
+   QHash<MessageKey_t, int32_t>::const_iterator    clIterT;
+
+   for (clIterT = clMessageIndexP.constBegin(); clIterT != clMessageIndexP.constEnd(); ++clIterT)
+   {
+      if (clIterT.key().first == pclOwnerV)
+      {
+         clHandleListT.append(clIterT.key().second);
+      }
+   }
+
+   return (clHandleListT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::link()                                                                                              //
+// insert frame into the timer wheel                                                                                  //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanScheduler::link(int32_t slIdxV)
+{
+   Message_s * ptsMsgT = &clMessageListP[slIdxV];
+   int64_t     sqDueTickT;
+   int64_t     sqDeltaT;
+   int32_t     slSlotT;
+
+   //---------------------------------------------------------------------------------------------------
+   // a frame which is already due is transmitted with the next tick
+   //
+   sqDueTickT = ptsMsgT->sqDueTime / SCHEDULER_TICK_NS;
+   if (sqDueTickT <= sqTickP)
+   {
+      sqDueTickT = sqTickP + 1;
+   }
+
+   sqDeltaT = sqDueTickT - (sqTickP + 1);
+   if (sqDeltaT >= WHEEL_LEVEL2_TICKS)
+   {
+      sqDueTickT = sqTickP + WHEEL_LEVEL2_TICKS;
+      sqDeltaT   = WHEEL_LEVEL2_TICKS - 1;
+   }
+
+   if (sqDeltaT < WHEEL_LEVEL0_TICKS)
+   {
+      slSlotT = (int32_t) (sqDueTickT & (WHEEL_LEVEL0_TICKS - 1));
+   }
+   else if (sqDeltaT < WHEEL_LEVEL1_TICKS)
+   {
+      slSlotT = WHEEL_LEVEL1_OFFSET + (int32_t) ((sqDueTickT >> 8) & 63);
+   }
+   else
+   {
+      slSlotT = WHEEL_LEVEL2_OFFSET + (int32_t) ((sqDueTickT >> 14) & 63);
+   }
+
+   ptsMsgT->slSlot = slSlotT;
+   ptsMsgT->slPrev = -1;
+   ptsMsgT->slNext = aslSlotP[slSlotT];
+   if (ptsMsgT->slNext >= 0)
+   {
+      clMessageListP[ptsMsgT->slNext].slPrev = slIdxV;
+   }
+   aslSlotP[slSlotT] = slIdxV;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::onTimerEvent()                                                                                      //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanScheduler::onTimerEvent(void)
+{
+   advance(clClockP.nsecsElapsed() / SCHEDULER_TICK_NS);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::setFrame()                                                                                          //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanScheduler::setFrame(QObject * pclOwnerV, uint16_t uwHandleV, const QCanFrame & clFrameR,
+                             uint32_t ulPeriodV, uint8_t ubCounterPosV, uint8_t ubCounterSizeV)
+{
+   Message_s * ptsMsgT;
+   QByteArray  clPayloadT;
+   int32_t     slIdxT;
+   int64_t     sqTimeT;
+   int64_t     sqPeriodT;
+
+   //---------------------------------------------------------------------------------------------------
+   // check parameters
+   //
+   if ((ulPeriodV < QCAN_SCHEDULER_TICK) || (ulPeriodV > QCAN_SCHEDULER_PERIOD_MAX) ||
+       (clFrameR.frameType() != QCanFrame::eFRAME_TYPE_DATA) || (ubCounterSizeV > 4))
+   {
+      return (false);
+   }
+
+   if ((ubCounterSizeV > 0) && (ubCounterPosV + ubCounterSizeV > clFrameR.dataSize()))
+   {
+      return (false);
+   }
+
+   sqTimeT   = clClockP.nsecsElapsed();
+   sqPeriodT = ((int64_t) ulPeriodV) * 1000;
+
+   //---------------------------------------------------------------------------------------------------
+   // the timer wheel starts with the current tick when the first frame is added
+   //
+   if (clMessageIndexP.isEmpty())
+   {
+      sqTickP = sqTimeT / SCHEDULER_TICK_NS;
+   }
+
+   slIdxT = clMessageIndexP.value(MessageKey_t(pclOwnerV, uwHandleV), -1);
+   if (slIdxT >= 0)
+   {
+      //-------------------------------------------------------------------------------------------
+      // update of an existing frame: with a new period the next transmission takes place one
+      // period after the last one
+      //
+      ptsMsgT = &clMessageListP[slIdxT];
+      if (ptsMsgT->sqPeriod != sqPeriodT)
+      {
+         unlink(slIdxT);
+         ptsMsgT->sqDueTime = ptsMsgT->sqDueTime - ptsMsgT->sqPeriod + sqPeriodT;
+         ptsMsgT->sqPeriod  = sqPeriodT;
+         link(slIdxT);
+      }
+   }
+   else
+   {
+      if (clMessageIndexP.size() >= QCAN_SCHEDULER_MESSAGE_MAX)
+      {
+         return (false);
+      }
+
+      if (clFreeListP.isEmpty())
+      {
+         clMessageListP.append(Message_s());
+         slIdxT = clMessageListP.size() - 1;
+      }
+      else
+      {
+         slIdxT = clFreeListP.takeLast();
+      }
+      clMessageIndexP.insert(MessageKey_t(pclOwnerV, uwHandleV), slIdxT);
+
+      ptsMsgT = &clMessageListP[slIdxT];
+      ptsMsgT->pclOwner    = pclOwnerV;
+      ptsMsgT->uwHandle    = uwHandleV;
+      ptsMsgT->ulCounter   = 0;
+      ptsMsgT->sqPeriod    = sqPeriodT;
+      ptsMsgT->sqDueTime   = sqTimeT;
+      ptsMsgT->uqJitterSum = 0;
+      memset(&ptsMsgT->tsStatus, 0, sizeof(CyclicStatus_ts));
+      link(slIdxT);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // the payload of the frame is the first entry of the pattern list
+   //
+   for (uint8_t ubPosT = 0; ubPosT < clFrameR.dataSize(); ubPosT++)
+   {
+      clPayloadT.append((char) clFrameR.data(ubPosT));
+   }
+
+   ptsMsgT->clFrame       = clFrameR;
+   ptsMsgT->clPattern.clear();
+   ptsMsgT->clPattern.append(clPayloadT);
+   ptsMsgT->slPatternIdx  = 0;
+   ptsMsgT->ubCounterPos  = ubCounterPosV;
+   ptsMsgT->ubCounterSize = ubCounterSizeV;
+
+   if (clTickTimerP.isActive() == false)
+   {
+      clTickTimerP.start();
+   }
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::status()                                                                                            //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanScheduler::status(QObject * pclOwnerV, uint16_t uwHandleV, CyclicStatus_ts & tsStatusR) const
+{
+   int32_t  slIdxT;
+
+   slIdxT = clMessageIndexP.value(MessageKey_t(pclOwnerV, uwHandleV), -1);
+   if (slIdxT < 0)
+   {
+      return (false);
+   }
+
+   tsStatusR = clMessageListP.at(slIdxT).tsStatus;
+   if (tsStatusR.ulCount > 0)
+   {
+      tsStatusR.ulJitterMean = (uint32_t) (clMessageListP.at(slIdxT).uqJitterSum / tsStatusR.ulCount);
+   }
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::transmit()                                                                                          //
+// transmit frame and calculate next transmission time                                                                //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanScheduler::transmit(int32_t slIdxV, int64_t sqTimeV)
+{
+   Message_s * ptsMsgT = &clMessageListP[slIdxV];
+   int64_t     sqJitterT;
+   uint8_t     ubPosT;
+
+   //---------------------------------------------------------------------------------------------------
+   // select payload of pattern list and apply payload counter
+   //
+   if (ptsMsgT->clPattern.size() > 1)
+   {
+      const QByteArray & clPayloadR = ptsMsgT->clPattern.at(ptsMsgT->slPatternIdx);
+
+      for (ubPosT = 0; ubPosT < clPayloadR.size(); ubPosT++)
+      {
+         ptsMsgT->clFrame.setData(ubPosT, (uint8_t) clPayloadR.at(ubPosT));
+      }
+
+      ptsMsgT->slPatternIdx++;
+      if (ptsMsgT->slPatternIdx == ptsMsgT->clPattern.size())
+      {
+         ptsMsgT->slPatternIdx = 0;
+      }
+   }
+
+   for (ubPosT = 0; ubPosT < ptsMsgT->ubCounterSize; ubPosT++)
+   {
+      ptsMsgT->clFrame.setData(ptsMsgT->ubCounterPos + ubPosT, (uint8_t) (ptsMsgT->ulCounter >> (ubPosT * 8)));
+   }
+   ptsMsgT->ulCounter++;
+
+   pclNetworkP->handleCanFrame(QCanNetwork::eFRAME_SOURCE_SCHEDULER, -1, ptsMsgT->clFrame.toByteArray());
+
+   //---------------------------------------------------------------------------------------------------
+   // update jitter, the value is limited to the range of the status values
+   //
+   sqJitterT = (sqTimeV - ptsMsgT->sqDueTime) / 1000;
+   if (sqJitterT > ((int64_t) 0x7FFFFFFF))
+   {
+      sqJitterT = ((int64_t) 0x7FFFFFFF);
+   }
+   if (sqJitterT < -((int64_t) 0x7FFFFFFF))
+   {
+      sqJitterT = -((int64_t) 0x7FFFFFFF);
+   }
+
+   ptsMsgT->tsStatus.ulCount++;
+   ptsMsgT->tsStatus.slJitterLast = (int32_t) sqJitterT;
+   if (sqJitterT < 0)
+   {
+      sqJitterT = -sqJitterT;
+   }
+   if ((uint32_t) sqJitterT > ptsMsgT->tsStatus.ulJitterMax)
+   {
+      ptsMsgT->tsStatus.ulJitterMax = (uint32_t) sqJitterT;
+   }
+   ptsMsgT->uqJitterSum += (uint64_t) sqJitterT;
+
+   //---------------------------------------------------------------------------------------------------
+   // the next transmission time is based on the scheduled time, so the period does not drift,
+   // transmissions which have been missed are skipped
+   //
+   ptsMsgT->sqDueTime += ptsMsgT->sqPeriod;
+   if (ptsMsgT->sqDueTime <= sqTimeV)
+   {
+      ptsMsgT->sqDueTime += ((sqTimeV - ptsMsgT->sqDueTime) / ptsMsgT->sqPeriod + 1) * ptsMsgT->sqPeriod;
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanScheduler::unlink()                                                                                            //
+// remove frame from the timer wheel                                                                                  //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanScheduler::unlink(int32_t slIdxV)
+{
+   Message_s * ptsMsgT = &clMessageListP[slIdxV];
+
+   if (ptsMsgT->slPrev >= 0)
+   {
+      clMessageListP[ptsMsgT->slPrev].slNext = ptsMsgT->slNext;
+   }
+   else if (aslSlotP[ptsMsgT->slSlot] == slIdxV)
+   {
+      aslSlotP[ptsMsgT->slSlot] = ptsMsgT->slNext;
+   }
+
+   if (ptsMsgT->slNext >= 0)
+   {
+      clMessageListP[ptsMsgT->slNext].slPrev = ptsMsgT->slPrev;
+   }
+
+   ptsMsgT->slNext = -1;
+   ptsMsgT->slPrev = -1;
+}
+
@@ -0,0 +1,275 @@
+//====================================================================================================================//
+// File:          qcan_scheduler.hpp                                                                                  //
+// Description:   QCAN classes - Cyclic transmit scheduler                                                            //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+#ifndef QCAN_SCHEDULER_HPP_
+#define QCAN_SCHEDULER_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QPair>
+#include <QtCore/QTimer>
+#include <QtCore/QVector>
+
+#include "qcan_defs.hpp"
+#include "qcan_frame.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_SCHEDULER_TICK
+** \ingroup QCAN_NW
+** \brief   Tick of scheduler
+**
+** This symbol defines the tick of the timer wheel of a QCanScheduler
+** in micro-seconds.
+*/
+#define  QCAN_SCHEDULER_TICK           1000
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_SCHEDULER_MESSAGE_MAX
+** \ingroup QCAN_NW
+** \brief   Maximum number of cyclic frames
+**
+** This symbol defines the maximum number of cyclic frames of a
+** QCanScheduler.
+*/
+#define  QCAN_SCHEDULER_MESSAGE_MAX    1024
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_SCHEDULER_PATTERN_MAX
+** \ingroup QCAN_NW
+** \brief   Maximum number of payload patterns
+**
+** This symbol defines the maximum number of payload patterns of a
+** cyclic frame.
+*/
+#define  QCAN_SCHEDULER_PATTERN_MAX    16
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_SCHEDULER_PERIOD_MAX
+** \ingroup QCAN_NW
+** \brief   Maximum period of a cyclic frame
+**
+** This symbol defines the maximum period of a cyclic frame in
+** micro-seconds.
+*/
+#define  QCAN_SCHEDULER_PERIOD_MAX     600000000
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Referenced classes                                                                                                 **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+class QCanNetwork;
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanScheduler
+** \brief Cyclic transmission of CAN frames
+**
+** The scheduler of a QCanNetwork transmits CAN frames with a fixed period. A cyclic frame is identified by its
+** owner (the socket which has registered the frame or \c Q_NULLPTR for the server) and a handle, it is added
+** or updated by setFrame() and removed by cancel(). Each transmission can increment a payload counter and / or
+** select the next payload of a pattern list (see appendPattern()).
+** <p>
+** The frames are sorted into a hierarchical timer wheel with a tick of #QCAN_SCHEDULER_TICK: 256 slots of
+** one tick, 64 slots of 256 ticks and 64 slots of 16384 ticks. Adding, updating and removing a frame has a
+** constant effort, the effort of a tick only depends on the frames which are due. The transmission time is
+** taken from a monotonic clock with nanosecond resolution: a frame is scheduled relative to its last
+** scheduled time, so the period does not drift. The deviation between the scheduled and the actual time
+** (jitter) of each frame is returned by status().
+*/
+class QCanScheduler : public QObject
+{
+   Q_OBJECT
+public:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclNetworkV    Pointer to CAN network
+   **
+   ** Create a new scheduler for the CAN network \a pclNetworkV, which is also the parent of the
+   ** scheduler.
+   */
+   QCanScheduler(QCanNetwork * pclNetworkV);
+
+   ~QCanScheduler();
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclOwnerV      Owner of cyclic frame
+   ** \param[in]  uwHandleV      Handle of cyclic frame
+   ** \param[in]  clFrameR       Payload pattern
+   ** \return     \c true if the pattern has been added
+   **
+   ** Append the payload of \a clFrameR to the pattern list of a cyclic frame. The payload of the
+   ** frame passed to setFrame() is the first entry of the list, each transmission selects the next
+   ** entry. A list holds up to #QCAN_SCHEDULER_PATTERN_MAX entries.
+   */
+   bool  appendPattern(QObject * pclOwnerV, uint16_t uwHandleV, const QCanFrame & clFrameR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclOwnerV      Owner of cyclic frame
+   ** \param[in]  uwHandleV      Handle of cyclic frame
+   ** \return     \c true if the frame has been removed
+   **
+   ** Stop the transmission of a cyclic frame.
+   */
+   bool  cancel(QObject * pclOwnerV, uint16_t uwHandleV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclOwnerV      Owner of cyclic frames
+   **
+   ** Stop the transmission of all cyclic frames of \a pclOwnerV, this function is called when a
+   ** socket is disconnected.
+   */
+   void  cancelAll(QObject * pclOwnerV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclOwnerV      Owner of cyclic frames
+   ** \return     List of handles
+   */
+   QVector<uint16_t>  handles(QObject * pclOwnerV) const;
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of cyclic frames
+   */
+   int32_t  messageCount(void) const      { return (clMessageIndexP.size()); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclOwnerV      Owner of cyclic frame
+   ** \param[in]  uwHandleV      Handle of cyclic frame
+   ** \param[in]  clFrameR       CAN frame
+   ** \param[in]  ulPeriodV      Period in micro-seconds
+   ** \param[in]  ubCounterPosV  Position of payload counter
+   ** \param[in]  ubCounterSizeV Size of payload counter in bytes
+   ** \return     \c true if the frame has been accepted
+   **
+   ** Add a cyclic frame or update an existing one. The first transmission of a new frame takes place
+   ** with the next tick. An update replaces the frame and the pattern list, the phase of the frame is
+   ** kept unless the period changes. The period must be in the range from #QCAN_SCHEDULER_TICK to
+   ** #QCAN_SCHEDULER_PERIOD_MAX.
+   ** <p>
+   ** A value of \a ubCounterSizeV in the range from 1 to 4 enables a payload counter: the data bytes
+   ** starting at \a ubCounterPosV are incremented after each transmission (LSB first). The counter
+   ** is applied after the pattern.
+   */
+   bool  setFrame(QObject * pclOwnerV, uint16_t uwHandleV, const QCanFrame & clFrameR, uint32_t ulPeriodV,
+                  uint8_t ubCounterPosV = 0, uint8_t ubCounterSizeV = 0);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclOwnerV      Owner of cyclic frame
+   ** \param[in]  uwHandleV      Handle of cyclic frame
+   ** \param[out] tsStatusR      Status of cyclic frame
+   ** \return     \c true if the frame exists
+   */
+   bool  status(QObject * pclOwnerV, uint16_t uwHandleV, CyclicStatus_ts & tsStatusR) const;
+
+private slots:
+
+   void  onTimerEvent(void);
+
+private:
+
+   //----------------------------------------------------------------
+   // cyclic frame: the frames of a slot of the timer wheel are
+   // linked by slNext / slPrev
+   //
+   struct Message_s {
+      QObject *            pclOwner;
+      uint16_t             uwHandle;
+      QCanFrame            clFrame;
+      QVector<QByteArray>  clPattern;
+      int32_t              slPatternIdx;
+      uint8_t              ubCounterPos;
+      uint8_t              ubCounterSize;
+      uint32_t             ulCounter;
+      int64_t              sqPeriod;
+      int64_t              sqDueTime;
+      int32_t              slNext;
+      int32_t              slPrev;
+      int32_t              slSlot;
+      CyclicStatus_ts      tsStatus;
+      uint64_t             uqJitterSum;
+   };
+
+   typedef QPair<QObject *, uint16_t>  MessageKey_t;
+
+   void  advance(int64_t sqTickV);
+
+   void  link(int32_t slIdxV);
+
+   void  transmit(int32_t slIdxV, int64_t sqTimeV);
+
+   void  unlink(int32_t slIdxV);
+
+   QCanNetwork *                 pclNetworkP;
+
+   QVector<Message_s>            clMessageListP;
+   QVector<int32_t>              clFreeListP;
+   QHash<MessageKey_t, int32_t>  clMessageIndexP;
+
+   //----------------------------------------------------------------
+   // timer wheel: slot 0 .. 255 hold the frames of the next 256
+   // ticks, slot 256 .. 319 and 320 .. 383 the following levels,
+   // sqTickP is the last tick which has been processed
+   //
+   int32_t                       aslSlotP[384];
+   int64_t                       sqTickP;
+
+   QElapsedTimer                 clClockP;
+   QTimer                        clTickTimerP;
+};
+
+#endif   // QCAN_SCHEDULER_HPP_
@@ -85,12 +85,24 @@ QCanServer::QCanServer( QObject * pclParentV, uint16_t  uwPortStartV, uint8_t ub
    pclListNetsP = new QVector<QCanNetwork *>;
    pclListNetsP->reserve(ubNetworkNumV);
 
+   pclMuxP     = new QCanMultiplexer(this, uwPortStartV + QCAN_NETWORK_MAX);
+   pclGatewayP = new QCanGateway(this);
+
    for(uint8_t ubNetCntT = 0; ubNetCntT < ubNetworkNumV; ubNetCntT++)
    {
       pclCanNetT = new QCanNetwork(pclParentV, uwPortStartV + ubNetCntT, pclSettingsP);
       pclListNetsP->append(pclCanNetT);
+      pclMuxP->addNetwork(pclCanNetT);
+      pclGatewayP->addNetwork(pclCanNetT);
    }
 
+   //------------------------------------------------------------------------------------
+   // accept multiplexed connections, frames are only passed to enabled networks. The servers
+   // are opened by the event loop, so the application can connect the multiplexer to its logger
+   // first and sees a server which can not be opened.
+   //
+   QTimer::singleShot(0, pclMuxP, SLOT(setEnabled()));
+
    //------------------------------------------------------------------------------------
    // start timer that calls onTimerEvent() every second
    //
@@ -240,6 +252,8 @@ void QCanServer::setServerAddress(QHostAddress clHostAddressV)
 
       qDebug() << "QCanServer::setServerAddress()" << clHostAddressV;
 
+      pclMuxP->setServerAddress(clHostAddressV);
+
       for(uint8_t ubNetCntT = 0; ubNetCntT < maximumNetwork(); ubNetCntT++)
       {
          pclNetworkT = network(ubNetCntT);
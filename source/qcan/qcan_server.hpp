@@ -39,6 +39,8 @@
 #include <QtCore/QObject>
 #include <QtCore/QSharedMemory>
 
+#include "qcan_gateway.hpp"
+#include "qcan_multiplexer.hpp"
 #include "qcan_network.hpp"
 
 
@@ -51,6 +53,13 @@
 ** multiple instances, the QCanServer class initialises a shared memory region which can be accessed using
 ** the QCanServerSettings class.
 ** <p>
+** A client can connect to several networks with a single connection, which is handled by the
+** QCanMultiplexer of the server (see multiplexer()). The TCP port of the multiplexer follows the TCP ports
+** of the networks.
+** <p>
+** The QCanGateway of the server forwards frames between the networks according to a set of rules (see
+** gateway()).
+** <p>
 **
 **
 */
@@ -97,6 +106,22 @@ public:
    */
    uint8_t       maximumNetwork(void) const;
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return Pointer to QCanMultiplexer
+   **
+   ** The function returns a pointer to the multiplexer, which handles connections to several networks.
+   */
+   QCanMultiplexer * multiplexer(void)   { return (pclMuxP);           };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return Pointer to QCanGateway
+   **
+   ** The function returns a pointer to the gateway, which forwards frames between the networks.
+   */
+   QCanGateway *     gateway(void)       { return (pclGatewayP);       };
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \return Host address of server
@@ -128,6 +153,8 @@ private:
 
    QHostAddress               clServerAddressP;
    QVector<QCanNetwork *> *   pclListNetsP;
+   QCanMultiplexer *          pclMuxP;
+   QCanGateway *              pclGatewayP;
    QSharedMemory *            pclSettingsP;
    QTimer *                   pclTimerP;
    bool                       btMemoryAttachedP;
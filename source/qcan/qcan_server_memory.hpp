@@ -101,7 +101,9 @@ typedef struct Network_s {
    int32_t  slNomBitRate;
    int32_t  slDatBitRate;
    char     szInterfaceName[QCAN_IF_NAME_LENGTH];
-   int32_t  slReserved[108];
+   int32_t  slValueCacheCount;
+   int32_t  slValueCacheSize;
+   int32_t  slReserved[106];
 } Network_ts;
 
 typedef struct ServerSettings_s {
@@ -0,0 +1,609 @@
+//====================================================================================================================//
+// File:          qcan_signal_database.cpp                                                                            //
+// Description:   QCAN classes - signal database                                                                      //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include <QtCore/QFile>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QStringList>
+#include <QtCore/QtEndian>
+
+#include "qcan_signal_database.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// the data of each frame is copied into a row of 72 bytes, so a 64
+// bit word can be loaded from every byte position of the payload
+//
+#define  SIGNAL_ROW_SIZE               (QCAN_MSG_DATA_MAX + 8)
+#define  SIGNAL_BIT_MAX                ((uint32_t) (QCAN_MSG_DATA_MAX * 8))
+
+//-------------------------------------------------------------------
+// bit 31 of the message identifier marks an extended frame, bit 30
+// and 29 are used by pseudo messages (e.g. VECTOR__INDEPENDENT_SIG_MSG)
+//
+#define  SIGNAL_KEY_EXT                ((uint32_t) 0x80000000)
+#define  SIGNAL_KEY_PSEUDO             ((uint32_t) 0x60000000)
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class methods                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSignalDatabase()                                                                                               //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanSignalDatabase::QCanSignalDatabase()
+{
+   clear();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSignalDatabase::clear()                                                                                        //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanSignalDatabase::clear(void)
+{
+   clMessageListP.clear();
+   clMessageKeyP.clear();
+   clSignalListP.clear();
+   clRowListP.clear();
+   clRowDataP.clear();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSignalDatabase::compileSignal()                                                                                //
+// compute extraction plan of signal                                                                                  //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanSignalDatabase::compileSignal(Signal_s & tsSignalR, uint32_t ulStartV, uint32_t ulLengthV,
+                                       bool btMotorolaV, bool btSignedV)
+{
+   uint32_t ulFirstBitT;
+
+   if ((ulLengthV == 0) || (ulLengthV > 64) || (ulStartV >= SIGNAL_BIT_MAX))
+   {
+      return (false);
+   }
+
+   //----------------------------------------------------------------
+   // The Intel format counts the start bit (LSB) from bit 0 of byte 0
+   // upwards. The start bit of the Motorola format is the MSB of the
+   // signal, it is converted into a position counted from bit 7 of
+   // byte 0, so that both formats are a linear range of bits.
+   //
+   if (btMotorolaV)
+   {
+      ulFirstBitT = ((ulStartV / 8) * 8) + (7 - (ulStartV % 8));
+   }
+   else
+   {
+      ulFirstBitT = ulStartV;
+   }
+
+   if ((ulFirstBitT + ulLengthV) > SIGNAL_BIT_MAX)
+   {
+      return (false);
+   }
+
+   tsSignalR.ubLoadPos  = (uint8_t) (ulFirstBitT / 8);
+   tsSignalR.ubShift    = (uint8_t) (ulFirstBitT % 8);
+   tsSignalR.ubLength   = (uint8_t) ulLengthV;
+   tsSignalR.btMotorola = btMotorolaV;
+   tsSignalR.btSigned   = btSignedV;
+   tsSignalR.btNextByte = ((ulFirstBitT % 8) + ulLengthV) > 64;
+
+   if (ulLengthV == 64)
+   {
+      tsSignalR.uqMask = ~((uint64_t) 0);
+   }
+   else
+   {
+      tsSignalR.uqMask = (((uint64_t) 1) << ulLengthV) - 1;
+   }
+
+   //----------------------------------------------------------------
+   // frames of the message must hold all bytes of the signal
+   //
+   Message_s & tsMessageT = clMessageListP[tsSignalR.slMessage];
+   uint8_t ubSizeT = (uint8_t) ((ulFirstBitT + ulLengthV + 7) / 8);
+   if (ubSizeT > tsMessageT.ubSizeMin)
+   {
+      tsMessageT.ubSizeMin = ubSizeT;
+   }
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSignalDatabase::decode()                                                                                       //
+// decode batch of frames into columns                                                                                //
+//--------------------------------------------------------------------------------------------------------------------//
+int32_t QCanSignalDatabase::decode(const QVector<QCanFrame> & clFrameListR, QVector<SignalValues_s> & clValuesR)
+{
+   int32_t  slDecodedT = 0;
+
+   //----------------------------------------------------------------
+   // prepare one column for each signal
+   //
+   clValuesR.resize(clSignalListP.size());
+   for (int32_t slSignalT = 0; slSignalT < clValuesR.size(); slSignalT++)
+   {
+      clValuesR[slSignalT].clFrameIndex.clear();
+      clValuesR[slSignalT].clRaw.clear();
+      clValuesR[slSignalT].clValue.clear();
+   }
+
+   //----------------------------------------------------------------
+   // sort the frames by message
+   //
+   clRowListP.resize(clMessageListP.size());
+   for (int32_t slMessageT = 0; slMessageT < clRowListP.size(); slMessageT++)
+   {
+      clRowListP[slMessageT].resize(0);
+   }
+
+   for (int32_t slFrameT = 0; slFrameT < clFrameListR.size(); slFrameT++)
+   {
+      const QCanFrame & clFrameT = clFrameListR.at(slFrameT);
+      int32_t slMessageT = messageIndex(clFrameT);
+      if (slMessageT < 0)
+      {
+         continue;
+      }
+
+      if (clFrameT.dataSize() < clMessageListP.at(slMessageT).ubSizeMin)
+      {
+         continue;
+      }
+
+      clRowListP[slMessageT].append(slFrameT);
+   }
+
+   //----------------------------------------------------------------
+   // decode all signals message by message: the data of the frames
+   // is copied into contiguous rows, then each signal is decoded by
+   // a loop over all rows
+   //
+   for (int32_t slMessageT = 0; slMessageT < clMessageListP.size(); slMessageT++)
+   {
+      const QVector<int32_t> & clRowsT = clRowListP.at(slMessageT);
+      int32_t slRowCountT = clRowsT.size();
+      if (slRowCountT == 0)
+      {
+         continue;
+      }
+
+      clRowDataP.resize(slRowCountT * SIGNAL_ROW_SIZE);
+      uint8_t * pubRowT = (uint8_t *) clRowDataP.data();
+      for (int32_t slRowT = 0; slRowT < slRowCountT; slRowT++)
+      {
+         memcpy(pubRowT, clFrameListR.at(clRowsT.at(slRowT)).constData(), QCAN_MSG_DATA_MAX);
+         memset(pubRowT + QCAN_MSG_DATA_MAX, 0, SIGNAL_ROW_SIZE - QCAN_MSG_DATA_MAX);
+         pubRowT += SIGNAL_ROW_SIZE;
+      }
+      pubRowT = (uint8_t *) clRowDataP.data();
+
+      foreach (int32_t slSignalT, clMessageListP.at(slMessageT).clSignalList)
+      {
+         const Signal_s & tsSignalT = clSignalListP.at(slSignalT);
+         SignalValues_s & tsValuesT = clValuesR[slSignalT];
+
+         tsValuesT.clFrameIndex = clRowsT;
+         tsValuesT.clRaw.resize(slRowCountT);
+         tsValuesT.clValue.resize(slRowCountT);
+
+         int64_t * psqRawT   = tsValuesT.clRaw.data();
+         double *  pdValueT  = tsValuesT.clValue.data();
+         double    dFactorT  = tsSignalT.dFactor;
+         double    dOffsetT  = tsSignalT.dOffset;
+
+         extractRaw(tsSignalT, pubRowT, slRowCountT, psqRawT);
+
+         if (tsSignalT.btSigned)
+         {
+            for (int32_t slRowT = 0; slRowT < slRowCountT; slRowT++)
+            {
+               pdValueT[slRowT] = ((double) psqRawT[slRowT]) * dFactorT + dOffsetT;
+            }
+         }
+         else
+         {
+            for (int32_t slRowT = 0; slRowT < slRowCountT; slRowT++)
+            {
+               pdValueT[slRowT] = ((double) ((uint64_t) psqRawT[slRowT])) * dFactorT + dOffsetT;
+            }
+         }
+      }
+
+      slDecodedT += slRowCountT;
+   }
+
+   return (slDecodedT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSignalDatabase::extractRaw()                                                                                   //
+// extract raw value of signal from rows of frame data                                                                //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanSignalDatabase::extractRaw(const Signal_s & tsSignalR, const uint8_t * pubRowV, int32_t slRowCountV,
+                                    int64_t * psqRawV)
+{
+   const uint8_t *   pubSrcT   = pubRowV + tsSignalR.ubLoadPos;
+   const uint64_t    uqMaskT   = tsSignalR.uqMask;
+   const uint32_t    ulShiftT  = tsSignalR.ubShift;
+   const uint32_t    ulUnusedT = 64 - tsSignalR.ubLength;
+   uint64_t          uqWordT;
+   int32_t           slRowT;
+
+   //----------------------------------------------------------------
+   // the plan is evaluated once per signal, so the loops have no
+   // branches
+   //
+   if (tsSignalR.btMotorola)
+   {
+      if (tsSignalR.btNextByte)
+      {
+         for (slRowT = 0; slRowT < slRowCountV; slRowT++)
+         {
+            uqWordT  = qFromBigEndian<quint64>(pubSrcT) << ulShiftT;
+            uqWordT |= pubSrcT[8] >> (8 - ulShiftT);
+            psqRawV[slRowT] = (int64_t) (uqWordT >> ulUnusedT);
+            pubSrcT += SIGNAL_ROW_SIZE;
+         }
+      }
+      else
+      {
+         for (slRowT = 0; slRowT < slRowCountV; slRowT++)
+         {
+            uqWordT = qFromBigEndian<quint64>(pubSrcT) << ulShiftT;
+            psqRawV[slRowT] = (int64_t) (uqWordT >> ulUnusedT);
+            pubSrcT += SIGNAL_ROW_SIZE;
+         }
+      }
+   }
+   else
+   {
+      if (tsSignalR.btNextByte)
+      {
+         for (slRowT = 0; slRowT < slRowCountV; slRowT++)
+         {
+            uqWordT  = qFromLittleEndian<quint64>(pubSrcT) >> ulShiftT;
+            uqWordT |= ((uint64_t) pubSrcT[8]) << (64 - ulShiftT);
+            psqRawV[slRowT] = (int64_t) (uqWordT & uqMaskT);
+            pubSrcT += SIGNAL_ROW_SIZE;
+         }
+      }
+      else
+      {
+         for (slRowT = 0; slRowT < slRowCountV; slRowT++)
+         {
+            uqWordT = qFromLittleEndian<quint64>(pubSrcT) >> ulShiftT;
+            psqRawV[slRowT] = (int64_t) (uqWordT & uqMaskT);
+            pubSrcT += SIGNAL_ROW_SIZE;
+         }
+      }
+   }
+
+   //----------------------------------------------------------------
+   // sign extension
+   //
+   if (tsSignalR.btSigned && (ulUnusedT > 0))
+   {
+      for (slRowT = 0; slRowT < slRowCountV; slRowT++)
+      {
+         psqRawV[slRowT] = ((int64_t) (((uint64_t) psqRawV[slRowT]) << ulUnusedT)) >> ulUnusedT;
+      }
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSignalDatabase::load()                                                                                         //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanSignalDatabase::load(const QString & clFileNameR)
+{
+   QFile clFileT(clFileNameR);
+
+   if (clFileT.open(QIODevice::ReadOnly | QIODevice::Text) == false)
+   {
+      clear();
+      clErrorStringP = clFileT.errorString();
+      return (false);
+   }
+
+   return (parse(QString::fromLatin1(clFileT.readAll())));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSignalDatabase::messageIndex()                                                                                 //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+int32_t QCanSignalDatabase::messageIndex(const QCanFrame & clFrameR) const
+{
+   uint32_t ulKeyT;
+
+   if ((clFrameR.frameType() != QCanFrame::eFRAME_TYPE_DATA) || clFrameR.isRemote())
+   {
+      return (-1);
+   }
+
+   ulKeyT = clFrameR.identifier();
+   if (clFrameR.isExtended())
+   {
+      ulKeyT |= SIGNAL_KEY_EXT;
+   }
+
+   return (clMessageKeyP.value(ulKeyT, -1));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSignalDatabase::parse()                                                                                        //
+// read messages and signals in DBC format                                                                            //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanSignalDatabase::parse(const QString & clTextR)
+{
+   QRegularExpression clMessageExpT("^BO_\\s+(\\d+)\\s+(\\w+)\\s*:\\s*(\\d+)");
+   QRegularExpression clSignalExpT("^SG_\\s+(\\w+)\\s*(\\w*)\\s*:\\s*(\\d+)\\|(\\d+)@([01])([+-])\\s*"
+                                   "\\(\\s*([^,\\s]+)\\s*,\\s*([^)\\s]+)\\s*\\)\\s*"
+                                   "\\[[^\\]]*\\]\\s*\"([^\"]*)\"");
+   QRegularExpressionMatch clMatchT;
+   QStringList clLineListT = clTextR.split('\n');
+   int32_t     slMessageT  = -1;
+   bool        btPseudoT   = false;
+
+   clear();
+   clErrorStringP.clear();
+
+   for (int32_t slLineT = 0; slLineT < clLineListT.size(); slLineT++)
+   {
+      QString clLineT = clLineListT.at(slLineT).trimmed();
+
+      //--------------------------------------------------------
+      // message: BO_ <identifier> <name>: <size> <transmitter>
+      //
+      if (clLineT.startsWith("BO_ "))
+      {
+         bool     btValidT = false;
+         uint32_t ulKeyT   = 0;
+         clMatchT = clMessageExpT.match(clLineT);
+         if (clMatchT.hasMatch())
+         {
+            ulKeyT = clMatchT.captured(1).toUInt(&btValidT, 10);
+         }
+
+         if (btValidT == false)
+         {
+            clear();
+            clErrorStringP = QString("Line %1: invalid message definition").arg(slLineT + 1);
+            return (false);
+         }
+
+         //------------------------------------------------
+         // signals of pseudo messages and messages with
+         // invalid identifier are ignored
+         //
+         btPseudoT = ((ulKeyT & SIGNAL_KEY_PSEUDO) != 0) ||
+                     (((ulKeyT & SIGNAL_KEY_EXT) == 0) && (ulKeyT > 0x7FF));
+         if (btPseudoT)
+         {
+            slMessageT = -1;
+            continue;
+         }
+
+         if (clMessageKeyP.contains(ulKeyT))
+         {
+            clear();
+            clErrorStringP = QString("Line %1: duplicate message identifier").arg(slLineT + 1);
+            return (false);
+         }
+
+         Message_s tsMessageT;
+         tsMessageT.clName    = clMatchT.captured(2);
+         tsMessageT.ulKey     = ulKeyT;
+         tsMessageT.ubSizeMin = 0;
+
+         slMessageT = clMessageListP.size();
+         clMessageListP.append(tsMessageT);
+         clMessageKeyP.insert(ulKeyT, slMessageT);
+         continue;
+      }
+
+      //--------------------------------------------------------
+      // signal: SG_ <name> [<mux>] : <start>|<length>@<order><sign>
+      //         (<factor>,<offset>) [<min>|<max>] "<unit>" ...
+      //
+      if (clLineT.startsWith("SG_ "))
+      {
+         if (btPseudoT)
+         {
+            continue;
+         }
+
+         clMatchT = clSignalExpT.match(clLineT);
+         if ((slMessageT < 0) || (clMatchT.hasMatch() == false))
+         {
+            clear();
+            clErrorStringP = QString("Line %1: invalid signal definition").arg(slLineT + 1);
+            return (false);
+         }
+
+         //------------------------------------------------
+         // multiplexed signals are not supported
+         //
+         if (clMatchT.captured(2).startsWith('m'))
+         {
+            continue;
+         }
+
+         bool btFactorT;
+         bool btOffsetT;
+         Signal_s tsSignalT;
+         tsSignalT.clName    = clMatchT.captured(1);
+         tsSignalT.clUnit    = clMatchT.captured(9);
+         tsSignalT.slMessage = slMessageT;
+         tsSignalT.dFactor   = clMatchT.captured(7).toDouble(&btFactorT);
+         tsSignalT.dOffset   = clMatchT.captured(8).toDouble(&btOffsetT);
+
+         if ((btFactorT == false) || (btOffsetT == false) ||
+             (compileSignal(tsSignalT, clMatchT.captured(3).toUInt(), clMatchT.captured(4).toUInt(),
+                            clMatchT.captured(5) == "0", clMatchT.captured(6) == "-") == false))
+         {
+            clear();
+            clErrorStringP = QString("Line %1: invalid signal definition").arg(slLineT + 1);
+            return (false);
+         }
+
+         clMessageListP[slMessageT].clSignalList.append(clSignalListP.size());
+         clSignalListP.append(tsSignalT);
+         continue;
+      }
+
+      //--------------------------------------------------------
+      // the signals of a message end with an empty line
+      //
+      if (clLineT.isEmpty())
+      {
+         slMessageT = -1;
+         btPseudoT  = false;
+      }
+   }
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSignalDatabase::signalIndex()                                                                                  //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+int32_t QCanSignalDatabase::signalIndex(const QString & clNameR) const
+{
+   QString  clMessageT;
+   QString  clSignalT = clNameR;
+   int32_t  slDotT    = clNameR.indexOf('.');
+
+   if (slDotT >= 0)
+   {
+      clMessageT = clNameR.left(slDotT);
+      clSignalT  = clNameR.mid(slDotT + 1);
+   }
+
+   for (int32_t slSignalT = 0; slSignalT < clSignalListP.size(); slSignalT++)
+   {
+      const Signal_s & tsSignalT = clSignalListP.at(slSignalT);
+      if (tsSignalT.clName != clSignalT)
+      {
+         continue;
+      }
+
+      if (clMessageT.isEmpty() || (clMessageListP.at(tsSignalT.slMessage).clName == clMessageT))
+      {
+         return (slSignalT);
+      }
+   }
+
+   return (-1);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSignalDatabase::toString()                                                                                     //
+// decode signals of a single frame                                                                                   //
+//--------------------------------------------------------------------------------------------------------------------//
+QString QCanSignalDatabase::toString(const QCanFrame & clFrameR) const
+{
+   uint8_t  aubRowT[SIGNAL_ROW_SIZE];
+   int64_t  sqRawT;
+   double   dValueT;
+   QString  clStringT;
+   int32_t  slMessageT = messageIndex(clFrameR);
+
+   if (slMessageT < 0)
+   {
+      return (clStringT);
+   }
+
+   const Message_s & tsMessageT = clMessageListP.at(slMessageT);
+   clStringT = tsMessageT.clName + ":";
+   if (clFrameR.dataSize() < tsMessageT.ubSizeMin)
+   {
+      clStringT += " invalid size";
+      return (clStringT);
+   }
+
+   memcpy(aubRowT, clFrameR.aubByteP, QCAN_MSG_DATA_MAX);
+   memset(aubRowT + QCAN_MSG_DATA_MAX, 0, SIGNAL_ROW_SIZE - QCAN_MSG_DATA_MAX);
+
+   foreach (int32_t slSignalT, tsMessageT.clSignalList)
+   {
+      const Signal_s & tsSignalT = clSignalListP.at(slSignalT);
+      extractRaw(tsSignalT, aubRowT, 1, &sqRawT);
+      if (tsSignalT.btSigned)
+      {
+         dValueT = (double) sqRawT;
+      }
+      else
+      {
+         dValueT = (double) ((uint64_t) sqRawT);
+      }
+      dValueT = dValueT * tsSignalT.dFactor + tsSignalT.dOffset;
+
+      clStringT += " " + tsSignalT.clName + "=" + QString::number(dValueT, 'g', 10);
+      if (tsSignalT.clUnit.isEmpty() == false)
+      {
+         clStringT += " " + tsSignalT.clUnit;
+      }
+   }
+
+   return (clStringT);
+}
+
@@ -0,0 +1,282 @@
+//====================================================================================================================//
+// File:          qcan_signal_database.hpp                                                                            //
+// Description:   QCAN classes - signal database                                                                      //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+#ifndef QCAN_SIGNAL_DATABASE_HPP_
+#define QCAN_SIGNAL_DATABASE_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "qcan_frame.hpp"
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanSignalDatabase
+** \brief Decoding of signals from CAN frames
+**
+** The class decodes physical values (signals) from the payload of CAN frames. The description of the messages
+** and signals is read from a file in DBC format by load() or from a string by parse(). The following subset
+** of the DBC format is evaluated, all other lines are ignored:
+** \code
+** BO_ <identifier> <message name>: <size> <transmitter>
+**  SG_ <signal name> : <start bit>|<length>@<byte order><sign> (<factor>,<offset>) [<min>|<max>] "<unit>" ...
+** \endcode
+** Bit 31 of the message identifier marks an extended frame, byte order 1 denotes Intel (little endian) and
+** 0 Motorola (big endian) format. Multiplexed signals (multiplexer indicator \c m) are not supported and
+** skipped, floating point signals (\c SIG_VALTYPE_) are decoded as integer. Signals may have a length of
+** up to 64 bits and are located anywhere inside the 64 data bytes of a CAN FD frame.
+** <p>
+** Every signal is compiled to an extraction plan: the position of a 64 bit word inside the payload, the
+** shift and mask of the raw value and the conversion to the physical value. Decoding a signal thus takes
+** one load, one shift and one mask operation, independent of its position and byte order.
+** <p>
+** The function decode() converts a batch of frames into one column per signal, which is the preferred way
+** for bulk processing of recorded data: the frames are sorted by message and every signal is decoded by a
+** loop over all frames of its message, which the compiler can vectorize. The function toString() decodes
+** a single frame for display.
+** \code
+** QCanSignalDatabase clDatabaseT;
+** QVector<QCanSignalDatabase::SignalValues_s> clValuesT;
+**
+** clDatabaseT.load("vehicle.dbc");
+** clDatabaseT.decode(clFrameListT, clValuesT);
+** int32_t slSpeedT = clDatabaseT.signalIndex("VehicleSpeed");
+** for (int32_t slRowT = 0; slRowT < clValuesT[slSpeedT].clValue.size(); slRowT++)
+** {
+**    qDebug() << clValuesT[slSpeedT].clValue[slRowT];
+** }
+** \endcode
+*/
+class QCanSignalDatabase
+{
+public:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \struct  SignalValues_s
+   **
+   ** The structure holds the decoded values of one signal in columns, every row belongs to one frame
+   ** of the batch passed to decode().
+   */
+   struct SignalValues_s {
+
+      /*! index of the frame inside the batch                                 */
+      QVector<int32_t>  clFrameIndex;
+
+      /*! raw value, sign extended for signed signals                         */
+      QVector<int64_t>  clRaw;
+
+      /*! physical value: raw value * factor + offset                         */
+      QVector<double>   clValue;
+   };
+
+   QCanSignalDatabase();
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** Remove all messages and signals.
+   */
+   void  clear(void);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameListR   List of CAN frames
+   ** \param[out] clValuesR      Decoded values, one entry per signal
+   ** \return     Number of decoded frames
+   **
+   ** The function decodes all signals of the frames in \a clFrameListR. The vector \a clValuesR is
+   ** resized to signalCount(), the entry of a signal holds one row for every frame of its message.
+   ** Frames of unknown messages, remote frames, error frames and frames which are too short for the
+   ** signals of their message are not decoded.
+   */
+   int32_t  decode(const QVector<QCanFrame> & clFrameListR, QVector<SignalValues_s> & clValuesR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Description of last error
+   **
+   ** The function returns a description of the last error of load() or parse().
+   */
+   inline QString  errorString(void) const               { return (clErrorStringP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFileNameR    Name of DBC file
+   ** \return     \c true if file has been read
+   **
+   ** The function reads the messages and signals from the file \a clFileNameR, see parse().
+   */
+   bool  load(const QString & clFileNameR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameR       CAN frame
+   ** \return     Index of message or -1
+   **
+   ** The function returns the index of the message which is described by the identifier and the
+   ** frame format of \a clFrameR.
+   */
+   int32_t  messageIndex(const QCanFrame & clFrameR) const;
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of messages
+   */
+   inline int32_t  messageCount(void) const              { return (clMessageListP.size()); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slMessageV     Index of message
+   ** \return     Name of message
+   */
+   inline QString  messageName(int32_t slMessageV) const { return (clMessageListP.at(slMessageV).clName); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clTextR        Text in DBC format
+   ** \return     \c true if all messages and signals could be compiled
+   **
+   ** The function removes all messages and signals and reads them from \a clTextR. On failure the
+   ** database is empty and the line of the error is returned by errorString().
+   */
+   bool  parse(const QString & clTextR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of signals
+   */
+   inline int32_t  signalCount(void) const               { return (clSignalListP.size()); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clNameR        Name of signal
+   ** \return     Index of signal or -1
+   **
+   ** The function returns the index of the signal \a clNameR, the name may be qualified by the
+   ** message name, e.g. "Engine.Speed".
+   */
+   int32_t  signalIndex(const QString & clNameR) const;
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slSignalV      Index of signal
+   ** \return     Index of message
+   */
+   inline int32_t  signalMessage(int32_t slSignalV) const   { return (clSignalListP.at(slSignalV).slMessage); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slSignalV      Index of signal
+   ** \return     Name of signal
+   */
+   inline QString  signalName(int32_t slSignalV) const      { return (clSignalListP.at(slSignalV).clName); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slSignalV      Index of signal
+   ** \return     Unit of signal
+   */
+   inline QString  signalUnit(int32_t slSignalV) const      { return (clSignalListP.at(slSignalV).clUnit); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameR       CAN frame
+   ** \return     Decoded signals
+   **
+   ** The function decodes the signals of \a clFrameR and returns them as string, e.g.
+   ** "Engine: Speed=1200.5 rpm Temperature=87 degC". An empty string is returned if the frame
+   ** is not described by the database.
+   */
+   QString  toString(const QCanFrame & clFrameR) const;
+
+private:
+
+   //----------------------------------------------------------------
+   // extraction plan of a signal: a 64 bit word is loaded from byte
+   // ubLoadPos (little endian for Intel, big endian for Motorola
+   // format), shifted by ubShift and masked; for signals spanning
+   // nine bytes the bits of the following byte are merged
+   //
+   struct Signal_s {
+      QString     clName;
+      QString     clUnit;
+      int32_t     slMessage;
+      uint64_t    uqMask;
+      double      dFactor;
+      double      dOffset;
+      uint8_t     ubLoadPos;
+      uint8_t     ubShift;
+      uint8_t     ubLength;
+      bool        btMotorola;
+      bool        btSigned;
+      bool        btNextByte;
+   };
+
+   struct Message_s {
+      QString           clName;
+      uint32_t          ulKey;
+      uint8_t           ubSizeMin;
+      QVector<int32_t>  clSignalList;
+   };
+
+   bool     compileSignal(Signal_s & tsSignalR, uint32_t ulStartV, uint32_t ulLengthV,
+                          bool btMotorolaV, bool btSignedV);
+
+   static void    extractRaw(const Signal_s & tsSignalR, const uint8_t * pubRowV, int32_t slRowCountV,
+                             int64_t * psqRawV);
+
+   //----------------------------------------------------------------
+   // messages are looked up by identifier, bit 31 of the key marks
+   // an extended frame (as in the DBC format)
+   //
+   QVector<Message_s>         clMessageListP;
+   QHash<uint32_t, int32_t>   clMessageKeyP;
+   QVector<Signal_s>          clSignalListP;
+   QString                    clErrorStringP;
+
+   //----------------------------------------------------------------
+   // buffers used by decode(): frame indices of every message and
+   // contiguous copy of the frame data with padding
+   //
+   QVector< QVector<int32_t> >   clRowListP;
+   QByteArray                    clRowDataP;
+};
+
+#endif   // QCAN_SIGNAL_DATABASE_HPP_
@@ -39,10 +39,14 @@
 **                                                                            **
 \*----------------------------------------------------------------------------*/
 
+#include <string.h>
+
 #include "qcan_socket.hpp"
 
 
 #include <QtCore/QDebug>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QtEndian>
 
 #include <QtNetwork/QNetworkInterface>
 
@@ -89,6 +93,31 @@ QCanSocket::QCanSocket(QObject * pclParentV)
    //
    btIsLocalConnectionP = true;
    btIsConnectedP       = false;
+   btIsMultiplexedP     = false;
+   ulChannelMaskP       = 0;
+
+   //----------------------------------------------------------------
+   // all frames are received by default
+   //
+   btSubChangeOnlyP     = false;
+   ulSubRateMaxP        = 0;
+   ulSubKeepAliveP      = 0;
+   btSnapshotPendingP   = false;
+
+   //----------------------------------------------------------------
+   // queue of writeQueued() is empty
+   //
+   btWriteQueuedP       = false;
+
+   //----------------------------------------------------------------
+   // the UDP socket is created by connectMulticast()
+   //
+   btIsMulticastP        = false;
+   btMcastSequenceValidP = false;
+   ubMcastChannelP       = eCAN_CHANNEL_NONE;
+   slMcastReadPosP       = 0;
+   ulMcastSequenceP      = 0;
+   ulMcastLostP          = 0;
 
    //----------------------------------------------------------------
    // No socket errors available yet
@@ -110,6 +139,28 @@ QCanSocket::~QCanSocket()
 }
 
 
+//----------------------------------------------------------------------------//
+// appendCyclicPattern()                                                      //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool QCanSocket::appendCyclicPattern(uint16_t uwHandleV, const QCanFrame & clFrameR)
+{
+   return (writeCyclic(QCAN_CYCLIC_PATTERN, uwHandleV, clFrameR));
+}
+
+
+//----------------------------------------------------------------------------//
+// cancelCyclicFrame()                                                        //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool QCanSocket::cancelCyclicFrame(uint16_t uwHandleV)
+{
+   clCyclicStatusP.remove(uwHandleV);
+
+   return (writeCyclic(QCAN_CYCLIC_CANCEL, uwHandleV, QCanFrame()));
+}
+
+
 //----------------------------------------------------------------------------//
 // connectNetwork()                                                           //
 //                                                                            //
@@ -119,6 +170,120 @@ bool QCanSocket::connectNetwork(CAN_Channel_e ubChannelV,
 {
    bool btResultT = false;
 
+   if (btIsConnectedP == false)
+   {
+      btIsMultiplexedP = false;
+      ulChannelMaskP   = 0;
+      btResultT = connectServer(QString("CANpieServerChannel%1").arg(ubChannelV),
+                                uwTcpPortP + ubChannelV - 1,
+                                slMilliSecsV);
+   }
+
+   return(btResultT);
+}
+
+
+//----------------------------------------------------------------------------//
+// connectMulticast()                                                         //
+// passive listener for UDP multicast datagrams                               //
+//----------------------------------------------------------------------------//
+bool QCanSocket::connectMulticast(CAN_Channel_e teChannelV, QHostAddress clGroupV)
+{
+   bool btResultT = false;
+
+   if ( (btIsConnectedP == false) && (clGroupV.isMulticast() == true) &&
+        (teChannelV > eCAN_CHANNEL_NONE) && (teChannelV <= QCAN_NETWORK_MAX) )
+   {
+      if (pclUdpSockP.isNull())
+      {
+         pclUdpSockP = new QUdpSocket(this);
+      }
+
+      //---------------------------------------------------------
+      // several listeners on the same host share the UDP port
+      //
+      if (pclUdpSockP->bind(QHostAddress(QHostAddress::AnyIPv4),
+                            QCAN_MCAST_PORT + teChannelV - 1,
+                            QUdpSocket::ShareAddress | QUdpSocket::ReuseAddressHint))
+      {
+         if (pclUdpSockP->joinMulticastGroup(clGroupV))
+         {
+            connect( pclUdpSockP, SIGNAL(readyRead()),
+                     this, SLOT(onSocketReceiveMulticast()));
+
+            clMcastGroupP         = clGroupV;
+            clMcastFramesP.clear();
+            slMcastReadPosP       = 0;
+            ubMcastChannelP       = teChannelV;
+            ulMcastLostP          = 0;
+            btMcastSequenceValidP = false;
+            btIsMulticastP        = true;
+            btIsConnectedP        = true;
+            btResultT             = true;
+            emit connected();
+         }
+         else
+         {
+            pclUdpSockP->close();
+         }
+      }
+
+      if (btResultT == false)
+      {
+         slSocketErrorP = pclUdpSockP->error();
+      }
+   }
+
+   return(btResultT);
+}
+
+
+//----------------------------------------------------------------------------//
+// connectNetworks()                                                          //
+// multiplexed connection to several CAN networks                             //
+//----------------------------------------------------------------------------//
+bool QCanSocket::connectNetworks(const QList<CAN_Channel_e> & clChannelListR,
+                                 const int32_t slMilliSecsV)
+{
+   bool           btResultT = false;
+   CAN_Channel_e  teChannelT;
+   uint32_t       ulMaskT = 0;
+
+   //----------------------------------------------------------------
+   // build the bit-mask of CAN channels which is sent to the server
+   // upon connection
+   //
+   foreach (teChannelT, clChannelListR)
+   {
+      if ((teChannelT > eCAN_CHANNEL_NONE) && (teChannelT <= QCAN_NETWORK_MAX))
+      {
+         ulMaskT |= ((uint32_t) 1) << (teChannelT - 1);
+      }
+   }
+
+   if ((btIsConnectedP == false) && (ulMaskT != 0))
+   {
+      btIsMultiplexedP = true;
+      ulChannelMaskP   = ulMaskT;
+      btResultT = connectServer(QString(QCAN_MUX_SERVER_NAME),
+                                uwTcpPortP + QCAN_NETWORK_MAX,
+                                slMilliSecsV);
+   }
+
+   return(btResultT);
+}
+
+
+//----------------------------------------------------------------------------//
+// connectServer()                                                            //
+// connect to a TCP port or local server                                      //
+//----------------------------------------------------------------------------//
+bool QCanSocket::connectServer(const QString & clServerNameR,
+                               uint16_t uwPortV,
+                               const int32_t slMilliSecsV)
+{
+   bool btResultT = false;
+
    //---------------------------------------------------------------------
    // create a new socket
    //
@@ -127,13 +292,13 @@ bool QCanSocket::connectNetwork(CAN_Channel_e ubChannelV,
 
       if (btIsLocalConnectionP == false)
       {
-         qDebug() << "QCanSocket::connectNetwork(" << ubChannelV << "," << slMilliSecsV << ") - TCP";
+         qDebug() << "QCanSocket::connectNetwork(" << uwPortV << "," << slMilliSecsV << ") - TCP";
 
          //----------------------------------------------------------
          // create new TCP socket
          //
          pclTcpSockP->abort();
-         pclTcpSockP->connectToHost(clTcpHostAddrP, uwTcpPortP + ubChannelV - 1);
+         pclTcpSockP->connectToHost(clTcpHostAddrP, uwPortV);
 
          //----------------------------------------------------------
          // make signal / slot connection for TCP socket
@@ -174,7 +339,7 @@ bool QCanSocket::connectNetwork(CAN_Channel_e ubChannelV,
       }
       else
       {
-         qDebug() << "QCanSocket::connectNetwork(" << ubChannelV << "," << slMilliSecsV << ") - Local";
+         qDebug() << "QCanSocket::connectNetwork(" << clServerNameR << "," << slMilliSecsV << ") - Local";
 
          //----------------------------------------------------------
          // create new local socket
@@ -199,7 +364,7 @@ bool QCanSocket::connectNetwork(CAN_Channel_e ubChannelV,
          //----------------------------------------------------------
          // connect to local server
          //
-         pclLocalSockP->connectToServer(QString("CANpieServerChannel%1").arg(ubChannelV));
+         pclLocalSockP->connectToServer(clServerNameR);
          qDebug() << "QCanSocket::connectNetwork() -" << pclLocalSockP->fullServerName();
 
          //----------------------------------------------------------
@@ -231,6 +396,23 @@ bool QCanSocket::connectNetwork(CAN_Channel_e ubChannelV,
 }
 
 
+//----------------------------------------------------------------------------//
+// cyclicStatus()                                                             //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool QCanSocket::cyclicStatus(uint16_t uwHandleV, CyclicStatus_ts & tsStatusR) const
+{
+   if (clCyclicStatusP.contains(uwHandleV) == false)
+   {
+      return (false);
+   }
+
+   tsStatusR = clCyclicStatusP.value(uwHandleV);
+
+   return (true);
+}
+
+
 //----------------------------------------------------------------------------//
 // disconnectNetwork()                                                        //
 //                                                                            //
@@ -239,7 +421,16 @@ void QCanSocket::disconnectNetwork(void)
 {
    qDebug() << "QCanSocket::disconnectNetwork() ";
 
-   if (btIsLocalConnectionP == false)
+   if (btIsMulticastP == true)
+   {
+      disconnect(pclUdpSockP, 0, 0, 0);
+      pclUdpSockP->leaveMulticastGroup(clMcastGroupP);
+      pclUdpSockP->close();
+      clMcastFramesP.clear();
+      slMcastReadPosP = 0;
+      btIsMulticastP  = false;
+   }
+   else if (btIsLocalConnectionP == false)
    {
       pclTcpSockP->disconnectFromHost();
    }
@@ -286,7 +477,11 @@ int32_t QCanSocket::framesAvailable(void) const
 {
    uint32_t    ulFrameCountT;
 
-   if (btIsLocalConnectionP == false)
+   if (btIsMulticastP == true)
+   {
+      ulFrameCountT = (clMcastFramesP.size() - slMcastReadPosP) / QCAN_FRAME_ARRAY_SIZE;
+   }
+   else if (btIsLocalConnectionP == false)
    {
       ulFrameCountT = pclTcpSockP->bytesAvailable() / QCAN_FRAME_ARRAY_SIZE;
    }
@@ -299,6 +494,28 @@ int32_t QCanSocket::framesAvailable(void) const
 }
 
 
+//----------------------------------------------------------------------------//
+// handleRecord()                                                             //
+// handle control record of the network                                       //
+//----------------------------------------------------------------------------//
+void QCanSocket::handleRecord(const QByteArray & clRecordR)
+{
+   const uint8_t *   pubRecordT = (const uint8_t *) clRecordR.constData();
+   CyclicStatus_ts   tsStatusT;
+   uint16_t          uwHandleT;
+
+   if ((pubRecordT[QCAN_RECORD_TYPE_POS] == QCAN_RECORD_CYCLIC) && (pubRecordT[70] == QCAN_CYCLIC_STATUS))
+   {
+      uwHandleT = qFromBigEndian<quint16>(pubRecordT + 72);
+      tsStatusT.ulCount      = qFromBigEndian<quint32>(pubRecordT + 0);
+      tsStatusT.slJitterLast = qFromBigEndian<qint32>(pubRecordT + 4);
+      tsStatusT.ulJitterMax  = qFromBigEndian<quint32>(pubRecordT + 8);
+      tsStatusT.ulJitterMean = qFromBigEndian<quint32>(pubRecordT + 12);
+      clCyclicStatusP.insert(uwHandleT, tsStatusT);
+   }
+}
+
+
 //----------------------------------------------------------------------------//
 // isConnected()                                                              //
 //                                                                            //
@@ -309,6 +526,25 @@ bool QCanSocket::isConnected(void)
 }
 
 
+//----------------------------------------------------------------------------//
+// mcastRelease()                                                             //
+// release frames of the multicast buffer which have been read                //
+//----------------------------------------------------------------------------//
+void QCanSocket::mcastRelease(int32_t slSizeV)
+{
+   //----------------------------------------------------------------
+   // the read position is moved forward, the buffer is emptied
+   // once after the last frame has been read
+   //
+   slMcastReadPosP += slSizeV;
+   if (slMcastReadPosP >= clMcastFramesP.size())
+   {
+      clMcastFramesP.clear();
+      slMcastReadPosP = 0;
+   }
+}
+
+
 //----------------------------------------------------------------------------//
 // onSocketConnect()                                                          //
 //                                                                            //
@@ -317,6 +553,41 @@ void QCanSocket::onSocketConnect(void)
 {
    qDebug() << "QCanSocket::onSocketConnect() ";
 
+   //----------------------------------------------------------------
+   // a multiplexed connection starts with the subscription of the
+   // CAN channels
+   //
+   if (btIsMultiplexedP == true)
+   {
+      QByteArray  clDatagramT(QCAN_FRAME_ARRAY_SIZE, 0x00);
+
+      clDatagramT[0] = (uint8_t) (ulChannelMaskP >> 24);
+      clDatagramT[1] = (uint8_t) (ulChannelMaskP >> 16);
+      clDatagramT[2] = (uint8_t) (ulChannelMaskP >>  8);
+      clDatagramT[3] = (uint8_t) (ulChannelMaskP >>  0);
+      clDatagramT[QCAN_MUX_CHANNEL_POS] = eCAN_CHANNEL_NONE;
+      writeDatagram(clDatagramT);
+   }
+
+   //----------------------------------------------------------------
+   // send the subscription to the network, a snapshot is requested
+   // after the subscription, so the frames of the snapshot count as
+   // sent for the subscription
+   //
+   if (btIsMultiplexedP == false)
+   {
+      if ((btSubChangeOnlyP == true) || (ulSubRateMaxP > 0))
+      {
+         writeSubscription();
+      }
+
+      if (btSnapshotPendingP == true)
+      {
+         writeRecord(QCAN_RECORD_SNAPSHOT);
+      }
+   }
+   btSnapshotPendingP = false;
+
    //----------------------------------------------------------------
    // send signal about connection state and keep it in local
    // variable
@@ -437,18 +708,135 @@ void QCanSocket::onSocketReceive(void)
 }
 
 
+//----------------------------------------------------------------------------//
+// onSocketReceiveMulticast()                                                 //
+// unpack UDP multicast datagrams                                             //
+//----------------------------------------------------------------------------//
+void QCanSocket::onSocketReceiveMulticast(void)
+{
+   QByteArray  clDatagramT;
+   uint32_t    ulSequenceT;
+   uint32_t    ulFrameCountT;
+
+   while (pclUdpSockP->hasPendingDatagrams())
+   {
+      clDatagramT.resize(pclUdpSockP->pendingDatagramSize());
+      pclUdpSockP->readDatagram(clDatagramT.data(), clDatagramT.size());
+
+      if (clDatagramT.size() < QCAN_MCAST_HEADER_SIZE)
+      {
+         continue;
+      }
+
+      //---------------------------------------------------------
+      // check CAN channel and number of frames of the datagram
+      //
+      ulFrameCountT = (uint8_t) clDatagramT.at(5);
+      if ( ((uint8_t) clDatagramT.at(4) != ubMcastChannelP) ||
+           (clDatagramT.size() < (int32_t) (QCAN_MCAST_HEADER_SIZE + (ulFrameCountT * QCAN_FRAME_ARRAY_SIZE))) )
+      {
+         continue;
+      }
+
+      //---------------------------------------------------------
+      // a gap in the sequence numbers denotes lost datagrams
+      //
+      ulSequenceT =               (uint8_t) clDatagramT.at(0);
+      ulSequenceT = ulSequenceT << 8;
+      ulSequenceT = ulSequenceT + (uint8_t) clDatagramT.at(1);
+      ulSequenceT = ulSequenceT << 8;
+      ulSequenceT = ulSequenceT + (uint8_t) clDatagramT.at(2);
+      ulSequenceT = ulSequenceT << 8;
+      ulSequenceT = ulSequenceT + (uint8_t) clDatagramT.at(3);
+
+      if (btMcastSequenceValidP == true)
+      {
+         if ((int32_t) (ulSequenceT - ulMcastSequenceP) < 0)
+         {
+            //---------------------------------------------------
+            // datagram has been reordered or duplicated
+            //
+            continue;
+         }
+         ulMcastLostP += ulSequenceT - ulMcastSequenceP;
+      }
+      ulMcastSequenceP      = ulSequenceT + 1;
+      btMcastSequenceValidP = true;
+
+      //---------------------------------------------------------
+      // frames which have been read are removed before new frames
+      // are appended, so the buffer does not grow while the reader
+      // keeps some frames pending
+      //
+      if (slMcastReadPosP > 0)
+      {
+         clMcastFramesP.remove(0, slMcastReadPosP);
+         slMcastReadPosP = 0;
+      }
+
+      clMcastFramesP.append(clDatagramT.constData() + QCAN_MCAST_HEADER_SIZE,
+                            ulFrameCountT * QCAN_FRAME_ARRAY_SIZE);
+   }
+
+   ulFrameCountT = framesAvailable();
+   if (ulFrameCountT > 0)
+   {
+      framesReceived(ulFrameCountT);
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// onWriteQueue()                                                             //
+// write frames of writeQueued()                                              //
+//----------------------------------------------------------------------------//
+void QCanSocket::onWriteQueue(void)
+{
+   QVector<QCanFrame>   clFrameListT;
+
+   //----------------------------------------------------------------
+   // the queue is taken under lock, writing is done without lock
+   //
+   clWriteQueueMutexP.lock();
+   clFrameListT.swap(clWriteQueueP);
+   btWriteQueuedP = false;
+   clWriteQueueMutexP.unlock();
+
+   writeFrames(clFrameListT);
+}
+
+
 //--------------------------------------------------------------------------------------------------------------------//
 // QCanSocket::read                                                                                                   //
 // read CAN frame                                                                                                     //
 //--------------------------------------------------------------------------------------------------------------------//
 bool QCanSocket::read(QCanFrame & clFrameR)
+{
+   CAN_Channel_e  teChannelT;
+
+   return (read(clFrameR, teChannelT));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSocket::read                                                                                                   //
+// read CAN frame and CAN channel                                                                                     //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanSocket::read(QCanFrame & clFrameR, CAN_Channel_e & teChannelR)
 {
    bool        btResultT = false;
    QByteArray  clDatagramT;
 
-   if (framesAvailable() > 0)
+   teChannelR = eCAN_CHANNEL_NONE;
+
+   while (framesAvailable() > 0)
    {
-      if (btIsLocalConnectionP == false)
+      if (btIsMulticastP == true)
+      {
+         clDatagramT = clMcastFramesP.mid(slMcastReadPosP, QCAN_FRAME_ARRAY_SIZE);
+         mcastRelease(QCAN_FRAME_ARRAY_SIZE);
+      }
+      else if (btIsLocalConnectionP == false)
       {
          clDatagramT = pclTcpSockP->read(QCAN_FRAME_ARRAY_SIZE);
       }
@@ -457,6 +845,26 @@ bool QCanSocket::read(QCanFrame & clFrameR)
          clDatagramT = pclLocalSockP->read(QCAN_FRAME_ARRAY_SIZE);
       }
 
+      //-------------------------------------------------------------------------------------------
+      // a control record of a single network is evaluated, reading continues with the next
+      // frame
+      //
+      if ((btIsMultiplexedP == false) && (btIsMulticastP == false) &&
+          (clDatagramT.size() == QCAN_FRAME_ARRAY_SIZE) && (clDatagramT.at(QCAN_RECORD_TYPE_POS) != 0))
+      {
+         handleRecord(clDatagramT);
+         continue;
+      }
+
+      //-------------------------------------------------------------------------------------------
+      // The CAN channel of a multiplexed connection is removed, it is not part of the checksum
+      //
+      if ((btIsMultiplexedP == true) && (clDatagramT.size() == QCAN_FRAME_ARRAY_SIZE))
+      {
+         teChannelR = (CAN_Channel_e) clDatagramT.at(QCAN_MUX_CHANNEL_POS);
+         clDatagramT[QCAN_MUX_CHANNEL_POS] = 0;
+      }
+
       btResultT = clFrameR.fromByteArray(clDatagramT);
 
       //-------------------------------------------------------------------------------------------
@@ -469,12 +877,221 @@ bool QCanSocket::read(QCanFrame & clFrameR)
             teCanStateP = clFrameR.errorState();
          }
       }
+      break;
    }
 
    return(btResultT);
 }
 
 
+//----------------------------------------------------------------------------//
+// readBuffer()                                                               //
+// read a block of frames from the socket                                     //
+//----------------------------------------------------------------------------//
+int32_t QCanSocket::readBuffer(QVector<QCanFrame> & clFrameListR, QVector<CAN_Channel_e> * pclChannelListV,
+                               int32_t slFrameMaxV)
+{
+   const uint8_t *   pubBufferT;
+   const uint8_t *   pubRecordT;
+   uint8_t           aubRecordT[QCAN_FRAME_ARRAY_SIZE];
+   QCanFrame         clFrameT;
+   CAN_Channel_e     teChannelT;
+   int32_t           slRecordCntT;
+   int32_t           slRecordIdxT;
+   int32_t           slFrameCntT = 0;
+   qint64            sqSizeT;
+
+   //----------------------------------------------------------------
+   // all available records are read with a single call
+   //
+   slRecordCntT = framesAvailable();
+   if ((slFrameMaxV >= 0) && (slRecordCntT > slFrameMaxV))
+   {
+      slRecordCntT = slFrameMaxV;
+   }
+
+   if (slRecordCntT <= 0)
+   {
+      return (0);
+   }
+
+   if (btIsMulticastP == true)
+   {
+      pubBufferT = (const uint8_t *) clMcastFramesP.constData() + slMcastReadPosP;
+   }
+   else
+   {
+      clReadBufferP.resize(slRecordCntT * QCAN_FRAME_ARRAY_SIZE);
+      if (btIsLocalConnectionP == false)
+      {
+         sqSizeT = pclTcpSockP->read(clReadBufferP.data(), clReadBufferP.size());
+      }
+      else
+      {
+         sqSizeT = pclLocalSockP->read(clReadBufferP.data(), clReadBufferP.size());
+      }
+
+      if (sqSizeT < 0)
+      {
+         sqSizeT = 0;
+      }
+      slRecordCntT = (int32_t) (sqSizeT / QCAN_FRAME_ARRAY_SIZE);
+      pubBufferT   = (const uint8_t *) clReadBufferP.constData();
+   }
+
+   //----------------------------------------------------------------
+   // convert the records in a tight loop
+   //
+   clFrameListR.reserve(clFrameListR.size() + slRecordCntT);
+   for (slRecordIdxT = 0; slRecordIdxT < slRecordCntT; slRecordIdxT++)
+   {
+      pubRecordT = pubBufferT + (slRecordIdxT * QCAN_FRAME_ARRAY_SIZE);
+      teChannelT = eCAN_CHANNEL_NONE;
+
+      //--------------------------------------------------------
+      // a control record of a single network is evaluated
+      //
+      if ((btIsMultiplexedP == false) && (btIsMulticastP == false) && (pubRecordT[QCAN_RECORD_TYPE_POS] != 0))
+      {
+         handleRecord(QByteArray::fromRawData((const char *) pubRecordT, QCAN_FRAME_ARRAY_SIZE));
+         continue;
+      }
+
+      //--------------------------------------------------------
+      // the CAN channel of a multiplexed connection is removed,
+      // it is not part of the checksum
+      //
+      if (btIsMultiplexedP == true)
+      {
+         memcpy(&aubRecordT[0], pubRecordT, QCAN_FRAME_ARRAY_SIZE);
+         teChannelT = (CAN_Channel_e) aubRecordT[QCAN_MUX_CHANNEL_POS];
+         aubRecordT[QCAN_MUX_CHANNEL_POS] = 0;
+         pubRecordT = &aubRecordT[0];
+      }
+
+      if (clFrameT.fromBuffer(pubRecordT) == true)
+      {
+         if (clFrameT.frameType() == QCanFrame::eFRAME_TYPE_ERROR)
+         {
+            teCanStateP = clFrameT.errorState();
+         }
+
+         clFrameListR.append(clFrameT);
+         if (pclChannelListV != Q_NULLPTR)
+         {
+            pclChannelListV->append(teChannelT);
+         }
+         slFrameCntT++;
+      }
+   }
+
+   if (btIsMulticastP == true)
+   {
+      mcastRelease(slRecordCntT * QCAN_FRAME_ARRAY_SIZE);
+   }
+
+   return (slFrameCntT);
+}
+
+
+//----------------------------------------------------------------------------//
+// readBlocking()                                                             //
+// wait for a frame and read it                                               //
+//----------------------------------------------------------------------------//
+bool QCanSocket::readBlocking(QCanFrame & clFrameR, int32_t slMilliSecsV)
+{
+   QElapsedTimer  clTimerT;
+   int32_t        slRemainT;
+
+   clTimerT.start();
+   for (;;)
+   {
+      if (read(clFrameR) == true)
+      {
+         return (true);
+      }
+
+      //--------------------------------------------------------
+      // a control record does not count as frame, wait again
+      // for the remaining time
+      //
+      slRemainT = slMilliSecsV - (int32_t) clTimerT.elapsed();
+      if ((slRemainT <= 0) || (waitForFrames(slRemainT) == false))
+      {
+         return (false);
+      }
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// readFrames()                                                               //
+// read all available frames                                                  //
+//----------------------------------------------------------------------------//
+int32_t QCanSocket::readFrames(QVector<QCanFrame> & clFrameListR, int32_t slFrameMaxV)
+{
+   return (readBuffer(clFrameListR, Q_NULLPTR, slFrameMaxV));
+}
+
+
+//----------------------------------------------------------------------------//
+// readFrames()                                                               //
+// read all available frames and CAN channels                                 //
+//----------------------------------------------------------------------------//
+int32_t QCanSocket::readFrames(QVector<QCanFrame> & clFrameListR, QVector<CAN_Channel_e> & clChannelListR,
+                               int32_t slFrameMaxV)
+{
+   return (readBuffer(clFrameListR, &clChannelListR, slFrameMaxV));
+}
+
+
+//----------------------------------------------------------------------------//
+// requestCyclicStatus()                                                      //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool QCanSocket::requestCyclicStatus(void)
+{
+   return (writeCyclic(QCAN_CYCLIC_STATUS, 0, QCanFrame()));
+}
+
+
+//----------------------------------------------------------------------------//
+// requestSnapshot()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool QCanSocket::requestSnapshot(void)
+{
+   bool  btResultT = true;
+
+   if ((btIsMultiplexedP == true) || (btIsMulticastP == true))
+   {
+      return (false);
+   }
+
+   if (btIsConnectedP == true)
+   {
+      btResultT = writeRecord(QCAN_RECORD_SNAPSHOT);
+   }
+   else
+   {
+      btSnapshotPendingP = true;
+   }
+
+   return (btResultT);
+}
+
+
+//----------------------------------------------------------------------------//
+// setCyclicFrame()                                                           //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool QCanSocket::setCyclicFrame(uint16_t uwHandleV, const QCanFrame & clFrameR, uint32_t ulPeriodV,
+                                uint8_t ubCounterPosV, uint8_t ubCounterSizeV)
+{
+   return (writeCyclic(QCAN_CYCLIC_SET, uwHandleV, clFrameR, ulPeriodV, ubCounterPosV, ubCounterSizeV));
+}
+
+
 //----------------------------------------------------------------------------//
 // setHostAddress()                                                           //
 //                                                                            //
@@ -496,33 +1113,190 @@ void QCanSocket::setHostAddress(QHostAddress clHostAddressV)
    }
 }
 
+
+//----------------------------------------------------------------------------//
+// setSubscription()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool QCanSocket::setSubscription(bool btChangeOnlyV, uint32_t ulRateMaxV,
+                                 uint32_t ulKeepAliveV)
+{
+   bool  btResultT = true;
+
+   //----------------------------------------------------------------
+   // a subscription is evaluated by a single network
+   //
+   if ((btIsMultiplexedP == true) || (btIsMulticastP == true))
+   {
+      return (false);
+   }
+
+   btSubChangeOnlyP = btChangeOnlyV;
+   ulSubRateMaxP    = ulRateMaxV;
+   ulSubKeepAliveP  = ulKeepAliveV;
+
+   if (btIsConnectedP == true)
+   {
+      btResultT = writeSubscription();
+   }
+
+   return (btResultT);
+}
+
+//----------------------------------------------------------------------------//
+// waitForFrames()                                                            //
+// wait for frames without an event loop                                      //
+//----------------------------------------------------------------------------//
+bool QCanSocket::waitForFrames(int32_t slMilliSecsV)
+{
+   QElapsedTimer  clTimerT;
+   int32_t        slRemainT;
+   bool           btReadyT;
+
+   clTimerT.start();
+   while (framesAvailable() == 0)
+   {
+      slRemainT = slMilliSecsV - (int32_t) clTimerT.elapsed();
+      if ((btIsConnectedP == false) || (slRemainT <= 0))
+      {
+         return (false);
+      }
+
+      //--------------------------------------------------------
+      // the socket emits readyRead() before the function returns,
+      // a UDP datagram is unpacked by onSocketReceiveMulticast()
+      //
+      if (btIsMulticastP == true)
+      {
+         btReadyT = pclUdpSockP->waitForReadyRead(slRemainT);
+      }
+      else if (btIsLocalConnectionP == false)
+      {
+         btReadyT = pclTcpSockP->waitForReadyRead(slRemainT);
+      }
+      else
+      {
+         btReadyT = pclLocalSockP->waitForReadyRead(slRemainT);
+      }
+
+      if (btReadyT == false)
+      {
+         break;
+      }
+   }
+
+   return (framesAvailable() > 0);
+}
+
+
 //----------------------------------------------------------------------------//
-// writeFrame()                                                               //
+// write()                                                                    //
 //                                                                            //
 //----------------------------------------------------------------------------//
 bool QCanSocket::write(const QCanFrame & clFrameR)
 {
    bool  btResultT = false;
 
-   if(btIsConnectedP == true)
+   //----------------------------------------------------------------
+   // the CAN channel is required on a multiplexed connection
+   //
+   if ((btIsConnectedP == true) && (btIsMultiplexedP == false))
+   {
+      btResultT = writeDatagram(clFrameR.toByteArray());
+   }
+
+   return(btResultT);
+}
+
+
+//----------------------------------------------------------------------------//
+// write()                                                                    //
+// write CAN frame to a CAN channel of a multiplexed connection               //
+//----------------------------------------------------------------------------//
+bool QCanSocket::write(const QCanFrame & clFrameR, CAN_Channel_e teChannelV)
+{
+   bool  btResultT = false;
+
+   if ((btIsConnectedP == true) && (btIsMultiplexedP == true) &&
+       (teChannelV > eCAN_CHANNEL_NONE) &&
+       ((ulChannelMaskP & (((uint32_t) 1) << (teChannelV - 1))) > 0))
    {
       QByteArray  clDatagramT = clFrameR.toByteArray();
 
-      if (btIsLocalConnectionP == false)
+      clDatagramT[QCAN_MUX_CHANNEL_POS] = (uint8_t) teChannelV;
+      btResultT = writeDatagram(clDatagramT);
+   }
+
+   return(btResultT);
+}
+
+
+//----------------------------------------------------------------------------//
+// writeCyclic()                                                              //
+// send cyclic frame record to the network                                    //
+//----------------------------------------------------------------------------//
+bool QCanSocket::writeCyclic(uint8_t ubCommandV, uint16_t uwHandleV, const QCanFrame & clFrameR,
+                             uint32_t ulPeriodV, uint8_t ubCounterPosV, uint8_t ubCounterSizeV)
+{
+   QByteArray  clRecordT;
+
+   //----------------------------------------------------------------
+   // cyclic frames are transmitted by a single network
+   //
+   if ((btIsConnectedP == false) || (btIsMultiplexedP == true) || (btIsMulticastP == true))
+   {
+      return (false);
+   }
+
+   //----------------------------------------------------------------
+   // byte 0 .. 69 hold the frame, the parameters follow
+   //
+   clRecordT = clFrameR.toByteArray();
+   clRecordT.replace(70, QCAN_FRAME_ARRAY_SIZE - 70, QByteArray(QCAN_FRAME_ARRAY_SIZE - 70, 0x00));
+   clRecordT[70] = ubCommandV;
+   clRecordT[72] = (uint8_t) (uwHandleV >>  8);
+   clRecordT[73] = (uint8_t) (uwHandleV >>  0);
+   clRecordT[74] = (uint8_t) (ulPeriodV >> 24);
+   clRecordT[75] = (uint8_t) (ulPeriodV >> 16);
+   clRecordT[76] = (uint8_t) (ulPeriodV >>  8);
+   clRecordT[77] = (uint8_t) (ulPeriodV >>  0);
+   clRecordT[78] = ubCounterPosV;
+   clRecordT[79] = ubCounterSizeV;
+   clRecordT[QCAN_RECORD_TYPE_POS] = QCAN_RECORD_CYCLIC;
+
+   return (writeDatagram(clRecordT));
+}
+
+
+//----------------------------------------------------------------------------//
+// writeDatagram()                                                            //
+//                                                                            //
+//----------------------------------------------------------------------------//
+bool QCanSocket::writeDatagram(const QByteArray & clDatagramR)
+{
+   bool  btResultT = false;
+
+   //----------------------------------------------------------------
+   // a multicast listener can not write
+   //
+   if (btIsMulticastP == true)
+   {
+      btResultT = false;
+   }
+   else if (btIsLocalConnectionP == false)
+   {
+      if (pclTcpSockP->write(clDatagramR) == QCAN_FRAME_ARRAY_SIZE)
       {
-         if (pclTcpSockP->write(clDatagramT) == QCAN_FRAME_ARRAY_SIZE)
-         {
-            pclTcpSockP->flush();
-            btResultT = true;
-         }
+         pclTcpSockP->flush();
+         btResultT = true;
       }
-      else
+   }
+   else
+   {
+      if (pclLocalSockP->write(clDatagramR) == QCAN_FRAME_ARRAY_SIZE)
       {
-         if (pclLocalSockP->write(clDatagramT) == QCAN_FRAME_ARRAY_SIZE)
-         {
-            pclLocalSockP->flush();
-            btResultT = true;
-         }
+         pclLocalSockP->flush();
+         btResultT = true;
       }
    }
 
@@ -530,3 +1304,113 @@ bool QCanSocket::write(const QCanFrame & clFrameR)
 }
 
 
+//----------------------------------------------------------------------------//
+// writeQueued()                                                              //
+// append frame to the write queue, thread-safe                               //
+//----------------------------------------------------------------------------//
+void QCanSocket::writeQueued(const QCanFrame & clFrameR)
+{
+   bool  btInvokeT;
+
+   //----------------------------------------------------------------
+   // only the first frame of a queue triggers the thread of the
+   // socket, following frames are written with it
+   //
+   clWriteQueueMutexP.lock();
+   clWriteQueueP.append(clFrameR);
+   btInvokeT      = (btWriteQueuedP == false);
+   btWriteQueuedP = true;
+   clWriteQueueMutexP.unlock();
+
+   if (btInvokeT)
+   {
+      QMetaObject::invokeMethod(this, "onWriteQueue", Qt::QueuedConnection);
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// writeRecord()                                                              //
+// send control record without parameters to the network                      //
+//----------------------------------------------------------------------------//
+bool QCanSocket::writeRecord(uint8_t ubTypeV)
+{
+   QByteArray  clRecordT(QCAN_FRAME_ARRAY_SIZE, 0x00);
+
+   clRecordT[QCAN_RECORD_TYPE_POS] = ubTypeV;
+
+   return (writeDatagram(clRecordT));
+}
+
+
+//----------------------------------------------------------------------------//
+// writeFrames()                                                              //
+// write a block of frames with a single call                                 //
+//----------------------------------------------------------------------------//
+int32_t QCanSocket::writeFrames(const QCanFrame * pclFrameV, int32_t slFrameCntV)
+{
+   uint8_t *   pubBufferT;
+   int32_t     slFrameIdxT;
+   qint64      sqSizeT;
+
+   //----------------------------------------------------------------
+   // the CAN channel is required on a multiplexed connection, a
+   // multicast listener can not write
+   //
+   if ((btIsConnectedP == false) || (btIsMultiplexedP == true) || (btIsMulticastP == true) ||
+       (pclFrameV == Q_NULLPTR)  || (slFrameCntV <= 0))
+   {
+      return (0);
+   }
+
+   clWriteBufferP.resize(slFrameCntV * QCAN_FRAME_ARRAY_SIZE);
+   pubBufferT = (uint8_t *) clWriteBufferP.data();
+   for (slFrameIdxT = 0; slFrameIdxT < slFrameCntV; slFrameIdxT++)
+   {
+      pclFrameV[slFrameIdxT].toBuffer(pubBufferT + (slFrameIdxT * QCAN_FRAME_ARRAY_SIZE));
+   }
+
+   if (btIsLocalConnectionP == false)
+   {
+      sqSizeT = pclTcpSockP->write(clWriteBufferP);
+      pclTcpSockP->flush();
+   }
+   else
+   {
+      sqSizeT = pclLocalSockP->write(clWriteBufferP);
+      pclLocalSockP->flush();
+   }
+
+   if (sqSizeT < 0)
+   {
+      sqSizeT = 0;
+   }
+
+   return ((int32_t) (sqSizeT / QCAN_FRAME_ARRAY_SIZE));
+}
+
+
+//----------------------------------------------------------------------------//
+// writeSubscription()                                                        //
+// send subscription record to the network                                    //
+//----------------------------------------------------------------------------//
+bool QCanSocket::writeSubscription(void)
+{
+   QByteArray  clRecordT(QCAN_FRAME_ARRAY_SIZE, 0x00);
+
+   if (btSubChangeOnlyP == true)
+   {
+      clRecordT[0] = QCAN_SUBSCRIBE_CHANGE;
+   }
+   clRecordT[4]  = (uint8_t) (ulSubRateMaxP >> 24);
+   clRecordT[5]  = (uint8_t) (ulSubRateMaxP >> 16);
+   clRecordT[6]  = (uint8_t) (ulSubRateMaxP >>  8);
+   clRecordT[7]  = (uint8_t) (ulSubRateMaxP >>  0);
+   clRecordT[8]  = (uint8_t) (ulSubKeepAliveP >> 24);
+   clRecordT[9]  = (uint8_t) (ulSubKeepAliveP >> 16);
+   clRecordT[10] = (uint8_t) (ulSubKeepAliveP >>  8);
+   clRecordT[11] = (uint8_t) (ulSubKeepAliveP >>  0);
+   clRecordT[QCAN_RECORD_TYPE_POS] = QCAN_RECORD_SUBSCRIPTION;
+
+   return (writeDatagram(clRecordT));
+}
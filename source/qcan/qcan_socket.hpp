@@ -33,12 +33,16 @@
 
 
 #include <QtCore/QString>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
 #include <QtCore/QVector>
 #include <QtCore/QPointer>
 
 #include <QtNetwork/QHostAddress>
 #include <QtNetwork/QLocalSocket>
 #include <QtNetwork/QTcpSocket>
+#include <QtNetwork/QUdpSocket>
 
 #include "qcan_defs.hpp"
 #include "qcan_frame.hpp"
@@ -51,10 +55,27 @@
 ** \brief CAN socket
 ** 
 ** A QCanSocket is used for connection to an existing QCanNetwork. The number of sockets that can be connected
-** to a QCanNetwork is limited by the symbol #QCAN_TCP_SOCKET_MAX during compile time.
+** to a QCanNetwork is limited by QCanNetwork::setSocketMax(), the default value is #QCAN_TCP_SOCKET_MAX.
 **
 ** Upon creation, the socket is in an unconnected state. The current socket state can be evaluated with
 ** isConnected() and error(). Each CAN socket has an unique identifier for socket management (uuidString()).
+** <p>
+** A socket connected with connectNetworks() uses a single connection for several CAN networks (see
+** QCanMultiplexer). The CAN channel of a frame is passed by read(QCanFrame &, CAN_Channel_e &) and
+** write(const QCanFrame &, CAN_Channel_e).
+** <p>
+** A socket connected with connectMulticast() is a passive listener, which receives the frames of a network
+** by UDP multicast. Such a socket can not write frames.
+** <p>
+** An application receiving a high number of frames should use readFrames() and writeFrames(), which transfer
+** a block of frames with a single call.
+** <p>
+** A socket can be used by a thread without an event loop: connectNetwork() with a timeout, waitForFrames() and
+** readBlocking() do not require one. writeQueued() can be called by any thread, the frames are written by the
+** thread of the socket (see QCanSocketThread).
+** <p>
+** Cyclic frames are transmitted by the scheduler of the network (see QCanScheduler), a frame is registered with
+** setCyclicFrame() and stopped with cancelCyclicFrame() or by disconnection of the socket.
 **
 */
 
@@ -93,6 +114,47 @@ public:
    bool connectNetwork(CAN_Channel_e teChannelV, const int32_t slMilliSecsV = 0);
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clChannelListR List of CAN channels
+   ** \param[in]  slMilliSecsV   Time to wait for connection
+   ** \return     \c true if connection is possible
+   ** \see        connectNetwork()
+   **
+   ** Connect the CAN socket to all CAN networks of \a clChannelListR using a single multiplexed
+   ** connection. Frames are received from all these networks, the CAN channel of a frame is evaluated
+   ** by read(QCanFrame &, CAN_Channel_e &). A frame is transmitted by
+   ** write(const QCanFrame &, CAN_Channel_e). The method returns \c false if the socket is already
+   ** connected or if the list holds no valid CAN channel.
+   */
+   bool connectNetworks(const QList<CAN_Channel_e> & clChannelListR, const int32_t slMilliSecsV = 0);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  teChannelV     CAN channel
+   ** \param[in]  clGroupV       Multicast group address
+   ** \return     \c true if the socket has joined the multicast group
+   ** \see        QCanNetwork::setMulticastEnabled(), datagramsLost()
+   **
+   ** Connect the CAN socket as passive listener to the UDP multicast publisher of a CAN network. The
+   ** socket receives all frames of the network, writing frames is not possible. Lost datagrams are
+   ** detected by the sequence number of the datagram and counted by datagramsLost().
+   */
+   bool connectMulticast(CAN_Channel_e teChannelV,
+                         QHostAddress clGroupV = QHostAddress(QString(QCAN_MCAST_ADDRESS)));
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of lost datagrams
+   ** \see        connectMulticast()
+   **
+   ** The function returns the number of datagrams which have been lost on a multicast connection.
+   */
+   uint32_t datagramsLost(void) const     { return (ulMcastLostP); };
+
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \see  connectNetwork()
@@ -149,6 +211,88 @@ public:
    QString  uuidString(void);
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true if the request has been accepted
+   ** \see        QCanNetwork::setValueCacheEnabled()
+   **
+   ** Request the last frame of each identifier from the last value cache of the CAN network. The
+   ** frames are received like all other frames, they carry the time stamp of their original
+   ** reception. If the socket is not connected yet, the request is sent on connection. A request is
+   ** not supported by a multiplexed or multicast connection.
+   */
+   bool  requestSnapshot(void);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  uwHandleV      Handle of cyclic frame
+   ** \param[in]  clFrameR       Payload pattern
+   ** \return     \c true if the request has been sent
+   ** \see        setCyclicFrame()
+   **
+   ** Append the payload of \a clFrameR to the pattern list of the cyclic frame \a uwHandleV. The payload
+   ** of the frame passed to setCyclicFrame() is the first entry of the list, each transmission selects
+   ** the next entry (see QCanScheduler::appendPattern()).
+   */
+   bool  appendCyclicPattern(uint16_t uwHandleV, const QCanFrame & clFrameR);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  uwHandleV      Handle of cyclic frame
+   ** \return     \c true if the request has been sent
+   ** \see        setCyclicFrame()
+   **
+   ** Stop the transmission of the cyclic frame \a uwHandleV.
+   */
+   bool  cancelCyclicFrame(uint16_t uwHandleV);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  uwHandleV      Handle of cyclic frame
+   ** \param[out] tsStatusR      Status of cyclic frame
+   ** \return     \c true if a status has been received for the cyclic frame
+   ** \see        requestCyclicStatus()
+   **
+   ** The function returns the last status of the cyclic frame \a uwHandleV, i.e. the number of
+   ** transmissions and the achieved jitter.
+   */
+   bool  cyclicStatus(uint16_t uwHandleV, CyclicStatus_ts & tsStatusR) const;
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true if the request has been sent
+   ** \see        cyclicStatus()
+   **
+   ** Request the status of all cyclic frames of the socket from the network. The answer of the network
+   ** is evaluated by read(), which stores the status for cyclicStatus().
+   */
+   bool  requestCyclicStatus(void);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  uwHandleV      Handle of cyclic frame
+   ** \param[in]  clFrameR       CAN frame
+   ** \param[in]  ulPeriodV      Period in micro-seconds
+   ** \param[in]  ubCounterPosV  Position of payload counter
+   ** \param[in]  ubCounterSizeV Size of payload counter in bytes, 0 for no counter
+   ** \return     \c true if the request has been sent
+   ** \see        cancelCyclicFrame()
+   **
+   ** Transmit the CAN frame \a clFrameR with the period \a ulPeriodV by the scheduler of the network.
+   ** The handle \a uwHandleV is selected by the application, a frame with an existing handle is
+   ** updated. A payload counter of 1 to 4 bytes at \a ubCounterPosV is incremented after each
+   ** transmission (LSB first). The request is not supported by a multiplexed or multicast connection,
+   ** the socket must be connected.
+   */
+   bool  setCyclicFrame(uint16_t uwHandleV, const QCanFrame & clFrameR, uint32_t ulPeriodV,
+                        uint8_t ubCounterPosV = 0, uint8_t ubCounterSizeV = 0);
+
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \param[in]  clHostAddressV    Host address
@@ -160,6 +304,28 @@ public:
    void  setHostAddress(QHostAddress clHostAddressV);
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  btChangeOnlyV  Receive frames with changed payload only
+   ** \param[in]  ulRateMaxV     Maximum number of frames per second and identifier
+   ** \param[in]  ulKeepAliveV   Keep-alive time in milli-seconds
+   ** \return     \c true if the subscription has been accepted
+   **
+   ** The subscription restricts the frames which are sent by the CAN network to the socket, it is
+   ** evaluated by the network for every identifier. If \a btChangeOnlyV is \c true, a frame is only
+   ** received if its payload differs from the last frame of the identifier which has been received.
+   ** A frame with an unchanged payload is received when the last frame of the identifier is older
+   ** than \a ulKeepAliveV milli-seconds, a value of 0 disables the keep-alive. A value of \a ulRateMaxV
+   ** other than 0 limits the number of frames per identifier, the following frames are received when
+   ** the interval has elapsed. Error frames are always received.
+   ** <p>
+   ** Calling the function with \a btChangeOnlyV set to \c false and \a ulRateMaxV set to 0 removes the
+   ** subscription. The subscription can be set before and after connectNetwork(), it is not
+   ** supported by a multiplexed or multicast connection.
+   */
+   bool  setSubscription(bool btChangeOnlyV, uint32_t ulRateMaxV = 0, uint32_t ulKeepAliveV = 0);
+
+
    //---------------------------------------------------------------------------------------------------
    /*!
    ** \return  CAN error state
@@ -176,10 +342,69 @@ public:
    ** \see           write()
    **
    ** The function reads a CAN frame from the socket and places the result in \a clFrameDataR. If no
-   ** CAN frame is available, the function returns \c false.
+   ** CAN frame is available, the function returns \c false. Control records of the network (e.g. the
+   ** answer to requestCyclicStatus()) are evaluated and skipped.
    */
    bool  read(QCanFrame & clFrameR);
 
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[out]    clFrameR    Reference to CAN frame
+   ** \param[out]    teChannelR  CAN channel of the frame
+   ** \return        \c true if CAN frame was read
+   ** \see           connectNetworks()
+   **
+   ** The function reads a CAN frame from the socket and places the result in \a clFrameR, the CAN
+   ** channel of a multiplexed connection is placed in \a teChannelR. For a socket which is connected
+   ** to a single network the value of \a teChannelR is eCAN_CHANNEL_NONE.
+   */
+   bool  read(QCanFrame & clFrameR, CAN_Channel_e & teChannelR);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[out]    clFrameListR   List of CAN frames
+   ** \param[in]     slFrameMaxV    Maximum number of frames, -1 reads all available frames
+   ** \return        Number of CAN frames appended to \a clFrameListR
+   ** \see           writeFrames()
+   **
+   ** The function reads all available CAN frames from the socket with a single call and appends them
+   ** to \a clFrameListR. In contrast to a loop of read() calls the data is not copied frame by frame,
+   ** which reduces the CPU load of an application receiving a high number of frames. Control records
+   ** of the network are evaluated and skipped.
+   */
+   int32_t  readFrames(QVector<QCanFrame> & clFrameListR, int32_t slFrameMaxV = -1);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[out]    clFrameListR   List of CAN frames
+   ** \param[out]    clChannelListR List of CAN channels
+   ** \param[in]     slFrameMaxV    Maximum number of frames, -1 reads all available frames
+   ** \return        Number of CAN frames appended to \a clFrameListR
+   ** \see           connectNetworks()
+   **
+   ** The function works like readFrames(QVector<QCanFrame> &, int32_t), the CAN channel of each frame
+   ** of a multiplexed connection is appended to \a clChannelListR.
+   */
+   int32_t  readFrames(QVector<QCanFrame> & clFrameListR, QVector<CAN_Channel_e> & clChannelListR,
+                       int32_t slFrameMaxV = -1);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[out]    clFrameR       Reference to CAN frame
+   ** \param[in]     slMilliSecsV   Timeout in milli-seconds
+   ** \return        \c true if CAN frame was read
+   ** \see           waitForFrames()
+   **
+   ** The function waits up to \a slMilliSecsV milli-seconds for a CAN frame and reads it like
+   ** read(QCanFrame &). It does not require an event loop, it must be called by the thread of the
+   ** socket.
+   */
+   bool  readBlocking(QCanFrame & clFrameR, int32_t slMilliSecsV);
+
    
    //---------------------------------------------------------------------------------------------------
    /*!
@@ -188,11 +413,76 @@ public:
    ** \see  readFrame()
    **
    ** The function writes the CAN frame \a clFrameR to the CAN socket. If writing fails, the function
-   ** returns \c false.
+   ** returns \c false. On a multiplexed connection the function returns \c false, the CAN channel
+   ** has to be passed by write(const QCanFrame &, CAN_Channel_e).
    */
    bool  write(const QCanFrame & clFrameR);
 
 
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameR       Reference to CAN frame
+   ** \param[in]  teChannelV     CAN channel
+   ** \return     \c true if CAN frame was written
+   ** \see        connectNetworks()
+   **
+   ** The function writes the CAN frame \a clFrameR to the CAN network \a teChannelV of a multiplexed
+   ** connection. The function returns \c false if the CAN channel has not been passed to
+   ** connectNetworks().
+   */
+   bool  write(const QCanFrame & clFrameR, CAN_Channel_e teChannelV);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclFrameV      Pointer to array of CAN frames
+   ** \param[in]  slFrameCntV    Number of CAN frames
+   ** \return     Number of CAN frames written
+   ** \see        readFrames()
+   **
+   ** The function writes \a slFrameCntV CAN frames to the CAN socket with a single call. On a
+   ** multiplexed connection the function returns 0, like write(const QCanFrame &).
+   */
+   int32_t  writeFrames(const QCanFrame * pclFrameV, int32_t slFrameCntV);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameListR   List of CAN frames
+   ** \return     Number of CAN frames written
+   **
+   ** The function writes all CAN frames of \a clFrameListR to the CAN socket with a single call.
+   */
+   inline int32_t writeFrames(const QVector<QCanFrame> & clFrameListR)
+   {
+      return (writeFrames(clFrameListR.constData(), clFrameListR.size()));
+   };
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameR       Reference to CAN frame
+   ** \see        write()
+   **
+   ** The function can be called by any thread. The CAN frame \a clFrameR is appended to a queue, all
+   ** frames of the queue are written by writeFrames() inside the event loop of the thread of the
+   ** socket.
+   */
+   void  writeQueued(const QCanFrame & clFrameR);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slMilliSecsV   Timeout in milli-seconds
+   ** \return     \c true if CAN frames are available
+   ** \see        readBlocking()
+   **
+   ** The function blocks until CAN frames are available for reading or \a slMilliSecsV milli-seconds
+   ** have passed. It does not require an event loop, it must be called by the thread of the socket.
+   */
+   bool  waitForFrames(int32_t slMilliSecsV);
+
+
 public slots:
 
 
@@ -235,12 +525,66 @@ protected:
 
 private:
 
+   bool  connectServer(const QString & clServerNameR, uint16_t uwPortV, const int32_t slMilliSecsV);
+   void  handleRecord(const QByteArray & clRecordR);
+   void  mcastRelease(int32_t slSizeV);
+   int32_t  readBuffer(QVector<QCanFrame> & clFrameListR, QVector<CAN_Channel_e> * pclChannelListV,
+                       int32_t slFrameMaxV);
+   bool  writeCyclic(uint8_t ubCommandV, uint16_t uwHandleV, const QCanFrame & clFrameR,
+                     uint32_t ulPeriodV = 0, uint8_t ubCounterPosV = 0, uint8_t ubCounterSizeV = 0);
+   bool  writeDatagram(const QByteArray & clDatagramR);
+   bool  writeRecord(uint8_t ubTypeV);
+   bool  writeSubscription(void);
+
    QPointer<QLocalSocket>  pclLocalSockP;
    QPointer<QTcpSocket>    pclTcpSockP;
    QHostAddress            clTcpHostAddrP;
    uint16_t                uwTcpPortP;
    bool                    btIsConnectedP;
    bool                    btIsLocalConnectionP;
+   bool                    btIsMultiplexedP;
+   uint32_t                ulChannelMaskP;
+
+   //----------------------------------------------------------------
+   // buffers of readFrames() and writeFrames(), they are kept to
+   // avoid a memory allocation for each call
+   //
+   QByteArray              clReadBufferP;
+   QByteArray              clWriteBufferP;
+
+   //----------------------------------------------------------------
+   // frames of writeQueued(), the queue is protected by the mutex
+   //
+   QMutex                  clWriteQueueMutexP;
+   QVector<QCanFrame>      clWriteQueueP;
+   bool                    btWriteQueuedP;
+
+   //----------------------------------------------------------------
+   // subscription, it is sent to the network on connection
+   //
+   bool                    btSubChangeOnlyP;
+   uint32_t                ulSubRateMaxP;
+   uint32_t                ulSubKeepAliveP;
+   bool                    btSnapshotPendingP;
+
+   //----------------------------------------------------------------
+   // status of cyclic frames, see requestCyclicStatus()
+   //
+   QHash<uint16_t, CyclicStatus_ts> clCyclicStatusP;
+
+   //----------------------------------------------------------------
+   // UDP multicast listener: received frames are stored in
+   // clMcastFramesP, frames before slMcastReadPosP have been read
+   //
+   QPointer<QUdpSocket>    pclUdpSockP;
+   QHostAddress            clMcastGroupP;
+   QByteArray              clMcastFramesP;
+   int32_t                 slMcastReadPosP;
+   uint8_t                 ubMcastChannelP;
+   uint32_t                ulMcastSequenceP;
+   uint32_t                ulMcastLostP;
+   bool                    btIsMulticastP;
+   bool                    btMcastSequenceValidP;
    int32_t                 slSocketErrorP;
    CAN_State_e             teCanStateP;
 
@@ -250,6 +594,8 @@ private slots:
    void           onSocketErrorLocal(QLocalSocket::LocalSocketError teSocketErrorV);
    void           onSocketErrorTcp(QAbstractSocket::SocketError teSocketErrorV);
    virtual void   onSocketReceive(void);
+   void           onSocketReceiveMulticast(void);
+   void           onWriteQueue(void);
 };
 
 #endif   // QCAN_SOCKET_HPP_
@@ -0,0 +1,231 @@
+//====================================================================================================================//
+// File:          qcan_socket_thread.cpp                                                                              //
+// Description:   QCAN classes - CAN socket thread                                                                    //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#include "qcan_socket_thread.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class methods                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSocketThread()                                                                                                 //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanSocketThread::QCanSocketThread(QObject * pclParentV)
+   : QThread(pclParentV)
+{
+   teChannelP     = eCAN_CHANNEL_NONE;
+   slConnectTimeP = 0;
+   slConnectedP.storeRelease(0);
+   pclSocketP     = Q_NULLPTR;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// ~QCanSocketThread()                                                                                                //
+// destructor                                                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanSocketThread::~QCanSocketThread()
+{
+   disconnectNetwork();
+
+   qDeleteAll(clQueueListP);
+   clQueueListP.clear();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSocketThread::connectNetwork()                                                                                 //
+// start thread and connect to CAN network                                                                            //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanSocketThread::connectNetwork(CAN_Channel_e teChannelV, const int32_t slMilliSecsV)
+{
+   if (isRunning() == true)
+   {
+      return (false);
+   }
+
+   teChannelP     = teChannelV;
+   slConnectTimeP = slMilliSecsV;
+   start(QThread::TimeCriticalPriority);
+
+   //---------------------------------------------------------------------------------------------------
+   // wait for the result of the connection
+   //
+   clConnectDoneP.acquire();
+
+   return (isConnected());
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSocketThread::createQueue()                                                                                    //
+// create queue for a consumer thread                                                                                 //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanFrameQueue * QCanSocketThread::createQueue(uint32_t ulSizeV)
+{
+   QCanFrameQueue * pclQueueT = new QCanFrameQueue(ulSizeV);
+
+   clQueueMutexP.lock();
+   clQueueListP.append(pclQueueT);
+   clQueueMutexP.unlock();
+
+   return (pclQueueT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSocketThread::disconnectNetwork()                                                                              //
+// stop the event loop of the thread                                                                                  //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanSocketThread::disconnectNetwork(void)
+{
+   if (isRunning() == true)
+   {
+      quit();
+      wait();
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSocketThread::onSocketReceive()                                                                                //
+// distribute frames, executed by the socket thread                                                                   //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanSocketThread::onSocketReceive(void)
+{
+   int32_t           slFrameIdxT;
+   QCanFrameQueue *  pclQueueT;
+
+   clFrameListP.clear();
+   if (pclSocketP->readFrames(clFrameListP) == 0)
+   {
+      return;
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // the mutex is only taken once for a block of frames, appending to a queue does not block
+   //
+   clQueueMutexP.lock();
+   foreach (pclQueueT, clQueueListP)
+   {
+      for (slFrameIdxT = 0; slFrameIdxT < clFrameListP.size(); slFrameIdxT++)
+      {
+         pclQueueT->append(clFrameListP.at(slFrameIdxT));
+      }
+   }
+   clQueueMutexP.unlock();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSocketThread::removeQueue()                                                                                    //
+// remove queue of a consumer thread                                                                                  //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanSocketThread::removeQueue(QCanFrameQueue * pclQueueV)
+{
+   clQueueMutexP.lock();
+   if (clQueueListP.removeOne(pclQueueV) == true)
+   {
+      delete (pclQueueV);
+   }
+   clQueueMutexP.unlock();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSocketThread::run()                                                                                            //
+// socket thread                                                                                                      //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanSocketThread::run(void)
+{
+   QCanSocket  clSocketT;
+
+   //---------------------------------------------------------------------------------------------------
+   // the slots are executed by this thread, a disconnection stops the event loop
+   //
+   connect(&clSocketT, SIGNAL(framesReceived(uint32_t)),
+           this,       SLOT(onSocketReceive()), Qt::DirectConnection);
+   connect(&clSocketT, SIGNAL(disconnected()),
+           this,       SLOT(quit()), Qt::DirectConnection);
+
+   if (clSocketT.connectNetwork(teChannelP, slConnectTimeP) == true)
+   {
+      clSocketMutexP.lock();
+      pclSocketP = &clSocketT;
+      clSocketMutexP.unlock();
+      slConnectedP.storeRelease(1);
+   }
+   clConnectDoneP.release();
+
+   if (isConnected() == true)
+   {
+      exec();
+
+      slConnectedP.storeRelease(0);
+      clSocketMutexP.lock();
+      pclSocketP = Q_NULLPTR;
+      clSocketMutexP.unlock();
+   }
+
+   clSocketT.disconnectNetwork();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanSocketThread::write()                                                                                          //
+// write frame, thread-safe                                                                                           //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanSocketThread::write(const QCanFrame & clFrameR)
+{
+   bool  btResultT = false;
+
+   clSocketMutexP.lock();
+   if (pclSocketP != Q_NULLPTR)
+   {
+      pclSocketP->writeQueued(clFrameR);
+      btResultT = true;
+   }
+   clSocketMutexP.unlock();
+
+   return (btResultT);
+}
+
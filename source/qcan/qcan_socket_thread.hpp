@@ -0,0 +1,186 @@
+//====================================================================================================================//
+// File:          qcan_socket_thread.hpp                                                                              //
+// Description:   QCAN classes - CAN socket thread                                                                    //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+#ifndef QCAN_SOCKET_THREAD_HPP_
+#define QCAN_SOCKET_THREAD_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QAtomicInteger>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+#include "qcan_frame_queue.hpp"
+#include "qcan_socket.hpp"
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanSocketThread
+** \brief CAN socket for worker threads
+**
+** A QCanSocketThread runs a QCanSocket with an event loop in its own thread, so threads without an event loop
+** (e.g. a \c std::thread) can exchange CAN frames with a network. Each consumer thread creates its own
+** QCanFrameQueue by createQueue(), every received CAN frame is appended to all queues. A consumer waits for
+** frames by QCanFrameQueue::waitForFrames() or QCanFrameQueue::readBlocking(). The function write() can be
+** called by any thread.
+** \code
+** QCanSocketThread  clSocketT;
+** QCanFrameQueue *  pclQueueT;
+** QCanFrame         clFrameT;
+**
+** pclQueueT = clSocketT.createQueue();
+** clSocketT.connectNetwork(eCAN_CHANNEL_1, 1000);
+** if (pclQueueT->readBlocking(clFrameT, 100) == true)
+** {
+**    clSocketT.write(clFrameT);
+** }
+** \endcode
+*/
+class QCanSocketThread : public QThread
+{
+   Q_OBJECT
+
+public:
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclParentV     Pointer to parent
+   **
+   ** Create a new socket thread, the thread is started by connectNetwork().
+   */
+   QCanSocketThread(QObject * pclParentV = Q_NULLPTR);
+
+   ~QCanSocketThread();
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  teChannelV     CAN channel
+   ** \param[in]  slMilliSecsV   Timeout in milli-seconds
+   ** \return     \c true if the connection has been established
+   ** \see        disconnectNetwork()
+   **
+   ** The function starts the thread, which connects the socket to the CAN network \a teChannelV. It
+   ** blocks until the connection has been established or \a slMilliSecsV milli-seconds have passed.
+   */
+   bool connectNetwork(CAN_Channel_e teChannelV, const int32_t slMilliSecsV = 1000);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ulSizeV        Number of CAN frames
+   ** \return     Pointer to frame queue
+   ** \see        removeQueue()
+   **
+   ** The function creates a queue for a consumer thread, which receives all CAN frames of the socket.
+   ** The queue is owned by the socket thread.
+   */
+   QCanFrameQueue * createQueue(uint32_t ulSizeV = QCAN_FRAME_QUEUE_SIZE);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** The function disconnects the socket and stops the thread.
+   */
+   void disconnectNetwork(void);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true if the socket is connected
+   */
+   bool isConnected(void) const        { return (slConnectedP.loadAcquire() != 0); };
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  pclQueueV      Pointer to frame queue
+   ** \see        createQueue()
+   **
+   ** The function removes and deletes the queue \a pclQueueV.
+   */
+   void removeQueue(QCanFrameQueue * pclQueueV);
+
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameR       Reference to CAN frame
+   ** \return     \c true if CAN frame was queued for writing
+   **
+   ** The function can be called by any thread, the frame is written by the socket thread (see
+   ** QCanSocket::writeQueued()). If the socket is not connected, the function returns \c false.
+   */
+   bool write(const QCanFrame & clFrameR);
+
+protected:
+
+   void run(void);
+
+private slots:
+
+   void onSocketReceive(void);
+
+private:
+
+   Q_DISABLE_COPY(QCanSocketThread)
+
+   //----------------------------------------------------------------
+   // parameters of connectNetwork(), the result of the connection
+   // is signalled by clConnectDoneP
+   //
+   CAN_Channel_e              teChannelP;
+   int32_t                    slConnectTimeP;
+   QSemaphore                 clConnectDoneP;
+   QAtomicInt                 slConnectedP;
+
+   //----------------------------------------------------------------
+   // the socket only exists while run() is executed, access from
+   // other threads is protected by the mutex
+   //
+   QMutex                     clSocketMutexP;
+   QCanSocket *               pclSocketP;
+
+   //----------------------------------------------------------------
+   // consumer queues, the list is protected by the mutex
+   //
+   QMutex                     clQueueMutexP;
+   QList<QCanFrameQueue *>    clQueueListP;
+   QVector<QCanFrame>         clFrameListP;
+};
+
+#endif   // QCAN_SOCKET_THREAD_HPP_
@@ -0,0 +1,617 @@
+//====================================================================================================================//
+// File:          qcan_trace.cpp                                                                                      //
+// Description:   QCAN classes - trace file                                                                           //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include <QtCore/QtEndian>
+
+#include "qcan_trace.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// file header: byte 0 .. 3 magic, 4 .. 7 version, 8 .. 11 frames
+// per block, 16 .. 23 number of blocks, 24 .. 31 number of frames,
+// 32 .. 39 position of index (0 if the file has not been closed)
+//
+#define  TRACE_HEADER_SIZE             64
+#define  TRACE_MAGIC                   "QCTF"
+#define  TRACE_VERSION                 ((uint32_t) 1)
+#define  TRACE_HDR_VERSION_POS         4
+#define  TRACE_HDR_BLOCK_FRAMES_POS    8
+#define  TRACE_HDR_BLOCK_COUNT_POS     16
+#define  TRACE_HDR_FRAME_COUNT_POS     24
+#define  TRACE_HDR_INDEX_POS           32
+
+//-------------------------------------------------------------------
+// largest number of frames per block accepted by the reader, a
+// header with a larger value is treated as invalid
+//
+#define  TRACE_BLOCK_FRAMES_MAX        ((uint32_t) 65536)
+
+//-------------------------------------------------------------------
+// block header: byte 0 .. 3 number of frames, 8 .. 15 time of first
+// frame and 16 .. 23 time of last frame in nanoseconds, 32 .. 95
+// bloom filter of identifiers
+//
+#define  TRACE_BLK_HEADER_SIZE         QCAN_FRAME_ARRAY_SIZE
+#define  TRACE_BLK_COUNT_POS           0
+#define  TRACE_BLK_TIME_FIRST_POS      8
+#define  TRACE_BLK_TIME_LAST_POS       16
+#define  TRACE_BLK_BLOOM_POS           32
+
+#define  TRACE_BLOCK_SIZE(FRAMES)      (TRACE_BLK_HEADER_SIZE + ((FRAMES) * QCAN_FRAME_ARRAY_SIZE))
+
+//-------------------------------------------------------------------
+// position of identifier, control field and time stamp inside a
+// frame (see QCanFrame::toByteArray())
+//
+#define  TRACE_FRM_CTRL_POS            5
+#define  TRACE_FRM_TIME_POS            70
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Static functions                                                                                                   **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// key of a data frame: identifier with bit 31 set for extended
+// frames, error frames have no key
+//
+static bool traceFrameKey(const uint8_t * pubFrameV, uint32_t & ulKeyR)
+{
+   if ((pubFrameV[0] & 0xE0) != 0)
+   {
+      return (false);
+   }
+
+   ulKeyR = qFromBigEndian<quint32>(pubFrameV) & 0x1FFFFFFF;
+   if (pubFrameV[TRACE_FRM_CTRL_POS] & 0x01)
+   {
+      ulKeyR |= 0x80000000;
+   }
+   return (true);
+}
+
+//-------------------------------------------------------------------
+// time of a frame in nanoseconds
+//
+static int64_t traceFrameTime(const uint8_t * pubFrameV)
+{
+   return (((int64_t) qFromBigEndian<quint32>(pubFrameV + TRACE_FRM_TIME_POS)) * 1000000000 +
+           qFromBigEndian<quint32>(pubFrameV + TRACE_FRM_TIME_POS + 4));
+}
+
+//-------------------------------------------------------------------
+// the bloom filter has 512 bits, every key sets two of them
+//
+static inline void traceBloomBits(uint32_t ulKeyV, uint32_t & ulBit1R, uint32_t & ulBit2R)
+{
+   ulBit1R = (ulKeyV * ((uint32_t) 0x9E3779B1)) >> 23;
+   ulBit2R = ((ulKeyV ^ (ulKeyV >> 16)) * ((uint32_t) 0x85EBCA6B)) >> 23;
+}
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class methods                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceWriter()                                                                                                  //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanTraceWriter::QCanTraceWriter()
+{
+   ulBlockFramesP = 0;
+   uqBlockCountP  = 0;
+   uqFrameCountP  = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// ~QCanTraceWriter()                                                                                                 //
+// destructor                                                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanTraceWriter::~QCanTraceWriter()
+{
+   close();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceWriter::close()                                                                                           //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanTraceWriter::close(void)
+{
+   uint8_t  aubHeaderT[TRACE_HEADER_SIZE];
+   qint64   sqIndexPosT;
+   bool     btResultT;
+
+   if (clFileP.isOpen() == false)
+   {
+      return (false);
+   }
+
+   //----------------------------------------------------------------
+   // write last block and index
+   //
+   if ((ulBlockFramesP > 0) && (writeBlock() == false))
+   {
+      return (false);
+   }
+
+   sqIndexPosT = clFileP.pos();
+   btResultT   = (clFileP.write(clIndexP) == clIndexP.size());
+
+   //----------------------------------------------------------------
+   // complete the file header
+   //
+   if (btResultT)
+   {
+      memset(aubHeaderT, 0, TRACE_HEADER_SIZE);
+      memcpy(aubHeaderT, TRACE_MAGIC, 4);
+      qToBigEndian<quint32>(TRACE_VERSION, aubHeaderT + TRACE_HDR_VERSION_POS);
+      qToBigEndian<quint32>(QCAN_TRACE_BLOCK_FRAMES, aubHeaderT + TRACE_HDR_BLOCK_FRAMES_POS);
+      qToBigEndian<quint64>(uqBlockCountP, aubHeaderT + TRACE_HDR_BLOCK_COUNT_POS);
+      qToBigEndian<quint64>(uqFrameCountP, aubHeaderT + TRACE_HDR_FRAME_COUNT_POS);
+      qToBigEndian<quint64>(sqIndexPosT, aubHeaderT + TRACE_HDR_INDEX_POS);
+
+      btResultT = clFileP.seek(0) &&
+                  (clFileP.write((const char *) aubHeaderT, TRACE_HEADER_SIZE) == TRACE_HEADER_SIZE);
+   }
+
+   if (btResultT == false)
+   {
+      clErrorStringP = clFileP.errorString();
+   }
+
+   clFileP.close();
+   clBlockP.clear();
+   clIndexP.clear();
+
+   return (btResultT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceWriter::open()                                                                                            //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanTraceWriter::open(const QString & clFileNameR)
+{
+   uint8_t  aubHeaderT[TRACE_HEADER_SIZE];
+
+   close();
+
+   clFileP.setFileName(clFileNameR);
+   if (clFileP.open(QIODevice::WriteOnly | QIODevice::Truncate) == false)
+   {
+      clErrorStringP = clFileP.errorString();
+      return (false);
+   }
+
+   //----------------------------------------------------------------
+   // the header is completed by close(), an index position of 0
+   // marks a file which has not been closed
+   //
+   memset(aubHeaderT, 0, TRACE_HEADER_SIZE);
+   memcpy(aubHeaderT, TRACE_MAGIC, 4);
+   qToBigEndian<quint32>(TRACE_VERSION, aubHeaderT + TRACE_HDR_VERSION_POS);
+   qToBigEndian<quint32>(QCAN_TRACE_BLOCK_FRAMES, aubHeaderT + TRACE_HDR_BLOCK_FRAMES_POS);
+   if (clFileP.write((const char *) aubHeaderT, TRACE_HEADER_SIZE) != TRACE_HEADER_SIZE)
+   {
+      clErrorStringP = clFileP.errorString();
+      clFileP.close();
+      return (false);
+   }
+
+   clBlockP.fill(0, TRACE_BLOCK_SIZE(QCAN_TRACE_BLOCK_FRAMES));
+   clIndexP.clear();
+   ulBlockFramesP = 0;
+   uqBlockCountP  = 0;
+   uqFrameCountP  = 0;
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceWriter::write()                                                                                           //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanTraceWriter::write(const QCanFrame & clFrameR)
+{
+   uint8_t *   pubBlockT;
+   uint8_t *   pubFrameT;
+   uint32_t    ulKeyT;
+   uint32_t    ulBit1T;
+   uint32_t    ulBit2T;
+   int64_t     sqTimeT;
+
+   if (clFileP.isOpen() == false)
+   {
+      return (false);
+   }
+
+   pubBlockT = (uint8_t *) clBlockP.data();
+   pubFrameT = pubBlockT + TRACE_BLOCK_SIZE(ulBlockFramesP);
+   memcpy(pubFrameT, clFrameR.toByteArray().constData(), QCAN_FRAME_ARRAY_SIZE);
+
+   //----------------------------------------------------------------
+   // update block header
+   //
+   sqTimeT = traceFrameTime(pubFrameT);
+   if (ulBlockFramesP == 0)
+   {
+      qToBigEndian<quint64>(sqTimeT, pubBlockT + TRACE_BLK_TIME_FIRST_POS);
+   }
+   qToBigEndian<quint64>(sqTimeT, pubBlockT + TRACE_BLK_TIME_LAST_POS);
+
+   if (traceFrameKey(pubFrameT, ulKeyT))
+   {
+      traceBloomBits(ulKeyT, ulBit1T, ulBit2T);
+      pubBlockT[TRACE_BLK_BLOOM_POS + (ulBit1T >> 3)] |= (uint8_t) (1 << (ulBit1T & 0x07));
+      pubBlockT[TRACE_BLK_BLOOM_POS + (ulBit2T >> 3)] |= (uint8_t) (1 << (ulBit2T & 0x07));
+   }
+
+   ulBlockFramesP++;
+   uqFrameCountP++;
+   qToBigEndian<quint32>(ulBlockFramesP, pubBlockT + TRACE_BLK_COUNT_POS);
+
+   if (ulBlockFramesP == QCAN_TRACE_BLOCK_FRAMES)
+   {
+      return (writeBlock());
+   }
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceWriter::writeBlock()                                                                                      //
+// write actual block to file and start a new block                                                                   //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanTraceWriter::writeBlock(void)
+{
+   qint64   sqBlockPosT = clFileP.pos();
+
+   if (clFileP.write(clBlockP) != clBlockP.size())
+   {
+      //----------------------------------------------------------------
+      // the block is lost: it is neither indexed nor counted and the
+      // file is closed, so no further frames are accepted. The file
+      // is left like a file that has not been closed, the reader
+      // rebuilds the index from the blocks written before.
+      //
+      clErrorStringP = clFileP.errorString();
+      clFileP.resize(sqBlockPosT);
+      clFileP.close();
+
+      uqFrameCountP -= ulBlockFramesP;
+      ulBlockFramesP = 0;
+      clBlockP.clear();
+      clIndexP.clear();
+
+      return (false);
+   }
+
+   clIndexP.append(clBlockP.constData(), TRACE_BLK_HEADER_SIZE);
+   uqBlockCountP++;
+
+   clBlockP.fill(0);
+   ulBlockFramesP = 0;
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceReader()                                                                                                  //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanTraceReader::QCanTraceReader()
+{
+   pubMapP        = Q_NULLPTR;
+   pubIndexP      = Q_NULLPTR;
+   ulBlockFramesP = QCAN_TRACE_BLOCK_FRAMES;
+   uqBlockCountP  = 0;
+   uqFrameCountP  = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// ~QCanTraceReader()                                                                                                 //
+// destructor                                                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanTraceReader::~QCanTraceReader()
+{
+   close();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceReader::blockHeader()                                                                                     //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+const uint8_t * QCanTraceReader::blockHeader(uint64_t uqBlockV) const
+{
+   return (pubIndexP + (uqBlockV * TRACE_BLK_HEADER_SIZE));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceReader::close()                                                                                           //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanTraceReader::close(void)
+{
+   if (pubMapP != Q_NULLPTR)
+   {
+      clFileP.unmap(pubMapP);
+      pubMapP = Q_NULLPTR;
+   }
+   clFileP.close();
+
+   pubIndexP     = Q_NULLPTR;
+   clIndexP.clear();
+   uqBlockCountP = 0;
+   uqFrameCountP = 0;
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceReader::findIdentifier()                                                                                  //
+// find next frame with identifier, skip blocks by bloom filter                                                       //
+//--------------------------------------------------------------------------------------------------------------------//
+uint64_t QCanTraceReader::findIdentifier(uint64_t uqStartV, uint32_t ulIdentifierV, bool btExtendedV) const
+{
+   const uint8_t *   pubBloomT;
+   uint32_t          ulSearchT;
+   uint32_t          ulKeyT;
+   uint32_t          ulBit1T;
+   uint32_t          ulBit2T;
+   uint64_t          uqBlockT;
+   uint64_t          uqIndexT;
+   uint64_t          uqEndT;
+
+   ulSearchT = ulIdentifierV & 0x1FFFFFFF;
+   if (btExtendedV)
+   {
+      ulSearchT |= 0x80000000;
+   }
+   traceBloomBits(ulSearchT, ulBit1T, ulBit2T);
+
+   for (uqBlockT = uqStartV / ulBlockFramesP; uqBlockT < uqBlockCountP; uqBlockT++)
+   {
+      pubBloomT = blockHeader(uqBlockT) + TRACE_BLK_BLOOM_POS;
+      if (((pubBloomT[ulBit1T >> 3] & (1 << (ulBit1T & 0x07))) == 0) ||
+          ((pubBloomT[ulBit2T >> 3] & (1 << (ulBit2T & 0x07))) == 0))
+      {
+         continue;
+      }
+
+      uqIndexT = qMax(uqStartV, uqBlockT * ulBlockFramesP);
+      uqEndT   = qMin(uqFrameCountP, (uqBlockT + 1) * ulBlockFramesP);
+      for ( ; uqIndexT < uqEndT; uqIndexT++)
+      {
+         if (traceFrameKey(frameData(uqIndexT), ulKeyT) && (ulKeyT == ulSearchT))
+         {
+            return (uqIndexT);
+         }
+      }
+   }
+
+   return (uqFrameCountP);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceReader::frame()                                                                                           //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanTraceReader::frame(uint64_t uqIndexV, QCanFrame & clFrameR) const
+{
+   if (uqIndexV >= uqFrameCountP)
+   {
+      return (false);
+   }
+
+   return (clFrameR.fromByteArray(QByteArray::fromRawData((const char *) frameData(uqIndexV),
+                                                          QCAN_FRAME_ARRAY_SIZE)));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceReader::frameData()                                                                                       //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+const uint8_t * QCanTraceReader::frameData(uint64_t uqIndexV) const
+{
+   uint64_t uqBlockT = uqIndexV / ulBlockFramesP;
+
+   return (pubMapP + TRACE_HEADER_SIZE + (uqBlockT * TRACE_BLOCK_SIZE(ulBlockFramesP)) +
+           TRACE_BLK_HEADER_SIZE + ((uqIndexV % ulBlockFramesP) * QCAN_FRAME_ARRAY_SIZE));
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceReader::open()                                                                                            //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+bool QCanTraceReader::open(const QString & clFileNameR)
+{
+   uint64_t uqBlockSizeT;
+   uint64_t uqIndexPosT;
+   uint32_t ulCountT;
+   qint64   sqSizeT;
+
+   close();
+
+   clFileP.setFileName(clFileNameR);
+   if (clFileP.open(QIODevice::ReadOnly) == false)
+   {
+      clErrorStringP = clFileP.errorString();
+      return (false);
+   }
+
+   sqSizeT = clFileP.size();
+   if (sqSizeT < TRACE_HEADER_SIZE)
+   {
+      close();
+      clErrorStringP = QString("Invalid trace file format");
+      return (false);
+   }
+
+   pubMapP = clFileP.map(0, sqSizeT);
+   if (pubMapP == Q_NULLPTR)
+   {
+      clErrorStringP = clFileP.errorString();
+      close();
+      return (false);
+   }
+
+   ulBlockFramesP = qFromBigEndian<quint32>(pubMapP + TRACE_HDR_BLOCK_FRAMES_POS);
+   if ((memcmp(pubMapP, TRACE_MAGIC, 4) != 0)                                     ||
+       (qFromBigEndian<quint32>(pubMapP + TRACE_HDR_VERSION_POS) != TRACE_VERSION) ||
+       (ulBlockFramesP == 0) || (ulBlockFramesP > TRACE_BLOCK_FRAMES_MAX))
+   {
+      close();
+      clErrorStringP = QString("Invalid trace file format");
+      return (false);
+   }
+
+   //----------------------------------------------------------------
+   // use the index at the end of the file
+   //
+   uqBlockSizeT  = TRACE_BLOCK_SIZE(ulBlockFramesP);
+   uqBlockCountP = qFromBigEndian<quint64>(pubMapP + TRACE_HDR_BLOCK_COUNT_POS);
+   uqFrameCountP = qFromBigEndian<quint64>(pubMapP + TRACE_HDR_FRAME_COUNT_POS);
+   uqIndexPosT   = qFromBigEndian<quint64>(pubMapP + TRACE_HDR_INDEX_POS);
+
+   if ((uqIndexPosT != 0)                                                             &&
+       (uqBlockCountP <= ((uint64_t) sqSizeT - TRACE_HEADER_SIZE) / uqBlockSizeT)      &&
+       (uqIndexPosT == TRACE_HEADER_SIZE + (uqBlockCountP * uqBlockSizeT))             &&
+       (uqIndexPosT + (uqBlockCountP * TRACE_BLK_HEADER_SIZE) <= (uint64_t) sqSizeT)   &&
+       (uqFrameCountP <= uqBlockCountP * ulBlockFramesP))
+   {
+      pubIndexP = pubMapP + uqIndexPosT;
+      return (true);
+   }
+
+   //----------------------------------------------------------------
+   // the file has not been closed: rebuild the index from the
+   // headers of all complete blocks
+   //
+   uqBlockCountP = ((uint64_t) sqSizeT - TRACE_HEADER_SIZE) / uqBlockSizeT;
+   uqFrameCountP = 0;
+   for (uint64_t uqBlockT = 0; uqBlockT < uqBlockCountP; uqBlockT++)
+   {
+      const uint8_t * pubHeaderT = pubMapP + TRACE_HEADER_SIZE + (uqBlockT * uqBlockSizeT);
+      ulCountT = qFromBigEndian<quint32>(pubHeaderT + TRACE_BLK_COUNT_POS);
+      if (ulCountT == 0)
+      {
+         uqBlockCountP = uqBlockT;
+         break;
+      }
+
+      clIndexP.append((const char *) pubHeaderT, TRACE_BLK_HEADER_SIZE);
+      uqFrameCountP += qMin(ulCountT, ulBlockFramesP);
+      if (ulCountT < ulBlockFramesP)
+      {
+         uqBlockCountP = uqBlockT + 1;
+         break;
+      }
+   }
+   pubIndexP = (const uint8_t *) clIndexP.constData();
+
+   return (true);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanTraceReader::seekTime()                                                                                        //
+// binary search on the time stamps of the blocks                                                                     //
+//--------------------------------------------------------------------------------------------------------------------//
+uint64_t QCanTraceReader::seekTime(const QCanTimeStamp & clTimeR) const
+{
+   int64_t  sqTimeT;
+   uint64_t uqLowT  = 0;
+   uint64_t uqHighT = uqBlockCountP;
+   uint64_t uqMidT;
+   uint64_t uqIndexT;
+   uint64_t uqEndT;
+
+   sqTimeT = ((int64_t) clTimeR.seconds()) * 1000000000 + clTimeR.nanoSeconds();
+
+   //----------------------------------------------------------------
+   // find the first block with the time of the last frame equal or
+   // greater than the requested time
+   //
+   while (uqLowT < uqHighT)
+   {
+      uqMidT = uqLowT + ((uqHighT - uqLowT) / 2);
+      if ((int64_t) qFromBigEndian<quint64>(blockHeader(uqMidT) + TRACE_BLK_TIME_LAST_POS) < sqTimeT)
+      {
+         uqLowT = uqMidT + 1;
+      }
+      else
+      {
+         uqHighT = uqMidT;
+      }
+   }
+
+   uqIndexT = uqLowT * ulBlockFramesP;
+   uqEndT   = qMin(uqFrameCountP, uqIndexT + ulBlockFramesP);
+   for ( ; uqIndexT < uqEndT; uqIndexT++)
+   {
+      if (traceFrameTime(frameData(uqIndexT)) >= sqTimeT)
+      {
+         return (uqIndexT);
+      }
+   }
+
+   return (uqFrameCountP);
+}
+
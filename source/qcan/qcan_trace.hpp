@@ -0,0 +1,275 @@
+//====================================================================================================================//
+// File:          qcan_trace.hpp                                                                                      //
+// Description:   QCAN classes - trace file                                                                           //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+
+#ifndef QCAN_TRACE_HPP_
+#define QCAN_TRACE_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+#include "qcan_frame.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_TRACE_BLOCK_FRAMES
+** \brief   Number of frames in a block of a trace file
+**
+** This symbol defines the number of frames which are stored in one
+** block of a trace file written by QCanTraceWriter.
+*/
+#define  QCAN_TRACE_BLOCK_FRAMES    256
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanTraceWriter
+** \brief Write CAN frames to a trace file
+**
+** The class writes CAN frames sequentially to a trace file, which can be read by QCanTraceReader. The file
+** starts with a header of 64 bytes, followed by blocks of fixed size. A block consists of a block header and
+** #QCAN_TRACE_BLOCK_FRAMES frames, every frame and the block header have a size of #QCAN_FRAME_ARRAY_SIZE
+** bytes (see QCanFrame::toByteArray()). The block header holds the number of frames, the time stamps of the
+** first and the last frame and a bloom filter of the identifiers in the block. All values are stored MSB
+** first.
+** <p>
+** On close() the last block is written and the block headers are appended to the file as index. If a file
+** has not been closed, the reader rebuilds the index from the block headers, the frames of the last
+** incomplete block are lost in that case.
+** <p>
+** If a block can not be written, the block is discarded and the file is closed in the same state. The
+** functions write() and close() return \c false then, errorString() describes the error.
+*/
+class QCanTraceWriter
+{
+public:
+
+   QCanTraceWriter();
+
+   ~QCanTraceWriter();
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true if the file has been completed
+   **
+   ** The function writes the last block and the index of the trace file and closes it.
+   */
+   bool  close(void);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Description of last error
+   */
+   inline QString  errorString(void) const               { return (clErrorStringP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of frames written
+   */
+   inline uint64_t frameCount(void) const                { return (uqFrameCountP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true if a trace file is open
+   */
+   inline bool  isOpen(void) const                       { return (clFileP.isOpen()); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFileNameR    Name of trace file
+   ** \return     \c true if the file has been created
+   **
+   ** The function creates the trace file \a clFileNameR, an existing file is overwritten.
+   */
+   bool  open(const QString & clFileNameR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFrameR       CAN frame
+   ** \return     \c true if the frame has been stored
+   **
+   ** The function appends the CAN frame \a clFrameR to the trace file. The frames must be written in
+   ** order of their time stamps, otherwise QCanTraceReader::seekTime() does not work.
+   */
+   bool  write(const QCanFrame & clFrameR);
+
+private:
+
+   bool  writeBlock(void);
+
+   QFile       clFileP;
+   QString     clErrorStringP;
+
+   //----------------------------------------------------------------
+   // the actual block is assembled in clBlockP, the headers of all
+   // blocks are collected in clIndexP
+   //
+   QByteArray  clBlockP;
+   QByteArray  clIndexP;
+   uint32_t    ulBlockFramesP;
+   uint64_t    uqBlockCountP;
+   uint64_t    uqFrameCountP;
+};
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanTraceReader
+** \brief Read CAN frames from a trace file
+**
+** The class reads a trace file written by QCanTraceWriter. The file is mapped into memory, so a frame is
+** only read from disk when it is accessed. The function seekTime() does a binary search on the time stamps
+** of the block index, findIdentifier() skips all blocks whose bloom filter does not contain the identifier.
+** \code
+** QCanTraceReader clTraceT;
+** QCanFrame       clFrameT;
+**
+** clTraceT.open("trace.qct");
+** uint64_t uqIndexT = clTraceT.findIdentifier(clTraceT.seekTime(QCanTimeStamp(60)), 0x123, false);
+** while (clTraceT.frame(uqIndexT, clFrameT))
+** {
+**    qDebug() << clFrameT.toString(true);
+**    uqIndexT = clTraceT.findIdentifier(uqIndexT + 1, 0x123, false);
+** }
+** \endcode
+*/
+class QCanTraceReader
+{
+public:
+
+   QCanTraceReader();
+
+   ~QCanTraceReader();
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of blocks
+   */
+   inline uint64_t blockCount(void) const                { return (uqBlockCountP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** The function unmaps and closes the trace file.
+   */
+   void  close(void);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Description of last error
+   */
+   inline QString  errorString(void) const               { return (clErrorStringP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  uqStartV       Index of first frame
+   ** \param[in]  ulIdentifierV  CAN identifier
+   ** \param[in]  btExtendedV    \c true for extended frame format
+   ** \return     Index of frame or frameCount()
+   **
+   ** The function returns the index of the next data frame with the identifier \a ulIdentifierV,
+   ** starting at the frame \a uqStartV. If no such frame exists, the function returns frameCount().
+   */
+   uint64_t findIdentifier(uint64_t uqStartV, uint32_t ulIdentifierV, bool btExtendedV) const;
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  uqIndexV       Index of frame
+   ** \param[out] clFrameR       CAN frame
+   ** \return     \c true if the frame has been read
+   */
+   bool  frame(uint64_t uqIndexV, QCanFrame & clFrameR) const;
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of frames
+   */
+   inline uint64_t frameCount(void) const                { return (uqFrameCountP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     \c true if a trace file is open
+   */
+   inline bool  isOpen(void) const                       { return (pubMapP != Q_NULLPTR); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clFileNameR    Name of trace file
+   ** \return     \c true if the file has been opened
+   **
+   ** The function opens and maps the trace file \a clFileNameR.
+   */
+   bool  open(const QString & clFileNameR);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clTimeR        Time stamp
+   ** \return     Index of frame or frameCount()
+   **
+   ** The function returns the index of the first frame with a time stamp equal or greater than
+   ** \a clTimeR. If no such frame exists, the function returns frameCount().
+   */
+   uint64_t seekTime(const QCanTimeStamp & clTimeR) const;
+
+private:
+
+   const uint8_t *   blockHeader(uint64_t uqBlockV) const;
+   const uint8_t *   frameData(uint64_t uqIndexV) const;
+
+   QFile             clFileP;
+   QString           clErrorStringP;
+   uchar *           pubMapP;
+
+   //----------------------------------------------------------------
+   // index of the file: pointer to the index at the end of the file
+   // or to clIndexP, which holds a copy of all block headers if the
+   // file has not been closed
+   //
+   const uint8_t *   pubIndexP;
+   QByteArray        clIndexP;
+
+   uint32_t          ulBlockFramesP;
+   uint64_t          uqBlockCountP;
+   uint64_t          uqFrameCountP;
+};
+
+#endif   // QCAN_TRACE_HPP_
@@ -0,0 +1,202 @@
+//====================================================================================================================//
+// File:          qcan_value_table.cpp                                                                                //
+// Description:   QCAN classes - last value table                                                                     //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#include <string.h>
+
+#include "qcan_value_table.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+#define  VALUE_STD_ID_COUNT            ((int32_t) 2048)
+
+//-------------------------------------------------------------------
+// the payload of a frame starts with the DLC (byte 4), followed by
+// the control field and 64 data bytes
+//
+#define  VALUE_PAYLOAD_POS             4
+#define  VALUE_PAYLOAD_SIZE            66
+
+//-------------------------------------------------------------------
+// estimated size of a QHash node: pointer to next node, hash value,
+// key and value
+//
+#define  VALUE_EXT_NODE_SIZE           (sizeof(void *) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(int32_t))
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Class methods                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanValueTable()                                                                                                   //
+// constructor                                                                                                        //
+//--------------------------------------------------------------------------------------------------------------------//
+QCanValueTable::QCanValueTable()
+{
+   ulEntryMaxP = QCAN_VALUE_ENTRY_MAX;
+   clear();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanValueTable::clear()                                                                                            //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanValueTable::clear(void)
+{
+   clStdIndexP.fill(-1, VALUE_STD_ID_COUNT);
+   clExtIndexP.clear();
+   clFrameDataP.clear();
+   clChangeCountP.clear();
+   clChangeCountP.squeeze();
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanValueTable::memorySize()                                                                                       //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+uint32_t QCanValueTable::memorySize(void) const
+{
+   uint32_t ulSizeT;
+
+   ulSizeT  = sizeof(QCanValueTable);
+   ulSizeT += clStdIndexP.capacity() * sizeof(int32_t);
+   ulSizeT += clExtIndexP.capacity() * sizeof(void *);
+   ulSizeT += clExtIndexP.size() * VALUE_EXT_NODE_SIZE;
+   ulSizeT += clFrameDataP.capacity();
+   ulSizeT += clChangeCountP.capacity() * sizeof(uint32_t);
+
+   return (ulSizeT);
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanValueTable::setEntryMax()                                                                                      //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+void QCanValueTable::setEntryMax(uint32_t ulEntryMaxV)
+{
+   ulEntryMaxP = ulEntryMaxV;
+   if ((uint32_t) clChangeCountP.size() > ulEntryMaxP)
+   {
+      clear();
+   }
+}
+
+
+//--------------------------------------------------------------------------------------------------------------------//
+// QCanValueTable::update()                                                                                           //
+// store frame in the entry of its identifier                                                                         //
+//--------------------------------------------------------------------------------------------------------------------//
+int32_t QCanValueTable::update(const QByteArray & clSockDataR)
+{
+   const uint8_t *   pubSrcT;
+   char *            pubDstT;
+   uint32_t          ulIdT;
+   int32_t           slEntryT;
+
+   if (clSockDataR.size() < QCAN_FRAME_ARRAY_SIZE)
+   {
+      return (-1);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // identifier field in byte 0 .. 3, MSB first: the upper 3 bits denote the frame type, only data
+   // frames are stored
+   //
+   pubSrcT = (const uint8_t *) clSockDataR.constData();
+   if ((pubSrcT[0] & 0xE0) > 0)
+   {
+      return (-1);
+   }
+   ulIdT = ((uint32_t) pubSrcT[0] << 24) | ((uint32_t) pubSrcT[1] << 16) |
+           ((uint32_t) pubSrcT[2] <<  8) | ((uint32_t) pubSrcT[3]);
+
+   //---------------------------------------------------------------------------------------------------
+   // look up the entry, bit 0 of the control field denotes an extended frame
+   //
+   if ((pubSrcT[5] & 0x01) == 0)
+   {
+      slEntryT = clStdIndexP.at(ulIdT & QCAN_FRAME_ID_MASK_STD);
+   }
+   else
+   {
+      slEntryT = clExtIndexP.value(ulIdT & QCAN_FRAME_ID_MASK_EXT, -1);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // a new identifier gets the next free entry
+   //
+   if (slEntryT < 0)
+   {
+      if ((uint32_t) clChangeCountP.size() >= ulEntryMaxP)
+      {
+         return (-1);
+      }
+
+      slEntryT = clChangeCountP.size();
+      if ((pubSrcT[5] & 0x01) == 0)
+      {
+         clStdIndexP[ulIdT & QCAN_FRAME_ID_MASK_STD] = slEntryT;
+      }
+      else
+      {
+         clExtIndexP.insert(ulIdT & QCAN_FRAME_ID_MASK_EXT, slEntryT);
+      }
+      clFrameDataP.append(clSockDataR.constData(), QCAN_FRAME_ARRAY_SIZE);
+      clChangeCountP.append(0);
+      return (slEntryT);
+   }
+
+   //---------------------------------------------------------------------------------------------------
+   // compare the payload and store the frame
+   //
+   pubDstT = clFrameDataP.data() + (slEntryT * QCAN_FRAME_ARRAY_SIZE);
+   if (memcmp(pubDstT + VALUE_PAYLOAD_POS, pubSrcT + VALUE_PAYLOAD_POS, VALUE_PAYLOAD_SIZE) != 0)
+   {
+      clChangeCountP[slEntryT]++;
+   }
+   memcpy(pubDstT, pubSrcT, QCAN_FRAME_ARRAY_SIZE);
+
+   return (slEntryT);
+}
@@ -0,0 +1,173 @@
+//====================================================================================================================//
+// File:          qcan_value_table.hpp                                                                                //
+// Description:   QCAN classes - last value table                                                                     //
+//                                                                                                                    //
+// Copyright (C) MicroControl GmbH & Co. KG                                                                           //
+// 53844 Troisdorf - Germany                                                                                          //
+// www.microcontrol.net                                                                                               //
+//                                                                                                                    //
+//--------------------------------------------------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without modification, are permitted provided that the   //
+// following conditions are met:                                                                                      //
+// 1. Redistributions of source code must retain the above copyright notice, this list of conditions, the following   //
+//    disclaimer and the referenced file 'LICENSE'.                                                                   //
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the       //
+//    following disclaimer in the documentation and/or other materials provided with the distribution.                //
+// 3. Neither the name of MicroControl nor the names of its contributors may be used to endorse or promote products   //
+//    derived from this software without specific prior written permission.                                           //
+//                                                                                                                    //
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except in compliance     //
+// with the License. You may obtain a copy of the License at                                                          //
+//                                                                                                                    //
+//    http://www.apache.org/licenses/LICENSE-2.0                                                                      //
+//                                                                                                                    //
+// Unless required by applicable law or agreed to in writing, software distributed under the License is distributed   //
+// on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for  //
+// the specific language governing permissions and limitations under the License.                                     //
+//                                                                                                                    //
+//====================================================================================================================//
+
+
+
+#ifndef QCAN_VALUE_TABLE_HPP_
+#define QCAN_VALUE_TABLE_HPP_
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Include files                                                                                                      **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+#include "qcan_frame.hpp"
+
+
+/*--------------------------------------------------------------------------------------------------------------------*\
+** Definitions                                                                                                        **
+**                                                                                                                    **
+\*--------------------------------------------------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+/*!
+** \def     QCAN_VALUE_ENTRY_MAX
+** \ingroup QCAN_NW
+** \brief   Maximum number of entries in the last value table
+**
+** This symbol defines the default value for the maximum number of
+** identifiers which are stored in the last value table of a
+** QCanNetwork. The value can be changed during run-time by
+** QCanNetwork::setValueCacheMax().
+*/
+#define  QCAN_VALUE_ENTRY_MAX       4096
+
+
+//----------------------------------------------------------------------------------------------------------------
+/*!
+** \class QCanValueTable
+** \brief Last value of each CAN identifier
+**
+** The table holds the last frame of each identifier of a CAN network. Every identifier is assigned to an entry
+** on first reception, the index of the entry does not change until clear() is called. Standard identifiers are
+** looked up in a table with one element per identifier, extended identifiers in a hash. The payload (DLC,
+** format and data) of a frame is compared with the stored frame, a change increments the change counter of
+** the entry.
+** <p>
+** The frames are stored in a contiguous array in order of their first reception, so the complete table
+** can be sent to a socket with a single write (see snapshot()). The number of entries is limited by
+** setEntryMax(), the memory footprint is returned by memorySize().
+*/
+class QCanValueTable
+{
+public:
+
+   QCanValueTable();
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  slEntryV       Index of entry
+   ** \return     Change counter of entry
+   **
+   ** The function returns the number of payload changes of the entry \a slEntryV, the value wraps
+   ** around.
+   */
+   inline uint32_t changeCount(int32_t slEntryV) const   { return (clChangeCountP.at(slEntryV)); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** Remove all entries from the table.
+   */
+   void  clear(void);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Number of entries
+   */
+   inline int32_t  entryCount(void) const                { return (clChangeCountP.size()); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Maximum number of entries
+   ** \see        setEntryMax()
+   */
+   inline uint32_t entryMax(void) const                  { return (ulEntryMaxP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Memory footprint in bytes
+   **
+   ** The function returns the memory which is allocated by the table, the size of the hash for
+   ** extended identifiers is estimated.
+   */
+   uint32_t memorySize(void) const;
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  ulEntryMaxV    Maximum number of entries
+   **
+   ** The function sets the maximum number of entries. If the table holds more entries than
+   ** \a ulEntryMaxV, all entries are removed.
+   */
+   void  setEntryMax(uint32_t ulEntryMaxV);
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \return     Frames of all entries
+   **
+   ** The function returns the last frame of each entry as byte array, the frames are placed in order
+   ** of the entry index with a size of #QCAN_FRAME_ARRAY_SIZE each.
+   */
+   inline const QByteArray & snapshot(void) const        { return (clFrameDataP); };
+
+   //---------------------------------------------------------------------------------------------------
+   /*!
+   ** \param[in]  clSockDataR    CAN frame as byte array
+   ** \return     Index of entry or -1
+   **
+   ** The function stores the CAN frame \a clSockDataR in the entry of its identifier and returns the
+   ** index of the entry. Error frames are not stored, the function returns -1 in that case and if
+   ** the maximum number of entries is reached (see setEntryMax()).
+   */
+   int32_t  update(const QByteArray & clSockDataR);
+
+private:
+
+   //----------------------------------------------------------------
+   // index of entry for every standard identifier and for every
+   // extended identifier which has been received
+   //
+   QVector<int32_t>           clStdIndexP;
+   QHash<uint32_t, int32_t>   clExtIndexP;
+
+   //----------------------------------------------------------------
+   // frame and change counter of each entry, the frames are stored
+   // in a contiguous array with QCAN_FRAME_ARRAY_SIZE bytes each
+   //
+   QByteArray                 clFrameDataP;
+   QVector<uint32_t>          clChangeCountP;
+
+   uint32_t                   ulEntryMaxP;
+};
+
+#endif   // QCAN_VALUE_TABLE_HPP_
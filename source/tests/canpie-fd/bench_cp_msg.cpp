@@ -0,0 +1,282 @@
+//============================================================================//
+// File:          bench_cp_msg.cpp                                            //
+// Description:   Benchmark of CANpie message access functions                //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#include "cp_msg.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#define  BENCH_FRAMES         2000000UL
+#define  BENCH_MSG_MAX        4096
+#define  BENCH_BUFFER_MAX     32
+
+#define  CP_USER_FLAG_RCV     ((uint32_t)(0x00000001))
+
+
+/*----------------------------------------------------------------------------*\
+** Variables of module                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+static CpCanMsg_ts   atsCanMsgS[BENCH_MSG_MAX];
+static CpCanMsg_ts   atsCanBufS[BENCH_BUFFER_MAX];
+static uint32_t      aulAccMaskS[BENCH_BUFFER_MAX];
+
+
+/*----------------------------------------------------------------------------*\
+** Function implementations                                                   **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//----------------------------------------------------------------------------//
+// BenchTimeNs()                                                              //
+// monotonic time in nanoseconds                                              //
+//----------------------------------------------------------------------------//
+static uint64_t BenchTimeNs(void)
+{
+   struct timespec tsTimeT;
+
+   clock_gettime(CLOCK_MONOTONIC, &tsTimeT);
+   return ((uint64_t) tsTimeT.tv_sec * 1000000000ULL + (uint64_t) tsTimeT.tv_nsec);
+}
+
+
+//----------------------------------------------------------------------------//
+// BenchSetup()                                                               //
+// message buffers and received frames                                        //
+//----------------------------------------------------------------------------//
+static void BenchSetup(void)
+{
+   uint32_t ulIdxT;
+
+   srand(1);
+
+   //----------------------------------------------------------------
+   // every second buffer receives, one quarter uses extended frames,
+   // the acceptance masks accept one or a group of identifiers
+   //
+   for (ulIdxT = 0; ulIdxT < BENCH_BUFFER_MAX; ulIdxT++)
+   {
+      memset(&atsCanBufS[ulIdxT], 0, sizeof(CpCanMsg_ts));
+      if ((ulIdxT % 4) == 3)
+      {
+         CpMsgInit(&atsCanBufS[ulIdxT], CP_MSG_FORMAT_FEFF);
+         CpMsgSetIdentifier(&atsCanBufS[ulIdxT], 0x18FF0000UL + ulIdxT);
+      }
+      else
+      {
+         CpMsgInit(&atsCanBufS[ulIdxT], CP_MSG_FORMAT_CBFF);
+         CpMsgSetIdentifier(&atsCanBufS[ulIdxT], 0x100 + (ulIdxT * 8));
+      }
+      atsCanBufS[ulIdxT].ulMsgUser = ((ulIdxT % 2) == 0) ? 0 : CP_USER_FLAG_RCV;
+      aulAccMaskS[ulIdxT] = ((ulIdxT % 3) == 0) ? 0x1FFFFFF8UL : CP_MASK_EXT_FRAME;
+   }
+
+   for (ulIdxT = 0; ulIdxT < BENCH_MSG_MAX; ulIdxT++)
+   {
+      memset(&atsCanMsgS[ulIdxT], 0, sizeof(CpCanMsg_ts));
+      if ((rand() % 4) == 0)
+      {
+         CpMsgInit(&atsCanMsgS[ulIdxT], CP_MSG_FORMAT_FEFF);
+         CpMsgSetIdentifier(&atsCanMsgS[ulIdxT], 0x18FF0000UL + ((uint32_t) rand() % 64));
+         CpMsgSetDlc(&atsCanMsgS[ulIdxT], (uint8_t) (rand() % 16));
+      }
+      else
+      {
+         CpMsgInit(&atsCanMsgS[ulIdxT], CP_MSG_FORMAT_CBFF);
+         CpMsgSetIdentifier(&atsCanMsgS[ulIdxT], 0x100 + ((uint32_t) rand() % 512));
+         CpMsgSetDlc(&atsCanMsgS[ulIdxT], (uint8_t) (rand() % 9));
+      }
+      atsCanMsgS[ulIdxT].tuMsgData.aubByte[0] = (uint8_t) ulIdxT;
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// BenchDispatchFunc()                                                        //
+// dispatch loop of QCanSocketCpFD::handleCanFrame() with cp_msg.c            //
+//----------------------------------------------------------------------------//
+static uint32_t BenchDispatchFunc(uint32_t ulFramesV)
+{
+   CpCanMsg_ts *  ptsCanMsgT;
+   CpCanMsg_ts *  ptsCanBufT;
+   uint32_t       ulAccMaskT;
+   uint32_t       ulMatchT = 0;
+
+   for (uint32_t ulFrameT = 0; ulFrameT < ulFramesV; ulFrameT++)
+   {
+      ptsCanMsgT = &atsCanMsgS[ulFrameT % BENCH_MSG_MAX];
+      for (uint8_t ubBufferIdxT = 0; ubBufferIdxT < BENCH_BUFFER_MAX; ubBufferIdxT++)
+      {
+         ptsCanBufT = &atsCanBufS[ubBufferIdxT];
+         ulAccMaskT = aulAccMaskS[ubBufferIdxT];
+
+         if ((ptsCanBufT->ulMsgUser & CP_USER_FLAG_RCV) == 0) continue;
+
+         if (CpMsgIsExtended(ptsCanBufT) == CpMsgIsExtended(ptsCanMsgT))
+         {
+            if ( (CpMsgGetIdentifier(ptsCanBufT) & ulAccMaskT) ==
+                 (CpMsgGetIdentifier(ptsCanMsgT) & ulAccMaskT)    )
+            {
+               ptsCanBufT->ubMsgDLC = CpMsgGetDlc(ptsCanMsgT);
+               ptsCanBufT->tuMsgData.aubByte[0] = CpMsgGetData(ptsCanMsgT, 0);
+               ulMatchT++;
+            }
+         }
+      }
+   }
+
+   return (ulMatchT);
+}
+
+
+//----------------------------------------------------------------------------//
+// BenchDispatchInline()                                                      //
+// dispatch loop of QCanSocketCpFD::handleCanFrame() with cp_msg.hpp          //
+//----------------------------------------------------------------------------//
+template <class MSG> static uint32_t BenchDispatchInline(uint32_t ulFramesV)
+{
+   CpCanMsg_ts *  ptsCanMsgT;
+   CpCanMsg_ts *  ptsCanBufT;
+   uint32_t       ulAccMaskT;
+   uint32_t       ulIdentifierT;
+   uint32_t       ulMatchT = 0;
+
+   for (uint32_t ulFrameT = 0; ulFrameT < ulFramesV; ulFrameT++)
+   {
+      ptsCanMsgT    = &atsCanMsgS[ulFrameT % BENCH_MSG_MAX];
+      ulIdentifierT = MSG::identifier(*ptsCanMsgT);
+      for (uint8_t ubBufferIdxT = 0; ubBufferIdxT < BENCH_BUFFER_MAX; ubBufferIdxT++)
+      {
+         ptsCanBufT = &atsCanBufS[ubBufferIdxT];
+         ulAccMaskT = aulAccMaskS[ubBufferIdxT];
+
+         if ((ptsCanBufT->ulMsgUser & CP_USER_FLAG_RCV) == 0) continue;
+
+         if (MSG::isSameFormat(*ptsCanBufT, *ptsCanMsgT))
+         {
+            if ( (MSG::identifier(*ptsCanBufT) & ulAccMaskT) ==
+                 (ulIdentifierT & ulAccMaskT)    )
+            {
+               ptsCanBufT->ubMsgDLC = MSG::dlc(*ptsCanMsgT);
+               ptsCanBufT->tuMsgData.aubByte[0] = MSG::data(*ptsCanMsgT, 0);
+               ulMatchT++;
+            }
+         }
+      }
+   }
+
+   return (ulMatchT);
+}
+
+
+//----------------------------------------------------------------------------//
+// BenchReport()                                                              //
+//                                                                            //
+//----------------------------------------------------------------------------//
+static void BenchReport(const char * pszNameV, uint32_t ulFramesV, uint32_t ulMatchV,
+                        uint64_t uqTimeV, uint64_t uqBaseV)
+{
+   printf("%-22s: %6.1f ns/frame, %u matches, speedup %.2f\n", pszNameV,
+          (double) uqTimeV / (double) ulFramesV, ulMatchV,
+          (double) uqBaseV / (double) (uqTimeV ? uqTimeV : 1));
+}
+
+
+//----------------------------------------------------------------------------//
+// main()                                                                     //
+// usage: bench_cp_msg [frames]                                               //
+//----------------------------------------------------------------------------//
+int main(int argc, const char *argv[])
+{
+   uint32_t ulFramesT = BENCH_FRAMES;
+   uint32_t ulFuncT;
+   uint32_t ulInlineT;
+   uint32_t ulClassicT;
+   uint64_t uqFuncT;
+   uint64_t uqInlineT;
+   uint64_t uqClassicT;
+   uint64_t uqStartT;
+
+   if (argc > 1)
+   {
+      ulFramesT = (uint32_t) strtoul(argv[1], NULL, 0);
+   }
+   if (ulFramesT == 0)
+   {
+      return (1);
+   }
+
+   BenchSetup();
+
+   //----------------------------------------------------------------
+   // warm up caches and branch predictors
+   //
+   BenchDispatchFunc(BENCH_MSG_MAX);
+   BenchDispatchInline<CpMsg>(BENCH_MSG_MAX);
+
+   uqStartT  = BenchTimeNs();
+   ulFuncT   = BenchDispatchFunc(ulFramesT);
+   uqFuncT   = BenchTimeNs() - uqStartT;
+
+   uqStartT  = BenchTimeNs();
+   ulInlineT = BenchDispatchInline<CpMsg>(ulFramesT);
+   uqInlineT = BenchTimeNs() - uqStartT;
+
+   uqStartT   = BenchTimeNs();
+   ulClassicT = BenchDispatchInline< CpMsgAccess<0> >(ulFramesT);
+   uqClassicT = BenchTimeNs() - uqStartT;
+
+   printf("frames                : %u, %u buffers\n", ulFramesT, BENCH_BUFFER_MAX);
+   BenchReport("cp_msg.c functions", ulFramesT, ulFuncT, uqFuncT, uqFuncT);
+   BenchReport("CpMsg (CAN FD)", ulFramesT, ulInlineT, uqInlineT, uqFuncT);
+   BenchReport("CpMsgAccess<0>", ulFramesT, ulClassicT, uqClassicT, uqFuncT);
+
+   return (((ulFuncT == ulInlineT) && (ulFuncT == ulClassicT)) ? 0 : 1);
+}
@@ -0,0 +1,325 @@
+//============================================================================//
+// File:          test_cp_fifo.c                                              //
+// Description:   Unit tests for CANpie FIFO functions                        //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+
+
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#include "cp_fifo.h"
+#include "unity_fixture.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#define  FIFO_SIZE      8
+
+/*----------------------------------------------------------------------------*\
+** Variables of module                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+TEST_GROUP(CP_FIFO);     // test group name
+
+static CpFifo_ts     tsFifoS;
+static CpCanMsg_ts   atsFifoMsgS[FIFO_SIZE];
+
+/*----------------------------------------------------------------------------*\
+** Function implementations                                                   **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+
+//----------------------------------------------------------------------------//
+// TEST_SETUP()                                                               //
+// init code for each test case                                               //
+//----------------------------------------------------------------------------//
+TEST_SETUP(CP_FIFO)
+{
+   memset(&atsFifoMsgS[0], 0, sizeof(atsFifoMsgS));
+   CpFifoInit(&tsFifoS, &atsFifoMsgS[0], FIFO_SIZE);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_TEAR_DOWN()                                                           //
+// release code for each test case                                            //
+//----------------------------------------------------------------------------//
+TEST_TEAR_DOWN(CP_FIFO)
+{
+
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_FIFO_001                                                      //
+// span of an empty and a full FIFO                                           //
+//----------------------------------------------------------------------------//
+TEST(CP_FIFO, 001)
+{
+   TEST_ASSERT_TRUE(CpFifoIsEmpty(&tsFifoS));
+   TEST_ASSERT_EQUAL(FIFO_SIZE, CpFifoDataInSpan(&tsFifoS));
+   TEST_ASSERT_EQUAL(0, CpFifoDataOutSpan(&tsFifoS));
+
+   //----------------------------------------------------------------
+   // fill FIFO with one block
+   //
+   CpFifoAddIn(&tsFifoS, FIFO_SIZE);
+   TEST_ASSERT_TRUE(CpFifoIsFull(&tsFifoS));
+   TEST_ASSERT_EQUAL(0, CpFifoDataInSpan(&tsFifoS));
+   TEST_ASSERT_EQUAL(FIFO_SIZE, CpFifoDataOutSpan(&tsFifoS));
+
+   //----------------------------------------------------------------
+   // release FIFO with one block
+   //
+   CpFifoAddOut(&tsFifoS, FIFO_SIZE);
+   TEST_ASSERT_TRUE(CpFifoIsEmpty(&tsFifoS));
+   TEST_ASSERT_EQUAL(0, CpFifoDataOutSpan(&tsFifoS));
+
+   UnityPrint("CP_FIFO_001: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_FIFO_002                                                      //
+// span of a FIFO that wraps around                                           //
+//----------------------------------------------------------------------------//
+TEST(CP_FIFO, 002)
+{
+   //----------------------------------------------------------------
+   // move indices to position 6
+   //
+   CpFifoAddIn(&tsFifoS, 6);
+   CpFifoAddOut(&tsFifoS, 6);
+   TEST_ASSERT_TRUE(CpFifoIsEmpty(&tsFifoS));
+   TEST_ASSERT_EQUAL(2, CpFifoDataInSpan(&tsFifoS));
+
+   //----------------------------------------------------------------
+   // write 2 + 3 entries, data in index wraps around
+   //
+   CpFifoAddIn(&tsFifoS, 2);
+   TEST_ASSERT_EQUAL(6, CpFifoDataInSpan(&tsFifoS));
+   TEST_ASSERT_EQUAL(0, (int) tsFifoS.ulIndexIn);
+   CpFifoAddIn(&tsFifoS, 3);
+   TEST_ASSERT_FALSE(CpFifoIsFull(&tsFifoS));
+   TEST_ASSERT_EQUAL(3, CpFifoDataInSpan(&tsFifoS));
+
+   //----------------------------------------------------------------
+   // pending entries are split into two blocks
+   //
+   TEST_ASSERT_EQUAL(2, CpFifoDataOutSpan(&tsFifoS));
+   TEST_ASSERT_TRUE(CpFifoDataOutPtr(&tsFifoS) == &atsFifoMsgS[6]);
+   CpFifoAddOut(&tsFifoS, 2);
+   TEST_ASSERT_EQUAL(3, CpFifoDataOutSpan(&tsFifoS));
+   TEST_ASSERT_TRUE(CpFifoDataOutPtr(&tsFifoS) == &atsFifoMsgS[0]);
+
+   //----------------------------------------------------------------
+   // free entries are contiguous again, fill them
+   //
+   TEST_ASSERT_EQUAL(5, CpFifoDataInSpan(&tsFifoS));
+   CpFifoAddIn(&tsFifoS, CpFifoDataInSpan(&tsFifoS));
+   TEST_ASSERT_TRUE(CpFifoIsFull(&tsFifoS));
+   TEST_ASSERT_EQUAL(FIFO_SIZE, CpFifoDataOutSpan(&tsFifoS));
+
+   UnityPrint("CP_FIFO_002: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_FIFO_003                                                      //
+// adding zero entries does not change the state                              //
+//----------------------------------------------------------------------------//
+TEST(CP_FIFO, 003)
+{
+   CpFifoAddOut(&tsFifoS, 0);
+   TEST_ASSERT_TRUE(CpFifoIsEmpty(&tsFifoS));
+
+   CpFifoAddIn(&tsFifoS, FIFO_SIZE);
+   CpFifoAddIn(&tsFifoS, 0);
+   TEST_ASSERT_TRUE(CpFifoIsFull(&tsFifoS));
+
+   UnityPrint("CP_FIFO_003: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_FIFO_004                                                      //
+// notification at high watermark, re-arm at low watermark                    //
+//----------------------------------------------------------------------------//
+TEST(CP_FIFO, 004)
+{
+   CpFifoEvent_ts tsEventT;
+
+   CpFifoEventInit(&tsEventT, 4, 1, 0);
+
+   //----------------------------------------------------------------
+   // no notification below the high watermark
+   //
+   CpFifoAddIn(&tsFifoS, 3);
+   TEST_ASSERT_EQUAL(3, CpFifoPending(&tsFifoS));
+   TEST_ASSERT_FALSE(CpFifoEventIn(&tsEventT, &tsFifoS, 0));
+   CpFifoIncIn(&tsFifoS);
+   TEST_ASSERT_TRUE(CpFifoEventIn(&tsEventT, &tsFifoS, 0));
+
+   //----------------------------------------------------------------
+   // one notification per batch
+   //
+   CpFifoIncIn(&tsFifoS);
+   TEST_ASSERT_FALSE(CpFifoEventIn(&tsEventT, &tsFifoS, 0));
+
+   //----------------------------------------------------------------
+   // reading above the low watermark does not re-arm
+   //
+   CpFifoAddOut(&tsFifoS, 3);
+   CpFifoEventOut(&tsEventT, &tsFifoS, 0);
+   CpFifoAddIn(&tsFifoS, 3);
+   TEST_ASSERT_FALSE(CpFifoEventIn(&tsEventT, &tsFifoS, 0));
+
+   CpFifoAddOut(&tsFifoS, 4);
+   CpFifoEventOut(&tsEventT, &tsFifoS, 0);
+   TEST_ASSERT_EQUAL(1, CpFifoPending(&tsFifoS));
+   CpFifoAddIn(&tsFifoS, 3);
+   TEST_ASSERT_TRUE(CpFifoEventIn(&tsEventT, &tsFifoS, 0));
+
+   UnityPrint("CP_FIFO_004: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_FIFO_005                                                      //
+// notification after timeout                                                 //
+//----------------------------------------------------------------------------//
+TEST(CP_FIFO, 005)
+{
+   CpFifoEvent_ts tsEventT;
+
+   CpFifoEventInit(&tsEventT, 6, 0, 10);
+
+   //----------------------------------------------------------------
+   // timeout starts with the first message
+   //
+   TEST_ASSERT_FALSE(CpFifoEventTimer(&tsEventT, &tsFifoS, 100));
+   CpFifoIncIn(&tsFifoS);
+   TEST_ASSERT_FALSE(CpFifoEventIn(&tsEventT, &tsFifoS, 100));
+   CpFifoIncIn(&tsFifoS);
+   TEST_ASSERT_FALSE(CpFifoEventIn(&tsEventT, &tsFifoS, 105));
+   TEST_ASSERT_FALSE(CpFifoEventTimer(&tsEventT, &tsFifoS, 109));
+   TEST_ASSERT_TRUE(CpFifoEventTimer(&tsEventT, &tsFifoS, 110));
+   TEST_ASSERT_FALSE(CpFifoEventTimer(&tsEventT, &tsFifoS, 120));
+
+   //----------------------------------------------------------------
+   // read all messages, no timeout without messages
+   //
+   CpFifoAddOut(&tsFifoS, 2);
+   CpFifoEventOut(&tsEventT, &tsFifoS, 121);
+   TEST_ASSERT_FALSE(CpFifoEventTimer(&tsEventT, &tsFifoS, 200));
+
+   //----------------------------------------------------------------
+   // tick counter wraps around
+   //
+   CpFifoIncIn(&tsFifoS);
+   TEST_ASSERT_FALSE(CpFifoEventIn(&tsEventT, &tsFifoS, 0xFFFFFFFA));
+   TEST_ASSERT_FALSE(CpFifoEventTimer(&tsEventT, &tsFifoS, 0x00000003));
+   TEST_ASSERT_TRUE(CpFifoEventTimer(&tsEventT, &tsFifoS, 0x00000004));
+
+   UnityPrint("CP_FIFO_005: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_FIFO_006                                                      //
+// pending messages after re-arm start a new timeout                          //
+//----------------------------------------------------------------------------//
+TEST(CP_FIFO, 006)
+{
+   CpFifoEvent_ts tsEventT;
+
+   CpFifoEventInit(&tsEventT, 4, 2, 10);
+
+   CpFifoAddIn(&tsFifoS, 4);
+   TEST_ASSERT_TRUE(CpFifoEventIn(&tsEventT, &tsFifoS, 0));
+
+   CpFifoAddOut(&tsFifoS, 2);
+   CpFifoEventOut(&tsEventT, &tsFifoS, 50);
+   TEST_ASSERT_FALSE(CpFifoEventTimer(&tsEventT, &tsFifoS, 59));
+   TEST_ASSERT_TRUE(CpFifoEventTimer(&tsEventT, &tsFifoS, 60));
+
+   //----------------------------------------------------------------
+   // a full FIFO reports all entries pending
+   //
+   CpFifoAddIn(&tsFifoS, CpFifoDataInSpan(&tsFifoS));
+   CpFifoAddIn(&tsFifoS, CpFifoDataInSpan(&tsFifoS));
+   TEST_ASSERT_TRUE(CpFifoIsFull(&tsFifoS));
+   TEST_ASSERT_EQUAL(FIFO_SIZE, CpFifoPending(&tsFifoS));
+
+   UnityPrint("CP_FIFO_006: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_GROUP_RUNNER()                                                        //
+// execute all test cases                                                     //
+//----------------------------------------------------------------------------//
+TEST_GROUP_RUNNER(CP_FIFO)
+{
+   UnityPrint("--- Run test group: CP_FIFO ----------------------------------");
+   printf("\n");
+
+   RUN_TEST_CASE(CP_FIFO, 001);
+   RUN_TEST_CASE(CP_FIFO, 002);
+   RUN_TEST_CASE(CP_FIFO, 003);
+   RUN_TEST_CASE(CP_FIFO, 004);
+   RUN_TEST_CASE(CP_FIFO, 005);
+   RUN_TEST_CASE(CP_FIFO, 006);
+   printf("\n");
+
+}
+
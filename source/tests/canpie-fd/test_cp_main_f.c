@@ -49,6 +49,8 @@ static void RunAllTests(void)
    RUN_TEST_GROUP(CP_MSG_CCF);
    RUN_TEST_GROUP(CP_MSG_FDF);
    RUN_TEST_GROUP(CP_CORE);
+   RUN_TEST_GROUP(CP_FIFO);
+   RUN_TEST_GROUP(CP_PRIO);
 }
 
 
@@ -0,0 +1,333 @@
+//============================================================================//
+// File:          test_cp_prio.c                                              //
+// Description:   Unit tests for CANpie priority transmit queue               //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#include "cp_msg.h"
+#include "cp_prio.h"
+#include "unity_fixture.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#define  PRIO_SIZE      32
+
+/*----------------------------------------------------------------------------*\
+** Variables of module                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+TEST_GROUP(CP_PRIO);     // test group name
+
+static CpPrio_ts        tsPrioS;
+static CpPrioEntry_ts   atsPrioEntryS[PRIO_SIZE];
+
+/*----------------------------------------------------------------------------*\
+** Function implementations                                                   **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//----------------------------------------------------------------------------//
+// PrioPush()                                                                 //
+// add message with identifier and data byte to the queue                     //
+//----------------------------------------------------------------------------//
+static bool_t PrioPush(uint8_t ubFormatV, uint32_t ulIdentifierV,
+                       uint8_t ubDataV, uint32_t ulTickV)
+{
+   CpCanMsg_ts tsCanMsgT;
+
+   CpMsgInit(&tsCanMsgT, ubFormatV);
+   CpMsgSetIdentifier(&tsCanMsgT, ulIdentifierV);
+   CpMsgSetDlc(&tsCanMsgT, 1);
+   CpMsgSetData(&tsCanMsgT, 0, ubDataV);
+
+   return (CpPrioPush(&tsPrioS, &tsCanMsgT, ulTickV));
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_SETUP()                                                               //
+// init code for each test case                                               //
+//----------------------------------------------------------------------------//
+TEST_SETUP(CP_PRIO)
+{
+   memset(&atsPrioEntryS[0], 0, sizeof(atsPrioEntryS));
+   CpPrioInit(&tsPrioS, &atsPrioEntryS[0], PRIO_SIZE);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_TEAR_DOWN()                                                           //
+// release code for each test case                                            //
+//----------------------------------------------------------------------------//
+TEST_TEAR_DOWN(CP_PRIO)
+{
+
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_PRIO_001                                                      //
+// messages are returned in order of identifier priority                      //
+//----------------------------------------------------------------------------//
+TEST(CP_PRIO, 001)
+{
+   CpCanMsg_ts tsCanMsgT;
+   uint32_t    ulKeyT;
+
+   TEST_ASSERT_TRUE(CpPrioIsEmpty(&tsPrioS));
+   TEST_ASSERT_FALSE(CpPrioHead(&tsPrioS, &ulKeyT));
+   TEST_ASSERT_FALSE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0));
+
+   //----------------------------------------------------------------
+   // a block of low priority messages followed by a message with
+   // high priority
+   //
+   TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x700, 1, 0));
+   TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x300, 2, 0));
+   TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x500, 3, 0));
+   TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x010, 4, 0));
+   TEST_ASSERT_EQUAL(4, CpPrioPending(&tsPrioS));
+
+   TEST_ASSERT_TRUE(CpPrioHead(&tsPrioS, &ulKeyT));
+   TEST_ASSERT_EQUAL_HEX32(CpPrioKey(&atsPrioEntryS[0].tsCanMsg), ulKeyT);
+
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0));
+   TEST_ASSERT_EQUAL_HEX32(0x010, CpMsgGetIdentifier(&tsCanMsgT));
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0));
+   TEST_ASSERT_EQUAL_HEX32(0x300, CpMsgGetIdentifier(&tsCanMsgT));
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0));
+   TEST_ASSERT_EQUAL_HEX32(0x500, CpMsgGetIdentifier(&tsCanMsgT));
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0));
+   TEST_ASSERT_EQUAL_HEX32(0x700, CpMsgGetIdentifier(&tsCanMsgT));
+   TEST_ASSERT_EQUAL(1, CpMsgGetData(&tsCanMsgT, 0));
+
+   TEST_ASSERT_TRUE(CpPrioIsEmpty(&tsPrioS));
+
+   UnityPrint("CP_PRIO_001: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_PRIO_002                                                      //
+// messages with the same identifier keep the order of submission             //
+//----------------------------------------------------------------------------//
+TEST(CP_PRIO, 002)
+{
+   CpCanMsg_ts tsCanMsgT;
+   uint8_t     aubNextT[4];
+   uint32_t    ulLastIdT;
+   uint8_t     ubCntT;
+   uint8_t     ubIdxT;
+
+   //----------------------------------------------------------------
+   // fill the queue with four identifiers in mixed order, the data
+   // byte counts the messages of each identifier
+   //
+   memset(&aubNextT[0], 0, sizeof(aubNextT));
+   for (ubCntT = 0; ubCntT < PRIO_SIZE; ubCntT++)
+   {
+      ubIdxT = (uint8_t) ((ubCntT * 7) % 4);
+      TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x100 + ubIdxT,
+                                aubNextT[ubIdxT], 0));
+      aubNextT[ubIdxT]++;
+   }
+   TEST_ASSERT_TRUE(CpPrioIsFull(&tsPrioS));
+   TEST_ASSERT_FALSE(PrioPush(CP_MSG_FORMAT_CBFF, 0x000, 0, 0));
+
+   memset(&aubNextT[0], 0, sizeof(aubNextT));
+   ulLastIdT = 0;
+   while (CpPrioPop(&tsPrioS, &tsCanMsgT, 0))
+   {
+      TEST_ASSERT_TRUE(CpMsgGetIdentifier(&tsCanMsgT) >= ulLastIdT);
+      ulLastIdT = CpMsgGetIdentifier(&tsCanMsgT);
+      ubIdxT    = (uint8_t) (ulLastIdT - 0x100);
+      TEST_ASSERT_EQUAL(aubNextT[ubIdxT], CpMsgGetData(&tsCanMsgT, 0));
+      aubNextT[ubIdxT]++;
+   }
+   TEST_ASSERT_EQUAL(PRIO_SIZE, aubNextT[0] + aubNextT[1] +
+                                aubNextT[2] + aubNextT[3]);
+
+   //----------------------------------------------------------------
+   // the sequence number may wrap around
+   //
+   tsPrioS.ulSequence = 0xFFFFFFFE;
+   for (ubCntT = 0; ubCntT < 4; ubCntT++)
+   {
+      TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x200, ubCntT, 0));
+   }
+   for (ubCntT = 0; ubCntT < 4; ubCntT++)
+   {
+      TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0));
+      TEST_ASSERT_EQUAL(ubCntT, CpMsgGetData(&tsCanMsgT, 0));
+   }
+
+   UnityPrint("CP_PRIO_002: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_PRIO_003                                                      //
+// arbitration of frame formats                                               //
+//----------------------------------------------------------------------------//
+TEST(CP_PRIO, 003)
+{
+   CpCanMsg_ts tsStdDataT;
+   CpCanMsg_ts tsStdRemoteT;
+   CpCanMsg_ts tsExtDataT;
+   CpCanMsg_ts tsExtRemoteT;
+   CpCanMsg_ts tsCanMsgT;
+
+   CpMsgInit(&tsStdDataT, CP_MSG_FORMAT_CBFF);
+   CpMsgSetIdentifier(&tsStdDataT, 0x123);
+   tsStdRemoteT = tsStdDataT;
+   CpMsgSetRemote(&tsStdRemoteT);
+
+   CpMsgInit(&tsExtDataT, CP_MSG_FORMAT_CEFF);
+   CpMsgSetIdentifier(&tsExtDataT, ((uint32_t) 0x123 << 18));
+   tsExtRemoteT = tsExtDataT;
+   CpMsgSetRemote(&tsExtRemoteT);
+
+   //----------------------------------------------------------------
+   // base frame wins against extended frame with the same base
+   // identifier, data frame wins against remote frame
+   //
+   TEST_ASSERT_TRUE(CpPrioKey(&tsStdDataT)   < CpPrioKey(&tsStdRemoteT));
+   TEST_ASSERT_TRUE(CpPrioKey(&tsStdRemoteT) < CpPrioKey(&tsExtDataT));
+   TEST_ASSERT_TRUE(CpPrioKey(&tsExtDataT)   < CpPrioKey(&tsExtRemoteT));
+
+   //----------------------------------------------------------------
+   // extended frame with lower base identifier wins against base
+   // frame
+   //
+   CpMsgSetIdentifier(&tsExtDataT, ((uint32_t) 0x122 << 18) | 0x3FFFF);
+   TEST_ASSERT_TRUE(CpPrioKey(&tsExtDataT) < CpPrioKey(&tsStdDataT));
+
+   TEST_ASSERT_TRUE(CpPrioPush(&tsPrioS, &tsExtRemoteT, 0));
+   TEST_ASSERT_TRUE(CpPrioPush(&tsPrioS, &tsStdRemoteT, 0));
+   TEST_ASSERT_TRUE(CpPrioPush(&tsPrioS, &tsStdDataT, 0));
+   TEST_ASSERT_TRUE(CpPrioPush(&tsPrioS, &tsExtDataT, 0));
+
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0));
+   TEST_ASSERT_TRUE(CpMsgIsExtended(&tsCanMsgT));
+   TEST_ASSERT_FALSE(CpMsgIsRemote(&tsCanMsgT));
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0));
+   TEST_ASSERT_FALSE(CpMsgIsExtended(&tsCanMsgT));
+   TEST_ASSERT_FALSE(CpMsgIsRemote(&tsCanMsgT));
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0));
+   TEST_ASSERT_FALSE(CpMsgIsExtended(&tsCanMsgT));
+   TEST_ASSERT_TRUE(CpMsgIsRemote(&tsCanMsgT));
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0));
+   TEST_ASSERT_TRUE(CpMsgIsExtended(&tsCanMsgT));
+   TEST_ASSERT_TRUE(CpMsgIsRemote(&tsCanMsgT));
+
+   UnityPrint("CP_PRIO_003: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_PRIO_004                                                      //
+// queueing delay per priority class                                          //
+//----------------------------------------------------------------------------//
+TEST(CP_PRIO, 004)
+{
+   CpCanMsg_ts tsCanMsgT;
+
+   TEST_ASSERT_EQUAL(0, CpPrioClass(0));
+   TEST_ASSERT_EQUAL(CP_PRIO_CLASS_MAX - 1, CpPrioClass(0xFFFFFFFF));
+
+   //----------------------------------------------------------------
+   // a message with high priority submitted after a block with low
+   // priority is not delayed by the block
+   //
+   TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x7F0, 0, 100));
+   TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x7F0, 1, 100));
+   TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x7F0, 2, 100));
+   TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x001, 0, 110));
+
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 112));
+   TEST_ASSERT_EQUAL_HEX32(0x001, CpMsgGetIdentifier(&tsCanMsgT));
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 114));
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 116));
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 130));
+
+   TEST_ASSERT_EQUAL(1,  tsPrioS.atsDelay[0].ulMsgCount);
+   TEST_ASSERT_EQUAL(2,  tsPrioS.atsDelay[0].ulDelaySum);
+   TEST_ASSERT_EQUAL(2,  tsPrioS.atsDelay[0].ulDelayMax);
+
+   TEST_ASSERT_EQUAL(3,  tsPrioS.atsDelay[CP_PRIO_CLASS_MAX - 1].ulMsgCount);
+   TEST_ASSERT_EQUAL(60, tsPrioS.atsDelay[CP_PRIO_CLASS_MAX - 1].ulDelaySum);
+   TEST_ASSERT_EQUAL(30, tsPrioS.atsDelay[CP_PRIO_CLASS_MAX - 1].ulDelayMax);
+
+   //----------------------------------------------------------------
+   // the tick counter may wrap around
+   //
+   TEST_ASSERT_TRUE(PrioPush(CP_MSG_FORMAT_CBFF, 0x001, 0, 0xFFFFFFF0));
+   TEST_ASSERT_TRUE(CpPrioPop(&tsPrioS, &tsCanMsgT, 0x00000010));
+   TEST_ASSERT_EQUAL(0x20, tsPrioS.atsDelay[0].ulDelayMax);
+
+   UnityPrint("CP_PRIO_004: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_GROUP_RUNNER()                                                        //
+// execute all test cases                                                     //
+//----------------------------------------------------------------------------//
+TEST_GROUP_RUNNER(CP_PRIO)
+{
+   UnityPrint("--- Run test group: CP_PRIO ----------------------------------");
+   printf("\n");
+
+   RUN_TEST_CASE(CP_PRIO, 001);
+   RUN_TEST_CASE(CP_PRIO, 002);
+   RUN_TEST_CASE(CP_PRIO, 003);
+   RUN_TEST_CASE(CP_PRIO, 004);
+   printf("\n");
+
+}
+
@@ -0,0 +1,641 @@
+//============================================================================//
+// File:          test_qcan_client.c                                          //
+// Description:   Unit tests for QCan client library                          //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//-------------------------------------------------------------------
+// socketpair() is not part of C99
+//
+#define  _POSIX_C_SOURCE   200809L
+
+#include "qcan_client_canpie_fd.h"
+#include "cp_fifo.h"
+#include "unity_fixture.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#define  FRAME_COUNT    20
+
+//-------------------------------------------------------------------
+// time in milli-seconds a server test waits for frames
+//
+#define  SERVER_TIMEOUT 1000
+
+/*----------------------------------------------------------------------------*\
+** Variables of module                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+TEST_GROUP(QCAN_CLIENT);        // test group name
+TEST_GROUP(QCAN_CLIENT_SERVER); // test group name, needs a running QCanServer
+
+static QCanClient_ts tsClientS;
+static int           aslPeerS[2];
+static CpCanMsg_ts   atsTrmMsgS[FRAME_COUNT];
+static CpCanMsg_ts   atsRcvMsgS[FRAME_COUNT];
+static uint8_t       aubStreamS[FRAME_COUNT * QCAN_CLIENT_RECORD_SIZE];
+
+static CpPort_ts     tsPortS;
+static CpFifo_ts     tsFifoS;
+static CpCanMsg_ts   atsFifoMsgS[FRAME_COUNT];
+
+/*----------------------------------------------------------------------------*\
+** Function implementations                                                   **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//----------------------------------------------------------------------------//
+// TestMsgEqual()                                                             //
+// compare fields of two CAN messages transferred by a record                 //
+//----------------------------------------------------------------------------//
+static void TestMsgEqual(CpCanMsg_ts *ptsExpectedV, CpCanMsg_ts *ptsActualV)
+{
+   TEST_ASSERT_EQUAL_HEX32(ptsExpectedV->ulIdentifier, ptsActualV->ulIdentifier);
+   TEST_ASSERT_EQUAL_HEX8(ptsExpectedV->ubMsgCtrl, ptsActualV->ubMsgCtrl);
+   TEST_ASSERT_EQUAL(ptsExpectedV->ubMsgDLC, ptsActualV->ubMsgDLC);
+   TEST_ASSERT_EQUAL_MEMORY(&(ptsExpectedV->tuMsgData.aubByte[0]),
+                            &(ptsActualV->tuMsgData.aubByte[0]),
+                            CP_DATA_SIZE);
+}
+
+
+//----------------------------------------------------------------------------//
+// TestStreamWrite()                                                          //
+// write bytes to the peer of the client socket                               //
+//----------------------------------------------------------------------------//
+static void TestStreamWrite(CPP_CONST uint8_t *pubDataV, uint32_t ulSizeV)
+{
+   TEST_ASSERT_EQUAL((ssize_t) ulSizeV, write(aslPeerS[1], pubDataV, ulSizeV));
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_SETUP()                                                               //
+// init code for each test case                                               //
+//----------------------------------------------------------------------------//
+TEST_SETUP(QCAN_CLIENT)
+{
+   uint32_t ulMsgIdxT;
+   uint8_t  ubByteT;
+
+   memset(&atsTrmMsgS[0], 0, sizeof(atsTrmMsgS));
+   memset(&atsRcvMsgS[0], 0, sizeof(atsRcvMsgS));
+
+   //----------------------------------------------------------------
+   // alternate between classic standard frames and extended
+   // CAN FD frames
+   //
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      if (ulMsgIdxT & 1)
+      {
+         atsTrmMsgS[ulMsgIdxT].ulIdentifier = 0x18FEA500UL + ulMsgIdxT;
+         atsTrmMsgS[ulMsgIdxT].ubMsgCtrl    = CP_MSG_CTRL_EXT_BIT |
+                                              CP_MSG_CTRL_FDF_BIT |
+                                              CP_MSG_CTRL_BRS_BIT;
+         atsTrmMsgS[ulMsgIdxT].ubMsgDLC     = 15;
+         for (ubByteT = 0; ubByteT < 64; ubByteT++)
+         {
+            atsTrmMsgS[ulMsgIdxT].tuMsgData.aubByte[ubByteT] =
+                                             (uint8_t) (ulMsgIdxT + ubByteT);
+         }
+      }
+      else
+      {
+         atsTrmMsgS[ulMsgIdxT].ulIdentifier = 0x100 + ulMsgIdxT;
+         atsTrmMsgS[ulMsgIdxT].ubMsgDLC     = 8;
+         for (ubByteT = 0; ubByteT < 8; ubByteT++)
+         {
+            atsTrmMsgS[ulMsgIdxT].tuMsgData.aubByte[ubByteT] =
+                                             (uint8_t) (ulMsgIdxT * ubByteT);
+         }
+      }
+      atsTrmMsgS[ulMsgIdxT].tsMsgTime.ulSec1970 = 1500000000UL + ulMsgIdxT;
+      atsTrmMsgS[ulMsgIdxT].tsMsgTime.ulNanoSec = 1000UL * ulMsgIdxT;
+      atsTrmMsgS[ulMsgIdxT].ulMsgUser           = 0xCAFE0000UL + ulMsgIdxT;
+      atsTrmMsgS[ulMsgIdxT].ulMsgMarker         = ulMsgIdxT;
+   }
+
+   //----------------------------------------------------------------
+   // connect the client to one end of a socket pair, the test
+   // plays the server at the other end
+   //
+   QCanClientInit(&tsClientS);
+   TEST_ASSERT_EQUAL(0, socketpair(AF_UNIX, SOCK_STREAM, 0, &aslPeerS[0]));
+   fcntl(aslPeerS[0], F_SETFL, fcntl(aslPeerS[0], F_GETFL) | O_NONBLOCK);
+   tsClientS.slSocket = aslPeerS[0];
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_TEAR_DOWN()                                                           //
+// clean-up code for each test case                                           //
+//----------------------------------------------------------------------------//
+TEST_TEAR_DOWN(QCAN_CLIENT)
+{
+   QCanClientDisconnect(&tsClientS);
+   close(aslPeerS[1]);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_CASE()                                                                //
+// check value of the checksum, equal to qChecksum() of Qt                    //
+//----------------------------------------------------------------------------//
+TEST(QCAN_CLIENT, 001)
+{
+   CPP_CONST uint8_t aubCheckT[] = "123456789";
+
+   TEST_ASSERT_EQUAL_HEX16(0x906E, QCanClientChecksum(&aubCheckT[0], 9));
+   TEST_ASSERT_EQUAL_HEX16(0x0000, QCanClientChecksum(&aubCheckT[0], 0));
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_CASE()                                                                //
+// byte layout of a record and round trip                                     //
+//----------------------------------------------------------------------------//
+TEST(QCAN_CLIENT, 002)
+{
+   uint8_t  aubRecordT[QCAN_CLIENT_RECORD_SIZE];
+   uint16_t uwChecksumT;
+   uint8_t  ubMsgIdxT;
+
+   //----------------------------------------------------------------
+   // check the fields of an extended CAN FD frame
+   //
+   QCanClientRecordEncode(&atsTrmMsgS[1], &aubRecordT[0]);
+   TEST_ASSERT_EQUAL_HEX8(0x18, aubRecordT[0]);
+   TEST_ASSERT_EQUAL_HEX8(0xFE, aubRecordT[1]);
+   TEST_ASSERT_EQUAL_HEX8(0xA5, aubRecordT[2]);
+   TEST_ASSERT_EQUAL_HEX8(0x01, aubRecordT[3]);
+   TEST_ASSERT_EQUAL_HEX8(15, aubRecordT[4]);
+   TEST_ASSERT_EQUAL_HEX8(CP_MSG_CTRL_EXT_BIT | CP_MSG_CTRL_FDF_BIT |
+                          CP_MSG_CTRL_BRS_BIT, aubRecordT[5]);
+   TEST_ASSERT_EQUAL_MEMORY(&(atsTrmMsgS[1].tuMsgData.aubByte[0]),
+                            &aubRecordT[6], 64);
+   TEST_ASSERT_EQUAL_HEX8(0x00, aubRecordT[87]);
+
+   uwChecksumT = QCanClientChecksum(&aubRecordT[0], 94);
+   TEST_ASSERT_EQUAL_HEX8((uint8_t) (uwChecksumT >> 8), aubRecordT[94]);
+   TEST_ASSERT_EQUAL_HEX8((uint8_t) (uwChecksumT), aubRecordT[95]);
+
+   //----------------------------------------------------------------
+   // all fields survive encoding and decoding
+   //
+   for (ubMsgIdxT = 0; ubMsgIdxT < FRAME_COUNT; ubMsgIdxT++)
+   {
+      QCanClientRecordEncode(&atsTrmMsgS[ubMsgIdxT], &aubRecordT[0]);
+      TEST_ASSERT_TRUE(QCanClientRecordDecode(&aubRecordT[0],
+                                              &atsRcvMsgS[ubMsgIdxT]));
+      TestMsgEqual(&atsTrmMsgS[ubMsgIdxT], &atsRcvMsgS[ubMsgIdxT]);
+      TEST_ASSERT_EQUAL(atsTrmMsgS[ubMsgIdxT].tsMsgTime.ulSec1970,
+                        atsRcvMsgS[ubMsgIdxT].tsMsgTime.ulSec1970);
+      TEST_ASSERT_EQUAL(atsTrmMsgS[ubMsgIdxT].tsMsgTime.ulNanoSec,
+                        atsRcvMsgS[ubMsgIdxT].tsMsgTime.ulNanoSec);
+      TEST_ASSERT_EQUAL_HEX32(atsTrmMsgS[ubMsgIdxT].ulMsgUser,
+                              atsRcvMsgS[ubMsgIdxT].ulMsgUser);
+      TEST_ASSERT_EQUAL(atsTrmMsgS[ubMsgIdxT].ulMsgMarker,
+                        atsRcvMsgS[ubMsgIdxT].ulMsgMarker);
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_CASE()                                                                //
+// a record with a wrong checksum is rejected                                 //
+//----------------------------------------------------------------------------//
+TEST(QCAN_CLIENT, 003)
+{
+   uint8_t  aubRecordT[QCAN_CLIENT_RECORD_SIZE];
+
+   QCanClientRecordEncode(&atsTrmMsgS[0], &aubRecordT[0]);
+   aubRecordT[10] ^= 0x01;
+   TEST_ASSERT_FALSE(QCanClientRecordDecode(&aubRecordT[0], &atsRcvMsgS[0]));
+
+   //----------------------------------------------------------------
+   // the client skips the corrupted record and counts the error
+   //
+   QCanClientRecordEncode(&atsTrmMsgS[1], &aubStreamS[0]);
+   memcpy(&aubStreamS[QCAN_CLIENT_RECORD_SIZE], &aubRecordT[0],
+          QCAN_CLIENT_RECORD_SIZE);
+   QCanClientRecordEncode(&atsTrmMsgS[2], &aubStreamS[2 * QCAN_CLIENT_RECORD_SIZE]);
+   TestStreamWrite(&aubStreamS[0], 3 * QCAN_CLIENT_RECORD_SIZE);
+
+   TEST_ASSERT_EQUAL(2, QCanClientRead(&tsClientS, &atsRcvMsgS[0], FRAME_COUNT));
+   TestMsgEqual(&atsTrmMsgS[1], &atsRcvMsgS[0]);
+   TestMsgEqual(&atsTrmMsgS[2], &atsRcvMsgS[1]);
+   TEST_ASSERT_EQUAL(1, tsClientS.ulErrorCount);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_CASE()                                                                //
+// records split at arbitrary positions of the byte stream                    //
+//----------------------------------------------------------------------------//
+TEST(QCAN_CLIENT, 004)
+{
+   uint32_t ulMsgIdxT;
+   uint32_t ulPosT = 0;
+   uint32_t ulStepT;
+   uint32_t ulRcvCntT = 0;
+   int32_t  slResultT;
+
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      QCanClientRecordEncode(&atsTrmMsgS[ulMsgIdxT],
+                             &aubStreamS[ulMsgIdxT * QCAN_CLIENT_RECORD_SIZE]);
+   }
+
+   //----------------------------------------------------------------
+   // nothing available, the client must not block
+   //
+   TEST_ASSERT_EQUAL(0, QCanClientRead(&tsClientS, &atsRcvMsgS[0], FRAME_COUNT));
+   TEST_ASSERT_EQUAL(0, QCanClientWait(&tsClientS, 0));
+
+   //----------------------------------------------------------------
+   // write the stream in pieces of changing size
+   //
+   ulStepT = 1;
+   while (ulPosT < sizeof(aubStreamS))
+   {
+      if (ulStepT > (sizeof(aubStreamS) - ulPosT))
+      {
+         ulStepT = sizeof(aubStreamS) - ulPosT;
+      }
+      TestStreamWrite(&aubStreamS[ulPosT], ulStepT);
+      ulPosT  += ulStepT;
+      ulStepT  = (ulStepT * 7 + 13) % 250 + 1;
+
+      TEST_ASSERT_EQUAL(1, QCanClientWait(&tsClientS, 100));
+      slResultT = QCanClientRead(&tsClientS, &atsRcvMsgS[ulRcvCntT],
+                                 FRAME_COUNT - ulRcvCntT);
+      TEST_ASSERT_TRUE(slResultT >= 0);
+      ulRcvCntT += (uint32_t) slResultT;
+   }
+
+   TEST_ASSERT_EQUAL(FRAME_COUNT, ulRcvCntT);
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      TestMsgEqual(&atsTrmMsgS[ulMsgIdxT], &atsRcvMsgS[ulMsgIdxT]);
+   }
+   TEST_ASSERT_EQUAL(0, tsClientS.ulErrorCount);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_CASE()                                                                //
+// control records of the network are skipped                                //
+//----------------------------------------------------------------------------//
+TEST(QCAN_CLIENT, 005)
+{
+   QCanClientRecordEncode(&atsTrmMsgS[0], &aubStreamS[0]);
+   QCanClientRecordEncode(&atsTrmMsgS[1], &aubStreamS[QCAN_CLIENT_RECORD_SIZE]);
+   aubStreamS[QCAN_CLIENT_RECORD_SIZE + 87] = 0x01;
+   QCanClientRecordEncode(&atsTrmMsgS[2], &aubStreamS[2 * QCAN_CLIENT_RECORD_SIZE]);
+   TestStreamWrite(&aubStreamS[0], 3 * QCAN_CLIENT_RECORD_SIZE);
+
+   TEST_ASSERT_EQUAL(2, QCanClientRead(&tsClientS, &atsRcvMsgS[0], FRAME_COUNT));
+   TestMsgEqual(&atsTrmMsgS[0], &atsRcvMsgS[0]);
+   TestMsgEqual(&atsTrmMsgS[2], &atsRcvMsgS[1]);
+   TEST_ASSERT_EQUAL(0, tsClientS.ulErrorCount);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_CASE()                                                                //
+// batched write and read, limited by the size of the message array           //
+//----------------------------------------------------------------------------//
+TEST(QCAN_CLIENT, 006)
+{
+   uint32_t ulMsgIdxT;
+
+   TEST_ASSERT_EQUAL(FRAME_COUNT, QCanClientWrite(&tsClientS, &atsTrmMsgS[0],
+                                                  FRAME_COUNT));
+   TEST_ASSERT_EQUAL(0, QCanClientFlush(&tsClientS));
+
+   TEST_ASSERT_EQUAL((ssize_t) sizeof(aubStreamS),
+                     read(aslPeerS[1], &aubStreamS[0], sizeof(aubStreamS)));
+
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      TEST_ASSERT_TRUE(QCanClientRecordDecode(
+                             &aubStreamS[ulMsgIdxT * QCAN_CLIENT_RECORD_SIZE],
+                             &atsRcvMsgS[ulMsgIdxT]));
+      TestMsgEqual(&atsTrmMsgS[ulMsgIdxT], &atsRcvMsgS[ulMsgIdxT]);
+   }
+
+   //----------------------------------------------------------------
+   // send the records back, read them in two blocks
+   //
+   TestStreamWrite(&aubStreamS[0], sizeof(aubStreamS));
+   TEST_ASSERT_EQUAL(5, QCanClientRead(&tsClientS, &atsRcvMsgS[0], 5));
+   TEST_ASSERT_EQUAL(FRAME_COUNT - 5,
+                     QCanClientRead(&tsClientS, &atsRcvMsgS[5], FRAME_COUNT));
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      TestMsgEqual(&atsTrmMsgS[ulMsgIdxT], &atsRcvMsgS[ulMsgIdxT]);
+   }
+
+   //----------------------------------------------------------------
+   // the client reports a closed connection
+   //
+   close(aslPeerS[1]);
+   aslPeerS[1] = -1;
+   TEST_ASSERT_EQUAL(-1, QCanClientRead(&tsClientS, &atsRcvMsgS[0], FRAME_COUNT));
+   TEST_ASSERT_EQUAL(-1, tsClientS.slSocket);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_CASE()                                                                //
+// the driver transmits the messages of a FIFO to a local TCP server, in      //
+// order of CAN priority if the driver is built with CP_TRM_PRIORITY > 0      //
+//----------------------------------------------------------------------------//
+TEST(QCAN_CLIENT, 007)
+{
+   struct sockaddr_in   tsAddrT;
+   socklen_t            tvAddrSizeT = sizeof(tsAddrT);
+   CpPort_ts            tsPortT;
+   CpCanMsg_ts          atsWriteT[FRAME_COUNT];
+   uint32_t             ulMsgCntT;
+   uint32_t             ulMsgIdxT;
+   uint32_t             ulPosT = 0;
+   ssize_t              slResultT;
+   int                  slListenT;
+   int                  slServerT;
+
+   //----------------------------------------------------------------
+   // the test plays the server on an ephemeral TCP port, which is
+   // used for CAN channel 2
+   //
+   slListenT = socket(AF_INET, SOCK_STREAM, 0);
+   TEST_ASSERT_TRUE(slListenT >= 0);
+   memset(&tsAddrT, 0, sizeof(tsAddrT));
+   tsAddrT.sin_family      = AF_INET;
+   tsAddrT.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+   tsAddrT.sin_port        = 0;
+   TEST_ASSERT_EQUAL(0, bind(slListenT, (struct sockaddr *) &tsAddrT,
+                             sizeof(tsAddrT)));
+   TEST_ASSERT_EQUAL(0, listen(slListenT, 1));
+   TEST_ASSERT_EQUAL(0, getsockname(slListenT, (struct sockaddr *) &tsAddrT,
+                                    &tvAddrSizeT));
+
+   memset(&tsPortT, 0, sizeof(tsPortT));
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpSocketSetHostAddress(eCP_CHANNEL_2,
+                                         "127.0.0.1",
+                                         (uint16_t) (ntohs(tsAddrT.sin_port) - 1)));
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreDriverInit(eCP_CHANNEL_2, &tsPortT, 0));
+   slServerT = accept(slListenT, (struct sockaddr *) 0L, (socklen_t *) 0L);
+   TEST_ASSERT_TRUE(slServerT >= 0);
+
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreBufferConfig(&tsPortT, eCP_BUFFER_2,
+                                                      0, 0,
+                                                      CP_MSG_FORMAT_FEFF,
+                                                      eCP_BUFFER_DIR_TRM));
+   CpFifoInit(&tsFifoS, &atsFifoMsgS[0], FRAME_COUNT);
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreFifoConfig(&tsPortT, eCP_BUFFER_2,
+                                                    &tsFifoS));
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreCanMode(&tsPortT, eCP_MODE_START));
+
+   //----------------------------------------------------------------
+   // write all messages in reverse order with one call
+   //
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      atsWriteT[ulMsgIdxT] = atsTrmMsgS[FRAME_COUNT - 1 - ulMsgIdxT];
+   }
+   ulMsgCntT = FRAME_COUNT;
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreFifoWrite(&tsPortT, eCP_BUFFER_2,
+                                                   &atsWriteT[0], &ulMsgCntT));
+   TEST_ASSERT_EQUAL(FRAME_COUNT, ulMsgCntT);
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpSocketPoll(&tsPortT, 0));
+
+   while (ulPosT < sizeof(aubStreamS))
+   {
+      slResultT = read(slServerT, &aubStreamS[ulPosT], sizeof(aubStreamS) - ulPosT);
+      TEST_ASSERT_TRUE(slResultT > 0);
+      ulPosT += (uint32_t) slResultT;
+   }
+
+   //----------------------------------------------------------------
+   // with priority all standard frames precede the extended frames,
+   // otherwise the messages keep the order of the write call
+   //
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      TEST_ASSERT_TRUE(QCanClientRecordDecode(
+                             &aubStreamS[ulMsgIdxT * QCAN_CLIENT_RECORD_SIZE],
+                             &atsRcvMsgS[ulMsgIdxT]));
+      #if CP_TRM_PRIORITY > 0
+      if (ulMsgIdxT < (FRAME_COUNT / 2))
+      {
+         TestMsgEqual(&atsTrmMsgS[ulMsgIdxT * 2], &atsRcvMsgS[ulMsgIdxT]);
+      }
+      else
+      {
+         TestMsgEqual(&atsTrmMsgS[(ulMsgIdxT - (FRAME_COUNT / 2)) * 2 + 1],
+                      &atsRcvMsgS[ulMsgIdxT]);
+      }
+      #else
+      TestMsgEqual(&atsWriteT[ulMsgIdxT], &atsRcvMsgS[ulMsgIdxT]);
+      #endif
+   }
+
+   CpCoreDriverRelease(&tsPortT);
+   CpSocketSetHostAddress(eCP_CHANNEL_2, (CPP_CONST char *) 0L, 0);
+   close(slServerT);
+   close(slListenT);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_SETUP()                                                               //
+// init code for each test case                                               //
+//----------------------------------------------------------------------------//
+TEST_SETUP(QCAN_CLIENT_SERVER)
+{
+   memset(&tsPortS, 0, sizeof(tsPortS));
+   CpFifoInit(&tsFifoS, &atsFifoMsgS[0], FRAME_COUNT);
+   QCanClientInit(&tsClientS);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_TEAR_DOWN()                                                           //
+// clean-up code for each test case                                           //
+//----------------------------------------------------------------------------//
+TEST_TEAR_DOWN(QCAN_CLIENT_SERVER)
+{
+   CpCoreDriverRelease(&tsPortS);
+   QCanClientDisconnect(&tsClientS);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_CASE()                                                                //
+// exchange frames with a second client through CAN channel 1                 //
+//----------------------------------------------------------------------------//
+TEST(QCAN_CLIENT_SERVER, 001)
+{
+   uint32_t ulMsgCntT;
+   uint32_t ulRcvCntT;
+   uint32_t ulMsgIdxT;
+   uint32_t ulLoopT;
+   int32_t  slResultT;
+
+   if (CpCoreDriverInit(eCP_CHANNEL_1, &tsPortS, 0) != eCP_ERR_NONE)
+   {
+      TEST_IGNORE_MESSAGE("QCanServer not running");
+   }
+   TEST_ASSERT_TRUE(CpSocketDescriptor(&tsPortS) >= 0);
+   TEST_ASSERT_EQUAL(0, QCanClientConnect(&tsClientS, eCP_CHANNEL_1, 0L, 0));
+
+   //----------------------------------------------------------------
+   // receive FIFO for all extended frames
+   //
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreBufferConfig(&tsPortS, eCP_BUFFER_1,
+                                                      0, 0,
+                                                      CP_MSG_FORMAT_FEFF,
+                                                      eCP_BUFFER_DIR_RCV));
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreFifoConfig(&tsPortS, eCP_BUFFER_1,
+                                                    &tsFifoS));
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreCanMode(&tsPortS, eCP_MODE_START));
+
+   //----------------------------------------------------------------
+   // the second client sends all frames, only the extended frames
+   // are accepted by the driver
+   //
+   TEST_ASSERT_EQUAL(FRAME_COUNT, QCanClientWrite(&tsClientS, &atsTrmMsgS[0],
+                                                  FRAME_COUNT));
+   ulRcvCntT = 0;
+   for (ulLoopT = 0; (ulLoopT < 100) && (ulRcvCntT < FRAME_COUNT / 2); ulLoopT++)
+   {
+      TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpSocketPoll(&tsPortS, SERVER_TIMEOUT / 100));
+      ulMsgCntT = FRAME_COUNT - ulRcvCntT;
+      CpCoreFifoRead(&tsPortS, eCP_BUFFER_1, &atsRcvMsgS[ulRcvCntT], &ulMsgCntT);
+      ulRcvCntT += ulMsgCntT;
+   }
+   TEST_ASSERT_EQUAL(FRAME_COUNT / 2, ulRcvCntT);
+   for (ulMsgIdxT = 0; ulMsgIdxT < ulRcvCntT; ulMsgIdxT++)
+   {
+      TestMsgEqual(&atsTrmMsgS[ulMsgIdxT * 2 + 1], &atsRcvMsgS[ulMsgIdxT]);
+   }
+
+   //----------------------------------------------------------------
+   // the driver sends all frames, the second client receives them
+   //
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreBufferConfig(&tsPortS, eCP_BUFFER_2,
+                                                      0, 0,
+                                                      CP_MSG_FORMAT_FEFF,
+                                                      eCP_BUFFER_DIR_TRM));
+   CpFifoInit(&tsFifoS, &atsFifoMsgS[0], FRAME_COUNT);
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreFifoConfig(&tsPortS, eCP_BUFFER_2,
+                                                    &tsFifoS));
+   ulMsgCntT = FRAME_COUNT;
+   TEST_ASSERT_EQUAL(eCP_ERR_NONE, CpCoreFifoWrite(&tsPortS, eCP_BUFFER_2,
+                                                   &atsTrmMsgS[0], &ulMsgCntT));
+   TEST_ASSERT_EQUAL(FRAME_COUNT, ulMsgCntT);
+
+   ulRcvCntT = 0;
+   for (ulLoopT = 0; (ulLoopT < 100) && (ulRcvCntT < FRAME_COUNT); ulLoopT++)
+   {
+      CpSocketPoll(&tsPortS, 0);
+      QCanClientWait(&tsClientS, SERVER_TIMEOUT / 100);
+      slResultT = QCanClientRead(&tsClientS, &atsRcvMsgS[ulRcvCntT],
+                                 FRAME_COUNT - ulRcvCntT);
+      TEST_ASSERT_TRUE(slResultT >= 0);
+      ulRcvCntT += (uint32_t) slResultT;
+   }
+   TEST_ASSERT_EQUAL(FRAME_COUNT, ulRcvCntT);
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      TestMsgEqual(&atsTrmMsgS[ulMsgIdxT], &atsRcvMsgS[ulMsgIdxT]);
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_GROUP_RUNNER()                                                        //
+// execute all test cases                                                     //
+//----------------------------------------------------------------------------//
+TEST_GROUP_RUNNER(QCAN_CLIENT)
+{
+   UnityPrint("--- Run test group: QCAN_CLIENT -----------------------------");
+   printf("\n");
+
+   RUN_TEST_CASE(QCAN_CLIENT, 001);
+   RUN_TEST_CASE(QCAN_CLIENT, 002);
+   RUN_TEST_CASE(QCAN_CLIENT, 003);
+   RUN_TEST_CASE(QCAN_CLIENT, 004);
+   RUN_TEST_CASE(QCAN_CLIENT, 005);
+   RUN_TEST_CASE(QCAN_CLIENT, 006);
+   RUN_TEST_CASE(QCAN_CLIENT, 007);
+   printf("\n");
+
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_GROUP_RUNNER()                                                        //
+// execute all test cases                                                     //
+//----------------------------------------------------------------------------//
+TEST_GROUP_RUNNER(QCAN_CLIENT_SERVER)
+{
+   UnityPrint("--- Run test group: QCAN_CLIENT_SERVER ----------------------");
+   printf("\n");
+
+   RUN_TEST_CASE(QCAN_CLIENT_SERVER, 001);
+   printf("\n");
+
+}
@@ -9,7 +9,12 @@ using namespace std;
 
 
 #include "test_qcan_timestamp.hpp"
+#include "test_qcan_trace.hpp"
 #include "test_qcan_frame.hpp"
+#include "test_qcan_isotp.hpp"
+#include "test_qcan_network.hpp"
+#include "test_qcan_recorder.hpp"
+#include "test_qcan_signal.hpp"
 #include "test_qcan_socket.hpp"
 
 
@@ -17,6 +22,11 @@ int main(int argc, char *argv[])
 {
    int32_t  slResultT;
 
+   //----------------------------------------------------------------
+   // the network test needs an event loop
+   //
+   QCoreApplication clAppT(argc, argv);
+
    cout << "#===========================================================\n";
    cout << "# Run test cases for QCan classes                           \n";
    cout << "#                                                           \n";
@@ -43,6 +53,36 @@ int main(int argc, char *argv[])
    TestQCanSocket  clTestQCanSockT;
    slResultT = QTest::qExec(&clTestQCanSockT) + slResultT;
 
+   //----------------------------------------------------------------
+   // test QCanNetwork
+   //
+   TestQCanNetwork  clTestQCanNetworkT;
+   slResultT = QTest::qExec(&clTestQCanNetworkT, argc, &argv[0]) + slResultT;
+
+   //----------------------------------------------------------------
+   // test QCanSignalDatabase
+   //
+   TestQCanSignal  clTestQCanSignalT;
+   slResultT = QTest::qExec(&clTestQCanSignalT, argc, &argv[0]) + slResultT;
+
+   //----------------------------------------------------------------
+   // test QCanTraceReader / QCanTraceWriter
+   //
+   TestQCanTrace  clTestQCanTraceT;
+   slResultT = QTest::qExec(&clTestQCanTraceT, argc, &argv[0]) + slResultT;
+
+   //----------------------------------------------------------------
+   // test QCanRecorder
+   //
+   TestQCanRecorder  clTestQCanRecorderT;
+   slResultT = QTest::qExec(&clTestQCanRecorderT, argc, &argv[0]) + slResultT;
+
+   //----------------------------------------------------------------
+   // test QCanIsoTp
+   //
+   TestQCanIsoTp  clTestQCanIsoTpT;
+   slResultT = QTest::qExec(&clTestQCanIsoTpT, argc, &argv[0]) + slResultT;
+
    cout << "\n";
    cout << "#===========================================================\n";
    cout << "# Total result                                              \n";
@@ -257,6 +257,9 @@ void TestQCanFrame::checkFrameData()
    QVERIFY(pclCanStdP->data(1) == 0xAA);
    QVERIFY(pclCanStdP->dataUInt16(0, 0) == 0xAABB);
 
+   QVERIFY(pclCanStdP->constData()[0] == 0xBB);
+   QVERIFY(pclCanStdP->constData()[1] == 0xAA);
+   QVERIFY(pclCanStdP->constData()[3] == 0x78);
 }
 
 
@@ -312,6 +315,46 @@ void TestQCanFrame::checkByteArray()
    }
 }
 
+//----------------------------------------------------------------------------//
+// checkBuffer()                                                              //
+// convert frames to a buffer and back                                        //
+//----------------------------------------------------------------------------//
+void TestQCanFrame::checkBuffer()
+{
+   uint8_t     aubBufferT[2 * QCAN_FRAME_ARRAY_SIZE];
+
+   //----------------------------------------------------------------
+   // the buffer format is equal to the byte array format
+   //
+   pclFdExtP->setIdentifier(0x1ABCDEF0);
+   pclFdExtP->setDlc(15);
+   pclFdExtP->setData(63, 0xA5);
+   pclFdExtP->setMarker(0x80112233);
+   pclFdExtP->setUser(0xFF445566);
+   pclFdExtP->toBuffer(&aubBufferT[0]);
+   pclCanStdP->toBuffer(&aubBufferT[QCAN_FRAME_ARRAY_SIZE]);
+
+   QVERIFY(QByteArray((const char *) &aubBufferT[0], QCAN_FRAME_ARRAY_SIZE) == pclFdExtP->toByteArray());
+
+   QVERIFY(pclFrameP->fromBuffer(&aubBufferT[0]) == true);
+   QVERIFY(pclFrameP->identifier() == 0x1ABCDEF0);
+   QVERIFY(pclFrameP->frameFormat() == QCanFrame::eFORMAT_FD_EXT);
+   QVERIFY(pclFrameP->dlc() == 15);
+   QVERIFY(pclFrameP->data(63) == 0xA5);
+   QVERIFY(pclFrameP->marker() == 0x80112233);
+   QVERIFY(pclFrameP->user() == 0xFF445566);
+
+   QVERIFY(pclFrameP->fromBuffer(&aubBufferT[QCAN_FRAME_ARRAY_SIZE]) == true);
+   QVERIFY(pclFrameP->identifier() == pclCanStdP->identifier());
+
+   //----------------------------------------------------------------
+   // a modified buffer is rejected
+   //
+   aubBufferT[10] ^= 0x01;
+   QVERIFY(pclFrameP->fromBuffer(&aubBufferT[0]) == false);
+}
+
+
 //----------------------------------------------------------------------------//
 // cleanupTestCase()                                                          //
 // cleanup test cases                                                         //
@@ -71,6 +71,7 @@ private slots:
    void checkFrameData();
    void checkFrameRemote();
    void checkByteArray();
+   void checkBuffer();
    void cleanupTestCase();
 };
 
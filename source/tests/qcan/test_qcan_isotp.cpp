@@ -0,0 +1,485 @@
+//============================================================================//
+// File:          test_qcan_isotp.cpp                                         //
+// Description:   QCAN classes - Test ISO-TP transport protocol               //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+#include <QtCore/QElapsedTimer>
+#include <QtTest/QSignalSpy>
+
+#include "test_qcan_isotp.hpp"
+
+
+//-------------------------------------------------------------------
+// bit-rates for the theoretical limit of the throughput benchmark
+//
+#define  TEST_NOM_BITRATE     500000
+#define  TEST_DAT_BITRATE     2000000
+
+
+//----------------------------------------------------------------------------//
+// busRate()                                                                  //
+// theoretical ISO-TP payload rate in bytes per second                        //
+//----------------------------------------------------------------------------//
+static double busRate(bool btCanFdV)
+{
+   double   ftFrameTimeT;
+
+   //----------------------------------------------------------------
+   // consecutive frames are transmitted back to back, the header
+   // uses the bit model of QCanNetwork (66 bits for a standard
+   // frame), for CAN FD the data field is transmitted with the
+   // data bit-rate
+   //
+   if (btCanFdV == true)
+   {
+      ftFrameTimeT = (66.0 / TEST_NOM_BITRATE) + (512.0 / TEST_DAT_BITRATE);
+      return (63.0 / ftFrameTimeT);
+   }
+
+   ftFrameTimeT = (66.0 + 64.0) / TEST_NOM_BITRATE;
+   return (7.0 / ftFrameTimeT);
+}
+
+
+//----------------------------------------------------------------------------//
+// testMessage()                                                              //
+// message with a pattern which detects lost or swapped segments              //
+//----------------------------------------------------------------------------//
+static QByteArray testMessage(int32_t slSizeV, uint8_t ubSeedV = 0)
+{
+   QByteArray  clMessageT(slSizeV, Qt::Uninitialized);
+   int32_t     slPosT;
+
+   for (slPosT = 0; slPosT < slSizeV; slPosT++)
+   {
+      clMessageT[slPosT] = (char) ((slPosT * 7) + (slPosT >> 8) + ubSeedV);
+   }
+
+   return (clMessageT);
+}
+
+
+TestQCanIsoTp::TestQCanIsoTp()
+{
+   pclNetworkP      = Q_NULLPTR;
+   pclTesterSocketP = Q_NULLPTR;
+   pclEcuSocketP    = Q_NULLPTR;
+   pclTesterP       = Q_NULLPTR;
+   pclEcuP          = Q_NULLPTR;
+}
+
+
+TestQCanIsoTp::~TestQCanIsoTp()
+{
+
+}
+
+
+//----------------------------------------------------------------------------//
+// transfer()                                                                 //
+// send message from tester to ECU and wait for reception                     //
+//----------------------------------------------------------------------------//
+bool TestQCanIsoTp::transfer(int32_t slTrmChannelV, int32_t slRcvChannelV, const QByteArray & clMessageR)
+{
+   QSignalSpy     clReceivedT(pclEcuP, SIGNAL(messageReceived(int32_t, const QByteArray &)));
+   QSignalSpy     clSentT(pclTesterP, SIGNAL(messageSent(int32_t)));
+   QElapsedTimer  clTimerT;
+
+   if (pclTesterP->send(slTrmChannelV, clMessageR) == false)
+   {
+      return (false);
+   }
+
+   clTimerT.start();
+   while ((clReceivedT.count() == 0) || (clSentT.count() == 0))
+   {
+      if (clTimerT.elapsed() > 10000)
+      {
+         return (false);
+      }
+      QCoreApplication::processEvents();
+   }
+
+   return ((clReceivedT.count() == 1) &&
+           (clReceivedT.at(0).at(0).toInt() == slRcvChannelV) &&
+           (clReceivedT.at(0).at(1).toByteArray() == clMessageR) &&
+           (clSentT.at(0).at(0).toInt() == slTrmChannelV));
+}
+
+
+//----------------------------------------------------------------------------//
+// initTestCase()                                                             //
+// prepare test cases                                                         //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::initTestCase()
+{
+   QCanIsoTp::Config_s  tsConfigT;
+
+   qRegisterMetaType<QCanIsoTp::Error_e>("QCanIsoTp::Error_e");
+
+   pclNetworkP = new QCanNetwork();
+   pclNetworkP->setNetworkEnabled(true);
+   QVERIFY(pclNetworkP->isNetworkEnabled() == true);
+
+   pclTesterSocketP = new QCanSocket();
+   pclEcuSocketP    = new QCanSocket();
+   QVERIFY(pclTesterSocketP->connectNetwork((CAN_Channel_e) pclNetworkP->id(), 1000) == true);
+   QVERIFY(pclEcuSocketP->connectNetwork((CAN_Channel_e) pclNetworkP->id(), 1000) == true);
+   QTest::qWait(100);
+
+   pclTesterP = new QCanIsoTp(pclTesterSocketP);
+   pclEcuP    = new QCanIsoTp(pclEcuSocketP);
+
+   //----------------------------------------------------------------
+   // channel 0: classic CAN, channel 1: CAN FD with extended frames
+   //
+   QVERIFY(pclTesterP->addChannel(QCanIsoTp::defaultConfig(0x7E0, 0x7E8)) == 0);
+   QVERIFY(pclEcuP->addChannel(QCanIsoTp::defaultConfig(0x7E8, 0x7E0)) == 0);
+
+   tsConfigT = QCanIsoTp::defaultConfig(0x18DA10F1, 0x18DAF110, true);
+   tsConfigT.btExtended = true;
+   QVERIFY(pclTesterP->addChannel(tsConfigT) == 1);
+
+   tsConfigT = QCanIsoTp::defaultConfig(0x18DAF110, 0x18DA10F1, true);
+   tsConfigT.btExtended = true;
+   QVERIFY(pclEcuP->addChannel(tsConfigT) == 1);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkChannel()                                                             //
+// add and remove channels                                                    //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::checkChannel()
+{
+   QCanIsoTp::Config_s  tsConfigT;
+   int32_t              slChannelT;
+
+   QVERIFY(pclTesterP->channelCount() == 2);
+
+   //----------------------------------------------------------------
+   // the receive identifier must be unique
+   //
+   QVERIFY(pclTesterP->addChannel(QCanIsoTp::defaultConfig(0x7DF, 0x7E8)) == -1);
+
+   //----------------------------------------------------------------
+   // invalid identifier and frame size
+   //
+   QVERIFY(pclTesterP->addChannel(QCanIsoTp::defaultConfig(0x800, 0x7E9)) == -1);
+   tsConfigT = QCanIsoTp::defaultConfig(0x7E1, 0x7E9);
+   tsConfigT.ubFrameSize = 12;
+   QVERIFY(pclTesterP->addChannel(tsConfigT) == -1);
+   tsConfigT = QCanIsoTp::defaultConfig(0x7E1, 0x7E9, true);
+   tsConfigT.ubFrameSize = 13;
+   QVERIFY(pclTesterP->addChannel(tsConfigT) == -1);
+
+   //----------------------------------------------------------------
+   // the index of a removed channel is used again
+   //
+   slChannelT = pclTesterP->addChannel(QCanIsoTp::defaultConfig(0x7E1, 0x7E9));
+   QVERIFY(slChannelT == 2);
+   QVERIFY(pclTesterP->channelCount() == 3);
+   QVERIFY(pclTesterP->removeChannel(slChannelT) == true);
+   QVERIFY(pclTesterP->removeChannel(slChannelT) == false);
+   QVERIFY(pclTesterP->send(slChannelT, testMessage(4)) == false);
+   QVERIFY(pclTesterP->addChannel(QCanIsoTp::defaultConfig(0x7E2, 0x7EA)) == slChannelT);
+   QVERIFY(pclTesterP->removeChannel(slChannelT) == true);
+   QVERIFY(pclTesterP->channelCount() == 2);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkSingleFrame()                                                         //
+// transfer messages which fit into a single frame                            //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::checkSingleFrame()
+{
+   QVERIFY(pclTesterP->send(0, QByteArray()) == false);
+
+   QVERIFY(transfer(0, 0, testMessage(1)) == true);
+   QVERIFY(transfer(0, 0, testMessage(7)) == true);
+
+   //----------------------------------------------------------------
+   // CAN FD uses the escape sequence for more than 7 bytes
+   //
+   QVERIFY(transfer(1, 1, testMessage(7)) == true);
+   QVERIFY(transfer(1, 1, testMessage(8)) == true);
+   QVERIFY(transfer(1, 1, testMessage(62)) == true);
+   QVERIFY(pclTesterP->isBusy(1) == false);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkSegmentation()                                                        //
+// transfer messages with first frame and consecutive frames                  //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::checkSegmentation()
+{
+   QVERIFY(transfer(0, 0, testMessage(8)) == true);
+   QVERIFY(transfer(0, 0, testMessage(4095)) == true);
+
+   //----------------------------------------------------------------
+   // a message of more than 4095 bytes uses the escape sequence of
+   // the first frame
+   //
+   QVERIFY(transfer(0, 0, testMessage(5000)) == true);
+   QVERIFY(transfer(1, 1, testMessage(63)) == true);
+   QVERIFY(transfer(1, 1, testMessage(100000)) == true);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkFlowControl()                                                         //
+// block size and separation time requested by the receiver                   //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::checkFlowControl()
+{
+   QCanIsoTp::Config_s  tsConfigT;
+   QElapsedTimer        clTimerT;
+
+   //----------------------------------------------------------------
+   // 300 bytes: first frame with 6 bytes and 42 consecutive frames,
+   // the receiver requests a flow control frame after 4 frames and
+   // a separation time of 1 ms
+   //
+   tsConfigT = QCanIsoTp::defaultConfig(0x7E8, 0x7E0);
+   tsConfigT.ubBlockSize = 4;
+   tsConfigT.ulSepTime   = 1000;
+   QVERIFY(pclEcuP->removeChannel(0) == true);
+   QVERIFY(pclEcuP->addChannel(tsConfigT) == 0);
+
+   clTimerT.start();
+   QVERIFY(transfer(0, 0, testMessage(300)) == true);
+   QVERIFY(clTimerT.elapsed() >= 41);
+
+   //----------------------------------------------------------------
+   // separation time below 1 ms
+   //
+   tsConfigT.ubBlockSize = 0;
+   tsConfigT.ulSepTime   = 200;
+   QVERIFY(pclEcuP->removeChannel(0) == true);
+   QVERIFY(pclEcuP->addChannel(tsConfigT) == 0);
+
+   clTimerT.start();
+   QVERIFY(transfer(0, 0, testMessage(300)) == true);
+   QVERIFY(clTimerT.nsecsElapsed() >= 41 * 200000);
+
+   QVERIFY(pclEcuP->removeChannel(0) == true);
+   QVERIFY(pclEcuP->addChannel(QCanIsoTp::defaultConfig(0x7E8, 0x7E0)) == 0);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkConcurrent()                                                          //
+// transfer messages on several channels in both directions                   //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::checkConcurrent()
+{
+   QSignalSpy  clEcuT(pclEcuP, SIGNAL(messageReceived(int32_t, const QByteArray &)));
+   QSignalSpy  clTesterT(pclTesterP, SIGNAL(messageReceived(int32_t, const QByteArray &)));
+   int32_t     slChannelT;
+   int32_t     slIdxT;
+
+   //----------------------------------------------------------------
+   // channel 2 .. 9 with identifier 0x700 .. 0x70F
+   //
+   for (slChannelT = 2; slChannelT < 10; slChannelT++)
+   {
+      QVERIFY(pclTesterP->addChannel(QCanIsoTp::defaultConfig(0x6FC + (2 * slChannelT),
+                                                             0x6FD + (2 * slChannelT))) == slChannelT);
+      QVERIFY(pclEcuP->addChannel(QCanIsoTp::defaultConfig(0x6FD + (2 * slChannelT),
+                                                          0x6FC + (2 * slChannelT))) == slChannelT);
+   }
+
+   for (slChannelT = 0; slChannelT < 10; slChannelT++)
+   {
+      QVERIFY(pclTesterP->send(slChannelT, testMessage(1000 + slChannelT, slChannelT)) == true);
+      QVERIFY(pclEcuP->send(slChannelT, testMessage(2000 + slChannelT, slChannelT)) == true);
+   }
+   QVERIFY(pclTesterP->isBusy(0) == true);
+   QVERIFY(pclTesterP->send(0, testMessage(10)) == false);
+
+   QTRY_VERIFY((clEcuT.count() == 10) && (clTesterT.count() == 10));
+
+   for (slIdxT = 0; slIdxT < 10; slIdxT++)
+   {
+      slChannelT = clEcuT.at(slIdxT).at(0).toInt();
+      QVERIFY(clEcuT.at(slIdxT).at(1).toByteArray() == testMessage(1000 + slChannelT, slChannelT));
+      slChannelT = clTesterT.at(slIdxT).at(0).toInt();
+      QVERIFY(clTesterT.at(slIdxT).at(1).toByteArray() == testMessage(2000 + slChannelT, slChannelT));
+   }
+
+   for (slChannelT = 2; slChannelT < 10; slChannelT++)
+   {
+      QVERIFY(pclTesterP->removeChannel(slChannelT) == true);
+      QVERIFY(pclEcuP->removeChannel(slChannelT) == true);
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// checkConcurrentPaced()                                                     //
+// a long transfer with a short separation time does not block other channels //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::checkConcurrentPaced()
+{
+   QSignalSpy           clEcuT(pclEcuP, SIGNAL(messageReceived(int32_t, const QByteArray &)));
+   QSignalSpy           clTesterT(pclTesterP, SIGNAL(messageReceived(int32_t, const QByteArray &)));
+   QSignalSpy           clEcuErrorT(pclEcuP, SIGNAL(error(int32_t, QCanIsoTp::Error_e)));
+   QSignalSpy           clTesterErrorT(pclTesterP, SIGNAL(error(int32_t, QCanIsoTp::Error_e)));
+   QCanIsoTp::Config_s  tsConfigT;
+
+   //----------------------------------------------------------------
+   // channel 2: the ECU requests a separation time of 200 us, the
+   // transfer of 4000 bytes takes more than 100 ms
+   //
+   QVERIFY(pclTesterP->addChannel(QCanIsoTp::defaultConfig(0x300, 0x301)) == 2);
+   tsConfigT = QCanIsoTp::defaultConfig(0x301, 0x300);
+   tsConfigT.ulSepTime = 200;
+   QVERIFY(pclEcuP->addChannel(tsConfigT) == 2);
+
+   //----------------------------------------------------------------
+   // channel 3: the tester receives at the same time with a
+   // timeout N_Cr of 20 ms
+   //
+   tsConfigT = QCanIsoTp::defaultConfig(0x302, 0x303);
+   tsConfigT.ulSepTime = 1000;
+   tsConfigT.ulTimeout = 20;
+   QVERIFY(pclTesterP->addChannel(tsConfigT) == 3);
+   QVERIFY(pclEcuP->addChannel(QCanIsoTp::defaultConfig(0x303, 0x302)) == 3);
+
+   QVERIFY(pclEcuP->send(3, testMessage(700, 3)) == true);
+   QVERIFY(pclTesterP->send(2, testMessage(4000, 2)) == true);
+
+   QTRY_VERIFY((clEcuT.count() == 1) && (clTesterT.count() == 1));
+   QCOMPARE(clEcuErrorT.count(), 0);
+   QCOMPARE(clTesterErrorT.count(), 0);
+   QVERIFY(clEcuT.at(0).at(1).toByteArray() == testMessage(4000, 2));
+   QVERIFY(clTesterT.at(0).at(1).toByteArray() == testMessage(700, 3));
+
+   QVERIFY(pclTesterP->removeChannel(2) == true);
+   QVERIFY(pclTesterP->removeChannel(3) == true);
+   QVERIFY(pclEcuP->removeChannel(2) == true);
+   QVERIFY(pclEcuP->removeChannel(3) == true);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkTimeout()                                                             //
+// no flow control frame from the receiver                                    //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::checkTimeout()
+{
+   QSignalSpy           clErrorT(pclTesterP, SIGNAL(error(int32_t, QCanIsoTp::Error_e)));
+   QCanIsoTp::Config_s  tsConfigT;
+   int32_t              slChannelT;
+
+   tsConfigT = QCanIsoTp::defaultConfig(0x100, 0x101);
+   tsConfigT.ulTimeout = 100;
+   slChannelT = pclTesterP->addChannel(tsConfigT);
+   QVERIFY(slChannelT == 2);
+
+   QVERIFY(pclTesterP->send(slChannelT, testMessage(20)) == true);
+   QTRY_VERIFY(clErrorT.count() == 1);
+   QVERIFY(clErrorT.at(0).at(0).toInt() == slChannelT);
+   QVERIFY(clErrorT.at(0).at(1).value<QCanIsoTp::Error_e>() == QCanIsoTp::eERROR_TIMEOUT_BS);
+   QVERIFY(pclTesterP->isBusy(slChannelT) == false);
+
+   QVERIFY(pclTesterP->removeChannel(slChannelT) == true);
+}
+
+
+//----------------------------------------------------------------------------//
+// throughput_data()                                                          //
+// classic CAN and CAN FD                                                     //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::throughput_data()
+{
+   QTest::addColumn<int>("channel");
+
+   QTest::newRow("CAN")    << 0;
+   QTest::newRow("CAN FD") << 1;
+}
+
+
+//----------------------------------------------------------------------------//
+// throughput()                                                               //
+// measure transfer of a large message over the virtual network               //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::throughput()
+{
+   QFETCH(int, channel);
+
+   QByteArray     clMessageT = testMessage(256 * 1024);
+   QElapsedTimer  clTimerT;
+   double         ftRateT;
+   double         ftBusRateT;
+
+   QBENCHMARK
+   {
+      QVERIFY(transfer(channel, channel, clMessageT) == true);
+   }
+
+   //----------------------------------------------------------------
+   // the virtual network does not limit the bit-rate, compare the
+   // achieved rate with the theoretical limit of the CAN bus
+   //
+   clTimerT.start();
+   QVERIFY(transfer(channel, channel, clMessageT) == true);
+   ftRateT    = (clMessageT.size() * 1.0E9) / qMax(clTimerT.nsecsElapsed(), (qint64) 1);
+   ftBusRateT = busRate(channel == 1);
+
+   qDebug() << "Bytes per second:" << (qint64) ftRateT
+            << "- bus limit:" << (qint64) ftBusRateT
+            << "- ratio:" << (ftRateT / ftBusRateT);
+}
+
+
+//----------------------------------------------------------------------------//
+// cleanupTestCase()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void TestQCanIsoTp::cleanupTestCase()
+{
+   delete (pclTesterP);
+   delete (pclEcuP);
+
+   pclTesterSocketP->disconnectNetwork();
+   pclEcuSocketP->disconnectNetwork();
+   delete (pclTesterSocketP);
+   delete (pclEcuSocketP);
+
+   pclNetworkP->setNetworkEnabled(false);
+   delete (pclNetworkP);
+}
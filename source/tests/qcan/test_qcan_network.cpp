@@ -0,0 +1,829 @@
+//============================================================================//
+// File:          test_qcan_network.cpp                                       //
+// Description:   QCAN classes - Test QCan network                            //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+#include "test_qcan_network.hpp"
+
+
+TestQCanNetwork::TestQCanNetwork()
+{
+   pclNetworkP = Q_NULLPTR;
+}
+
+
+TestQCanNetwork::~TestQCanNetwork()
+{
+
+}
+
+
+//----------------------------------------------------------------------------//
+// connectSockets()                                                           //
+// connect local sockets to the network                                       //
+//----------------------------------------------------------------------------//
+bool TestQCanNetwork::connectSockets(int32_t slCountV)
+{
+   QLocalSocket * pclSocketT;
+   int32_t        slSockIdxT;
+
+   for (slSockIdxT = 0; slSockIdxT < slCountV; slSockIdxT++)
+   {
+      pclSocketT = new QLocalSocket();
+      clSocketListP.append(pclSocketT);
+      pclSocketT->connectToServer(QString("CANpieServerChannel%1").
+                                  arg(pclNetworkP->id()));
+      if (pclSocketT->waitForConnected(1000) == false)
+      {
+         return (false);
+      }
+   }
+
+   //----------------------------------------------------------------
+   // the network accepts the connections inside the event loop
+   //
+   QTest::qWait(100);
+
+   return (true);
+}
+
+
+//----------------------------------------------------------------------------//
+// disconnectSockets()                                                        //
+// disconnect and delete all local sockets                                    //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::disconnectSockets(void)
+{
+   QLocalSocket * pclSocketT;
+
+   foreach (pclSocketT, clSocketListP)
+   {
+      pclSocketT->abort();
+      delete (pclSocketT);
+   }
+   clSocketListP.clear();
+   QTest::qWait(100);
+}
+
+
+//----------------------------------------------------------------------------//
+// initTestCase()                                                             //
+// prepare test cases                                                         //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::initTestCase()
+{
+   pclNetworkP = new QCanNetwork();
+   pclNetworkP->setNetworkEnabled(true);
+   QVERIFY(pclNetworkP->isNetworkEnabled() == true);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkSocketMax()                                                           //
+// check limit of local sockets                                               //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::checkSocketMax()
+{
+   QByteArray     clFrameT;
+   int32_t        slSockIdxT;
+
+   //----------------------------------------------------------------
+   // default values
+   //
+   QVERIFY(pclNetworkP->localSocketMax() == QCAN_LOCAL_SOCKET_MAX);
+   QVERIFY(pclNetworkP->tcpSocketMax()   == QCAN_TCP_SOCKET_MAX);
+
+   //----------------------------------------------------------------
+   // a value of 0 is not accepted
+   //
+   QVERIFY(pclNetworkP->setSocketMax(0, 1) == false);
+   QVERIFY(pclNetworkP->setSocketMax(1, 0) == false);
+   QVERIFY(pclNetworkP->localSocketMax() == QCAN_LOCAL_SOCKET_MAX);
+
+   //----------------------------------------------------------------
+   // connect 4 local sockets with a limit of 3: the last socket
+   // is closed by the network
+   //
+   QVERIFY(pclNetworkP->setSocketMax(3, 3) == true);
+   QVERIFY(connectSockets(4) == true);
+   QTRY_VERIFY(clSocketListP.at(3)->state() ==
+               QLocalSocket::UnconnectedState);
+
+   //----------------------------------------------------------------
+   // a frame written by socket 0 is received by socket 1 and 2
+   //
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x123, 2).toByteArray();
+   clSocketListP.at(0)->write(clFrameT);
+   clSocketListP.at(0)->flush();
+   for (slSockIdxT = 1; slSockIdxT < 3; slSockIdxT++)
+   {
+      QTRY_VERIFY(clSocketListP.at(slSockIdxT)->bytesAvailable() >=
+                  QCAN_FRAME_ARRAY_SIZE);
+      QVERIFY(clSocketListP.at(slSockIdxT)->read(QCAN_FRAME_ARRAY_SIZE) ==
+              clFrameT);
+   }
+   QVERIFY(clSocketListP.at(0)->bytesAvailable() == 0);
+
+   //----------------------------------------------------------------
+   // remove socket 0, socket 2 is moved to its position and must
+   // still receive frames from socket 1
+   //
+   clSocketListP.at(0)->disconnectFromServer();
+   QTest::qWait(100);
+   clSocketListP.at(1)->write(clFrameT);
+   clSocketListP.at(1)->flush();
+   QTRY_VERIFY(clSocketListP.at(2)->bytesAvailable() >=
+               QCAN_FRAME_ARRAY_SIZE);
+   QVERIFY(clSocketListP.at(2)->read(QCAN_FRAME_ARRAY_SIZE) == clFrameT);
+   QTest::qWait(50);
+   QVERIFY(clSocketListP.at(1)->bytesAvailable() == 0);
+
+   disconnectSockets();
+}
+
+
+//----------------------------------------------------------------------------//
+// checkMultiplexer()                                                         //
+// exchange frames via a multiplexed connection                               //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::checkMultiplexer()
+{
+   QCanMultiplexer      clMuxT;
+   QCanSocket           clMuxSocketT;
+   QCanFrame            clFrameT;
+   QByteArray           clDataT;
+   CAN_Channel_e        teChannelT;
+   QList<CAN_Channel_e> clChannelListT;
+
+   clMuxT.addNetwork(pclNetworkP);
+   clMuxT.setEnabled(true);
+
+   //----------------------------------------------------------------
+   // no valid CAN channel
+   //
+   clChannelListT << eCAN_CHANNEL_NONE;
+   QVERIFY(clMuxSocketT.connectNetworks(clChannelListT) == false);
+
+   clChannelListT << (CAN_Channel_e) pclNetworkP->id();
+   QVERIFY(clMuxSocketT.connectNetworks(clChannelListT, 1000) == true);
+   QVERIFY(connectSockets(1) == true);
+
+   //----------------------------------------------------------------
+   // frame of the network is received with its CAN channel
+   //
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_EXT, 0x1234567, 4);
+   clSocketListP.at(0)->write(clFrameT.toByteArray());
+   clSocketListP.at(0)->flush();
+   QTRY_VERIFY(clMuxSocketT.framesAvailable() > 0);
+   QVERIFY(clMuxSocketT.read(clFrameT, teChannelT) == true);
+   QVERIFY(teChannelT == (CAN_Channel_e) pclNetworkP->id());
+   QVERIFY(clFrameT.identifier() == 0x1234567);
+
+   //----------------------------------------------------------------
+   // the CAN channel is required for writing
+   //
+   QVERIFY(clMuxSocketT.write(clFrameT) == false);
+   QVERIFY(clMuxSocketT.write(clFrameT, eCAN_CHANNEL_NONE) == false);
+   QVERIFY(clMuxSocketT.write(clFrameT, teChannelT) == true);
+   QTRY_VERIFY(clSocketListP.at(0)->bytesAvailable() >= QCAN_FRAME_ARRAY_SIZE);
+   clDataT = clSocketListP.at(0)->read(QCAN_FRAME_ARRAY_SIZE);
+   QVERIFY(clFrameT.fromByteArray(clDataT) == true);
+   QVERIFY(clFrameT.identifier() == 0x1234567);
+
+   clMuxSocketT.disconnectNetwork();
+   disconnectSockets();
+}
+
+
+//----------------------------------------------------------------------------//
+// checkGateway()                                                             //
+// forward frames to a second network                                         //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::checkGateway()
+{
+   QCanNetwork          clNetworkT(Q_NULLPTR, QCAN_TCP_DEFAULT_PORT + 1);
+   QCanGateway          clGatewayT;
+   QLocalSocket         clSocketT;
+   QCanFrame            clFrameT;
+   GatewayRule_ts       tsRuleT;
+   GatewayStatistic_ts  tsStatisticT;
+
+   clNetworkT.setNetworkEnabled(true);
+   QVERIFY(clNetworkT.isNetworkEnabled() == true);
+
+   clGatewayT.addNetwork(pclNetworkP);
+   clGatewayT.addNetwork(&clNetworkT);
+
+   //----------------------------------------------------------------
+   // identifier 1xxh is forwarded as CAN FD frame with identifier
+   // 2xxh, not more than 1 frame per second
+   //
+   tsRuleT.teSrcChannel   = (CAN_Channel_e) pclNetworkP->id();
+   tsRuleT.teDstChannel   = (CAN_Channel_e) clNetworkT.id();
+   tsRuleT.ulIdMatch      = 0x100;
+   tsRuleT.ulIdMask       = 0x700;
+   tsRuleT.btExtended     = false;
+   tsRuleT.ulIdRemapValue = 0x200;
+   tsRuleT.ulIdRemapMask  = 0x700;
+   tsRuleT.teConvert      = eGATEWAY_CONVERT_FD;
+   tsRuleT.ulRateLimit    = 1;
+   QVERIFY(clGatewayT.addRule(tsRuleT) == 0);
+
+   tsRuleT.teDstChannel   = tsRuleT.teSrcChannel;
+   QVERIFY(clGatewayT.addRule(tsRuleT) == -1);
+   QVERIFY(clGatewayT.ruleCount() == 1);
+
+   QVERIFY(connectSockets(1) == true);
+   clSocketT.connectToServer(QString("CANpieServerChannel%1").arg(clNetworkT.id()));
+   QVERIFY(clSocketT.waitForConnected(1000) == true);
+   QTest::qWait(100);
+
+   //----------------------------------------------------------------
+   // 323h does not match, 123h is forwarded, 124h exceeds the rate
+   //
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x323, 2);
+   clSocketListP.at(0)->write(clFrameT.toByteArray());
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x123, 2);
+   clSocketListP.at(0)->write(clFrameT.toByteArray());
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x124, 2);
+   clSocketListP.at(0)->write(clFrameT.toByteArray());
+   clSocketListP.at(0)->flush();
+
+   QTRY_VERIFY(clGatewayT.statistic(0).ulMatchCount == 2);
+   QTRY_VERIFY(clSocketT.bytesAvailable() >= QCAN_FRAME_ARRAY_SIZE);
+   QVERIFY(clFrameT.fromByteArray(clSocketT.read(QCAN_FRAME_ARRAY_SIZE)) == true);
+   QVERIFY(clFrameT.identifier()  == 0x223);
+   QVERIFY(clFrameT.frameFormat() == QCanFrame::eFORMAT_FD_STD);
+   QTest::qWait(50);
+   QVERIFY(clSocketT.bytesAvailable() == 0);
+
+   tsStatisticT = clGatewayT.statistic(0);
+   QVERIFY(tsStatisticT.ulForwardCount == 1);
+   QVERIFY(tsStatisticT.ulDropCount    == 1);
+   QVERIFY(tsStatisticT.ulLatencyMin   <= tsStatisticT.ulLatencyMax);
+
+   clSocketT.abort();
+   disconnectSockets();
+   clNetworkT.setNetworkEnabled(false);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkMulticast()                                                           //
+// receive frames by UDP multicast on the loopback interface                  //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::checkMulticast()
+{
+   QCanSocket     clListenerT;
+   QCanFrame      clFrameT;
+   int32_t        slFrameIdxT;
+
+   QVERIFY(pclNetworkP->setMulticastEnabled(true, QHostAddress("10.0.0.1")) == false);
+   QVERIFY(pclNetworkP->setMulticastEnabled(true) == true);
+   QVERIFY(pclNetworkP->isMulticastEnabled() == true);
+
+   //----------------------------------------------------------------
+   // the system might not provide a multicast route
+   //
+   if (clListenerT.connectMulticast((CAN_Channel_e) pclNetworkP->id()) == false)
+   {
+      pclNetworkP->setMulticastEnabled(false);
+      QSKIP("UDP multicast is not available");
+   }
+
+   //----------------------------------------------------------------
+   // 20 frames need at least 2 datagrams
+   //
+   QVERIFY(connectSockets(1) == true);
+   for (slFrameIdxT = 0; slFrameIdxT < 20; slFrameIdxT++)
+   {
+      clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x100 + slFrameIdxT, 1);
+      clSocketListP.at(0)->write(clFrameT.toByteArray());
+   }
+   clSocketListP.at(0)->flush();
+
+   QTRY_VERIFY(clListenerT.framesAvailable() == 20);
+   for (slFrameIdxT = 0; slFrameIdxT < 20; slFrameIdxT++)
+   {
+      QVERIFY(clListenerT.read(clFrameT) == true);
+      QVERIFY(clFrameT.identifier() == (uint32_t) (0x100 + slFrameIdxT));
+   }
+   QVERIFY(clListenerT.datagramsLost() == 0);
+
+   //----------------------------------------------------------------
+   // a listener can not write
+   //
+   QVERIFY(clListenerT.write(clFrameT) == false);
+
+   clListenerT.disconnectNetwork();
+   disconnectSockets();
+   QVERIFY(pclNetworkP->setMulticastEnabled(false) == true);
+   QVERIFY(pclNetworkP->isMulticastEnabled() == false);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkSubscription()                                                        //
+// receive changed frames only and limit the rate per identifier              //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::checkSubscription()
+{
+   QCanSocket     clSubscriberT;
+   QCanFrame      clFrameT;
+   uint8_t        ubValueT;
+   const uint8_t  aubValueT[] = { 1, 1, 1, 2, 2 };
+
+   QVERIFY(clSubscriberT.setSubscription(true) == true);
+   QVERIFY(clSubscriberT.connectNetwork((CAN_Channel_e) pclNetworkP->id(), 1000) == true);
+   QVERIFY(connectSockets(1) == true);
+   QTRY_VERIFY(pclNetworkP->subscriptionCount() == 1);
+
+   //----------------------------------------------------------------
+   // payload sequence 1, 1, 1, 2, 2: only the first frame and the
+   // change are received, a frame of another identifier is received
+   // as well
+   //
+   for (ubValueT = 0; ubValueT < 5; ubValueT++)
+   {
+      clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x123, 1);
+      clFrameT.setData(0, aubValueT[ubValueT]);
+      clSocketListP.at(0)->write(clFrameT.toByteArray());
+   }
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x124, 1);
+   clSocketListP.at(0)->write(clFrameT.toByteArray());
+   clSocketListP.at(0)->flush();
+
+   QTRY_VERIFY(clSubscriberT.framesAvailable() == 3);
+   QTest::qWait(50);
+   QVERIFY(clSubscriberT.framesAvailable() == 3);
+   QVERIFY(clSubscriberT.read(clFrameT) == true);
+   QVERIFY(clFrameT.data(0) == 1);
+   QVERIFY(clSubscriberT.read(clFrameT) == true);
+   QVERIFY(clFrameT.data(0) == 2);
+   QVERIFY(clSubscriberT.read(clFrameT) == true);
+   QVERIFY(clFrameT.identifier() == 0x124);
+
+   //----------------------------------------------------------------
+   // 1 frame per second: of 5 frames sent at once only the first is
+   // received
+   //
+   QVERIFY(clSubscriberT.setSubscription(false, 1) == true);
+   QTest::qWait(50);
+   for (ubValueT = 0; ubValueT < 5; ubValueT++)
+   {
+      clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x200, 1);
+      clFrameT.setData(0, ubValueT);
+      clSocketListP.at(0)->write(clFrameT.toByteArray());
+   }
+   clSocketListP.at(0)->flush();
+
+   QTRY_VERIFY(clSubscriberT.framesAvailable() == 1);
+   QTest::qWait(50);
+   QVERIFY(clSubscriberT.framesAvailable() == 1);
+   QVERIFY(clSubscriberT.read(clFrameT) == true);
+   QVERIFY(clFrameT.data(0) == 0);
+
+   //----------------------------------------------------------------
+   // the subscription is removed on disconnection
+   //
+   QVERIFY(clSubscriberT.setSubscription(false) == true);
+   QTRY_VERIFY(pclNetworkP->subscriptionCount() == 0);
+   QVERIFY(clSubscriberT.setSubscription(true, 10, 1000) == true);
+   QTRY_VERIFY(pclNetworkP->subscriptionCount() == 1);
+   clSubscriberT.disconnectNetwork();
+   QTRY_VERIFY(pclNetworkP->subscriptionCount() == 0);
+
+   disconnectSockets();
+}
+
+
+//----------------------------------------------------------------------------//
+// checkValueCache()                                                          //
+// receive last frame of each identifier on connection                        //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::checkValueCache()
+{
+   QCanSocket     clLateSocketT;
+   QCanFrame      clFrameT;
+
+   //----------------------------------------------------------------
+   // remove frames of previous tests from the cache
+   //
+   QVERIFY(pclNetworkP->isValueCacheEnabled() == true);
+   pclNetworkP->setValueCacheEnabled(false);
+   QVERIFY(pclNetworkP->valueCacheCount() == 0);
+   pclNetworkP->setValueCacheEnabled(true);
+
+   //----------------------------------------------------------------
+   // 3 frames of 2 identifiers
+   //
+   QVERIFY(connectSockets(1) == true);
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x100, 1);
+   clFrameT.setData(0, 1);
+   clSocketListP.at(0)->write(clFrameT.toByteArray());
+   clFrameT.setData(0, 2);
+   clSocketListP.at(0)->write(clFrameT.toByteArray());
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_EXT, 0x12345678, 0);
+   clSocketListP.at(0)->write(clFrameT.toByteArray());
+   clSocketListP.at(0)->flush();
+   QTRY_VERIFY(pclNetworkP->valueCacheCount() == 2);
+   QVERIFY(pclNetworkP->valueCacheSize() > 2 * QCAN_FRAME_ARRAY_SIZE);
+
+   //----------------------------------------------------------------
+   // a socket which connects later receives the last frame of each
+   // identifier
+   //
+   QVERIFY(clLateSocketT.requestSnapshot() == true);
+   QVERIFY(clLateSocketT.connectNetwork((CAN_Channel_e) pclNetworkP->id(), 1000) == true);
+   QTRY_VERIFY(clLateSocketT.framesAvailable() == 2);
+   QVERIFY(clLateSocketT.read(clFrameT) == true);
+   QVERIFY(clFrameT.identifier() == 0x100);
+   QVERIFY(clFrameT.data(0) == 2);
+   QVERIFY(clLateSocketT.read(clFrameT) == true);
+   QVERIFY(clFrameT.identifier() == 0x12345678);
+   QVERIFY(clFrameT.isExtended() == true);
+
+   //----------------------------------------------------------------
+   // a lower limit clears the cache, further identifiers are not
+   // stored
+   //
+   pclNetworkP->setValueCacheMax(1);
+   QVERIFY(pclNetworkP->valueCacheCount() == 0);
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x101, 0);
+   clSocketListP.at(0)->write(clFrameT.toByteArray());
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x102, 0);
+   clSocketListP.at(0)->write(clFrameT.toByteArray());
+   clSocketListP.at(0)->flush();
+   QTRY_VERIFY(clLateSocketT.framesAvailable() == 2);
+   QVERIFY(pclNetworkP->valueCacheCount() == 1);
+   pclNetworkP->setValueCacheMax(QCAN_VALUE_ENTRY_MAX);
+
+   clLateSocketT.disconnectNetwork();
+   disconnectSockets();
+}
+
+
+//----------------------------------------------------------------------------//
+// checkScheduler()                                                           //
+// check cyclic frames of a socket                                            //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::checkScheduler()
+{
+   QCanSocket        clSocketT;
+   QCanFrame         clFrameT;
+   CyclicStatus_ts   tsStatusT;
+   uint8_t           ubCounterT;
+
+   QVERIFY(clSocketT.setCyclicFrame(1, clFrameT, 10000) == false);
+   QVERIFY(clSocketT.connectNetwork((CAN_Channel_e) pclNetworkP->id(), 1000) == true);
+
+   //----------------------------------------------------------------
+   // cyclic frame with a period of 10 ms, a counter in byte 0 and a
+   // pattern for byte 1
+   //
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x321, 2);
+   QVERIFY(clSocketT.setCyclicFrame(1, clFrameT, 10000, 0, 1) == true);
+   clFrameT.setData(1, 0x55);
+   QVERIFY(clSocketT.appendCyclicPattern(1, clFrameT) == true);
+   QTRY_VERIFY(pclNetworkP->scheduler()->messageCount() == 1);
+
+   QTRY_VERIFY(clSocketT.framesAvailable() >= 10);
+   QVERIFY(clSocketT.read(clFrameT) == true);
+   QVERIFY(clFrameT.identifier() == 0x321);
+   ubCounterT = clFrameT.data(0);
+   for (int32_t slFrameT = 1; slFrameT < 10; slFrameT++)
+   {
+      QVERIFY(clSocketT.read(clFrameT) == true);
+      QVERIFY(clFrameT.data(0) == (uint8_t) (ubCounterT + slFrameT));
+      QVERIFY(clFrameT.data(1) == (((ubCounterT + slFrameT) & 1) ? 0x55 : 0x00));
+   }
+
+   //----------------------------------------------------------------
+   // the status is evaluated by read()
+   //
+   QVERIFY(clSocketT.requestCyclicStatus() == true);
+   for (int32_t slWaitT = 0; slWaitT < 100; slWaitT++)
+   {
+      QTest::qWait(10);
+      while (clSocketT.read(clFrameT) == true)
+      {
+      }
+
+      if (clSocketT.cyclicStatus(1, tsStatusT) == true)
+      {
+         break;
+      }
+   }
+   QVERIFY(clSocketT.cyclicStatus(1, tsStatusT) == true);
+   QVERIFY(tsStatusT.ulCount >= 10);
+   QVERIFY(tsStatusT.ulJitterMax >= tsStatusT.ulJitterMean);
+
+   //----------------------------------------------------------------
+   // a frame is removed by cancel and by disconnection
+   //
+   QVERIFY(clSocketT.cancelCyclicFrame(1) == true);
+   QTRY_VERIFY(pclNetworkP->scheduler()->messageCount() == 0);
+   QVERIFY(clSocketT.setCyclicFrame(2, clFrameT, 20000) == true);
+   QTRY_VERIFY(pclNetworkP->scheduler()->messageCount() == 1);
+   clSocketT.disconnectNetwork();
+   QTRY_VERIFY(pclNetworkP->scheduler()->messageCount() == 0);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkFrameBlock()                                                          //
+// exchange a block of frames with a single call                              //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::checkFrameBlock()
+{
+   QCanSocket           clWriterT;
+   QCanSocket           clReaderT;
+   QVector<QCanFrame>   clFrameListT;
+   QCanFrame            clFrameT(QCanFrame::eFORMAT_CAN_STD, 0, 4);
+   int32_t              slFrameIdxT;
+
+   QVERIFY(clWriterT.writeFrames(clFrameListT) == 0);
+   QVERIFY(clWriterT.connectNetwork((CAN_Channel_e) pclNetworkP->id(), 1000) == true);
+   QVERIFY(clReaderT.connectNetwork((CAN_Channel_e) pclNetworkP->id(), 1000) == true);
+
+   for (slFrameIdxT = 0; slFrameIdxT < 500; slFrameIdxT++)
+   {
+      clFrameT.setIdentifier(slFrameIdxT);
+      clFrameT.setDataUInt32(0, slFrameIdxT);
+      clFrameListT.append(clFrameT);
+   }
+   QVERIFY(clWriterT.writeFrames(clFrameListT) == 500);
+   QTRY_VERIFY(clReaderT.framesAvailable() == 500);
+
+   //----------------------------------------------------------------
+   // read a limited number of frames first, the frames are appended
+   //
+   clFrameListT.clear();
+   QVERIFY(clReaderT.readFrames(clFrameListT, 100) == 100);
+   QVERIFY(clReaderT.framesAvailable() == 400);
+   QVERIFY(clReaderT.readFrames(clFrameListT) == 400);
+   QVERIFY(clReaderT.readFrames(clFrameListT) == 0);
+   QVERIFY(clFrameListT.size() == 500);
+
+   for (slFrameIdxT = 0; slFrameIdxT < 500; slFrameIdxT++)
+   {
+      QVERIFY(clFrameListT.at(slFrameIdxT).identifier() == (uint32_t) slFrameIdxT);
+      QVERIFY(clFrameListT.at(slFrameIdxT).dataUInt32(0) == (uint32_t) slFrameIdxT);
+   }
+
+   clWriterT.disconnectNetwork();
+   clReaderT.disconnectNetwork();
+}
+
+
+//----------------------------------------------------------------------------//
+// checkErrorCoalescing()                                                     //
+// coalesce repetitions of an error frame                                     //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::checkErrorCoalescing()
+{
+   QCanSocket     clSocketT;
+   QCanFrame      clFrameT;
+   QCanFrame      clErrorFrameT(QCanFrame::eFRAME_TYPE_ERROR);
+   uint32_t       ulErrorCntT;
+   uint8_t        ubCntT;
+
+   QVERIFY(pclNetworkP->errorCoalescingTime() == 0);
+   pclNetworkP->setErrorCoalescingTime(200);
+   QVERIFY(pclNetworkP->errorCoalescingTime() == 200);
+   ulErrorCntT = pclNetworkP->frameCountError();
+
+   QVERIFY(connectSockets(1) == true);
+   QVERIFY(clSocketT.connectNetwork((CAN_Channel_e) pclNetworkP->id(), 1000) == true);
+
+   //----------------------------------------------------------------
+   // 5 identical error frames followed by a different one: the first
+   // frame, the number of repetitions and the different frame are
+   // received
+   //
+   clErrorFrameT.setErrorState(eCAN_STATE_BUS_PASSIVE);
+   clErrorFrameT.setErrorCounterReceive(128);
+   for (ubCntT = 0; ubCntT < 5; ubCntT++)
+   {
+      clSocketListP.at(0)->write(clErrorFrameT.toByteArray());
+   }
+   clErrorFrameT.setErrorCounterReceive(136);
+   clSocketListP.at(0)->write(clErrorFrameT.toByteArray());
+   clSocketListP.at(0)->flush();
+
+   QTRY_VERIFY(clSocketT.framesAvailable() == 3);
+   QVERIFY(clSocketT.read(clFrameT) == true);
+   QVERIFY(clFrameT.errorCounterReceive() == 128);
+   QVERIFY(clFrameT.user() == 0);
+   QVERIFY(clSocketT.read(clFrameT) == true);
+   QVERIFY(clFrameT.errorCounterReceive() == 128);
+   QVERIFY(clFrameT.user() == 4);
+   QVERIFY(clSocketT.read(clFrameT) == true);
+   QVERIFY(clFrameT.errorCounterReceive() == 136);
+   QVERIFY(clFrameT.user() == 0);
+
+   //----------------------------------------------------------------
+   // all error frames are counted
+   //
+   QVERIFY(pclNetworkP->frameCountError() == ulErrorCntT + 6);
+   QVERIFY(pclNetworkP->frameCountErrorCoalesced() == 4);
+
+   //----------------------------------------------------------------
+   // pending repetitions are reported when the time window expires
+   //
+   QTest::qWait(300);
+   clErrorFrameT.setErrorCounterReceive(200);
+   for (ubCntT = 0; ubCntT < 3; ubCntT++)
+   {
+      clSocketListP.at(0)->write(clErrorFrameT.toByteArray());
+   }
+   clSocketListP.at(0)->flush();
+   QTRY_VERIFY(clSocketT.framesAvailable() == 1);
+   QTRY_VERIFY(clSocketT.framesAvailable() == 2);
+   QVERIFY(clSocketT.read(clFrameT) == true);
+   QVERIFY(clFrameT.user() == 0);
+   QVERIFY(clSocketT.read(clFrameT) == true);
+   QVERIFY(clFrameT.errorCounterReceive() == 200);
+   QVERIFY(clFrameT.user() == 2);
+   QVERIFY(pclNetworkP->frameCountError() == ulErrorCntT + 9);
+
+   pclNetworkP->setErrorCoalescingTime(0);
+   clSocketT.disconnectNetwork();
+   disconnectSockets();
+}
+
+
+//----------------------------------------------------------------------------//
+// checkSocketThread()                                                        //
+// receive frames by queues of a socket thread                                //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::checkSocketThread()
+{
+   QCanSocketThread  clThreadT;
+   QCanSocket        clSocketT;
+   QCanFrameQueue *  pclQueueT;
+   QCanFrameQueue *  pclSmallQueueT;
+   QCanFrame         clFrameT(QCanFrame::eFORMAT_CAN_STD, 0x123, 1);
+   uint8_t           ubCntT;
+
+   pclQueueT      = clThreadT.createQueue();
+   pclSmallQueueT = clThreadT.createQueue(10);
+   QVERIFY(pclSmallQueueT->size() == 16);
+   QVERIFY(clThreadT.write(clFrameT) == false);
+   QVERIFY(pclQueueT->readBlocking(clFrameT, 10) == false);
+
+   //----------------------------------------------------------------
+   // the network accepts the connection inside the event loop
+   //
+   QVERIFY(clThreadT.connectNetwork((CAN_Channel_e) pclNetworkP->id(), 1000) == true);
+   QVERIFY(clSocketT.connectNetwork((CAN_Channel_e) pclNetworkP->id(), 1000) == true);
+   QTest::qWait(100);
+
+   //----------------------------------------------------------------
+   // each queue receives all frames, a full queue drops frames
+   //
+   for (ubCntT = 0; ubCntT < 20; ubCntT++)
+   {
+      clFrameT.setData(0, ubCntT);
+      QVERIFY(clSocketT.write(clFrameT) == true);
+   }
+   QTRY_VERIFY(pclQueueT->framesAvailable() == 20);
+   QVERIFY(pclSmallQueueT->framesAvailable() == 16);
+   QVERIFY(pclSmallQueueT->framesLost() == 4);
+
+   for (ubCntT = 0; ubCntT < 20; ubCntT++)
+   {
+      QVERIFY(pclQueueT->readBlocking(clFrameT, 0) == true);
+      QVERIFY(clFrameT.data(0) == ubCntT);
+   }
+   QVERIFY(pclQueueT->readBlocking(clFrameT, 10) == false);
+   clThreadT.removeQueue(pclSmallQueueT);
+
+   //----------------------------------------------------------------
+   // frames are written by the socket thread
+   //
+   clFrameT.setIdentifier(0x124);
+   QVERIFY(clThreadT.write(clFrameT) == true);
+   QTRY_VERIFY(clSocketT.framesAvailable() == 1);
+   QVERIFY(clSocketT.read(clFrameT) == true);
+   QVERIFY(clFrameT.identifier() == 0x124);
+
+   clThreadT.disconnectNetwork();
+   QVERIFY(clThreadT.isConnected() == false);
+   clSocketT.disconnectNetwork();
+   QTest::qWait(100);
+}
+
+
+//----------------------------------------------------------------------------//
+// fanOut_data()                                                              //
+// number of receiving sockets                                                //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::fanOut_data()
+{
+   QTest::addColumn<int>("subscribers");
+
+   QTest::newRow("1")    << 1;
+   QTest::newRow("10")   << 10;
+   QTest::newRow("100")  << 100;
+   QTest::newRow("1000") << 1000;
+}
+
+
+//----------------------------------------------------------------------------//
+// fanOut()                                                                   //
+// measure distribution of one CAN frame to all receiving sockets             //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::fanOut()
+{
+   QFETCH(int, subscribers);
+
+   QByteArray     clFrameT;
+   QLocalSocket * pclSenderT;
+   int32_t        slSockIdxT;
+   int32_t        slRcvCntT;
+
+   QVERIFY(pclNetworkP->setSocketMax(subscribers + 1, 1) == true);
+
+   //----------------------------------------------------------------
+   // the number of file descriptors might be limited
+   //
+   if (connectSockets(subscribers + 1) == false)
+   {
+      disconnectSockets();
+      QSKIP("Number of local sockets is limited by the system");
+   }
+
+   pclSenderT = clSocketListP.at(0);
+   clFrameT   = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x123, 8).toByteArray();
+
+   QBENCHMARK
+   {
+      pclSenderT->write(clFrameT);
+      pclSenderT->flush();
+
+      slRcvCntT = 0;
+      while (slRcvCntT < subscribers)
+      {
+         QCoreApplication::processEvents();
+         slRcvCntT = 0;
+         for (slSockIdxT = 1; slSockIdxT <= subscribers; slSockIdxT++)
+         {
+            if (clSocketListP.at(slSockIdxT)->bytesAvailable() >=
+                QCAN_FRAME_ARRAY_SIZE)
+            {
+               slRcvCntT++;
+            }
+         }
+      }
+
+      for (slSockIdxT = 1; slSockIdxT <= subscribers; slSockIdxT++)
+      {
+         clSocketListP.at(slSockIdxT)->read(QCAN_FRAME_ARRAY_SIZE);
+      }
+   }
+
+   disconnectSockets();
+}
+
+
+//----------------------------------------------------------------------------//
+// cleanupTestCase()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void TestQCanNetwork::cleanupTestCase()
+{
+   pclNetworkP->setNetworkEnabled(false);
+   delete (pclNetworkP);
+}
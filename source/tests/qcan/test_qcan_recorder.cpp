@@ -0,0 +1,285 @@
+//============================================================================//
+// File:          test_qcan_recorder.cpp                                      //
+// Description:   QCAN classes - Test recorder                                //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+
+#include <QtTest/QSignalSpy>
+
+#include <QCanTraceReader>
+
+#include "test_qcan_recorder.hpp"
+
+
+TestQCanRecorder::TestQCanRecorder()
+{
+
+}
+
+
+TestQCanRecorder::~TestQCanRecorder()
+{
+
+}
+
+
+//----------------------------------------------------------------------------//
+// defaultTrigger()                                                           //
+// trigger which matches every standard frame                                 //
+//----------------------------------------------------------------------------//
+RecorderTrigger_ts TestQCanRecorder::defaultTrigger(RecorderTrigger_e teTypeV)
+{
+   RecorderTrigger_ts   tsTriggerT;
+
+   memset(&tsTriggerT, 0, sizeof(tsTriggerT));
+   tsTriggerT.teType      = teTypeV;
+   tsTriggerT.teErrorType = QCanFrame::eERROR_TYPE_NONE;
+
+   return (tsTriggerT);
+}
+
+
+//----------------------------------------------------------------------------//
+// initTestCase()                                                             //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void TestQCanRecorder::initTestCase()
+{
+   QVERIFY(clTempDirP.isValid());
+}
+
+
+//----------------------------------------------------------------------------//
+// checkMemorySize()                                                          //
+// the ring holds a fixed number of frames                                    //
+//----------------------------------------------------------------------------//
+void TestQCanRecorder::checkMemorySize()
+{
+   QCanRecorder   clRecorderT;
+   QCanFrame      clFrameT(QCanFrame::eFORMAT_CAN_STD, 0x100, 8);
+
+   clRecorderT.appendFrame(clFrameT.toByteArray());
+   QCOMPARE(clRecorderT.frameCount(), (uint32_t) 0);
+
+   clRecorderT.setMemorySize(10 * QCAN_FRAME_ARRAY_SIZE);
+   clRecorderT.setEnabled();
+   QVERIFY(clRecorderT.isEnabled() == true);
+
+   for (int32_t slFrameT = 0; slFrameT < 25; slFrameT++)
+   {
+      clRecorderT.appendFrame(clFrameT.toByteArray());
+   }
+   QCOMPARE(clRecorderT.frameCount(), (uint32_t) 10);
+
+   clRecorderT.setEnabled(false);
+   QCOMPARE(clRecorderT.frameCount(), (uint32_t) 0);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkIdentifier()                                                          //
+// trigger on identifier and mask                                             //
+//----------------------------------------------------------------------------//
+void TestQCanRecorder::checkIdentifier()
+{
+   QCanRecorder         clRecorderT;
+   QSignalSpy           clSpyT(&clRecorderT, SIGNAL(triggered(int32_t)));
+   RecorderTrigger_ts   tsTriggerT = defaultTrigger(eRECORDER_TRIGGER_IDENTIFIER);
+
+   tsTriggerT.ulIdMatch = 0x555;
+   tsTriggerT.ulIdMask  = 0x7F0;
+   QCOMPARE(clRecorderT.addTrigger(tsTriggerT), 0);
+   clRecorderT.setEnabled();
+
+   clRecorderT.appendFrame(QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x545, 8).toByteArray());
+   clRecorderT.appendFrame(QCanFrame(QCanFrame::eFORMAT_CAN_EXT, 0x555, 8).toByteArray());
+   QCOMPARE(clSpyT.count(), 0);
+
+   clRecorderT.appendFrame(QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x55A, 8).toByteArray());
+   QCOMPARE(clSpyT.count(), 1);
+   QCOMPARE(clSpyT.at(0).at(0).toInt(), 0);
+   QVERIFY(clRecorderT.isTriggered() == true);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkPayload()                                                             //
+// trigger on payload pattern                                                 //
+//----------------------------------------------------------------------------//
+void TestQCanRecorder::checkPayload()
+{
+   QCanRecorder         clRecorderT;
+   QSignalSpy           clSpyT(&clRecorderT, SIGNAL(triggered(int32_t)));
+   RecorderTrigger_ts   tsTriggerT = defaultTrigger(eRECORDER_TRIGGER_PAYLOAD);
+   QCanFrame            clFrameT(QCanFrame::eFORMAT_CAN_STD, 0x200, 8);
+
+   tsTriggerT.ulIdMatch         = 0x200;
+   tsTriggerT.ulIdMask          = 0x7FF;
+   tsTriggerT.aubPattern[0]     = 0xA5;
+   tsTriggerT.aubPatternMask[0] = 0xF0;
+   tsTriggerT.ubPatternPos      = 2;
+   tsTriggerT.ubPatternSize     = 1;
+   QCOMPARE(clRecorderT.addTrigger(tsTriggerT), 0);
+
+   tsTriggerT.ubPatternSize     = 0;
+   QCOMPARE(clRecorderT.addTrigger(tsTriggerT), -1);
+   clRecorderT.setEnabled();
+
+   clFrameT.setData(2, 0x5A);
+   clRecorderT.appendFrame(clFrameT.toByteArray());
+   clFrameT.setData(2, 0xA0);
+   clFrameT.setDlc(2);
+   clRecorderT.appendFrame(clFrameT.toByteArray());
+   QCOMPARE(clSpyT.count(), 0);
+
+   clFrameT.setDlc(3);
+   clRecorderT.appendFrame(clFrameT.toByteArray());
+   QCOMPARE(clSpyT.count(), 1);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkErrorFrame()                                                          //
+// trigger on error frame type                                                //
+//----------------------------------------------------------------------------//
+void TestQCanRecorder::checkErrorFrame()
+{
+   QCanRecorder         clRecorderT;
+   QSignalSpy           clSpyT(&clRecorderT, SIGNAL(triggered(int32_t)));
+   RecorderTrigger_ts   tsTriggerT = defaultTrigger(eRECORDER_TRIGGER_ERROR_FRAME);
+   QCanFrame            clFrameT;
+
+   tsTriggerT.teErrorType = QCanFrame::eERROR_TYPE_CRC;
+   QCOMPARE(clRecorderT.addTrigger(tsTriggerT), 0);
+   clRecorderT.setEnabled();
+
+   clFrameT.setFrameType(QCanFrame::eFRAME_TYPE_ERROR);
+   clFrameT.setErrorType(QCanFrame::eERROR_TYPE_FORM);
+   clRecorderT.appendFrame(clFrameT.toByteArray());
+   QCOMPARE(clSpyT.count(), 0);
+
+   clFrameT.setErrorType(QCanFrame::eERROR_TYPE_CRC);
+   clRecorderT.appendFrame(clFrameT.toByteArray());
+   QCOMPARE(clSpyT.count(), 1);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkBusOff()                                                              //
+// trigger on bus-off state                                                   //
+//----------------------------------------------------------------------------//
+void TestQCanRecorder::checkBusOff()
+{
+   QCanRecorder         clRecorderT;
+   QSignalSpy           clSpyT(&clRecorderT, SIGNAL(triggered(int32_t)));
+
+   clRecorderT.addTrigger(defaultTrigger(eRECORDER_TRIGGER_IDENTIFIER));
+   QCOMPARE(clRecorderT.addTrigger(defaultTrigger(eRECORDER_TRIGGER_BUS_OFF)), 1);
+
+   clRecorderT.changeState(eCAN_STATE_BUS_OFF);
+   QCOMPARE(clSpyT.count(), 0);
+
+   clRecorderT.setEnabled();
+   clRecorderT.changeState(eCAN_STATE_BUS_PASSIVE);
+   QCOMPARE(clSpyT.count(), 0);
+
+   clRecorderT.changeState(eCAN_STATE_BUS_OFF);
+   QCOMPARE(clSpyT.count(), 1);
+   QCOMPARE(clSpyT.at(0).at(0).toInt(), 1);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkCapture()                                                             //
+// write frames before and after trigger to trace file                        //
+//----------------------------------------------------------------------------//
+void TestQCanRecorder::checkCapture()
+{
+   QCanRecorder         clRecorderT;
+   QSignalSpy           clSpyT(&clRecorderT, SIGNAL(traceWritten(QString, bool)));
+   RecorderTrigger_ts   tsTriggerT = defaultTrigger(eRECORDER_TRIGGER_IDENTIFIER);
+   QCanTraceReader      clReaderT;
+   QCanFrame            clFrameT;
+   int32_t              slFrameT;
+
+   tsTriggerT.ulIdMatch = 0x555;
+   tsTriggerT.ulIdMask  = 0x7FF;
+   clRecorderT.addTrigger(tsTriggerT);
+   clRecorderT.setTraceFilePrefix(clTempDirP.path() + "/can");
+   clRecorderT.setTriggerTime(10000, 50);
+   clRecorderT.setEnabled();
+
+   for (slFrameT = 0; slFrameT < 20; slFrameT++)
+   {
+      if (slFrameT == 10)
+      {
+         clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x555, 4);
+      }
+      else
+      {
+         clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x100, 4);
+      }
+      clFrameT.setDataUInt32(0, (uint32_t) slFrameT);
+      clRecorderT.appendFrame(clFrameT.toByteArray());
+   }
+   QVERIFY(clRecorderT.isTriggered() == true);
+
+   //----------------------------------------------------------------
+   // the post-trigger timer ends the capture, the file is written
+   // by the thread pool of the recorder
+   //
+   QVERIFY(clSpyT.wait(5000) == true);
+   QVERIFY(clRecorderT.isTriggered() == false);
+   QCOMPARE(clSpyT.at(0).at(1).toBool(), true);
+
+   QVERIFY(clReaderT.open(clSpyT.at(0).at(0).toString()) == true);
+   QCOMPARE(clReaderT.frameCount(), (uint64_t) 20);
+   QVERIFY(clReaderT.frame(0, clFrameT) == true);
+   QCOMPARE(clFrameT.dataUInt32(0), (uint32_t) 0);
+   QVERIFY(clReaderT.frame(10, clFrameT) == true);
+   QCOMPARE(clFrameT.identifier(), (uint32_t) 0x555);
+   QVERIFY(clReaderT.frame(19, clFrameT) == true);
+   QCOMPARE(clFrameT.dataUInt32(0), (uint32_t) 19);
+}
+
+
+//----------------------------------------------------------------------------//
+// cleanupTestCase()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void TestQCanRecorder::cleanupTestCase()
+{
+
+}
+
@@ -0,0 +1,349 @@
+//============================================================================//
+// File:          test_qcan_signal.cpp                                        //
+// Description:   QCAN classes - Test signal database                         //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+#include <QtCore/QElapsedTimer>
+
+#include "test_qcan_signal.hpp"
+
+
+//-------------------------------------------------------------------
+// signal database for all test cases: message 'Battery' uses an
+// extended identifier (bit 31 set), the signal 'Mode' is multiplexed
+// and the signals of the pseudo message are ignored
+//
+static const char aszDatabaseS[] =
+      "VERSION \"\"\n"
+      "\n"
+      "BO_ 291 Engine: 8 ECU\n"
+      " SG_ Speed : 0|16@1+ (0.125,0) [0|8031.875] \"rpm\" Vector__XXX\n"
+      " SG_ Temperature : 16|8@1+ (1,-40) [-40|215] \"degC\" Vector__XXX\n"
+      " SG_ Torque : 31|12@0- (0.5,0) [-1024|1023.5] \"Nm\" Vector__XXX\n"
+      " SG_ Mode m1 : 48|8@1+ (1,0) [0|255] \"\" Vector__XXX\n"
+      "\n"
+      "BO_ 2566844926 Battery: 8 BMS\n"
+      " SG_ Voltage : 7|16@0+ (0.01,0) [0|655.35] \"V\" Vector__XXX\n"
+      " SG_ Current : 16|16@1- (0.1,0) [-3276.8|3276.7] \"A\" Vector__XXX\n"
+      "\n"
+      "BO_ 3221225472 VECTOR__INDEPENDENT_SIG_MSG: 0 Vector__XXX\n"
+      " SG_ Unused : 0|8@1+ (1,0) [0|0] \"\" Vector__XXX\n"
+      "\n"
+      "CM_ SG_ 291 Speed \"Engine speed\";\n";
+
+
+TestQCanSignal::TestQCanSignal()
+{
+
+}
+
+
+TestQCanSignal::~TestQCanSignal()
+{
+
+}
+
+
+//----------------------------------------------------------------------------//
+// engineFrame()                                                              //
+// frame of message 'Engine': temperature 87 degC, torque -100 Nm             //
+//----------------------------------------------------------------------------//
+QCanFrame TestQCanSignal::engineFrame(uint16_t uwSpeedV)
+{
+   QCanFrame clFrameT(QCanFrame::eFORMAT_CAN_STD, 0x123, 8);
+
+   clFrameT.setDataUInt16(0, uwSpeedV, false);
+   clFrameT.setData(2, 0x7F);
+   clFrameT.setData(3, 0xF3);
+   clFrameT.setData(4, 0x80);
+
+   return (clFrameT);
+}
+
+
+//----------------------------------------------------------------------------//
+// batteryFrame()                                                             //
+// frame of message 'Battery': voltage 13.0 V, current -12.5 A                //
+//----------------------------------------------------------------------------//
+QCanFrame TestQCanSignal::batteryFrame(void)
+{
+   QCanFrame clFrameT(QCanFrame::eFORMAT_CAN_EXT, 0x18FEF1FE, 8);
+
+   clFrameT.setData(0, 0x05);
+   clFrameT.setData(1, 0x14);
+   clFrameT.setData(2, 0x83);
+   clFrameT.setData(3, 0xFF);
+
+   return (clFrameT);
+}
+
+
+//----------------------------------------------------------------------------//
+// initTestCase()                                                             //
+// prepare test cases                                                         //
+//----------------------------------------------------------------------------//
+void TestQCanSignal::initTestCase()
+{
+   QVERIFY(clDatabaseP.parse(QString(aszDatabaseS)) == true);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkParse()                                                               //
+// check messages and signals of database                                     //
+//----------------------------------------------------------------------------//
+void TestQCanSignal::checkParse()
+{
+   QCanSignalDatabase   clDatabaseT;
+
+   QCOMPARE(clDatabaseP.messageCount(), 2);
+   QCOMPARE(clDatabaseP.signalCount(), 5);
+
+   QCOMPARE(clDatabaseP.signalIndex("Speed"), 0);
+   QCOMPARE(clDatabaseP.signalIndex("Battery.Current"), 4);
+   QCOMPARE(clDatabaseP.signalIndex("Engine.Current"), -1);
+   QCOMPARE(clDatabaseP.signalIndex("Mode"), -1);
+   QCOMPARE(clDatabaseP.signalUnit(1), QString("degC"));
+   QCOMPARE(clDatabaseP.messageName(clDatabaseP.signalMessage(3)), QString("Battery"));
+
+   //----------------------------------------------------------------
+   // signal exceeds the data field of a CAN FD frame
+   //
+   QVERIFY(clDatabaseT.parse("BO_ 1 Test: 8 ECU\n"
+                             " SG_ Value : 500|16@1+ (1,0) [0|0] \"\" ECU\n") == false);
+   QCOMPARE(clDatabaseT.messageCount(), 0);
+   QVERIFY(clDatabaseT.errorString().startsWith("Line 2"));
+
+   //----------------------------------------------------------------
+   // signal without message
+   //
+   QVERIFY(clDatabaseT.parse(" SG_ Value : 0|8@1+ (1,0) [0|0] \"\" ECU\n") == false);
+
+   //----------------------------------------------------------------
+   // signal with 64 bits
+   //
+   QVERIFY(clDatabaseT.parse("BO_ 1 Test: 16 ECU\n"
+                             " SG_ Value : 4|64@1+ (1,0) [0|0] \"\" ECU\n") == true);
+   QCOMPARE(clDatabaseT.signalCount(), 1);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkIntel()                                                               //
+// check signals in Intel format                                              //
+//----------------------------------------------------------------------------//
+void TestQCanSignal::checkIntel()
+{
+   QVector<QCanFrame>                           clFrameListT;
+   QVector<QCanSignalDatabase::SignalValues_s>  clValuesT;
+   QCanFrame                                    clFrameT;
+
+   clFrameListT.append(engineFrame(9600));
+   clFrameListT.append(batteryFrame());
+   QCOMPARE(clDatabaseP.decode(clFrameListT, clValuesT), 2);
+   QCOMPARE(clValuesT.size(), 5);
+
+   QCOMPARE(clValuesT[0].clRaw.at(0), (int64_t) 9600);
+   QCOMPARE(clValuesT[0].clValue.at(0), 1200.0);
+   QCOMPARE(clValuesT[1].clValue.at(0), 87.0);
+   QCOMPARE(clValuesT[4].clRaw.at(0), (int64_t) -125);
+   QCOMPARE(clValuesT[4].clValue.at(0), -12.5);
+
+   //----------------------------------------------------------------
+   // 64 bit signal spanning nine bytes
+   //
+   QCanSignalDatabase clDatabaseT;
+   QVERIFY(clDatabaseT.parse("BO_ 1 Test: 16 ECU\n"
+                             " SG_ Value : 4|64@1+ (1,0) [0|0] \"\" ECU\n") == true);
+
+   clFrameT = QCanFrame(QCanFrame::eFORMAT_FD_STD, 1, 10);
+   for (uint8_t ubPosT = 0; ubPosT < 9; ubPosT++)
+   {
+      clFrameT.setData(ubPosT, (uint8_t) (0x10 * ubPosT + 0x0F - ubPosT));
+   }
+   clFrameListT.clear();
+   clFrameListT.append(clFrameT);
+   QCOMPARE(clDatabaseT.decode(clFrameListT, clValuesT), 1);
+   QCOMPARE((uint64_t) clValuesT[0].clRaw.at(0), Q_UINT64_C(0x778695A4B3C2D1E0));
+}
+
+
+//----------------------------------------------------------------------------//
+// checkMotorola()                                                            //
+// check signals in Motorola format                                           //
+//----------------------------------------------------------------------------//
+void TestQCanSignal::checkMotorola()
+{
+   QVector<QCanFrame>                           clFrameListT;
+   QVector<QCanSignalDatabase::SignalValues_s>  clValuesT;
+
+   clFrameListT.append(engineFrame(0));
+   clFrameListT.append(batteryFrame());
+   QCOMPARE(clDatabaseP.decode(clFrameListT, clValuesT), 2);
+
+   QCOMPARE(clValuesT[2].clRaw.at(0), (int64_t) -200);
+   QCOMPARE(clValuesT[2].clValue.at(0), -100.0);
+   QCOMPARE(clValuesT[3].clRaw.at(0), (int64_t) 1300);
+   QCOMPARE(clValuesT[3].clValue.at(0), 13.0);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkDecode()                                                              //
+// check columns of a batch                                                   //
+//----------------------------------------------------------------------------//
+void TestQCanSignal::checkDecode()
+{
+   QVector<QCanFrame>                           clFrameListT;
+   QVector<QCanSignalDatabase::SignalValues_s>  clValuesT;
+   QCanFrame                                    clFrameT;
+
+   clFrameListT.append(engineFrame(800));
+   clFrameListT.append(QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x200, 8));
+   clFrameListT.append(batteryFrame());
+
+   //----------------------------------------------------------------
+   // the frame is too short for the signal 'Torque'
+   //
+   clFrameT = engineFrame(1600);
+   clFrameT.setDlc(4);
+   clFrameListT.append(clFrameT);
+
+   clFrameT = engineFrame(2400);
+   clFrameT.setRemote();
+   clFrameListT.append(clFrameT);
+
+   //----------------------------------------------------------------
+   // standard frame with the identifier of message 'Battery'
+   //
+   clFrameListT.append(QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x18FEF1FE & 0x7FF, 8));
+
+   clFrameListT.append(engineFrame(3200));
+
+   QCOMPARE(clDatabaseP.decode(clFrameListT, clValuesT), 3);
+
+   QCOMPARE(clValuesT[0].clFrameIndex.size(), 2);
+   QCOMPARE(clValuesT[0].clFrameIndex.at(0), 0);
+   QCOMPARE(clValuesT[0].clFrameIndex.at(1), 6);
+   QCOMPARE(clValuesT[0].clValue.at(0), 100.0);
+   QCOMPARE(clValuesT[0].clValue.at(1), 400.0);
+   QCOMPARE(clValuesT[2].clValue.size(), 2);
+
+   QCOMPARE(clValuesT[3].clFrameIndex.size(), 1);
+   QCOMPARE(clValuesT[3].clFrameIndex.at(0), 2);
+
+   //----------------------------------------------------------------
+   // the columns are cleared by the next batch
+   //
+   clFrameListT.clear();
+   clFrameListT.append(batteryFrame());
+   QCOMPARE(clDatabaseP.decode(clFrameListT, clValuesT), 1);
+   QCOMPARE(clValuesT[0].clValue.size(), 0);
+   QCOMPARE(clValuesT[4].clValue.size(), 1);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkString()                                                              //
+// check decoding of a single frame                                           //
+//----------------------------------------------------------------------------//
+void TestQCanSignal::checkString()
+{
+   QCOMPARE(clDatabaseP.toString(engineFrame(9600)),
+            QString("Engine: Speed=1200 rpm Temperature=87 degC Torque=-100 Nm"));
+
+   QCOMPARE(clDatabaseP.toString(batteryFrame()),
+            QString("Battery: Voltage=13 V Current=-12.5 A"));
+
+   QVERIFY(clDatabaseP.toString(QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x200, 8)).isEmpty());
+}
+
+
+//----------------------------------------------------------------------------//
+// decodeRate()                                                               //
+// benchmark: decode a batch of 10000 frames                                  //
+//----------------------------------------------------------------------------//
+void TestQCanSignal::decodeRate()
+{
+   QVector<QCanFrame>                           clFrameListT;
+   QVector<QCanSignalDatabase::SignalValues_s>  clValuesT;
+   QElapsedTimer                                clTimerT;
+   int64_t                                      sqSignalCntT = 0;
+   int32_t                                      slRunT;
+
+   for (int32_t slFrameT = 0; slFrameT < 10000; slFrameT++)
+   {
+      if (slFrameT % 4 == 0)
+      {
+         clFrameListT.append(batteryFrame());
+      }
+      else
+      {
+         clFrameListT.append(engineFrame((uint16_t) slFrameT));
+      }
+   }
+
+   QBENCHMARK
+   {
+      clDatabaseP.decode(clFrameListT, clValuesT);
+   }
+
+   //----------------------------------------------------------------
+   // report the number of signals decoded per second
+   //
+   clTimerT.start();
+   for (slRunT = 0; slRunT < 100; slRunT++)
+   {
+      clDatabaseP.decode(clFrameListT, clValuesT);
+      for (int32_t slSignalT = 0; slSignalT < clValuesT.size(); slSignalT++)
+      {
+         sqSignalCntT += clValuesT[slSignalT].clValue.size();
+      }
+   }
+
+   QCOMPARE(sqSignalCntT, (int64_t) 100 * (7500 * 3 + 2500 * 2));
+   qDebug() << "Signals decoded per second:"
+            << (sqSignalCntT * 1000000000) / qMax(clTimerT.nsecsElapsed(), (qint64) 1);
+}
+
+
+//----------------------------------------------------------------------------//
+// cleanupTestCase()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void TestQCanSignal::cleanupTestCase()
+{
+   clDatabaseP.clear();
+}
+
@@ -0,0 +1,279 @@
+//============================================================================//
+// File:          test_qcan_trace.cpp                                         //
+// Description:   QCAN classes - Test trace file                              //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+#include "test_qcan_trace.hpp"
+
+
+//-------------------------------------------------------------------
+// the test trace holds 10000 frames with a distance of 1 ms, every
+// 1000th frame has the identifier 555h and every 5000th frame is an
+// extended frame
+//
+#define  TRACE_FRAME_COUNT    10000
+
+
+TestQCanTrace::TestQCanTrace()
+{
+
+}
+
+
+TestQCanTrace::~TestQCanTrace()
+{
+
+}
+
+
+//----------------------------------------------------------------------------//
+// initTestCase()                                                             //
+// write trace file                                                           //
+//----------------------------------------------------------------------------//
+void TestQCanTrace::initTestCase()
+{
+   QCanTraceWriter   clWriterT;
+   QCanFrame         clFrameT;
+
+   QVERIFY(clTempDirP.isValid());
+   clFileNameP = clTempDirP.path() + "/test.qct";
+
+   QVERIFY(clWriterT.open(clFileNameP) == true);
+   for (int32_t slFrameT = 0; slFrameT < TRACE_FRAME_COUNT; slFrameT++)
+   {
+      if (slFrameT % 5000 == 3)
+      {
+         clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_EXT, 0x18FF0000, 8);
+      }
+      else if (slFrameT % 1000 == 7)
+      {
+         clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x555, 8);
+      }
+      else
+      {
+         clFrameT = QCanFrame(QCanFrame::eFORMAT_CAN_STD, 0x100 + (slFrameT % 64), 8);
+      }
+      clFrameT.setDataUInt32(0, (uint32_t) slFrameT);
+      clFrameT.setTimeStamp(QCanTimeStamp(slFrameT / 1000, (slFrameT % 1000) * 1000000));
+      QVERIFY(clWriterT.write(clFrameT) == true);
+   }
+
+   QCOMPARE(clWriterT.frameCount(), (uint64_t) TRACE_FRAME_COUNT);
+   QVERIFY(clWriterT.close() == true);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkRead()                                                                //
+// check random access                                                        //
+//----------------------------------------------------------------------------//
+void TestQCanTrace::checkRead()
+{
+   QCanTraceReader   clReaderT;
+   QCanFrame         clFrameT;
+
+   QVERIFY(clReaderT.open(clFileNameP) == true);
+   QCOMPARE(clReaderT.frameCount(), (uint64_t) TRACE_FRAME_COUNT);
+   QCOMPARE(clReaderT.blockCount(),
+            (uint64_t) ((TRACE_FRAME_COUNT + QCAN_TRACE_BLOCK_FRAMES - 1) / QCAN_TRACE_BLOCK_FRAMES));
+
+   QVERIFY(clReaderT.frame(1234, clFrameT) == true);
+   QCOMPARE(clFrameT.dataUInt32(0), (uint32_t) 1234);
+   QCOMPARE(clFrameT.timeStamp().seconds(), (uint32_t) 1);
+   QCOMPARE(clFrameT.timeStamp().nanoSeconds(), (uint32_t) 234000000);
+
+   QVERIFY(clReaderT.frame(TRACE_FRAME_COUNT - 1, clFrameT) == true);
+   QCOMPARE(clFrameT.dataUInt32(0), (uint32_t) (TRACE_FRAME_COUNT - 1));
+   QVERIFY(clReaderT.frame(TRACE_FRAME_COUNT, clFrameT) == false);
+
+   QVERIFY(clReaderT.open(clTempDirP.path() + "/missing.qct") == false);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkSeekTime()                                                            //
+// find frames by time-stamp                                                  //
+//----------------------------------------------------------------------------//
+void TestQCanTrace::checkSeekTime()
+{
+   QCanTraceReader   clReaderT;
+
+   QVERIFY(clReaderT.open(clFileNameP) == true);
+   QCOMPARE(clReaderT.seekTime(QCanTimeStamp(0)), (uint64_t) 0);
+   QCOMPARE(clReaderT.seekTime(QCanTimeStamp(5, 500000000)), (uint64_t) 5500);
+   QCOMPARE(clReaderT.seekTime(QCanTimeStamp(5, 500000001)), (uint64_t) 5501);
+   QCOMPARE(clReaderT.seekTime(QCanTimeStamp(100)), (uint64_t) TRACE_FRAME_COUNT);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkIdentifier()                                                          //
+// find frames by identifier                                                  //
+//----------------------------------------------------------------------------//
+void TestQCanTrace::checkIdentifier()
+{
+   QCanTraceReader   clReaderT;
+   QCanFrame         clFrameT;
+   uint64_t          uqIndexT;
+   int32_t           slCountT;
+
+   QVERIFY(clReaderT.open(clFileNameP) == true);
+
+   slCountT = 0;
+   uqIndexT = clReaderT.findIdentifier(0, 0x555, false);
+   while (clReaderT.frame(uqIndexT, clFrameT))
+   {
+      QCOMPARE(clFrameT.identifier(), (uint32_t) 0x555);
+      QCOMPARE(uqIndexT % 1000, (uint64_t) 7);
+      slCountT++;
+      uqIndexT = clReaderT.findIdentifier(uqIndexT + 1, 0x555, false);
+   }
+   QCOMPARE(slCountT, TRACE_FRAME_COUNT / 1000);
+
+   QCOMPARE(clReaderT.findIdentifier(4000, 0x18FF0000, true), (uint64_t) 5003);
+   QCOMPARE(clReaderT.findIdentifier(0, 0x18FF0000, false), (uint64_t) TRACE_FRAME_COUNT);
+   QCOMPARE(clReaderT.findIdentifier(0, 0x7FF, false), (uint64_t) TRACE_FRAME_COUNT);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkRecover()                                                             //
+// read a trace file which has not been closed                                //
+//----------------------------------------------------------------------------//
+void TestQCanTrace::checkRecover()
+{
+   QCanTraceReader   clReaderT;
+   QFile             clSourceT(clFileNameP);
+   QFile             clTargetT(clTempDirP.path() + "/recover.qct");
+   QByteArray        clDataT;
+
+   //----------------------------------------------------------------
+   // remove the index and the position of the index
+   //
+   QVERIFY(clSourceT.open(QIODevice::ReadOnly) == true);
+   clDataT = clSourceT.read(64 + 10 * (96 + (QCAN_TRACE_BLOCK_FRAMES * QCAN_FRAME_ARRAY_SIZE)) + 100);
+   clDataT.replace(32, 8, QByteArray(8, 0));
+   QVERIFY(clTargetT.open(QIODevice::WriteOnly) == true);
+   clTargetT.write(clDataT);
+   clTargetT.close();
+
+   QVERIFY(clReaderT.open(clTargetT.fileName()) == true);
+   QCOMPARE(clReaderT.blockCount(), (uint64_t) 10);
+   QCOMPARE(clReaderT.frameCount(), (uint64_t) (10 * QCAN_TRACE_BLOCK_FRAMES));
+   QCOMPARE(clReaderT.findIdentifier(0, 0x555, false), (uint64_t) 7);
+   QCOMPARE(clReaderT.seekTime(QCanTimeStamp(2)), (uint64_t) 2000);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkInvalidHeader()                                                       //
+// reject a file header with an invalid number of frames per block            //
+//----------------------------------------------------------------------------//
+void TestQCanTrace::checkInvalidHeader()
+{
+   QCanTraceReader   clReaderT;
+   QFile             clSourceT(clFileNameP);
+   QFile             clTargetT(clTempDirP.path() + "/invalid.qct");
+   QByteArray        clDataT;
+   QByteArray        clBlockFramesT(4, 0);
+
+   QVERIFY(clSourceT.open(QIODevice::ReadOnly) == true);
+   clDataT = clSourceT.readAll();
+
+   //----------------------------------------------------------------
+   // no frames per block
+   //
+   clDataT.replace(8, 4, clBlockFramesT);
+   QVERIFY(clTargetT.open(QIODevice::WriteOnly) == true);
+   clTargetT.write(clDataT);
+   clTargetT.close();
+   QVERIFY(clReaderT.open(clTargetT.fileName()) == false);
+
+   //----------------------------------------------------------------
+   // number of frames per block exceeds the limit of the reader
+   //
+   qToBigEndian<quint32>(0x10000000, (uchar *) clBlockFramesT.data());
+   clDataT.replace(8, 4, clBlockFramesT);
+   QVERIFY(clTargetT.open(QIODevice::WriteOnly) == true);
+   clTargetT.write(clDataT);
+   clTargetT.close();
+   QVERIFY(clReaderT.open(clTargetT.fileName()) == false);
+}
+
+
+//----------------------------------------------------------------------------//
+// checkWriteError()                                                          //
+// a block which can not be written is neither indexed nor counted            //
+//----------------------------------------------------------------------------//
+void TestQCanTrace::checkWriteError()
+{
+   #ifdef Q_OS_LINUX
+   QCanTraceWriter   clWriterT;
+   QCanFrame         clFrameT(QCanFrame::eFORMAT_CAN_STD, 0x123, 8);
+   int32_t           slFrameT;
+
+   //----------------------------------------------------------------
+   // every write to /dev/full fails, the first block is larger than
+   // the write buffer of QFile
+   //
+   QVERIFY(clWriterT.open("/dev/full") == true);
+   for (slFrameT = 0; slFrameT < (QCAN_TRACE_BLOCK_FRAMES - 1); slFrameT++)
+   {
+      QVERIFY(clWriterT.write(clFrameT) == true);
+   }
+   QVERIFY(clWriterT.write(clFrameT) == false);
+   QVERIFY(clWriterT.isOpen() == false);
+   QVERIFY(clWriterT.errorString().isEmpty() == false);
+   QCOMPARE(clWriterT.frameCount(), (uint64_t) 0);
+
+   //----------------------------------------------------------------
+   // no further frames are accepted
+   //
+   QVERIFY(clWriterT.write(clFrameT) == false);
+   QVERIFY(clWriterT.close() == false);
+   #else
+   QSKIP("needs /dev/full");
+   #endif
+}
+
+
+//----------------------------------------------------------------------------//
+// cleanupTestCase()                                                          //
+//                                                                            //
+//----------------------------------------------------------------------------//
+void TestQCanTrace::cleanupTestCase()
+{
+
+}
+
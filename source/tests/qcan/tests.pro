@@ -85,11 +85,27 @@ VPATH += ./../../qcan
 # header files of project 
 #
 HEADERS +=  qcan_frame.hpp             \
+            qcan_frame_queue.hpp       \
+            qcan_gateway.hpp           \
             qcan_interface.hpp         \
+            qcan_isotp.hpp             \
+            qcan_multiplexer.hpp       \
+            qcan_network.hpp           \
+            qcan_recorder.hpp          \
+            qcan_scheduler.hpp         \
+            qcan_signal_database.hpp   \
             qcan_socket.hpp            \
+            qcan_socket_thread.hpp     \
+            qcan_trace.hpp             \
+            qcan_value_table.hpp       \
             test_qcan_frame.hpp        \
+            test_qcan_isotp.hpp        \
+            test_qcan_network.hpp      \
+            test_qcan_recorder.hpp     \
+            test_qcan_signal.hpp       \
             test_qcan_socket.hpp       \
-            test_qcan_timestamp.hpp
+            test_qcan_timestamp.hpp    \
+            test_qcan_trace.hpp
 
 #---------------------------------------------------------------
 # source files of project 
@@ -98,11 +114,27 @@ SOURCES +=  qcan_data.cpp              \
             qcan_frame.cpp             \
             qcan_frame_api.cpp         \
             qcan_frame_error.cpp       \
+            qcan_frame_queue.cpp       \
+            qcan_gateway.cpp           \
+            qcan_isotp.cpp             \
+            qcan_multiplexer.cpp       \
+            qcan_network.cpp           \
+            qcan_recorder.cpp          \
+            qcan_scheduler.cpp         \
+            qcan_signal_database.cpp   \
             qcan_timestamp.cpp         \
             qcan_socket.cpp            \
+            qcan_socket_thread.cpp     \
+            qcan_trace.cpp             \
+            qcan_value_table.cpp       \
             test_qcan_frame.cpp        \
+            test_qcan_isotp.cpp        \
+            test_qcan_network.cpp      \
+            test_qcan_recorder.cpp     \
+            test_qcan_signal.cpp       \
             test_qcan_socket.cpp       \
             test_qcan_timestamp.cpp    \
+            test_qcan_trace.cpp        \
             test_main.cpp
 
 
@@ -0,0 +1,299 @@
+//============================================================================//
+// File:          bench_cp_usart_pty.c                                        //
+// Description:   Benchmark of USART frame decoder on a pty pair              //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#define _DEFAULT_SOURCE
+#define _XOPEN_SOURCE  600
+
+#include "cp_usart_frame.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#define  BENCH_BAUDRATE       3000000UL
+#define  BENCH_FRAMES         50000UL
+#define  BENCH_CHUNK_MAX      256
+#define  BENCH_MSG_MAX        64
+
+/*----------------------------------------------------------------------------*\
+** Variables of module                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+static int        slMasterS;
+static int        slSlaveS;
+static uint8_t   *pubStreamS;
+static uint32_t   ulStreamSizeS;
+static uint32_t   ulByteRateS;
+
+
+/*----------------------------------------------------------------------------*\
+** Function implementations                                                   **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//----------------------------------------------------------------------------//
+// BenchTimeNs()                                                              //
+// monotonic time in nanoseconds                                              //
+//----------------------------------------------------------------------------//
+static uint64_t BenchTimeNs(void)
+{
+   struct timespec tsTimeT;
+
+   clock_gettime(CLOCK_MONOTONIC, &tsTimeT);
+   return ((uint64_t) tsTimeT.tv_sec * 1000000000ULL + (uint64_t) tsTimeT.tv_nsec);
+}
+
+
+//----------------------------------------------------------------------------//
+// BenchWriter()                                                              //
+// write the encoded stream in random chunks, paced to the byte rate          //
+//----------------------------------------------------------------------------//
+static void *BenchWriter(void *pvArgV)
+{
+   uint64_t uqStartT;
+   uint64_t uqDueT;
+   uint64_t uqNowT;
+   uint32_t ulPosT = 0;
+   uint32_t ulChunkT;
+   ssize_t  slWrittenT;
+
+   (void) pvArgV;
+
+   uqStartT = BenchTimeNs();
+   while (ulPosT < ulStreamSizeS)
+   {
+      ulChunkT = 1 + ((uint32_t) rand() % BENCH_CHUNK_MAX);
+      if (ulChunkT > (ulStreamSizeS - ulPosT))
+      {
+         ulChunkT = ulStreamSizeS - ulPosT;
+      }
+
+      //--------------------------------------------------------
+      // keep the line rate of the simulated USART
+      //
+      if (ulByteRateS > 0)
+      {
+         uqDueT = uqStartT + ((uint64_t) ulPosT * 1000000000ULL) / ulByteRateS;
+         uqNowT = BenchTimeNs();
+         if (uqDueT > uqNowT)
+         {
+            struct timespec tsWaitT;
+            tsWaitT.tv_sec  = (time_t) ((uqDueT - uqNowT) / 1000000000ULL);
+            tsWaitT.tv_nsec = (long) ((uqDueT - uqNowT) % 1000000000ULL);
+            nanosleep(&tsWaitT, NULL);
+         }
+      }
+
+      slWrittenT = write(slMasterS, &pubStreamS[ulPosT], ulChunkT);
+      if (slWrittenT < 0)
+      {
+         perror("write");
+         break;
+      }
+      ulPosT += (uint32_t) slWrittenT;
+   }
+
+   return (NULL);
+}
+
+
+//----------------------------------------------------------------------------//
+// BenchOpenPty()                                                             //
+// open pseudo terminal pair in raw mode                                      //
+//----------------------------------------------------------------------------//
+static int BenchOpenPty(void)
+{
+   struct termios tsTermT;
+
+   slMasterS = posix_openpt(O_RDWR | O_NOCTTY);
+   if ((slMasterS < 0) || (grantpt(slMasterS) != 0) || (unlockpt(slMasterS) != 0))
+   {
+      perror("posix_openpt");
+      return (-1);
+   }
+
+   slSlaveS = open(ptsname(slMasterS), O_RDWR | O_NOCTTY);
+   if (slSlaveS < 0)
+   {
+      perror("open");
+      return (-1);
+   }
+
+   tcgetattr(slSlaveS, &tsTermT);
+   cfmakeraw(&tsTermT);
+   tcsetattr(slSlaveS, TCSANOW, &tsTermT);
+   tcgetattr(slMasterS, &tsTermT);
+   cfmakeraw(&tsTermT);
+   tcsetattr(slMasterS, TCSANOW, &tsTermT);
+
+   return (0);
+}
+
+
+//----------------------------------------------------------------------------//
+// main()                                                                     //
+// usage: bench_usart [baudrate|0] [frames] [version]                         //
+//----------------------------------------------------------------------------//
+int main(int argc, const char *argv[])
+{
+   static CpCanMsg_ts   atsCanMsgT[BENCH_MSG_MAX];
+   static uint8_t       aubReadT[4096];
+   CpUsartDecoder_ts    tsDecoderT;
+   CpCanMsg_ts          tsCanMsgT;
+   pthread_t            tsWriterT;
+   uint32_t             ulBaudrateT = BENCH_BAUDRATE;
+   uint32_t             ulFramesT   = BENCH_FRAMES;
+   uint8_t              ubVersionT  = CP_USART_VERSION;
+   uint32_t             ulMsgIdxT;
+   uint32_t             ulRcvCntT   = 0;
+   uint32_t             ulReadCntT  = 0;
+   uint32_t             ulUsedT;
+   uint32_t             ulPosT;
+   uint64_t             uqStartT;
+   uint64_t             uqDecodeT   = 0;
+   uint64_t             uqTimeT;
+   ssize_t              slReadT;
+
+   if (argc > 1)
+   {
+      ulBaudrateT = (uint32_t) strtoul(argv[1], NULL, 0);
+   }
+   if (argc > 2)
+   {
+      ulFramesT = (uint32_t) strtoul(argv[2], NULL, 0);
+   }
+   if (argc > 3)
+   {
+      ubVersionT = (uint8_t) strtoul(argv[3], NULL, 0);
+   }
+
+   //----------------------------------------------------------------
+   // 8N1 needs 10 bit times for each byte, a baudrate of 0 runs
+   // the benchmark without pacing
+   //
+   ulByteRateS = ulBaudrateT / 10;
+
+   //----------------------------------------------------------------
+   // prepare the stream
+   //
+   pubStreamS    = (uint8_t *) malloc(ulFramesT * CP_USART_FRAME_SIZE);
+   ulStreamSizeS = 0;
+   if (pubStreamS == NULL)
+   {
+      return (1);
+   }
+   memset(&tsCanMsgT, 0, sizeof(tsCanMsgT));
+   for (ulMsgIdxT = 0; ulMsgIdxT < ulFramesT; ulMsgIdxT++)
+   {
+      tsCanMsgT.ulIdentifier = ulMsgIdxT & 0x7FF;
+      tsCanMsgT.ubMsgDLC     = (uint8_t) (ulMsgIdxT % 9);
+      memcpy(&(tsCanMsgT.tuMsgData.aubByte[0]), &ulMsgIdxT, sizeof(ulMsgIdxT));
+      ulStreamSizeS += CpUsartFrameEncode(&tsCanMsgT, ubVersionT,
+                                          &pubStreamS[ulStreamSizeS]);
+   }
+
+   if (BenchOpenPty() != 0)
+   {
+      return (1);
+   }
+   CpUsartDecoderInit(&tsDecoderT);
+
+   //----------------------------------------------------------------
+   // run writer and decode all frames
+   //
+   uqStartT = BenchTimeNs();
+   pthread_create(&tsWriterT, NULL, BenchWriter, NULL);
+
+   while (ulRcvCntT < ulFramesT)
+   {
+      slReadT = read(slSlaveS, aubReadT, sizeof(aubReadT));
+      if (slReadT <= 0)
+      {
+         break;
+      }
+      ulReadCntT++;
+
+      uqTimeT = BenchTimeNs();
+      ulPosT  = 0;
+      while (ulPosT < (uint32_t) slReadT)
+      {
+         ulRcvCntT += CpUsartFrameDecode(&tsDecoderT, &aubReadT[ulPosT],
+                                         (uint32_t) slReadT - ulPosT, &ulUsedT,
+                                         &atsCanMsgT[0], BENCH_MSG_MAX);
+         ulPosT += ulUsedT;
+      }
+      uqDecodeT += BenchTimeNs() - uqTimeT;
+   }
+   uqTimeT = BenchTimeNs() - uqStartT;
+
+   pthread_join(tsWriterT, NULL);
+
+   printf("baudrate      : %u (%u bytes/s)\n", ulBaudrateT, ulByteRateS);
+   printf("frames        : %u received, %u expected\n", ulRcvCntT, ulFramesT);
+   printf("frame format  : version %u, %.1f bytes/frame\n", ubVersionT,
+          (double) ulStreamSizeS / (double) ulFramesT);
+   printf("errors        : %u, dropped bytes %u\n",
+          tsDecoderT.ulErrorCount, tsDecoderT.ulDropCount);
+   printf("read calls    : %u (%.1f frames/call)\n", ulReadCntT,
+          (double) ulRcvCntT / (double) (ulReadCntT ? ulReadCntT : 1));
+   printf("throughput    : %.0f frames/s\n",
+          (double) ulRcvCntT * 1e9 / (double) uqTimeT);
+   printf("decode time   : %.1f ns/frame\n",
+          (double) uqDecodeT / (double) (ulRcvCntT ? ulRcvCntT : 1));
+
+   close(slSlaveS);
+   close(slMasterS);
+   free(pubStreamS);
+
+   return ((ulRcvCntT == ulFramesT) ? 0 : 1);
+}
@@ -0,0 +1,592 @@
+//============================================================================//
+// File:          test_cp_usart_frame.c                                       //
+// Description:   Unit tests for CANpie USART frame codec                     //
+//                                                                            //
+// Copyright 2017 MicroControl GmbH & Co. KG                                  //
+// 53844 Troisdorf - Germany                                                  //
+// www.microcontrol.net                                                       //
+//                                                                            //
+//----------------------------------------------------------------------------//
+// Redistribution and use in source and binary forms, with or without         //
+// modification, are permitted provided that the following conditions         //
+// are met:                                                                   //
+// 1. Redistributions of source code must retain the above copyright          //
+//    notice, this list of conditions, the following disclaimer and           //
+//    the referenced file 'LICENSE'.                                          //
+// 2. Redistributions in binary form must reproduce the above copyright       //
+//    notice, this list of conditions and the following disclaimer in the     //
+//    documentation and/or other materials provided with the distribution.    //
+// 3. Neither the name of MicroControl nor the names of its contributors      //
+//    may be used to endorse or promote products derived from this software   //
+//    without specific prior written permission.                              //
+//                                                                            //
+// Licensed under the Apache License, Version 2.0 (the "License");            //
+// you may not use this file except in compliance with the License.           //
+// You may obtain a copy of the License at                                    //
+//                                                                            //
+//    http://www.apache.org/licenses/LICENSE-2.0                              //
+//                                                                            //
+// Unless required by applicable law or agreed to in writing, software        //
+// distributed under the License is distributed on an "AS IS" BASIS,          //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   //
+// See the License for the specific language governing permissions and        //
+// limitations under the License.                                             //
+//============================================================================//
+
+
+
+
+
+/*----------------------------------------------------------------------------*\
+** Include files                                                              **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#include "cp_usart_frame.h"
+#include "unity_fixture.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/*----------------------------------------------------------------------------*\
+** Definitions                                                                **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+#define  FRAME_COUNT    20
+
+/*----------------------------------------------------------------------------*\
+** Variables of module                                                        **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+TEST_GROUP(CP_USART_FRAME);     // test group name
+
+static CpUsartDecoder_ts   tsDecoderS;
+static CpCanMsg_ts         atsTrmMsgS[FRAME_COUNT];
+static CpCanMsg_ts         atsRcvMsgS[FRAME_COUNT];
+static uint8_t             aubStreamS[(FRAME_COUNT + 1) * CP_USART_FRAME_SIZE];
+
+/*----------------------------------------------------------------------------*\
+** Function implementations                                                   **
+**                                                                            **
+\*----------------------------------------------------------------------------*/
+
+//----------------------------------------------------------------------------//
+// TestEncodeStream()                                                         //
+// encode all transmit messages into one byte stream                          //
+//----------------------------------------------------------------------------//
+static uint32_t TestEncodeStream(uint8_t ubVersionV, uint8_t *pubStreamV)
+{
+   uint32_t ulMsgIdxT;
+   uint32_t ulSizeT = 0;
+
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      ulSizeT += CpUsartFrameEncode(&atsTrmMsgS[ulMsgIdxT], ubVersionV,
+                                    &pubStreamV[ulSizeT]);
+   }
+
+   return (ulSizeT);
+}
+
+
+//----------------------------------------------------------------------------//
+// TestMsgEqual()                                                             //
+// compare fields of two CAN messages transferred by a USART frame, a         //
+// compact frame only transfers the data bytes defined by the DLC             //
+//----------------------------------------------------------------------------//
+static void TestMsgEqual(CpCanMsg_ts *ptsExpectedV, CpCanMsg_ts *ptsActualV)
+{
+   uint8_t ubSizeT = ptsExpectedV->ubMsgDLC;
+
+   if ((ptsExpectedV->ubMsgCtrl & CP_MSG_CTRL_RTR_BIT) > 0)
+   {
+      ubSizeT = 0;
+   }
+
+   TEST_ASSERT_EQUAL_HEX32(ptsExpectedV->ulIdentifier, ptsActualV->ulIdentifier);
+   TEST_ASSERT_EQUAL_HEX8(ptsExpectedV->ubMsgCtrl, ptsActualV->ubMsgCtrl);
+   TEST_ASSERT_EQUAL(ptsExpectedV->ubMsgDLC, ptsActualV->ubMsgDLC);
+   if (ubSizeT > 0)
+   {
+      TEST_ASSERT_EQUAL_MEMORY(&(ptsExpectedV->tuMsgData.aubByte[0]),
+                               &(ptsActualV->tuMsgData.aubByte[0]),
+                               ubSizeT);
+   }
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_SETUP()                                                               //
+// init code for each test case                                               //
+//----------------------------------------------------------------------------//
+TEST_SETUP(CP_USART_FRAME)
+{
+   uint32_t ulMsgIdxT;
+   uint8_t  ubByteT;
+
+   memset(&atsTrmMsgS[0], 0, sizeof(atsTrmMsgS));
+   memset(&atsRcvMsgS[0], 0, sizeof(atsRcvMsgS));
+
+   //----------------------------------------------------------------
+   // alternate between standard and extended frames, the data
+   // contains the sync pattern on purpose
+   //
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      if (ulMsgIdxT & 1)
+      {
+         atsTrmMsgS[ulMsgIdxT].ulIdentifier = 0x18FEA500UL + ulMsgIdxT;
+         atsTrmMsgS[ulMsgIdxT].ubMsgCtrl    = CP_MSG_CTRL_EXT_BIT;
+      }
+      else
+      {
+         atsTrmMsgS[ulMsgIdxT].ulIdentifier = 0x100 + ulMsgIdxT;
+      }
+      atsTrmMsgS[ulMsgIdxT].ubMsgDLC = (uint8_t) (ulMsgIdxT % 9);
+      for (ubByteT = 0; ubByteT < CP_DATA_SIZE; ubByteT++)
+      {
+         atsTrmMsgS[ulMsgIdxT].tuMsgData.aubByte[ubByteT] =
+               (ubByteT & 1) ? CP_USART_SYNC_1 : CP_USART_SYNC_0;
+      }
+      atsTrmMsgS[ulMsgIdxT].tuMsgData.aubByte[0] = (uint8_t) ulMsgIdxT;
+   }
+
+   CpUsartDecoderInit(&tsDecoderS);
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_TEAR_DOWN()                                                           //
+// release code for each test case                                            //
+//----------------------------------------------------------------------------//
+TEST_TEAR_DOWN(CP_USART_FRAME)
+{
+
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_USART_FRAME_001                                               //
+// encode and decode a single frame                                           //
+//----------------------------------------------------------------------------//
+TEST(CP_USART_FRAME, 001)
+{
+   uint32_t ulUsedT = 0;
+
+   TEST_ASSERT_EQUAL(CP_USART_FRAME_SIZE,
+                     CpUsartFrameEncode(&atsTrmMsgS[1], CP_USART_VERSION_FIXED,
+                                        &aubStreamS[0]));
+   TEST_ASSERT_EQUAL_HEX8(CP_USART_SYNC_0, aubStreamS[0]);
+   TEST_ASSERT_EQUAL_HEX8(CP_USART_SYNC_1, aubStreamS[1]);
+
+   TEST_ASSERT_EQUAL(1, CpUsartFrameDecode(&tsDecoderS, &aubStreamS[0],
+                                           CP_USART_FRAME_SIZE, &ulUsedT,
+                                           &atsRcvMsgS[0], FRAME_COUNT));
+   TEST_ASSERT_EQUAL(CP_USART_FRAME_SIZE, ulUsedT);
+   TestMsgEqual(&atsTrmMsgS[1], &atsRcvMsgS[0]);
+   TEST_ASSERT_EQUAL(1, tsDecoderS.ulFrameCount);
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ulErrorCount);
+
+   UnityPrint("CP_USART_FRAME_001: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_USART_FRAME_002                                               //
+// stream is passed to the decoder byte by byte                               //
+//----------------------------------------------------------------------------//
+TEST(CP_USART_FRAME, 002)
+{
+   uint32_t ulSizeT;
+   uint32_t ulPosT;
+   uint32_t ulUsedT;
+   uint32_t ulMsgCntT = 0;
+
+   ulSizeT = TestEncodeStream(CP_USART_VERSION_FIXED, &aubStreamS[0]);
+
+   for (ulPosT = 0; ulPosT < ulSizeT; ulPosT++)
+   {
+      ulMsgCntT += CpUsartFrameDecode(&tsDecoderS, &aubStreamS[ulPosT], 1,
+                                      &ulUsedT, &atsRcvMsgS[ulMsgCntT],
+                                      FRAME_COUNT - ulMsgCntT);
+      TEST_ASSERT_EQUAL(1, ulUsedT);
+   }
+
+   TEST_ASSERT_EQUAL(FRAME_COUNT, ulMsgCntT);
+   for (ulPosT = 0; ulPosT < FRAME_COUNT; ulPosT++)
+   {
+      TestMsgEqual(&atsTrmMsgS[ulPosT], &atsRcvMsgS[ulPosT]);
+   }
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ulErrorCount);
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ulDropCount);
+
+   UnityPrint("CP_USART_FRAME_002: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_USART_FRAME_003                                               //
+// coalesced frames, limited by the size of the message array                 //
+//----------------------------------------------------------------------------//
+TEST(CP_USART_FRAME, 003)
+{
+   uint32_t ulSizeT;
+   uint32_t ulUsedT;
+   uint32_t ulMsgIdxT;
+
+   ulSizeT = TestEncodeStream(CP_USART_VERSION_FIXED, &aubStreamS[0]);
+
+   //----------------------------------------------------------------
+   // a chunk with a partial frame at the end
+   //
+   TEST_ASSERT_EQUAL(3, CpUsartFrameDecode(&tsDecoderS, &aubStreamS[0],
+                                           (3 * CP_USART_FRAME_SIZE) + 5,
+                                           &ulUsedT, &atsRcvMsgS[0],
+                                           FRAME_COUNT));
+   TEST_ASSERT_EQUAL((3 * CP_USART_FRAME_SIZE) + 5, ulUsedT);
+
+   //----------------------------------------------------------------
+   // the rest of the stream, decoder stops after 10 messages
+   //
+   TEST_ASSERT_EQUAL(10, CpUsartFrameDecode(&tsDecoderS, &aubStreamS[ulUsedT],
+                                            ulSizeT - ulUsedT, &ulUsedT,
+                                            &atsRcvMsgS[3], 10));
+   TEST_ASSERT_EQUAL((13 * CP_USART_FRAME_SIZE) - (3 * CP_USART_FRAME_SIZE) - 5,
+                     ulUsedT);
+
+   TEST_ASSERT_EQUAL(7, CpUsartFrameDecode(&tsDecoderS,
+                                           &aubStreamS[13 * CP_USART_FRAME_SIZE],
+                                           7 * CP_USART_FRAME_SIZE, &ulUsedT,
+                                           &atsRcvMsgS[13], FRAME_COUNT));
+   TEST_ASSERT_EQUAL(7 * CP_USART_FRAME_SIZE, ulUsedT);
+
+   for (ulMsgIdxT = 0; ulMsgIdxT < FRAME_COUNT; ulMsgIdxT++)
+   {
+      TestMsgEqual(&atsTrmMsgS[ulMsgIdxT], &atsRcvMsgS[ulMsgIdxT]);
+   }
+
+   UnityPrint("CP_USART_FRAME_003: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_USART_FRAME_004                                               //
+// resynchronisation after noise and a corrupted frame                        //
+//----------------------------------------------------------------------------//
+TEST(CP_USART_FRAME, 004)
+{
+   uint32_t ulSizeT;
+   uint32_t ulUsedT;
+   uint32_t ulMsgCntT;
+   uint32_t ulPosT;
+
+   //----------------------------------------------------------------
+   // 3 bytes of noise, followed by 20 frames where frame 5 has
+   // a wrong CRC
+   //
+   aubStreamS[0] = 0x00;
+   aubStreamS[1] = CP_USART_SYNC_0;
+   aubStreamS[2] = 0x11;
+   ulSizeT  = 3 + TestEncodeStream(CP_USART_VERSION_FIXED, &aubStreamS[3]);
+   aubStreamS[3 + (5 * CP_USART_FRAME_SIZE) + 4] ^= 0x40;
+
+   //----------------------------------------------------------------
+   // pass the stream in chunks of 7 bytes
+   //
+   ulMsgCntT = 0;
+   for (ulPosT = 0; ulPosT < ulSizeT; ulPosT += ulUsedT)
+   {
+      ulMsgCntT += CpUsartFrameDecode(&tsDecoderS, &aubStreamS[ulPosT],
+                                      (ulSizeT - ulPosT) < 7 ?
+                                      (ulSizeT - ulPosT) : 7,
+                                      &ulUsedT, &atsRcvMsgS[ulMsgCntT],
+                                      FRAME_COUNT - ulMsgCntT);
+   }
+
+   TEST_ASSERT_EQUAL(FRAME_COUNT - 1, ulMsgCntT);
+   TEST_ASSERT_EQUAL(1, tsDecoderS.ulErrorCount);
+   TestMsgEqual(&atsTrmMsgS[4], &atsRcvMsgS[4]);
+   TestMsgEqual(&atsTrmMsgS[6], &atsRcvMsgS[5]);
+   TestMsgEqual(&atsTrmMsgS[FRAME_COUNT - 1], &atsRcvMsgS[FRAME_COUNT - 2]);
+
+   UnityPrint("CP_USART_FRAME_004: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_USART_FRAME_005                                               //
+// size of compact frames                                                     //
+//----------------------------------------------------------------------------//
+TEST(CP_USART_FRAME, 005)
+{
+   uint32_t ulUsedT = 0;
+
+   //----------------------------------------------------------------
+   // standard frame, 8 data bytes
+   //
+   atsTrmMsgS[0].ubMsgDLC = 8;
+   TEST_ASSERT_EQUAL(16, CpUsartFrameEncode(&atsTrmMsgS[0],
+                                            CP_USART_VERSION_COMPACT,
+                                            &aubStreamS[0]));
+   TEST_ASSERT_EQUAL(16, CpUsartFrameSize(&aubStreamS[0], 16));
+   TEST_ASSERT_EQUAL(1, CpUsartFrameDecode(&tsDecoderS, &aubStreamS[0], 16,
+                                           &ulUsedT, &atsRcvMsgS[0], 1));
+   TestMsgEqual(&atsTrmMsgS[0], &atsRcvMsgS[0]);
+
+   //----------------------------------------------------------------
+   // extended frame, 3 data bytes
+   //
+   atsTrmMsgS[1].ubMsgDLC = 3;
+   TEST_ASSERT_EQUAL(13, CpUsartFrameEncode(&atsTrmMsgS[1],
+                                            CP_USART_VERSION_COMPACT,
+                                            &aubStreamS[0]));
+   TEST_ASSERT_EQUAL(1, CpUsartFrameDecode(&tsDecoderS, &aubStreamS[0], 13,
+                                           &ulUsedT, &atsRcvMsgS[1], 1));
+   TestMsgEqual(&atsTrmMsgS[1], &atsRcvMsgS[1]);
+
+   //----------------------------------------------------------------
+   // remote frame does not carry data
+   //
+   atsTrmMsgS[2].ubMsgCtrl = CP_MSG_CTRL_RTR_BIT;
+   atsTrmMsgS[2].ubMsgDLC  = 8;
+   TEST_ASSERT_EQUAL(8, CpUsartFrameEncode(&atsTrmMsgS[2],
+                                           CP_USART_VERSION_COMPACT,
+                                           &aubStreamS[0]));
+   TEST_ASSERT_EQUAL(1, CpUsartFrameDecode(&tsDecoderS, &aubStreamS[0], 8,
+                                           &ulUsedT, &atsRcvMsgS[2], 1));
+   TestMsgEqual(&atsTrmMsgS[2], &atsRcvMsgS[2]);
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ulErrorCount);
+
+   UnityPrint("CP_USART_FRAME_005: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_USART_FRAME_006                                               //
+// mixed fixed and compact frames, passed in chunks of 5 bytes                //
+//----------------------------------------------------------------------------//
+TEST(CP_USART_FRAME, 006)
+{
+   uint32_t ulSizeT = 0;
+   uint32_t ulUsedT;
+   uint32_t ulMsgCntT = 0;
+   uint32_t ulPosT;
+
+   for (ulPosT = 0; ulPosT < FRAME_COUNT; ulPosT++)
+   {
+      ulSizeT += CpUsartFrameEncode(&atsTrmMsgS[ulPosT],
+                                    (ulPosT % 3) ? CP_USART_VERSION_COMPACT :
+                                                   CP_USART_VERSION_FIXED,
+                                    &aubStreamS[ulSizeT]);
+   }
+
+   for (ulPosT = 0; ulPosT < ulSizeT; ulPosT += ulUsedT)
+   {
+      ulMsgCntT += CpUsartFrameDecode(&tsDecoderS, &aubStreamS[ulPosT],
+                                      (ulSizeT - ulPosT) < 5 ?
+                                      (ulSizeT - ulPosT) : 5,
+                                      &ulUsedT, &atsRcvMsgS[ulMsgCntT],
+                                      FRAME_COUNT - ulMsgCntT);
+   }
+
+   TEST_ASSERT_EQUAL(FRAME_COUNT, ulMsgCntT);
+   for (ulPosT = 0; ulPosT < FRAME_COUNT; ulPosT++)
+   {
+      TestMsgEqual(&atsTrmMsgS[ulPosT], &atsRcvMsgS[ulPosT]);
+   }
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ulErrorCount);
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ulDropCount);
+
+   UnityPrint("CP_USART_FRAME_006: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_USART_FRAME_007                                               //
+// version negotiation                                                        //
+//----------------------------------------------------------------------------//
+TEST(CP_USART_FRAME, 007)
+{
+   uint32_t ulSizeT;
+   uint32_t ulUsedT;
+
+   //----------------------------------------------------------------
+   // no announcement: use fixed frames
+   //
+   TEST_ASSERT_EQUAL(CP_USART_VERSION_FIXED, CpUsartVersionSelect(&tsDecoderS));
+
+   //----------------------------------------------------------------
+   // version request followed by a CAN message
+   //
+   ulSizeT  = CpUsartVersionEncode(1, &aubStreamS[0]);
+   TEST_ASSERT_TRUE(CpUsartFrameIsVersion(&aubStreamS[0], ulSizeT));
+   ulSizeT += CpUsartFrameEncode(&atsTrmMsgS[0], CP_USART_VERSION_FIXED,
+                                 &aubStreamS[ulSizeT]);
+
+   TEST_ASSERT_EQUAL(1, CpUsartFrameDecode(&tsDecoderS, &aubStreamS[0], ulSizeT,
+                                           &ulUsedT, &atsRcvMsgS[0], 1));
+   TEST_ASSERT_EQUAL(ulSizeT, ulUsedT);
+   TestMsgEqual(&atsTrmMsgS[0], &atsRcvMsgS[0]);
+   TEST_ASSERT_EQUAL(1, tsDecoderS.ubReplyPending);
+   TEST_ASSERT_EQUAL(CP_USART_VERSION, CpUsartVersionSelect(&tsDecoderS));
+
+   //----------------------------------------------------------------
+   // a corrupted version frame is ignored
+   //
+   CpUsartVersionEncode(0, &aubStreamS[0]);
+   aubStreamS[CP_USART_FRAME_SIZE - 2] ^= 0x01;
+   CpUsartDecoderInit(&tsDecoderS);
+   TEST_ASSERT_EQUAL(0, CpUsartFrameDecode(&tsDecoderS, &aubStreamS[0],
+                                           CP_USART_FRAME_SIZE, &ulUsedT,
+                                           &atsRcvMsgS[0], 1));
+   TEST_ASSERT_EQUAL(1, tsDecoderS.ulErrorCount);
+   TEST_ASSERT_EQUAL(CP_USART_VERSION_FIXED, CpUsartVersionSelect(&tsDecoderS));
+
+   UnityPrint("CP_USART_FRAME_007: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_USART_FRAME_008                                               //
+// resynchronisation from a fixed frame header onto compact frames            //
+//----------------------------------------------------------------------------//
+TEST(CP_USART_FRAME, 008)
+{
+   uint32_t ulSizeT;
+   uint32_t ulUsedT;
+   uint32_t ulMsgCntT = 0;
+   uint32_t ulPosT;
+
+   //----------------------------------------------------------------
+   // the header of a fixed frame without payload is followed by
+   // compact frames: the decoder buffers the size of a fixed frame,
+   // fails on the CRC and resynchronises onto the first compact
+   // frame, which is shorter than the buffered data
+   //
+   aubStreamS[0] = CP_USART_SYNC_0;
+   aubStreamS[1] = CP_USART_SYNC_1;
+   aubStreamS[2] = CP_USART_TYPE_CAN;
+   aubStreamS[3] = 0x00;
+   ulSizeT = 4 + TestEncodeStream(CP_USART_VERSION_COMPACT, &aubStreamS[4]);
+
+   for (ulPosT = 0; ulPosT < ulSizeT; ulPosT += ulUsedT)
+   {
+      ulMsgCntT += CpUsartFrameDecode(&tsDecoderS, &aubStreamS[ulPosT],
+                                      (ulSizeT - ulPosT) < 5 ?
+                                      (ulSizeT - ulPosT) : 5,
+                                      &ulUsedT, &atsRcvMsgS[ulMsgCntT],
+                                      FRAME_COUNT - ulMsgCntT);
+   }
+
+   TEST_ASSERT_EQUAL(FRAME_COUNT, ulMsgCntT);
+   for (ulPosT = 0; ulPosT < FRAME_COUNT; ulPosT++)
+   {
+      TestMsgEqual(&atsTrmMsgS[ulPosT], &atsRcvMsgS[ulPosT]);
+   }
+   TEST_ASSERT_EQUAL(1, tsDecoderS.ulErrorCount);
+   TEST_ASSERT_EQUAL(4, tsDecoderS.ulDropCount);
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ulCount);
+
+   UnityPrint("CP_USART_FRAME_008: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// Test case CP_USART_FRAME_009                                               //
+// legacy frames are cut from the stream by size only                         //
+//----------------------------------------------------------------------------//
+TEST(CP_USART_FRAME, 009)
+{
+   uint32_t ulSizeT = 0;
+   uint32_t ulUsedT;
+   uint32_t ulMsgCntT = 0;
+   uint32_t ulPosT;
+
+   //----------------------------------------------------------------
+   // the legacy layout is the plain CAN message structure: the
+   // identifier is followed by data, DLC and control field
+   //
+   TEST_ASSERT_EQUAL(CP_USART_LEGACY_SIZE,
+                     CpUsartLegacyEncode(&atsTrmMsgS[1], &aubStreamS[0]));
+   TEST_ASSERT_EQUAL_HEX8(0x01, aubStreamS[0]);
+   TEST_ASSERT_EQUAL_HEX8(0xA5, aubStreamS[1]);
+   TEST_ASSERT_EQUAL_HEX8(0xFE, aubStreamS[2]);
+   TEST_ASSERT_EQUAL_HEX8(0x18, aubStreamS[3]);
+   TEST_ASSERT_EQUAL_HEX8(0x01, aubStreamS[4]);
+   TEST_ASSERT_EQUAL(1, aubStreamS[4 + CP_DATA_SIZE]);
+   TEST_ASSERT_EQUAL_HEX8(CP_MSG_CTRL_EXT_BIT, aubStreamS[5 + CP_DATA_SIZE]);
+
+   for (ulPosT = 0; ulPosT < FRAME_COUNT; ulPosT++)
+   {
+      ulSizeT += CpUsartLegacyEncode(&atsTrmMsgS[ulPosT], &aubStreamS[ulSizeT]);
+   }
+   TEST_ASSERT_EQUAL(FRAME_COUNT * CP_USART_LEGACY_SIZE, ulSizeT);
+
+   //----------------------------------------------------------------
+   // the data contains the sync pattern, which must not be
+   // evaluated in legacy mode
+   //
+   tsDecoderS.ubLegacy = 1;
+   for (ulPosT = 0; ulPosT < ulSizeT; ulPosT += ulUsedT)
+   {
+      ulMsgCntT += CpUsartFrameDecode(&tsDecoderS, &aubStreamS[ulPosT],
+                                      (ulSizeT - ulPosT) < 7 ?
+                                      (ulSizeT - ulPosT) : 7,
+                                      &ulUsedT, &atsRcvMsgS[ulMsgCntT],
+                                      FRAME_COUNT - ulMsgCntT);
+   }
+
+   TEST_ASSERT_EQUAL(FRAME_COUNT, ulMsgCntT);
+   for (ulPosT = 0; ulPosT < FRAME_COUNT; ulPosT++)
+   {
+      TestMsgEqual(&atsTrmMsgS[ulPosT], &atsRcvMsgS[ulPosT]);
+   }
+   TEST_ASSERT_EQUAL(FRAME_COUNT, tsDecoderS.ulFrameCount);
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ulErrorCount);
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ulDropCount);
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ubPeerVersion);
+   TEST_ASSERT_EQUAL(0, tsDecoderS.ulCount);
+
+   //----------------------------------------------------------------
+   // coalesced frames are limited by the size of the message array
+   //
+   TEST_ASSERT_EQUAL(2, CpUsartFrameDecode(&tsDecoderS, &aubStreamS[0], ulSizeT,
+                                           &ulUsedT, &atsRcvMsgS[0], 2));
+   TEST_ASSERT_EQUAL(2 * CP_USART_LEGACY_SIZE, ulUsedT);
+
+   UnityPrint("CP_USART_FRAME_009: PASSED");
+   printf("\n");
+}
+
+
+//----------------------------------------------------------------------------//
+// TEST_GROUP_RUNNER()                                                        //
+// execute all test cases                                                     //
+//----------------------------------------------------------------------------//
+TEST_GROUP_RUNNER(CP_USART_FRAME)
+{
+   UnityPrint("--- Run test group: CP_USART_FRAME ---------------------------");
+   printf("\n");
+
+   RUN_TEST_CASE(CP_USART_FRAME, 001);
+   RUN_TEST_CASE(CP_USART_FRAME, 002);
+   RUN_TEST_CASE(CP_USART_FRAME, 003);
+   RUN_TEST_CASE(CP_USART_FRAME, 004);
+   RUN_TEST_CASE(CP_USART_FRAME, 005);
+   RUN_TEST_CASE(CP_USART_FRAME, 006);
+   RUN_TEST_CASE(CP_USART_FRAME, 007);
+   RUN_TEST_CASE(CP_USART_FRAME, 008);
+   RUN_TEST_CASE(CP_USART_FRAME, 009);
+   printf("\n");
+
+}